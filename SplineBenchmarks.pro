@@ -0,0 +1,26 @@
+#standalone benchmarks for the spline library. unlike SplineDemo.pro, this doesn't use Qt at all
+TARGET = SplineBenchmarks
+TEMPLATE = app
+
+QT =
+CONFIG -= qt app_bundle
+CONFIG += console c++14 release
+
+exists(./SplineDemo_Include.pri) {
+    include(SplineDemo_Include.pri)
+}
+
+INCLUDEPATH += $$PWD
+
+unix: LIBS += -lpthread
+
+SOURCES += \
+    benchmark/main.cpp
+
+HEADERS += \
+    benchmark/benchmarkrunner.h
+
+#uncomment one of these to print what the library's instrumentation counted under each benchmark, averaged per operation
+#the second also times the larger operations, which makes every benchmark that uses them a bit slower
+#DEFINES += SPLINE_LIBRARY_INSTRUMENTATION
+#DEFINES += SPLINE_LIBRARY_INSTRUMENTATION_TIMING
@@ -32,15 +32,38 @@ HEADERS  += \
     demo/benchmarker.h \
     spline_library/utils/calculus.h \
     spline_library/vector.h \
+    spline_library/vector_simd.h \
     spline_library/utils/spline_common.h \
+    spline_library/utils/knot_editor.h \
     spline_library/splines/generic_b_spline.h \
     spline_library/splines/uniform_cubic_bspline.h \
     spline_library/splines/cubic_hermite_spline.h \
     spline_library/splines/uniform_cr_spline.h \
     spline_library/splines/quintic_hermite_spline.h \
     spline_library/splines/natural_spline.h \
+    spline_library/splines/compiled_spline.h \
+    spline_library/splines/fixed_uniform_spline.h \
+    spline_library/splines/sliding_window_spline.h \
     spline_library/utils/arclength.h \
-    spline_library/utils/splineinverter.h
+    spline_library/utils/arclengthtable.h \
+    spline_library/utils/arclengthparameterization.h \
+    spline_library/utils/parallelfor.h \
+    spline_library/utils/splineinverter.h \
+    spline_library/utils/splineboundstree.h \
+    spline_library/utils/splinesegmentbounds.h \
+    spline_library/utils/splinelodtable.h \
+    spline_library/utils/quinticbezier.h \
+    spline_library/utils/tessellation.h \
+    spline_library/utils/fixedstepsampler.h \
+    spline_library/utils/rotationminimizingframes.h \
+    spline_library/utils/splinefitting.h \
+    spline_library/utils/gpusplinebuffer.h \
+    spline_library/utils/splinearchive.h \
+    spline_library/utils/instrumentation.h \
+    spline_library/utils/splinevariant.h \
+    spline_library/utils/splinesegmentcache.h \
+    spline_library/utils/splinecursor.h \
+    spline_library/utils/splinepublisher.h
 
 FORMS    += \
     demo/settingswidget.ui \
@@ -75,3 +98,9 @@ test {
 #QMAKE_CXXFLAGS_RELEASE += -g
 #QMAKE_CFLAGS_RELEASE += -g
 #QMAKE_LFLAGS_RELEASE =
+
+#uncomment this to force the scalar Vector implementation, IE to compare it against the SIMD implementation in the benchmarker
+#DEFINES += SPLINE_LIBRARY_NO_SIMD
+
+#uncomment this to have the benchmarker also report what the library's instrumentation counted. see spline_library/utils/instrumentation.h
+#DEFINES += SPLINE_LIBRARY_INSTRUMENTATION
@@ -0,0 +1,221 @@
+#pragma once
+
+#include <vector>
+#include <string>
+#include <chrono>
+#include <algorithm>
+#include <numeric>
+#include <cmath>
+#include <iostream>
+#include <iomanip>
+
+#include "spline_library/utils/instrumentation.h"
+
+//the measured timing of a single operation on a single spline configuration
+struct BenchmarkResult
+{
+    std::string spline;
+    std::string operation;
+    std::string vectorOps;
+    size_t size;
+    size_t dimension;
+
+    //nanoseconds per operation, for each sample
+    std::vector<double> sampleNs;
+
+    //everything the library's instrumentation counted during the timed samples, and how many operations that covers
+    //always empty unless the benchmarks are built with SPLINE_LIBRARY_INSTRUMENTATION
+    SplineInstrumentation::Counters counters;
+    size_t countedOps;
+
+    double countPerOp(SplineInstrumentation::Counter counter) const { return double(counters.counts[counter]) / countedOps; }
+    double nanosecondsPerOp(SplineInstrumentation::Counter counter) const { return double(counters.nanoseconds[counter]) / countedOps; }
+
+    double mean(void) const { return std::accumulate(sampleNs.begin(), sampleNs.end(), 0.0) / sampleNs.size(); }
+    double minimum(void) const { return *std::min_element(sampleNs.begin(), sampleNs.end()); }
+    double median(void) const
+    {
+        std::vector<double> sorted = sampleNs;
+        std::sort(sorted.begin(), sorted.end());
+        size_t middle = sorted.size() / 2;
+        return sorted.size() % 2 == 1 ? sorted[middle] : (sorted[middle - 1] + sorted[middle]) / 2;
+    }
+    double standardDeviation(void) const
+    {
+        if(sampleNs.size() < 2)
+            return 0;
+
+        double average = mean();
+        double sumSquares = 0;
+        for(double sample : sampleNs)
+        {
+            sumSquares += (sample - average) * (sample - average);
+        }
+        return std::sqrt(sumSquares / (sampleNs.size() - 1));
+    }
+};
+
+class BenchmarkRunner
+{
+public:
+    //each benchmark is timed "samples" times, and each sample repeats the operation until at least minSampleSeconds have passed
+    //only benchmarks whose "spline/operation" name contains filter are run
+    BenchmarkRunner(size_t samples, double minSampleSeconds, std::string filter)
+        :samples(samples), minSampleSeconds(minSampleSeconds), filter(std::move(filter)), sink(0)
+    {}
+
+    //time the given operation. each call to operation() should do opsPerCall operations (IE evaluate opsPerCall t values),
+    //and return some value computed from the results, so that the compiler can't optimize the work away
+    template<class Operation>
+    void run(const std::string &spline, const std::string &operation, const std::string &vectorOps,
+             size_t size, size_t dimension, size_t opsPerCall, Operation operationFunction);
+
+    inline const std::vector<BenchmarkResult> &getResults(void) const { return results; }
+
+    //print a human-readable table of every result so far
+    void printTable(std::ostream &output) const;
+
+    //write every result so far as a JSON document, for tracking regressions between versions
+    void writeJson(std::ostream &output) const;
+
+private:
+    typedef std::chrono::steady_clock Clock;
+
+    static void printRow(std::ostream &output, const BenchmarkResult &result);
+    static std::string escapeJson(const std::string &text);
+
+    size_t samples;
+    double minSampleSeconds;
+    std::string filter;
+
+    std::vector<BenchmarkResult> results;
+
+    //every operation's return value gets added here, so that the work it does is observable
+    volatile double sink;
+};
+
+template<class Operation>
+void BenchmarkRunner::run(const std::string &spline, const std::string &operation, const std::string &vectorOps,
+                          size_t size, size_t dimension, size_t opsPerCall, Operation operationFunction)
+{
+    if((spline + "/" + operation).find(filter) == std::string::npos)
+        return;
+
+    //warm up, and use the warmup time to estimate how many calls it takes to fill a sample
+    auto warmupBegin = Clock::now();
+    sink = sink + double(operationFunction());
+    double warmupSeconds = std::chrono::duration<double>(Clock::now() - warmupBegin).count();
+
+    size_t callsPerSample = 1;
+    if(warmupSeconds < minSampleSeconds)
+    {
+        callsPerSample = size_t(std::ceil(minSampleSeconds / std::max(warmupSeconds, 1e-9)));
+    }
+
+    BenchmarkResult result;
+    result.spline = spline;
+    result.operation = operation;
+    result.vectorOps = vectorOps;
+    result.size = size;
+    result.dimension = dimension;
+
+    auto countersBegin = SplineInstrumentation::globalSnapshot();
+    for(size_t sample = 0; sample < samples; sample++)
+    {
+        double sampleSink = 0;
+        auto begin = Clock::now();
+        for(size_t i = 0; i < callsPerSample; i++)
+        {
+            sampleSink += double(operationFunction());
+        }
+        double elapsedNs = std::chrono::duration<double, std::nano>(Clock::now() - begin).count();
+
+        sink = sink + sampleSink;
+        result.sampleNs.push_back(elapsedNs / (callsPerSample * opsPerCall));
+    }
+    result.counters = SplineInstrumentation::globalSnapshot() - countersBegin;
+    result.countedOps = samples * callsPerSample * opsPerCall;
+
+    printRow(std::cout, result);
+    results.push_back(std::move(result));
+}
+
+inline void BenchmarkRunner::printTable(std::ostream &output) const
+{
+    for(const BenchmarkResult &result : results)
+    {
+        printRow(output, result);
+    }
+}
+
+inline void BenchmarkRunner::printRow(std::ostream &output, const BenchmarkResult &result)
+{
+    std::string name = result.spline + "[" + std::to_string(result.size) + "] " + std::to_string(result.dimension) + "D " + result.operation;
+
+    output << std::left << std::setw(56) << name << std::right << std::fixed << std::setprecision(1)
+           << std::setw(14) << result.mean() << " ns/op"
+           << "  +/- " << std::setw(10) << result.standardDeviation()
+           << "  (min " << result.minimum() << ")" << std::endl;
+
+    //one indented line per counter that saw anything, averaged per operation like the timings above
+    if(SplineInstrumentation::enabled)
+    {
+        for(size_t i = 0; i < SplineInstrumentation::CounterCount; i++)
+        {
+            auto counter = SplineInstrumentation::Counter(i);
+            if(result.counters.counts[counter] == 0)
+                continue;
+
+            output << "    " << std::left << std::setw(52) << SplineInstrumentation::counterName(counter) << std::right
+                   << std::setprecision(2) << std::setw(14) << result.countPerOp(counter) << " /op";
+            if(SplineInstrumentation::timingEnabled && result.counters.nanoseconds[counter] > 0)
+                output << "  (" << std::setprecision(1) << result.nanosecondsPerOp(counter) << " ns/op inside)";
+            output << std::endl;
+        }
+    }
+}
+
+inline void BenchmarkRunner::writeJson(std::ostream &output) const
+{
+    output << "{\n  \"results\": [\n";
+    for(size_t i = 0; i < results.size(); i++)
+    {
+        const BenchmarkResult &result = results[i];
+        output << std::setprecision(3) << std::fixed
+               << "    {"
+               << "\"spline\": \"" << escapeJson(result.spline) << "\", "
+               << "\"operation\": \"" << escapeJson(result.operation) << "\", "
+               << "\"vector_ops\": \"" << escapeJson(result.vectorOps) << "\", "
+               << "\"size\": " << result.size << ", "
+               << "\"dimension\": " << result.dimension << ", "
+               << "\"samples\": " << result.sampleNs.size() << ", "
+               << "\"mean_ns\": " << result.mean() << ", "
+               << "\"stddev_ns\": " << result.standardDeviation() << ", "
+               << "\"median_ns\": " << result.median() << ", "
+               << "\"min_ns\": " << result.minimum();
+        if(SplineInstrumentation::enabled)
+        {
+            output << ", \"counters\": {";
+            for(size_t c = 0; c < SplineInstrumentation::CounterCount; c++)
+            {
+                auto counter = SplineInstrumentation::Counter(c);
+                output << (c > 0 ? ", " : "") << "\"" << escapeJson(SplineInstrumentation::counterName(counter)) << "\": " << result.countPerOp(counter);
+            }
+            output << "}";
+        }
+        output << "}" << (i + 1 < results.size() ? "," : "") << "\n";
+    }
+    output << "  ]\n}\n";
+}
+
+inline std::string BenchmarkRunner::escapeJson(const std::string &text)
+{
+    std::string result;
+    for(char c : text)
+    {
+        if(c == '"' || c == '\\')
+            result += '\\';
+        result += c;
+    }
+    return result;
+}
@@ -0,0 +1,599 @@
+#include <vector>
+#include <string>
+#include <memory>
+#include <random>
+#include <functional>
+#include <fstream>
+#include <iostream>
+#include <cstdlib>
+#include <cmath>
+
+#include "benchmarkrunner.h"
+
+#include "spline_library/vector.h"
+#include "spline_library/utils/arclength.h"
+#include "spline_library/utils/splineinverter.h"
+#include "spline_library/utils/splineboundstree.h"
+#include "spline_library/utils/splinesegmentbounds.h"
+#include "spline_library/utils/splinelodtable.h"
+#include "spline_library/utils/splinecursor.h"
+#include "spline_library/utils/tessellation.h"
+#include "spline_library/utils/fixedstepsampler.h"
+#include "spline_library/splines/sliding_window_spline.h"
+#include "spline_library/utils/gpusplinebuffer.h"
+#include "spline_library/utils/splinearchive.h"
+
+#include "spline_library/splines/uniform_cr_spline.h"
+#include "spline_library/splines/uniform_cubic_bspline.h"
+#include "spline_library/splines/cubic_hermite_spline.h"
+#include "spline_library/splines/quintic_hermite_spline.h"
+#include "spline_library/splines/natural_spline.h"
+#include "spline_library/splines/generic_b_spline.h"
+#include "spline_library/splines/compiled_spline.h"
+
+//a standalone benchmark of every spline type and utility, with no dependency on Qt
+//run with --help for the list of options
+
+namespace
+{
+    //number of t values evaluated by each call of the evaluation benchmarks
+    const size_t evaluationsPerCall = 1000;
+
+    //number of queries made by each call of the arc length and inversion benchmarks
+    const size_t queriesPerCall = 100;
+
+    template<size_t dimension>
+    struct SplineFactory
+    {
+        typedef Vector<dimension, float> VectorType;
+
+        std::string name;
+        bool looping;
+        std::function<std::shared_ptr<Spline<VectorType, float>>(const std::vector<VectorType> &points)> create;
+    };
+
+    template<size_t dimension>
+    std::vector<Vector<dimension, float>> makeRandomPoints(std::mt19937 &gen, size_t count)
+    {
+        std::uniform_real_distribution<float> distribution(-10, 10);
+
+        //walk in a random direction from the previous point, so that the result looks like a curve that a person might draw
+        std::vector<Vector<dimension, float>> result(count);
+        for(size_t i = 0; i < count; i++)
+        {
+            for(size_t d = 0; d < dimension; d++)
+            {
+                result[i][d] = distribution(gen);
+            }
+            if(i > 0)
+            {
+                result[i] += result[i - 1];
+            }
+        }
+        return result;
+    }
+
+    template<class VectorType>
+    std::vector<VectorType> makeTangents(const std::vector<VectorType> &points, bool looping)
+    {
+        //finite differences, IE the same tangents a catmull-rom spline would use
+        size_t size = points.size();
+        std::vector<VectorType> result(size);
+        for(size_t i = 0; i < size; i++)
+        {
+            size_t previous = (i == 0) ? (looping ? size - 1 : 0) : i - 1;
+            size_t next = (i == size - 1) ? (looping ? 0 : size - 1) : i + 1;
+            result[i] = (points[next] - points[previous]) / float(next == previous ? 1 : 2);
+        }
+        return result;
+    }
+
+    template<size_t dimension>
+    std::vector<SplineFactory<dimension>> makeFactories(void)
+    {
+        typedef Vector<dimension, float> VectorType;
+        typedef std::shared_ptr<Spline<VectorType, float>> SplinePtr;
+        typedef std::vector<VectorType> Points;
+
+        return std::vector<SplineFactory<dimension>> {
+            {"UniformCR", false, [](const Points &p) { return SplinePtr(new UniformCRSpline<VectorType>(p)); }},
+            {"UniformCubicB", false, [](const Points &p) { return SplinePtr(new UniformCubicBSpline<VectorType>(p)); }},
+            {"CubicHermite", false, [](const Points &p) { return SplinePtr(new CubicHermiteSpline<VectorType>(p, makeTangents(p, false), 0.5f)); }},
+            {"CubicHermiteCR", false, [](const Points &p) { return SplinePtr(new CubicHermiteSpline<VectorType>(p, 0.5f)); }},
+            {"QuinticHermiteCR", false, [](const Points &p) { return SplinePtr(new QuinticHermiteSpline<VectorType>(p, 0.5f)); }},
+            {"Natural", false, [](const Points &p) { return SplinePtr(new NaturalSpline<VectorType>(p, true, 0.5f)); }},
+            {"CubicHermiteCRUniform", false, [](const Points &p) { return SplinePtr(new CubicHermiteSpline<VectorType, float, true>(p)); }},
+            {"NaturalUniform", false, [](const Points &p) { return SplinePtr(new NaturalSpline<VectorType, float, true>(p)); }},
+            {"NaturalNotAKnot", false, [](const Points &p) {
+                 return SplinePtr(new NaturalSpline<VectorType>(p, true, 0.5f, NaturalSpline<VectorType>::NotAKnot));
+             }},
+            {"GenericB5", false, [](const Points &p) { return SplinePtr(new GenericBSpline<VectorType>(p, 5)); }},
+            {"FixedGenericB5", false, [](const Points &p) { return SplinePtr(new GenericBSpline<VectorType, float, 5>(p)); }},
+            {"CompiledNatural", false, [](const Points &p) {
+                 return SplinePtr(new CompiledSpline<VectorType>(NaturalSpline<VectorType>(p, true, 0.5f)));
+             }},
+
+            {"LoopingUniformCR", true, [](const Points &p) { return SplinePtr(new LoopingUniformCRSpline<VectorType>(p)); }},
+            {"LoopingUniformCubicB", true, [](const Points &p) { return SplinePtr(new LoopingUniformCubicBSpline<VectorType>(p)); }},
+            {"LoopingCubicHermite", true, [](const Points &p) {
+                 return SplinePtr(new LoopingCubicHermiteSpline<VectorType>(p, makeTangents(p, true), 0.5f));
+             }},
+            {"LoopingCubicHermiteCR", true, [](const Points &p) { return SplinePtr(new LoopingCubicHermiteSpline<VectorType>(p, 0.5f)); }},
+            {"LoopingQuinticHermiteCR", true, [](const Points &p) { return SplinePtr(new LoopingQuinticHermiteSpline<VectorType>(p, 0.5f)); }},
+            {"LoopingNatural", true, [](const Points &p) { return SplinePtr(new LoopingNaturalSpline<VectorType>(p, 0.5f)); }},
+            {"LoopingQuinticHermiteCRUniform", true, [](const Points &p) { return SplinePtr(new LoopingQuinticHermiteSpline<VectorType, float, true>(p)); }},
+            {"LoopingGenericB5", true, [](const Points &p) { return SplinePtr(new LoopingGenericBSpline<VectorType>(p, 5)); }},
+            {"LoopingFixedGenericB5", true, [](const Points &p) { return SplinePtr(new LoopingGenericBSpline<VectorType, float, 5>(p)); }},
+            {"LoopingCompiledNatural", true, [](const Points &p) {
+                 return SplinePtr(new LoopingCompiledSpline<VectorType>(LoopingNaturalSpline<VectorType>(p, 0.5f)));
+             }},
+        };
+    }
+
+    template<size_t dimension>
+    void benchmarkSpline(BenchmarkRunner &runner, const SplineFactory<dimension> &factory, const std::vector<Vector<dimension, float>> &points, std::mt19937 &gen)
+    {
+        typedef Vector<dimension, float> VectorType;
+        typedef Spline<VectorType, float> SplineType;
+
+        const char *vectorOps = __VectorPrivate::VectorOps<dimension, float>::name;
+        size_t size = points.size();
+
+        runner.run(factory.name, "construct", vectorOps, size, dimension, 1, [&]() {
+            return factory.create(points)->getMaxT();
+        });
+
+        std::shared_ptr<SplineType> spline = factory.create(points);
+        float maxT = spline->getMaxT();
+
+        std::uniform_real_distribution<float> tDistribution(0, maxT);
+        std::vector<float> tValues(evaluationsPerCall);
+        for(float &t : tValues)
+        {
+            t = tDistribution(gen);
+        }
+
+        //the same values in order, for the batch functions, which are fastest when consecutive t values land in the same segment
+        std::vector<float> sortedTValues = tValues;
+        std::sort(sortedTValues.begin(), sortedTValues.end());
+
+        runner.run(factory.name, "getPosition", vectorOps, size, dimension, evaluationsPerCall, [&]() {
+            float sum = 0;
+            for(float t : tValues)
+                sum += spline->getPosition(t)[0];
+            return sum;
+        });
+        runner.run(factory.name, "getTangent", vectorOps, size, dimension, evaluationsPerCall, [&]() {
+            float sum = 0;
+            for(float t : tValues)
+                sum += spline->getTangent(t).tangent[0];
+            return sum;
+        });
+        runner.run(factory.name, "getCurvature", vectorOps, size, dimension, evaluationsPerCall, [&]() {
+            float sum = 0;
+            for(float t : tValues)
+                sum += spline->getCurvature(t).curvature[0];
+            return sum;
+        });
+        runner.run(factory.name, "getWiggle", vectorOps, size, dimension, evaluationsPerCall, [&]() {
+            float sum = 0;
+            for(float t : tValues)
+                sum += spline->getWiggle(t).wiggle[0];
+            return sum;
+        });
+
+        std::vector<VectorType> positions(evaluationsPerCall);
+        runner.run(factory.name, "getPositions (sorted batch)", vectorOps, size, dimension, evaluationsPerCall, [&]() {
+            spline->getPositions(sortedTValues.data(), sortedTValues.size(), positions.data());
+            return positions.back()[0];
+        });
+
+        //the same evenly spaced samples of every segment, evaluated one at a time and by forward differencing
+        const size_t samplesPerSegment = 16;
+        std::vector<VectorType> fixedStepPositions(FixedStepSampler::sampleCount(*spline, samplesPerSegment));
+        std::vector<float> fixedStepTValues(fixedStepPositions.size());
+        FixedStepSampler::sample(*spline, samplesPerSegment, fixedStepPositions.data(), fixedStepTValues.data());
+        runner.run(factory.name, "getPositions (fixed step)", vectorOps, size, dimension, fixedStepPositions.size(), [&]() {
+            spline->getPositions(fixedStepTValues.data(), fixedStepTValues.size(), fixedStepPositions.data());
+            return fixedStepPositions.back()[0];
+        });
+        runner.run(factory.name, "FixedStepSampler::sample", vectorOps, size, dimension, fixedStepPositions.size(), [&]() {
+            FixedStepSampler::sample(*spline, samplesPerSegment, fixedStepPositions.data());
+            return fixedStepPositions.back()[0];
+        });
+
+        //step across the whole spline in small increments, the way an animation would
+        float cursorStep = maxT / evaluationsPerCall;
+        runner.run(factory.name, "SplineCursor advance", vectorOps, size, dimension, evaluationsPerCall, [&]() {
+            SplineCursor<VectorType, float> cursor(*spline);
+            float sum = 0;
+            for(size_t i = 0; i < evaluationsPerCall; i++)
+            {
+                cursor.advance(cursorStep);
+                sum += cursor.getPosition()[0];
+            }
+            return sum;
+        });
+
+        float cursorLengthStep = spline->totalLength() / (evaluationsPerCall + 1);
+        runner.run(factory.name, "SplineCursor advanceLength", vectorOps, size, dimension, evaluationsPerCall, [&]() {
+            SplineCursor<VectorType, float> cursor(*spline);
+            float sum = 0;
+            for(size_t i = 0; i < evaluationsPerCall; i++)
+            {
+                cursor.advanceLength(cursorLengthStep);
+                sum += cursor.getPosition()[0];
+            }
+            return sum;
+        });
+
+        //random ranges of t for the arc length benchmarks
+        std::vector<std::pair<float, float>> ranges(queriesPerCall);
+        for(auto &range : ranges)
+        {
+            float a = tDistribution(gen), b = tDistribution(gen);
+            range = std::make_pair(std::min(a, b), std::max(a, b));
+        }
+
+        runner.run(factory.name, "arcLength", vectorOps, size, dimension, queriesPerCall, [&]() {
+            float sum = 0;
+            for(const auto &range : ranges)
+                sum += spline->arcLength(range.first, range.second);
+            return sum;
+        });
+        runner.run(factory.name, "totalLength", vectorOps, size, dimension, 1, [&]() {
+            return spline->totalLength();
+        });
+
+        if(factory.looping)
+        {
+            auto loopingSpline = std::static_pointer_cast<LoopingSpline<VectorType, float>>(spline);
+            runner.run(factory.name, "cyclicArcLength", vectorOps, size, dimension, queriesPerCall, [&]() {
+                float sum = 0;
+                for(const auto &range : ranges)
+                    sum += loopingSpline->cyclicArcLength(range.second, range.first);
+                return sum;
+            });
+        }
+
+        //solve for the end of a random fraction of the remaining length after each range's start
+        std::vector<float> desiredLengths(queriesPerCall);
+        std::uniform_real_distribution<float> fractionDistribution(0, 1);
+        for(size_t i = 0; i < queriesPerCall; i++)
+        {
+            desiredLengths[i] = spline->arcLength(ranges[i].first, maxT) * fractionDistribution(gen);
+        }
+
+        runner.run(factory.name, "ArcLength::solveLength", vectorOps, size, dimension, queriesPerCall, [&]() {
+            float sum = 0;
+            for(size_t i = 0; i < queriesPerCall; i++)
+                sum += ArcLength::solveLength(*spline, ranges[i].first, desiredLengths[i]);
+            return sum;
+        });
+
+        //slightly more than 100 pieces' worth, so that rounding error can't leave the last piece a hair short of the end of the spline
+        float pieceLength = spline->totalLength() / 100.5f;
+        runner.run(factory.name, "ArcLength::partition", vectorOps, size, dimension, 1, [&]() {
+            return ArcLength::partition(*spline, pieceLength).back();
+        });
+        runner.run(factory.name, "ArcLength::partitionN", vectorOps, size, dimension, 1, [&]() {
+            return ArcLength::partitionN(*spline, 100).back();
+        });
+        runner.run(factory.name, "ArcLength::partitionN (all threads)", vectorOps, size, dimension, 1, [&]() {
+            return ArcLength::partitionN(*spline, 100, 0).back();
+        });
+
+        runner.run(factory.name, "SplineInverter construct", vectorOps, size, dimension, 1, [&]() {
+            SplineInverter<VectorType, float, dimension> inverter(*spline);
+            return inverter.findClosestT(points[0]);
+        });
+
+        //what an interactive edit of one point costs, compared to constructing a new inverter. the spline doesn't actually change, but the work is the same
+        SplineInverter<VectorType, float, dimension> inverter(*spline);
+        size_t refitSegment = spline->segmentCount() / 2;
+        runner.run(factory.name, "SplineInverter::refit (4 segments)", vectorOps, size, dimension, 1, [&]() {
+            inverter.refit(refitSegment - 2, refitSegment + 2);
+            return inverter.findClosestT(points[0]);
+        });
+        runner.run(factory.name, "SplineInverter::rebuild", vectorOps, size, dimension, 1, [&]() {
+            inverter.rebuild();
+            return inverter.findClosestT(points[0]);
+        });
+
+        //query points a short distance away from the spline, so that each query has a well-defined closest point
+        std::uniform_real_distribution<float> offsetDistribution(-1, 1);
+        std::vector<VectorType> queryPoints(queriesPerCall);
+        for(auto &queryPoint : queryPoints)
+        {
+            queryPoint = spline->getPosition(tDistribution(gen));
+            for(size_t d = 0; d < dimension; d++)
+                queryPoint[d] += offsetDistribution(gen);
+        }
+
+        runner.run(factory.name, "SplineInverter::findClosestT", vectorOps, size, dimension, queriesPerCall, [&]() {
+            float sum = 0;
+            for(const auto &queryPoint : queryPoints)
+                sum += inverter.findClosestT(queryPoint);
+            return sum;
+        });
+
+        std::vector<float> closestT(queriesPerCall);
+        runner.run(factory.name, "SplineInverter::findClosestT (batch, 1 thread)", vectorOps, size, dimension, queriesPerCall, [&]() {
+            inverter.findClosestT(queryPoints.data(), queryPoints.size(), closestT.data(), 1);
+            return closestT.back();
+        });
+
+        //a point moving along next to the spline, like a vehicle being snapped to its lane every frame
+        std::vector<VectorType> trackPoints(queriesPerCall);
+        for(size_t i = 0; i < trackPoints.size(); i++)
+        {
+            trackPoints[i] = spline->getPosition(std::fmod(i * 0.05f, spline->getMaxT()));
+            for(size_t d = 0; d < dimension; d++)
+                trackPoints[i][d] += offsetDistribution(gen) * 0.1f;
+        }
+
+        runner.run(factory.name, "SplineInverter::findClosestT (tracking)", vectorOps, size, dimension, queriesPerCall, [&]() {
+            float sum = 0;
+            for(const auto &queryPoint : trackPoints)
+                sum += inverter.findClosestT(queryPoint);
+            return sum;
+        });
+        runner.run(factory.name, "SplineInverter::findClosestT (tracking, coherent)", vectorOps, size, dimension, queriesPerCall, [&]() {
+            float sum = 0;
+            float hintT = 0;
+            for(const auto &queryPoint : trackPoints)
+            {
+                hintT = inverter.findClosestT(queryPoint, hintT);
+                sum += hintT;
+            }
+            return sum;
+        });
+
+        std::vector<VectorType> polyline(Tessellation::countPoints(*spline, 0.01f, 0.0f));
+        runner.run(factory.name, "Tessellation::tessellate", vectorOps, size, dimension, 1, [&]() {
+            Tessellation::tessellate(*spline, 0.01f, 0.0f, polyline.data(), polyline.size());
+            return polyline.back()[0];
+        });
+
+        runner.run(factory.name, "GpuSplineBuffer::addSpline", vectorOps, size, dimension, 1, [&]() {
+            GpuSplineBuffer<VectorType, float, dimension> buffer;
+            buffer.addSpline(*spline);
+            return buffer.curveData()[0].totalLength;
+        });
+
+        GpuSplineBuffer<VectorType, float, dimension> gpuBuffer;
+        gpuBuffer.addSpline(*spline);
+        runner.run(factory.name, "GpuSplineBuffer::tForLength (reference)", vectorOps, size, dimension, queriesPerCall, [&]() {
+            float sum = 0;
+            float totalLength = gpuBuffer.curveData()[0].totalLength;
+            for(size_t i = 0; i < queriesPerCall; i++)
+                sum += gpuBuffer.tForLength(0, totalLength * i / queriesPerCall);
+            return sum;
+        });
+
+        //loading a prebuilt spline from an archive, to compare against "construct", and evaluating it in place
+        SplineArchiveWriter<VectorType, float, dimension> archiveWriter;
+        archiveWriter.addSpline(*spline);
+        std::vector<char> archiveData = archiveWriter.serialize();
+        runner.run(factory.name, "SplineArchiveView load", vectorOps, size, dimension, 1, [&]() {
+            SplineArchiveView<VectorType, float, dimension> view(archiveData.data(), archiveData.size());
+            return view.makeSpline(0)->getMaxT();
+        });
+
+        SplineArchiveView<VectorType, float, dimension> archiveView(archiveData.data(), archiveData.size());
+        auto mappedSpline = archiveView.makeSpline(0);
+        runner.run(factory.name, "MappedSpline getPosition", vectorOps, size, dimension, evaluationsPerCall, [&]() {
+            float sum = 0;
+            for(float t : tValues)
+                sum += mappedSpline->getPosition(t)[0];
+            return sum;
+        });
+
+        runner.run(factory.name, "SplineBoundsTree construct", vectorOps, size, dimension, 1, [&]() {
+            SplineBoundsTree<VectorType, float, dimension> tree(*spline);
+            return tree.findClosestT(points[0]);
+        });
+
+        SplineBoundsTree<VectorType, float, dimension> tree(*spline);
+        runner.run(factory.name, "SplineBoundsTree::findClosestT", vectorOps, size, dimension, queriesPerCall, [&]() {
+            float sum = 0;
+            for(const auto &queryPoint : queryPoints)
+                sum += tree.findClosestT(queryPoint);
+            return sum;
+        });
+
+        //level of detail tables with 16 samples per segment, to compare against getPosition
+        typedef SplineLodTable<VectorType, float, dimension> LodTable;
+        LodTable cubicTable(*spline, spline->segmentCount() * 16 + 1, LodTable::Cubic);
+        LodTable quantizedTable(*spline, spline->segmentCount() * 16 + 1, LodTable::Linear, true);
+        runner.run(factory.name, "SplineLodTable getPosition (cubic)", vectorOps, size, dimension, evaluationsPerCall, [&]() {
+            float sum = 0;
+            for(float t : tValues)
+                sum += cubicTable.getPosition(t)[0];
+            return sum;
+        });
+        runner.run(factory.name, "SplineLodTable getPosition (linear, quantized)", vectorOps, size, dimension, evaluationsPerCall, [&]() {
+            float sum = 0;
+            for(float t : tValues)
+                sum += quantizedTable.getPosition(t)[0];
+            return sum;
+        });
+
+        runner.run(factory.name, "SplineSegmentBounds construct", vectorOps, size, dimension, 1, [&]() {
+            SplineSegmentBounds<VectorType, float, dimension> segmentBounds(*spline);
+            return segmentBounds.getBounds().max[0];
+        });
+
+        //culling with a small box around each query point, the way a renderer would check a spline against one cell of a grid
+        SplineSegmentBounds<VectorType, float, dimension> segmentBounds(*spline);
+        runner.run(factory.name, "SplineSegmentBounds::findSegmentsInBox", vectorOps, size, dimension, queriesPerCall, [&]() {
+            float sum = 0;
+            VectorType extent;
+            for(size_t d = 0; d < dimension; d++)
+                extent[d] = 0.5f;
+            for(const auto &queryPoint : queryPoints)
+                sum += segmentBounds.findSegmentsInBox(queryPoint - extent, queryPoint + extent).size();
+            return sum;
+        });
+    }
+
+    //building many small natural splines at once, against building each one alone. each call builds the whole batch
+    template<size_t dimension>
+    void benchmarkNaturalBatch(BenchmarkRunner &runner, size_t size, std::mt19937 &gen)
+    {
+        typedef Vector<dimension, float> VectorType;
+        const char *vectorOps = __VectorPrivate::VectorOps<dimension, float>::name;
+        const size_t batchSize = 256;
+
+        std::vector<std::vector<VectorType>> pointSets;
+        for(size_t i = 0; i < batchSize; i++)
+        {
+            pointSets.push_back(makeRandomPoints<dimension>(gen, size));
+        }
+
+        runner.run("Natural", "construct x256", vectorOps, size, dimension, batchSize, [&]() {
+            float sum = 0;
+            for(const auto &points : pointSets)
+                sum += NaturalSpline<VectorType>(points, true, 0.5f).getMaxT();
+            return sum;
+        });
+        runner.run("Natural", "createBatch x256", vectorOps, size, dimension, batchSize, [&]() {
+            return NaturalSpline<VectorType>::createBatch(pointSets, 0.5f).back().getMaxT();
+        });
+        runner.run("Natural", "createBatch x256 (all threads)", vectorOps, size, dimension, batchSize, [&]() {
+            return NaturalSpline<VectorType>::createBatch(pointSets, 0.5f, 0).back().getMaxT();
+        });
+        runner.run("LoopingNatural", "construct x256", vectorOps, size, dimension, batchSize, [&]() {
+            float sum = 0;
+            for(const auto &points : pointSets)
+                sum += LoopingNaturalSpline<VectorType>(points, 0.5f).getMaxT();
+            return sum;
+        });
+        runner.run("LoopingNatural", "createBatch x256", vectorOps, size, dimension, batchSize, [&]() {
+            return LoopingNaturalSpline<VectorType>::createBatch(pointSets, 0.5f).back().getMaxT();
+        });
+    }
+
+    //keeping a spline over the most recent points of a stream: rebuilding from a copy of the window after every new point, against pushing into a sliding window
+    //each call takes in 256 new points, and evaluates the newest part of the spline after each one
+    template<size_t dimension>
+    void benchmarkSlidingWindow(BenchmarkRunner &runner, size_t size, std::mt19937 &gen)
+    {
+        typedef Vector<dimension, float> VectorType;
+        const char *vectorOps = __VectorPrivate::VectorOps<dimension, float>::name;
+        const size_t pushCount = 256;
+
+        std::vector<VectorType> stream = makeRandomPoints<dimension>(gen, size + pushCount);
+
+        runner.run("UniformCR", "copy window + construct x256", vectorOps, size, dimension, pushCount, [&]() {
+            float sum = 0;
+            for(size_t i = 0; i < pushCount; i++)
+            {
+                std::vector<VectorType> window(stream.begin() + i, stream.begin() + i + size);
+                UniformCRSpline<VectorType> spline(window);
+                sum += spline.getPosition(spline.getMaxT() - 0.5f)[0];
+            }
+            return sum;
+        });
+
+        //double t, since the stream's t keeps growing
+        SlidingWindowUniformCRSpline<VectorType, double> window(size);
+        for(size_t i = 0; i < size; i++)
+        {
+            window.push(stream[i]);
+        }
+        runner.run("SlidingWindowUniformCR", "push x256", vectorOps, size, dimension, pushCount, [&]() {
+            float sum = 0;
+            for(size_t i = 0; i < pushCount; i++)
+            {
+                window.push(stream[size + i]);
+                sum += window.getPosition(window.getMaxT() - 0.5)[0];
+            }
+            return sum;
+        });
+    }
+
+    template<size_t dimension>
+    void benchmarkDimension(BenchmarkRunner &runner, const std::vector<size_t> &sizes)
+    {
+        //fixed seed, so that every run measures the same splines
+        std::mt19937 gen(12345);
+
+        for(const auto &factory : makeFactories<dimension>())
+        {
+            for(size_t size : sizes)
+            {
+                benchmarkSpline(runner, factory, makeRandomPoints<dimension>(gen, size), gen);
+            }
+        }
+
+        for(size_t size : sizes)
+        {
+            benchmarkNaturalBatch<dimension>(runner, size, gen);
+            benchmarkSlidingWindow<dimension>(runner, size, gen);
+        }
+    }
+
+    void printUsage(const char *program)
+    {
+        std::cout << "usage: " << program << " [options]" << std::endl
+                  << "  --json FILE     also write the results to FILE as JSON" << std::endl
+                  << "  --filter TEXT   only run benchmarks whose \"SplineType/operation\" name contains TEXT" << std::endl
+                  << "  --samples N     number of timed samples per benchmark (default 10)" << std::endl
+                  << "  --quick         fewer samples, shorter samples, and only the smaller spline sizes" << std::endl;
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    std::string jsonPath;
+    std::string filter;
+    size_t samples = 10;
+    double minSampleSeconds = 0.002;
+    std::vector<size_t> sizes {16, 256, 4096};
+
+    for(int i = 1; i < argc; i++)
+    {
+        std::string arg = argv[i];
+        if(arg == "--json" && i + 1 < argc)
+        {
+            jsonPath = argv[++i];
+        }
+        else if(arg == "--filter" && i + 1 < argc)
+        {
+            filter = argv[++i];
+        }
+        else if(arg == "--samples" && i + 1 < argc)
+        {
+            samples = std::max(1, std::atoi(argv[++i]));
+        }
+        else if(arg == "--quick")
+        {
+            samples = 3;
+            minSampleSeconds = 0.0005;
+            sizes = {16, 256};
+        }
+        else
+        {
+            printUsage(argv[0]);
+            return arg == "--help" ? 0 : 1;
+        }
+    }
+
+    BenchmarkRunner runner(samples, minSampleSeconds, filter);
+    benchmarkDimension<2>(runner, sizes);
+    benchmarkDimension<3>(runner, sizes);
+
+    if(!jsonPath.empty())
+    {
+        std::ofstream jsonFile(jsonPath);
+        if(!jsonFile)
+        {
+            std::cerr << "couldn't open " << jsonPath << " for writing" << std::endl;
+            return 1;
+        }
+        runner.writeJson(jsonFile);
+    }
+
+    return 0;
+}
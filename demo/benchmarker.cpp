@@ -2,12 +2,21 @@
 
 #include <vector>
 #include <memory>
+#include <chrono>
+#include <atomic>
+#include <thread>
+#include <limits>
 
 #include <QVector2D>
 #include <QVector3D>
 #include <QTime>
+#include <QThread>
+#include <QThreadPool>
+#include <QtConcurrent>
 
 #include "spline_library/utils/arclength.h"
+#include "spline_library/utils/splineinverter.h"
+#include "spline_library/utils/instrumentation.h"
 #include "spline_library/splines/generic_b_spline.h"
 #include "spline_library/splines/uniform_cr_spline.h"
 #include "spline_library/splines/natural_spline.h"
@@ -43,11 +52,97 @@ QMap<QString, float> Benchmarker::runBenchmark(void)
         return result;
     };
 
+    //tag every result with the Vector implementation in use, so that results from a scalar build (see SplineDemo.pro) can be compared against a SIMD build
+    QString vectorOps = QString(" (%1)").arg(__VectorPrivate::VectorOps<D, FloatingT>::name);
+
+    QMap<QString, float> results;
+    timeSplineMemberFunction(results, &Benchmarker::testArcLength, crSpline, "uniform_cr[10]" + vectorOps,    10000, 12);
+    timeSplineMemberFunction(results, &Benchmarker::testArcLength, crSpline, "uniform_cr[1000]" + vectorOps,  1000, 1002);
+    timeSplineMemberFunction(results, &Benchmarker::testArcLength, genericBSpline, "bspline[10]" + vectorOps,    1000, 16);
+    timeSplineMemberFunction(results, &Benchmarker::testArcLength, genericBSpline, "bspline[1000]" + vectorOps,  100, 1006);
+    timeSplineMemberFunction(results, &Benchmarker::testPosition, crSpline, "uniform_cr position[1000]" + vectorOps,  100000, 1002);
+
+    return results;
+}
+
+QMap<QString, float> Benchmarker::runScalingBenchmark(void)
+{
+    canceled = false;
+
+    std::uniform_real_distribution<FloatingT> distribution(10,15);
+    auto randomSource = [this, &distribution]() {
+        return distribution(this->gen);
+    };
+
+    //every workload shares this one spline, and this one inverter, the same way a program's threads would
+    gen.seed(10);
+    auto points = randomPoints_Uniform<VectorT, D, FloatingT>(randomSource, 1000);
+    LoopingUniformCRSpline<VectorT, FloatingT> spline(points);
+    SplineInverter<VectorT, FloatingT> inverter(spline);
+
+    FloatingT maxT = spline.getMaxT();
+    FloatingT averageSegmentLength = spline.totalLength() / spline.segmentCount();
+
+    auto position = [&spline, maxT](int queries, std::minstd_rand &threadGen) {
+        std::uniform_real_distribution<FloatingT> dist(0, maxT);
+        float sum = 0;
+        for(int q = 0; q < queries; q++)
+        {
+            sum += spline.getPosition(dist(threadGen))[0];
+        }
+        return sum;
+    };
+    auto arcLength = [&spline, maxT](int queries, std::minstd_rand &threadGen) {
+        std::uniform_real_distribution<FloatingT> dist(0, maxT);
+        float sum = 0;
+        for(int q = 0; q < queries; q++)
+        {
+            FloatingT a = dist(threadGen);
+            FloatingT b = dist(threadGen);
+            sum += spline.cyclicArcLength(a, b);
+        }
+        return sum;
+    };
+    auto solveLength = [&spline, maxT, averageSegmentLength](int queries, std::minstd_rand &threadGen) {
+        std::uniform_real_distribution<FloatingT> dist(0, maxT);
+        std::uniform_real_distribution<FloatingT> lengthDist(0, averageSegmentLength * 4);
+        float sum = 0;
+        for(int q = 0; q < queries; q++)
+        {
+            FloatingT a = dist(threadGen);
+            sum += ArcLength::solveLength(spline, a, lengthDist(threadGen));
+        }
+        return sum;
+    };
+    auto closestT = [&inverter](int queries, std::minstd_rand &threadGen) {
+        std::uniform_real_distribution<FloatingT> dist(10, 15);
+        auto threadRandomSource = [&dist, &threadGen]() {
+            return dist(threadGen);
+        };
+        float sum = 0;
+        for(int q = 0; q < queries; q++)
+        {
+            sum += inverter.findClosestT(makeRandomPoint<VectorT, D, FloatingT>(threadRandomSource));
+        }
+        return sum;
+    };
+
+    //double the thread count each time, and always finish with one thread per hardware thread
+    std::vector<int> threadCounts;
+    int maxThreads = std::max(1, QThread::idealThreadCount());
+    for(int threadCount = 1; threadCount < maxThreads; threadCount *= 2)
+    {
+        threadCounts.push_back(threadCount);
+    }
+    threadCounts.push_back(maxThreads);
+
+    QString vectorOps = QString(" (%1)").arg(__VectorPrivate::VectorOps<D, FloatingT>::name);
+
     QMap<QString, float> results;
-    timeSplineMemberFunction(results, &Benchmarker::testArcLength, crSpline, "uniform_cr[10]",    10000, 12);
-    timeSplineMemberFunction(results, &Benchmarker::testArcLength, crSpline, "uniform_cr[1000]",  1000, 1002);
-    timeSplineMemberFunction(results, &Benchmarker::testArcLength, genericBSpline, "bspline[10]",    1000, 16);
-    timeSplineMemberFunction(results, &Benchmarker::testArcLength, genericBSpline, "bspline[1000]",  100, 1006);
+    timeScaling(results, position, "uniform_cr position[1000]" + vectorOps, 100000, threadCounts);
+    timeScaling(results, arcLength, "uniform_cr cyclicArcLength[1000]" + vectorOps, 10000, threadCounts);
+    timeScaling(results, solveLength, "uniform_cr solveLength[1000]" + vectorOps, 5000, threadCounts);
+    timeScaling(results, closestT, "uniform_cr findClosestT[1000]" + vectorOps, 5000, threadCounts);
 
     return results;
 }
@@ -69,6 +164,7 @@ void Benchmarker::timeSplineMemberFunction(
     int totalElapsed = 0;
     gen.seed(10);
     QTime t;
+    SplineInstrumentation::Counters counters;
 
     for(int i = 0; i < repeats; i++) {
         if(canceled) return;
@@ -76,13 +172,105 @@ void Benchmarker::timeSplineMemberFunction(
         emit setProgressValue(i);
         auto spline = splineFunction(size);
 
+        auto countersBegin = SplineInstrumentation::threadSnapshot();
         t.start();
         (this->*testFunction)(queries, *spline);
         totalElapsed += t.elapsed();
+        counters += SplineInstrumentation::threadSnapshot() - countersBegin;
     }
     emit setProgressValue(repeats);
 
     results[message] = 1000 * float(totalElapsed) / (repeats * queries);
+
+    //when the library is built with instrumentation, also report what it counted, per query
+    if(SplineInstrumentation::enabled)
+    {
+        for(size_t i = 0; i < SplineInstrumentation::CounterCount; i++)
+        {
+            auto counter = SplineInstrumentation::Counter(i);
+            if(counters.counts[counter] > 0)
+                results[message + " " + SplineInstrumentation::counterName(counter)] = float(counters.counts[counter]) / (repeats * queries);
+        }
+    }
+}
+
+void Benchmarker::timeScaling(
+        QMap<QString, float>& results,
+        const ScalingWorkload &workload,
+        QString message, int queries, const std::vector<int> &threadCounts) {
+
+    //fewer repeats than the single threaded benchmarks, since each one runs on every thread count
+    int scalingRepeats = 5;
+
+    emit setProgressText(message);
+    emit setProgressRange(0, int(threadCounts.size()) * scalingRepeats);
+
+    double singleThroughput = 0;
+    for(size_t i = 0; i < threadCounts.size(); i++) {
+        int threadCount = threadCounts[i];
+
+        //take the fastest repeat, since anything else the machine is doing can only slow a repeat down
+        double fastest = std::numeric_limits<double>::max();
+        for(int r = 0; r < scalingRepeats; r++) {
+            if(canceled) return;
+
+            emit setProgressValue(int(i) * scalingRepeats + r);
+            fastest = std::min(fastest, timeThreads(workload, queries, threadCount));
+        }
+
+        //queries per microsecond, across every thread
+        double throughput = double(queries) * threadCount / (fastest * 1e6);
+        if(i == 0)
+            singleThroughput = throughput;
+
+        //pad the thread count so that the results sort in order
+        QString label = QString("%1 threads=%2").arg(message).arg(threadCount, 2, 10, QChar('0'));
+        results[label + " throughput (queries/us)"] = float(throughput);
+        results[label + " speedup"] = float(throughput / singleThroughput);
+    }
+    emit setProgressValue(int(threadCounts.size()) * scalingRepeats);
+}
+
+double Benchmarker::timeThreads(const ScalingWorkload &workload, int queries, int threadCount)
+{
+    QThreadPool pool;
+    pool.setMaxThreadCount(threadCount);
+
+    //hold every thread at the start until all of them are running, so that thread startup isn't timed, and the threads really do run side by side
+    std::atomic<int> ready(0);
+    std::atomic<bool> start(false);
+
+    QList<QFuture<float>> futures;
+    for(int i = 0; i < threadCount; i++) {
+        futures.append(QtConcurrent::run(&pool, [&workload, &ready, &start, queries, i]() {
+            //each thread gets its own generator, so that they don't share one, which would be contention the library isn't responsible for
+            std::minstd_rand threadGen(i + 1);
+
+            ready.fetch_add(1);
+            while(!start.load())
+                std::this_thread::yield();
+
+            return workload(queries, threadGen);
+        }));
+    }
+
+    while(ready.load() < threadCount)
+        std::this_thread::yield();
+
+    auto begin = std::chrono::steady_clock::now();
+    start.store(true);
+
+    float sum = 0;
+    for(auto &future : futures) {
+        sum += future.result();
+    }
+    auto end = std::chrono::steady_clock::now();
+
+    //keep the sum alive, so that the compiler can't see that it's unused
+    volatile float sink = sum;
+    (void)sink;
+
+    return std::chrono::duration<double>(end - begin).count();
 }
 
 void Benchmarker::testArcLength(int queries, const LoopingSpline<VectorT, FloatingT> &spline)
@@ -98,3 +286,15 @@ void Benchmarker::testArcLength(int queries, const LoopingSpline<VectorT, Floati
     }
 }
 
+
+void Benchmarker::testPosition(int queries, const LoopingSpline<VectorT, FloatingT> &spline)
+{
+    std::uniform_real_distribution<FloatingT> dist(0, spline.getMaxT());
+
+    for(int q = 0; q < queries; q++)
+    {
+        FloatingT t = dist(gen);
+
+        VectorT result = spline.getPosition(t);
+    }
+}
@@ -31,6 +31,10 @@ signals:
 public slots:
     QMap<QString, float> runBenchmark(void);
 
+    //run each workload on one shared spline from 1 thread up to one thread per hardware thread, and report the throughput and the speedup over 1 thread
+    //if a cache or lazy state in the library makes the threads contend with each other, the speedup stops growing with the thread count
+    QMap<QString, float> runScalingBenchmark(void);
+
     void cancel(void);
 
 private:
@@ -43,6 +47,16 @@ private:
     //**********
     //all of these functions can change based on whatever you want - i just needed a common place to put performance comparisons
     void testArcLength(int queries, const SplineType &spline);
+    void testPosition(int queries, const SplineType &spline);
+
+    //a workload for the scaling benchmark runs the given number of queries with the given generator, which belongs to the thread running it
+    //it returns the sum of its results, so that the queries can't be optimized away
+    typedef std::function<float(int, std::minstd_rand&)> ScalingWorkload;
+
+    void timeScaling(QMap<QString, float>& results, const ScalingWorkload &workload, QString message, int queries, const std::vector<int> &threadCounts);
+
+    //seconds for threadCount threads to each run the workload once, all starting at once
+    double timeThreads(const ScalingWorkload &workload, int queries, int threadCount);
 
 private://support stuff
 
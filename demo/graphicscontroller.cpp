@@ -7,11 +7,13 @@
 
 #include <QVector2D>
 #include <QVector3D>
+#include <QPolygonF>
 
 #include <ctime>
 #include <algorithm>
 
 #include "spline_library/utils/splineinverter.h"
+#include "spline_library/utils/tessellation.h"
 #include "spline_library/splines/natural_spline.h"
 #include "spline_library/splines/cubic_hermite_spline.h"
 
@@ -221,22 +223,37 @@ void GraphicsController::createDistanceField(const QString &filename)
     float base = 1 / (float(supersampling) * 2);
     float step = 1 / float(supersampling);
 
-	//for every pixel in the image, determine the closest T value
+	//gather every supersampled point in the image, so that the closest T values can all be computed in one multithreaded batch
+    std::vector<QVector2D> queryPoints;
+    queryPoints.reserve(output.width() * output.height() * totalSamples);
 	for(int y = 0; y < output.height(); y++)
 	{
 		for(int x = 0; x < output.width(); x++)
 		{
 			//use 2x supersampling, with a simple grid
-            QVector3D colorVector;
 			for(int dy = 0; dy < supersampling; dy++) {
 				for(int dx = 0; dx < supersampling; dx++) {
-                    QVector2D realPoint(
+                    queryPoints.emplace_back(
 						x + base + dx * step,
                         y + base + dy * step);
-                    float tfast = calc.findClosestT(realPoint);
-                    colorVector += getColor(tfast);
 				}
 			}
+		}
+    }
+
+    std::vector<float> closestT(queryPoints.size());
+    calc.findClosestT(queryPoints.data(), queryPoints.size(), closestT.data());
+
+	//for every pixel in the image, average the colors of its samples
+    size_t sampleIndex = 0;
+	for(int y = 0; y < output.height(); y++)
+	{
+		for(int x = 0; x < output.width(); x++)
+		{
+            QVector3D colorVector;
+            for(int i = 0; i < totalSamples; i++) {
+                colorVector += getColor(closestT[sampleIndex++]);
+			}
 
 			output.setPixel(x,y,
 				qRgb(
@@ -354,53 +371,22 @@ QVector3D GraphicsController::getColor(float t) const
 
 void GraphicsController::drawSpline(QPainter &painter, const Spline<QVector2D> &s, const QColor &color)
 {
-    //draw the spline
-    float stepSize = 0.25;
-    float currentStep = stepSize;
-    float limit = s.getMaxT() + 0.01;
+    //the spline can't get more than a third of a pixel away from the line we draw
+    float maxChordError = 0.3f;
 
-    painter.setPen(color);
+    //ask how many points there will be first, so that the buffer only has to be allocated once
+    std::vector<QVector2D> points(Tessellation::countPoints(s, maxChordError, 0.0f));
+    Tessellation::tessellate(s, maxChordError, 0.0f, points.data(), points.size());
 
-    while(currentStep <= limit)
+    QPolygonF polyline;
+    polyline.reserve(int(points.size()));
+    for(const auto &point : points)
     {
-        drawSplineSegment(painter, s, currentStep - stepSize, currentStep);
-        currentStep += stepSize;
+        polyline.append(QPointF(point.x(), point.y()));
     }
-}
 
-void GraphicsController::drawSplineSegment(QPainter &painter, const Spline<QVector2D> &s, float beginT, float endT)
-{
-    auto beginData = s.getPosition(beginT);
-    auto endData = s.getPosition(endT);
-
-    float middleT = (beginT + endT) * .5f;
-
-    QVector2D midExpected = (beginData + endData) * .5f;
-    auto midActual = s.getPosition((beginT + endT) * .5f);
-
-
-
-    //if the difference in T is too small, we're almost certainly at a break point in the spline
-    //this obviously isn't supposed to happen, but if there's a bug in the spline code that creates a break, we want to show it
-    float minDelta = .001f;
-    float maxDistance = .1f;
-    if((endT - beginT) > minDelta)
-    {
-        //if the actual midpoint is too far away from the expected midpoint, subdivide and try again
-        if((midExpected - midActual).lengthSquared() > maxDistance)
-        {
-            drawSplineSegment(painter, s, beginT, middleT);
-            drawSplineSegment(painter, s, middleT, endT);
-        }
-        else
-        {
-
-            painter.drawLine(
-                QPointF(beginData.x(),beginData.y()),
-                QPointF(endData.x(),endData.y())
-                );
-        }
-    }
+    painter.setPen(color);
+    painter.drawPolyline(polyline);
 }
 
 
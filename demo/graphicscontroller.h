@@ -54,11 +54,6 @@ protected:
 private:
 
      void drawSpline(QPainter &painter, const Spline<QVector2D> &s, const QColor &color);
-     void drawSplineSegment(
-             QPainter &painter,
-             const Spline<QVector2D> &s,
-             float beginT,
-             float endT);
 
      void drawSplineDerivative(QPainter &painter, const Spline<QVector2D> &s, const QColor &color);
      void drawSplineSegmentDerivative(
@@ -92,7 +92,10 @@ void MainWindow::keyPressEvent(QKeyEvent *event)
         createDistanceField();
         break;
     case Qt::Key_B:
-        runBenchmark();
+        runBenchmark(&Benchmarker::runBenchmark, "ns");
+        break;
+    case Qt::Key_M:
+        runBenchmark(&Benchmarker::runScalingBenchmark, "");
         break;
     case Qt::Key_I:
 		addVertex();
@@ -384,7 +387,7 @@ void MainWindow::createDistanceField(void)
 	}
 }
 
-void MainWindow::runBenchmark(void)
+void MainWindow::runBenchmark(QMap<QString, float>(Benchmarker::*benchmark)(void), const QString &unit)
 {
     //if the benchmarker is non-null, there's already one running
     if(benchmarker != nullptr)
@@ -401,7 +404,7 @@ void MainWindow::runBenchmark(void)
     connect(&dialog, &QProgressDialog::canceled, benchmarker, &Benchmarker::cancel);
 
     //begin the task
-    auto future = QtConcurrent::run(benchmarker, &Benchmarker::runBenchmark);
+    auto future = QtConcurrent::run(benchmarker, benchmark);
 
     //use a futurewatcher to know when the task is complete. when it is, close the progress dialog
     QFutureWatcher<void> watcher;
@@ -423,7 +426,7 @@ void MainWindow::runBenchmark(void)
         auto result = future.result();
         for(auto it = result.cbegin(); it != result.cend(); it++)
         {
-            resultText += QString("%1: %2ns\n").arg(it.key(), QString::number(it.value(), 'f', 2));
+            resultText += QString("%1: %2%3\n").arg(it.key(), QString::number(it.value(), 'f', 2), unit);
         }
 
 
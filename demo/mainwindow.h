@@ -4,6 +4,7 @@
 #include <vector>
 
 #include <QWidget>
+#include <QMap>
 
 #include "spline_library/spline.h"
 #include "spline_library/utils/splineinverter.h"
@@ -56,7 +57,8 @@ private: //methods
 
 	void createDistanceField(void);
 
-    void runBenchmark(void);
+    //run one of the benchmarker's benchmarks in the background, then show its results, with unit after each value
+    void runBenchmark(QMap<QString, float>(Benchmarker::*benchmark)(void), const QString &unit);
 
 
 private: //data
@@ -1,6 +1,8 @@
 #pragma once
 
 #include <vector>
+#include <array>
+#include <algorithm>
 
 #include "utils/spline_common.h"
 #include "utils/calculus.h"
@@ -25,6 +27,13 @@ public:
     virtual InterpolatedPTC getCurvature(floating_t x) const = 0;
     virtual InterpolatedPTCW getWiggle(floating_t x) const = 0;
 
+    //batch versions of the above. evaluate every t value in tValues and write the results to the corresponding element of output
+    //consecutive t values that land in the same or an adjacent segment skip the segment search, so sorted input is fastest
+    virtual void getPositions(const floating_t *tValues, size_t count, InterpolationType *output) const = 0;
+    virtual void getTangents(const floating_t *tValues, size_t count, InterpolatedPT *output) const = 0;
+    virtual void getCurvatures(const floating_t *tValues, size_t count, InterpolatedPTC *output) const = 0;
+    virtual void getWiggles(const floating_t *tValues, size_t count, InterpolatedPTCW *output) const = 0;
+
     virtual floating_t arcLength(floating_t a, floating_t b) const = 0;
     virtual floating_t totalLength(void) const = 0;
     inline floating_t getMaxT(void) const { return maxT; }
@@ -32,17 +41,71 @@ public:
     const std::vector<InterpolationType> &getOriginalPoints(void) const { return originalPoints; }
     virtual bool isLooping(void) const = 0;
 
+    //evaluation never reads the original points, so they can be freed to save memory. getOriginalPoints will return an empty list afterwards
+    //restoreOriginalPoints brings them back, and returns false if this spline type can't rebuild them from its own data.
+    //a spline that supports editing its points restores them automatically before every edit
+    void discardOriginalPoints(void)
+    {
+        std::vector<InterpolationType>().swap(originalPoints);
+        originalPointsDiscarded = true;
+    }
+    bool restoreOriginalPoints(void)
+    {
+        if(originalPointsDiscarded && reconstructOriginalPoints(originalPoints))
+        {
+            originalPointsDiscarded = false;
+        }
+        return !originalPointsDiscarded;
+    }
+    inline bool hasOriginalPoints(void) const { return !originalPointsDiscarded; }
+
+    //the number of bytes used by this spline, including everything it has allocated
+    virtual size_t memoryFootprint(void) const = 0;
+
     //lower level functions
     virtual size_t segmentCount(void) const = 0;
     virtual size_t segmentForT(floating_t t) const = 0;
     virtual floating_t segmentT(size_t segmentIndex) const = 0;
     virtual floating_t segmentArcLength(size_t segmentIndex, floating_t a, floating_t b) const = 0;
 
+    //evaluate at t, which must already be inside the given segment, IE between segmentT(segmentIndex) and segmentT(segmentIndex + 1)
+    //this skips both the segment search and, for looping splines, wrapping t. see SplineCursor for an easy way to use them
+    virtual InterpolationType getPositionInSegment(size_t segmentIndex, floating_t t) const = 0;
+    virtual InterpolatedPT getTangentInSegment(size_t segmentIndex, floating_t t) const = 0;
+    virtual InterpolatedPTC getCurvatureInSegment(size_t segmentIndex, floating_t t) const = 0;
+    virtual InterpolatedPTCW getWiggleInSegment(size_t segmentIndex, floating_t t) const = 0;
+
+    //choose how segment arc lengths are numerically integrated. this affects arcLength, totalLength, and everything in ArcLength
+    //the default is a fixed 13-point gauss-legendre quadrature. see SplineLibraryCalculus::QuadratureMode for the alternatives
+    inline void setArcLengthQuadrature(const SplineLibraryCalculus::QuadratureSettings<floating_t> &settings) { quadrature = settings; }
+    inline const SplineLibraryCalculus::QuadratureSettings<floating_t> &getArcLengthQuadrature(void) const { return quadrature; }
+
 protected:
-    const floating_t maxT;
+    floating_t maxT;
+
+    //only for splines that support editing their points in place
+    inline std::vector<InterpolationType> &editOriginalPoints(void) { return originalPoints; }
+
+    //for the splines' rebuild methods: replace the original points and maxT, reusing the points' memory. points may be this spline's own original points
+    inline void replaceOriginalPoints(const std::vector<InterpolationType> &points, floating_t newMaxT)
+    {
+        if(&points != &originalPoints)
+            originalPoints.assign(points.begin(), points.end());
+        originalPointsDiscarded = false;
+        maxT = newMaxT;
+    }
+
+    //rebuild the original points from the spline's own data after they've been discarded. only override this if the spline type can do it exactly
+    virtual bool reconstructOriginalPoints(std::vector<InterpolationType> &) const { return false; }
+
+    //the bytes allocated by the original points, for memoryFootprint
+    inline size_t originalPointsFootprint(void) const { return originalPoints.capacity() * sizeof(InterpolationType); }
 
 private:
-    const std::vector<InterpolationType> originalPoints;
+    std::vector<InterpolationType> originalPoints;
+    bool originalPointsDiscarded = false;
+
+    SplineLibraryCalculus::QuadratureSettings<floating_t> quadrature;
 };
 
 template<class InterpolationType, typename floating_t=float>
@@ -54,7 +117,7 @@ public:
     {}
 
     inline floating_t wrapT(floating_t t) const {
-        float wrappedT = std::fmod(t, maxT);
+        floating_t wrappedT = std::fmod(t, maxT);
         if(wrappedT < 0)
             return wrappedT + maxT;
         else
@@ -63,6 +126,73 @@ public:
     virtual floating_t cyclicArcLength(floating_t a, floating_t b) const = 0;
 };
 
+//the same interface as Spline, without any virtual functions, bound directly to a spline core, IE one of the *Common classes
+//templated code like ArcLength can be given one of these instead of a Spline reference, so that the calls in its inner loops inline instead of going through the vtable
+//get one from any spline with staticSpline(). it only points into the spline, so it must not outlive the spline, and it sees edits to the spline as they happen
+template<class SplineCoreT, bool looping>
+struct StaticSpline
+{
+    //the templated utilities expect a spline type with exactly two template parameters, so the core type and looping are bound ahead of time
+    template<class InterpolationType, typename floating_t>
+    class Interface
+    {
+    public:
+        typedef typename Spline<InterpolationType,floating_t>::InterpolatedPT InterpolatedPT;
+        typedef typename Spline<InterpolationType,floating_t>::InterpolatedPTC InterpolatedPTC;
+        typedef typename Spline<InterpolationType,floating_t>::InterpolatedPTCW InterpolatedPTCW;
+
+        Interface(const SplineCoreT &core, const floating_t &maxT, const SplineLibraryCalculus::QuadratureSettings<floating_t> &quadrature)
+            :core(&core), maxT(&maxT), quadrature(&quadrature)
+        {}
+
+        //every t value is wrapped first for looping splines, just like the virtual versions
+        inline InterpolationType getPosition(floating_t t) const { return core->getPosition(wrapIfLooping(t)); }
+        inline InterpolatedPT getTangent(floating_t t) const { return core->getTangent(wrapIfLooping(t)); }
+        inline InterpolatedPTC getCurvature(floating_t t) const { return core->getCurvature(wrapIfLooping(t)); }
+        inline InterpolatedPTCW getWiggle(floating_t t) const { return core->getWiggle(wrapIfLooping(t)); }
+
+        inline floating_t arcLength(floating_t a, floating_t b) const { return ArcLength::arcLength(*this, wrapIfLooping(a), wrapIfLooping(b)); }
+        inline floating_t cyclicArcLength(floating_t a, floating_t b) const
+        {
+            static_assert(looping, "cyclicArcLength is only available for looping splines");
+            return ArcLength::cyclicArcLength(*this, a, b);
+        }
+        inline floating_t totalLength(void) const { return ArcLength::totalLength(*this); }
+
+        inline floating_t getMaxT(void) const { return *maxT; }
+        inline bool isLooping(void) const { return looping; }
+
+        //same as LoopingSpline::wrapT
+        inline floating_t wrapT(floating_t t) const
+        {
+            floating_t wrappedT = std::fmod(t, *maxT);
+            if(wrappedT < 0)
+                return wrappedT + *maxT;
+            else
+                return wrappedT;
+        }
+
+        inline size_t segmentCount(void) const { return core->segmentCount(); }
+        inline size_t segmentForT(floating_t t) const { return core->segmentForT(wrapIfLooping(t)); }
+        inline floating_t segmentT(size_t segmentIndex) const { return core->segmentT(segmentIndex); }
+        inline floating_t segmentArcLength(size_t segmentIndex, floating_t a, floating_t b) const { return core->segmentLength(segmentIndex, a, b, *quadrature); }
+
+        inline InterpolationType getPositionInSegment(size_t segmentIndex, floating_t t) const { return core->positionInSegment(segmentIndex, t); }
+        inline InterpolatedPT getTangentInSegment(size_t segmentIndex, floating_t t) const { return core->tangentInSegment(segmentIndex, t); }
+        inline InterpolatedPTC getCurvatureInSegment(size_t segmentIndex, floating_t t) const { return core->curvatureInSegment(segmentIndex, t); }
+        inline InterpolatedPTCW getWiggleInSegment(size_t segmentIndex, floating_t t) const { return core->wiggleInSegment(segmentIndex, t); }
+
+        inline const SplineCoreT &getCore(void) const { return *core; }
+
+    private:
+        inline floating_t wrapIfLooping(floating_t t) const { return looping ? wrapT(t) : t; }
+
+        const SplineCoreT *core;
+        const floating_t *maxT;
+        const SplineLibraryCalculus::QuadratureSettings<floating_t> *quadrature;
+    };
+};
+
 
 
 
@@ -75,15 +205,33 @@ public:
     typename Spline<InterpolationType,floating_t>::InterpolatedPTC getCurvature(floating_t t) const override { return common.getCurvature(t); }
     typename Spline<InterpolationType,floating_t>::InterpolatedPTCW getWiggle(floating_t t) const override { return common.getWiggle(t); }
 
-    floating_t arcLength(floating_t a, floating_t b) const override { return ArcLength::arcLength(*this,a,b); }
-    floating_t totalLength(void) const override { return ArcLength::totalLength(*this); }
+    void getPositions(const floating_t *tValues, size_t count, InterpolationType *output) const override { common.getPositions(tValues, count, output); }
+    void getTangents(const floating_t *tValues, size_t count, typename Spline<InterpolationType,floating_t>::InterpolatedPT *output) const override { common.getTangents(tValues, count, output); }
+    void getCurvatures(const floating_t *tValues, size_t count, typename Spline<InterpolationType,floating_t>::InterpolatedPTC *output) const override { common.getCurvatures(tValues, count, output); }
+    void getWiggles(const floating_t *tValues, size_t count, typename Spline<InterpolationType,floating_t>::InterpolatedPTCW *output) const override { common.getWiggles(tValues, count, output); }
+
+    floating_t arcLength(floating_t a, floating_t b) const override { return staticSpline().arcLength(a, b); }
+    floating_t totalLength(void) const override { return staticSpline().totalLength(); }
 
     bool isLooping(void) const override { return false; }
 
     size_t segmentCount(void) const override { return common.segmentCount(); }
     size_t segmentForT(floating_t t) const override { return common.segmentForT(t); }
     floating_t segmentT(size_t segmentIndex) const override { return common.segmentT(segmentIndex); }
-    floating_t segmentArcLength(size_t segmentIndex, floating_t a, floating_t b) const override { return common.segmentLength(segmentIndex, a, b); }
+    floating_t segmentArcLength(size_t segmentIndex, floating_t a, floating_t b) const override { return common.segmentLength(segmentIndex, a, b, this->getArcLengthQuadrature()); }
+
+    InterpolationType getPositionInSegment(size_t segmentIndex, floating_t t) const override { return common.positionInSegment(segmentIndex, t); }
+    typename Spline<InterpolationType,floating_t>::InterpolatedPT getTangentInSegment(size_t segmentIndex, floating_t t) const override { return common.tangentInSegment(segmentIndex, t); }
+    typename Spline<InterpolationType,floating_t>::InterpolatedPTC getCurvatureInSegment(size_t segmentIndex, floating_t t) const override { return common.curvatureInSegment(segmentIndex, t); }
+    typename Spline<InterpolationType,floating_t>::InterpolatedPTCW getWiggleInSegment(size_t segmentIndex, floating_t t) const override { return common.wiggleInSegment(segmentIndex, t); }
+
+    size_t memoryFootprint(void) const override { return sizeof(*this) + this->originalPointsFootprint() + common.heapFootprint(); }
+
+    //this spline's core, and the same interface as above bound directly to it, for code that wants to call it without virtual dispatch. see StaticSpline
+    typedef SplineCore<InterpolationType, floating_t> CoreType;
+    typedef typename StaticSpline<CoreType, false>::template Interface<InterpolationType, floating_t> StaticSplineType;
+    inline const CoreType &getCore(void) const { return common; }
+    inline StaticSplineType staticSpline(void) const { return StaticSplineType(common, this->maxT, this->getArcLengthQuadrature()); }
 
 protected:
     //protected constructor and destructor, so that this class can only be used as a parent class, even though it won't have any pure virtual methods
@@ -92,6 +240,12 @@ protected:
     {}
     ~SplineImpl(void) = default;
 
+    //declaring the destructor would otherwise quietly turn every move of a spline into a copy
+    SplineImpl(const SplineImpl &) = default;
+    SplineImpl(SplineImpl &&) = default;
+    SplineImpl &operator=(const SplineImpl &) = default;
+    SplineImpl &operator=(SplineImpl &&) = default;
+
     SplineCore<InterpolationType, floating_t> common;
 };
 
@@ -106,16 +260,46 @@ public:
     typename Spline<InterpolationType,floating_t>::InterpolatedPTC getCurvature(floating_t globalT) const override { return common.getCurvature(wrapT(globalT)); }
     typename Spline<InterpolationType,floating_t>::InterpolatedPTCW getWiggle(floating_t globalT) const override { return common.getWiggle(wrapT(globalT)); }
 
-    floating_t arcLength(floating_t a, floating_t b) const override { return ArcLength::arcLength(*this, wrapT(a), wrapT(b)); }
-    floating_t cyclicArcLength(floating_t a, floating_t b) const override { return ArcLength::cyclicArcLength(*this, a, b); }
-    floating_t totalLength(void) const override { return ArcLength::totalLength(*this); }
+    void getPositions(const floating_t *tValues, size_t count, InterpolationType *output) const override
+    {
+        wrapBatch(tValues, count, output, [this](const floating_t *t, size_t n, InterpolationType *out) { common.getPositions(t, n, out); });
+    }
+    void getTangents(const floating_t *tValues, size_t count, typename Spline<InterpolationType,floating_t>::InterpolatedPT *output) const override
+    {
+        wrapBatch(tValues, count, output, [this](const floating_t *t, size_t n, typename Spline<InterpolationType,floating_t>::InterpolatedPT *out) { common.getTangents(t, n, out); });
+    }
+    void getCurvatures(const floating_t *tValues, size_t count, typename Spline<InterpolationType,floating_t>::InterpolatedPTC *output) const override
+    {
+        wrapBatch(tValues, count, output, [this](const floating_t *t, size_t n, typename Spline<InterpolationType,floating_t>::InterpolatedPTC *out) { common.getCurvatures(t, n, out); });
+    }
+    void getWiggles(const floating_t *tValues, size_t count, typename Spline<InterpolationType,floating_t>::InterpolatedPTCW *output) const override
+    {
+        wrapBatch(tValues, count, output, [this](const floating_t *t, size_t n, typename Spline<InterpolationType,floating_t>::InterpolatedPTCW *out) { common.getWiggles(t, n, out); });
+    }
+
+    floating_t arcLength(floating_t a, floating_t b) const override { return staticSpline().arcLength(a, b); }
+    floating_t cyclicArcLength(floating_t a, floating_t b) const override { return staticSpline().cyclicArcLength(a, b); }
+    floating_t totalLength(void) const override { return staticSpline().totalLength(); }
 
     bool isLooping(void) const override { return true; }
 
     size_t segmentCount(void) const override { return common.segmentCount(); }
     size_t segmentForT(floating_t t) const override { return common.segmentForT(wrapT(t)); }
     floating_t segmentT(size_t segmentIndex) const override { return common.segmentT(segmentIndex); }
-    floating_t segmentArcLength(size_t segmentIndex, floating_t a, floating_t b) const override { return common.segmentLength(segmentIndex, a, b); }
+    floating_t segmentArcLength(size_t segmentIndex, floating_t a, floating_t b) const override { return common.segmentLength(segmentIndex, a, b, this->getArcLengthQuadrature()); }
+
+    InterpolationType getPositionInSegment(size_t segmentIndex, floating_t t) const override { return common.positionInSegment(segmentIndex, t); }
+    typename Spline<InterpolationType,floating_t>::InterpolatedPT getTangentInSegment(size_t segmentIndex, floating_t t) const override { return common.tangentInSegment(segmentIndex, t); }
+    typename Spline<InterpolationType,floating_t>::InterpolatedPTC getCurvatureInSegment(size_t segmentIndex, floating_t t) const override { return common.curvatureInSegment(segmentIndex, t); }
+    typename Spline<InterpolationType,floating_t>::InterpolatedPTCW getWiggleInSegment(size_t segmentIndex, floating_t t) const override { return common.wiggleInSegment(segmentIndex, t); }
+
+    size_t memoryFootprint(void) const override { return sizeof(*this) + this->originalPointsFootprint() + common.heapFootprint(); }
+
+    //this spline's core, and the same interface as above bound directly to it, for code that wants to call it without virtual dispatch. see StaticSpline
+    typedef SplineCore<InterpolationType, floating_t> CoreType;
+    typedef typename StaticSpline<CoreType, true>::template Interface<InterpolationType, floating_t> StaticSplineType;
+    inline const CoreType &getCore(void) const { return common; }
+    inline StaticSplineType staticSpline(void) const { return StaticSplineType(common, this->maxT, this->getArcLengthQuadrature()); }
 
 protected:
     //protected constructor and destructor, so that this class can only be used as a parent class, even though it won't have any pure virtual methods
@@ -124,7 +308,31 @@ protected:
     {}
     ~SplineLoopingImpl(void) = default;
 
+    //see SplineImpl
+    SplineLoopingImpl(const SplineLoopingImpl &) = default;
+    SplineLoopingImpl(SplineLoopingImpl &&) = default;
+    SplineLoopingImpl &operator=(const SplineLoopingImpl &) = default;
+    SplineLoopingImpl &operator=(SplineLoopingImpl &&) = default;
+
     SplineCore<InterpolationType, floating_t> common;
+
+private:
+    //the common class expects t values that are already wrapped. rather than allocate a wrapped copy of the whole input,
+    //wrap it a fixed-size chunk at a time on the stack and hand each chunk to batchFunction
+    template<class OutputType, class BatchFunction>
+    void wrapBatch(const floating_t *tValues, size_t count, OutputType *output, BatchFunction batchFunction) const
+    {
+        std::array<floating_t, 64> wrappedT;
+        for(size_t chunkBegin = 0; chunkBegin < count; chunkBegin += wrappedT.size())
+        {
+            size_t chunkSize = std::min(wrappedT.size(), count - chunkBegin);
+            for(size_t i = 0; i < chunkSize; i++)
+            {
+                wrappedT[i] = wrapT(tValues[chunkBegin + i]);
+            }
+            batchFunction(wrappedT.data(), chunkSize, output + chunkBegin);
+        }
+    }
 };
 
 
@@ -137,7 +345,8 @@ struct Spline<InterpolationType,floating_t>::InterpolatedPT
     InterpolationType position;
     InterpolationType tangent;
 
-    InterpolatedPT(const InterpolationType &p, const InterpolationType &t)
+    InterpolatedPT(void) = default;
+    constexpr InterpolatedPT(const InterpolationType &p, const InterpolationType &t)
         :position(p),tangent(t)
     {}
 };
@@ -149,7 +358,8 @@ struct Spline<InterpolationType,floating_t>::InterpolatedPTC
     InterpolationType tangent;
     InterpolationType curvature;
 
-    InterpolatedPTC(const InterpolationType &p, const InterpolationType &t, const InterpolationType &c)
+    InterpolatedPTC(void) = default;
+    constexpr InterpolatedPTC(const InterpolationType &p, const InterpolationType &t, const InterpolationType &c)
         :position(p),tangent(t),curvature(c)
     {}
 };
@@ -162,7 +372,8 @@ struct Spline<InterpolationType,floating_t>::InterpolatedPTCW
     InterpolationType curvature;
     InterpolationType wiggle;
 
-    InterpolatedPTCW(const InterpolationType &p, const InterpolationType &t, const InterpolationType &c, const InterpolationType &w)
+    InterpolatedPTCW(void) = default;
+    constexpr InterpolatedPTCW(const InterpolationType &p, const InterpolationType &t, const InterpolationType &c, const InterpolationType &w)
         :position(p),tangent(t),curvature(c), wiggle(w)
     {}
 };
@@ -0,0 +1,466 @@
+#pragma once
+
+#include <cassert>
+#include <cmath>
+#include <array>
+#include <vector>
+
+#include "../spline.h"
+
+namespace __CompiledSplinePrivate
+{
+    //each segment is baked by matching the source spline's position and derivatives at a few points strictly inside the segment
+    //we stay away from the segment boundaries because some spline types have discontinuous derivatives there
+    //a degree 3 polynomial is fit to the position, tangent, curvature, and wiggle at the segment midpoint
+    //degree 5 and 7 polynomials use the two gauss-legendre points instead, matching 3 or 4 values at each
+    //locations are in local t, which is 0 at the center of the segment
+    template<size_t degree>
+    struct FitPoints
+    {
+        static_assert(degree == 3 || degree == 5 || degree == 7, "Compiled splines only support degree 3, 5, or 7");
+
+        static const size_t pointCount = degree == 3 ? 1 : 2;
+        static const size_t derivativesPerPoint = (degree + 1) / pointCount;
+
+        static std::array<double, pointCount> locations(void)
+        {
+            std::array<double, pointCount> result;
+            if(pointCount == 1)
+            {
+                result[0] = 0;
+            }
+            else
+            {
+                double offset = 0.5 / std::sqrt(3.0);
+                result[0] = -offset;
+                result[pointCount - 1] = offset;
+            }
+            return result;
+        }
+    };
+
+    //compute the matrix that converts "values and derivatives at the fit points" into polynomial coefficients
+    //the matrix only depends on the degree, so it's computed once and shared by every compiled spline of that degree
+    template<size_t degree>
+    const std::array<std::array<double, degree + 1>, degree + 1> &fitMatrix(void)
+    {
+        static const std::array<std::array<double, degree + 1>, degree + 1> result = [](){
+            const size_t size = degree + 1;
+            typedef FitPoints<degree> Points;
+            auto locations = Points::locations();
+
+            //build the system: each row is one equation of the form "the Nth derivative of the polynomial at x is y"
+            //augment it with the identity matrix so that gauss-jordan elimination leaves us with the inverse
+            std::array<std::array<double, size * 2>, size> system{};
+            for(size_t point = 0; point < Points::pointCount; point++)
+            {
+                for(size_t derivative = 0; derivative < Points::derivativesPerPoint; derivative++)
+                {
+                    size_t row = point * Points::derivativesPerPoint + derivative;
+                    for(size_t power = derivative; power < size; power++)
+                    {
+                        double multiplier = 1;
+                        for(size_t i = 0; i < derivative; i++)
+                        {
+                            multiplier *= power - i;
+                        }
+                        system[row][power] = multiplier * std::pow(locations[point], double(power - derivative));
+                    }
+                    system[row][size + row] = 1;
+                }
+            }
+
+            for(size_t column = 0; column < size; column++)
+            {
+                //partial pivoting
+                size_t pivot = column;
+                for(size_t row = column + 1; row < size; row++)
+                {
+                    if(std::abs(system[row][column]) > std::abs(system[pivot][column]))
+                    {
+                        pivot = row;
+                    }
+                }
+                std::swap(system[column], system[pivot]);
+
+                double inversePivot = 1 / system[column][column];
+                for(auto &entry : system[column])
+                {
+                    entry *= inversePivot;
+                }
+
+                for(size_t row = 0; row < size; row++)
+                {
+                    if(row != column)
+                    {
+                        double factor = system[row][column];
+                        for(size_t i = 0; i < size * 2; i++)
+                        {
+                            system[row][i] -= factor * system[column][i];
+                        }
+                    }
+                }
+            }
+
+            std::array<std::array<double, size>, size> inverse;
+            for(size_t row = 0; row < size; row++)
+            {
+                std::copy(system[row].begin() + size, system[row].end(), inverse[row].begin());
+            }
+            return inverse;
+        }();
+
+        return result;
+    }
+}
+
+template<class InterpolationType, typename floating_t, size_t degree>
+class CompiledSplineCommon
+{
+public:
+    inline CompiledSplineCommon(void) = default;
+    inline CompiledSplineCommon(const Spline<InterpolationType, floating_t> &source)
+    {
+        compile(source);
+    }
+
+    //replace every segment with one compiled from the given source, reusing this core's memory
+    inline void compile(const Spline<InterpolationType, floating_t> &source)
+    {
+        segments.resize(source.segmentCount());
+        knots.resize(source.segmentCount() + 1);
+        for(size_t i = 0; i < source.segmentCount(); i++)
+        {
+            knots[i] = source.segmentT(i);
+            segments[i] = compileSegment(source, i);
+        }
+        knots.back() = source.segmentT(source.segmentCount());
+    }
+
+    inline size_t segmentCount(void) const
+    {
+        return segments.size();
+    }
+
+    inline size_t segmentForT(floating_t t) const
+    {
+        size_t segmentIndex = SplineCommon::getIndexForT(knots, t);
+        if(segmentIndex > segmentCount() - 1)
+            return segmentCount() - 1;
+        else
+            return segmentIndex;
+    }
+
+    inline floating_t segmentT(size_t segmentIndex) const
+    {
+        return knots[segmentIndex];
+    }
+
+    inline InterpolationType getPosition(floating_t globalT) const
+    {
+        return positionInSegment(segmentForT(globalT), globalT);
+    }
+
+    inline typename Spline<InterpolationType,floating_t>::InterpolatedPT getTangent(floating_t globalT) const
+    {
+        return tangentInSegment(segmentForT(globalT), globalT);
+    }
+
+    inline typename Spline<InterpolationType,floating_t>::InterpolatedPTC getCurvature(floating_t globalT) const
+    {
+        return curvatureInSegment(segmentForT(globalT), globalT);
+    }
+
+    inline typename Spline<InterpolationType,floating_t>::InterpolatedPTCW getWiggle(floating_t globalT) const
+    {
+        return wiggleInSegment(segmentForT(globalT), globalT);
+    }
+
+    inline void getPositions(const floating_t *tValues, size_t count, InterpolationType *output) const
+    {
+        size_t segmentIndex = 0;
+        for(size_t i = 0; i < count; i++)
+        {
+            segmentIndex = SplineCommon::segmentForTWithHint(*this, tValues[i], segmentIndex);
+            output[i] = positionInSegment(segmentIndex, tValues[i]);
+        }
+    }
+
+    inline void getTangents(const floating_t *tValues, size_t count, typename Spline<InterpolationType,floating_t>::InterpolatedPT *output) const
+    {
+        size_t segmentIndex = 0;
+        for(size_t i = 0; i < count; i++)
+        {
+            segmentIndex = SplineCommon::segmentForTWithHint(*this, tValues[i], segmentIndex);
+            output[i] = tangentInSegment(segmentIndex, tValues[i]);
+        }
+    }
+
+    inline void getCurvatures(const floating_t *tValues, size_t count, typename Spline<InterpolationType,floating_t>::InterpolatedPTC *output) const
+    {
+        size_t segmentIndex = 0;
+        for(size_t i = 0; i < count; i++)
+        {
+            segmentIndex = SplineCommon::segmentForTWithHint(*this, tValues[i], segmentIndex);
+            output[i] = curvatureInSegment(segmentIndex, tValues[i]);
+        }
+    }
+
+    inline void getWiggles(const floating_t *tValues, size_t count, typename Spline<InterpolationType,floating_t>::InterpolatedPTCW *output) const
+    {
+        size_t segmentIndex = 0;
+        for(size_t i = 0; i < count; i++)
+        {
+            segmentIndex = SplineCommon::segmentForTWithHint(*this, tValues[i], segmentIndex);
+            output[i] = wiggleInSegment(segmentIndex, tValues[i]);
+        }
+    }
+
+    inline floating_t segmentLength(size_t segmentIndex, floating_t a, floating_t b, const SplineLibraryCalculus::QuadratureSettings<floating_t> &quadrature) const
+    {
+        const Segment &segment = segments[segmentIndex];
+
+        //it's perfectly legal for segments to have a T distance of 0, in which case the arc length is 0
+        if(segment.inverseLength > 0)
+        {
+            auto segmentFunction = [&segment](floating_t t) -> floating_t {
+                floating_t localT = (t - segment.centerT) * segment.inverseLength;
+                return SplineCommon::evaluateSpeed(segment.squaredSpeed.data(), segment.squaredSpeed.size(), localT);
+            };
+
+            return SplineLibraryCalculus::integrate<floating_t>(segmentFunction, a, b, quadrature);
+        }
+        else
+        {
+            return 0;
+        }
+    }
+
+private: //types
+    //everything needed to evaluate one segment, stored together so that an evaluation touches as little memory as possible
+    //each array holds power basis coefficients in terms of the local t, lowest power first
+    //local t is 0 at the center of the segment, and ranges from -0.5 to 0.5. centering it keeps the high-degree coefficients well conditioned
+    //the derivative coefficients are already scaled to be derivatives with respect to the global t
+    struct Segment
+    {
+        floating_t centerT;
+        floating_t inverseLength;
+
+        std::array<InterpolationType, degree + 1> position;
+        std::array<InterpolationType, degree> tangent;
+        std::array<InterpolationType, degree - 1> curvature;
+        std::array<InterpolationType, degree - 2> wiggle;
+
+        //the squared length of the tangent, so that arc length integrands are a scalar horner pass instead of a vector one
+        std::array<floating_t, 2 * degree - 1> squaredSpeed;
+    };
+
+public:
+    //the number of bytes this core has allocated
+    inline size_t heapFootprint(void) const
+    {
+        return SplineCommon::vectorFootprint(segments) + SplineCommon::vectorFootprint(knots);
+    }
+
+
+    //these skip the segment search, for callers that already know which segment globalT is in
+    inline InterpolationType positionInSegment(size_t segmentIndex, floating_t globalT) const
+    {
+        const Segment &segment = segments[segmentIndex];
+        floating_t localT = (globalT - segment.centerT) * segment.inverseLength;
+
+        return horner(segment.position, localT);
+    }
+
+    inline typename Spline<InterpolationType,floating_t>::InterpolatedPT tangentInSegment(size_t segmentIndex, floating_t globalT) const
+    {
+        const Segment &segment = segments[segmentIndex];
+        floating_t localT = (globalT - segment.centerT) * segment.inverseLength;
+
+        return typename Spline<InterpolationType,floating_t>::InterpolatedPT(
+                    horner(segment.position, localT),
+                    horner(segment.tangent, localT)
+                    );
+    }
+
+    inline typename Spline<InterpolationType,floating_t>::InterpolatedPTC curvatureInSegment(size_t segmentIndex, floating_t globalT) const
+    {
+        const Segment &segment = segments[segmentIndex];
+        floating_t localT = (globalT - segment.centerT) * segment.inverseLength;
+
+        return typename Spline<InterpolationType,floating_t>::InterpolatedPTC(
+                    horner(segment.position, localT),
+                    horner(segment.tangent, localT),
+                    horner(segment.curvature, localT)
+                    );
+    }
+
+    inline typename Spline<InterpolationType,floating_t>::InterpolatedPTCW wiggleInSegment(size_t segmentIndex, floating_t globalT) const
+    {
+        const Segment &segment = segments[segmentIndex];
+        floating_t localT = (globalT - segment.centerT) * segment.inverseLength;
+
+        return typename Spline<InterpolationType,floating_t>::InterpolatedPTCW(
+                    horner(segment.position, localT),
+                    horner(segment.tangent, localT),
+                    horner(segment.curvature, localT),
+                    horner(segment.wiggle, localT)
+                    );
+    }
+
+private: //methods
+    template<size_t size>
+    static inline InterpolationType horner(const std::array<InterpolationType, size> &coefficients, floating_t t)
+    {
+        InterpolationType result = coefficients[size - 1];
+        for(size_t i = size - 1; i > 0; i--)
+        {
+            result = result * t + coefficients[i - 1];
+        }
+        return result;
+    }
+
+    static Segment compileSegment(const Spline<InterpolationType, floating_t> &source, size_t segmentIndex);
+
+private: //data
+    std::vector<Segment> segments;
+
+    //the beginning of each segment, plus the end of the last segment, kept separately so that segmentForT can search it
+    std::vector<floating_t> knots;
+};
+
+template<class InterpolationType, typename floating_t, size_t degree>
+typename CompiledSplineCommon<InterpolationType, floating_t, degree>::Segment
+    CompiledSplineCommon<InterpolationType, floating_t, degree>::compileSegment(const Spline<InterpolationType, floating_t> &source, size_t segmentIndex)
+{
+    typedef __CompiledSplinePrivate::FitPoints<degree> Points;
+
+    Segment result;
+    floating_t beginT = source.segmentT(segmentIndex);
+    floating_t length = source.segmentT(segmentIndex + 1) - beginT;
+    result.centerT = beginT + length / 2;
+
+    //a segment with no T distance is a single point: the polynomial is constant, and every derivative is zero
+    if(length <= 0)
+    {
+        result.inverseLength = 0;
+        result.position.fill(InterpolationType());
+        result.tangent.fill(InterpolationType());
+        result.curvature.fill(InterpolationType());
+        result.wiggle.fill(InterpolationType());
+        result.squaredSpeed.fill(0);
+        result.position[0] = source.getPosition(beginT);
+        return result;
+    }
+    result.inverseLength = 1 / length;
+
+    //sample the source at each fit point. derivatives are with respect to local t, so scale the nth derivative by length^n
+    std::array<InterpolationType, degree + 1> samples;
+    auto locations = Points::locations();
+    for(size_t point = 0; point < Points::pointCount; point++)
+    {
+        auto sample = source.getWiggle(result.centerT + floating_t(locations[point]) * length);
+        std::array<InterpolationType, 4> derivatives = {{sample.position, sample.tangent, sample.curvature, sample.wiggle}};
+
+        floating_t scale = 1;
+        for(size_t derivative = 0; derivative < Points::derivativesPerPoint; derivative++)
+        {
+            samples[point * Points::derivativesPerPoint + derivative] = derivatives[derivative] * scale;
+            scale *= length;
+        }
+    }
+
+    //convert the samples to power basis coefficients
+    auto &matrix = __CompiledSplinePrivate::fitMatrix<degree>();
+    for(size_t power = 0; power <= degree; power++)
+    {
+        InterpolationType coefficient = samples[0] * floating_t(matrix[power][0]);
+        for(size_t i = 1; i <= degree; i++)
+        {
+            coefficient += samples[i] * floating_t(matrix[power][i]);
+        }
+        result.position[power] = coefficient;
+    }
+
+    //differentiate the position polynomial to get the derivative polynomials, converting from local t to global t as we go
+    for(size_t power = 0; power < degree; power++)
+    {
+        result.tangent[power] = result.position[power + 1] * (floating_t(power + 1) * result.inverseLength);
+    }
+    for(size_t power = 0; power < degree - 1; power++)
+    {
+        result.curvature[power] = result.tangent[power + 1] * (floating_t(power + 1) * result.inverseLength);
+    }
+    for(size_t power = 0; power < degree - 2; power++)
+    {
+        result.wiggle[power] = result.curvature[power + 1] * (floating_t(power + 1) * result.inverseLength);
+    }
+
+    SplineCommon::computeSquaredSpeed(result.tangent.data(), result.tangent.size(), result.squaredSpeed.data());
+
+    return result;
+}
+
+namespace __CompiledSplinePrivate
+{
+    //SplineImpl expects a spline core with exactly two template parameters, so bind the degree ahead of time
+    template<size_t degree>
+    struct Degree
+    {
+        template<class InterpolationType, typename floating_t>
+        using Common = CompiledSplineCommon<InterpolationType, floating_t, degree>;
+    };
+}
+
+//bakes any spline into a flat list of per-segment polynomials. the source spline can be discarded afterwards
+//if every segment of the source is a polynomial of at most the given degree, the result is identical to the source up to floating point error
+//otherwise it's an approximation. IE, use degree 3 for cubic splines, 5 for quintic hermite splines, and 7 for B-splines of degree 6 or 7
+template<class InterpolationType, typename floating_t=float, size_t degree=3>
+class CompiledSpline final : public SplineImpl<__CompiledSplinePrivate::Degree<degree>::template Common, InterpolationType, floating_t>
+{
+//constructors
+public:
+    CompiledSpline(const Spline<InterpolationType, floating_t> &source)
+        :SplineImpl<__CompiledSplinePrivate::Degree<degree>::template Common, InterpolationType, floating_t>(source.getOriginalPoints(), source.getMaxT())
+    {
+        assert(source.segmentCount() > 0);
+
+        common = CompiledSplineCommon<InterpolationType, floating_t, degree>(source);
+    }
+
+    //replace this spline with one compiled from a different source, reusing this spline's memory
+    //as long as the source has no more points and segments than the last one, nothing is allocated
+    inline void rebuild(const Spline<InterpolationType, floating_t> &source)
+    {
+        assert(source.segmentCount() > 0);
+        assert(&source != this);
+
+        this->replaceOriginalPoints(source.getOriginalPoints(), source.getMaxT());
+        this->common.compile(source);
+    }
+};
+
+template<class InterpolationType, typename floating_t=float, size_t degree=3>
+class LoopingCompiledSpline final : public SplineLoopingImpl<__CompiledSplinePrivate::Degree<degree>::template Common, InterpolationType, floating_t>
+{
+//constructors
+public:
+    LoopingCompiledSpline(const LoopingSpline<InterpolationType, floating_t> &source)
+        :SplineLoopingImpl<__CompiledSplinePrivate::Degree<degree>::template Common, InterpolationType, floating_t>(source.getOriginalPoints(), source.getMaxT())
+    {
+        assert(source.segmentCount() > 0);
+
+        common = CompiledSplineCommon<InterpolationType, floating_t, degree>(source);
+    }
+
+    //replace this spline with one compiled from a different source, reusing this spline's memory
+    //as long as the source has no more points and segments than the last one, nothing is allocated
+    inline void rebuild(const LoopingSpline<InterpolationType, floating_t> &source)
+    {
+        assert(source.segmentCount() > 0);
+        assert(&source != this);
+
+        this->replaceOriginalPoints(source.getOriginalPoints(), source.getMaxT());
+        this->common.compile(source);
+    }
+};
@@ -1,10 +1,14 @@
 #pragma once
 
 #include <cassert>
+#include <array>
 
 #include "../spline.h"
+#include "../utils/knot_editor.h"
 
-template<class InterpolationType, typename floating_t>
+//if uniformKnots is true, the spline must have been built with alpha == 0, so its knots are just 0, 1, 2, etc
+//then the knots aren't stored, segment lookup is a floor, and the compiler can fold away every division by the T distance
+template<class InterpolationType, typename floating_t, bool uniformKnots = false>
 class CubicHermiteSplineCommon
 {
 public:
@@ -15,8 +19,10 @@ public:
 
     inline CubicHermiteSplineCommon(void) = default;
     inline CubicHermiteSplineCommon(std::vector<CubicHermiteSplinePoint> points, std::vector<floating_t> knots)
-        :points(std::move(points)), knots(std::move(knots))
-    {}
+        :points(std::move(points)), knots(std::move(knots)), squaredSpeeds(segmentCount())
+    {
+        refreshSquaredSpeeds(0, segmentCount());
+    }
 
     inline size_t segmentCount(void) const
     {
@@ -25,7 +31,7 @@ public:
 
     inline size_t segmentForT(floating_t t) const
     {
-        size_t segmentIndex = SplineCommon::getIndexForT(knots, t);
+        size_t segmentIndex = knots.indexForT(t);
         if(segmentIndex > segmentCount() - 1)
             return segmentCount() - 1;
         else
@@ -39,91 +45,188 @@ public:
 
     inline InterpolationType getPosition(floating_t globalT) const
     {
-        size_t knotIndex = segmentForT(globalT);
-
-        floating_t tDiff = (knots[knotIndex + 1] - knots[knotIndex]);
-        floating_t localT = (globalT - knots[knotIndex]) / tDiff;
-
-        return computePosition(knotIndex, tDiff, localT);
+        return positionInSegment(segmentForT(globalT), globalT);
     }
 
     inline typename Spline<InterpolationType,floating_t>::InterpolatedPT getTangent(floating_t globalT) const
     {
-        size_t knotIndex = segmentForT(globalT);
-
-        floating_t tDiff = (knots[knotIndex + 1] - knots[knotIndex]);
-        floating_t localT = (globalT - knots[knotIndex]) / tDiff;
-
-        return typename Spline<InterpolationType,floating_t>::InterpolatedPT(
-                    computePosition(knotIndex, tDiff, localT),
-                    computeTangent(knotIndex, tDiff, localT)
-                    );
+        return tangentInSegment(segmentForT(globalT), globalT);
     }
 
     inline typename Spline<InterpolationType,floating_t>::InterpolatedPTC getCurvature(floating_t globalT) const
     {
-        size_t knotIndex = segmentForT(globalT);
+        return curvatureInSegment(segmentForT(globalT), globalT);
+    }
 
-        floating_t tDiff = (knots[knotIndex + 1] - knots[knotIndex]);
-        floating_t localT = (globalT - knots[knotIndex]) / tDiff;
+    inline typename Spline<InterpolationType,floating_t>::InterpolatedPTCW getWiggle(floating_t globalT) const
+    {
+        return wiggleInSegment(segmentForT(globalT), globalT);
+    }
 
-        return typename Spline<InterpolationType,floating_t>::InterpolatedPTC(
-                    computePosition(knotIndex, tDiff, localT),
-                    computeTangent(knotIndex, tDiff, localT),
-                    computeCurvature(knotIndex, tDiff, localT)
-                    );
+    inline void getPositions(const floating_t *tValues, size_t count, InterpolationType *output) const
+    {
+        size_t segmentIndex = 0;
+        for(size_t i = 0; i < count; i++)
+        {
+            segmentIndex = SplineCommon::segmentForTWithHint(*this, tValues[i], segmentIndex);
+            output[i] = positionInSegment(segmentIndex, tValues[i]);
+        }
     }
 
-    inline typename Spline<InterpolationType,floating_t>::InterpolatedPTCW getWiggle(floating_t globalT) const
+    inline void getTangents(const floating_t *tValues, size_t count, typename Spline<InterpolationType,floating_t>::InterpolatedPT *output) const
     {
-        size_t knotIndex = segmentForT(globalT);
+        size_t segmentIndex = 0;
+        for(size_t i = 0; i < count; i++)
+        {
+            segmentIndex = SplineCommon::segmentForTWithHint(*this, tValues[i], segmentIndex);
+            output[i] = tangentInSegment(segmentIndex, tValues[i]);
+        }
+    }
 
-        floating_t tDiff = knots[knotIndex + 1] - knots[knotIndex];
-        floating_t localT = (globalT - knots[knotIndex]) / tDiff;
+    inline void getCurvatures(const floating_t *tValues, size_t count, typename Spline<InterpolationType,floating_t>::InterpolatedPTC *output) const
+    {
+        size_t segmentIndex = 0;
+        for(size_t i = 0; i < count; i++)
+        {
+            segmentIndex = SplineCommon::segmentForTWithHint(*this, tValues[i], segmentIndex);
+            output[i] = curvatureInSegment(segmentIndex, tValues[i]);
+        }
+    }
 
-        return typename Spline<InterpolationType,floating_t>::InterpolatedPTCW(
-                    computePosition(knotIndex, tDiff, localT),
-                    computeTangent(knotIndex, tDiff, localT),
-                    computeCurvature(knotIndex, tDiff, localT),
-                    computeWiggle(knotIndex, tDiff)
-                    );
+    inline void getWiggles(const floating_t *tValues, size_t count, typename Spline<InterpolationType,floating_t>::InterpolatedPTCW *output) const
+    {
+        size_t segmentIndex = 0;
+        for(size_t i = 0; i < count; i++)
+        {
+            segmentIndex = SplineCommon::segmentForTWithHint(*this, tValues[i], segmentIndex);
+            output[i] = wiggleInSegment(segmentIndex, tValues[i]);
+        }
     }
 
-    inline floating_t segmentLength(size_t index, floating_t a, floating_t b) const
+    inline floating_t segmentLength(size_t index, floating_t a, floating_t b, const SplineLibraryCalculus::QuadratureSettings<floating_t> &quadrature) const
     {
-        floating_t tDiff = knots[index + 1] - knots[index];
-        auto segmentFunction = [this, index, tDiff](floating_t t) -> floating_t {
-            auto tangent = computeTangent(index, tDiff, t);
-            return tangent.length();
+        floating_t tDiff = knots.tDiff(index);
+        const auto &squaredSpeed = squaredSpeeds[index];
+        auto segmentFunction = [&squaredSpeed](floating_t t) -> floating_t {
+            return SplineCommon::evaluateSpeed(squaredSpeed.data(), squaredSpeed.size(), t);
         };
 
         floating_t localA = (a - knots[index]) / tDiff;
         floating_t localB = (b - knots[index]) / tDiff;
 
-        return tDiff * SplineLibraryCalculus::gaussLegendreQuadratureIntegral<floating_t>(segmentFunction, localA, localB);
+        return tDiff * SplineLibraryCalculus::integrate<floating_t>(segmentFunction, localA, localB, quadrature);
+    }
+
+    //direct access to the point data, for the splines that support editing their points in place
+    inline std::vector<CubicHermiteSplinePoint> &editPoints(void) { return points; }
+    inline SplineCommon::Knots<floating_t, uniformKnots> &editKnots(void) { return knots; }
+    inline std::vector<std::array<floating_t, 5>> &editSquaredSpeeds(void) { return squaredSpeeds; }
+
+    //resize and recompute everything derived from the points and knots, after a spline's rebuild replaced them all in place
+    //builtKnots is the vector the knots were computed into, from SplineCommon::Knots::buildStorage
+    inline void finishBuild(const std::vector<floating_t> &builtKnots)
+    {
+        knots.finishBuild(builtKnots);
+        squaredSpeeds.resize(segmentCount());
+        refreshSquaredSpeeds(0, segmentCount());
+    }
+
+    //recompute the cached squared speeds of segments [beginSegment, endSegment), after the points or knots they depend on were edited
+    inline void refreshSquaredSpeeds(size_t beginSegment, size_t endSegment)
+    {
+        for(size_t i = beginSegment; i < endSegment; i++)
+        {
+            //the tangent is a quadratic of local t, so its taylor series at the beginning of the segment is exact
+            //the derivatives are with respect to global t, so scale each one by tDiff to make it with respect to local t
+            floating_t tDiff = knots.tDiff(i);
+            std::array<InterpolationType, 3> tangent = {{
+                computeTangent(points, i, tDiff, 0),
+                computeCurvature(points, i, tDiff, 0) * tDiff,
+                computeWiggle(points, i, tDiff) * (tDiff * tDiff / 2)
+            }};
+            SplineCommon::computeSquaredSpeed(tangent.data(), tangent.size(), squaredSpeeds[i].data());
+        }
+    }
+
+    //the points this core keeps a copy of, in order, including any that a looping spline repeated. used to rebuild a spline's original points after they've been discarded
+    inline size_t storedPointCount(void) const { return points.size(); }
+    inline const InterpolationType &storedPoint(size_t index) const { return points[index].position; }
+
+    //the number of bytes this core has allocated
+    inline size_t heapFootprint(void) const
+    {
+        return SplineCommon::vectorFootprint(points) + knots.heapFootprint() + SplineCommon::vectorFootprint(squaredSpeeds);
+    }
+
+
+    //these skip the segment search, for callers that already know which segment globalT is in
+    inline InterpolationType positionInSegment(size_t segmentIndex, floating_t globalT) const
+    {
+        floating_t tDiff = knots.tDiff(segmentIndex);
+        floating_t localT = (globalT - knots[segmentIndex]) / tDiff;
+
+        return computePosition(points, segmentIndex, tDiff, localT);
+    }
+
+    inline typename Spline<InterpolationType,floating_t>::InterpolatedPT tangentInSegment(size_t segmentIndex, floating_t globalT) const
+    {
+        floating_t tDiff = knots.tDiff(segmentIndex);
+        floating_t localT = (globalT - knots[segmentIndex]) / tDiff;
+
+        return typename Spline<InterpolationType,floating_t>::InterpolatedPT(
+                    computePosition(points, segmentIndex, tDiff, localT),
+                    computeTangent(points, segmentIndex, tDiff, localT)
+                    );
     }
 
+    inline typename Spline<InterpolationType,floating_t>::InterpolatedPTC curvatureInSegment(size_t segmentIndex, floating_t globalT) const
+    {
+        floating_t tDiff = knots.tDiff(segmentIndex);
+        floating_t localT = (globalT - knots[segmentIndex]) / tDiff;
 
-private: //methods
-    inline InterpolationType computePosition(size_t index, floating_t tDiff, floating_t t) const
+        return typename Spline<InterpolationType,floating_t>::InterpolatedPTC(
+                    computePosition(points, segmentIndex, tDiff, localT),
+                    computeTangent(points, segmentIndex, tDiff, localT),
+                    computeCurvature(points, segmentIndex, tDiff, localT)
+                    );
+    }
+
+    inline typename Spline<InterpolationType,floating_t>::InterpolatedPTCW wiggleInSegment(size_t segmentIndex, floating_t globalT) const
+    {
+        floating_t tDiff = knots.tDiff(segmentIndex);
+        floating_t localT = (globalT - knots[segmentIndex]) / tDiff;
+
+        return typename Spline<InterpolationType,floating_t>::InterpolatedPTCW(
+                    computePosition(points, segmentIndex, tDiff, localT),
+                    computeTangent(points, segmentIndex, tDiff, localT),
+                    computeCurvature(points, segmentIndex, tDiff, localT),
+                    computeWiggle(points, segmentIndex, tDiff)
+                    );
+    }
+
+    //the math behind the functions above, as functions of any random-access list of CubicHermiteSplinePoint, so that SlidingWindowCubicHermiteSpline can share it
+    template<class PointList>
+    static inline InterpolationType computePosition(const PointList &points, size_t index, floating_t tDiff, floating_t t)
     {
         auto oneMinusT = 1 - t;
 
-        auto basis00 = (1 + 2*t) * oneMinusT * oneMinusT;
         auto basis10 = t * oneMinusT * oneMinusT;
 
         auto basis11 = t * t * -oneMinusT;
         auto basis01 = t * t * (3 - 2*t);
 
+        //the basis functions of the two positions always sum to 1, and their derivatives to 0, so apply them to the displacement from the first position,
+        //rather than to each position, so that points far from the origin don't lose precision to cancellation
         return
-                basis00 * points[index].position +
+                points[index].position +
                 basis10 * tDiff * points[index].tangent +
 
                 basis11 * tDiff * points[index + 1].tangent +
-                basis01 * points[index + 1].position;
+                basis01 * (points[index + 1].position - points[index].position);
     }
 
-    inline InterpolationType computeTangent(size_t index, floating_t tDiff, floating_t t) const
+    template<class PointList>
+    static inline InterpolationType computeTangent(const PointList &points, size_t index, floating_t tDiff, floating_t t)
     {
         auto oneMinusT = 1 - t;
 
@@ -137,15 +240,15 @@ private: //methods
         //intuitively it would just be the derivative of the position function and nothing else
         //if you know why please let me know
         return (
-                d_basis00 * points[index].position +
                 d_basis10 * tDiff * points[index].tangent +
 
                 d_basis11 * tDiff * points[index + 1].tangent +
-                d_basis01 * points[index + 1].position
+                d_basis01 * (points[index + 1].position - points[index].position)
                 ) / tDiff;
     }
 
-    inline InterpolationType computeCurvature(size_t index, floating_t tDiff, floating_t t) const
+    template<class PointList>
+    static inline InterpolationType computeCurvature(const PointList &points, size_t index, floating_t tDiff, floating_t t)
     {
         auto d2_basis00 = 6 * (2 * t - 1);
         auto d2_basis10 = 2 * (3 * t - 2);
@@ -157,15 +260,15 @@ private: //methods
         //intuitively it would just be the 2nd derivative of the position function and nothing else
         //if you know why please let me know
         return (
-                d2_basis00 * points[index].position +
                 d2_basis10 * tDiff * points[index].tangent +
 
                 d2_basis11 * tDiff * points[index + 1].tangent +
-                d2_basis01 * points[index + 1].position
+                d2_basis01 * (points[index + 1].position - points[index].position)
                 ) / (tDiff * tDiff);
     }
 
-    inline InterpolationType computeWiggle(size_t index, floating_t tDiff) const
+    template<class PointList>
+    static inline InterpolationType computeWiggle(const PointList &points, size_t index, floating_t tDiff)
     {
         //tests and such have shown that we have to scale this by the inverse of the t distance, and i'm not sure why
         //intuitively it would just be the 2nd derivative of the position function and nothing else
@@ -177,162 +280,473 @@ private: //methods
 
 private: //data
     std::vector<CubicHermiteSplinePoint> points;
-    std::vector<floating_t> knots;
+    SplineCommon::Knots<floating_t, uniformKnots> knots;
+
+    //for each segment, the squared length of the tangent as a polynomial of local t, so that arc length integrands don't need the tangent
+    std::vector<std::array<floating_t, 5>> squaredSpeeds;
 };
 
 
 
-template<class InterpolationType, typename floating_t=float>
-class CubicHermiteSpline final : public SplineImpl<CubicHermiteSplineCommon, InterpolationType, floating_t>
+namespace __CubicHermiteSplinePrivate
+{
+    //SplineImpl expects a spline core with exactly two template parameters, so bind the knot type ahead of time
+    template<bool uniformKnots>
+    struct KnotType
+    {
+        template<class InterpolationType, typename floating_t>
+        using Common = CubicHermiteSplineCommon<InterpolationType, floating_t, uniformKnots>;
+    };
+}
+
+//if uniformKnots is true, alpha must be 0. see CubicHermiteSplineCommon for details
+template<class InterpolationType, typename floating_t=float, bool uniformKnots=false>
+class CubicHermiteSpline final : public SplineImpl<__CubicHermiteSplinePrivate::KnotType<uniformKnots>::template Common, InterpolationType, floating_t>
 {
 //constructors
 public:
     CubicHermiteSpline(const std::vector<InterpolationType> &points, const std::vector<InterpolationType> &tangents, floating_t alpha = 0.0)
-        :SplineImpl<CubicHermiteSplineCommon, InterpolationType,floating_t>(points, points.size() - 1)
+        :SplineImpl<__CubicHermiteSplinePrivate::KnotType<uniformKnots>::template Common, InterpolationType,floating_t>(points, points.size() - 1), editable(true), knotEditor(alpha, false)
     {
-        assert(points.size() >= 2);
-        assert(points.size() == tangents.size());
-
-        size_t firstTangent = 0;
-        size_t numSegments = points.size() - 1;
+        SplineCommon::BuildScratch<InterpolationType, floating_t> buildScratch;
+        build(points, tangents, alpha, buildScratch);
+    }
 
-        //compute the T values for each point
-        std::vector<floating_t> knots = SplineCommon::computeTValuesWithInnerPadding(points, alpha, firstTangent);
+    CubicHermiteSpline(const std::vector<InterpolationType> &points, floating_t alpha = 0.0)
+        :SplineImpl<__CubicHermiteSplinePrivate::KnotType<uniformKnots>::template Common, InterpolationType,floating_t>(points, points.size() - 3), editable(false), knotEditor(alpha, false)
+    {
+        SplineCommon::BuildScratch<InterpolationType, floating_t> buildScratch;
+        build(points, alpha, buildScratch);
+    }
 
-        //pre-arrange the data needed for interpolation
-        std::vector<typename CubicHermiteSplineCommon<InterpolationType, floating_t>::CubicHermiteSplinePoint> positionData(numSegments + 1);
-        for(int i = 0; i < positionData.size(); i++)
-        {
-            positionData[i].position = points[i];
-            positionData[i].tangent = tangents[i];
-        }
+//rebuilding
+public:
+    //replace this spline with the one the matching constructor would build from the given arguments, reusing this spline's memory
+    //as long as there are no more points than the last time, nothing is allocated
+    inline void rebuild(const std::vector<InterpolationType> &points, const std::vector<InterpolationType> &tangents, floating_t alpha = 0.0)
+    {
+        this->replaceOriginalPoints(points, floating_t(points.size() - 1));
+        editable = true;
+        knotEditor.reset(alpha);
+        build(points, tangents, alpha, retainedScratch.get());
+    }
 
-        common = CubicHermiteSplineCommon<InterpolationType, floating_t>(std::move(positionData), std::move(knots));
+    inline void rebuild(const std::vector<InterpolationType> &points, floating_t alpha = 0.0)
+    {
+        this->replaceOriginalPoints(points, floating_t(points.size() - 3));
+        editable = false;
+        knotEditor.reset(alpha);
+        build(points, alpha, retainedScratch.get());
     }
 
-    CubicHermiteSpline(const std::vector<InterpolationType> &points, floating_t alpha = 0.0)
-        :SplineImpl<CubicHermiteSplineCommon, InterpolationType,floating_t>(points, points.size() - 3)
+//editing
+public:
+    //move, insert, or remove a single point and its tangent, and update the spline to match without rebuilding it
+    //the tangents are given explicitly, so no other point is affected. only supported for splines created with explicit tangents
+    void setPoint(size_t index, const InterpolationType &point, const InterpolationType &tangent);
+    void insertPoint(size_t index, const InterpolationType &point, const InterpolationType &tangent);
+    void removePoint(size_t index);
+
+    inline void appendPoint(const InterpolationType &point, const InterpolationType &tangent)
     {
-        assert(points.size() >= 4);
+        this->restoreOriginalPoints();
+        insertPoint(this->getOriginalPoints().size(), point, tangent);
+    }
+    inline bool isEditable(void) const { return editable; }
 
-        size_t firstTangent = 1;
-        size_t numSegments = points.size() - 3;
+    size_t memoryFootprint(void) const override
+    {
+        return sizeof(*this) + this->originalPointsFootprint() + this->common.heapFootprint() + knotEditor.heapFootprint() + retainedScratch.heapFootprint();
+    }
 
-        //compute the T values for each point
-        std::vector<floating_t> paddedKnots = SplineCommon::computeTValuesWithInnerPadding(points, alpha, firstTangent);
+private:
+    //fill the core from scratch, for the constructors and rebuild
+    void build(const std::vector<InterpolationType> &points, const std::vector<InterpolationType> &tangents, floating_t alpha, SplineCommon::BuildScratch<InterpolationType, floating_t> &buildScratch);
+    void build(const std::vector<InterpolationType> &points, floating_t alpha, SplineCommon::BuildScratch<InterpolationType, floating_t> &buildScratch);
 
-        //compute the tangents
-        std::vector<InterpolationType> tangents(points.size());
-        for(size_t i = firstTangent; i < firstTangent + numSegments + 1; i++)
-        {
-            floating_t tPrev = paddedKnots[i - 1];
-            floating_t tCurrent = paddedKnots[i];
-            floating_t tNext = paddedKnots[i + 1];
-
-            InterpolationType pPrev = points.at(i - 1);
-            InterpolationType pCurrent = points.at(i);
-            InterpolationType pNext = points.at(i + 1);
-
-            //the tangent is the standard catmull-rom spline tangent calculation
-            tangents[i] =
-                                pPrev * (tCurrent - tNext) / ((tNext - tPrev) * (tCurrent - tPrev))
-                                + pNext * (tCurrent - tPrev) / ((tNext - tPrev) * (tNext - tCurrent))
-
-                             //plus a little something extra - this is derived from the pyramid contruction
-                             //when the t values are evenly spaced (ie when alpha is 0), this whole line collapses to 0,
-                             //yielding the standard catmull-rom formula
-                                - pCurrent * ((tCurrent - tPrev) - (tNext - tCurrent)) / ((tNext - tCurrent) * (tCurrent - tPrev));
-        }
+    void finishEdit(size_t index, typename SplineKnotEditor<InterpolationType, floating_t>::EditType type);
 
-        //pre-arrange the data needed for interpolation
-        std::vector<floating_t> knots(numSegments + 1);
-        std::vector<typename CubicHermiteSplineCommon<InterpolationType, floating_t>::CubicHermiteSplinePoint> positionData(numSegments + 1);
-        for(size_t i = 0; i < positionData.size(); i++)
-        {
-            knots[i] = paddedKnots[i + firstTangent];
-            positionData[i].position = points[i + firstTangent];
-            positionData[i].tangent = tangents[i + firstTangent];
-        }
+    bool reconstructOriginalPoints(std::vector<InterpolationType> &output) const override
+    {
+        //the core keeps every point unchanged, but only when the tangents were given explicitly. otherwise the first and last points are only used for tangents
+        if(!editable)
+            return false;
 
-        common = CubicHermiteSplineCommon<InterpolationType, floating_t>(std::move(positionData), std::move(knots));
+        SplineCommon::copyStoredPoints(this->common, 0, this->common.storedPointCount(), output);
+        return true;
     }
+
+    bool editable;
+    SplineKnotEditor<InterpolationType, floating_t> knotEditor;
+    SplineCommon::RetainedBuildScratch<InterpolationType, floating_t> retainedScratch;
 };
 
 
 
 
-template<class InterpolationType, typename floating_t=float>
-class LoopingCubicHermiteSpline final : public SplineLoopingImpl<CubicHermiteSplineCommon, InterpolationType, floating_t>
+//if uniformKnots is true, alpha must be 0. see CubicHermiteSplineCommon for details
+template<class InterpolationType, typename floating_t=float, bool uniformKnots=false>
+class LoopingCubicHermiteSpline final : public SplineLoopingImpl<__CubicHermiteSplinePrivate::KnotType<uniformKnots>::template Common, InterpolationType, floating_t>
 {
 //constructors
 public:
     LoopingCubicHermiteSpline(const std::vector<InterpolationType> &points, const std::vector<InterpolationType> &tangents, floating_t alpha = 0.0)
-        :SplineLoopingImpl<CubicHermiteSplineCommon, InterpolationType,floating_t>(points, points.size())
+        :SplineLoopingImpl<__CubicHermiteSplinePrivate::KnotType<uniformKnots>::template Common, InterpolationType,floating_t>(points, points.size()), editable(true), knotEditor(alpha, true)
     {
-        assert(points.size() >= 2);
-        assert(points.size() == tangents.size());
-
-        //compute the T values for each point
-        std::vector<floating_t> knots = SplineCommon::computeLoopingTValues(points, alpha, 0);
+        SplineCommon::BuildScratch<InterpolationType, floating_t> buildScratch;
+        build(points, tangents, alpha, buildScratch);
+    }
 
-        //pre-arrange the data needed for interpolation
-        std::vector<typename CubicHermiteSplineCommon<InterpolationType, floating_t>::CubicHermiteSplinePoint> positionData(points.size() + 1);
-        for(int i = 0; i < points.size(); i++)
-        {
-            positionData[i].position = points[i];
-            positionData[i].tangent = tangents[i];
-        }
-        positionData[points.size()] = positionData[0];
+    LoopingCubicHermiteSpline(const std::vector<InterpolationType> &points, floating_t alpha = 0.0)
+        :SplineLoopingImpl<__CubicHermiteSplinePrivate::KnotType<uniformKnots>::template Common, InterpolationType,floating_t>(points, points.size()), editable(false), knotEditor(alpha, true)
+    {
+        SplineCommon::BuildScratch<InterpolationType, floating_t> buildScratch;
+        build(points, alpha, buildScratch);
+    }
 
-        common = CubicHermiteSplineCommon<InterpolationType, floating_t>(std::move(positionData), std::move(knots));
+//rebuilding
+public:
+    //replace this spline with the one the matching constructor would build from the given arguments, reusing this spline's memory
+    //as long as there are no more points than the last time, nothing is allocated
+    inline void rebuild(const std::vector<InterpolationType> &points, const std::vector<InterpolationType> &tangents, floating_t alpha = 0.0)
+    {
+        this->replaceOriginalPoints(points, floating_t(points.size()));
+        editable = true;
+        knotEditor.reset(alpha);
+        build(points, tangents, alpha, retainedScratch.get());
     }
 
-    LoopingCubicHermiteSpline(const std::vector<InterpolationType> &points, floating_t alpha = 0.0)
-        :SplineLoopingImpl<CubicHermiteSplineCommon, InterpolationType,floating_t>(points, points.size())
+    inline void rebuild(const std::vector<InterpolationType> &points, floating_t alpha = 0.0)
     {
-        assert(points.size() >= 4);
+        this->replaceOriginalPoints(points, floating_t(points.size()));
+        editable = false;
+        knotEditor.reset(alpha);
+        build(points, alpha, retainedScratch.get());
+    }
 
-        size_t size = points.size();
+//editing
+public:
+    //move, insert, or remove a single point and its tangent, and update the spline to match without rebuilding it
+    //the tangents are given explicitly, so no other point is affected. only supported for splines created with explicit tangents
+    void setPoint(size_t index, const InterpolationType &point, const InterpolationType &tangent);
+    void insertPoint(size_t index, const InterpolationType &point, const InterpolationType &tangent);
+    void removePoint(size_t index);
 
-        //compute the T values for each point
-        size_t padding = 1;
-        std::vector<floating_t> paddedKnots = SplineCommon::computeLoopingTValues(points, alpha, padding);
+    inline void appendPoint(const InterpolationType &point, const InterpolationType &tangent)
+    {
+        this->restoreOriginalPoints();
+        insertPoint(this->getOriginalPoints().size(), point, tangent);
+    }
+    inline bool isEditable(void) const { return editable; }
 
-        //compute the tangents
-        std::vector<InterpolationType> tangents(size);
-        for(size_t i = 0; i < size; i++)
-        {
-            floating_t tPrev = paddedKnots[i - 1 + padding];
-            floating_t tCurrent = paddedKnots[i + padding];
-            floating_t tNext = paddedKnots[i + 1 + padding];
-
-            InterpolationType pPrev = points[(i - 1 + size)%size];
-            InterpolationType pCurrent = points[i];
-            InterpolationType pNext = points[(i + 1)%size];
-
-            //the tangent is the standard catmull-rom spline tangent calculation
-            tangents[i] =
-                                pPrev * (tCurrent - tNext) / ((tNext - tPrev) * (tCurrent - tPrev))
-                                + pNext * (tCurrent - tPrev) / ((tNext - tPrev) * (tNext - tCurrent))
-
-                             //plus a little something extra - this is derived from the pyramid contruction
-                             //when the t values are evenly spaced (ie when alpha is 0), this whole line collapses to 0,
-                             //yielding the standard catmull-rom formula
-                                - pCurrent * ((tCurrent - tPrev) - (tNext - tCurrent)) / ((tNext - tCurrent) * (tCurrent - tPrev));
-        }
+    size_t memoryFootprint(void) const override
+    {
+        return sizeof(*this) + this->originalPointsFootprint() + this->common.heapFootprint() + knotEditor.heapFootprint() + retainedScratch.heapFootprint();
+    }
 
-        //pre-arrange the data needed for interpolation
-        std::vector<floating_t> knots(size + 1);
-        std::vector<typename CubicHermiteSplineCommon<InterpolationType, floating_t>::CubicHermiteSplinePoint> positionData(size + 1);
-        for(size_t i = 0; i < size; i++)
-        {
-            knots[i] = paddedKnots[i + padding];
-            positionData[i].position = points[i];
-            positionData[i].tangent = tangents[i];
-        }
-        positionData[size] = positionData[0];
-        knots[size] = paddedKnots[size + padding];
+private:
+    //fill the core from scratch, for the constructors and rebuild
+    void build(const std::vector<InterpolationType> &points, const std::vector<InterpolationType> &tangents, floating_t alpha, SplineCommon::BuildScratch<InterpolationType, floating_t> &buildScratch);
+    void build(const std::vector<InterpolationType> &points, floating_t alpha, SplineCommon::BuildScratch<InterpolationType, floating_t> &buildScratch);
+
+    void finishEdit(size_t index, typename SplineKnotEditor<InterpolationType, floating_t>::EditType type);
 
-        common = CubicHermiteSplineCommon<InterpolationType, floating_t>(std::move(positionData), std::move(knots));
+    bool reconstructOriginalPoints(std::vector<InterpolationType> &output) const override
+    {
+        //the core keeps every point, then the first point again
+        SplineCommon::copyStoredPoints(this->common, 0, this->common.storedPointCount() - 1, output);
+        return true;
     }
+
+    bool editable;
+    SplineKnotEditor<InterpolationType, floating_t> knotEditor;
+    SplineCommon::RetainedBuildScratch<InterpolationType, floating_t> retainedScratch;
 };
+
+
+template<class InterpolationType, typename floating_t, bool uniformKnots>
+void CubicHermiteSpline<InterpolationType,floating_t,uniformKnots>::build(
+        const std::vector<InterpolationType> &points, const std::vector<InterpolationType> &tangents, floating_t alpha, SplineCommon::BuildScratch<InterpolationType, floating_t> &buildScratch)
+{
+    assert(!uniformKnots || alpha == 0);
+    assert(points.size() >= 2);
+    assert(points.size() == tangents.size());
+
+    size_t firstTangent = 0;
+    size_t numSegments = points.size() - 1;
+
+    //compute the T values for each point
+    std::vector<floating_t> &knots = this->common.editKnots().buildStorage(buildScratch.knots);
+    SplineCommon::computeTValuesWithInnerPadding(points, alpha, firstTangent, knots);
+
+    //pre-arrange the data needed for interpolation
+    auto &positionData = this->common.editPoints();
+    positionData.resize(numSegments + 1);
+    for(size_t i = 0; i < positionData.size(); i++)
+    {
+        positionData[i].position = points[i];
+        positionData[i].tangent = tangents[i];
+    }
+
+    this->common.finishBuild(knots);
+}
+
+template<class InterpolationType, typename floating_t, bool uniformKnots>
+void CubicHermiteSpline<InterpolationType,floating_t,uniformKnots>::build(
+        const std::vector<InterpolationType> &points, floating_t alpha, SplineCommon::BuildScratch<InterpolationType, floating_t> &buildScratch)
+{
+    assert(!uniformKnots || alpha == 0);
+    assert(points.size() >= 4);
+
+    size_t firstTangent = 1;
+    size_t numSegments = points.size() - 3;
+
+    //compute the T values for each point
+    std::vector<floating_t> &paddedKnots = this->common.editKnots().buildStorage(buildScratch.knots);
+    SplineCommon::computeTValuesWithInnerPadding(points, alpha, firstTangent, paddedKnots);
+
+    //compute the tangents, directly into the data needed for interpolation
+    auto &positionData = this->common.editPoints();
+    positionData.resize(numSegments + 1);
+    for(size_t i = firstTangent; i < firstTangent + numSegments + 1; i++)
+    {
+        floating_t tPrev = paddedKnots[i - 1];
+        floating_t tCurrent = paddedKnots[i];
+        floating_t tNext = paddedKnots[i + 1];
+
+        InterpolationType pPrev = points.at(i - 1);
+        InterpolationType pCurrent = points.at(i);
+        InterpolationType pNext = points.at(i + 1);
+
+        positionData[i - firstTangent].position = pCurrent;
+
+        //the tangent is the standard catmull-rom spline tangent calculation
+        positionData[i - firstTangent].tangent = SplineCommon::computeCatmullRomTangent(pPrev, pCurrent, pNext, tPrev, tCurrent, tNext);
+    }
+
+    //the knots are the padded knots without their padding, so reuse the padded vector's memory
+    SplineCommon::removeKnotPadding(paddedKnots, firstTangent, numSegments + 1);
+
+    this->common.finishBuild(paddedKnots);
+}
+
+template<class InterpolationType, typename floating_t, bool uniformKnots>
+void CubicHermiteSpline<InterpolationType,floating_t,uniformKnots>::setPoint(size_t index, const InterpolationType &point, const InterpolationType &tangent)
+{
+    assert(editable);
+    this->restoreOriginalPoints();
+    assert(index < this->getOriginalPoints().size());
+
+    knotEditor.initialize(this->getOriginalPoints());
+
+    this->editOriginalPoints()[index] = point;
+    this->common.editPoints()[index].position = point;
+    this->common.editPoints()[index].tangent = tangent;
+
+    finishEdit(index, SplineKnotEditor<InterpolationType, floating_t>::Set);
+}
+
+template<class InterpolationType, typename floating_t, bool uniformKnots>
+void CubicHermiteSpline<InterpolationType,floating_t,uniformKnots>::insertPoint(size_t index, const InterpolationType &point, const InterpolationType &tangent)
+{
+    assert(editable);
+    this->restoreOriginalPoints();
+    assert(index <= this->getOriginalPoints().size());
+
+    knotEditor.initialize(this->getOriginalPoints());
+
+    typename CubicHermiteSplineCommon<InterpolationType, floating_t, uniformKnots>::CubicHermiteSplinePoint hermitePoint;
+    hermitePoint.position = point;
+    hermitePoint.tangent = tangent;
+
+    auto &points = this->editOriginalPoints();
+    auto &hermitePoints = this->common.editPoints();
+    auto &squaredSpeeds = this->common.editSquaredSpeeds();
+    points.insert(points.begin() + index, point);
+    hermitePoints.insert(hermitePoints.begin() + index, hermitePoint);
+    squaredSpeeds.insert(squaredSpeeds.begin() + std::min(index, squaredSpeeds.size()), std::array<floating_t, 5>());
+
+    finishEdit(index, SplineKnotEditor<InterpolationType, floating_t>::Insert);
+}
+
+template<class InterpolationType, typename floating_t, bool uniformKnots>
+void CubicHermiteSpline<InterpolationType,floating_t,uniformKnots>::removePoint(size_t index)
+{
+    assert(editable);
+    this->restoreOriginalPoints();
+    assert(index < this->getOriginalPoints().size());
+    assert(this->getOriginalPoints().size() > 2);
+
+    knotEditor.initialize(this->getOriginalPoints());
+
+    auto &points = this->editOriginalPoints();
+    auto &hermitePoints = this->common.editPoints();
+    auto &squaredSpeeds = this->common.editSquaredSpeeds();
+    points.erase(points.begin() + index);
+    hermitePoints.erase(hermitePoints.begin() + index);
+    squaredSpeeds.erase(squaredSpeeds.begin() + std::min(index, squaredSpeeds.size() - 1));
+
+    finishEdit(index, SplineKnotEditor<InterpolationType, floating_t>::Remove);
+}
+
+template<class InterpolationType, typename floating_t, bool uniformKnots>
+void CubicHermiteSpline<InterpolationType,floating_t,uniformKnots>::finishEdit(size_t index, typename SplineKnotEditor<InterpolationType, floating_t>::EditType type)
+{
+    floating_t knotScale = knotEditor.update(this->getOriginalPoints(), this->common.editKnots(), index, type);
+    this->maxT = floating_t(this->getOriginalPoints().size() - 1);
+
+    //if every knot moved, every segment's squared speed changed. otherwise only the segments on either side of the edited point did
+    size_t segmentCount = this->common.segmentCount();
+    if(knotScale != 1)
+        this->common.refreshSquaredSpeeds(0, segmentCount);
+    else
+        this->common.refreshSquaredSpeeds(index > 0 ? index - 1 : 0, std::min(index + 1, segmentCount));
+}
+
+template<class InterpolationType, typename floating_t, bool uniformKnots>
+void LoopingCubicHermiteSpline<InterpolationType,floating_t,uniformKnots>::build(
+        const std::vector<InterpolationType> &points, const std::vector<InterpolationType> &tangents, floating_t alpha, SplineCommon::BuildScratch<InterpolationType, floating_t> &buildScratch)
+{
+    assert(!uniformKnots || alpha == 0);
+    assert(points.size() >= 2);
+    assert(points.size() == tangents.size());
+
+    //compute the T values for each point
+    std::vector<floating_t> &knots = this->common.editKnots().buildStorage(buildScratch.knots);
+    SplineCommon::computeLoopingTValues(points, alpha, 0, knots);
+
+    //pre-arrange the data needed for interpolation
+    auto &positionData = this->common.editPoints();
+    positionData.resize(points.size() + 1);
+    for(size_t i = 0; i < points.size(); i++)
+    {
+        positionData[i].position = points[i];
+        positionData[i].tangent = tangents[i];
+    }
+    positionData[points.size()] = positionData[0];
+
+    this->common.finishBuild(knots);
+}
+
+template<class InterpolationType, typename floating_t, bool uniformKnots>
+void LoopingCubicHermiteSpline<InterpolationType,floating_t,uniformKnots>::build(
+        const std::vector<InterpolationType> &points, floating_t alpha, SplineCommon::BuildScratch<InterpolationType, floating_t> &buildScratch)
+{
+    assert(!uniformKnots || alpha == 0);
+    assert(points.size() >= 4);
+
+    size_t size = points.size();
+
+    //compute the T values for each point
+    size_t padding = 1;
+    std::vector<floating_t> &paddedKnots = this->common.editKnots().buildStorage(buildScratch.knots);
+    SplineCommon::computeLoopingTValues(points, alpha, padding, paddedKnots);
+
+    //compute the tangents, directly into the data needed for interpolation
+    auto &positionData = this->common.editPoints();
+    positionData.resize(size + 1);
+    for(size_t i = 0; i < size; i++)
+    {
+        floating_t tPrev = paddedKnots[i - 1 + padding];
+        floating_t tCurrent = paddedKnots[i + padding];
+        floating_t tNext = paddedKnots[i + 1 + padding];
+
+        InterpolationType pPrev = points[(i - 1 + size)%size];
+        InterpolationType pCurrent = points[i];
+        InterpolationType pNext = points[(i + 1)%size];
+
+        positionData[i].position = pCurrent;
+
+        //the tangent is the standard catmull-rom spline tangent calculation
+        positionData[i].tangent = SplineCommon::computeCatmullRomTangent(pPrev, pCurrent, pNext, tPrev, tCurrent, tNext);
+    }
+    positionData[size] = positionData[0];
+
+    //the knots are the padded knots without their padding, so reuse the padded vector's memory
+    SplineCommon::removeKnotPadding(paddedKnots, padding, size + 1);
+
+    this->common.finishBuild(paddedKnots);
+}
+
+template<class InterpolationType, typename floating_t, bool uniformKnots>
+void LoopingCubicHermiteSpline<InterpolationType,floating_t,uniformKnots>::setPoint(size_t index, const InterpolationType &point, const InterpolationType &tangent)
+{
+    assert(editable);
+    this->restoreOriginalPoints();
+    assert(index < this->getOriginalPoints().size());
+
+    knotEditor.initialize(this->getOriginalPoints());
+
+    this->editOriginalPoints()[index] = point;
+    this->common.editPoints()[index].position = point;
+    this->common.editPoints()[index].tangent = tangent;
+
+    finishEdit(index, SplineKnotEditor<InterpolationType, floating_t>::Set);
+}
+
+template<class InterpolationType, typename floating_t, bool uniformKnots>
+void LoopingCubicHermiteSpline<InterpolationType,floating_t,uniformKnots>::insertPoint(size_t index, const InterpolationType &point, const InterpolationType &tangent)
+{
+    assert(editable);
+    this->restoreOriginalPoints();
+    assert(index <= this->getOriginalPoints().size());
+
+    knotEditor.initialize(this->getOriginalPoints());
+
+    typename CubicHermiteSplineCommon<InterpolationType, floating_t, uniformKnots>::CubicHermiteSplinePoint hermitePoint;
+    hermitePoint.position = point;
+    hermitePoint.tangent = tangent;
+
+    auto &points = this->editOriginalPoints();
+    auto &hermitePoints = this->common.editPoints();
+    auto &squaredSpeeds = this->common.editSquaredSpeeds();
+    points.insert(points.begin() + index, point);
+    hermitePoints.insert(hermitePoints.begin() + index, hermitePoint);
+    squaredSpeeds.insert(squaredSpeeds.begin() + std::min(index, squaredSpeeds.size()), std::array<floating_t, 5>());
+
+    finishEdit(index, SplineKnotEditor<InterpolationType, floating_t>::Insert);
+}
+
+template<class InterpolationType, typename floating_t, bool uniformKnots>
+void LoopingCubicHermiteSpline<InterpolationType,floating_t,uniformKnots>::removePoint(size_t index)
+{
+    assert(editable);
+    this->restoreOriginalPoints();
+    assert(index < this->getOriginalPoints().size());
+    assert(this->getOriginalPoints().size() > 2);
+
+    knotEditor.initialize(this->getOriginalPoints());
+
+    auto &points = this->editOriginalPoints();
+    auto &hermitePoints = this->common.editPoints();
+    auto &squaredSpeeds = this->common.editSquaredSpeeds();
+    points.erase(points.begin() + index);
+    hermitePoints.erase(hermitePoints.begin() + index);
+    squaredSpeeds.erase(squaredSpeeds.begin() + std::min(index, squaredSpeeds.size() - 1));
+
+    finishEdit(index, SplineKnotEditor<InterpolationType, floating_t>::Remove);
+}
+
+template<class InterpolationType, typename floating_t, bool uniformKnots>
+void LoopingCubicHermiteSpline<InterpolationType,floating_t,uniformKnots>::finishEdit(size_t index, typename SplineKnotEditor<InterpolationType, floating_t>::EditType type)
+{
+    //the first point is repeated at the end, so keep the copy up to date
+    this->common.editPoints().back() = this->common.editPoints().front();
+
+    floating_t knotScale = knotEditor.update(this->getOriginalPoints(), this->common.editKnots(), index, type);
+    this->maxT = floating_t(this->getOriginalPoints().size());
+
+    //if every knot moved, every segment's squared speed changed. otherwise only the segments on either side of the edited point did
+    size_t segmentCount = this->common.segmentCount();
+    if(knotScale != 1)
+    {
+        this->common.refreshSquaredSpeeds(0, segmentCount);
+    }
+    else
+    {
+        //the segment before the first point is the last segment
+        if(index == 0)
+            this->common.refreshSquaredSpeeds(segmentCount - 1, segmentCount);
+        this->common.refreshSquaredSpeeds(index > 0 ? index - 1 : 0, std::min(index + 1, segmentCount));
+    }
+}
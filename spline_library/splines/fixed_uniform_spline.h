@@ -0,0 +1,187 @@
+#pragma once
+
+#include <cassert>
+#include <array>
+#include <utility>
+
+#include "uniform_cr_spline.h"
+#include "uniform_cubic_bspline.h"
+
+namespace __FixedUniformSplinePrivate
+{
+    //copy points into an array with 3 extra elements, laid out the same way LoopingUniformCRSpline and LoopingUniformCubicBSpline lay out their positions:
+    //the last point first, then every point, then the first two points again
+    template<class InterpolationType, size_t pointCount, size_t... indexes>
+    constexpr std::array<InterpolationType, pointCount + 3> loopPositions(const std::array<InterpolationType, pointCount> &points, std::index_sequence<indexes...>)
+    {
+        return {{ points[(indexes + pointCount - 1) % pointCount]... }};
+    }
+
+    //std::fmod isn't constexpr, so wrap by subtracting a whole number of loops instead
+    template<typename floating_t>
+    constexpr floating_t wrapT(floating_t t, floating_t maxT)
+    {
+        floating_t wrappedT = t - maxT * floating_t(static_cast<long long>(t / maxT));
+        if(wrappedT < 0)
+            return wrappedT + maxT;
+        else
+            return wrappedT;
+    }
+
+    //everything the fixed uniform splines have in common. SplineCore is the core class of the equivalent std::vector-based spline,
+    //which provides the interpolation math as static functions of a point list
+    template<template<class, typename> class SplineCore, class InterpolationType, size_t positionCount, typename floating_t, bool looping>
+    class FixedUniformSpline
+    {
+        static_assert(positionCount >= 4, "a fixed uniform spline needs at least 4 positions");
+
+        typedef SplineCore<InterpolationType, floating_t> Core;
+
+    public:
+        constexpr FixedUniformSpline(const std::array<InterpolationType, positionCount> &positions)
+            :positions(positions)
+        {}
+
+        constexpr InterpolationType getPosition(floating_t globalT) const
+        {
+            floating_t t = wrap(globalT);
+            return getPositionInSegment(segmentForT(t), t);
+        }
+        constexpr typename Spline<InterpolationType,floating_t>::InterpolatedPT getTangent(floating_t globalT) const
+        {
+            floating_t t = wrap(globalT);
+            return getTangentInSegment(segmentForT(t), t);
+        }
+        constexpr typename Spline<InterpolationType,floating_t>::InterpolatedPTC getCurvature(floating_t globalT) const
+        {
+            floating_t t = wrap(globalT);
+            return getCurvatureInSegment(segmentForT(t), t);
+        }
+        constexpr typename Spline<InterpolationType,floating_t>::InterpolatedPTCW getWiggle(floating_t globalT) const
+        {
+            floating_t t = wrap(globalT);
+            return getWiggleInSegment(segmentForT(t), t);
+        }
+
+        constexpr floating_t getMaxT(void) const { return floating_t(segmentCount()); }
+        constexpr bool isLooping(void) const { return looping; }
+
+        //lower level functions
+        constexpr size_t segmentCount(void) const { return positionCount - 3; }
+        constexpr size_t segmentForT(floating_t t) const
+        {
+            if(t < 0)
+                return 0;
+
+            size_t segmentIndex = size_t(t);
+            if(segmentIndex > segmentCount() - 1)
+                return segmentCount() - 1;
+            else
+                return segmentIndex;
+        }
+        constexpr floating_t segmentT(size_t segmentIndex) const { return floating_t(segmentIndex); }
+
+        //evaluate at t, which must already be inside the given segment. same as the Spline methods of the same names
+        constexpr InterpolationType getPositionInSegment(size_t segmentIndex, floating_t t) const
+        {
+            floating_t localT = t - segmentIndex;
+            return Core::computePosition(positions, segmentIndex, localT);
+        }
+        constexpr typename Spline<InterpolationType,floating_t>::InterpolatedPT getTangentInSegment(size_t segmentIndex, floating_t t) const
+        {
+            floating_t localT = t - segmentIndex;
+            return typename Spline<InterpolationType,floating_t>::InterpolatedPT(
+                        Core::computePosition(positions, segmentIndex, localT),
+                        Core::computeTangent(positions, segmentIndex, localT)
+                        );
+        }
+        constexpr typename Spline<InterpolationType,floating_t>::InterpolatedPTC getCurvatureInSegment(size_t segmentIndex, floating_t t) const
+        {
+            floating_t localT = t - segmentIndex;
+            return typename Spline<InterpolationType,floating_t>::InterpolatedPTC(
+                        Core::computePosition(positions, segmentIndex, localT),
+                        Core::computeTangent(positions, segmentIndex, localT),
+                        Core::computeCurvature(positions, segmentIndex, localT)
+                        );
+        }
+        constexpr typename Spline<InterpolationType,floating_t>::InterpolatedPTCW getWiggleInSegment(size_t segmentIndex, floating_t t) const
+        {
+            floating_t localT = t - segmentIndex;
+            return typename Spline<InterpolationType,floating_t>::InterpolatedPTCW(
+                        Core::computePosition(positions, segmentIndex, localT),
+                        Core::computeTangent(positions, segmentIndex, localT),
+                        Core::computeCurvature(positions, segmentIndex, localT),
+                        Core::computeWiggle(positions, segmentIndex)
+                        );
+        }
+
+    protected:
+        std::array<InterpolationType, positionCount> positions;
+
+    private:
+        constexpr floating_t wrap(floating_t t) const
+        {
+            return looping ? wrapT(t, getMaxT()) : t;
+        }
+    };
+}
+
+//fixed-capacity versions of UniformCRSpline, UniformCubicBSpline, and their looping variants, for splines whose number of points is known at compile time
+//the points are stored in a std::array inside the spline object, so nothing is ever allocated, and everything is constexpr whenever InterpolationType's arithmetic is
+//(for example with float, double, or QVector2D) so a spline declared constexpr is built and evaluated at compile time, and ends up in read-only data
+//they evaluate exactly the same as the std::vector-based splines, but they don't inherit from Spline, so they don't support arc length or the utilities that take a Spline
+template<class InterpolationType, size_t pointCount, typename floating_t=float>
+class FixedUniformCRSpline final : public __FixedUniformSplinePrivate::FixedUniformSpline<UniformCRSplineCommon, InterpolationType, pointCount, floating_t, false>
+{
+public:
+    constexpr FixedUniformCRSpline(const std::array<InterpolationType, pointCount> &points)
+        :__FixedUniformSplinePrivate::FixedUniformSpline<UniformCRSplineCommon, InterpolationType, pointCount, floating_t, false>(points)
+    {}
+
+    //the positions are exactly the original points, so there's no need to store them twice
+    constexpr const std::array<InterpolationType, pointCount> &getOriginalPoints(void) const { return this->positions; }
+};
+
+template<class InterpolationType, size_t pointCount, typename floating_t=float>
+class LoopingFixedUniformCRSpline final : public __FixedUniformSplinePrivate::FixedUniformSpline<UniformCRSplineCommon, InterpolationType, pointCount + 3, floating_t, true>
+{
+public:
+    constexpr LoopingFixedUniformCRSpline(const std::array<InterpolationType, pointCount> &points)
+        :__FixedUniformSplinePrivate::FixedUniformSpline<UniformCRSplineCommon, InterpolationType, pointCount + 3, floating_t, true>(
+             __FixedUniformSplinePrivate::loopPositions(points, std::make_index_sequence<pointCount + 3>())),
+         originalPoints(points)
+    {}
+
+    constexpr const std::array<InterpolationType, pointCount> &getOriginalPoints(void) const { return originalPoints; }
+
+private:
+    std::array<InterpolationType, pointCount> originalPoints;
+};
+
+template<class InterpolationType, size_t pointCount, typename floating_t=float>
+class FixedUniformCubicBSpline final : public __FixedUniformSplinePrivate::FixedUniformSpline<UniformCubicBSplineCommon, InterpolationType, pointCount, floating_t, false>
+{
+public:
+    constexpr FixedUniformCubicBSpline(const std::array<InterpolationType, pointCount> &points)
+        :__FixedUniformSplinePrivate::FixedUniformSpline<UniformCubicBSplineCommon, InterpolationType, pointCount, floating_t, false>(points)
+    {}
+
+    //the positions are exactly the original points, so there's no need to store them twice
+    constexpr const std::array<InterpolationType, pointCount> &getOriginalPoints(void) const { return this->positions; }
+};
+
+template<class InterpolationType, size_t pointCount, typename floating_t=float>
+class LoopingFixedUniformCubicBSpline final : public __FixedUniformSplinePrivate::FixedUniformSpline<UniformCubicBSplineCommon, InterpolationType, pointCount + 3, floating_t, true>
+{
+public:
+    constexpr LoopingFixedUniformCubicBSpline(const std::array<InterpolationType, pointCount> &points)
+        :__FixedUniformSplinePrivate::FixedUniformSpline<UniformCubicBSplineCommon, InterpolationType, pointCount + 3, floating_t, true>(
+             __FixedUniformSplinePrivate::loopPositions(points, std::make_index_sequence<pointCount + 3>())),
+         originalPoints(points)
+    {}
+
+    constexpr const std::array<InterpolationType, pointCount> &getOriginalPoints(void) const { return originalPoints; }
+
+private:
+    std::array<InterpolationType, pointCount> originalPoints;
+};
@@ -1,21 +1,28 @@
 #pragma once
 
 #include <cassert>
+#include <array>
+#include <vector>
+#include <algorithm>
 
 #include "../spline.h"
 
-template<class InterpolationType, typename floating_t>
+//if fixedDegree is nonzero, the degree is known at compile time, so the compiler can fully unroll the de boor loops
+template<class InterpolationType, typename floating_t, size_t fixedDegree = 0>
 class GenericBSplineCommon
 {
 public:
     inline GenericBSplineCommon(void) = default;
     inline GenericBSplineCommon(std::vector<InterpolationType> positions, std::vector<floating_t> knots, size_t splineDegree)
         :positions(std::move(positions)), knots(std::move(knots)), splineDegree(splineDegree)
-    {}
+    {
+        std::vector<InterpolationType> scratch;
+        computeSquaredSpeeds(scratch);
+    }
 
     inline size_t segmentCount(void) const
     {
-        return positions.size() - splineDegree;
+        return positions.size() - getDegree();
     }
 
     inline size_t segmentForT(floating_t t) const
@@ -24,7 +31,7 @@ public:
             return 0;
         }
 
-        size_t segmentIndex = SplineCommon::getIndexForT(knots, t) - (splineDegree - 1);
+        size_t segmentIndex = SplineCommon::getIndexForT(knots, t) - (getDegree() - 1);
         if(segmentIndex > segmentCount() - 1)
         {
             return segmentCount() - 1;
@@ -37,68 +44,88 @@ public:
 
     inline floating_t segmentT(size_t segmentIndex) const
     {
-        return knots[segmentIndex + splineDegree - 1];
+        return knots[segmentIndex + getDegree() - 1];
     }
 
     inline InterpolationType getPosition(floating_t globalT) const
     {
-        size_t segmentIndex = segmentForT(globalT);
-        size_t innerIndex = segmentIndex + (splineDegree - 1);
-
-        return computeDeboor(innerIndex + 1, splineDegree, globalT);
+        return positionInSegment(segmentForT(globalT), globalT);
     }
 
     inline typename Spline<InterpolationType,floating_t>::InterpolatedPT getTangent(floating_t globalT) const
     {
-        size_t segmentIndex = segmentForT(globalT);
-        size_t innerIndex = segmentIndex + (splineDegree - 1);
-
-        return typename Spline<InterpolationType,floating_t>::InterpolatedPT(
-                    computeDeboor(innerIndex + 1, splineDegree, globalT),
-                    computeDeboorDerivative(innerIndex + 1, splineDegree, globalT, 1)
-                    );
+        return tangentInSegment(segmentForT(globalT), globalT);
     }
 
     inline typename Spline<InterpolationType,floating_t>::InterpolatedPTC getCurvature(floating_t globalT) const
     {
-        size_t segmentIndex = segmentForT(globalT);
-        size_t innerIndex = segmentIndex + (splineDegree - 1);
-
-        return typename Spline<InterpolationType,floating_t>::InterpolatedPTC(
-                    computeDeboor(innerIndex + 1, splineDegree, globalT),
-                    computeDeboorDerivative(innerIndex + 1, splineDegree, globalT, 1),
-                    computeDeboorDerivative(innerIndex + 1, splineDegree, globalT, 2)
-                    );
+        return curvatureInSegment(segmentForT(globalT), globalT);
     }
 
     inline typename Spline<InterpolationType,floating_t>::InterpolatedPTCW getWiggle(floating_t globalT) const
     {
-        size_t segmentIndex = segmentForT(globalT);
-        size_t innerIndex = segmentIndex + (splineDegree - 1);
+        return wiggleInSegment(segmentForT(globalT), globalT);
+    }
 
-        return typename Spline<InterpolationType,floating_t>::InterpolatedPTCW(
-                    computeDeboor(innerIndex + 1, splineDegree, globalT),
-                    computeDeboorDerivative(innerIndex + 1, splineDegree, globalT, 1),
-                    computeDeboorDerivative(innerIndex + 1, splineDegree, globalT, 2),
-                    computeDeboorDerivative(innerIndex + 1, splineDegree, globalT, 3)
-                    );
+    inline void getPositions(const floating_t *tValues, size_t count, InterpolationType *output) const
+    {
+        size_t segmentIndex = 0;
+        for(size_t i = 0; i < count; i++)
+        {
+            segmentIndex = SplineCommon::segmentForTWithHint(*this, tValues[i], segmentIndex);
+            output[i] = positionInSegment(segmentIndex, tValues[i]);
+        }
     }
 
-    inline floating_t segmentLength(size_t segmentIndex, floating_t a, floating_t b) const {
+    inline void getTangents(const floating_t *tValues, size_t count, typename Spline<InterpolationType,floating_t>::InterpolatedPT *output) const
+    {
+        size_t segmentIndex = 0;
+        for(size_t i = 0; i < count; i++)
+        {
+            segmentIndex = SplineCommon::segmentForTWithHint(*this, tValues[i], segmentIndex);
+            output[i] = tangentInSegment(segmentIndex, tValues[i]);
+        }
+    }
 
-        auto innerIndex = segmentIndex + splineDegree - 1;
+    inline void getCurvatures(const floating_t *tValues, size_t count, typename Spline<InterpolationType,floating_t>::InterpolatedPTC *output) const
+    {
+        size_t segmentIndex = 0;
+        for(size_t i = 0; i < count; i++)
+        {
+            segmentIndex = SplineCommon::segmentForTWithHint(*this, tValues[i], segmentIndex);
+            output[i] = curvatureInSegment(segmentIndex, tValues[i]);
+        }
+    }
+
+    inline void getWiggles(const floating_t *tValues, size_t count, typename Spline<InterpolationType,floating_t>::InterpolatedPTCW *output) const
+    {
+        size_t segmentIndex = 0;
+        for(size_t i = 0; i < count; i++)
+        {
+            segmentIndex = SplineCommon::segmentForTWithHint(*this, tValues[i], segmentIndex);
+            output[i] = wiggleInSegment(segmentIndex, tValues[i]);
+        }
+    }
+
+    inline floating_t segmentLength(size_t segmentIndex, floating_t a, floating_t b, const SplineLibraryCalculus::QuadratureSettings<floating_t> &quadrature) const {
+
+        auto innerIndex = segmentIndex + getDegree() - 1;
 
         floating_t tDistance = knots[innerIndex + 1] - knots[innerIndex];
 
         //it's perfectly legal for Bspline segments to have a T distance of 0, in which case the arc length is 0
         if(tDistance > 0)
         {
-            auto segmentFunction = [this, innerIndex](floating_t t) -> floating_t {
-                auto tangent = computeDeboorDerivative(innerIndex + 1, splineDegree, t, 1);
-                return tangent.length();
+            size_t stride = 2 * getDegree() - 1;
+            const floating_t *squaredSpeed = squaredSpeeds.data() + segmentIndex * stride;
+            auto segmentFunction = [squaredSpeed, stride](floating_t t) -> floating_t {
+                return SplineCommon::evaluateBernsteinSpeed(squaredSpeed, stride, t);
             };
 
-            return SplineLibraryCalculus::gaussLegendreQuadratureIntegral<floating_t>(segmentFunction, a, b);
+            //the cached polynomial is the speed with respect to local t, so it already includes the factor of tDistance
+            floating_t localA = (a - knots[innerIndex]) / tDistance;
+            floating_t localB = (b - knots[innerIndex]) / tDistance;
+            return SplineLibraryCalculus::integrate<floating_t>(segmentFunction, localA, localB, quadrature);
         }
         else
         {
@@ -106,100 +133,365 @@ public:
         }
     }
 
+    inline size_t getDegree(void) const
+    {
+        return fixedDegree > 0 ? fixedDegree : splineDegree;
+    }
+
+    //direct access to the positions and knots, for rebuilding a spline in place
+    inline std::vector<InterpolationType> &editPositions(void) { return positions; }
+    inline std::vector<floating_t> &editKnots(void) { return knots; }
+
+    //recompute the cached squared speeds, after a spline's rebuild replaced the positions and knots in place with ones of the given degree
+    //scratch holds the bezier conversion's temporaries, so that a rebuild can keep it and not allocate
+    inline void finishBuild(size_t degree, std::vector<InterpolationType> &scratch)
+    {
+        splineDegree = degree;
+        computeSquaredSpeeds(scratch);
+    }
+
+    //the points this core keeps a copy of, in order, including any that a looping spline repeated. used to rebuild a spline's original points after they've been discarded
+    inline size_t storedPointCount(void) const { return positions.size(); }
+    inline const InterpolationType &storedPoint(size_t index) const { return positions[index]; }
+
+    //the number of bytes this core has allocated
+    inline size_t heapFootprint(void) const
+    {
+        return SplineCommon::vectorFootprint(positions) + SplineCommon::vectorFootprint(knots) + SplineCommon::vectorFootprint(squaredSpeeds);
+    }
+
+
+    //these skip the segment search, for callers that already know which segment globalT is in
+    inline InterpolationType positionInSegment(size_t segmentIndex, floating_t globalT) const
+    {
+        size_t innerIndex = segmentIndex + (getDegree() - 1);
+
+        return computeDeboor<0>(innerIndex + 1, globalT)[0];
+    }
+
+    inline typename Spline<InterpolationType,floating_t>::InterpolatedPT tangentInSegment(size_t segmentIndex, floating_t globalT) const
+    {
+        size_t innerIndex = segmentIndex + (getDegree() - 1);
+        auto result = computeDeboor<1>(innerIndex + 1, globalT);
+
+        return typename Spline<InterpolationType,floating_t>::InterpolatedPT(result[0], result[1]);
+    }
+
+    inline typename Spline<InterpolationType,floating_t>::InterpolatedPTC curvatureInSegment(size_t segmentIndex, floating_t globalT) const
+    {
+        size_t innerIndex = segmentIndex + (getDegree() - 1);
+        auto result = computeDeboor<2>(innerIndex + 1, globalT);
+
+        return typename Spline<InterpolationType,floating_t>::InterpolatedPTC(result[0], result[1], result[2]);
+    }
+
+    inline typename Spline<InterpolationType,floating_t>::InterpolatedPTCW wiggleInSegment(size_t segmentIndex, floating_t globalT) const
+    {
+        size_t innerIndex = segmentIndex + (getDegree() - 1);
+        auto result = computeDeboor<3>(innerIndex + 1, globalT);
+
+        return typename Spline<InterpolationType,floating_t>::InterpolatedPTCW(result[0], result[1], result[2], result[3]);
+    }
+
 private: //methods
-    InterpolationType computeDeboor(size_t knotIndex, size_t degree, float globalT) const;
-    InterpolationType computeDeboorDerivative(size_t knotIndex, size_t degree, float globalT, int derivativeLevel) const;
+    //compute the position and the first derivativeCount derivatives at globalT, all in one pass
+    //result[0] is the position, result[1] is the first derivative, etc
+    template<size_t derivativeCount>
+    std::array<InterpolationType, derivativeCount + 1> computeDeboor(size_t knotIndex, floating_t globalT) const;
+
+    template<size_t derivativeCount>
+    void computeDeboor(size_t knotIndex, floating_t globalT, InterpolationType *workspace, std::array<InterpolationType, derivativeCount + 1> &result) const;
+
+    //convert each segment to bezier form, and cache the squared length of its derivative for segmentLength. scratch is resized to fit the temporaries
+    void computeSquaredSpeeds(std::vector<InterpolationType> &scratch);
 
 private: //data
     std::vector<InterpolationType> positions;
     std::vector<floating_t> knots;
     size_t splineDegree;
+
+    //for each segment, 2 * degree - 1 bernstein coefficients of the squared length of the tangent with respect to local t
+    std::vector<floating_t> squaredSpeeds;
+
+    //degrees up to this size are evaluated with a workspace on the stack. anything larger falls back to the heap
+    static const size_t maxStackDegree = fixedDegree > 0 ? fixedDegree : 15;
 };
 
-template<class InterpolationType, typename floating_t>
-InterpolationType GenericBSplineCommon<InterpolationType,floating_t>::computeDeboor(size_t knotIndex, size_t degree, float globalT) const
+template<class InterpolationType, typename floating_t, size_t fixedDegree>
+template<size_t derivativeCount>
+std::array<InterpolationType, derivativeCount + 1> GenericBSplineCommon<InterpolationType,floating_t,fixedDegree>::computeDeboor(size_t knotIndex, floating_t globalT) const
 {
-    if(degree == 0)
+    //any derivative higher than the degree is zero, so leave it default-constructed
+    std::array<InterpolationType, derivativeCount + 1> result{};
+
+    if(getDegree() <= maxStackDegree)
     {
-        return positions[knotIndex];
+        std::array<InterpolationType, maxStackDegree + 1> workspace;
+        computeDeboor<derivativeCount>(knotIndex, globalT, workspace.data(), result);
     }
     else
     {
-        floating_t alpha = (globalT - knots[knotIndex - 1]) / (knots[knotIndex + splineDegree - degree] - knots[knotIndex - 1]);
-
-        InterpolationType leftRecursive = computeDeboor(knotIndex - 1, degree - 1, globalT);
-        InterpolationType rightRecursive = computeDeboor(knotIndex, degree - 1, globalT);
-
-        InterpolationType blended = leftRecursive * (1 - alpha) + rightRecursive * alpha;
-
-        return blended;
+        std::vector<InterpolationType> workspace(getDegree() + 1);
+        computeDeboor<derivativeCount>(knotIndex, globalT, workspace.data(), result);
     }
+
+    return result;
 }
 
-template<class InterpolationType, typename floating_t>
-InterpolationType GenericBSplineCommon<InterpolationType,floating_t>::computeDeboorDerivative(size_t knotIndex, size_t degree, float globalT, int derivativeLevel) const
+template<class InterpolationType, typename floating_t, size_t fixedDegree>
+template<size_t derivativeCount>
+void GenericBSplineCommon<InterpolationType,floating_t,fixedDegree>::computeDeboor(
+        size_t knotIndex, floating_t globalT, InterpolationType *workspace, std::array<InterpolationType, derivativeCount + 1> &result) const
 {
-    if(degree == 0)
+    //this is the triangular version of the de boor recursion: the recursive version evaluates the same sub-blends over and over,
+    //so instead we start with the degree+1 control points that affect this segment and blend adjacent pairs until one point is left
+    //workspace[i] corresponds to positions[firstPosition + i]. after blending level "level", workspace[level..degree] is valid
+    const size_t degree = getDegree();
+    const size_t firstPosition = knotIndex - degree;
+
+    for(size_t i = 0; i <= degree; i++)
     {
-        //if we hit degree 0 before derivative level 0, then this spline's
-        //degree isn't high enough to support whatever derivative level was requested
-        return InterpolationType();
+        workspace[i] = positions[firstPosition + i];
     }
-    else
+
+    //the nth derivative is computed by stopping the blending n levels early, then taking n levels of differences instead
+    //so whenever we reach a level that some requested derivative branches off from, finish that derivative in a separate scratch space
+    auto computeDerivative = [&](size_t derivative) {
+        const size_t branchLevel = degree - derivative;
+
+        std::array<InterpolationType, derivativeCount + 1> differences;
+        for(size_t i = 0; i <= derivative; i++)
+        {
+            differences[i] = workspace[branchLevel + i];
+        }
+
+        for(size_t level = branchLevel + 1; level <= degree; level++)
+        {
+            for(size_t i = degree; i >= level; i--)
+            {
+                size_t index = firstPosition + i;
+                floating_t multiplier = level / (knots[index + degree - level] - knots[index - 1]);
+
+                differences[i - branchLevel] = multiplier * (differences[i - branchLevel] - differences[i - branchLevel - 1]);
+            }
+        }
+
+        result[derivative] = differences[derivative];
+    };
+
+    for(size_t level = 1; level <= degree; level++)
     {
-        floating_t multiplier = degree / (knots[knotIndex + splineDegree - degree] - knots[knotIndex - 1]);
+        //the previous level is complete, so any derivative that branches off from it can be finished now
+        if(degree - (level - 1) <= derivativeCount)
+        {
+            computeDerivative(degree - (level - 1));
+        }
 
-        if(derivativeLevel <= 1)
+        for(size_t i = degree; i >= level; i--)
         {
-            //once we reach this point, the derivative calculation is "complete"
-            //in that from here, we go back to the normal deboor calculation deeper in the recursive tree
-            return multiplier *
-                    (computeDeboor(knotIndex, degree - 1, globalT)
-                   - computeDeboor(knotIndex - 1, degree - 1, globalT)
-                     );
+            size_t index = firstPosition + i;
+            floating_t alpha = (globalT - knots[index - 1]) / (knots[index + degree - level] - knots[index - 1]);
+
+            workspace[i] = workspace[i - 1] * (1 - alpha) + workspace[i] * alpha;
         }
-        else
+    }
+
+    result[0] = workspace[degree];
+}
+
+template<class InterpolationType, typename floating_t, size_t fixedDegree>
+void GenericBSplineCommon<InterpolationType,floating_t,fixedDegree>::computeSquaredSpeeds(std::vector<InterpolationType> &scratch)
+{
+    const size_t degree = getDegree();
+    const size_t stride = 2 * degree - 1;
+    squaredSpeeds.assign(segmentCount() * stride, floating_t(0));
+
+    //de boor's workspace and the bezier control points each need degree + 1 elements, and the derivative's control points need degree
+    scratch.resize(degree * 3 + 2);
+    InterpolationType *workspace = scratch.data();
+    InterpolationType *bezier = workspace + degree + 1;
+    InterpolationType *derivative = bezier + degree + 1;
+
+    for(size_t segmentIndex = 0; segmentIndex < segmentCount(); segmentIndex++)
+    {
+        const size_t knotIndex = segmentIndex + degree;
+        const size_t firstPosition = knotIndex - degree;
+        floating_t beginT = knots[knotIndex - 1];
+        floating_t endT = knots[knotIndex];
+
+        //segments with no T distance have no length, so segmentLength never reads their coefficients
+        if(endT <= beginT)
+            continue;
+
+        //bezier control point k is the blossom of the segment with beginT repeated degree - k times and endT repeated k times
+        //the blossom is the de boor recursion above, except that each level can blend with a different t
+        for(size_t k = 0; k <= degree; k++)
+        {
+            for(size_t i = 0; i <= degree; i++)
+            {
+                workspace[i] = positions[firstPosition + i];
+            }
+
+            for(size_t level = 1; level <= degree; level++)
+            {
+                floating_t levelT = level <= degree - k ? beginT : endT;
+                for(size_t i = degree; i >= level; i--)
+                {
+                    size_t index = firstPosition + i;
+                    floating_t alpha = (levelT - knots[index - 1]) / (knots[index + degree - level] - knots[index - 1]);
+
+                    workspace[i] = workspace[i - 1] * (1 - alpha) + workspace[i] * alpha;
+                }
+            }
+            bezier[k] = workspace[degree];
+        }
+
+        //the control points of the derivative with respect to local t are degree times the differences of the control points
+        for(size_t k = 0; k < degree; k++)
         {
-            //recursively call the derivative function to compute a higher derivative
-            return multiplier *
-                    (computeDeboorDerivative(knotIndex, degree - 1, globalT, derivativeLevel - 1)
-                   - computeDeboorDerivative(knotIndex - 1, degree - 1, globalT, derivativeLevel - 1)
-                     );
+            derivative[k] = floating_t(degree) * (bezier[k + 1] - bezier[k]);
         }
+
+        SplineCommon::computeBernsteinSquaredSpeed(derivative, degree, squaredSpeeds.data() + segmentIndex * stride);
     }
 }
 
-template<class InterpolationType, typename floating_t=float>
-class GenericBSpline final : public SplineImpl<GenericBSplineCommon, InterpolationType, floating_t>
+namespace __GenericBSplinePrivate
+{
+    //SplineImpl expects a spline core with exactly two template parameters, so bind the fixed degree ahead of time
+    template<size_t fixedDegree>
+    struct FixedDegree
+    {
+        template<class InterpolationType, typename floating_t>
+        using Common = GenericBSplineCommon<InterpolationType, floating_t, fixedDegree>;
+    };
+}
+
+//if fixedDegree is nonzero, the degree is a compile-time constant, and the degree passed to the constructor must either match it or be left out
+//IE GenericBSpline<QVector2D, float, 3> is a cubic B-spline that evaluates faster than GenericBSpline<QVector2D>(points, 3)
+template<class InterpolationType, typename floating_t=float, size_t fixedDegree=0>
+class GenericBSpline final : public SplineImpl<__GenericBSplinePrivate::FixedDegree<fixedDegree>::template Common, InterpolationType, floating_t>
 {
 //constructors
 public:
-    GenericBSpline(const std::vector<InterpolationType> &points, size_t degree)
-        :SplineImpl<GenericBSplineCommon, InterpolationType,floating_t>(points, points.size() - degree)
+    GenericBSpline(const std::vector<InterpolationType> &points, size_t degree = fixedDegree)
+        :SplineImpl<__GenericBSplinePrivate::FixedDegree<fixedDegree>::template Common, InterpolationType,floating_t>(points, points.size() - degree)
+    {
+        std::vector<InterpolationType> scratch;
+        build(points, degree, scratch);
+    }
+
+    //a B-spline with the given knots, instead of evenly spaced ones. knots has points.size() + degree - 1 elements, in increasing order, and knots[degree - 1] must be 0
+    //the spline goes from t = 0 to t = knots[points.size() - 1], and segment i goes from knots[i + degree - 1] to knots[i + degree]
+    //see SplineFitting for a way to choose them
+    GenericBSpline(const std::vector<InterpolationType> &points, const std::vector<floating_t> &knots, size_t degree = fixedDegree)
+        :SplineImpl<__GenericBSplinePrivate::FixedDegree<fixedDegree>::template Common, InterpolationType,floating_t>(points, knots[points.size() - 1])
+    {
+        std::vector<InterpolationType> scratch;
+        build(points, knots, degree, scratch);
+    }
+
+//rebuilding
+public:
+    //replace this spline with the one the matching constructor would build from the given arguments, reusing this spline's memory
+    //as long as there are no more points than the last time, and the degree is no higher, nothing is allocated
+    inline void rebuild(const std::vector<InterpolationType> &points, size_t degree = fixedDegree)
     {
+        this->replaceOriginalPoints(points, floating_t(points.size() - degree));
+        build(points, degree, retainedScratch.get().values);
+    }
+
+    inline void rebuild(const std::vector<InterpolationType> &points, const std::vector<floating_t> &knots, size_t degree = fixedDegree)
+    {
+        this->replaceOriginalPoints(points, knots[points.size() - 1]);
+        build(points, knots, degree, retainedScratch.get().values);
+    }
+
+    size_t memoryFootprint(void) const override
+    {
+        return sizeof(*this) + this->originalPointsFootprint() + this->common.heapFootprint() + retainedScratch.heapFootprint();
+    }
+
+private:
+    //fill the core from scratch, for the constructor and rebuild
+    void build(const std::vector<InterpolationType> &points, size_t degree, std::vector<InterpolationType> &scratch)
+    {
+        assert(degree > 0);
+        assert(fixedDegree == 0 || degree == fixedDegree);
         assert(points.size() > degree);
 
-        std::vector<floating_t> knots(points.size() + degree - 1);
+        std::vector<floating_t> &knots = this->common.editKnots();
+        knots.resize(points.size() + degree - 1);
         for(size_t i = 0; i < knots.size(); i++)
         {
             knots[i] = floating_t(i) - floating_t(degree - 1);
         }
 
-        common = GenericBSplineCommon<InterpolationType, floating_t>(points, std::move(knots), degree);
+        this->common.editPositions().assign(points.begin(), points.end());
+        this->common.finishBuild(degree, scratch);
+    }
+
+    void build(const std::vector<InterpolationType> &points, const std::vector<floating_t> &knots, size_t degree, std::vector<InterpolationType> &scratch)
+    {
+        assert(degree > 0);
+        assert(fixedDegree == 0 || degree == fixedDegree);
+        assert(points.size() > degree);
+        assert(knots.size() == points.size() + degree - 1);
+        assert(knots[degree - 1] == 0);
+        assert(std::is_sorted(knots.begin(), knots.end()));
+
+        this->common.editKnots().assign(knots.begin(), knots.end());
+        this->common.editPositions().assign(points.begin(), points.end());
+        this->common.finishBuild(degree, scratch);
     }
+
+    bool reconstructOriginalPoints(std::vector<InterpolationType> &output) const override
+    {
+        //the core keeps every point unchanged
+        SplineCommon::copyStoredPoints(this->common, 0, this->common.storedPointCount(), output);
+        return true;
+    }
+
+    SplineCommon::RetainedBuildScratch<InterpolationType, floating_t> retainedScratch;
 };
 
-template<class InterpolationType, typename floating_t=float>
-class LoopingGenericBSpline final : public SplineLoopingImpl<GenericBSplineCommon, InterpolationType, floating_t>
+template<class InterpolationType, typename floating_t=float, size_t fixedDegree=0>
+class LoopingGenericBSpline final : public SplineLoopingImpl<__GenericBSplinePrivate::FixedDegree<fixedDegree>::template Common, InterpolationType, floating_t>
 {
 //constructors
 public:
-    LoopingGenericBSpline(const std::vector<InterpolationType> &points, size_t degree)
-        :SplineLoopingImpl<GenericBSplineCommon, InterpolationType,floating_t>(points, points.size())
+    LoopingGenericBSpline(const std::vector<InterpolationType> &points, size_t degree = fixedDegree)
+        :SplineLoopingImpl<__GenericBSplinePrivate::FixedDegree<fixedDegree>::template Common, InterpolationType,floating_t>(points, points.size())
+    {
+        std::vector<InterpolationType> scratch;
+        build(points, degree, scratch);
+    }
+
+//rebuilding
+public:
+    //replace this spline with the one the constructor would build from the given arguments, reusing this spline's memory
+    //as long as there are no more points than the last time, and the degree is no higher, nothing is allocated
+    inline void rebuild(const std::vector<InterpolationType> &points, size_t degree = fixedDegree)
+    {
+        this->replaceOriginalPoints(points, floating_t(points.size()));
+        build(points, degree, retainedScratch.get().values);
+    }
+
+    size_t memoryFootprint(void) const override
+    {
+        return sizeof(*this) + this->originalPointsFootprint() + this->common.heapFootprint() + retainedScratch.heapFootprint();
+    }
+
+private:
+    //fill the core from scratch, for the constructor and rebuild
+    void build(const std::vector<InterpolationType> &points, size_t degree, std::vector<InterpolationType> &scratch)
     {
+        assert(degree > 0);
+        assert(fixedDegree == 0 || degree == fixedDegree);
         assert(points.size() > degree);
 
-        std::vector<floating_t> knots(points.size() + degree * 2 - 1);
+        std::vector<floating_t> &knots = this->common.editKnots();
+        knots.resize(points.size() + degree * 2 - 1);
         for(size_t i = 0; i < knots.size(); i++)
         {
             knots[i] = floating_t(i) - floating_t(degree - 1);
@@ -209,14 +501,24 @@ public:
         //this DOES work, but interpolation begins in the wrong place (ie getPosition(0) occurs at the wrong place on the spline)
         //to fix this, we effectively "rotate" the position vector backwards, by copying point[size-1] to the beginning
         //then copying the points vector in after, then copying degree-1 elements from the beginning
-        std::vector<InterpolationType> positions(points.size() + degree);
+        std::vector<InterpolationType> &positions = this->common.editPositions();
+        positions.resize(points.size() + degree);
 
         size_t padding = degree - 1;
         positions[0] = points[points.size() - 1];
         std::copy(points.begin(), points.end(), positions.begin() + 1);
         std::copy_n(points.begin(), padding, positions.end() - padding);
 
-        common = GenericBSplineCommon<InterpolationType, floating_t>(std::move(positions), std::move(knots), degree);
+        this->common.finishBuild(degree, scratch);
     }
+
+    bool reconstructOriginalPoints(std::vector<InterpolationType> &output) const override
+    {
+        //the core keeps the last point, then every point, then the first degree - 1 points again
+        SplineCommon::copyStoredPoints(this->common, 1, this->common.storedPointCount() - this->common.getDegree(), output);
+        return true;
+    }
+
+    SplineCommon::RetainedBuildScratch<InterpolationType, floating_t> retainedScratch;
 };
 
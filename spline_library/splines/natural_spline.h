@@ -1,11 +1,17 @@
 #pragma once
 
 #include <cassert>
+#include <limits>
+#include <array>
 
 #include "../spline.h"
 #include "../utils/linearalgebra.h"
+#include "../utils/knot_editor.h"
+#include "../utils/parallelfor.h"
 
-template<class InterpolationType, typename floating_t>
+//if uniformKnots is true, the spline must have been built with alpha == 0, so its knots are just 0, 1, 2, etc
+//then the knots aren't stored, segment lookup is a floor, and the compiler can fold away every division by the T distance
+template<class InterpolationType, typename floating_t, bool uniformKnots = false>
 class NaturalSplineCommon
 {
 public:
@@ -16,8 +22,10 @@ public:
 
     inline NaturalSplineCommon(void) = default;
     inline NaturalSplineCommon(std::vector<NaturalSplineSegment> segments, std::vector<floating_t> knots)
-        :segments(std::move(segments)), knots(std::move(knots))
-    {}
+        :segments(std::move(segments)), knots(std::move(knots)), squaredSpeeds(segmentCount())
+    {
+        refreshSquaredSpeeds(0, segmentCount());
+    }
 
     inline size_t segmentCount(void) const
     {
@@ -26,7 +34,7 @@ public:
 
     inline size_t segmentForT(floating_t t) const
     {
-        size_t segmentIndex = SplineCommon::getIndexForT(knots, t);
+        size_t segmentIndex = knots.indexForT(t);
         if(segmentIndex >= segmentCount())
             return segmentCount() - 1;
         else
@@ -40,24 +48,127 @@ public:
 
     inline InterpolationType getPosition(floating_t globalT) const
     {
-        size_t segmentIndex = SplineCommon::getIndexForT(knots, globalT);
-        if(segmentIndex >= knots.size() - 1)
-            segmentIndex--;
+        return positionInSegment(segmentForT(globalT), globalT);
+    }
+
+    inline typename Spline<InterpolationType,floating_t>::InterpolatedPT getTangent(floating_t globalT) const
+    {
+        return tangentInSegment(segmentForT(globalT), globalT);
+    }
 
+    inline typename Spline<InterpolationType,floating_t>::InterpolatedPTC getCurvature(floating_t globalT) const
+    {
+        return curvatureInSegment(segmentForT(globalT), globalT);
+    }
+
+    inline typename Spline<InterpolationType,floating_t>::InterpolatedPTCW getWiggle(floating_t globalT) const
+    {
+        return wiggleInSegment(segmentForT(globalT), globalT);
+    }
+
+    inline void getPositions(const floating_t *tValues, size_t count, InterpolationType *output) const
+    {
+        size_t segmentIndex = 0;
+        for(size_t i = 0; i < count; i++)
+        {
+            segmentIndex = SplineCommon::segmentForTWithHint(*this, tValues[i], segmentIndex);
+            output[i] = positionInSegment(segmentIndex, tValues[i]);
+        }
+    }
+
+    inline void getTangents(const floating_t *tValues, size_t count, typename Spline<InterpolationType,floating_t>::InterpolatedPT *output) const
+    {
+        size_t segmentIndex = 0;
+        for(size_t i = 0; i < count; i++)
+        {
+            segmentIndex = SplineCommon::segmentForTWithHint(*this, tValues[i], segmentIndex);
+            output[i] = tangentInSegment(segmentIndex, tValues[i]);
+        }
+    }
+
+    inline void getCurvatures(const floating_t *tValues, size_t count, typename Spline<InterpolationType,floating_t>::InterpolatedPTC *output) const
+    {
+        size_t segmentIndex = 0;
+        for(size_t i = 0; i < count; i++)
+        {
+            segmentIndex = SplineCommon::segmentForTWithHint(*this, tValues[i], segmentIndex);
+            output[i] = curvatureInSegment(segmentIndex, tValues[i]);
+        }
+    }
+
+    inline void getWiggles(const floating_t *tValues, size_t count, typename Spline<InterpolationType,floating_t>::InterpolatedPTCW *output) const
+    {
+        size_t segmentIndex = 0;
+        for(size_t i = 0; i < count; i++)
+        {
+            segmentIndex = SplineCommon::segmentForTWithHint(*this, tValues[i], segmentIndex);
+            output[i] = wiggleInSegment(segmentIndex, tValues[i]);
+        }
+    }
+
+    inline floating_t segmentLength(size_t segmentIndex, floating_t a, floating_t b, const SplineLibraryCalculus::QuadratureSettings<floating_t> &quadrature) const {
+
+        const auto &squaredSpeed = squaredSpeeds[segmentIndex];
+        auto segmentFunction = [&squaredSpeed](floating_t t) -> floating_t {
+            return SplineCommon::evaluateSpeed(squaredSpeed.data(), squaredSpeed.size(), t);
+        };
+
+        floating_t localA = a - knots[segmentIndex];
+        floating_t localB = b - knots[segmentIndex];
+
+        return SplineLibraryCalculus::integrate<floating_t>(segmentFunction, localA, localB, quadrature);
+    }
+
+    //direct access to the segment data, for the splines that support editing their points in place
+    inline std::vector<NaturalSplineSegment> &editSegments(void) { return segments; }
+    inline SplineCommon::Knots<floating_t, uniformKnots> &editKnots(void) { return knots; }
+    inline std::vector<std::array<floating_t, 5>> &editSquaredSpeeds(void) { return squaredSpeeds; }
+
+    //resize and recompute everything derived from the segments and knots, after a spline's rebuild replaced them all in place
+    //builtKnots is the vector the knots were computed into, from SplineCommon::Knots::buildStorage
+    inline void finishBuild(const std::vector<floating_t> &builtKnots)
+    {
+        knots.finishBuild(builtKnots);
+        squaredSpeeds.resize(segmentCount());
+        refreshSquaredSpeeds(0, segmentCount());
+    }
+
+    //recompute the cached squared speeds of segments [beginSegment, endSegment), after the points, curvatures, or knots they depend on were edited
+    inline void refreshSquaredSpeeds(size_t beginSegment, size_t endSegment)
+    {
+        for(size_t i = beginSegment; i < endSegment; i++)
+        {
+            //the segment is stored in power basis already, so the tangent's coefficients are just b, 2c, and 3d
+            floating_t tDiff = knots.tDiff(i);
+            std::array<InterpolationType, 3> tangent = {{computeB(i, tDiff), floating_t(2) * segments[i].c, floating_t(3) * computeD(i, tDiff)}};
+            SplineCommon::computeSquaredSpeed(tangent.data(), tangent.size(), squaredSpeeds[i].data());
+        }
+    }
+
+    //the points this core keeps a copy of, in order, including any that a looping spline repeated. used to rebuild a spline's original points after they've been discarded
+    inline size_t storedPointCount(void) const { return segments.size(); }
+    inline const InterpolationType &storedPoint(size_t index) const { return segments[index].a; }
+
+    //the number of bytes this core has allocated
+    inline size_t heapFootprint(void) const
+    {
+        return SplineCommon::vectorFootprint(segments) + knots.heapFootprint() + SplineCommon::vectorFootprint(squaredSpeeds);
+    }
+
+
+    //these skip the segment search, for callers that already know which segment globalT is in
+    inline InterpolationType positionInSegment(size_t segmentIndex, floating_t globalT) const
+    {
         floating_t localT = globalT - knots[segmentIndex];
-        floating_t tDiff = knots[segmentIndex + 1] - knots[segmentIndex];
+        floating_t tDiff = knots.tDiff(segmentIndex);
 
         return computePosition(segmentIndex, tDiff, localT);
     }
 
-    inline typename Spline<InterpolationType,floating_t>::InterpolatedPT getTangent(floating_t globalT) const
+    inline typename Spline<InterpolationType,floating_t>::InterpolatedPT tangentInSegment(size_t segmentIndex, floating_t globalT) const
     {
-        size_t segmentIndex = SplineCommon::getIndexForT(knots, globalT);
-        if(segmentIndex >= knots.size() - 1)
-            segmentIndex--;
-
         floating_t localT = globalT - knots[segmentIndex];
-        floating_t tDiff = knots[segmentIndex + 1] - knots[segmentIndex];
+        floating_t tDiff = knots.tDiff(segmentIndex);
 
         return typename Spline<InterpolationType,floating_t>::InterpolatedPT(
                     computePosition(segmentIndex, tDiff, localT),
@@ -65,14 +176,10 @@ public:
                     );
     }
 
-    inline typename Spline<InterpolationType,floating_t>::InterpolatedPTC getCurvature(floating_t globalT) const
+    inline typename Spline<InterpolationType,floating_t>::InterpolatedPTC curvatureInSegment(size_t segmentIndex, floating_t globalT) const
     {
-        size_t segmentIndex = SplineCommon::getIndexForT(knots, globalT);
-        if(segmentIndex >= knots.size() - 1)
-            segmentIndex--;
-
         floating_t localT = globalT - knots[segmentIndex];
-        floating_t tDiff = knots[segmentIndex + 1] - knots[segmentIndex];
+        floating_t tDiff = knots.tDiff(segmentIndex);
 
         return typename Spline<InterpolationType,floating_t>::InterpolatedPTC(
                     computePosition(segmentIndex, tDiff, localT),
@@ -81,14 +188,10 @@ public:
                     );
     }
 
-    inline typename Spline<InterpolationType,floating_t>::InterpolatedPTCW getWiggle(floating_t globalT) const
+    inline typename Spline<InterpolationType,floating_t>::InterpolatedPTCW wiggleInSegment(size_t segmentIndex, floating_t globalT) const
     {
-        size_t segmentIndex = SplineCommon::getIndexForT(knots, globalT);
-        if(segmentIndex >= knots.size() - 1)
-            segmentIndex--;
-
         floating_t localT = globalT - knots[segmentIndex];
-        floating_t tDiff = knots[segmentIndex + 1] - knots[segmentIndex];
+        floating_t tDiff = knots.tDiff(segmentIndex);
 
         return typename Spline<InterpolationType,floating_t>::InterpolatedPTCW(
                     computePosition(segmentIndex, tDiff, localT),
@@ -98,20 +201,6 @@ public:
                     );
     }
 
-    inline floating_t segmentLength(size_t segmentIndex, floating_t a, floating_t b) const {
-
-        floating_t tDiff = knots[segmentIndex + 1] - knots[segmentIndex];
-        auto segmentFunction = [=](floating_t t) -> floating_t {
-            auto tangent = computeTangent(segmentIndex, tDiff, t);
-            return tangent.length();
-        };
-
-        floating_t localA = a - knots[segmentIndex];
-        floating_t localB = b - knots[segmentIndex];
-
-        return SplineLibraryCalculus::gaussLegendreQuadratureIntegral<floating_t>(segmentFunction, localA, localB);
-    }
-
 private: //methods
     inline InterpolationType computePosition(size_t index, floating_t tDiff, floating_t t) const
     {
@@ -168,12 +257,251 @@ private: //methods
 
 private: //data
     std::vector<NaturalSplineSegment> segments;
-    std::vector<floating_t> knots;
+    SplineCommon::Knots<floating_t, uniformKnots> knots;
+
+    //for each segment, the squared length of the tangent as a polynomial of local t, so that arc length integrands don't need the tangent
+    std::vector<std::array<floating_t, 5>> squaredSpeeds;
 };
 
 
-template<class InterpolationType, typename floating_t=float>
-class NaturalSpline final : public SplineImpl<NaturalSplineCommon, InterpolationType, floating_t>
+namespace __NaturalSplinePrivate
+{
+    //after an edit, re-solve the curvatures of the points in [windowBegin, windowEnd), holding the curvatures just outside the window fixed
+    //a change to one row of the tridiagonal system affects each following curvature at most half as much as the previous one,
+    //so extending the window floating point precision's number of bits past the edit makes the truncated solve as accurate as a full one.
+    //indexes are wrapped around for looping splines, and clamped to the interior points for non-looping splines
+    //the system is built and solved in scratch, which the spline keeps in its knot editor, so repeated edits reuse the same memory
+    template<class InterpolationType, typename floating_t, bool uniformKnots>
+    void solveCurvatureWindow(
+            std::vector<typename NaturalSplineCommon<InterpolationType, floating_t, uniformKnots>::NaturalSplineSegment> &segments,
+            const SplineCommon::Knots<floating_t, uniformKnots> &knots,
+            bool looping,
+            ptrdiff_t windowBegin,
+            ptrdiff_t windowEnd,
+            typename SplineKnotEditor<InterpolationType, floating_t>::WindowScratch &scratch)
+    {
+        ptrdiff_t pointCount = looping ? segments.size() - 1 : segments.size();
+
+        if(looping)
+        {
+            //if the window would wrap around onto itself, just solve the whole loop
+            if(windowEnd - windowBegin >= pointCount)
+            {
+                windowBegin = 0;
+                windowEnd = pointCount;
+            }
+        }
+        else
+        {
+            //natural end conditions: the first and last curvature are always 0
+            segments.front().c = InterpolationType();
+            segments.back().c = InterpolationType();
+
+            windowBegin = std::max(windowBegin, ptrdiff_t(1));
+            windowEnd = std::min(windowEnd, pointCount - 1);
+        }
+
+        if(windowBegin >= windowEnd)
+            return;
+
+        auto wrap = [pointCount](ptrdiff_t i) { return size_t((i % pointCount + pointCount) % pointCount); };
+        auto tDiff = [&](ptrdiff_t i) { return knots.tDiff(wrap(i)); };
+        auto deltaPoint = [&](ptrdiff_t i) { return (segments[wrap(i + 1)].a - segments[wrap(i)].a) / tDiff(i); };
+
+        //build the same tridiagonal system that the constructors build, but only for the rows inside the window
+        size_t windowSize = windowEnd - windowBegin;
+        scratch.resize(windowSize);
+        floating_t *diagonal = scratch.diagonal.data();
+        floating_t *secondaryDiagonal = scratch.secondaryDiagonal.data();
+        InterpolationType *inputVector = scratch.values.data();
+        for(size_t i = 0; i < windowSize; i++)
+        {
+            ptrdiff_t row = windowBegin + i;
+            diagonal[i] = 2 * (tDiff(row - 1) + tDiff(row));
+            secondaryDiagonal[i] = tDiff(row);
+            inputVector[i] = floating_t(3) * (deltaPoint(row) - deltaPoint(row - 1));
+        }
+
+        //the solvers replace the input vector with the curvatures
+        if(looping && windowSize == size_t(pointCount))
+        {
+            LinearAlgebra::solveCyclicSymmetricTridiagonalInPlace(diagonal, secondaryDiagonal, inputVector, scratch.correction.data(), windowSize);
+        }
+        else
+        {
+            //the curvatures just outside the window are known, so move them to the right side of the equation
+            inputVector[0] -= tDiff(windowBegin - 1) * segments[wrap(windowBegin - 1)].c;
+            inputVector[windowSize - 1] -= tDiff(windowEnd - 1) * segments[wrap(windowEnd)].c;
+
+            //the last element of the secondary diagonal is the corner of the cyclic system, which the non-cyclic solver never reads
+            LinearAlgebra::solveSymmetricTridiagonalInPlace(diagonal, secondaryDiagonal, inputVector, windowSize);
+        }
+
+        for(size_t i = 0; i < windowSize; i++)
+        {
+            segments[wrap(windowBegin + i)].c = inputVector[i];
+        }
+
+        //looping splines repeat the first point at the end
+        if(looping)
+        {
+            segments.back() = segments.front();
+        }
+    }
+
+    //number of points on each side of an edit whose curvatures are re-solved
+    template<typename floating_t>
+    ptrdiff_t editWindowRadius(void) { return std::numeric_limits<floating_t>::digits; }
+
+    //refresh the cached squared speeds of segments [windowBegin, windowEnd), wrapping around for looping splines and clamping otherwise
+    template<class InterpolationType, typename floating_t, bool uniformKnots>
+    void refreshSquaredSpeedWindow(NaturalSplineCommon<InterpolationType, floating_t, uniformKnots> &common, bool looping, ptrdiff_t windowBegin, ptrdiff_t windowEnd)
+    {
+        ptrdiff_t segmentCount = common.segmentCount();
+        if(!looping)
+        {
+            common.refreshSquaredSpeeds(size_t(std::max(windowBegin, ptrdiff_t(0))), size_t(std::min(windowEnd, segmentCount)));
+        }
+        else if(windowEnd - windowBegin >= segmentCount)
+        {
+            common.refreshSquaredSpeeds(0, segmentCount);
+        }
+        else
+        {
+            for(ptrdiff_t i = windowBegin; i < windowEnd; i++)
+            {
+                size_t wrapped = size_t((i % segmentCount + segmentCount) % segmentCount);
+                common.refreshSquaredSpeeds(wrapped, wrapped + 1);
+            }
+        }
+    }
+
+    //createBatch solves the tridiagonal systems of up to maxBatchWidth splines together. each group is also the unit of work handed to a thread
+    //splines with many points use smaller groups, so that a group's interleaved systems still fit in about batchCacheBytes of cache
+    const size_t maxBatchWidth = 64;
+    const size_t batchCacheBytes = 64 * 1024;
+
+    //for createBatch: build the core of a natural spline from every set of points, exactly as the constructors would.
+    //point sets of the same size are solved batchWidth at a time, with their systems interleaved, and the groups are spread across threadCount threads
+    template<class InterpolationType, typename floating_t, bool uniformKnots>
+    std::vector<NaturalSplineCommon<InterpolationType, floating_t, uniformKnots>> buildBatch(
+            const std::vector<std::vector<InterpolationType>> &pointSets,
+            floating_t alpha,
+            bool looping,
+            size_t threadCount)
+    {
+        typedef NaturalSplineCommon<InterpolationType, floating_t, uniformKnots> Common;
+
+        //sort the point sets by size, so that each group only has systems of the same size
+        std::vector<size_t> order(pointSets.size());
+        for(size_t i = 0; i < order.size(); i++)
+            order[i] = i;
+        std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) { return pointSets[a].size() < pointSets[b].size(); });
+
+        std::vector<std::pair<size_t, size_t>> groups;
+        for(size_t begin = 0; begin < order.size();)
+        {
+            size_t pointCount = pointSets[order[begin]].size();
+            size_t bytesPerSystem = pointCount * (sizeof(InterpolationType) + 3 * sizeof(floating_t));
+            size_t batchWidth = std::max(size_t(1), std::min(maxBatchWidth, batchCacheBytes / bytesPerSystem));
+
+            size_t end = begin + 1;
+            while(end < order.size() && end - begin < batchWidth && pointSets[order[end]].size() == pointCount)
+                end++;
+            groups.emplace_back(begin, end);
+            begin = end;
+        }
+
+        std::vector<Common> results(pointSets.size());
+        SplineCommon::parallelFor(groups.size(), 1, threadCount, [&](size_t groupIndex) {
+            size_t groupBegin = groups[groupIndex].first;
+            size_t systemCount = groups[groupIndex].second - groupBegin;
+            size_t pointCount = pointSets[order[groupBegin]].size();
+            assert(pointCount >= 3);
+
+            //non-looping splines hold their first and last curvatures at 0, so only the interior points are in the system
+            size_t systemSize = looping ? pointCount : pointCount - 2;
+
+            //every temporary for the whole group comes from one allocation for the scalars and one for the right hand sides
+            std::vector<floating_t> scratch(systemSize * systemCount * (looping ? 3 : 2));
+            floating_t *diagonal = scratch.data();
+            floating_t *secondaryDiagonal = diagonal + systemSize * systemCount;
+            floating_t *correction = secondaryDiagonal + systemSize * systemCount;
+            std::vector<InterpolationType> values(systemSize * systemCount);
+
+            //each element of system s is at row * systemCount + s. this is the same system each constructor builds
+            std::vector<std::vector<floating_t>> knots(systemCount);
+            for(size_t s = 0; s < systemCount; s++)
+            {
+                const std::vector<InterpolationType> &points = pointSets[order[groupBegin + s]];
+
+                //each row only needs the delta t and delta point on either side of it, so keep a running copy of the previous ones
+                //looping splines start from the wraparound segment, and the others skip the first point, whose curvature is 0
+                size_t firstRow = looping ? 0 : 1;
+                size_t previous = looping ? pointCount - 1 : 0;
+                knots[s] = looping ? SplineCommon::computeLoopingTValues(points, alpha, 0) : SplineCommon::computeTValuesWithInnerPadding(points, alpha, 0);
+
+                floating_t previousDeltaT = knots[s][previous + 1] - knots[s][previous];
+                InterpolationType previousDeltaPoint = (points[looping ? 0 : 1] - points[previous]) / previousDeltaT;
+                for(size_t row = 0; row < systemSize; row++)
+                {
+                    size_t i = row + firstRow;
+                    size_t next = i + 1 < pointCount ? i + 1 : 0;
+                    floating_t deltaT = knots[s][i + 1] - knots[s][i];
+                    InterpolationType deltaPoint = (points[next] - points[i]) / deltaT;
+
+                    diagonal[row * systemCount + s] = floating_t(2) * (previousDeltaT + deltaT);
+                    secondaryDiagonal[row * systemCount + s] = deltaT;
+                    values[row * systemCount + s] = floating_t(3) * (deltaPoint - previousDeltaPoint);
+
+                    previousDeltaT = deltaT;
+                    previousDeltaPoint = deltaPoint;
+                }
+            }
+
+            if(looping)
+                LinearAlgebra::solveCyclicSymmetricTridiagonalInterleaved(diagonal, secondaryDiagonal, values.data(), correction, systemSize, systemCount);
+            else
+                LinearAlgebra::solveSymmetricTridiagonalInterleaved(diagonal, secondaryDiagonal, values.data(), systemSize, systemCount);
+
+            for(size_t s = 0; s < systemCount; s++)
+            {
+                const std::vector<InterpolationType> &points = pointSets[order[groupBegin + s]];
+
+                //looping splines repeat the first point at the end, and non-looping splines have 0 curvature at both ends
+                std::vector<typename Common::NaturalSplineSegment> segments(looping ? pointCount + 1 : pointCount);
+                for(size_t i = 0; i < segments.size(); i++)
+                {
+                    segments[i].a = points[i % pointCount];
+                    if(looping)
+                        segments[i].c = values[(i % pointCount) * systemCount + s];
+                    else if(i > 0 && i < pointCount - 1)
+                        segments[i].c = values[(i - 1) * systemCount + s];
+                    else
+                        segments[i].c = InterpolationType();
+                }
+
+                if(!looping)
+                    SplineCommon::removeKnotPadding(knots[s], 0, pointCount);
+                results[order[groupBegin + s]] = Common(std::move(segments), std::move(knots[s]));
+            }
+        });
+
+        return results;
+    }
+
+    //SplineImpl expects a spline core with exactly two template parameters, so bind the knot type ahead of time
+    template<bool uniformKnots>
+    struct KnotType
+    {
+        template<class InterpolationType, typename floating_t>
+        using Common = NaturalSplineCommon<InterpolationType, floating_t, uniformKnots>;
+    };
+}
+
+//if uniformKnots is true, alpha must be 0. see NaturalSplineCommon for details
+template<class InterpolationType, typename floating_t=float, bool uniformKnots=false>
+class NaturalSpline final : public SplineImpl<__NaturalSplinePrivate::KnotType<uniformKnots>::template Common, InterpolationType, floating_t>
 {
 public:
     enum EndConditions { Natural, NotAKnot };
@@ -184,192 +512,357 @@ public:
                   bool includeEndpoints = true,
                   floating_t alpha = 0.0,
                   EndConditions endConditions = Natural)
-        :SplineImpl<NaturalSplineCommon, InterpolationType,floating_t>(points, includeEndpoints ? points.size()- 1 : points.size() - 3)
+        :SplineImpl<__NaturalSplinePrivate::KnotType<uniformKnots>::template Common, InterpolationType,floating_t>(points, includeEndpoints ? points.size()- 1 : points.size() - 3),
+          editable(includeEndpoints && endConditions == Natural), includesEndpoints(includeEndpoints), knotEditor(alpha, false)
     {
-        size_t size = points.size();
-        size_t firstPoint;
-        size_t numSegments;
+        SplineCommon::BuildScratch<InterpolationType, floating_t> buildScratch;
+        build(points, includeEndpoints, alpha, endConditions, buildScratch);
+    }
 
-        if(includeEndpoints)
-        {
-            assert(points.size() >= 3);
-            numSegments = size - 1;
-            firstPoint = 0;
-        }
-        else
+    //build one spline from each set of points, with the same result as calling the constructor on each with includeEndpoints = true and natural end conditions
+    //building many splines this way is faster, because splines with the same number of points solve their tridiagonal systems together, interleaved
+    //so that each step of the solve runs across splines instead of waiting on the previous step of a single one
+    //groups of splines are spread across threadCount threads. if threadCount is 0, use one thread per hardware thread
+    static std::vector<NaturalSpline> createBatch(const std::vector<std::vector<InterpolationType>> &pointSets, floating_t alpha = 0.0, size_t threadCount = 1)
+    {
+        auto cores = __NaturalSplinePrivate::buildBatch<InterpolationType, floating_t, uniformKnots>(pointSets, alpha, false, threadCount);
+
+        std::vector<NaturalSpline> result;
+        result.reserve(pointSets.size());
+        for(size_t i = 0; i < pointSets.size(); i++)
         {
-            assert(points.size() >= 4);
-            numSegments = size - 3;
-            firstPoint = 1;
+            result.push_back(NaturalSpline(pointSets[i], alpha, std::move(cores[i])));
         }
+        return result;
+    }
 
-        //compute the T values for each point
-        std::vector<floating_t> paddedKnots = SplineCommon::computeTValuesWithInnerPadding(points, alpha, firstPoint);
-
-        //next we compute curvatures
-        std::vector<InterpolationType> curvatures;
-        if(endConditions == Natural)
-            curvatures = computeCurvaturesNatural(paddedKnots);
-        else
-            curvatures = computeCurvaturesNotAKnot(paddedKnots);
+private:
+    //for createBatch, which has already built the core
+    NaturalSpline(const std::vector<InterpolationType> &points, floating_t alpha, NaturalSplineCommon<InterpolationType, floating_t, uniformKnots> &&prebuiltCommon)
+        :SplineImpl<__NaturalSplinePrivate::KnotType<uniformKnots>::template Common, InterpolationType,floating_t>(points, points.size() - 1),
+          editable(true), includesEndpoints(true), knotEditor(alpha, false)
+    {
+        assert(!uniformKnots || alpha == 0);
+        common = std::move(prebuiltCommon);
+    }
 
-        //we now have 0 curvature for index 0 and n - 1, and the final (usually nonzero) curvature for every other point
-        //use this curvature to determine a,b,c,and d to build each segment
-        std::vector<floating_t> knots(numSegments + 1);
-        std::vector<typename NaturalSplineCommon<InterpolationType, floating_t>::NaturalSplineSegment> segments(numSegments + 1);
-        for(size_t i = firstPoint; i < numSegments + firstPoint + 1; i++) {
+//rebuilding
+public:
+    //replace this spline with the one the constructor would build from the given arguments, reusing this spline's memory
+    //as long as there are no more points than the last time, nothing is allocated
+    inline void rebuild(const std::vector<InterpolationType> &points,
+                        bool includeEndpoints = true,
+                        floating_t alpha = 0.0,
+                        EndConditions endConditions = Natural)
+    {
+        this->replaceOriginalPoints(points, floating_t(includeEndpoints ? points.size() - 1 : points.size() - 3));
+        editable = includeEndpoints && endConditions == Natural;
+        includesEndpoints = includeEndpoints;
+        knotEditor.reset(alpha);
+        build(points, includeEndpoints, alpha, endConditions, retainedScratch.get());
+    }
 
-            knots[i - firstPoint] = paddedKnots[i];
-            segments[i - firstPoint].a = points.at(i);
-            segments[i - firstPoint].c = curvatures.at(i);
-        }
+//editing
+public:
+    //move, insert, or remove a single point, and update the spline to match without rebuilding it
+    //the result is the same as constructing a new spline from the edited points, but only the curvatures near the edit are re-solved
+    //only supported for splines that include their endpoints and use natural end conditions
+    void setPoint(size_t index, const InterpolationType &point);
+    void insertPoint(size_t index, const InterpolationType &point);
+    void removePoint(size_t index);
+
+    inline void appendPoint(const InterpolationType &point)
+    {
+        this->restoreOriginalPoints();
+        insertPoint(this->getOriginalPoints().size(), point);
+    }
+    inline bool isEditable(void) const { return editable; }
 
-        common = NaturalSplineCommon<InterpolationType, floating_t>(std::move(segments), std::move(knots));
+    size_t memoryFootprint(void) const override
+    {
+        return sizeof(*this) + this->originalPointsFootprint() + this->common.heapFootprint() + knotEditor.heapFootprint() + retainedScratch.heapFootprint();
     }
+
 private:
-    std::vector<InterpolationType> computeCurvaturesNatural(const std::vector<floating_t> tValues) const;
-    std::vector<InterpolationType> computeCurvaturesNotAKnot(const std::vector<floating_t> tValues) const;
+    //fill the core from scratch, for the constructor and rebuild
+    void build(const std::vector<InterpolationType> &points, bool includeEndpoints, floating_t alpha, EndConditions endConditions,
+               SplineCommon::BuildScratch<InterpolationType, floating_t> &buildScratch);
+
+    //compute the curvature at every one of the original points into buildScratch.values, using the rest of buildScratch for the tridiagonal system
+    void computeCurvaturesNatural(const std::vector<floating_t> &tValues, SplineCommon::BuildScratch<InterpolationType, floating_t> &buildScratch) const;
+    void computeCurvaturesNotAKnot(const std::vector<floating_t> &tValues, SplineCommon::BuildScratch<InterpolationType, floating_t> &buildScratch) const;
+
+    void finishEdit(size_t index, typename SplineKnotEditor<InterpolationType, floating_t>::EditType type);
+
+    bool reconstructOriginalPoints(std::vector<InterpolationType> &output) const override
+    {
+        //the core keeps every point unchanged, unless the first and last points were left out of the spline
+        if(!includesEndpoints)
+            return false;
+
+        SplineCommon::copyStoredPoints(this->common, 0, this->common.storedPointCount(), output);
+        return true;
+    }
+
+    bool editable;
+    bool includesEndpoints;
+    SplineKnotEditor<InterpolationType, floating_t> knotEditor;
+    SplineCommon::RetainedBuildScratch<InterpolationType, floating_t> retainedScratch;
 };
 
-template<class InterpolationType, typename floating_t=float>
-class LoopingNaturalSpline final : public SplineLoopingImpl<NaturalSplineCommon, InterpolationType, floating_t>
+//if uniformKnots is true, alpha must be 0. see NaturalSplineCommon for details
+template<class InterpolationType, typename floating_t=float, bool uniformKnots=false>
+class LoopingNaturalSpline final : public SplineLoopingImpl<__NaturalSplinePrivate::KnotType<uniformKnots>::template Common, InterpolationType, floating_t>
 {
 //constructors
 public:
     LoopingNaturalSpline(const std::vector<InterpolationType> &points, floating_t alpha = 0.0)
-        :SplineLoopingImpl<NaturalSplineCommon, InterpolationType,floating_t>(points, points.size())
+        :SplineLoopingImpl<__NaturalSplinePrivate::KnotType<uniformKnots>::template Common, InterpolationType,floating_t>(points, points.size()), knotEditor(alpha, true)
     {
-        size_t size = points.size();
-
-        //compute the T values for each point
-        std::vector<floating_t> knots = SplineCommon::computeLoopingTValues(points, alpha, 0);
-
-        //now that we know the t values, we need to prepare the tridiagonal matrix calculation
-        //note that there several ways to formulate this matrix - i chose the following:
-        // http://www-hagen.informatik.uni-kl.de/~alggeom/pdf/ws1213/alggeom_script_ws12_02.pdf
+        SplineCommon::BuildScratch<InterpolationType, floating_t> buildScratch;
+        build(points, alpha, buildScratch);
+    }
 
-        //the tridiagonal matrix's main diagonal will be neighborDeltaT, and the secondary diagonals will be deltaT
-        //the list of values to solve for will be neighborDeltaPoint
+    //see NaturalSpline::createBatch
+    static std::vector<LoopingNaturalSpline> createBatch(const std::vector<std::vector<InterpolationType>> &pointSets, floating_t alpha = 0.0, size_t threadCount = 1)
+    {
+        auto cores = __NaturalSplinePrivate::buildBatch<InterpolationType, floating_t, uniformKnots>(pointSets, alpha, true, threadCount);
 
-        //create an array of the differences in T between one point and the next
-        std::vector<floating_t> upperDiagonal(size);
-        for(size_t i = 0; i < size; i++)
+        std::vector<LoopingNaturalSpline> result;
+        result.reserve(pointSets.size());
+        for(size_t i = 0; i < pointSets.size(); i++)
         {
-            floating_t delta = knots[i + 1] - knots[i];
-            upperDiagonal[i] = delta;
+            result.push_back(LoopingNaturalSpline(pointSets[i], alpha, std::move(cores[i])));
         }
+        return result;
+    }
 
-        //create an array that stores 2 * (deltaT.at(i - 1) + deltaT.at(i))
-        //when i = 0, wrap i - 1 back around to the end of the list
-        std::vector<floating_t> diagonal(size);
-        for(size_t i = 0; i < size; i++)
-        {
-            floating_t neighborDelta = 2 * (upperDiagonal.at((i - 1 + size)%size) + upperDiagonal.at(i));
-            diagonal[i] = neighborDelta;
-        }
+private:
+    //for createBatch, which has already built the core
+    LoopingNaturalSpline(const std::vector<InterpolationType> &points, floating_t alpha, NaturalSplineCommon<InterpolationType, floating_t, uniformKnots> &&prebuiltCommon)
+        :SplineLoopingImpl<__NaturalSplinePrivate::KnotType<uniformKnots>::template Common, InterpolationType,floating_t>(points, points.size()), knotEditor(alpha, true)
+    {
+        assert(!uniformKnots || alpha == 0);
+        common = std::move(prebuiltCommon);
+    }
 
-        //create an array of displacement between each point, divided by delta t
-        std::vector<InterpolationType> deltaPoint(size);
-        for(size_t i = 0; i < size; i++)
-        {
-            InterpolationType displacement = points.at((i + 1)%size) - points.at(i);
-            deltaPoint[i] = displacement / upperDiagonal.at(i);
-        }
+//rebuilding
+public:
+    //replace this spline with the one the constructor would build from the given arguments, reusing this spline's memory
+    //as long as there are no more points than the last time, nothing is allocated
+    inline void rebuild(const std::vector<InterpolationType> &points, floating_t alpha = 0.0)
+    {
+        this->replaceOriginalPoints(points, floating_t(points.size()));
+        knotEditor.reset(alpha);
+        build(points, alpha, retainedScratch.get());
+    }
 
-        //create an array that stores 3 * (deltaPoint(i - 1) + deltaPoint(i))
-        //when i = 0, wrap i - 1 back around to the end of the list
-        std::vector<InterpolationType> inputVector(size);
-        for(size_t i = 0; i < size; i++)
-        {
-            InterpolationType neighborDelta = floating_t(3) * (deltaPoint.at(i) - deltaPoint.at((i - 1 + size) % size));
-            inputVector[i] = neighborDelta;
-        }
+//editing
+public:
+    //move, insert, or remove a single point, and update the spline to match without rebuilding it
+    //the result is the same as constructing a new spline from the edited points, but only the curvatures near the edit are re-solved
+    void setPoint(size_t index, const InterpolationType &point);
+    void insertPoint(size_t index, const InterpolationType &point);
+    void removePoint(size_t index);
 
-        //solve the cyclic tridiagonal system to get the curvature at each point
-        std::vector<InterpolationType> curvatures = LinearAlgebra::solveCyclicSymmetricTridiagonal(
-                    std::move(diagonal),
-                    std::move(upperDiagonal),
-                    std::move(inputVector)
-                    );
+    inline void appendPoint(const InterpolationType &point)
+    {
+        this->restoreOriginalPoints();
+        insertPoint(this->getOriginalPoints().size(), point);
+    }
 
-        //we now have the curvature for every point
-        //use this curvature to determine a,b,c,and d to build each segment
-        std::vector<typename NaturalSplineCommon<InterpolationType, floating_t>::NaturalSplineSegment> segments(size + 1);
-        for(int i = 0; i < size + 1; i++)
-        {
-            segments[i].a = points.at(i%size);
-            segments[i].c = curvatures.at(i%size);
-        }
+    size_t memoryFootprint(void) const override
+    {
+        return sizeof(*this) + this->originalPointsFootprint() + this->common.heapFootprint() + knotEditor.heapFootprint() + retainedScratch.heapFootprint();
+    }
 
-        common = NaturalSplineCommon<InterpolationType, floating_t>(std::move(segments), std::move(knots));
+private:
+    void finishEdit(size_t index, typename SplineKnotEditor<InterpolationType, floating_t>::EditType type);
+
+    bool reconstructOriginalPoints(std::vector<InterpolationType> &output) const override
+    {
+        //the core keeps every point, then the first point again
+        SplineCommon::copyStoredPoints(this->common, 0, this->common.storedPointCount() - 1, output);
+        return true;
     }
+
+    //fill the core from scratch, for the constructor and rebuild
+    void build(const std::vector<InterpolationType> &points, floating_t alpha, SplineCommon::BuildScratch<InterpolationType, floating_t> &buildScratch);
+
+    SplineKnotEditor<InterpolationType, floating_t> knotEditor;
+    SplineCommon::RetainedBuildScratch<InterpolationType, floating_t> retainedScratch;
 };
 
-template<class InterpolationType, typename floating_t>
-std::vector<InterpolationType> NaturalSpline<InterpolationType,floating_t>::computeCurvaturesNatural(const std::vector<floating_t> tValues) const
+template<class InterpolationType, typename floating_t, bool uniformKnots>
+void NaturalSpline<InterpolationType,floating_t,uniformKnots>::build(
+        const std::vector<InterpolationType> &points, bool includeEndpoints, floating_t alpha, EndConditions endConditions,
+        SplineCommon::BuildScratch<InterpolationType, floating_t> &buildScratch)
 {
+    assert(!uniformKnots || alpha == 0);
+    size_t size = points.size();
+    size_t firstPoint;
+    size_t numSegments;
+
+    if(includeEndpoints)
+    {
+        assert(points.size() >= 3);
+        numSegments = size - 1;
+        firstPoint = 0;
+    }
+    else
+    {
+        assert(points.size() >= 4);
+        numSegments = size - 3;
+        firstPoint = 1;
+    }
+
+    //compute the T values for each point
+    std::vector<floating_t> &paddedKnots = this->common.editKnots().buildStorage(buildScratch.knots);
+    SplineCommon::computeTValuesWithInnerPadding(points, alpha, firstPoint, paddedKnots);
+
+    //next we compute curvatures
+    if(endConditions == Natural)
+        computeCurvaturesNatural(paddedKnots, buildScratch);
+    else
+        computeCurvaturesNotAKnot(paddedKnots, buildScratch);
+    const std::vector<InterpolationType> &curvatures = buildScratch.values;
+
+    //we now have 0 curvature for index 0 and n - 1, and the final (usually nonzero) curvature for every other point
+    //use this curvature to determine a,b,c,and d to build each segment
+    auto &segments = this->common.editSegments();
+    segments.resize(numSegments + 1);
+    for(size_t i = firstPoint; i < numSegments + firstPoint + 1; i++) {
+
+        segments[i - firstPoint].a = points.at(i);
+        segments[i - firstPoint].c = curvatures.at(i);
+    }
+
+    //the knots are the padded knots without their padding, so reuse the padded vector's memory
+    SplineCommon::removeKnotPadding(paddedKnots, firstPoint, numSegments + 1);
+
+    this->common.finishBuild(paddedKnots);
+}
+
+template<class InterpolationType, typename floating_t, bool uniformKnots>
+void LoopingNaturalSpline<InterpolationType,floating_t,uniformKnots>::build(
+        const std::vector<InterpolationType> &points, floating_t alpha, SplineCommon::BuildScratch<InterpolationType, floating_t> &buildScratch)
+{
+    assert(!uniformKnots || alpha == 0);
+    size_t size = points.size();
+
+    //compute the T values for each point
+    std::vector<floating_t> &knots = this->common.editKnots().buildStorage(buildScratch.knots);
+    SplineCommon::computeLoopingTValues(points, alpha, 0, knots);
 
     //now that we know the t values, we need to prepare the tridiagonal matrix calculation
-    //note that there several ways to formulate this matrix - for the "natural boundary conditions" i chose the following:
+    //note that there several ways to formulate this matrix - i chose the following:
     // http://www-hagen.informatik.uni-kl.de/~alggeom/pdf/ws1213/alggeom_script_ws12_02.pdf
 
     //the tridiagonal matrix's main diagonal will be neighborDeltaT, and the secondary diagonals will be deltaT
     //the list of values to solve for will be neighborDeltaPoint
 
-    size_t loop_limit = this->getOriginalPoints().size() - 1;
-
     //create an array of the differences in T between one point and the next
-    std::vector<floating_t> upperDiagonal(loop_limit);
-    for(size_t i = 0; i < loop_limit; i++)
+    std::vector<floating_t> &upperDiagonal = buildScratch.upperDiagonal;
+    upperDiagonal.resize(size);
+    for(size_t i = 0; i < size; i++)
     {
-        floating_t delta = tValues[i + 1] - tValues[i];
+        floating_t delta = knots[i + 1] - knots[i];
         upperDiagonal[i] = delta;
     }
 
     //create an array that stores 2 * (deltaT.at(i - 1) + deltaT.at(i))
-    std::vector<floating_t> diagonal(loop_limit - 1);
-    for(size_t i = 1; i < loop_limit; i++)
+    //when i = 0, wrap i - 1 back around to the end of the list
+    std::vector<floating_t> &diagonal = buildScratch.diagonal;
+    diagonal.resize(size);
+    for(size_t i = 0; i < size; i++)
     {
-        floating_t neighborDelta = floating_t(2) * (upperDiagonal[i - 1] + upperDiagonal[i]);
-        diagonal[i - 1] = neighborDelta;
+        floating_t neighborDelta = 2 * (upperDiagonal[(i - 1 + size)%size] + upperDiagonal[i]);
+        diagonal[i] = neighborDelta;
     }
 
-    //create an array of displacement between each point, divided by delta t
-    std::vector<InterpolationType> deltaPoint(loop_limit);
-    for(size_t i = 0; i < loop_limit; i++)
+    //the right hand side stores 3 * (deltaPoint(i) - deltaPoint(i - 1)), where deltaPoint is the displacement between each point divided by delta t
+    //when i = 0, wrap i - 1 back around to the end of the list. each row only needs two delta points, so keep a running copy instead of an array of them
+    std::vector<InterpolationType> &curvatures = buildScratch.values;
+    curvatures.resize(size);
+    InterpolationType previousDeltaPoint = (points[0] - points[size - 1]) / upperDiagonal[size - 1];
+    for(size_t i = 0; i < size; i++)
     {
-        InterpolationType displacement = this->getOriginalPoints()[i + 1] - this->getOriginalPoints()[i];
-        deltaPoint[i] = displacement / upperDiagonal[i];
+        InterpolationType displacement = points[(i + 1)%size] - points[i];
+        InterpolationType deltaPoint = displacement / upperDiagonal[i];
+
+        curvatures[i] = floating_t(3) * (deltaPoint - previousDeltaPoint);
+        previousDeltaPoint = deltaPoint;
     }
 
-    //create an array that stores 3 * (deltaPoint(i - 1) + deltaPoint(i))
-    std::vector<InterpolationType> inputVector(loop_limit - 1);
-    for(size_t i = 1; i < loop_limit; i++)
+    //solve the cyclic tridiagonal system to get the curvature at each point
+    buildScratch.correction.resize(size);
+    LinearAlgebra::solveCyclicSymmetricTridiagonalInPlace(diagonal.data(), upperDiagonal.data(), curvatures.data(), buildScratch.correction.data(), size);
+
+    //we now have the curvature for every point
+    //use this curvature to determine a,b,c,and d to build each segment
+    auto &segments = this->common.editSegments();
+    segments.resize(size + 1);
+    for(size_t i = 0; i < size + 1; i++)
     {
-        InterpolationType neighborDelta = floating_t(3) * (deltaPoint[i] - deltaPoint[i - 1]);
-        inputVector[i - 1] = neighborDelta;
+        segments[i].a = points[i%size];
+        segments[i].c = curvatures[i%size];
     }
 
-    //the first element in upperDiagonal is garbage, so remove it
-    upperDiagonal.erase(upperDiagonal.begin());
+    this->common.finishBuild(knots);
+}
+
+template<class InterpolationType, typename floating_t, bool uniformKnots>
+void NaturalSpline<InterpolationType,floating_t,uniformKnots>::computeCurvaturesNatural(
+        const std::vector<floating_t> &tValues, SplineCommon::BuildScratch<InterpolationType, floating_t> &buildScratch) const
+{
+
+    //now that we know the t values, we need to prepare the tridiagonal matrix calculation
+    //note that there several ways to formulate this matrix - for the "natural boundary conditions" i chose the following:
+    // http://www-hagen.informatik.uni-kl.de/~alggeom/pdf/ws1213/alggeom_script_ws12_02.pdf
+
+    //the tridiagonal matrix's main diagonal will be neighborDeltaT, and the secondary diagonals will be deltaT
+    //the list of values to solve for will be neighborDeltaPoint
+
+    const std::vector<InterpolationType> &points = this->getOriginalPoints();
+    size_t loop_limit = points.size() - 1;
+
+    //the first and last curvatures are 0, so the system only covers the points in between, and is solved in place between them
+    //each row only needs the delta t and delta point on either side of it, so keep a running copy of the previous ones instead of an array of each
+    std::vector<floating_t> &diagonal = buildScratch.diagonal;
+    std::vector<floating_t> &secondaryDiagonal = buildScratch.upperDiagonal;
+    std::vector<InterpolationType> &curvatures = buildScratch.values;
+    diagonal.resize(loop_limit - 1);
+    secondaryDiagonal.resize(loop_limit - 1);
+    curvatures.resize(loop_limit + 1);
+
+    floating_t previousDeltaT = tValues[1] - tValues[0];
+    InterpolationType previousDeltaPoint = (points[1] - points[0]) / previousDeltaT;
+    for(size_t i = 1; i < loop_limit; i++)
+    {
+        floating_t deltaT = tValues[i + 1] - tValues[i];
+        InterpolationType deltaPoint = (points[i + 1] - points[i]) / deltaT;
+
+        //2 * (deltaT(i - 1) + deltaT(i)) on the main diagonal, and 3 * (deltaPoint(i) - deltaPoint(i - 1)) on the right hand side
+        diagonal[i - 1] = floating_t(2) * (previousDeltaT + deltaT);
+        secondaryDiagonal[i - 1] = deltaT;
+        curvatures[i] = floating_t(3) * (deltaPoint - previousDeltaPoint);
+
+        previousDeltaT = deltaT;
+        previousDeltaPoint = deltaPoint;
+    }
 
     //solve the tridiagonal system to get the curvature at each point
-    std::vector<InterpolationType> curvatures = LinearAlgebra::solveSymmetricTridiagonal(
-                std::move(diagonal),
-                std::move(upperDiagonal),
-                std::move(inputVector)
-                );
+    LinearAlgebra::solveSymmetricTridiagonalInPlace(diagonal.data(), secondaryDiagonal.data(), curvatures.data() + 1, loop_limit - 1);
 
     //we didn't compute the first or last curvature, which will be 0
-    curvatures.insert(curvatures.begin(), InterpolationType());
-    curvatures.push_back(InterpolationType());
-
-    return curvatures;
+    curvatures.front() = InterpolationType();
+    curvatures.back() = InterpolationType();
 }
 
 
-template<class InterpolationType, typename floating_t>
-std::vector<InterpolationType> NaturalSpline<InterpolationType,floating_t>::computeCurvaturesNotAKnot(const std::vector<floating_t> tValues) const
+template<class InterpolationType, typename floating_t, bool uniformKnots>
+void NaturalSpline<InterpolationType,floating_t,uniformKnots>::computeCurvaturesNotAKnot(
+        const std::vector<floating_t> &tValues, SplineCommon::BuildScratch<InterpolationType, floating_t> &buildScratch) const
 {
     //now that we know the t values, we need to prepare the tridiagonal matrix calculation
     //note that there several ways to formulate this matrix; for "not a knot" i chose the following:
@@ -378,47 +871,48 @@ std::vector<InterpolationType> NaturalSpline<InterpolationType,floating_t>::comp
     //the tridiagonal matrix's main diagonal will be neighborDeltaT, and the secondary diagonals will be deltaT
     //the list of values to solve for will be neighborDeltaPoint
 
-    size_t size = this->getOriginalPoints().size() - 1;
+    const std::vector<InterpolationType> &points = this->getOriginalPoints();
+    size_t size = points.size() - 1;
 
     //create an array of the differences in T between one point and the next
-    std::vector<floating_t> deltaT(size);
+    std::vector<floating_t> &deltaT = buildScratch.correction;
+    deltaT.resize(size);
     for(size_t i = 0; i < size; i++)
     {
         deltaT[i] = tValues[i + 1] - tValues[i];
     }
 
     //the main diagonal of the tridiagonal will be 2 * (deltaT[i] + deltaT[i + 1])
-    float mainDiagonalSize = size - 1;
-    std::vector<floating_t> mainDiagonal(mainDiagonalSize);
+    size_t mainDiagonalSize = size - 1;
+    std::vector<floating_t> &mainDiagonal = buildScratch.diagonal;
+    mainDiagonal.resize(mainDiagonalSize);
     for(size_t i = 0; i < mainDiagonalSize; i++)
     {
         mainDiagonal[i] = 2 * (deltaT[i] + deltaT[i + 1]);
     }
 
-    //the upper diagonal will just be deltaT[i + 1]
-    float secondaryDiagonalSize = size - 2;
-    std::vector<floating_t> upperDiagonal(secondaryDiagonalSize);
+    //the upper diagonal will just be deltaT[i + 1], and the lower diagonal is a copy of it
+    size_t secondaryDiagonalSize = size - 2;
+    std::vector<floating_t> &upperDiagonal = buildScratch.upperDiagonal;
+    std::vector<floating_t> &lowerDiagonal = buildScratch.lowerDiagonal;
+    upperDiagonal.resize(secondaryDiagonalSize);
+    lowerDiagonal.resize(secondaryDiagonalSize);
     for(size_t i = 0; i < secondaryDiagonalSize; i++)
     {
         upperDiagonal[i] = deltaT[i + 1];
+        lowerDiagonal[i] = deltaT[i + 1];
     }
 
-    //the lower diagonal is just a copy of the upper diagonal
-    std::vector<floating_t> lowerDiagonal = upperDiagonal;
-
-    //create an array of displacement between each point, divided by delta t
-    std::vector<InterpolationType> deltaPoint(size);
-    for(size_t i = 0; i < size; i++)
-    {
-        InterpolationType displacement = this->getOriginalPoints()[i + 1] - this->getOriginalPoints()[i];
-        deltaPoint[i] = displacement / deltaT[i];
-    }
-
-    //create an array that stores 3 * (deltaPoint(i - 1) + deltaPoint(i))
-    std::vector<InterpolationType> inputVector(mainDiagonalSize);
+    //the right hand side stores 3 * (deltaPoint(i + 1) - deltaPoint(i)), where deltaPoint is the displacement between each point divided by delta t
+    //it's solved in place between the first and last curvatures, which are computed from the others afterwards
+    std::vector<InterpolationType> &curvatures = buildScratch.values;
+    curvatures.resize(size + 1);
+    InterpolationType previousDeltaPoint = (points[1] - points[0]) / deltaT[0];
     for(size_t i = 0; i < mainDiagonalSize; i++)
     {
-        inputVector[i] = floating_t(3) * (deltaPoint[i + 1] - deltaPoint[i]);
+        InterpolationType deltaPoint = (points[i + 2] - points[i + 1]) / deltaT[i + 1];
+        curvatures[i + 1] = floating_t(3) * (deltaPoint - previousDeltaPoint);
+        previousDeltaPoint = deltaPoint;
     }
 
     //the first and last of the values in maindiagonalare different than normal
@@ -432,17 +926,192 @@ std::vector<InterpolationType> NaturalSpline<InterpolationType,floating_t>::comp
     lowerDiagonal[secondaryDiagonalSize - 1] = deltaT[size - 2] - deltaT[size - 1]*deltaT[size - 1]/deltaT[size - 2];
 
     //solve the tridiagonal system to get the curvature at each point
-    std::vector<InterpolationType> curvatures = LinearAlgebra::solveTridiagonal(
-                std::move(mainDiagonal),
-                std::move(upperDiagonal),
-                std::move(lowerDiagonal),
-                std::move(inputVector)
-                );
+    LinearAlgebra::solveTridiagonalInPlace(mainDiagonal.data(), upperDiagonal.data(), lowerDiagonal.data(), curvatures.data() + 1, mainDiagonalSize);
 
     //we didn't compute the first or last curvature, which will be calculated based on the others
-    curvatures.insert(curvatures.begin(), curvatures[0] * (1 + deltaT[0]/deltaT[1]) - curvatures[1] * (deltaT[0]/deltaT[1]));
-    curvatures.push_back(curvatures.back() * (1 + deltaT[size - 1]/deltaT[size - 2])
-            - curvatures[curvatures.size() - 2] * (deltaT[size - 1]/deltaT[size - 2]));
+    curvatures[0] = curvatures[1] * (1 + deltaT[0]/deltaT[1]) - curvatures[2] * (deltaT[0]/deltaT[1]);
+    curvatures[size] = curvatures[size - 1] * (1 + deltaT[size - 1]/deltaT[size - 2])
+            - curvatures[size - 2] * (deltaT[size - 1]/deltaT[size - 2]);
+}
+
+
+
+template<class InterpolationType, typename floating_t, bool uniformKnots>
+void NaturalSpline<InterpolationType,floating_t,uniformKnots>::setPoint(size_t index, const InterpolationType &point)
+{
+    assert(editable);
+    this->restoreOriginalPoints();
+    assert(index < this->getOriginalPoints().size());
+
+    knotEditor.initialize(this->getOriginalPoints());
+
+    this->editOriginalPoints()[index] = point;
+    this->common.editSegments()[index].a = point;
+
+    finishEdit(index, SplineKnotEditor<InterpolationType, floating_t>::Set);
+}
+
+template<class InterpolationType, typename floating_t, bool uniformKnots>
+void NaturalSpline<InterpolationType,floating_t,uniformKnots>::insertPoint(size_t index, const InterpolationType &point)
+{
+    assert(editable);
+    this->restoreOriginalPoints();
+    assert(index <= this->getOriginalPoints().size());
+
+    knotEditor.initialize(this->getOriginalPoints());
+
+    typename NaturalSplineCommon<InterpolationType, floating_t, uniformKnots>::NaturalSplineSegment segment;
+    segment.a = point;
+    segment.c = InterpolationType();
+
+    auto &points = this->editOriginalPoints();
+    auto &segments = this->common.editSegments();
+    auto &squaredSpeeds = this->common.editSquaredSpeeds();
+    points.insert(points.begin() + index, point);
+    segments.insert(segments.begin() + index, segment);
+    squaredSpeeds.insert(squaredSpeeds.begin() + std::min(index, squaredSpeeds.size()), std::array<floating_t, 5>());
+
+    finishEdit(index, SplineKnotEditor<InterpolationType, floating_t>::Insert);
+}
+
+template<class InterpolationType, typename floating_t, bool uniformKnots>
+void NaturalSpline<InterpolationType,floating_t,uniformKnots>::removePoint(size_t index)
+{
+    assert(editable);
+    this->restoreOriginalPoints();
+    assert(index < this->getOriginalPoints().size());
+    assert(this->getOriginalPoints().size() > 3);
+
+    knotEditor.initialize(this->getOriginalPoints());
+
+    auto &points = this->editOriginalPoints();
+    auto &segments = this->common.editSegments();
+    auto &squaredSpeeds = this->common.editSquaredSpeeds();
+    points.erase(points.begin() + index);
+    segments.erase(segments.begin() + index);
+    squaredSpeeds.erase(squaredSpeeds.begin() + std::min(index, squaredSpeeds.size() - 1));
+
+    finishEdit(index, SplineKnotEditor<InterpolationType, floating_t>::Remove);
+}
+
+template<class InterpolationType, typename floating_t, bool uniformKnots>
+void NaturalSpline<InterpolationType,floating_t,uniformKnots>::finishEdit(size_t index, typename SplineKnotEditor<InterpolationType, floating_t>::EditType type)
+{
+    auto &segments = this->common.editSegments();
+    auto &knots = this->common.editKnots();
+
+    //if the rest of the knots were scaled, scale the rest of the curvatures to match
+    floating_t knotScale = knotEditor.update(this->getOriginalPoints(), knots, index, type);
+    if(knotScale != 1)
+    {
+        floating_t curvatureScale = 1 / (knotScale * knotScale);
+        for(auto &segment : segments)
+        {
+            segment.c = curvatureScale * segment.c;
+        }
+    }
+
+    //the rows of the curvature system that changed are the ones for the edited point and its neighbors
+    ptrdiff_t radius = __NaturalSplinePrivate::editWindowRadius<floating_t>();
+    ptrdiff_t windowBegin = ptrdiff_t(index) - 1 - radius;
+    ptrdiff_t windowEnd = ptrdiff_t(index) + 2 + radius;
+    __NaturalSplinePrivate::solveCurvatureWindow<InterpolationType, floating_t>(segments, knots, false, windowBegin, windowEnd, knotEditor.windowScratch());
+
+    this->maxT = floating_t(this->getOriginalPoints().size() - 1);
+
+    //a segment's squared speed depends on the points and curvatures at both of its ends, so refresh the segments that touch the window
+    if(knotScale != 1)
+        this->common.refreshSquaredSpeeds(0, this->common.segmentCount());
+    else
+        __NaturalSplinePrivate::refreshSquaredSpeedWindow(this->common, false, windowBegin - 1, windowEnd);
+}
+
+
+template<class InterpolationType, typename floating_t, bool uniformKnots>
+void LoopingNaturalSpline<InterpolationType,floating_t,uniformKnots>::setPoint(size_t index, const InterpolationType &point)
+{
+    this->restoreOriginalPoints();
+    assert(index < this->getOriginalPoints().size());
+
+    knotEditor.initialize(this->getOriginalPoints());
+
+    this->editOriginalPoints()[index] = point;
+    this->common.editSegments()[index].a = point;
+
+    finishEdit(index, SplineKnotEditor<InterpolationType, floating_t>::Set);
+}
+
+template<class InterpolationType, typename floating_t, bool uniformKnots>
+void LoopingNaturalSpline<InterpolationType,floating_t,uniformKnots>::insertPoint(size_t index, const InterpolationType &point)
+{
+    this->restoreOriginalPoints();
+    assert(index <= this->getOriginalPoints().size());
+
+    knotEditor.initialize(this->getOriginalPoints());
+
+    typename NaturalSplineCommon<InterpolationType, floating_t, uniformKnots>::NaturalSplineSegment segment;
+    segment.a = point;
+    segment.c = InterpolationType();
+
+    auto &points = this->editOriginalPoints();
+    auto &segments = this->common.editSegments();
+    auto &squaredSpeeds = this->common.editSquaredSpeeds();
+    points.insert(points.begin() + index, point);
+    segments.insert(segments.begin() + index, segment);
+    squaredSpeeds.insert(squaredSpeeds.begin() + std::min(index, squaredSpeeds.size()), std::array<floating_t, 5>());
+
+    finishEdit(index, SplineKnotEditor<InterpolationType, floating_t>::Insert);
+}
+
+template<class InterpolationType, typename floating_t, bool uniformKnots>
+void LoopingNaturalSpline<InterpolationType,floating_t,uniformKnots>::removePoint(size_t index)
+{
+    this->restoreOriginalPoints();
+    assert(index < this->getOriginalPoints().size());
+    assert(this->getOriginalPoints().size() > 3);
+
+    knotEditor.initialize(this->getOriginalPoints());
+
+    auto &points = this->editOriginalPoints();
+    auto &segments = this->common.editSegments();
+    auto &squaredSpeeds = this->common.editSquaredSpeeds();
+    points.erase(points.begin() + index);
+    segments.erase(segments.begin() + index);
+    squaredSpeeds.erase(squaredSpeeds.begin() + std::min(index, squaredSpeeds.size() - 1));
+
+    finishEdit(index, SplineKnotEditor<InterpolationType, floating_t>::Remove);
+}
+
+template<class InterpolationType, typename floating_t, bool uniformKnots>
+void LoopingNaturalSpline<InterpolationType,floating_t,uniformKnots>::finishEdit(size_t index, typename SplineKnotEditor<InterpolationType, floating_t>::EditType type)
+{
+    auto &segments = this->common.editSegments();
+    auto &knots = this->common.editKnots();
+
+    //the first point is repeated at the end, so if it was edited, the copy has to be updated before anything reads it
+    segments.back() = segments.front();
+
+    //if the rest of the knots were scaled, scale the rest of the curvatures to match
+    floating_t knotScale = knotEditor.update(this->getOriginalPoints(), knots, index, type);
+    if(knotScale != 1)
+    {
+        floating_t curvatureScale = 1 / (knotScale * knotScale);
+        for(auto &segment : segments)
+        {
+            segment.c = curvatureScale * segment.c;
+        }
+    }
+
+    ptrdiff_t radius = __NaturalSplinePrivate::editWindowRadius<floating_t>();
+    ptrdiff_t windowBegin = ptrdiff_t(index) - 1 - radius;
+    ptrdiff_t windowEnd = ptrdiff_t(index) + 2 + radius;
+    __NaturalSplinePrivate::solveCurvatureWindow<InterpolationType, floating_t>(segments, knots, true, windowBegin, windowEnd, knotEditor.windowScratch());
+
+    this->maxT = floating_t(this->getOriginalPoints().size());
 
-    return curvatures;
+    //a segment's squared speed depends on the points and curvatures at both of its ends, so refresh the segments that touch the window
+    if(knotScale != 1)
+        this->common.refreshSquaredSpeeds(0, this->common.segmentCount());
+    else
+        __NaturalSplinePrivate::refreshSquaredSpeedWindow(this->common, true, windowBegin - 1, windowEnd);
 }
@@ -1,10 +1,13 @@
 #pragma once
 
 #include <cassert>
+#include <array>
 
 #include "../spline.h"
 
-template<class InterpolationType, typename floating_t>
+//if uniformKnots is true, the spline must have been built with alpha == 0, so its knots are just 0, 1, 2, etc
+//then the knots aren't stored, segment lookup is a floor, and the compiler can fold away every division by the T distance
+template<class InterpolationType, typename floating_t, bool uniformKnots = false>
 class QuinticHermiteSplineCommon
 {
 public:
@@ -15,8 +18,13 @@ public:
 
     inline QuinticHermiteSplineCommon(void) = default;
     inline QuinticHermiteSplineCommon(std::vector<QuinticHermiteSplinePoint> points, std::vector<floating_t> knots)
-        :points(std::move(points)), knots(std::move(knots))
-    {}
+        :points(std::move(points)), knots(std::move(knots)), squaredSpeeds(segmentCount())
+    {
+        for(size_t i = 0; i < segmentCount(); i++)
+        {
+            computeSquaredSpeed(i);
+        }
+    }
 
     inline size_t segmentCount(void) const
     {
@@ -25,7 +33,7 @@ public:
 
     inline size_t segmentForT(floating_t t) const
     {
-        size_t segmentIndex = SplineCommon::getIndexForT(knots, t);
+        size_t segmentIndex = knots.indexForT(t);
         if(segmentIndex >= segmentCount())
             return segmentCount() - 1;
         else
@@ -39,80 +47,149 @@ public:
 
     inline InterpolationType getPosition(floating_t globalT) const
     {
-        //get the knot index. if it's the final knot, back it up by one
-        size_t knotIndex = SplineCommon::getIndexForT(knots, globalT);
-        if(knotIndex >= knots.size() - 1)
-            knotIndex--;
-
-        floating_t tDiff = (knots[knotIndex + 1] - knots[knotIndex]);
-        floating_t localT = (globalT - knots[knotIndex]) / tDiff;
-
-        return computePosition(knotIndex, tDiff, localT);
+        return positionInSegment(segmentForT(globalT), globalT);
     }
 
     inline typename Spline<InterpolationType,floating_t>::InterpolatedPT getTangent(floating_t globalT) const
     {
-        //get the knot index. if it's the final knot, back it up by one
-        size_t knotIndex = SplineCommon::getIndexForT(knots, globalT);
-        if(knotIndex >= knots.size() - 1)
-            knotIndex--;
-
-        floating_t tDiff = (knots[knotIndex + 1] - knots[knotIndex]);
-        floating_t localT = (globalT - knots[knotIndex]) / tDiff;
-
-        return typename Spline<InterpolationType,floating_t>::InterpolatedPT(
-                    computePosition(knotIndex, tDiff, localT),
-                    computeTangent(knotIndex, tDiff, localT)
-                    );
+        return tangentInSegment(segmentForT(globalT), globalT);
     }
 
     inline typename Spline<InterpolationType,floating_t>::InterpolatedPTC getCurvature(floating_t globalT) const
     {
-        //get the knot index. if it's the final knot, back it up by one
-        size_t knotIndex = SplineCommon::getIndexForT(knots, globalT);
-        if(knotIndex >= knots.size() - 1)
-            knotIndex--;
+        return curvatureInSegment(segmentForT(globalT), globalT);
+    }
 
-        floating_t tDiff = (knots[knotIndex + 1] - knots[knotIndex]);
-        floating_t localT = (globalT - knots[knotIndex]) / tDiff;
+    inline typename Spline<InterpolationType,floating_t>::InterpolatedPTCW getWiggle(floating_t globalT) const
+    {
+        return wiggleInSegment(segmentForT(globalT), globalT);
+    }
 
-        return typename Spline<InterpolationType,floating_t>::InterpolatedPTC(
-                    computePosition(knotIndex, tDiff, localT),
-                    computeTangent(knotIndex, tDiff, localT),
-                    computeCurvature(knotIndex, tDiff, localT)
-                    );
+    inline void getPositions(const floating_t *tValues, size_t count, InterpolationType *output) const
+    {
+        size_t segmentIndex = 0;
+        for(size_t i = 0; i < count; i++)
+        {
+            segmentIndex = SplineCommon::segmentForTWithHint(*this, tValues[i], segmentIndex);
+            output[i] = positionInSegment(segmentIndex, tValues[i]);
+        }
     }
 
-    inline typename Spline<InterpolationType,floating_t>::InterpolatedPTCW getWiggle(floating_t globalT) const
+    inline void getTangents(const floating_t *tValues, size_t count, typename Spline<InterpolationType,floating_t>::InterpolatedPT *output) const
     {
-        //get the knot index. if it's the final knot, back it up by one
-        size_t knotIndex = SplineCommon::getIndexForT(knots, globalT);
-        if(knotIndex >= knots.size() - 1)
-            knotIndex--;
+        size_t segmentIndex = 0;
+        for(size_t i = 0; i < count; i++)
+        {
+            segmentIndex = SplineCommon::segmentForTWithHint(*this, tValues[i], segmentIndex);
+            output[i] = tangentInSegment(segmentIndex, tValues[i]);
+        }
+    }
 
-        floating_t tDiff = (knots[knotIndex + 1] - knots[knotIndex]);
-        floating_t localT = (globalT - knots[knotIndex]) / tDiff;
+    inline void getCurvatures(const floating_t *tValues, size_t count, typename Spline<InterpolationType,floating_t>::InterpolatedPTC *output) const
+    {
+        size_t segmentIndex = 0;
+        for(size_t i = 0; i < count; i++)
+        {
+            segmentIndex = SplineCommon::segmentForTWithHint(*this, tValues[i], segmentIndex);
+            output[i] = curvatureInSegment(segmentIndex, tValues[i]);
+        }
+    }
 
-        return typename Spline<InterpolationType,floating_t>::InterpolatedPTCW(
-                    computePosition(knotIndex, tDiff, localT),
-                    computeTangent(knotIndex, tDiff, localT),
-                    computeCurvature(knotIndex, tDiff, localT),
-                    computeWiggle(knotIndex, tDiff, localT)
-                    );
+    inline void getWiggles(const floating_t *tValues, size_t count, typename Spline<InterpolationType,floating_t>::InterpolatedPTCW *output) const
+    {
+        size_t segmentIndex = 0;
+        for(size_t i = 0; i < count; i++)
+        {
+            segmentIndex = SplineCommon::segmentForTWithHint(*this, tValues[i], segmentIndex);
+            output[i] = wiggleInSegment(segmentIndex, tValues[i]);
+        }
     }
 
-    inline floating_t segmentLength(size_t index, floating_t a, floating_t b) const
+    inline floating_t segmentLength(size_t index, floating_t a, floating_t b, const SplineLibraryCalculus::QuadratureSettings<floating_t> &quadrature) const
     {
-        floating_t tDiff = knots[index + 1] - knots[index];
-        auto segmentFunction = [this, index, tDiff](floating_t t) -> floating_t {
-            auto tangent = computeTangent(index, tDiff, t);
-            return tangent.length();
+        floating_t tDiff = knots.tDiff(index);
+        const auto &squaredSpeed = squaredSpeeds[index];
+        auto segmentFunction = [&squaredSpeed](floating_t t) -> floating_t {
+            return SplineCommon::evaluateBernsteinSpeed(squaredSpeed.data(), squaredSpeed.size(), t);
         };
 
         floating_t localA = (a - knots[index]) / tDiff;
         floating_t localB = (b - knots[index]) / tDiff;
 
-        return tDiff * SplineLibraryCalculus::gaussLegendreQuadratureIntegral<floating_t>(segmentFunction, localA, localB);
+        //the cached polynomial is the speed with respect to local t, so it already includes the factor of tDiff
+        return SplineLibraryCalculus::integrate<floating_t>(segmentFunction, localA, localB, quadrature);
+    }
+
+    //direct access to the point data and knots, for rebuilding a spline in place
+    inline std::vector<QuinticHermiteSplinePoint> &editPoints(void) { return points; }
+    inline SplineCommon::Knots<floating_t, uniformKnots> &editKnots(void) { return knots; }
+
+    //resize and recompute everything derived from the points and knots, after a spline's rebuild replaced them all in place
+    //builtKnots is the vector the knots were computed into, from SplineCommon::Knots::buildStorage
+    inline void finishBuild(const std::vector<floating_t> &builtKnots)
+    {
+        knots.finishBuild(builtKnots);
+        squaredSpeeds.resize(segmentCount());
+        for(size_t i = 0; i < segmentCount(); i++)
+        {
+            computeSquaredSpeed(i);
+        }
+    }
+
+    //the points this core keeps a copy of, in order, including any that a looping spline repeated. used to rebuild a spline's original points after they've been discarded
+    inline size_t storedPointCount(void) const { return points.size(); }
+    inline const InterpolationType &storedPoint(size_t index) const { return points[index].position; }
+
+    //the number of bytes this core has allocated
+    inline size_t heapFootprint(void) const
+    {
+        return SplineCommon::vectorFootprint(points) + knots.heapFootprint() + SplineCommon::vectorFootprint(squaredSpeeds);
+    }
+
+
+    //these skip the segment search, for callers that already know which segment globalT is in
+    inline InterpolationType positionInSegment(size_t segmentIndex, floating_t globalT) const
+    {
+        floating_t tDiff = knots.tDiff(segmentIndex);
+        floating_t localT = (globalT - knots[segmentIndex]) / tDiff;
+
+        return computePosition(segmentIndex, tDiff, localT);
+    }
+
+    inline typename Spline<InterpolationType,floating_t>::InterpolatedPT tangentInSegment(size_t segmentIndex, floating_t globalT) const
+    {
+        floating_t tDiff = knots.tDiff(segmentIndex);
+        floating_t localT = (globalT - knots[segmentIndex]) / tDiff;
+
+        return typename Spline<InterpolationType,floating_t>::InterpolatedPT(
+                    computePosition(segmentIndex, tDiff, localT),
+                    computeTangent(segmentIndex, tDiff, localT)
+                    );
+    }
+
+    inline typename Spline<InterpolationType,floating_t>::InterpolatedPTC curvatureInSegment(size_t segmentIndex, floating_t globalT) const
+    {
+        floating_t tDiff = knots.tDiff(segmentIndex);
+        floating_t localT = (globalT - knots[segmentIndex]) / tDiff;
+
+        return typename Spline<InterpolationType,floating_t>::InterpolatedPTC(
+                    computePosition(segmentIndex, tDiff, localT),
+                    computeTangent(segmentIndex, tDiff, localT),
+                    computeCurvature(segmentIndex, tDiff, localT)
+                    );
+    }
+
+    inline typename Spline<InterpolationType,floating_t>::InterpolatedPTCW wiggleInSegment(size_t segmentIndex, floating_t globalT) const
+    {
+        floating_t tDiff = knots.tDiff(segmentIndex);
+        floating_t localT = (globalT - knots[segmentIndex]) / tDiff;
+
+        return typename Spline<InterpolationType,floating_t>::InterpolatedPTCW(
+                    computePosition(segmentIndex, tDiff, localT),
+                    computeTangent(segmentIndex, tDiff, localT),
+                    computeCurvature(segmentIndex, tDiff, localT),
+                    computeWiggle(segmentIndex, tDiff, localT)
+                    );
     }
 
 private: //methods
@@ -123,21 +200,22 @@ private: //methods
         //one for t0 tangent (1st derivative of position), and one for t1 tangent
         //this adds 2 more basis functions, one for t0 curvature (2nd derivative) and t1 curvature
         //see this paper for details http://www.rose-hulman.edu/~finn/CCLI/Notes/day09.pdf
-        auto basis00 = (1 - t) * (1 - t) * (1 - t) * (t * (6 * t + 3) + 1);
         auto basis10 = t * (1 - t) * (1 - t) * (1 - t) * (3 * t + 1);
         auto basis20 = floating_t(0.5) * (1 - t) * (1 - t) * (1 - t) * t * t;
         auto basis21 = floating_t(0.5) * (1 - t) * (1 - t) * t * t * t;
         auto basis11 = t * t * t * (1 - t) * (t * 3 - 4);
         auto basis01 = t * t * t * (t * (6 * t - 15) + 10);
 
+        //the basis functions of the two positions always sum to 1, and their derivatives to 0, so apply them to the displacement from the first position,
+        //rather than to each position, so that points far from the origin don't lose precision to cancellation
         return
-                basis00 * points[index].position +
+                points[index].position +
                 basis10 * tDiff * points[index].tangent +
                 basis20 * tDiff * tDiff * points[index].curvature +
 
                 basis21 * tDiff * tDiff * points[index + 1].curvature +
                 basis11 * tDiff * points[index + 1].tangent +
-                basis01 * points[index + 1].position;
+                basis01 * (points[index + 1].position - points[index].position);
     }
 
     inline InterpolationType computeTangent(size_t index, floating_t tDiff, floating_t t) const
@@ -145,7 +223,6 @@ private: //methods
         //we're computing the derivative of the computePosition function with respect to t
         //we can do this by computing the derivatives of each of its basis functions.
         //thankfully this can easily be done analytically since they're polynomials!
-        auto d_basis00 =  (-30) * (1 - t) * (1 - t) * t * t;
         auto d_basis10 = (1 - t) * (1 - t) * (1 - 3 * t) * (5 * t + 1);
         auto d_basis20 = floating_t(-0.5) * (1 - t) * (1 - t) * t * (5 * t - 2);
         auto d_basis21 = floating_t(0.5) * (1 - t) * t * t * (3 - 5 * t);
@@ -156,13 +233,12 @@ private: //methods
         //intuitively it would just be the derivative of the position function and nothing else
         //if you know why please let me know
         return (
-                    d_basis00 * points[index].position +
                     d_basis10 * tDiff * points[index].tangent +
                     d_basis20 * tDiff * tDiff * points[index].curvature +
 
                     d_basis21 * tDiff * tDiff * points[index + 1].curvature +
                     d_basis11 * tDiff * points[index + 1].tangent +
-                    d_basis01 * points[index + 1].position
+                    d_basis01 * (points[index + 1].position - points[index].position)
                 ) / tDiff;
     }
 
@@ -182,13 +258,12 @@ private: //methods
         //intuitively it would just be the 2nd derivative of the position function and nothing else
         //if you know why please let me know
         return (
-                    d2_basis00 * points[index].position +
                     d2_basis10 * tDiff * points[index].tangent +
                     d2_basis20 * tDiff * tDiff * points[index].curvature +
 
                     d2_basis21 * tDiff * tDiff * points[index + 1].curvature +
                     d2_basis11 * tDiff * points[index + 1].tangent +
-                    d2_basis01 * points[index + 1].position
+                    d2_basis01 * (points[index + 1].position - points[index].position)
                 ) / (tDiff * tDiff);
     }
 
@@ -206,24 +281,62 @@ private: //methods
         //intuitively it would just be the 2nd derivative of the position function and nothing else
         //if you know why please let me know
         return (
-                    d3_basis00 * points[index].position +
                     d3_basis10 * tDiff * points[index].tangent +
                     d3_basis20 * tDiff * tDiff * points[index].curvature +
 
                     d3_basis21 * tDiff * tDiff * points[index + 1].curvature +
                     d3_basis11 * tDiff * points[index + 1].tangent +
-                    d3_basis01 * points[index + 1].position
+                    d3_basis01 * (points[index + 1].position - points[index].position)
                 ) / (tDiff * tDiff * tDiff);
     }
 
+    inline void computeSquaredSpeed(size_t index)
+    {
+        floating_t tDiff = knots.tDiff(index);
+
+        //the power basis coefficients of this segment's tangent cancel each other out badly in single precision, so use bernstein form instead
+        //the derivative of a quintic bezier curve is a quartic, whose control points are 5 times the differences of the quintic's control points
+        const auto &begin = points[index];
+        const auto &end = points[index + 1];
+        auto beginTangent = begin.tangent * tDiff;
+        auto endTangent = end.tangent * tDiff;
+        auto beginCurvature = begin.curvature * (tDiff * tDiff);
+        auto endCurvature = end.curvature * (tDiff * tDiff);
+
+        std::array<InterpolationType, 5> derivative = {{
+            beginTangent,
+            beginTangent + beginCurvature * floating_t(0.25),
+            floating_t(5) * (end.position - begin.position) - floating_t(2) * (beginTangent + endTangent) + (endCurvature - beginCurvature) * floating_t(0.25),
+            endTangent - endCurvature * floating_t(0.25),
+            endTangent
+        }};
+
+        SplineCommon::computeBernsteinSquaredSpeed(derivative.data(), derivative.size(), squaredSpeeds[index].data());
+    }
+
 private: //data
     std::vector<QuinticHermiteSplinePoint> points;
-    std::vector<floating_t> knots;
+    SplineCommon::Knots<floating_t, uniformKnots> knots;
+
+    //for each segment, the squared length of the tangent with respect to local t as a bernstein polynomial, so that arc length integrands don't need the tangent
+    std::vector<std::array<floating_t, 9>> squaredSpeeds;
 };
 
 
-template<class InterpolationType, typename floating_t=float>
-class QuinticHermiteSpline final : public SplineImpl<QuinticHermiteSplineCommon, InterpolationType, floating_t>
+namespace __QuinticHermiteSplinePrivate
+{
+    //SplineImpl expects a spline core with exactly two template parameters, so bind the knot type ahead of time
+    template<bool uniformKnots>
+    struct KnotType
+    {
+        template<class InterpolationType, typename floating_t>
+        using Common = QuinticHermiteSplineCommon<InterpolationType, floating_t, uniformKnots>;
+    };
+}
+
+//if uniformKnots is true, alpha must be 0. see QuinticHermiteSplineCommon for details
+template<class InterpolationType, typename floating_t=float, bool uniformKnots=false>
+class QuinticHermiteSpline final : public SplineImpl<__QuinticHermiteSplinePrivate::KnotType<uniformKnots>::template Common, InterpolationType, floating_t>
 {
 //constructors
 public:
@@ -232,109 +345,74 @@ public:
                          const std::vector<InterpolationType> &curvatures,
                          floating_t alpha = 0.0
                          )
-        :SplineImpl<QuinticHermiteSplineCommon, InterpolationType,floating_t>(points, points.size() - 1)
+        :SplineImpl<__QuinticHermiteSplinePrivate::KnotType<uniformKnots>::template Common, InterpolationType,floating_t>(points, points.size() - 1), explicitDerivatives(true)
     {
-        assert(points.size() >= 2);
-        assert(points.size() == tangents.size());
-        assert(points.size() == curvatures.size());
-
-        //compute the T values for each point
-        std::vector<floating_t> knots = SplineCommon::computeTValuesWithInnerPadding(points, alpha, 0);
-
-        //pre-arrange the data needed for interpolation
-        std::vector<typename QuinticHermiteSplineCommon<InterpolationType, floating_t>::QuinticHermiteSplinePoint> positionData(points.size());
-        for(int i = 0; i < points.size(); i++)
-        {
-            positionData[i].position = points.at(i);
-            positionData[i].tangent = tangents.at(i);
-            positionData[i].curvature = curvatures.at(i);
-        }
-
-        common = QuinticHermiteSplineCommon<InterpolationType, floating_t>(std::move(positionData), std::move(knots));
+        SplineCommon::BuildScratch<InterpolationType, floating_t> buildScratch;
+        build(points, tangents, curvatures, alpha, buildScratch);
     }
 
     QuinticHermiteSpline(const std::vector<InterpolationType> &points, floating_t alpha = 0.0f)
-        :SplineImpl<QuinticHermiteSplineCommon, InterpolationType,floating_t>(points, points.size() - 5)
+        :SplineImpl<__QuinticHermiteSplinePrivate::KnotType<uniformKnots>::template Common, InterpolationType,floating_t>(points, points.size() - 5), explicitDerivatives(false)
     {
-        assert(points.size() >= 6);
-
-        size_t size = points.size();
-        size_t numSegments = points.size() - 5;
+        SplineCommon::BuildScratch<InterpolationType, floating_t> buildScratch;
+        build(points, alpha, buildScratch);
+    }
 
-        //compute the T values for each point
-        size_t padding = 2;
-        std::vector<floating_t> paddedKnots = SplineCommon::computeTValuesWithInnerPadding(points, alpha, padding);
+//rebuilding
+public:
+    //replace this spline with the one the matching constructor would build from the given arguments, reusing this spline's memory
+    //as long as there are no more points than the last time, nothing is allocated
+    inline void rebuild(const std::vector<InterpolationType> &points,
+                        const std::vector<InterpolationType> &tangents,
+                        const std::vector<InterpolationType> &curvatures,
+                        floating_t alpha = 0.0
+                        )
+    {
+        this->replaceOriginalPoints(points, floating_t(points.size() - 1));
+        explicitDerivatives = true;
+        build(points, tangents, curvatures, alpha, retainedScratch.get());
+    }
 
-        //compute the tangents
-        std::vector<InterpolationType> tangents(size);
-        size_t firstTangent = 1;
-        size_t lastTangent = points.size() - 2;
-        for(size_t i = firstTangent; i <= lastTangent; i++)
-        {
-            floating_t tPrev = paddedKnots[i - 1];
-            floating_t tCurrent = paddedKnots[i];
-            floating_t tNext = paddedKnots[i + 1];
-
-            InterpolationType pPrev = points.at(i - 1);
-            InterpolationType pCurrent = points.at(i);
-            InterpolationType pNext = points.at(i + 1);
-
-            //the tangent is the standard catmull-rom spline tangent calculation
-            tangents[i] =
-                      pPrev * (tCurrent - tNext) / ((tNext - tPrev) * (tCurrent - tPrev))
-                    + pNext * (tCurrent - tPrev) / ((tNext - tPrev) * (tNext - tCurrent))
-
-                 //plus a little something extra - this is derived from the pyramid contruction
-                 //when the t values are evenly spaced (ie when alpha is 0), this whole line collapses to 0,
-                 //yielding the standard catmull-rom formula
-                    - pCurrent * ((tCurrent - tPrev) - (tNext - tCurrent)) / ((tNext - tCurrent) * (tCurrent - tPrev));
-        }
+    inline void rebuild(const std::vector<InterpolationType> &points, floating_t alpha = 0.0f)
+    {
+        this->replaceOriginalPoints(points, floating_t(points.size() - 5));
+        explicitDerivatives = false;
+        build(points, alpha, retainedScratch.get());
+    }
 
-        //compute the curvatures
-        std::vector<InterpolationType> curves(size);
-        size_t firstCurvature = padding = 2;
-        size_t lastCurvature = points.size() - 3;
-        for(size_t i = firstCurvature; i <= lastCurvature; i++)
-        {
-            floating_t tPrev = paddedKnots[i - 1];
-            floating_t tCurrent = paddedKnots[i];
-            floating_t tNext = paddedKnots[i + 1];
-
-            InterpolationType pPrev = tangents.at(i - 1);
-            InterpolationType pCurrent = tangents.at(i);
-            InterpolationType pNext = tangents.at(i + 1);
-
-            //the tangent is the standard catmull-rom spline tangent calculation
-            curves[i] =
-                      pPrev * (tCurrent - tNext) / ((tNext - tPrev) * (tCurrent - tPrev))
-                    + pNext * (tCurrent - tPrev) / ((tNext - tPrev) * (tNext - tCurrent))
-
-                 //plus a little something extra - this is derived from the pyramid contruction
-                 //when the t values are evenly spaced (ie when alpha is 0), this whole line collapses to 0,
-                 //yielding the standard catmull-rom formula
-                    - pCurrent * ((tCurrent - tPrev) - (tNext - tCurrent)) / ((tNext - tCurrent) * (tCurrent - tPrev));
-        }
+    size_t memoryFootprint(void) const override
+    {
+        return sizeof(*this) + this->originalPointsFootprint() + this->common.heapFootprint() + retainedScratch.heapFootprint();
+    }
 
+private:
+    //fill the core from scratch, for the constructors and rebuild
+    void build(const std::vector<InterpolationType> &points,
+               const std::vector<InterpolationType> &tangents,
+               const std::vector<InterpolationType> &curvatures,
+               floating_t alpha,
+               SplineCommon::BuildScratch<InterpolationType, floating_t> &buildScratch);
+    void build(const std::vector<InterpolationType> &points, floating_t alpha, SplineCommon::BuildScratch<InterpolationType, floating_t> &buildScratch);
 
-        //pre-arrange the data needed for interpolation
-        std::vector<floating_t> knots(numSegments + 1);
-        std::vector<typename QuinticHermiteSplineCommon<InterpolationType, floating_t>::QuinticHermiteSplinePoint> positionData(numSegments + 1);
-        for(size_t i = 0; i < positionData.size(); i++)
-        {
-            knots[i] = paddedKnots[i + padding];
+    bool reconstructOriginalPoints(std::vector<InterpolationType> &output) const override
+    {
+        //the core keeps every point unchanged, but only when the derivatives were given explicitly. otherwise the first and last two points are only used for derivatives
+        if(!explicitDerivatives)
+            return false;
 
-            positionData[i].position = points[i + padding];
-            positionData[i].tangent = tangents[i + padding];
-            positionData[i].curvature = curves[i + padding];
-        }
-        common = QuinticHermiteSplineCommon<InterpolationType, floating_t>(std::move(positionData), std::move(knots));
+        SplineCommon::copyStoredPoints(this->common, 0, this->common.storedPointCount(), output);
+        return true;
     }
+
+    bool explicitDerivatives;
+    SplineCommon::RetainedBuildScratch<InterpolationType, floating_t> retainedScratch;
 };
 
 
 
-template<class InterpolationType, typename floating_t=float>
-class LoopingQuinticHermiteSpline final : public SplineLoopingImpl<QuinticHermiteSplineCommon, InterpolationType, floating_t>
+//if uniformKnots is true, alpha must be 0. see QuinticHermiteSplineCommon for details
+template<class InterpolationType, typename floating_t=float, bool uniformKnots=false>
+class LoopingQuinticHermiteSpline final : public SplineLoopingImpl<__QuinticHermiteSplinePrivate::KnotType<uniformKnots>::template Common, InterpolationType, floating_t>
 {
 //constructors
 public:
@@ -343,99 +421,240 @@ public:
                                 const std::vector<InterpolationType> &curvatures,
                                 floating_t alpha = 0.0
                                 )
-        :SplineLoopingImpl<QuinticHermiteSplineCommon, InterpolationType,floating_t>(points, points.size())
+        :SplineLoopingImpl<__QuinticHermiteSplinePrivate::KnotType<uniformKnots>::template Common, InterpolationType,floating_t>(points, points.size())
     {
-        assert(points.size() >= 2);
-        assert(points.size() == tangents.size());
-        assert(points.size() == curvatures.size());
+        SplineCommon::BuildScratch<InterpolationType, floating_t> buildScratch;
+        build(points, tangents, curvatures, alpha, buildScratch);
+    }
 
-        //compute the T values for each point
-        std::vector<floating_t> knots = SplineCommon::computeLoopingTValues(points, alpha, 0);
+    LoopingQuinticHermiteSpline(const std::vector<InterpolationType> &points, floating_t alpha = 0.0)
+        :SplineLoopingImpl<__QuinticHermiteSplinePrivate::KnotType<uniformKnots>::template Common, InterpolationType,floating_t>(points, points.size())
+    {
+        SplineCommon::BuildScratch<InterpolationType, floating_t> buildScratch;
+        build(points, alpha, buildScratch);
+    }
 
-        //pre-arrange the data needed for interpolation
-        std::vector<typename QuinticHermiteSplineCommon<InterpolationType, floating_t>::QuinticHermiteSplinePoint> positionData(points.size() + 1);
-        for(size_t i = 0; i < points.size(); i++)
-        {
-            positionData[i].position = points.at(i);
-            positionData[i].tangent = tangents.at(i);
-            positionData[i].curvature = curvatures.at(i);
-        }
-        positionData[points.size()] = positionData[0];
+//rebuilding
+public:
+    //replace this spline with the one the matching constructor would build from the given arguments, reusing this spline's memory
+    //as long as there are no more points than the last time, nothing is allocated
+    inline void rebuild(const std::vector<InterpolationType> &points,
+                        const std::vector<InterpolationType> &tangents,
+                        const std::vector<InterpolationType> &curvatures,
+                        floating_t alpha = 0.0
+                        )
+    {
+        this->replaceOriginalPoints(points, floating_t(points.size()));
+        build(points, tangents, curvatures, alpha, retainedScratch.get());
+    }
 
-        common = QuinticHermiteSplineCommon<InterpolationType, floating_t>(std::move(positionData), std::move(knots));
+    inline void rebuild(const std::vector<InterpolationType> &points, floating_t alpha = 0.0)
+    {
+        this->replaceOriginalPoints(points, floating_t(points.size()));
+        build(points, alpha, retainedScratch.get());
     }
 
-    LoopingQuinticHermiteSpline(const std::vector<InterpolationType> &points, floating_t alpha = 0.0)
-        :SplineLoopingImpl<QuinticHermiteSplineCommon, InterpolationType,floating_t>(points, points.size())
+    size_t memoryFootprint(void) const override
     {
-        assert(points.size() >= 3);
+        return sizeof(*this) + this->originalPointsFootprint() + this->common.heapFootprint() + retainedScratch.heapFootprint();
+    }
 
-        size_t size = points.size();
+private:
+    bool reconstructOriginalPoints(std::vector<InterpolationType> &output) const override
+    {
+        //the core keeps every point, then the first point again
+        SplineCommon::copyStoredPoints(this->common, 0, this->common.storedPointCount() - 1, output);
+        return true;
+    }
 
-        //compute the T values for each point
-        size_t padding = 2;
-        std::vector<floating_t> paddedKnots = SplineCommon::computeLoopingTValues(points, alpha, padding);
+    //fill the core from scratch, for the constructors and rebuild
+    void build(const std::vector<InterpolationType> &points,
+               const std::vector<InterpolationType> &tangents,
+               const std::vector<InterpolationType> &curvatures,
+               floating_t alpha,
+               SplineCommon::BuildScratch<InterpolationType, floating_t> &buildScratch);
+    void build(const std::vector<InterpolationType> &points, floating_t alpha, SplineCommon::BuildScratch<InterpolationType, floating_t> &buildScratch);
 
-        //compute the tangents
-        std::vector<InterpolationType> tangents(size);
-        for(int i = 0; i < size; i++)
-        {
-            floating_t tPrev = paddedKnots[i - 1 + padding];
-            floating_t tCurrent = paddedKnots[i + padding];
-            floating_t tNext = paddedKnots[i + 1 + padding];
-
-            InterpolationType pPrev = points[(i - 1 + size)%size];
-            InterpolationType pCurrent = points[i];
-            InterpolationType pNext = points[(i + 1)%size];
-
-            //the tangent is the standard catmull-rom spline tangent calculation
-            tangents[i] =
-                      pPrev * (tCurrent - tNext) / ((tNext - tPrev) * (tCurrent - tPrev))
-                    + pNext * (tCurrent - tPrev) / ((tNext - tPrev) * (tNext - tCurrent))
-
-                 //plus a little something extra - this is derived from the pyramid contruction
-                 //when the t values are evenly spaced (ie when alpha is 0), this whole line collapses to 0,
-                 //yielding the standard catmull-rom formula
-                    - pCurrent * ((tCurrent - tPrev) - (tNext - tCurrent)) / ((tNext - tCurrent) * (tCurrent - tPrev));
-        }
+    SplineCommon::RetainedBuildScratch<InterpolationType, floating_t> retainedScratch;
+};
 
-        //compute the curvatures
-        std::vector<InterpolationType> curves(size);
-        for(int i = 0; i < size; i++)
-        {
-            floating_t tPrev = paddedKnots[i - 1 + padding];
-            floating_t tCurrent = paddedKnots[i + padding];
-            floating_t tNext = paddedKnots[i + 1 + padding];
-
-            InterpolationType pPrev = tangents[(i - 1 + size)%size];
-            InterpolationType pCurrent = tangents[i];
-            InterpolationType pNext = tangents[(i + 1)%size];
-
-            //the tangent is the standard catmull-rom spline tangent calculation
-            curves[i] =
-                      pPrev * (tCurrent - tNext) / ((tNext - tPrev) * (tCurrent - tPrev))
-                    + pNext * (tCurrent - tPrev) / ((tNext - tPrev) * (tNext - tCurrent))
-
-                 //plus a little something extra - this is derived from the pyramid contruction
-                 //when the t values are evenly spaced (ie when alpha is 0), this whole line collapses to 0,
-                 //yielding the standard catmull-rom formula
-                    - pCurrent * ((tCurrent - tPrev) - (tNext - tCurrent)) / ((tNext - tCurrent) * (tCurrent - tPrev));
-        }
+template<class InterpolationType, typename floating_t, bool uniformKnots>
+void QuinticHermiteSpline<InterpolationType,floating_t,uniformKnots>::build(
+        const std::vector<InterpolationType> &points,
+        const std::vector<InterpolationType> &tangents,
+        const std::vector<InterpolationType> &curvatures,
+        floating_t alpha,
+        SplineCommon::BuildScratch<InterpolationType, floating_t> &buildScratch)
+{
+    assert(!uniformKnots || alpha == 0);
+    assert(points.size() >= 2);
+    assert(points.size() == tangents.size());
+    assert(points.size() == curvatures.size());
+
+    //compute the T values for each point
+    std::vector<floating_t> &knots = this->common.editKnots().buildStorage(buildScratch.knots);
+    SplineCommon::computeTValuesWithInnerPadding(points, alpha, 0, knots);
+
+    //pre-arrange the data needed for interpolation
+    auto &positionData = this->common.editPoints();
+    positionData.resize(points.size());
+    for(size_t i = 0; i < points.size(); i++)
+    {
+        positionData[i].position = points.at(i);
+        positionData[i].tangent = tangents.at(i);
+        positionData[i].curvature = curvatures.at(i);
+    }
 
+    this->common.finishBuild(knots);
+}
 
-        //pre-arrange the data needed for interpolation
-        std::vector<floating_t> knots(size + 1);
-        std::vector<typename QuinticHermiteSplineCommon<InterpolationType, floating_t>::QuinticHermiteSplinePoint> positionData(size + 1);
-        for(int i = 0; i < size; i++)
-        {
-            knots[i] = paddedKnots[i + padding];
-            positionData[i].position = points[i];
-            positionData[i].tangent = tangents[i];
-            positionData[i].curvature = curves[i];
-        }
-        positionData[size] = positionData[0];
-        knots[size] = paddedKnots[size + padding];
+template<class InterpolationType, typename floating_t, bool uniformKnots>
+void QuinticHermiteSpline<InterpolationType,floating_t,uniformKnots>::build(
+        const std::vector<InterpolationType> &points, floating_t alpha, SplineCommon::BuildScratch<InterpolationType, floating_t> &buildScratch)
+{
+    assert(!uniformKnots || alpha == 0);
+    assert(points.size() >= 6);
+
+    size_t size = points.size();
+    size_t numSegments = points.size() - 5;
+
+    //compute the T values for each point
+    size_t padding = 2;
+    std::vector<floating_t> &paddedKnots = this->common.editKnots().buildStorage(buildScratch.knots);
+    SplineCommon::computeTValuesWithInnerPadding(points, alpha, padding, paddedKnots);
+
+    //compute the tangents
+    std::vector<InterpolationType> &tangents = buildScratch.values;
+    tangents.resize(size);
+    size_t firstTangent = 1;
+    size_t lastTangent = points.size() - 2;
+    for(size_t i = firstTangent; i <= lastTangent; i++)
+    {
+        floating_t tPrev = paddedKnots[i - 1];
+        floating_t tCurrent = paddedKnots[i];
+        floating_t tNext = paddedKnots[i + 1];
+
+        InterpolationType pPrev = points.at(i - 1);
+        InterpolationType pCurrent = points.at(i);
+        InterpolationType pNext = points.at(i + 1);
 
-        common = QuinticHermiteSplineCommon<InterpolationType, floating_t>(std::move(positionData), std::move(knots));
+        //the tangent is the standard catmull-rom spline tangent calculation
+        tangents[i] = SplineCommon::computeCatmullRomTangent(pPrev, pCurrent, pNext, tPrev, tCurrent, tNext);
     }
-};
+
+    //compute the curvatures, directly into the data needed for interpolation
+    auto &positionData = this->common.editPoints();
+    positionData.resize(numSegments + 1);
+    size_t firstCurvature = padding;
+    size_t lastCurvature = points.size() - 3;
+    for(size_t i = firstCurvature; i <= lastCurvature; i++)
+    {
+        floating_t tPrev = paddedKnots[i - 1];
+        floating_t tCurrent = paddedKnots[i];
+        floating_t tNext = paddedKnots[i + 1];
+
+        InterpolationType pPrev = tangents.at(i - 1);
+        InterpolationType pCurrent = tangents.at(i);
+        InterpolationType pNext = tangents.at(i + 1);
+
+        positionData[i - padding].position = points[i];
+        positionData[i - padding].tangent = pCurrent;
+
+        //the tangent is the standard catmull-rom spline tangent calculation
+        positionData[i - padding].curvature = SplineCommon::computeCatmullRomTangent(pPrev, pCurrent, pNext, tPrev, tCurrent, tNext);
+    }
+
+    //the knots are the padded knots without their padding, so reuse the padded vector's memory
+    SplineCommon::removeKnotPadding(paddedKnots, padding, numSegments + 1);
+
+    this->common.finishBuild(paddedKnots);
+}
+
+template<class InterpolationType, typename floating_t, bool uniformKnots>
+void LoopingQuinticHermiteSpline<InterpolationType,floating_t,uniformKnots>::build(
+        const std::vector<InterpolationType> &points,
+        const std::vector<InterpolationType> &tangents,
+        const std::vector<InterpolationType> &curvatures,
+        floating_t alpha,
+        SplineCommon::BuildScratch<InterpolationType, floating_t> &buildScratch)
+{
+    assert(!uniformKnots || alpha == 0);
+    assert(points.size() >= 2);
+    assert(points.size() == tangents.size());
+    assert(points.size() == curvatures.size());
+
+    //compute the T values for each point
+    std::vector<floating_t> &knots = this->common.editKnots().buildStorage(buildScratch.knots);
+    SplineCommon::computeLoopingTValues(points, alpha, 0, knots);
+
+    //pre-arrange the data needed for interpolation
+    auto &positionData = this->common.editPoints();
+    positionData.resize(points.size() + 1);
+    for(size_t i = 0; i < points.size(); i++)
+    {
+        positionData[i].position = points.at(i);
+        positionData[i].tangent = tangents.at(i);
+        positionData[i].curvature = curvatures.at(i);
+    }
+    positionData[points.size()] = positionData[0];
+
+    this->common.finishBuild(knots);
+}
+
+template<class InterpolationType, typename floating_t, bool uniformKnots>
+void LoopingQuinticHermiteSpline<InterpolationType,floating_t,uniformKnots>::build(
+        const std::vector<InterpolationType> &points, floating_t alpha, SplineCommon::BuildScratch<InterpolationType, floating_t> &buildScratch)
+{
+    assert(!uniformKnots || alpha == 0);
+    assert(points.size() >= 3);
+
+    size_t size = points.size();
+
+    //compute the T values for each point
+    size_t padding = 2;
+    std::vector<floating_t> &paddedKnots = this->common.editKnots().buildStorage(buildScratch.knots);
+    SplineCommon::computeLoopingTValues(points, alpha, padding, paddedKnots);
+
+    //compute the tangents
+    std::vector<InterpolationType> &tangents = buildScratch.values;
+    tangents.resize(size);
+    for(size_t i = 0; i < size; i++)
+    {
+        floating_t tPrev = paddedKnots[i - 1 + padding];
+        floating_t tCurrent = paddedKnots[i + padding];
+        floating_t tNext = paddedKnots[i + 1 + padding];
+
+        InterpolationType pPrev = points[(i - 1 + size)%size];
+        InterpolationType pCurrent = points[i];
+        InterpolationType pNext = points[(i + 1)%size];
+
+        //the tangent is the standard catmull-rom spline tangent calculation
+        tangents[i] = SplineCommon::computeCatmullRomTangent(pPrev, pCurrent, pNext, tPrev, tCurrent, tNext);
+    }
+
+    //compute the curvatures, directly into the data needed for interpolation
+    auto &positionData = this->common.editPoints();
+    positionData.resize(size + 1);
+    for(size_t i = 0; i < size; i++)
+    {
+        floating_t tPrev = paddedKnots[i - 1 + padding];
+        floating_t tCurrent = paddedKnots[i + padding];
+        floating_t tNext = paddedKnots[i + 1 + padding];
+
+        InterpolationType pPrev = tangents[(i - 1 + size)%size];
+        InterpolationType pCurrent = tangents[i];
+        InterpolationType pNext = tangents[(i + 1)%size];
+
+        positionData[i].position = points[i];
+        positionData[i].tangent = pCurrent;
+
+        //the tangent is the standard catmull-rom spline tangent calculation
+        positionData[i].curvature = SplineCommon::computeCatmullRomTangent(pPrev, pCurrent, pNext, tPrev, tCurrent, tNext);
+    }
+    positionData[size] = positionData[0];
+
+    //the knots are the padded knots without their padding, so reuse the padded vector's memory
+    SplineCommon::removeKnotPadding(paddedKnots, padding, size + 1);
+
+    this->common.finishBuild(paddedKnots);
+}
@@ -0,0 +1,337 @@
+#pragma once
+
+#include <cassert>
+#include <array>
+#include <vector>
+
+#include "../spline.h"
+#include "uniform_cr_spline.h"
+#include "cubic_hermite_spline.h"
+
+namespace __SlidingWindowSplinePrivate
+{
+    //a fixed-capacity ring buffer where pushing past the capacity drops the oldest element
+    //every element is stored twice, capacity elements apart, so the elements from oldest to newest are always contiguous in memory,
+    //starting at data(). that way the interpolation math can index into them directly, with no wrapping
+    template<class T>
+    class MirroredRing
+    {
+    public:
+        MirroredRing(size_t capacity)
+            :storage(capacity * 2), ringCapacity(capacity), head(0), count(0)
+        {}
+
+        inline void push(const T &value)
+        {
+            if(count == ringCapacity)
+                head = head + 1 == ringCapacity ? 0 : head + 1;
+            else
+                count++;
+
+            size_t slot = head + count - 1;
+            if(slot >= ringCapacity)
+                slot -= ringCapacity;
+
+            storage[slot] = value;
+            storage[slot + ringCapacity] = value;
+        }
+
+        inline const T *data(void) const { return storage.data() + head; }
+        inline size_t size(void) const { return count; }
+        inline size_t capacity(void) const { return ringCapacity; }
+
+        inline size_t heapFootprint(void) const { return SplineCommon::vectorFootprint(storage); }
+
+    private:
+        std::vector<T> storage;
+        size_t ringCapacity;
+        size_t head;
+        size_t count;
+    };
+
+    //everything the sliding window splines have in common. Math provides the type of point that's pushed, how many extra points the segments need,
+    //and the interpolation math, by forwarding to the static functions of the equivalent std::vector-based spline's core
+    template<class Math, class InterpolationType, typename floating_t>
+    class SlidingWindowSpline
+    {
+    public:
+        typedef typename Math::Point Point;
+
+        //the window holds up to capacity points. point k, counting every point ever pushed from 0, is at t = startTime + k * sampleInterval
+        SlidingWindowSpline(size_t capacity, floating_t sampleInterval, floating_t startTime)
+            :points(capacity), squaredSpeeds(capacity - Math::extraPoints), sampleInterval(sampleInterval), startTime(startTime), pushedCount(0), windowBeginT(0)
+        {
+            assert(capacity > Math::extraPoints);
+            assert(sampleInterval > 0);
+        }
+
+        //t values outside the window fall in the first or last segment, the same as for the other splines. the window must have at least one segment before anything is evaluated
+        inline InterpolationType getPosition(floating_t t) const
+        {
+            return getPositionInSegment(segmentForT(t), t);
+        }
+        inline typename Spline<InterpolationType,floating_t>::InterpolatedPT getTangent(floating_t t) const
+        {
+            return getTangentInSegment(segmentForT(t), t);
+        }
+        inline typename Spline<InterpolationType,floating_t>::InterpolatedPTC getCurvature(floating_t t) const
+        {
+            return getCurvatureInSegment(segmentForT(t), t);
+        }
+        inline typename Spline<InterpolationType,floating_t>::InterpolatedPTCW getWiggle(floating_t t) const
+        {
+            return getWiggleInSegment(segmentForT(t), t);
+        }
+
+        //the range of t the window currently covers. both move forward by sampleInterval with every push, once the window is full
+        inline floating_t getMinT(void) const { return windowBeginT; }
+        inline floating_t getMaxT(void) const { return segmentT(segmentCount()); }
+        inline bool isLooping(void) const { return false; }
+
+        inline size_t pointCount(void) const { return points.size(); }
+        inline size_t capacity(void) const { return points.capacity(); }
+
+        //the points in the window, from oldest to newest
+        inline const Point &windowPoint(size_t index) const { return points.data()[index]; }
+
+        inline void setArcLengthQuadrature(const SplineLibraryCalculus::QuadratureSettings<floating_t> &settings) { quadrature = settings; }
+        inline const SplineLibraryCalculus::QuadratureSettings<floating_t> &getArcLengthQuadrature(void) const { return quadrature; }
+
+        //the number of bytes used by this spline, including everything it has allocated
+        inline size_t memoryFootprint(void) const { return sizeof(*this) + points.heapFootprint() + squaredSpeeds.heapFootprint(); }
+
+        //lower level functions. segment indexes count from the oldest segment in the window, so the same t has a different segment index after every push
+        inline size_t segmentCount(void) const
+        {
+            return points.size() > Math::extraPoints ? points.size() - Math::extraPoints : 0;
+        }
+        inline size_t segmentForT(floating_t t) const
+        {
+            assert(segmentCount() > 0);
+
+            //the segments are all sampleInterval long, so this is a floor, offset by where the window begins
+            floating_t windowT = (t - windowBeginT) / sampleInterval;
+            if(windowT < 0)
+                return 0;
+            if(windowT >= floating_t(segmentCount() - 1))
+                return segmentCount() - 1;
+            return size_t(windowT);
+        }
+        inline floating_t segmentT(size_t segmentIndex) const
+        {
+            //computed from the point's index every time, rather than accumulated, so that it doesn't drift over a long stream
+            return startTime + floating_t(firstSegmentIndex() + segmentIndex) * sampleInterval;
+        }
+        inline floating_t segmentArcLength(size_t segmentIndex, floating_t a, floating_t b) const
+        {
+            const floating_t *squaredSpeed = squaredSpeeds.data()[segmentIndex].data();
+            auto segmentFunction = [squaredSpeed](floating_t localT) -> floating_t {
+                return SplineCommon::evaluateSpeed(squaredSpeed, 5, localT);
+            };
+
+            //the squared speed is with respect to local t, so integrating over local t gives the length directly
+            floating_t beginT = segmentT(segmentIndex);
+            floating_t localA = (a - beginT) / sampleInterval;
+            floating_t localB = (b - beginT) / sampleInterval;
+            return SplineLibraryCalculus::integrate<floating_t>(segmentFunction, localA, localB, quadrature);
+        }
+
+        //evaluate at t, which must already be inside the given segment. same as the Spline methods of the same names
+        inline InterpolationType getPositionInSegment(size_t segmentIndex, floating_t t) const
+        {
+            return Math::position(points.data(), segmentIndex, sampleInterval, localT(segmentIndex, t));
+        }
+        inline typename Spline<InterpolationType,floating_t>::InterpolatedPT getTangentInSegment(size_t segmentIndex, floating_t t) const
+        {
+            floating_t local = localT(segmentIndex, t);
+            return typename Spline<InterpolationType,floating_t>::InterpolatedPT(
+                        Math::position(points.data(), segmentIndex, sampleInterval, local),
+                        Math::tangent(points.data(), segmentIndex, sampleInterval, local)
+                        );
+        }
+        inline typename Spline<InterpolationType,floating_t>::InterpolatedPTC getCurvatureInSegment(size_t segmentIndex, floating_t t) const
+        {
+            floating_t local = localT(segmentIndex, t);
+            return typename Spline<InterpolationType,floating_t>::InterpolatedPTC(
+                        Math::position(points.data(), segmentIndex, sampleInterval, local),
+                        Math::tangent(points.data(), segmentIndex, sampleInterval, local),
+                        Math::curvature(points.data(), segmentIndex, sampleInterval, local)
+                        );
+        }
+        inline typename Spline<InterpolationType,floating_t>::InterpolatedPTCW getWiggleInSegment(size_t segmentIndex, floating_t t) const
+        {
+            floating_t local = localT(segmentIndex, t);
+            return typename Spline<InterpolationType,floating_t>::InterpolatedPTCW(
+                        Math::position(points.data(), segmentIndex, sampleInterval, local),
+                        Math::tangent(points.data(), segmentIndex, sampleInterval, local),
+                        Math::curvature(points.data(), segmentIndex, sampleInterval, local),
+                        Math::wiggle(points.data(), segmentIndex, sampleInterval)
+                        );
+        }
+
+    protected:
+        //add a point to the window, dropping the oldest one if it's full
+        //the only segment that changes is the new one at the end, since every other segment only depends on points that are still in the window,
+        //so this costs the same no matter how big the window is
+        void pushPoint(const Point &point)
+        {
+            points.push(point);
+            pushedCount++;
+
+            if(points.size() > Math::extraPoints)
+            {
+                std::array<floating_t, 5> squaredSpeed;
+                Math::squaredSpeed(points.data(), segmentCount() - 1, sampleInterval, squaredSpeed.data());
+                squaredSpeeds.push(squaredSpeed);
+            }
+            windowBeginT = segmentT(0);
+        }
+
+    private:
+        //the index of the window's first segment, counting every segment there's ever been
+        inline size_t firstSegmentIndex(void) const { return pushedCount - points.size() + Math::leadingPoints; }
+
+        inline floating_t localT(size_t segmentIndex, floating_t t) const
+        {
+            return (t - segmentT(segmentIndex)) / sampleInterval;
+        }
+
+        MirroredRing<Point> points;
+
+        //for each segment in the window, the squared length of the tangent as a polynomial of local t, so that arc length integrands don't need the tangent
+        MirroredRing<std::array<floating_t, 5>> squaredSpeeds;
+
+        floating_t sampleInterval;
+        floating_t startTime;
+        size_t pushedCount;
+        floating_t windowBeginT;
+
+        SplineLibraryCalculus::QuadratureSettings<floating_t> quadrature;
+    };
+
+    template<class InterpolationType, typename floating_t>
+    struct UniformCRMath
+    {
+        typedef InterpolationType Point;
+        typedef UniformCRSplineCommon<InterpolationType, floating_t> Core;
+
+        //each segment also needs the point before it and the point after it, and the first segment begins at the second point
+        static const size_t extraPoints = 3;
+        static const size_t leadingPoints = 1;
+
+        //the core's derivatives are with respect to local t, which goes from 0 to 1 across one sample interval
+        static inline InterpolationType position(const Point *points, size_t segmentIndex, floating_t, floating_t t)
+        {
+            return Core::computePosition(points, segmentIndex, t);
+        }
+        static inline InterpolationType tangent(const Point *points, size_t segmentIndex, floating_t sampleInterval, floating_t t)
+        {
+            return Core::computeTangent(points, segmentIndex, t) / sampleInterval;
+        }
+        static inline InterpolationType curvature(const Point *points, size_t segmentIndex, floating_t sampleInterval, floating_t t)
+        {
+            return Core::computeCurvature(points, segmentIndex, t) / (sampleInterval * sampleInterval);
+        }
+        static inline InterpolationType wiggle(const Point *points, size_t segmentIndex, floating_t sampleInterval)
+        {
+            return Core::computeWiggle(points, segmentIndex) / (sampleInterval * sampleInterval * sampleInterval);
+        }
+        static inline void squaredSpeed(const Point *points, size_t segmentIndex, floating_t, floating_t *output)
+        {
+            //the tangent is a quadratic, so its taylor series at the beginning of the segment is exact
+            std::array<InterpolationType, 3> tangent = {{
+                Core::computeTangent(points, segmentIndex, 0),
+                Core::computeCurvature(points, segmentIndex, 0),
+                Core::computeWiggle(points, segmentIndex) / floating_t(2)
+            }};
+            SplineCommon::computeSquaredSpeed(tangent.data(), tangent.size(), output);
+        }
+    };
+
+    template<class InterpolationType, typename floating_t>
+    struct CubicHermiteMath
+    {
+        typedef CubicHermiteSplineCommon<InterpolationType, floating_t, true> Core;
+        typedef typename Core::CubicHermiteSplinePoint Point;
+
+        //each segment only needs the points at its ends
+        static const size_t extraPoints = 1;
+        static const size_t leadingPoints = 0;
+
+        //the core's derivatives are with respect to t, given the t distance of the segment
+        static inline InterpolationType position(const Point *points, size_t segmentIndex, floating_t sampleInterval, floating_t t)
+        {
+            return Core::computePosition(points, segmentIndex, sampleInterval, t);
+        }
+        static inline InterpolationType tangent(const Point *points, size_t segmentIndex, floating_t sampleInterval, floating_t t)
+        {
+            return Core::computeTangent(points, segmentIndex, sampleInterval, t);
+        }
+        static inline InterpolationType curvature(const Point *points, size_t segmentIndex, floating_t sampleInterval, floating_t t)
+        {
+            return Core::computeCurvature(points, segmentIndex, sampleInterval, t);
+        }
+        static inline InterpolationType wiggle(const Point *points, size_t segmentIndex, floating_t sampleInterval)
+        {
+            return Core::computeWiggle(points, segmentIndex, sampleInterval);
+        }
+        static inline void squaredSpeed(const Point *points, size_t segmentIndex, floating_t sampleInterval, floating_t *output)
+        {
+            //the tangent is a quadratic of local t, so its taylor series at the beginning of the segment is exact
+            //the derivatives are with respect to t, so scale each one by the sample interval to make it with respect to local t
+            std::array<InterpolationType, 3> tangent = {{
+                Core::computeTangent(points, segmentIndex, sampleInterval, 0) * sampleInterval,
+                Core::computeCurvature(points, segmentIndex, sampleInterval, 0) * (sampleInterval * sampleInterval),
+                Core::computeWiggle(points, segmentIndex, sampleInterval) * (sampleInterval * sampleInterval * sampleInterval / 2)
+            }};
+            SplineCommon::computeSquaredSpeed(tangent.data(), tangent.size(), output);
+        }
+    };
+}
+
+//splines over the most recent points of a stream, for live data like sensor telemetry, where only the last few seconds matter
+//the points are kept in a fixed-capacity ring buffer that's allocated once, by the constructor. pushing a point when the window is full drops the oldest point,
+//and only the newest segment is computed, so every push costs the same no matter how big the window is
+//
+//t is absolute time: the kth point pushed, counting from 0, is at startTime + k * sampleInterval, and t values keep increasing as the stream goes on
+//long streams need a floating_t with enough precision for the largest t value. IE, a float can only tell samples apart for the first few hours of a 1 kHz stream,
+//so prefer double for floating_t there, even when InterpolationType is single precision
+//
+//they evaluate exactly the same as UniformCRSpline and CubicHermiteSpline built from the points in the window, but they don't inherit from Spline,
+//because their t values don't begin at 0. arcLength and totalLength are available directly
+template<class InterpolationType, typename floating_t=float>
+class SlidingWindowUniformCRSpline final : public __SlidingWindowSplinePrivate::SlidingWindowSpline<
+        __SlidingWindowSplinePrivate::UniformCRMath<InterpolationType, floating_t>, InterpolationType, floating_t>
+{
+public:
+    SlidingWindowUniformCRSpline(size_t capacity, floating_t sampleInterval = 1, floating_t startTime = 0)
+        :__SlidingWindowSplinePrivate::SlidingWindowSpline<__SlidingWindowSplinePrivate::UniformCRMath<InterpolationType, floating_t>, InterpolationType, floating_t>(
+             capacity, sampleInterval, startTime)
+    {}
+
+    //the spline needs the point after a segment to know the tangent at the segment's end, so the newest point's segment only appears once the next point arrives
+    //getMaxT() lags one sample interval behind the newest point
+    inline void push(const InterpolationType &point) { this->pushPoint(point); }
+
+    //ArcLength takes any class with the spline interface, so these forward to it directly, measuring between window t values
+    inline floating_t arcLength(floating_t a, floating_t b) const { return ArcLength::arcLength(*this, a, b); }
+    inline floating_t totalLength(void) const { return arcLength(this->getMinT(), this->getMaxT()); }
+};
+
+//the tangents are given explicitly, with respect to t, so every segment is available as soon as the point at its end is pushed
+template<class InterpolationType, typename floating_t=float>
+class SlidingWindowCubicHermiteSpline final : public __SlidingWindowSplinePrivate::SlidingWindowSpline<
+        __SlidingWindowSplinePrivate::CubicHermiteMath<InterpolationType, floating_t>, InterpolationType, floating_t>
+{
+public:
+    SlidingWindowCubicHermiteSpline(size_t capacity, floating_t sampleInterval = 1, floating_t startTime = 0)
+        :__SlidingWindowSplinePrivate::SlidingWindowSpline<__SlidingWindowSplinePrivate::CubicHermiteMath<InterpolationType, floating_t>, InterpolationType, floating_t>(
+             capacity, sampleInterval, startTime)
+    {}
+
+    inline void push(const InterpolationType &point, const InterpolationType &tangent) { this->pushPoint({point, tangent}); }
+
+    //see SlidingWindowUniformCRSpline
+    inline floating_t arcLength(floating_t a, floating_t b) const { return ArcLength::arcLength(*this, a, b); }
+    inline floating_t totalLength(void) const { return arcLength(this->getMinT(), this->getMaxT()); }
+};
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <cassert>
+#include <array>
 
 #include "../spline.h"
 
@@ -12,7 +13,24 @@ public:
     inline UniformCRSplineCommon(void) = default;
     inline UniformCRSplineCommon(std::vector<InterpolationType> points)
         :points(std::move(points))
-    {}
+    {
+        finishBuild();
+    }
+
+    //direct access to the points, for rebuilding a spline in place. call finishBuild afterwards
+    inline std::vector<InterpolationType> &editPoints(void) { return points; }
+
+    //resize and recompute the cached squared speeds, after the points were replaced
+    inline void finishBuild(void)
+    {
+        squaredSpeeds.resize(segmentCount());
+        for(size_t i = 0; i < segmentCount(); i++)
+        {
+            //the tangent is a quadratic, so its taylor series at the beginning of the segment is exact
+            std::array<InterpolationType, 3> tangent = {{computeTangent(points, i, 0), computeCurvature(points, i, 0), computeWiggle(points, i) / floating_t(2)}};
+            SplineCommon::computeSquaredSpeed(tangent.data(), tangent.size(), squaredSpeeds[i].data());
+        }
+    }
 
     inline size_t segmentCount(void) const
     {
@@ -39,88 +57,162 @@ public:
 
     inline InterpolationType getPosition(floating_t globalT) const
     {
-        size_t segmentIndex = segmentForT(globalT);
+        return positionInSegment(segmentForT(globalT), globalT);
+    }
+
+    inline typename Spline<InterpolationType,floating_t>::InterpolatedPT getTangent(floating_t globalT) const
+    {
+        return tangentInSegment(segmentForT(globalT), globalT);
+    }
+
+    inline typename Spline<InterpolationType,floating_t>::InterpolatedPTC getCurvature(floating_t globalT) const
+    {
+        return curvatureInSegment(segmentForT(globalT), globalT);
+    }
+
+    inline typename Spline<InterpolationType,floating_t>::InterpolatedPTCW getWiggle(floating_t globalT) const
+    {
+        return wiggleInSegment(segmentForT(globalT), globalT);
+    }
+
+    inline void getPositions(const floating_t *tValues, size_t count, InterpolationType *output) const
+    {
+        size_t segmentIndex = 0;
+        for(size_t i = 0; i < count; i++)
+        {
+            segmentIndex = SplineCommon::segmentForTWithHint(*this, tValues[i], segmentIndex);
+            output[i] = positionInSegment(segmentIndex, tValues[i]);
+        }
+    }
+
+    inline void getTangents(const floating_t *tValues, size_t count, typename Spline<InterpolationType,floating_t>::InterpolatedPT *output) const
+    {
+        size_t segmentIndex = 0;
+        for(size_t i = 0; i < count; i++)
+        {
+            segmentIndex = SplineCommon::segmentForTWithHint(*this, tValues[i], segmentIndex);
+            output[i] = tangentInSegment(segmentIndex, tValues[i]);
+        }
+    }
+
+    inline void getCurvatures(const floating_t *tValues, size_t count, typename Spline<InterpolationType,floating_t>::InterpolatedPTC *output) const
+    {
+        size_t segmentIndex = 0;
+        for(size_t i = 0; i < count; i++)
+        {
+            segmentIndex = SplineCommon::segmentForTWithHint(*this, tValues[i], segmentIndex);
+            output[i] = curvatureInSegment(segmentIndex, tValues[i]);
+        }
+    }
+
+    inline void getWiggles(const floating_t *tValues, size_t count, typename Spline<InterpolationType,floating_t>::InterpolatedPTCW *output) const
+    {
+        size_t segmentIndex = 0;
+        for(size_t i = 0; i < count; i++)
+        {
+            segmentIndex = SplineCommon::segmentForTWithHint(*this, tValues[i], segmentIndex);
+            output[i] = wiggleInSegment(segmentIndex, tValues[i]);
+        }
+    }
+
+    inline floating_t segmentLength(size_t index, floating_t a, floating_t b, const SplineLibraryCalculus::QuadratureSettings<floating_t> &quadrature) const
+    {
+        const auto &squaredSpeed = squaredSpeeds[index];
+        auto segmentFunction = [&squaredSpeed](floating_t t) -> floating_t {
+            return SplineCommon::evaluateSpeed(squaredSpeed.data(), squaredSpeed.size(), t);
+        };
+
+        floating_t localA = a - index;
+        floating_t localB = b - index;
+
+        return SplineLibraryCalculus::integrate<floating_t>(segmentFunction, localA, localB, quadrature);
+    }
+
+
+    //the points this core keeps a copy of, in order, including any that a looping spline repeated. used to rebuild a spline's original points after they've been discarded
+    inline size_t storedPointCount(void) const { return points.size(); }
+    inline const InterpolationType &storedPoint(size_t index) const { return points[index]; }
+
+    //the number of bytes this core has allocated
+    inline size_t heapFootprint(void) const
+    {
+        return SplineCommon::vectorFootprint(points) + SplineCommon::vectorFootprint(squaredSpeeds);
+    }
+
+
+    //these skip the segment search, for callers that already know which segment globalT is in
+    inline InterpolationType positionInSegment(size_t segmentIndex, floating_t globalT) const
+    {
         floating_t localT = globalT - segmentIndex;
 
-        return computePosition(segmentIndex + 1, localT);
+        return computePosition(points, segmentIndex, localT);
     }
 
-    inline typename Spline<InterpolationType,floating_t>::InterpolatedPT getTangent(floating_t globalT) const
+    inline typename Spline<InterpolationType,floating_t>::InterpolatedPT tangentInSegment(size_t segmentIndex, floating_t globalT) const
     {
-        size_t segmentIndex = segmentForT(globalT);
         floating_t localT = globalT - segmentIndex;
 
         return typename Spline<InterpolationType,floating_t>::InterpolatedPT(
-                    computePosition(segmentIndex + 1, localT),
-                    computeTangent(segmentIndex + 1, localT)
+                    computePosition(points, segmentIndex, localT),
+                    computeTangent(points, segmentIndex, localT)
                     );
     }
 
-    inline typename Spline<InterpolationType,floating_t>::InterpolatedPTC getCurvature(floating_t globalT) const
+    inline typename Spline<InterpolationType,floating_t>::InterpolatedPTC curvatureInSegment(size_t segmentIndex, floating_t globalT) const
     {
-        size_t segmentIndex = segmentForT(globalT);
         floating_t localT = globalT - segmentIndex;
 
         return typename Spline<InterpolationType,floating_t>::InterpolatedPTC(
-                    computePosition(segmentIndex + 1, localT),
-                    computeTangent(segmentIndex + 1, localT),
-                    computeCurvature(segmentIndex + 1, localT)
+                    computePosition(points, segmentIndex, localT),
+                    computeTangent(points, segmentIndex, localT),
+                    computeCurvature(points, segmentIndex, localT)
                     );
     }
 
-    inline typename Spline<InterpolationType,floating_t>::InterpolatedPTCW getWiggle(floating_t globalT) const
+    inline typename Spline<InterpolationType,floating_t>::InterpolatedPTCW wiggleInSegment(size_t segmentIndex, floating_t globalT) const
     {
-        size_t segmentIndex = segmentForT(globalT);
         floating_t localT = globalT - segmentIndex;
 
         return typename Spline<InterpolationType,floating_t>::InterpolatedPTCW(
-                    computePosition(segmentIndex + 1, localT),
-                    computeTangent(segmentIndex + 1, localT),
-                    computeCurvature(segmentIndex + 1, localT),
-                    computeWiggle(segmentIndex + 1)
+                    computePosition(points, segmentIndex, localT),
+                    computeTangent(points, segmentIndex, localT),
+                    computeCurvature(points, segmentIndex, localT),
+                    computeWiggle(points, segmentIndex)
                     );
     }
 
-    inline floating_t segmentLength(size_t index, floating_t a, floating_t b) const
-    {
-        auto segmentFunction = [this, index](floating_t t) -> floating_t {
-            auto tangent = computeTangent(index + 1, t);
-            return tangent.length();
-        };
-
-        floating_t localA = a - index;
-        floating_t localB = b - index;
-
-        return SplineLibraryCalculus::gaussLegendreQuadratureIntegral<floating_t>(segmentFunction, localA, localB);
-    }
-
-
-private: //methods
-    inline InterpolationType computePosition(size_t index, floating_t t) const
+    //the math behind the functions above, as functions of any random-access list of points, so that FixedUniformCRSpline can share it
+    //these are constexpr whenever InterpolationType's arithmetic is
+    template<class PointList>
+    static constexpr InterpolationType computePosition(const PointList &points, size_t segmentIndex, floating_t t)
     {
-        auto beforeTangent = computeTangentAtIndex(index);
-        auto afterTangent = computeTangentAtIndex(index + 1);
+        size_t index = segmentIndex + 1;
+        auto beforeTangent = computeTangentAtIndex(points, index);
+        auto afterTangent = computeTangentAtIndex(points, index + 1);
 
         auto oneMinusT = 1 - t;
 
-        auto basis00 = (1 + 2*t) * oneMinusT * oneMinusT;
         auto basis10 = t * oneMinusT * oneMinusT;
 
         auto basis11 = t * t * -oneMinusT;
         auto basis01 = t * t * (3 - 2*t);
 
+        //the basis functions of the two positions always sum to 1, and their derivatives to 0, so apply them to the displacement from the first position,
+        //rather than to each position, so that points far from the origin don't lose precision to cancellation
         return
-                basis00 * points[index] +
+                points[index] +
                 basis10 * beforeTangent +
 
                 basis11 * afterTangent +
-                basis01 * points[index + 1];
+                basis01 * (points[index + 1] - points[index]);
     }
 
-    inline InterpolationType computeTangent(size_t index, floating_t t) const
+    template<class PointList>
+    static constexpr InterpolationType computeTangent(const PointList &points, size_t segmentIndex, floating_t t)
     {
-        auto beforeTangent = computeTangentAtIndex(index);
-        auto afterTangent = computeTangentAtIndex(index + 1);
+        size_t index = segmentIndex + 1;
+        auto beforeTangent = computeTangentAtIndex(points, index);
+        auto afterTangent = computeTangentAtIndex(points, index + 1);
 
         auto oneMinusT = 1 - t;
 
@@ -134,17 +226,18 @@ private: //methods
         //intuitively it would just be the derivative of the position function and nothing else
         //if you know why please let me know
         return
-                d_basis00 * points[index] +
                 d_basis10 * beforeTangent +
 
                 d_basis11 * afterTangent +
-                d_basis01 * points[index + 1];
+                d_basis01 * (points[index + 1] - points[index]);
     }
 
-    inline InterpolationType computeCurvature(size_t index, floating_t t) const
+    template<class PointList>
+    static constexpr InterpolationType computeCurvature(const PointList &points, size_t segmentIndex, floating_t t)
     {
-        auto beforeTangent = computeTangentAtIndex(index);
-        auto afterTangent = computeTangentAtIndex(index + 1);
+        size_t index = segmentIndex + 1;
+        auto beforeTangent = computeTangentAtIndex(points, index);
+        auto afterTangent = computeTangentAtIndex(points, index + 1);
 
         auto d2_basis00 = 6 * (2 * t - 1);
         auto d2_basis10 = 2 * (3 * t - 2);
@@ -156,17 +249,18 @@ private: //methods
         //intuitively it would just be the 2nd derivative of the position function and nothing else
         //if you know why please let me know
         return
-                d2_basis00 * points[index] +
                 d2_basis10 * beforeTangent +
 
                 d2_basis11 * afterTangent +
-                d2_basis01 * points[index + 1];
+                d2_basis01 * (points[index + 1] - points[index]);
     }
 
-    inline InterpolationType computeWiggle(size_t index) const
+    template<class PointList>
+    static constexpr InterpolationType computeWiggle(const PointList &points, size_t segmentIndex)
     {
-        auto beforeTangent = computeTangentAtIndex(index);
-        auto afterTangent = computeTangentAtIndex(index + 1);
+        size_t index = segmentIndex + 1;
+        auto beforeTangent = computeTangentAtIndex(points, index);
+        auto afterTangent = computeTangentAtIndex(points, index + 1);
 
         //tests and such have shown that we have to scale this by the inverse of the t distance, and i'm not sure why
         //intuitively it would just be the 2nd derivative of the position function and nothing else
@@ -174,13 +268,18 @@ private: //methods
         return floating_t(12) * (points[index] - points[index + 1]) + floating_t(6) * (beforeTangent + afterTangent);
     }
 
-    inline InterpolationType computeTangentAtIndex(size_t i) const
+private: //methods
+    template<class PointList>
+    static constexpr InterpolationType computeTangentAtIndex(const PointList &points, size_t i)
     {
         return (points[i + 1] - points[i - 1]) / floating_t(2);
     }
 
 private: //data
     std::vector<InterpolationType> points;
+
+    //for each segment, the squared length of the tangent as a polynomial of local t, so that arc length integrands don't need the tangent
+    std::vector<std::array<floating_t, 5>> squaredSpeeds;
 };
 
 
@@ -198,6 +297,24 @@ public:
 
         common = UniformCRSplineCommon<InterpolationType, floating_t>(points);
     }
+
+    //replace this spline with the one the constructor would build from the given points, reusing this spline's memory
+    //as long as there are no more points than the last time, nothing is allocated
+    inline void rebuild(const std::vector<InterpolationType> &points)
+    {
+        assert(points.size() >= 4);
+
+        this->replaceOriginalPoints(points, floating_t(points.size() - 3));
+        this->common.editPoints().assign(points.begin(), points.end());
+        this->common.finishBuild();
+    }
+
+    bool reconstructOriginalPoints(std::vector<InterpolationType> &output) const override
+    {
+        //the core keeps every point unchanged
+        SplineCommon::copyStoredPoints(this->common, 0, this->common.storedPointCount(), output);
+        return true;
+    }
 };
 
 
@@ -208,11 +325,27 @@ class LoopingUniformCRSpline final : public SplineLoopingImpl<UniformCRSplineCom
 public:
     LoopingUniformCRSpline(const std::vector<InterpolationType> &points)
         :SplineLoopingImpl<UniformCRSplineCommon, InterpolationType,floating_t>(points, points.size())
+    {
+        build(points);
+    }
+
+    //replace this spline with the one the constructor would build from the given points, reusing this spline's memory
+    //as long as there are no more points than the last time, nothing is allocated
+    inline void rebuild(const std::vector<InterpolationType> &points)
+    {
+        this->replaceOriginalPoints(points, floating_t(points.size()));
+        build(points);
+    }
+
+private:
+    //fill the core's points, for the constructor and rebuild
+    void build(const std::vector<InterpolationType> &points)
     {
         assert(points.size() >= 4);
 
         //we need enough space to repeat the last 'degree' elements
-        std::vector<InterpolationType> positions(points.size() + 3);
+        std::vector<InterpolationType> &positions = this->common.editPoints();
+        positions.resize(points.size() + 3);
 
         //it would be easiest to just copy the points vector to the position vector, then copy the first 'degree' elements again
         //this DOES work, but interpolation begins in the wrong place (ie getPosition(0) occurs at the wrong place on the spline)
@@ -222,6 +355,13 @@ public:
         std::copy(points.begin(), points.end(), positions.begin() + 1);
         std::copy_n(points.begin(), 2, positions.end() - 2);
 
-        common = UniformCRSplineCommon<InterpolationType, floating_t>(std::move(positions));
+        this->common.finishBuild();
+    }
+
+    bool reconstructOriginalPoints(std::vector<InterpolationType> &output) const override
+    {
+        //the core keeps the last point, then every point, then the first two again
+        SplineCommon::copyStoredPoints(this->common, 1, this->common.storedPointCount() - 3, output);
+        return true;
     }
 };
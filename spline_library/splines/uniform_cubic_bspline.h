@@ -1,6 +1,7 @@
 #pragma once
 
 #include <cassert>
+#include <array>
 
 #include "../spline.h"
 
@@ -12,7 +13,24 @@ public:
     inline UniformCubicBSplineCommon(void) = default;
     inline UniformCubicBSplineCommon(std::vector<InterpolationType> points)
         :points(std::move(points))
-    {}
+    {
+        finishBuild();
+    }
+
+    //direct access to the points, for rebuilding a spline in place. call finishBuild afterwards
+    inline std::vector<InterpolationType> &editPoints(void) { return points; }
+
+    //resize and recompute the cached squared speeds, after the points were replaced
+    inline void finishBuild(void)
+    {
+        squaredSpeeds.resize(segmentCount());
+        for(size_t i = 0; i < segmentCount(); i++)
+        {
+            //the tangent is a quadratic, so its taylor series at the beginning of the segment is exact
+            std::array<InterpolationType, 3> tangent = {{computeTangent(points, i, 0), computeCurvature(points, i, 0), computeWiggle(points, i) / floating_t(2)}};
+            SplineCommon::computeSquaredSpeed(tangent.data(), tangent.size(), squaredSpeeds[i].data());
+        }
+    }
 
     inline size_t segmentCount(void) const
     {
@@ -38,99 +56,174 @@ public:
 
     inline InterpolationType getPosition(floating_t globalT) const
     {
-        size_t segmentIndex = segmentForT(globalT);
+        return positionInSegment(segmentForT(globalT), globalT);
+    }
+
+    inline typename Spline<InterpolationType,floating_t>::InterpolatedPT getTangent(floating_t globalT) const
+    {
+        return tangentInSegment(segmentForT(globalT), globalT);
+    }
+
+    inline typename Spline<InterpolationType,floating_t>::InterpolatedPTC getCurvature(floating_t globalT) const
+    {
+        return curvatureInSegment(segmentForT(globalT), globalT);
+    }
+
+    inline typename Spline<InterpolationType,floating_t>::InterpolatedPTCW getWiggle(floating_t globalT) const
+    {
+        return wiggleInSegment(segmentForT(globalT), globalT);
+    }
+
+    inline void getPositions(const floating_t *tValues, size_t count, InterpolationType *output) const
+    {
+        size_t segmentIndex = 0;
+        for(size_t i = 0; i < count; i++)
+        {
+            segmentIndex = SplineCommon::segmentForTWithHint(*this, tValues[i], segmentIndex);
+            output[i] = positionInSegment(segmentIndex, tValues[i]);
+        }
+    }
+
+    inline void getTangents(const floating_t *tValues, size_t count, typename Spline<InterpolationType,floating_t>::InterpolatedPT *output) const
+    {
+        size_t segmentIndex = 0;
+        for(size_t i = 0; i < count; i++)
+        {
+            segmentIndex = SplineCommon::segmentForTWithHint(*this, tValues[i], segmentIndex);
+            output[i] = tangentInSegment(segmentIndex, tValues[i]);
+        }
+    }
+
+    inline void getCurvatures(const floating_t *tValues, size_t count, typename Spline<InterpolationType,floating_t>::InterpolatedPTC *output) const
+    {
+        size_t segmentIndex = 0;
+        for(size_t i = 0; i < count; i++)
+        {
+            segmentIndex = SplineCommon::segmentForTWithHint(*this, tValues[i], segmentIndex);
+            output[i] = curvatureInSegment(segmentIndex, tValues[i]);
+        }
+    }
+
+    inline void getWiggles(const floating_t *tValues, size_t count, typename Spline<InterpolationType,floating_t>::InterpolatedPTCW *output) const
+    {
+        size_t segmentIndex = 0;
+        for(size_t i = 0; i < count; i++)
+        {
+            segmentIndex = SplineCommon::segmentForTWithHint(*this, tValues[i], segmentIndex);
+            output[i] = wiggleInSegment(segmentIndex, tValues[i]);
+        }
+    }
+
+    inline floating_t segmentLength(size_t index, floating_t a, floating_t b, const SplineLibraryCalculus::QuadratureSettings<floating_t> &quadrature) const
+    {
+        const auto &squaredSpeed = squaredSpeeds[index];
+        auto segmentFunction = [&squaredSpeed](floating_t t) -> floating_t {
+            return SplineCommon::evaluateSpeed(squaredSpeed.data(), squaredSpeed.size(), t);
+        };
+
+        floating_t localA = a - index;
+        floating_t localB = b - index;
+
+        return SplineLibraryCalculus::integrate<floating_t>(segmentFunction, localA, localB, quadrature);
+    }
+
+    //the points this core keeps a copy of, in order, including any that a looping spline repeated. used to rebuild a spline's original points after they've been discarded
+    inline size_t storedPointCount(void) const { return points.size(); }
+    inline const InterpolationType &storedPoint(size_t index) const { return points[index]; }
+
+    //the number of bytes this core has allocated
+    inline size_t heapFootprint(void) const
+    {
+        return SplineCommon::vectorFootprint(points) + SplineCommon::vectorFootprint(squaredSpeeds);
+    }
+
+
+    //these skip the segment search, for callers that already know which segment globalT is in
+    inline InterpolationType positionInSegment(size_t segmentIndex, floating_t globalT) const
+    {
         floating_t localT = globalT - segmentIndex;
 
-        return computePosition(segmentIndex, localT);
+        return computePosition(points, segmentIndex, localT);
     }
 
-    inline typename Spline<InterpolationType,floating_t>::InterpolatedPT getTangent(floating_t globalT) const
+    inline typename Spline<InterpolationType,floating_t>::InterpolatedPT tangentInSegment(size_t segmentIndex, floating_t globalT) const
     {
-        size_t segmentIndex = segmentForT(globalT);
         floating_t localT = globalT - segmentIndex;
 
         return typename Spline<InterpolationType,floating_t>::InterpolatedPT(
-                    computePosition(segmentIndex, localT),
-                    computeTangent(segmentIndex, localT)
+                    computePosition(points, segmentIndex, localT),
+                    computeTangent(points, segmentIndex, localT)
                     );
     }
 
-    inline typename Spline<InterpolationType,floating_t>::InterpolatedPTC getCurvature(floating_t globalT) const
+    inline typename Spline<InterpolationType,floating_t>::InterpolatedPTC curvatureInSegment(size_t segmentIndex, floating_t globalT) const
     {
-        size_t segmentIndex = segmentForT(globalT);
         floating_t localT = globalT - segmentIndex;
 
         return typename Spline<InterpolationType,floating_t>::InterpolatedPTC(
-                    computePosition(segmentIndex, localT),
-                    computeTangent(segmentIndex, localT),
-                    computeCurvature(segmentIndex, localT)
+                    computePosition(points, segmentIndex, localT),
+                    computeTangent(points, segmentIndex, localT),
+                    computeCurvature(points, segmentIndex, localT)
                     );
     }
 
-    inline typename Spline<InterpolationType,floating_t>::InterpolatedPTCW getWiggle(floating_t globalT) const
+    inline typename Spline<InterpolationType,floating_t>::InterpolatedPTCW wiggleInSegment(size_t segmentIndex, floating_t globalT) const
     {
-        size_t segmentIndex = segmentForT(globalT);
         floating_t localT = globalT - segmentIndex;
 
         return typename Spline<InterpolationType,floating_t>::InterpolatedPTCW(
-                    computePosition(segmentIndex, localT),
-                    computeTangent(segmentIndex, localT),
-                    computeCurvature(segmentIndex, localT),
-                    computeWiggle(segmentIndex)
+                    computePosition(points, segmentIndex, localT),
+                    computeTangent(points, segmentIndex, localT),
+                    computeCurvature(points, segmentIndex, localT),
+                    computeWiggle(points, segmentIndex)
                     );
     }
 
-    inline floating_t segmentLength(size_t index, floating_t a, floating_t b) const
-    {
-        auto segmentFunction = [this, index](floating_t t) -> floating_t {
-            auto tangent = computeTangent(index, t);
-            return tangent.length();
-        };
-
-        floating_t localA = a - index;
-        floating_t localB = b - index;
-
-        return SplineLibraryCalculus::gaussLegendreQuadratureIntegral<floating_t>(segmentFunction, localA, localB);
-    }
-
-private: //methods
-    inline InterpolationType computePosition(size_t index, floating_t t) const
+    //the math behind the functions above, as functions of any random-access list of points, so that FixedUniformCubicBSpline can share it
+    //these are constexpr whenever InterpolationType's arithmetic is
+    template<class PointList>
+    static constexpr InterpolationType computePosition(const PointList &points, size_t index, floating_t t)
     {
-        return (
-                    points[index] * ((1 - t) * (1 - t) * (1 - t)) +
-                    points[index + 1] * (t * t * 3 * (t - 2) + 4) +
-                    points[index + 2] * (t * (t * (-3 * t + 3) + 3) + 1) +
-                    points[index + 3] * (t * t * t)
+        //the weights of the 4 points always sum to 6, and the weights of their derivatives to 0, so apply them to each point's displacement from points[index + 1]
+        //rather than to each point, so that points far from the origin don't lose precision to cancellation
+        return points[index + 1] + (
+                    (points[index] - points[index + 1]) * ((1 - t) * (1 - t) * (1 - t)) +
+                    (points[index + 2] - points[index + 1]) * (t * (t * (-3 * t + 3) + 3) + 1) +
+                    (points[index + 3] - points[index + 1]) * (t * t * t)
                 ) / floating_t(6);
     }
 
-    inline InterpolationType computeTangent(size_t index, floating_t t) const
+    template<class PointList>
+    static constexpr InterpolationType computeTangent(const PointList &points, size_t index, floating_t t)
     {
         return (
-                    points[index] * (-(1 - t) * (1 - t)) +
-                    points[index + 1] * (t * (3 * t - 4)) +
-                    points[index + 2] * ((3 * t + 1) * (1 - t)) +
-                    points[index + 3] * (t * t)
+                    (points[index] - points[index + 1]) * (-(1 - t) * (1 - t)) +
+                    (points[index + 2] - points[index + 1]) * ((3 * t + 1) * (1 - t)) +
+                    (points[index + 3] - points[index + 1]) * (t * t)
                 ) / floating_t(2);
     }
 
-    inline InterpolationType computeCurvature(size_t index, floating_t t) const
+    template<class PointList>
+    static constexpr InterpolationType computeCurvature(const PointList &points, size_t index, floating_t t)
     {
         return (
-                    points[index] * (1 - t) +
-                    points[index + 1] * (3 * t - 2) +
-                    points[index + 2] * (1 - 3 * t) +
-                    points[index + 3] * (t)
+                    (points[index] - points[index + 1]) * (1 - t) +
+                    (points[index + 2] - points[index + 1]) * (1 - 3 * t) +
+                    (points[index + 3] - points[index + 1]) * (t)
                 );
     }
 
-    inline InterpolationType computeWiggle(size_t index) const
+    template<class PointList>
+    static constexpr InterpolationType computeWiggle(const PointList &points, size_t index)
     {
         return floating_t(3) * (points[index + 1] - points[index + 2]) + (points[index + 3] - points[index]);
     }
 
 private: //data
     std::vector<InterpolationType> points;
+
+    //for each segment, the squared length of the tangent as a polynomial of local t, so that arc length integrands don't need the tangent
+    std::vector<std::array<floating_t, 5>> squaredSpeeds;
 };
 
 
@@ -147,6 +240,24 @@ public:
 
         common = UniformCubicBSplineCommon<InterpolationType, floating_t>(points);
     }
+
+    //replace this spline with the one the constructor would build from the given points, reusing this spline's memory
+    //as long as there are no more points than the last time, nothing is allocated
+    inline void rebuild(const std::vector<InterpolationType> &points)
+    {
+        assert(points.size() >= 4);
+
+        this->replaceOriginalPoints(points, floating_t(points.size() - 3));
+        this->common.editPoints().assign(points.begin(), points.end());
+        this->common.finishBuild();
+    }
+
+    bool reconstructOriginalPoints(std::vector<InterpolationType> &output) const override
+    {
+        //the core keeps every point unchanged
+        SplineCommon::copyStoredPoints(this->common, 0, this->common.storedPointCount(), output);
+        return true;
+    }
 };
 
 
@@ -157,13 +268,29 @@ class LoopingUniformCubicBSpline final : public SplineLoopingImpl<UniformCubicBS
 public:
     LoopingUniformCubicBSpline(const std::vector<InterpolationType> &points)
         :SplineLoopingImpl<UniformCubicBSplineCommon, InterpolationType,floating_t>(points, points.size())
+    {
+        build(points);
+    }
+
+    //replace this spline with the one the constructor would build from the given points, reusing this spline's memory
+    //as long as there are no more points than the last time, nothing is allocated
+    inline void rebuild(const std::vector<InterpolationType> &points)
+    {
+        this->replaceOriginalPoints(points, floating_t(points.size()));
+        build(points);
+    }
+
+private:
+    //fill the core's points, for the constructor and rebuild
+    void build(const std::vector<InterpolationType> &points)
     {
         size_t degree = 3;
 
         assert(points.size() >= degree);
 
         //we need enough space to repeat the last 'degree' elements
-        std::vector<InterpolationType> positions(points.size() + degree);
+        std::vector<InterpolationType> &positions = this->common.editPoints();
+        positions.resize(points.size() + degree);
 
         //it would be easiest to just copy the points vector to the position vector, then copy the first 'degree' elements again
         //this DOES work, but interpolation begins in the wrong place (ie getPosition(0) occurs at the wrong place on the spline)
@@ -173,6 +300,13 @@ public:
         std::copy(points.begin(), points.end(), positions.begin() + 1);
         std::copy_n(points.begin(), degree - 1, positions.end() - (degree - 1));
 
-        common = UniformCubicBSplineCommon<InterpolationType, floating_t>(positions);
+        this->common.finishBuild();
+    }
+
+    bool reconstructOriginalPoints(std::vector<InterpolationType> &output) const override
+    {
+        //the core keeps the last point, then every point, then the first two again
+        SplineCommon::copyStoredPoints(this->common, 1, this->common.storedPointCount() - 3, output);
+        return true;
     }
 };
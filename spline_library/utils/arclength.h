@@ -3,24 +3,32 @@
 #include <boost/math/tools/roots.hpp>
 
 #include "spline_common.h"
+#include "arclengthtable.h"
+#include "instrumentation.h"
 
 namespace __ArcLengthSolvePrivate
 {
-    //solve the arc length for a single spline segment
-    template<template <class, typename> class Spline, class InterpolationType, typename floating_t>
-    floating_t solveSegment(const Spline<InterpolationType, floating_t>& spline, size_t segmentIndex, floating_t desiredLength, floating_t maxLength, floating_t segmentA)
+    //solve the arc length for part of a single spline segment, where maxLength is the arc length from segmentA to bEnd, and the result is somewhere between them
+    template<class SplineT, typename floating_t = SplineCommon::SplineFloat<SplineT>>
+    floating_t solveSegmentRange(const SplineT& spline, size_t segmentIndex, SplineCommon::SplineFloat<SplineT> desiredLength, SplineCommon::SplineFloat<SplineT> maxLength,
+                                 SplineCommon::SplineFloat<SplineT> segmentA, SplineCommon::SplineFloat<SplineT> bEnd)
     {
+        typedef SplineCommon::SplineInterpolation<SplineT> InterpolationType;
+
+        SPLINE_LIBRARY_TIMED_SCOPE(ArcLengthSolves, 1);
+
         //we can use the lengths we've calculated to formulate a pretty solid guess
         //if desired length is x% of the bLength, then our guess will be x% of the way from aPercent to 1
         floating_t desiredPercent = desiredLength / maxLength;
-        floating_t bEnd = spline.segmentT(segmentIndex + 1);
         floating_t bGuess = segmentA + desiredPercent * (bEnd - segmentA);
 
         auto solveFunction = [&](floating_t b) {
+            //halley's method evaluates this once per iteration
+            SPLINE_LIBRARY_COUNT(HalleyIterations, 1);
             floating_t value = spline.segmentArcLength(segmentIndex, segmentA, b) - desiredLength;
 
             //the derivative will be the length of the tangent
-            auto interpolationResult = spline.getCurvature(b);
+            auto interpolationResult = spline.getCurvatureInSegment(segmentIndex, b);
             floating_t tangentLength = interpolationResult.tangent.length();
 
             //the second derivative will be the curvature projected onto the tangent
@@ -32,13 +40,44 @@ namespace __ArcLengthSolvePrivate
 
         return boost::math::tools::halley_iterate(solveFunction, bGuess, segmentA, bEnd, int(std::numeric_limits<floating_t>::digits * 0.5));
     }
+
+    //solve the arc length for a single spline segment, from segmentA to the end of the segment
+    template<class SplineT, typename floating_t = SplineCommon::SplineFloat<SplineT>>
+    floating_t solveSegment(const SplineT& spline, size_t segmentIndex, SplineCommon::SplineFloat<SplineT> desiredLength, SplineCommon::SplineFloat<SplineT> maxLength,
+                            SplineCommon::SplineFloat<SplineT> segmentA)
+    {
+        return solveSegmentRange(spline, segmentIndex, desiredLength, maxLength, segmentA, spline.segmentT(segmentIndex + 1));
+    }
+
+    //solve for the t value at the given arc length from the beginning of the spline, by looking up its segment in the table and solving within that segment
+    //every call is independent of every other call, so the partition functions get the same results no matter what order or thread their pieces are solved on
+    template<class InterpolationType, typename floating_t>
+    floating_t solveTableLength(const ArcLengthTable<InterpolationType, floating_t>& lengthTable, floating_t length)
+    {
+        const auto &spline = lengthTable.getSpline();
+
+        size_t segmentIndex = lengthTable.segmentForLength(length);
+        floating_t segmentLength = lengthTable.segmentLength(segmentIndex);
+        floating_t lengthIntoSegment = length - lengthTable.lengthBeforeSegment(segmentIndex);
+
+        //rounding in the cumulative lengths can put a length at the very end of the spline just past its last segment
+        if(lengthIntoSegment >= segmentLength)
+        {
+            return spline.segmentT(segmentIndex + 1);
+        }
+        return solveSegment(spline, segmentIndex, lengthIntoSegment, segmentLength, spline.segmentT(segmentIndex));
+    }
+
+    //number of piece boundaries a thread solves at a time in the multithreaded partition functions
+    //each boundary takes several segment integrations, so this can be smaller than the ArcLengthTable's chunk size
+    const size_t partitionChunkSize = 64;
 }
 
 namespace ArcLength
 {
     //compute b such that arcLength(a,b) == desiredLength
-    template<template <class, typename> class SplineT, class InterpolationType, typename floating_t>
-    floating_t solveLength(const SplineT<InterpolationType, floating_t>& spline, floating_t a, floating_t desiredLength)
+    template<class SplineT, typename floating_t = SplineCommon::SplineFloat<SplineT>>
+    floating_t solveLength(const SplineT& spline, SplineCommon::SplineFloat<SplineT> a, SplineCommon::SplineFloat<SplineT> desiredLength)
     {
         size_t index = spline.segmentForT(a);
 
@@ -74,8 +113,8 @@ namespace ArcLength
 
     //compute b such that cyclicArcLength(a,b) == desiredLength, respecting the cyclic semantics of a looping spline
     //IE, a can be out of range, if desiredLength is totalLength*2 + 1, the result will be equal to solveCyclic(a,1) + maxT*2
-    template<template <class, typename> class LoopingSplineT, class InterpolationType, typename floating_t>
-    floating_t solveLengthCyclic(const LoopingSplineT<InterpolationType, floating_t>& spline, floating_t a, floating_t desiredLength)
+    template<class LoopingSplineT, typename floating_t = SplineCommon::SplineFloat<LoopingSplineT>>
+    floating_t solveLengthCyclic(const LoopingSplineT& spline, SplineCommon::SplineFloat<LoopingSplineT> a, SplineCommon::SplineFloat<LoopingSplineT> desiredLength)
     {
         size_t index = spline.segmentForT(a);
 
@@ -108,97 +147,58 @@ namespace ArcLength
     //returns a list of t values marking the boundaries of each piece
     //the first entry is always 0. the final entry is the T value that marks the end of the last cleanly-dividible piece
     //The remainder that could not be divided is the piece between the last entry and maxT
-    template<template <class, typename> class Spline, class InterpolationType, typename floating_t>
-    std::vector<floating_t> partition(const Spline<InterpolationType, floating_t>& spline, floating_t lengthPerPiece)
+    //this version uses a precomputed table of segment lengths, so that repeated partitions of the same spline don't re-integrate every segment
+    //the piece boundaries are solved across threadCount threads, or one thread per hardware thread if threadCount is 0. the result doesn't depend on the thread count
+    template<class InterpolationType, typename floating_t>
+    std::vector<floating_t> partition(const ArcLengthTable<InterpolationType, floating_t>& lengthTable, floating_t lengthPerPiece, size_t threadCount = 1)
     {
-        //first, compute total arc length and arc length for each segment
-        std::vector<floating_t> segmentLengths(spline.segmentCount());
-        floating_t totalArcLength(0);
-        for(size_t i = 0; i < spline.segmentCount(); i++)
-        {
-            floating_t segmentLength = spline.segmentArcLength(i, spline.segmentT(i), spline.segmentT(i+1));
-            totalArcLength += segmentLength;
-            segmentLengths[i] = segmentLength;
-        }
-
-        size_t n = size_t(totalArcLength / lengthPerPiece) + 1;
+        size_t n = size_t(lengthTable.totalLength() / lengthPerPiece) + 1;
         std::vector<floating_t> pieces(n);
 
-        //set up the inter-piece state
-        floating_t segmentRemainder = segmentLengths[0];
-        size_t segmentIndex = 0;
-
-        //for each piece, perform the same algorithm as the "solve" method, except re-use work between segments by referring to the segmentLengths array
-        for(size_t i = 1; i < n; i++)
-        {
-            floating_t desiredLength = lengthPerPiece;
-            floating_t segmentBegin = pieces[i - 1];
-
-            //if the segment length is less than desiredLength, B will be in a different segment than A, so search though the spline until we find B's segment
-            while(segmentRemainder < desiredLength)
-            {
-                segmentIndex++;
-                desiredLength -= segmentRemainder;
-                segmentRemainder = segmentLengths[segmentIndex];
-                segmentBegin = spline.segmentT(segmentIndex);
-            }
-
-            //we've found the segment that b lies in, so solve for the remaining arc length within this segment
-            pieces[i] = __ArcLengthSolvePrivate::solveSegment(spline, segmentIndex, desiredLength, segmentRemainder, segmentBegin);
-
-            //set up the next iteration of the loop
-            segmentRemainder = segmentRemainder - desiredLength;
-        }
+        //once the table knows where every segment begins, each boundary only depends on its own length from the beginning of the spline
+        SplineCommon::parallelFor(n - 1, __ArcLengthSolvePrivate::partitionChunkSize, threadCount, [&](size_t i) {
+            pieces[i + 1] = __ArcLengthSolvePrivate::solveTableLength(lengthTable, lengthPerPiece * (i + 1));
+        });
         return pieces;
     }
 
+    //subdivide the spline into pieces such that the arc length of each pieces is equal to desiredLength
+    //see the ArcLengthTable overload above. if you partition the same spline more than once, build an ArcLengthTable and use that instead
+    //threadCount is used both for building the table and for solving the piece boundaries
+    template<class SplineT, typename floating_t = SplineCommon::SplineFloat<SplineT>>
+    std::vector<floating_t> partition(const SplineT& spline, SplineCommon::SplineFloat<SplineT> lengthPerPiece, size_t threadCount = 1)
+    {
+        return partition(ArcLengthTable<SplineCommon::SplineInterpolation<SplineT>, floating_t>(spline, threadCount), lengthPerPiece, threadCount);
+    }
+
     //subdivide the spline into N pieces such that each piece has the same arc length
     //returns a list of N+1 T values, where return[i] is the T value of the beginning of a piece and return[i+1] is the T value of the end of a piece
     //the first element in the returned list is always 0, and the last element is always spline.getMaxT()
-    template<template <class, typename> class Spline, class InterpolationType, typename floating_t>
-    std::vector<floating_t> partitionN(const Spline<InterpolationType, floating_t>& spline, size_t n)
+    //this version uses a precomputed table of segment lengths, so that repeated partitions of the same spline don't re-integrate every segment
+    //the piece boundaries are solved across threadCount threads, or one thread per hardware thread if threadCount is 0. the result doesn't depend on the thread count
+    template<class InterpolationType, typename floating_t>
+    std::vector<floating_t> partitionN(const ArcLengthTable<InterpolationType, floating_t>& lengthTable, size_t n, size_t threadCount = 1)
     {
-        //first, compute total arc length and arc length for each segment
-        std::vector<floating_t> segmentLengths(spline.segmentCount());
-        floating_t totalArcLength(0);
-        for(size_t i = 0; i < spline.segmentCount(); i++)
-        {
-            floating_t segmentLength = spline.segmentArcLength(i, spline.segmentT(i), spline.segmentT(i+1));
-            totalArcLength += segmentLength;
-            segmentLengths[i] = segmentLength;
-        }
-        const floating_t lengthPerPiece = totalArcLength / n;
+        const floating_t lengthPerPiece = lengthTable.totalLength() / n;
 
         //set up the result vector
         std::vector<floating_t> pieces(n + 1);
 
-        //set up the inter-piece state
-        floating_t segmentRemainder = segmentLengths[0];
-        size_t segmentIndex = 0;
-
-        //for each piece, perform the same algorithm as the "solve" method, except re-use work between segments by referring to the segmentLengths array
-        for(size_t i = 1; i < n; i++)
-        {
-            floating_t desiredLength = lengthPerPiece;
-            floating_t segmentBegin = pieces[i - 1];
+        //the first and last boundaries are already known, so there are n - 1 left to solve
+        SplineCommon::parallelFor(n > 0 ? n - 1 : 0, __ArcLengthSolvePrivate::partitionChunkSize, threadCount, [&](size_t i) {
+            pieces[i + 1] = __ArcLengthSolvePrivate::solveTableLength(lengthTable, lengthPerPiece * (i + 1));
+        });
 
-            //if the segment length is less than desiredLength, B will be in a different segment than A, so search though the spline until we find B's segment
-            while(segmentRemainder < desiredLength)
-            {
-                segmentIndex++;
-                desiredLength -= segmentRemainder;
-                segmentRemainder = segmentLengths[segmentIndex];
-                segmentBegin = spline.segmentT(segmentIndex);
-            }
-
-            //we've found the segment that b lies in, so solve for the remaining arc length within this segment
-            pieces[i] = __ArcLengthSolvePrivate::solveSegment(spline, segmentIndex, desiredLength, segmentRemainder, segmentBegin);
-
-            //set up the next iteration of the loop
-            segmentRemainder = segmentRemainder - desiredLength;
-        }
-
-        pieces[n] = spline.getMaxT();
+        pieces[n] = lengthTable.getSpline().getMaxT();
         return pieces;
     }
+
+    //subdivide the spline into N pieces such that each piece has the same arc length
+    //see the ArcLengthTable overload above. if you partition the same spline more than once, build an ArcLengthTable and use that instead
+    //threadCount is used both for building the table and for solving the piece boundaries
+    template<class SplineT, typename floating_t = SplineCommon::SplineFloat<SplineT>>
+    std::vector<floating_t> partitionN(const SplineT& spline, size_t n, size_t threadCount = 1)
+    {
+        return partitionN(ArcLengthTable<SplineCommon::SplineInterpolation<SplineT>, floating_t>(spline, threadCount), n, threadCount);
+    }
 }
@@ -0,0 +1,273 @@
+#pragma once
+
+#include <vector>
+#include <algorithm>
+#include <cmath>
+#include <cassert>
+
+#include "../spline.h"
+#include "arclength.h"
+#include "arclengthtable.h"
+
+template<class InterpolationType, typename floating_t=float>
+class ArcLengthParameterization
+{
+public:
+    //approximate t(s) for the given spline, splitting it into pieces until the approximated t value is within "tolerance" arc length of the exact t value at each piece's check points
+    //the check points are a sample, not a bound, and a piece that's still off after maxDepth splits is kept anyway, so see measuredMaxError() for the error that was actually seen
+    ArcLengthParameterization(const Spline<InterpolationType, floating_t> &spline, floating_t tolerance = 0.001);
+
+    //compute the t value that is the given distance along the spline from t = 0, using the precomputed approximation
+    //distances outside [0, totalLength()] are clamped to 0 and maxT respectively
+    floating_t solveT(floating_t distance) const;
+
+    //same as solveT, but uses the precomputed table only to find the correct segment, and then solves for t within that segment numerically
+    //this is much slower than solveT, but is accurate to floating point precision instead of the tolerance
+    floating_t solveTExact(floating_t distance) const;
+
+    //compute solveT, but using wrapping/cyclic logic. IE if distance is totalLength*2 + 1, the result will be solveT(1) + maxT*2
+    //for cyclic splines only!
+    floating_t solveTCyclic(floating_t distance) const;
+
+    inline InterpolationType getPosition(floating_t distance) const { return spline.getPosition(solveT(distance)); }
+    inline InterpolationType getPositionCyclic(floating_t distance) const { return spline.getPosition(solveTCyclic(distance)); }
+
+    inline floating_t totalLength(void) const { return lengthTable.totalLength(); }
+    inline floating_t getTolerance(void) const { return tolerance; }
+
+    //the largest arc length error measured at any piece's check points. this is usually at most the tolerance, but it can be larger if a piece hit the split limit
+    //it's a sampled estimate: distances between the check points can be off by a little more
+    inline floating_t measuredMaxError(void) const { return maxMeasuredError; }
+
+    //number of polynomial pieces the approximation was split into
+    inline size_t pieceCount(void) const { return pieces.size(); }
+
+    inline const ArcLengthTable<InterpolationType, floating_t> &getLengthTable(void) const { return lengthTable; }
+    inline const Spline<InterpolationType, floating_t> &getSpline(void) const { return spline; }
+
+private: //types
+    //t is approximated within each piece by a cubic polynomial in u, where u is the fraction of the way through the piece by arc length
+    struct Piece
+    {
+        floating_t inverseLength;
+        floating_t c0, c1, c2, c3;
+
+        inline floating_t evaluate(floating_t u) const { return c0 + u * (c1 + u * (c2 + u * c3)); }
+    };
+
+    //a sample of t and dt/ds at a single point in a segment, where s is arc length from the beginning of the segment
+    struct Sample
+    {
+        floating_t t, s, tPerLength;
+    };
+
+private: //methods
+    Sample makeSample(size_t segmentIndex, floating_t segmentBegin, floating_t t) const;
+    static Piece makePiece(const Sample &begin, const Sample &end);
+
+    void buildSegment(size_t segmentIndex, floating_t segmentLengthBegin, const Sample &begin, const Sample &end, int depth);
+
+private: //data
+    const Spline<InterpolationType, floating_t> &spline;
+    ArcLengthTable<InterpolationType, floating_t> lengthTable;
+
+    floating_t tolerance;
+    floating_t maxMeasuredError;
+
+    //pieceBegins[i] is the arc length from the beginning of the spline to the beginning of pieces[i]
+    //they're kept apart from the pieces themselves so that the binary search only touches the data it compares
+    std::vector<floating_t> pieceBegins;
+    std::vector<Piece> pieces;
+
+    //each split halves the piece in t, so this is plenty of room for any reasonable tolerance
+    static const int maxDepth = 16;
+};
+
+template<class InterpolationType, typename floating_t>
+ArcLengthParameterization<InterpolationType, floating_t>::ArcLengthParameterization(const Spline<InterpolationType, floating_t> &spline, floating_t tolerance)
+    :spline(spline), lengthTable(spline), tolerance(tolerance), maxMeasuredError(0)
+{
+    assert(tolerance > 0);
+
+    for(size_t i = 0; i < spline.segmentCount(); i++)
+    {
+        //a segment with no length can never contain a distance, so leave it out entirely
+        if(lengthTable.segmentLength(i) <= 0)
+        {
+            continue;
+        }
+
+        floating_t segmentBegin = spline.segmentT(i);
+        floating_t segmentEnd = spline.segmentT(i + 1);
+
+        Sample begin = makeSample(i, segmentBegin, segmentBegin);
+        Sample end = makeSample(i, segmentBegin, segmentEnd);
+
+        //use the length from the table for the end of the segment, so that adjacent segments line up exactly
+        begin.s = 0;
+        end.s = lengthTable.segmentLength(i);
+
+        buildSegment(i, lengthTable.lengthBeforeSegment(i), begin, end, 0);
+    }
+}
+
+template<class InterpolationType, typename floating_t>
+floating_t ArcLengthParameterization<InterpolationType, floating_t>::solveT(floating_t distance) const
+{
+    if(distance <= 0 || pieces.empty())
+    {
+        return 0;
+    }
+    if(distance >= totalLength())
+    {
+        return spline.getMaxT();
+    }
+
+    //find the last piece whose beginning is <= distance
+    size_t pieceIndex = std::distance(pieceBegins.cbegin(), std::upper_bound(pieceBegins.cbegin() + 1, pieceBegins.cend(), distance)) - 1;
+
+    const Piece &piece = pieces[pieceIndex];
+    floating_t u = std::min(floating_t(1), (distance - pieceBegins[pieceIndex]) * piece.inverseLength);
+    return piece.evaluate(u);
+}
+
+template<class InterpolationType, typename floating_t>
+floating_t ArcLengthParameterization<InterpolationType, floating_t>::solveTExact(floating_t distance) const
+{
+    if(distance <= 0)
+    {
+        return 0;
+    }
+    if(distance >= totalLength())
+    {
+        return spline.getMaxT();
+    }
+
+    size_t segmentIndex = lengthTable.segmentForLength(distance);
+    floating_t desiredLength = distance - lengthTable.lengthBeforeSegment(segmentIndex);
+
+    return __ArcLengthSolvePrivate::solveSegment(spline, segmentIndex, desiredLength, lengthTable.segmentLength(segmentIndex), spline.segmentT(segmentIndex));
+}
+
+template<class InterpolationType, typename floating_t>
+floating_t ArcLengthParameterization<InterpolationType, floating_t>::solveTCyclic(floating_t distance) const
+{
+    assert(spline.isLooping());
+
+    //with no length there's nothing to wrap, and dividing by the length would give nan. clamp like solveT does
+    if(totalLength() <= 0)
+    {
+        return 0;
+    }
+
+    floating_t numCycles = std::floor(distance / totalLength());
+    return solveT(distance - numCycles * totalLength()) + numCycles * spline.getMaxT();
+}
+
+template<class InterpolationType, typename floating_t>
+typename ArcLengthParameterization<InterpolationType, floating_t>::Sample
+    ArcLengthParameterization<InterpolationType, floating_t>::makeSample(size_t segmentIndex, floating_t segmentBegin, floating_t t) const
+{
+    floating_t s = spline.segmentArcLength(segmentIndex, segmentBegin, t);
+
+    //dt/ds is the reciprocal of the speed. if the speed is zero, leave it at zero and let makePiece pick a finite slope
+    floating_t speed = spline.getTangent(t).tangent.length();
+    floating_t tPerLength = speed > 0 ? 1 / speed : 0;
+
+    return Sample{t, s, tPerLength};
+}
+
+template<class InterpolationType, typename floating_t>
+typename ArcLengthParameterization<InterpolationType, floating_t>::Piece
+    ArcLengthParameterization<InterpolationType, floating_t>::makePiece(const Sample &begin, const Sample &end)
+{
+    floating_t length = end.s - begin.s;
+    floating_t deltaT = end.t - begin.t;
+
+    //scale the slopes so that they're derivatives with respect to u instead of s
+    floating_t beginSlope = begin.tPerLength * length;
+    floating_t endSlope = end.tPerLength * length;
+
+    //zero speed means infinite dt/ds, so replace it with the steepest slope that still keeps the piece monotone
+    if(begin.tPerLength <= 0 || beginSlope > 3 * deltaT)
+    {
+        beginSlope = 3 * deltaT;
+    }
+    if(end.tPerLength <= 0 || endSlope > 3 * deltaT)
+    {
+        endSlope = 3 * deltaT;
+    }
+
+    //Fritsch-Carlson: if the slopes are too steep relative to the secant, scale them down so that t(s) is monotone within the piece
+    //this guarantees that the approximated t value never leaves [begin.t, end.t]
+    floating_t alpha = beginSlope / deltaT;
+    floating_t beta = endSlope / deltaT;
+    floating_t slopeMagnitude = alpha * alpha + beta * beta;
+    if(slopeMagnitude > 9)
+    {
+        floating_t scale = 3 / std::sqrt(slopeMagnitude);
+        beginSlope *= scale;
+        endSlope *= scale;
+    }
+
+    //convert the hermite form to power basis
+    Piece result;
+    result.inverseLength = 1 / length;
+    result.c0 = begin.t;
+    result.c1 = beginSlope;
+    result.c2 = 3 * deltaT - 2 * beginSlope - endSlope;
+    result.c3 = -2 * deltaT + beginSlope + endSlope;
+    return result;
+}
+
+template<class InterpolationType, typename floating_t>
+void ArcLengthParameterization<InterpolationType, floating_t>::buildSegment(size_t segmentIndex, floating_t segmentLengthBegin, const Sample &begin, const Sample &end, int depth)
+{
+    floating_t length = end.s - begin.s;
+    if(length <= 0)
+    {
+        return;
+    }
+
+    //if the arc length in this piece is already below the tolerance, no approximation can be off by more than the tolerance,
+    //because the piece is monotone and never leaves [begin.t, end.t]
+    Piece piece = makePiece(begin, end);
+    if(length <= tolerance)
+    {
+        pieceBegins.push_back(segmentLengthBegin + begin.s);
+        pieces.push_back(piece);
+        return;
+    }
+
+    floating_t segmentBegin = spline.segmentT(segmentIndex);
+
+    //check the approximation at a few points inside the piece. for each, see how far the approximated t is from the desired distance
+    //a piece at the split limit is kept no matter what, so measure all of its check points to know how far off it is
+    floating_t error = 0;
+    for(floating_t u : {floating_t(0.25), floating_t(0.5), floating_t(0.75)})
+    {
+        floating_t approximateT = piece.evaluate(u);
+        floating_t actualLength = spline.segmentArcLength(segmentIndex, segmentBegin, approximateT);
+        floating_t desiredLength = begin.s + u * length;
+
+        error = std::max(error, std::abs(actualLength - desiredLength));
+        if(error > tolerance && depth < maxDepth)
+        {
+            break;
+        }
+    }
+
+    if(error <= tolerance || depth >= maxDepth)
+    {
+        maxMeasuredError = std::max(maxMeasuredError, error);
+        pieceBegins.push_back(segmentLengthBegin + begin.s);
+        pieces.push_back(piece);
+    }
+    else
+    {
+        //split the piece in half by t and try again on each half
+        Sample middle = makeSample(segmentIndex, segmentBegin, (begin.t + end.t) / 2);
+        buildSegment(segmentIndex, segmentLengthBegin, begin, middle, depth + 1);
+        buildSegment(segmentIndex, segmentLengthBegin, middle, end, depth + 1);
+    }
+}
@@ -0,0 +1,134 @@
+#pragma once
+
+#include <vector>
+#include <algorithm>
+#include <cassert>
+
+#include "../spline.h"
+#include "parallelfor.h"
+
+template<class InterpolationType, typename floating_t=float>
+class ArcLengthTable
+{
+public:
+    //the segments are integrated across threadCount threads. if threadCount is 0, use one thread per hardware thread
+    //the table is exactly the same no matter how many threads are used, and short splines are always integrated on the calling thread
+    ArcLengthTable(const Spline<InterpolationType, floating_t> &spline, size_t threadCount = 1);
+
+    //compute the arc length from a to b. same semantics as spline.arcLength, but only the segments containing a and b are integrated
+    //on a looping spline, a and b are wrapped into [0, maxT) first. on a non-looping spline, t values outside it extend the first and last segments, like the spline does
+    floating_t arcLength(floating_t a, floating_t b) const;
+
+    //compute the arc length from a to b, using wrapping/cyclic logic. same semantics as ArcLength::cyclicArcLength
+    //for cyclic splines only!
+    floating_t cyclicArcLength(floating_t a, floating_t b) const;
+
+    inline floating_t totalLength(void) const { return cumulativeLengths.back(); }
+
+    //arc length of the entire segment with the given index
+    inline floating_t segmentLength(size_t segmentIndex) const { return segmentLengths[segmentIndex]; }
+
+    //arc length from the beginning of the spline to the beginning of the given segment
+    //segmentIndex may be equal to segmentCount(), in which case this returns the total length
+    inline floating_t lengthBeforeSegment(size_t segmentIndex) const { return cumulativeLengths[segmentIndex]; }
+
+    //find the index of the segment that contains the given arc length, measured from the beginning of the spline
+    //lengths outside [0, totalLength()] are clamped to the first or last segment
+    size_t segmentForLength(floating_t length) const;
+
+    inline const Spline<InterpolationType, floating_t> &getSpline(void) const { return spline; }
+
+private: //data
+    const Spline<InterpolationType, floating_t> &spline;
+
+    //segmentLengths[i] is the length of segment i, and cumulativeLengths[i] is the sum of every segment length before i
+    //we keep both, rather than subtracting adjacent cumulative lengths, because subtracting two large sums to get a small one loses precision
+    std::vector<floating_t> segmentLengths;
+    std::vector<floating_t> cumulativeLengths;
+
+    bool looping;
+
+    //number of segments a thread integrates at a time when the table is built with more than one thread
+    //integrating a segment takes long enough that a chunk of this size is well worth the cost of starting a thread
+    static const size_t parallelChunkSize = 256;
+};
+
+template<class InterpolationType, typename floating_t>
+ArcLengthTable<InterpolationType, floating_t>::ArcLengthTable(const Spline<InterpolationType, floating_t> &spline, size_t threadCount)
+    :spline(spline), segmentLengths(spline.segmentCount()), cumulativeLengths(spline.segmentCount() + 1), looping(spline.isLooping())
+{
+    //every segment is independent, so integrating them is the part worth spreading across threads
+    SplineCommon::parallelFor(spline.segmentCount(), parallelChunkSize, threadCount, [&](size_t i) {
+        segmentLengths[i] = spline.segmentArcLength(i, spline.segmentT(i), spline.segmentT(i + 1));
+    });
+
+    //the running sum is cheap by comparison, and summing in a different order would round differently, so it stays serial
+    cumulativeLengths[0] = 0;
+    for(size_t i = 0; i < spline.segmentCount(); i++)
+    {
+        cumulativeLengths[i + 1] = cumulativeLengths[i] + segmentLengths[i];
+    }
+}
+
+template<class InterpolationType, typename floating_t>
+floating_t ArcLengthTable<InterpolationType, floating_t>::arcLength(floating_t a, floating_t b) const
+{
+    //segmentForT wraps t on looping splines, so a and b have to be wrapped the same way, or they'd be measured against the wrong segment
+    if(looping)
+    {
+        const auto &loopingSpline = static_cast<const LoopingSpline<InterpolationType, floating_t>&>(spline);
+        a = loopingSpline.wrapT(a);
+        b = loopingSpline.wrapT(b);
+    }
+
+    if(a > b) {
+        std::swap(a,b);
+    }
+
+    //get the knot indices for the beginning and end
+    size_t aIndex = spline.segmentForT(a);
+    size_t bIndex = spline.segmentForT(b);
+
+    //if a and b occur inside the same segment, compute the length within that segment
+    if(aIndex == bIndex) {
+        return spline.segmentArcLength(aIndex, a, b);
+    }
+    else {
+        //a and b occur in different segments. integrate the partial first and last segments, and look up every segment in between
+        floating_t aEnd = spline.segmentT(aIndex + 1);
+        floating_t bBegin = spline.segmentT(bIndex);
+
+        return spline.segmentArcLength(aIndex, a, aEnd)
+             + (cumulativeLengths[bIndex] - cumulativeLengths[aIndex + 1])
+             + spline.segmentArcLength(bIndex, bBegin, b);
+    }
+}
+
+template<class InterpolationType, typename floating_t>
+size_t ArcLengthTable<InterpolationType, floating_t>::segmentForLength(floating_t length) const
+{
+    //we want the last segment whose beginning is <= length. the final cumulative length is the end of the spline, so leave it out of the search
+    auto segmentEnd = std::upper_bound(cumulativeLengths.cbegin() + 1, cumulativeLengths.cend() - 1, length);
+    return std::distance(cumulativeLengths.cbegin() + 1, segmentEnd);
+}
+
+template<class InterpolationType, typename floating_t>
+floating_t ArcLengthTable<InterpolationType, floating_t>::cyclicArcLength(floating_t a, floating_t b) const
+{
+    assert(spline.isLooping());
+    const auto &loopingSpline = static_cast<const LoopingSpline<InterpolationType, floating_t>&>(spline);
+
+    floating_t wrappedA = loopingSpline.wrapT(a);
+    floating_t wrappedB = loopingSpline.wrapT(b);
+
+    //if wrapped A is less than wrapped B, then we can use the normal arc legth formula
+    //otherwise, the path from a to b is everything except the path from b to a
+    if(wrappedA <= wrappedB)
+    {
+        return arcLength(wrappedA, wrappedB);
+    }
+    else
+    {
+        return totalLength() - arcLength(wrappedB, wrappedA);
+    }
+}
@@ -2,12 +2,48 @@
 
 #include <cmath>
 #include <array>
+#include <limits>
+
+#include "instrumentation.h"
 
 class SplineLibraryCalculus {
 private:
     SplineLibraryCalculus() = default;
 
 public:
+    //which quadrature integrate() uses
+    //FixedGaussLegendre always uses 13 points, AdaptiveGaussKronrod splits the interval until its error estimate meets a tolerance,
+    //and LowOrderGaussLegendre uses 5 points, which is roughly 1e-3 relative error on typical spline segments - fine for previews
+    enum QuadratureMode { FixedGaussLegendre, AdaptiveGaussKronrod, LowOrderGaussLegendre };
+
+    template<typename floating_t>
+    struct QuadratureSettings
+    {
+        QuadratureSettings(QuadratureMode mode = FixedGaussLegendre, floating_t tolerance = std::numeric_limits<floating_t>::epsilon() * 100)
+            :mode(mode), tolerance(tolerance)
+        {}
+
+        QuadratureMode mode;
+
+        //the relative error the adaptive mode aims for. ignored by the other modes
+        floating_t tolerance;
+    };
+
+    //numerically integrate f from a to b, using the quadrature chosen by the given settings
+    template<class IntegrandType, class Function, typename floating_t>
+    inline static IntegrandType integrate(Function f, floating_t a, floating_t b, const QuadratureSettings<floating_t> &settings)
+    {
+        switch(settings.mode)
+        {
+        case AdaptiveGaussKronrod:
+            return adaptiveGaussKronrodIntegral<IntegrandType>(f, a, b, settings.tolerance);
+        case LowOrderGaussLegendre:
+            return lowOrderGaussLegendreIntegral<IntegrandType>(f, a, b);
+        default:
+            return gaussLegendreQuadratureIntegral<IntegrandType>(f, a, b);
+        }
+    }
+
     //use the gauss-legendre quadrature algorithm to numerically integrate f from a to b
     //as of this writing, hardcoded to use 13 points
     template<class IntegrandType, class Function, typename floating_t>
@@ -50,6 +86,9 @@ public:
             floating_t(0.0404840047653159)
         };
 
+        SPLINE_LIBRARY_TIMED_SCOPE(QuadratureCalls, 1);
+        SPLINE_LIBRARY_COUNT(QuadratureEvaluations, NUM_POINTS);
+
         floating_t halfDiff = (b - a) / 2;
         floating_t halfSum = (a + b) / 2;
 
@@ -60,4 +99,130 @@ public:
         }
         return halfDiff * sum;
     }
+
+    //use the 5-point gauss-legendre quadrature to integrate f from a to b. exact for polynomials up to degree 9
+    template<class IntegrandType, class Function, typename floating_t>
+    inline static IntegrandType lowOrderGaussLegendreIntegral(Function f, floating_t a, floating_t b)
+    {
+        const size_t NUM_POINTS = 5;
+
+        std::array<floating_t, NUM_POINTS> quadraturePoints = {
+            floating_t( 0.0000000000000000),
+            floating_t(-0.5384693101056831),
+            floating_t( 0.5384693101056831),
+            floating_t(-0.9061798459386640),
+            floating_t( 0.9061798459386640)
+        };
+
+        std::array<floating_t, NUM_POINTS> quadratureWeights = {
+            floating_t(0.5688888888888889),
+            floating_t(0.4786286704993665),
+            floating_t(0.4786286704993665),
+            floating_t(0.2369268850561891),
+            floating_t(0.2369268850561891)
+        };
+
+        SPLINE_LIBRARY_TIMED_SCOPE(QuadratureCalls, 1);
+        SPLINE_LIBRARY_COUNT(QuadratureEvaluations, NUM_POINTS);
+
+        floating_t halfDiff = (b - a) / 2;
+        floating_t halfSum = (a + b) / 2;
+
+        IntegrandType sum{};
+        for(size_t i = 0; i < NUM_POINTS; i++)
+        {
+            sum += quadratureWeights[i] * f(halfDiff * quadraturePoints[i] + halfSum);
+        }
+        return halfDiff * sum;
+    }
+
+    //use the 15-point gauss-kronrod quadrature to integrate f from a to b
+    //the 7-point gauss-legendre quadrature shares 7 of the kronrod points, so comparing the two gives an error estimate for free
+    //the integrand must be a scalar, so that the error estimate is too
+    template<class IntegrandType, class Function, typename floating_t>
+    inline static IntegrandType gaussKronrodIntegral(Function f, floating_t a, floating_t b, IntegrandType &errorEstimate)
+    {
+        //kronrod points, from the outside in. the odd indexes are also the gauss points
+        std::array<floating_t, 8> kronrodPoints = {
+            floating_t(0.9914553711208126),
+            floating_t(0.9491079123427585),
+            floating_t(0.8648644233597691),
+            floating_t(0.7415311855993944),
+            floating_t(0.5860872354676911),
+            floating_t(0.4058451513773972),
+            floating_t(0.2077849550078985),
+            floating_t(0.0000000000000000)
+        };
+
+        std::array<floating_t, 8> kronrodWeights = {
+            floating_t(0.0229353220105292),
+            floating_t(0.0630920926299786),
+            floating_t(0.1047900103222502),
+            floating_t(0.1406532597155259),
+            floating_t(0.1690047266392679),
+            floating_t(0.1903505780647854),
+            floating_t(0.2044329400752989),
+            floating_t(0.2094821410847278)
+        };
+
+        //weights for kronrodPoints[1], [3], [5], and [7]
+        std::array<floating_t, 4> gaussWeights = {
+            floating_t(0.1294849661688697),
+            floating_t(0.2797053914892767),
+            floating_t(0.3818300505051189),
+            floating_t(0.4179591836734694)
+        };
+
+        SPLINE_LIBRARY_COUNT(QuadratureEvaluations, 15);
+
+        floating_t halfDiff = (b - a) / 2;
+        floating_t halfSum = (a + b) / 2;
+
+        IntegrandType center = f(halfSum);
+        IntegrandType kronrodSum = kronrodWeights[7] * center;
+        IntegrandType gaussSum = gaussWeights[3] * center;
+        for(size_t i = 0; i < 7; i++)
+        {
+            IntegrandType pairSum = f(halfSum - halfDiff * kronrodPoints[i]) + f(halfSum + halfDiff * kronrodPoints[i]);
+            kronrodSum += kronrodWeights[i] * pairSum;
+            if(i % 2 == 1)
+            {
+                gaussSum += gaussWeights[i / 2] * pairSum;
+            }
+        }
+
+        errorEstimate = std::abs(halfDiff * (kronrodSum - gaussSum));
+        return halfDiff * kronrodSum;
+    }
+
+    //integrate f from a to b with gauss-kronrod quadrature, recursively splitting the interval in half until the estimated error
+    //is at most relativeTolerance times the result. smooth integrands usually finish with a single 15-point pass,
+    //while integrands with sharp features only pay for extra points where they need them
+    template<class IntegrandType, class Function, typename floating_t>
+    inline static IntegrandType adaptiveGaussKronrodIntegral(Function f, floating_t a, floating_t b, floating_t relativeTolerance, int maxDepth = 12)
+    {
+        SPLINE_LIBRARY_TIMED_SCOPE(QuadratureCalls, 1);
+
+        IntegrandType errorEstimate;
+        IntegrandType result = gaussKronrodIntegral<IntegrandType>(f, a, b, errorEstimate);
+
+        return adaptiveGaussKronrodStep(f, a, b, result, errorEstimate, relativeTolerance * std::abs(result), maxDepth);
+    }
+
+private:
+    template<class IntegrandType, class Function, typename floating_t>
+    static IntegrandType adaptiveGaussKronrodStep(Function f, floating_t a, floating_t b, IntegrandType wholeResult, IntegrandType wholeError, IntegrandType absoluteTolerance, int depth)
+    {
+        if(wholeError <= absoluteTolerance || depth <= 0)
+            return wholeResult;
+
+        //split the remaining error budget evenly between the two halves
+        floating_t middle = (a + b) / 2;
+        IntegrandType leftError, rightError;
+        IntegrandType left = gaussKronrodIntegral<IntegrandType>(f, a, middle, leftError);
+        IntegrandType right = gaussKronrodIntegral<IntegrandType>(f, middle, b, rightError);
+
+        return adaptiveGaussKronrodStep(f, a, middle, left, leftError, absoluteTolerance / 2, depth - 1)
+             + adaptiveGaussKronrodStep(f, middle, b, right, rightError, absoluteTolerance / 2, depth - 1);
+    }
 };
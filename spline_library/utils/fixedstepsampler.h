@@ -0,0 +1,205 @@
+#pragma once
+
+#include <array>
+#include <algorithm>
+#include <utility>
+#include <cassert>
+
+#include "../spline.h"
+#include "quinticbezier.h"
+
+namespace FixedStepSampler
+{
+    //sample every segment of the spline at samplesPerSegment evenly spaced t values, for rendering, exporting and building meshes
+    //the points are written into positions, which needs room for sampleCount(spline, samplesPerSegment) points: segment i's samples begin at index i * samplesPerSegment,
+    //and each segment's end is shared with the next segment's beginning, so the last point is the end of the spline. if tValues or tangents aren't null, they get the
+    //t value and the tangent of each point too, and need the same amount of room
+    //
+    //degree is the highest degree of the spline's segments: 3 for cubic splines, and 5, the default, for quintic hermite splines and B-splines of degree 4 or 5
+    //see quinticbezier.h for the splines that aren't supported. each sample costs degree vector adds instead of a full evaluation, after a fixed cost per segment
+    //to find its polynomial, so this beats getPositions once each segment gets a few dozen samples, or sooner for splines that are slow to evaluate
+    //returns the number of points written
+    template<size_t degree = 5, class InterpolationType, typename floating_t>
+    size_t sample(const Spline<InterpolationType, floating_t> &spline, size_t samplesPerSegment,
+                  InterpolationType *positions, floating_t *tValues = nullptr, InterpolationType *tangents = nullptr);
+
+    //the same, for a single segment, split into stepCount equal steps. writes stepCount + 1 points, including both ends of the segment
+    template<size_t degree = 5, class InterpolationType, typename floating_t>
+    void sampleSegment(const Spline<InterpolationType, floating_t> &spline, size_t segmentIndex, size_t stepCount,
+                       InterpolationType *positions, floating_t *tValues = nullptr, InterpolationType *tangents = nullptr);
+
+    //the number of points sample will write
+    template<class InterpolationType, typename floating_t>
+    size_t sampleCount(const Spline<InterpolationType, floating_t> &spline, size_t samplesPerSegment)
+    {
+        return spline.segmentCount() * samplesPerSegment + 1;
+    }
+
+    //every rounding error made by forward differencing is carried into every later sample, so the differences are recomputed exactly from the polynomial
+    //this often. that keeps the drift well below the error of converting the segment to a polynomial in the first place
+    const size_t anchorInterval = 64;
+}
+
+namespace __FixedStepSamplerPrivate
+{
+    template<class InterpolationType, size_t degree>
+    using Differences = std::array<InterpolationType, degree + 1>;
+
+    //a polynomial's value at the given sample, where sample k is at u = k / stepCount, along with its forward differences from there
+    //coefficients are in terms of u, lowest power first, and there are degree + 1 of them
+    //differencing sampled values would cancel almost every bit of the higher differences, so they're computed from the coefficients instead
+    template<size_t degree, class InterpolationType, typename floating_t>
+    Differences<InterpolationType, degree> computeDifferences(const InterpolationType *coefficients, size_t sampleIndex, size_t stepCount)
+    {
+        floating_t u = floating_t(sampleIndex) / floating_t(stepCount);
+        floating_t step = floating_t(1) / floating_t(stepCount);
+
+        //shift the polynomial to begin at u, by repeated synthetic division, then scale it so that one step is 1
+        std::array<InterpolationType, degree + 1> shifted;
+        std::copy(coefficients, coefficients + degree + 1, shifted.begin());
+        if(sampleIndex > 0)
+        {
+            for(size_t i = 0; i < degree; i++)
+            {
+                for(size_t j = degree; j-- > i;)
+                {
+                    shifted[j] = shifted[j] + shifted[j + 1] * u;
+                }
+            }
+        }
+        floating_t stepPower = step;
+        for(size_t j = 1; j <= degree; j++)
+        {
+            shifted[j] = shifted[j] * stepPower;
+            stepPower *= step;
+        }
+
+        //at 0, the kth forward difference of s^j with a step of 1 is the number of ways to map j things onto k things, using every one of them
+        static const floating_t surjections[6][6] = {
+            {1, 0, 0, 0, 0, 0},
+            {0, 1, 0, 0, 0, 0},
+            {0, 1, 2, 0, 0, 0},
+            {0, 1, 6, 6, 0, 0},
+            {0, 1, 14, 36, 24, 0},
+            {0, 1, 30, 150, 240, 120}
+        };
+        Differences<InterpolationType, degree> differences;
+        for(size_t k = 0; k <= degree; k++)
+        {
+            InterpolationType difference = shifted[degree] * surjections[degree][k];
+            for(size_t j = degree; j-- > k;)
+            {
+                difference = difference + shifted[j] * surjections[j][k];
+            }
+            differences[k] = difference;
+        }
+        return differences;
+    }
+
+    //move to the next sample, by adding each difference to the one below it. each one has to be used before it changes, so this goes from the bottom up
+    //the indexes are spelled out, rather than looped over, so that the compiler can keep every difference in a register
+    template<class InterpolationType, size_t degree, size_t... k>
+    inline void advance(Differences<InterpolationType, degree> &differences, std::index_sequence<k...>)
+    {
+        int unused[] = {0, (differences[k] = differences[k] + differences[k + 1], 0)...};
+        (void)unused;
+    }
+
+    //write stepCount samples of the polynomial, restarting from the exact polynomial every anchorInterval samples
+    //each sample depends on the one before it, so the two halves of the range are sampled side by side, giving the processor two independent chains to work on
+    template<size_t degree, class InterpolationType, typename floating_t>
+    void sampleSteps(const InterpolationType *coefficients, size_t stepCount, InterpolationType *output)
+    {
+        size_t half = (stepCount + 1) / 2;
+        for(size_t offset = 0; offset < half; offset += FixedStepSampler::anchorInterval)
+        {
+            Differences<InterpolationType, degree> first = computeDifferences<degree, InterpolationType, floating_t>(coefficients, offset, stepCount);
+            Differences<InterpolationType, degree> second = computeDifferences<degree, InterpolationType, floating_t>(coefficients, half + offset, stepCount);
+
+            //the second half is one sample shorter when stepCount is odd
+            size_t count = std::min(FixedStepSampler::anchorInterval, half - offset);
+            size_t secondCount = std::min(count, stepCount - half - offset);
+            for(size_t k = 0; k < secondCount; k++)
+            {
+                output[offset + k] = first[0];
+                output[half + offset + k] = second[0];
+                advance<InterpolationType, degree>(first, std::make_index_sequence<degree>());
+                advance<InterpolationType, degree>(second, std::make_index_sequence<degree>());
+            }
+            if(secondCount < count)
+                output[offset + count - 1] = first[0];
+        }
+    }
+}
+
+template<size_t degree, class InterpolationType, typename floating_t>
+void FixedStepSampler::sampleSegment(const Spline<InterpolationType, floating_t> &spline, size_t segmentIndex, size_t stepCount,
+                                     InterpolationType *positions, floating_t *tValues, InterpolationType *tangents)
+{
+    static_assert(degree >= 1 && degree <= 5, "every supported segment can be sampled as a polynomial of degree 5 or less");
+    assert(stepCount > 0);
+
+    floating_t beginT = spline.segmentT(segmentIndex);
+    floating_t endT = spline.segmentT(segmentIndex + 1);
+    floating_t tDistance = endT - beginT;
+
+    if(tValues)
+    {
+        for(size_t k = 0; k < stepCount; k++)
+        {
+            tValues[k] = beginT + tDistance * k / stepCount;
+        }
+        tValues[stepCount] = endT;
+    }
+
+    //a segment with no t distance is a single point, so there's nothing to difference
+    if(tDistance <= 0)
+    {
+        auto result = spline.getTangentInSegment(segmentIndex, beginT);
+        for(size_t k = 0; k <= stepCount; k++)
+        {
+            positions[k] = result.position;
+            if(tangents)
+                tangents[k] = result.tangent;
+        }
+        return;
+    }
+
+    //the bezier conversion is exact. for lower degrees, the coefficients past the segment's real degree are only rounding error, so they're left out
+    QuinticBezier::ControlPoints<InterpolationType> controlPoints = QuinticBezier::fromSegment(spline, segmentIndex);
+    std::array<InterpolationType, 6> coefficients = QuinticBezier::powerBasis<floating_t>(controlPoints);
+
+    __FixedStepSamplerPrivate::sampleSteps<degree, InterpolationType, floating_t>(coefficients.data(), stepCount, positions);
+
+    //the ends of the bezier curve are the segment's own ends, so use them directly, so that adjacent segments meet exactly
+    positions[0] = controlPoints[0];
+    positions[stepCount] = controlPoints[5];
+
+    if(tangents)
+    {
+        //differentiate, converting from u to the spline's t
+        std::array<InterpolationType, degree> tangentCoefficients;
+        for(size_t k = 0; k < degree; k++)
+        {
+            tangentCoefficients[k] = coefficients[k + 1] * (floating_t(k + 1) / tDistance);
+        }
+
+        __FixedStepSamplerPrivate::sampleSteps<degree - 1, InterpolationType, floating_t>(tangentCoefficients.data(), stepCount, tangents);
+        tangents[stepCount] = (controlPoints[5] - controlPoints[4]) * (5 / tDistance);
+    }
+}
+
+template<size_t degree, class InterpolationType, typename floating_t>
+size_t FixedStepSampler::sample(const Spline<InterpolationType, floating_t> &spline, size_t samplesPerSegment,
+                                InterpolationType *positions, floating_t *tValues, InterpolationType *tangents)
+{
+    assert(samplesPerSegment > 0);
+
+    //each segment's last point is overwritten by the next segment's first point, which is the same point
+    for(size_t i = 0; i < spline.segmentCount(); i++)
+    {
+        size_t offset = i * samplesPerSegment;
+        sampleSegment<degree>(spline, i, samplesPerSegment, positions + offset, tValues ? tValues + offset : nullptr, tangents ? tangents + offset : nullptr);
+    }
+    return sampleCount(spline, samplesPerSegment);
+}
@@ -0,0 +1,458 @@
+#pragma once
+
+#include <vector>
+#include <array>
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstddef>
+
+#include "../spline.h"
+#include "spline_common.h"
+#include "quinticbezier.h"
+
+//packs any number of splines into two flat arrays that can be uploaded to the GPU as shader storage buffers, so that shaders can evaluate the splines directly
+//each segment is converted exactly into a quintic polynomial (see quinticbezier.h for the splines that aren't supported), so every spline type has the same layout
+//glslSource() has the matching shader code. every struct here only contains 4 byte scalars and arrays of vec4, so its layout is the same under std140 and std430
+//
+//the position, tangent, and tForLength methods are a C++ transcription of the shader code, using the same float math, so shader results can be checked against them
+template<class InterpolationType, typename floating_t=float, size_t dimension=2>
+class GpuSplineBuffer
+{
+    static_assert(dimension >= 1 && dimension <= 4, "Each coefficient is stored in a vec4, so GpuSplineBuffer supports at most 4 dimensions");
+
+public:
+    //matches the SplineSegment struct in glslSource()
+    //the position is a polynomial in terms of a local t that goes from -0.5 at the beginning of the segment to 0.5 at the end
+    //centering it keeps the high degree coefficients small, which matters in single precision
+    struct Segment
+    {
+        float beginT;
+        float inverseLength;
+
+        //arc length from the beginning of the spline to the beginning of this segment, and the arc length of this segment
+        float lengthBefore;
+        float length;
+
+        //lowest power first. components past the spline's dimension are 0
+        std::array<std::array<float, 4>, 6> coefficients;
+    };
+
+    //matches the SplineCurve struct in glslSource()
+    struct Curve
+    {
+        uint32_t firstSegment;
+        uint32_t segmentCount;
+        uint32_t looping;
+        uint32_t padding0;
+
+        float maxT;
+        float totalLength;
+        float padding1;
+        float padding2;
+    };
+
+    static_assert(sizeof(Segment) == 112, "GpuSplineBuffer::Segment must match the std430 layout of SplineSegment");
+    static_assert(sizeof(Curve) == 32, "GpuSplineBuffer::Curve must match the std430 layout of SplineCurve");
+
+    //add the spline to the buffer, and return its curve index, which is how shaders refer to it
+    size_t addSpline(const Spline<InterpolationType, floating_t> &spline);
+
+    inline size_t curveCount(void) const { return curves.size(); }
+
+    //upload these directly: segmentData().data() is segmentData().size() * sizeof(Segment) bytes, and the same for curveData()
+    inline const std::vector<Segment> &segmentData(void) const { return segments; }
+    inline const std::vector<Curve> &curveData(void) const { return curves; }
+
+    //reference versions of the shader functions with the same names
+    InterpolationType position(size_t curveIndex, float t) const;
+    void tangent(size_t curveIndex, float t, InterpolationType &positionResult, InterpolationType &tangentResult) const;
+    float tForLength(size_t curveIndex, float length) const;
+
+    //the shader code for evaluating the buffers. prepend your own #version line, and optionally define
+    //SPLINE_SEGMENT_BINDING and SPLINE_CURVE_BINDING to choose the buffer binding points, which default to 0 and 1
+    static const char *glslSource(void);
+
+    //the number of bytes used by this buffer, including everything it allocated
+    size_t memoryFootprint(void) const;
+
+private: //methods
+    size_t segmentForT(const Curve &curve, float t) const;
+    static float wrapT(const Curve &curve, float t);
+
+    //the position and derivative with respect to local t of a segment, as vec4s
+    static std::array<float, 4> evaluate(const Segment &segment, float localT);
+    static std::array<float, 4> evaluateDerivative(const Segment &segment, float localT);
+
+    //arc length from the beginning of the segment to localT, with the same gauss-legendre rule as the shader
+    static float lengthInSegment(const Segment &segment, float localT);
+
+    static InterpolationType toInterpolationType(const std::array<float, 4> &value);
+
+private: //data
+    std::vector<Segment> segments;
+    std::vector<Curve> curves;
+
+    //newton's method on the arc length inside a segment converges quickly, because the initial guess is already close
+    static const int lengthIterations = 4;
+};
+
+namespace __GpuSplineBufferPrivate
+{
+    //5 point gauss-legendre on [-1, 1]. it's exact for polynomials up to degree 9, but the speed of a quintic is the square root of a degree 8 polynomial,
+    //so this is only an approximation. the speed is smooth within a segment, so the error is small unless the segment nearly stops and turns sharply
+    const float gaussNodes[5] = {-0.906179845938664f, -0.538469310105683f, 0.0f, 0.538469310105683f, 0.906179845938664f};
+    const float gaussWeights[5] = {0.236926885056189f, 0.478628670499366f, 0.568888888888889f, 0.478628670499366f, 0.236926885056189f};
+}
+
+template<class InterpolationType, typename floating_t, size_t dimension>
+size_t GpuSplineBuffer<InterpolationType, floating_t, dimension>::addSpline(const Spline<InterpolationType, floating_t> &spline)
+{
+    Curve curve;
+    curve.firstSegment = uint32_t(segments.size());
+    curve.segmentCount = uint32_t(spline.segmentCount());
+    curve.looping = spline.isLooping() ? 1 : 0;
+    curve.maxT = float(spline.getMaxT());
+    curve.padding0 = 0;
+    curve.padding1 = 0;
+    curve.padding2 = 0;
+
+    floating_t lengthBefore = 0;
+    for(size_t i = 0; i < spline.segmentCount(); i++)
+    {
+        floating_t beginT = spline.segmentT(i);
+        floating_t endT = spline.segmentT(i + 1);
+        floating_t segmentLength = spline.segmentArcLength(i, beginT, endT);
+
+        Segment segment;
+        segment.beginT = float(beginT);
+        segment.inverseLength = endT > beginT ? float(1 / (endT - beginT)) : 0.0f;
+        segment.lengthBefore = float(lengthBefore);
+        segment.length = float(segmentLength);
+
+        std::array<InterpolationType, 6> powerBasis;
+        if(endT > beginT)
+        {
+            powerBasis = QuinticBezier::centeredPowerBasis<floating_t>(QuinticBezier::fromSegment(spline, i));
+        }
+        else
+        {
+            //a segment with no T distance is a single point
+            powerBasis.fill(InterpolationType());
+            powerBasis[0] = spline.getPositionInSegment(i, beginT);
+        }
+
+        for(size_t k = 0; k < 6; k++)
+        {
+            for(size_t d = 0; d < 4; d++)
+            {
+                segment.coefficients[k][d] = d < dimension ? float(powerBasis[k][d]) : 0.0f;
+            }
+        }
+
+        segments.push_back(segment);
+        lengthBefore += segmentLength;
+    }
+    curve.totalLength = float(lengthBefore);
+
+    curves.push_back(curve);
+    return curves.size() - 1;
+}
+
+template<class InterpolationType, typename floating_t, size_t dimension>
+float GpuSplineBuffer<InterpolationType, floating_t, dimension>::wrapT(const Curve &curve, float t)
+{
+    if(curve.looping != 0)
+        return t - curve.maxT * std::floor(t / curve.maxT);
+    else
+        return t;
+}
+
+template<class InterpolationType, typename floating_t, size_t dimension>
+size_t GpuSplineBuffer<InterpolationType, floating_t, dimension>::segmentForT(const Curve &curve, float t) const
+{
+    //binary search for the last segment that begins at or before t. t values before the first segment use the first one
+    size_t low = 0;
+    size_t high = curve.segmentCount;
+    while(high - low > 1)
+    {
+        size_t middle = (low + high) / 2;
+        if(segments[curve.firstSegment + middle].beginT <= t)
+            low = middle;
+        else
+            high = middle;
+    }
+    return curve.firstSegment + low;
+}
+
+template<class InterpolationType, typename floating_t, size_t dimension>
+std::array<float, 4> GpuSplineBuffer<InterpolationType, floating_t, dimension>::evaluate(const Segment &segment, float localT)
+{
+    std::array<float, 4> result = segment.coefficients[5];
+    for(size_t k = 5; k > 0; k--)
+    {
+        for(size_t d = 0; d < 4; d++)
+            result[d] = result[d] * localT + segment.coefficients[k - 1][d];
+    }
+    return result;
+}
+
+template<class InterpolationType, typename floating_t, size_t dimension>
+std::array<float, 4> GpuSplineBuffer<InterpolationType, floating_t, dimension>::evaluateDerivative(const Segment &segment, float localT)
+{
+    std::array<float, 4> result;
+    for(size_t d = 0; d < 4; d++)
+        result[d] = segment.coefficients[5][d] * 5.0f;
+    for(size_t k = 4; k > 0; k--)
+    {
+        for(size_t d = 0; d < 4; d++)
+            result[d] = result[d] * localT + segment.coefficients[k][d] * float(k);
+    }
+    return result;
+}
+
+template<class InterpolationType, typename floating_t, size_t dimension>
+float GpuSplineBuffer<InterpolationType, floating_t, dimension>::lengthInSegment(const Segment &segment, float localT)
+{
+    //integrate the speed from -0.5 to localT. the derivative is with respect to local t, so the result is already a length
+    float halfWidth = (localT + 0.5f) * 0.5f;
+    float center = -0.5f + halfWidth;
+    float result = 0;
+    for(size_t i = 0; i < 5; i++)
+    {
+        std::array<float, 4> derivative = evaluateDerivative(segment, center + halfWidth * __GpuSplineBufferPrivate::gaussNodes[i]);
+        float speedSquared = 0;
+        for(size_t d = 0; d < 4; d++)
+            speedSquared += derivative[d] * derivative[d];
+        result += __GpuSplineBufferPrivate::gaussWeights[i] * std::sqrt(speedSquared);
+    }
+    return result * halfWidth;
+}
+
+template<class InterpolationType, typename floating_t, size_t dimension>
+InterpolationType GpuSplineBuffer<InterpolationType, floating_t, dimension>::toInterpolationType(const std::array<float, 4> &value)
+{
+    InterpolationType result;
+    for(size_t d = 0; d < dimension; d++)
+        result[d] = value[d];
+    return result;
+}
+
+template<class InterpolationType, typename floating_t, size_t dimension>
+InterpolationType GpuSplineBuffer<InterpolationType, floating_t, dimension>::position(size_t curveIndex, float t) const
+{
+    const Curve &curve = curves[curveIndex];
+    t = wrapT(curve, t);
+    const Segment &segment = segments[segmentForT(curve, t)];
+    return toInterpolationType(evaluate(segment, (t - segment.beginT) * segment.inverseLength - 0.5f));
+}
+
+template<class InterpolationType, typename floating_t, size_t dimension>
+void GpuSplineBuffer<InterpolationType, floating_t, dimension>::tangent(size_t curveIndex, float t, InterpolationType &positionResult, InterpolationType &tangentResult) const
+{
+    const Curve &curve = curves[curveIndex];
+    t = wrapT(curve, t);
+    const Segment &segment = segments[segmentForT(curve, t)];
+    float localT = (t - segment.beginT) * segment.inverseLength - 0.5f;
+
+    std::array<float, 4> derivative = evaluateDerivative(segment, localT);
+    for(size_t d = 0; d < 4; d++)
+        derivative[d] *= segment.inverseLength;
+
+    positionResult = toInterpolationType(evaluate(segment, localT));
+    tangentResult = toInterpolationType(derivative);
+}
+
+template<class InterpolationType, typename floating_t, size_t dimension>
+float GpuSplineBuffer<InterpolationType, floating_t, dimension>::tForLength(size_t curveIndex, float length) const
+{
+    const Curve &curve = curves[curveIndex];
+    if(curve.looping != 0)
+        length = length - curve.totalLength * std::floor(length / curve.totalLength);
+    else
+        length = std::min(std::max(length, 0.0f), curve.totalLength);
+
+    //binary search for the last segment that begins at or before the length
+    size_t low = 0;
+    size_t high = curve.segmentCount;
+    while(high - low > 1)
+    {
+        size_t middle = (low + high) / 2;
+        if(segments[curve.firstSegment + middle].lengthBefore <= length)
+            low = middle;
+        else
+            high = middle;
+    }
+    const Segment &segment = segments[curve.firstSegment + low];
+    if(segment.length <= 0 || segment.inverseLength <= 0)
+        return segment.beginT;
+
+    //newton's method on the local t, starting from the guess that the speed is constant across the segment
+    float target = std::min(length - segment.lengthBefore, segment.length);
+    float localT = target / segment.length - 0.5f;
+    for(int i = 0; i < lengthIterations; i++)
+    {
+        std::array<float, 4> derivative = evaluateDerivative(segment, localT);
+        float speedSquared = 0;
+        for(size_t d = 0; d < 4; d++)
+            speedSquared += derivative[d] * derivative[d];
+        if(speedSquared <= 0)
+            break;
+
+        localT -= (lengthInSegment(segment, localT) - target) / std::sqrt(speedSquared);
+        localT = std::min(std::max(localT, -0.5f), 0.5f);
+    }
+    return segment.beginT + (localT + 0.5f) / segment.inverseLength;
+}
+
+template<class InterpolationType, typename floating_t, size_t dimension>
+size_t GpuSplineBuffer<InterpolationType, floating_t, dimension>::memoryFootprint(void) const
+{
+    return sizeof(*this) + SplineCommon::vectorFootprint(segments) + SplineCommon::vectorFootprint(curves);
+}
+
+template<class InterpolationType, typename floating_t, size_t dimension>
+const char *GpuSplineBuffer<InterpolationType, floating_t, dimension>::glslSource(void)
+{
+    return R"GLSL(
+#ifndef SPLINE_SEGMENT_BINDING
+#define SPLINE_SEGMENT_BINDING 0
+#endif
+#ifndef SPLINE_CURVE_BINDING
+#define SPLINE_CURVE_BINDING 1
+#endif
+
+struct SplineSegment
+{
+    float beginT;
+    float inverseLength;
+    float lengthBefore;
+    float length;
+    vec4 coefficients[6];
+};
+
+struct SplineCurve
+{
+    uint firstSegment;
+    uint segmentCount;
+    uint looping;
+    uint padding0;
+    float maxT;
+    float totalLength;
+    float padding1;
+    float padding2;
+};
+
+layout(std430, binding = SPLINE_SEGMENT_BINDING) readonly buffer SplineSegmentBuffer { SplineSegment splineSegments[]; };
+layout(std430, binding = SPLINE_CURVE_BINDING) readonly buffer SplineCurveBuffer { SplineCurve splineCurves[]; };
+
+const float splineGaussNodes[5] = float[5](-0.906179845938664, -0.538469310105683, 0.0, 0.538469310105683, 0.906179845938664);
+const float splineGaussWeights[5] = float[5](0.236926885056189, 0.478628670499366, 0.568888888888889, 0.478628670499366, 0.236926885056189);
+
+float splineWrapT(SplineCurve curve, float t)
+{
+    return curve.looping != 0u ? t - curve.maxT * floor(t / curve.maxT) : t;
+}
+
+uint splineSegmentForT(SplineCurve curve, float t)
+{
+    uint low = 0u;
+    uint high = curve.segmentCount;
+    while(high - low > 1u)
+    {
+        uint middle = (low + high) / 2u;
+        if(splineSegments[curve.firstSegment + middle].beginT <= t)
+            low = middle;
+        else
+            high = middle;
+    }
+    return curve.firstSegment + low;
+}
+
+vec4 splineEvaluate(uint segmentIndex, float localT)
+{
+    vec4 result = splineSegments[segmentIndex].coefficients[5];
+    for(int k = 5; k > 0; k--)
+        result = result * localT + splineSegments[segmentIndex].coefficients[k - 1];
+    return result;
+}
+
+vec4 splineEvaluateDerivative(uint segmentIndex, float localT)
+{
+    vec4 result = splineSegments[segmentIndex].coefficients[5] * 5.0;
+    for(int k = 4; k > 0; k--)
+        result = result * localT + splineSegments[segmentIndex].coefficients[k] * float(k);
+    return result;
+}
+
+float splineLengthInSegment(uint segmentIndex, float localT)
+{
+    float halfWidth = (localT + 0.5) * 0.5;
+    float center = -0.5 + halfWidth;
+    float result = 0.0;
+    for(int i = 0; i < 5; i++)
+        result += splineGaussWeights[i] * length(splineEvaluateDerivative(segmentIndex, center + halfWidth * splineGaussNodes[i]));
+    return result * halfWidth;
+}
+
+vec4 splinePosition(uint curveIndex, float t)
+{
+    SplineCurve curve = splineCurves[curveIndex];
+    t = splineWrapT(curve, t);
+    uint segmentIndex = splineSegmentForT(curve, t);
+    float localT = (t - splineSegments[segmentIndex].beginT) * splineSegments[segmentIndex].inverseLength - 0.5;
+    return splineEvaluate(segmentIndex, localT);
+}
+
+void splineTangent(uint curveIndex, float t, out vec4 position, out vec4 tangent)
+{
+    SplineCurve curve = splineCurves[curveIndex];
+    t = splineWrapT(curve, t);
+    uint segmentIndex = splineSegmentForT(curve, t);
+    float inverseLength = splineSegments[segmentIndex].inverseLength;
+    float localT = (t - splineSegments[segmentIndex].beginT) * inverseLength - 0.5;
+    position = splineEvaluate(segmentIndex, localT);
+    tangent = splineEvaluateDerivative(segmentIndex, localT) * inverseLength;
+}
+
+float splineTForLength(uint curveIndex, float arcLength)
+{
+    SplineCurve curve = splineCurves[curveIndex];
+    if(curve.looping != 0u)
+        arcLength = arcLength - curve.totalLength * floor(arcLength / curve.totalLength);
+    else
+        arcLength = clamp(arcLength, 0.0, curve.totalLength);
+
+    uint low = 0u;
+    uint high = curve.segmentCount;
+    while(high - low > 1u)
+    {
+        uint middle = (low + high) / 2u;
+        if(splineSegments[curve.firstSegment + middle].lengthBefore <= arcLength)
+            low = middle;
+        else
+            high = middle;
+    }
+    uint segmentIndex = curve.firstSegment + low;
+    SplineSegment segment = splineSegments[segmentIndex];
+    if(segment.length <= 0.0 || segment.inverseLength <= 0.0)
+        return segment.beginT;
+
+    float target = min(arcLength - segment.lengthBefore, segment.length);
+    float localT = target / segment.length - 0.5;
+    for(int i = 0; i < 4; i++)
+    {
+        float speed = length(splineEvaluateDerivative(segmentIndex, localT));
+        if(speed <= 0.0)
+            break;
+        localT = clamp(localT - (splineLengthInSegment(segmentIndex, localT) - target) / speed, -0.5, 0.5);
+    }
+    return segment.beginT + (localT + 0.5) / segment.inverseLength;
+}
+
+vec4 splinePositionAtLength(uint curveIndex, float arcLength)
+{
+    return splinePosition(curveIndex, splineTForLength(curveIndex, arcLength));
+}
+)GLSL";
+}
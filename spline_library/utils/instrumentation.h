@@ -0,0 +1,237 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+#include <algorithm>
+
+//optional counters for the library's hot paths, to find out where the time goes and to spot pathological inputs, like degenerate knot spacing
+//define SPLINE_LIBRARY_INSTRUMENTATION to count events, and SPLINE_LIBRARY_INSTRUMENTATION_TIMING to also time the operations that are large enough to time
+//when neither is defined, every counting macro expands to nothing, so instrumentation costs nothing at all
+#if defined(SPLINE_LIBRARY_INSTRUMENTATION_TIMING) && !defined(SPLINE_LIBRARY_INSTRUMENTATION)
+    #define SPLINE_LIBRARY_INSTRUMENTATION
+#endif
+
+namespace SplineInstrumentation
+{
+#if defined(SPLINE_LIBRARY_INSTRUMENTATION)
+    const bool enabled = true;
+#else
+    const bool enabled = false;
+#endif
+
+#if defined(SPLINE_LIBRARY_INSTRUMENTATION_TIMING)
+    const bool timingEnabled = true;
+#else
+    const bool timingEnabled = false;
+#endif
+
+    enum Counter {
+        IndexLookups,           //calls to getIndexForT
+        IndexProbes,            //knots compared by getIndexForT
+        QuadratureCalls,        //calls to any of the quadrature functions. timed
+        QuadratureEvaluations,  //integrand evaluations made by the quadrature functions
+        ArcLengthSolves,        //segments solved for an arc length, by halley's method. timed
+        HalleyIterations,       //iterations of halley's method in those solves
+        InverterQueries,        //calls to SplineInverter::findClosestT. a coherent query that falls back to a global search counts twice. timed
+        KdTreeLookups,          //nearest sample lookups in the inverter's kd-tree. timed
+        BrentIterations,        //iterations of brent's method in SplineInverter::findClosestT
+        TridiagonalSolves,      //tridiagonal systems solved, counting each right hand side of a factored solve and each system of an interleaved one. timed
+        CounterCount
+    };
+
+    //a readable name for each counter
+    inline const char *counterName(Counter counter)
+    {
+        static const char *names[CounterCount] = {
+            "getIndexForT calls",
+            "getIndexForT probes",
+            "quadrature calls",
+            "quadrature evaluations",
+            "arc length solves",
+            "halley iterations",
+            "inverter queries",
+            "kd-tree lookups",
+            "brent iterations",
+            "tridiagonal solves"
+        };
+        return names[counter];
+    }
+
+    //a copy of some set of counters, taken at one point in time. subtract two snapshots to find what happened in between
+    struct Counters
+    {
+        std::array<uint64_t, CounterCount> counts{};
+
+        //total time spent in each timed operation. always 0 unless SPLINE_LIBRARY_INSTRUMENTATION_TIMING is defined
+        std::array<uint64_t, CounterCount> nanoseconds{};
+
+        Counters &operator+=(const Counters &other)
+        {
+            for(size_t i = 0; i < CounterCount; i++)
+            {
+                counts[i] += other.counts[i];
+                nanoseconds[i] += other.nanoseconds[i];
+            }
+            return *this;
+        }
+        Counters &operator-=(const Counters &other)
+        {
+            for(size_t i = 0; i < CounterCount; i++)
+            {
+                counts[i] -= other.counts[i];
+                nanoseconds[i] -= other.nanoseconds[i];
+            }
+            return *this;
+        }
+        friend Counters operator+(Counters left, const Counters &right) { return left += right; }
+        friend Counters operator-(Counters left, const Counters &right) { return left -= right; }
+    };
+
+    //the counters of the calling thread only
+    inline Counters threadSnapshot(void);
+
+    //the counters of every thread, including threads that have since exited
+    inline Counters globalSnapshot(void);
+}
+
+namespace __SplineInstrumentationPrivate
+{
+    using namespace SplineInstrumentation;
+
+    //each thread only ever adds to its own counters, so nothing needs to be locked to count something.
+    //the counters are atomic only so that another thread can read them for a global snapshot at the same time
+    struct ThreadCounters
+    {
+        std::array<std::atomic<uint64_t>, CounterCount> counts;
+        std::array<std::atomic<uint64_t>, CounterCount> nanoseconds;
+
+        inline ThreadCounters(void);
+        inline ~ThreadCounters(void);
+
+        inline void add(std::atomic<uint64_t> &value, uint64_t amount)
+        {
+            value.store(value.load(std::memory_order_relaxed) + amount, std::memory_order_relaxed);
+        }
+
+        inline Counters snapshot(void) const
+        {
+            Counters result;
+            for(size_t i = 0; i < CounterCount; i++)
+            {
+                result.counts[i] = counts[i].load(std::memory_order_relaxed);
+                result.nanoseconds[i] = nanoseconds[i].load(std::memory_order_relaxed);
+            }
+            return result;
+        }
+    };
+
+    //every thread's counters, plus the totals of the threads that have exited
+    struct Registry
+    {
+        std::mutex mutex;
+        std::vector<const ThreadCounters*> liveThreads;
+        Counters exitedThreads;
+    };
+
+    inline Registry &registry(void)
+    {
+        //thread_local objects are always destroyed before static ones, so every thread, including the main thread, can still unregister
+        static Registry registry;
+        return registry;
+    }
+
+    ThreadCounters::ThreadCounters(void)
+    {
+        for(size_t i = 0; i < CounterCount; i++)
+        {
+            counts[i].store(0, std::memory_order_relaxed);
+            nanoseconds[i].store(0, std::memory_order_relaxed);
+        }
+
+        Registry &r = registry();
+        std::lock_guard<std::mutex> lock(r.mutex);
+        r.liveThreads.push_back(this);
+    }
+
+    ThreadCounters::~ThreadCounters(void)
+    {
+        Registry &r = registry();
+        std::lock_guard<std::mutex> lock(r.mutex);
+        r.exitedThreads += snapshot();
+        r.liveThreads.erase(std::find(r.liveThreads.begin(), r.liveThreads.end(), this));
+    }
+
+    inline ThreadCounters &threadCounters(void)
+    {
+        thread_local ThreadCounters counters;
+        return counters;
+    }
+
+    inline void count(Counter counter, uint64_t amount)
+    {
+        ThreadCounters &counters = threadCounters();
+        counters.add(counters.counts[counter], amount);
+    }
+
+    //counts the operation it's given, and adds the time until it goes out of scope to that operation's total
+    class ScopedTimer
+    {
+    public:
+        inline ScopedTimer(Counter counter, uint64_t amount)
+            :counter(counter), begin(std::chrono::steady_clock::now())
+        {
+            count(counter, amount);
+        }
+        inline ~ScopedTimer(void)
+        {
+            auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - begin);
+            ThreadCounters &counters = threadCounters();
+            counters.add(counters.nanoseconds[counter], uint64_t(elapsed.count()));
+        }
+
+        ScopedTimer(const ScopedTimer &) = delete;
+        ScopedTimer &operator=(const ScopedTimer &) = delete;
+
+    private:
+        Counter counter;
+        std::chrono::steady_clock::time_point begin;
+    };
+}
+
+SplineInstrumentation::Counters SplineInstrumentation::threadSnapshot(void)
+{
+    return __SplineInstrumentationPrivate::threadCounters().snapshot();
+}
+
+SplineInstrumentation::Counters SplineInstrumentation::globalSnapshot(void)
+{
+    __SplineInstrumentationPrivate::Registry &r = __SplineInstrumentationPrivate::registry();
+    std::lock_guard<std::mutex> lock(r.mutex);
+
+    Counters result = r.exitedThreads;
+    for(const __SplineInstrumentationPrivate::ThreadCounters *counters : r.liveThreads)
+    {
+        result += counters->snapshot();
+    }
+    return result;
+}
+
+//SPLINE_LIBRARY_COUNT(counter, amount) adds amount to the given counter
+//SPLINE_LIBRARY_TIMED_SCOPE(counter, amount) adds amount to the given counter, and also adds the time spent in the rest of the enclosing scope if timing is enabled
+#if defined(SPLINE_LIBRARY_INSTRUMENTATION)
+    #define SPLINE_LIBRARY_COUNT(counter, amount) \
+        __SplineInstrumentationPrivate::count(SplineInstrumentation::counter, uint64_t(amount))
+#else
+    #define SPLINE_LIBRARY_COUNT(counter, amount) ((void)0)
+#endif
+
+#if defined(SPLINE_LIBRARY_INSTRUMENTATION_TIMING)
+    #define SPLINE_LIBRARY_TIMED_SCOPE(counter, amount) \
+        __SplineInstrumentationPrivate::ScopedTimer splineLibraryScopedTimer(SplineInstrumentation::counter, uint64_t(amount))
+#else
+    #define SPLINE_LIBRARY_TIMED_SCOPE(counter, amount) SPLINE_LIBRARY_COUNT(counter, amount)
+#endif
@@ -0,0 +1,189 @@
+#pragma once
+
+#include <vector>
+#include <algorithm>
+#include <cassert>
+
+#include "spline_common.h"
+
+//keeps a spline's knots up to date as its points are edited one at a time, without recomputing the distance in t between every pair of points
+//this is for splines without any padding points: the knots of a non-looping spline go from 0 to points.size() - 1,
+//and the knots of a looping spline go from 0 to points.size() with the first point repeated at the end
+template<class InterpolationType, typename floating_t>
+class SplineKnotEditor
+{
+public:
+    enum EditType { Set, Insert, Remove };
+
+    //scratch space for re-solving the window of a spline's system that an edit touches, IE the natural spline's curvatures, so that once it's big enough, editing doesn't allocate
+    //like SplineCommon::RetainedBuildScratch, it isn't part of the editor's value, so a copy starts without it, and assigning keeps the memory that's already there
+    struct WindowScratch
+    {
+        WindowScratch(void) = default;
+        WindowScratch(const WindowScratch &) {}
+        WindowScratch(WindowScratch &&) = default;
+        WindowScratch &operator=(const WindowScratch &) { return *this; }
+        WindowScratch &operator=(WindowScratch &&) = default;
+
+        //make room for a window of the given number of rows. this only allocates if the window is bigger than any before it
+        inline void resize(size_t size)
+        {
+            diagonal.resize(size);
+            secondaryDiagonal.resize(size);
+            correction.resize(size);
+            values.resize(size);
+        }
+
+        inline size_t heapFootprint(void) const
+        {
+            return SplineCommon::vectorFootprint(diagonal) + SplineCommon::vectorFootprint(secondaryDiagonal)
+                    + SplineCommon::vectorFootprint(correction) + SplineCommon::vectorFootprint(values);
+        }
+
+        std::vector<floating_t> diagonal;
+        std::vector<floating_t> secondaryDiagonal;
+        std::vector<floating_t> correction;
+        std::vector<InterpolationType> values;
+    };
+
+    SplineKnotEditor(floating_t alpha, bool looping)
+        :alpha(alpha), looping(looping), multiplier(1)
+    {}
+
+    //forget everything computed for the old points, after the spline was rebuilt with new ones and the given alpha. keeps the memory for the next edit
+    inline void reset(floating_t newAlpha)
+    {
+        alpha = newAlpha;
+        multiplier = 1;
+        tDiffs.clear();
+    }
+
+    //must be called with the spline's points before every edit. the first time, this computes the distance in t from each point to the next
+    //so splines that are never edited don't pay for storing them
+    void initialize(const std::vector<InterpolationType> &points);
+
+    //update the knots to match the points, after the point at the given index was set, inserted, or removed
+    //every knot after the edit will usually move, but only the distances in t next to the edit are recomputed
+    //returns the factor that the distances in t between every other pair of points were scaled by
+    floating_t update(const std::vector<InterpolationType> &points, std::vector<floating_t> &knots, size_t index, EditType type);
+
+    //the same, for splines that keep their knots in SplineCommon::Knots
+    inline floating_t update(const std::vector<InterpolationType> &points, SplineCommon::Knots<floating_t, false> &knots, size_t index, EditType type)
+    {
+        return update(points, knots.edit(), index, type);
+    }
+
+    //uniform knots are always 0, 1, 2, etc, so only the number of knots changes
+    inline floating_t update(const std::vector<InterpolationType> &points, SplineCommon::Knots<floating_t, true> &knots, size_t, EditType)
+    {
+        assert(alpha == 0);
+        knots.resize(looping ? points.size() + 1 : points.size());
+        return 1;
+    }
+
+    inline WindowScratch &windowScratch(void) { return scratch; }
+
+    //the number of bytes this editor has allocated, which is nothing until the first edit
+    inline size_t heapFootprint(void) const { return SplineCommon::vectorFootprint(tDiffs) + scratch.heapFootprint(); }
+
+private:
+    void recomputeTDiff(const std::vector<InterpolationType> &points, size_t diffIndex);
+
+    floating_t alpha;
+    bool looping;
+
+    //tDiffs[i] is the unnormalized distance in t from point i to point i + 1, and multiplier is the factor that normalizes them
+    //when alpha is 0 every distance is 1 and neither is needed
+    std::vector<floating_t> tDiffs;
+    floating_t multiplier;
+
+    WindowScratch scratch;
+};
+
+template<class InterpolationType, typename floating_t>
+void SplineKnotEditor<InterpolationType, floating_t>::initialize(const std::vector<InterpolationType> &points)
+{
+    if(alpha == 0 || !tDiffs.empty())
+        return;
+
+    size_t diffCount = looping ? points.size() : points.size() - 1;
+    tDiffs.resize(diffCount);
+
+    floating_t total = 0;
+    for(size_t i = 0; i < diffCount; i++)
+    {
+        recomputeTDiff(points, i);
+        total += tDiffs[i];
+    }
+    multiplier = diffCount / total;
+}
+
+template<class InterpolationType, typename floating_t>
+floating_t SplineKnotEditor<InterpolationType, floating_t>::update(const std::vector<InterpolationType> &points, std::vector<floating_t> &knots, size_t index, EditType type)
+{
+    size_t diffCount = looping ? points.size() : points.size() - 1;
+
+    //with uniform t values, knot i is just i, so the only change is the number of knots
+    if(alpha == 0)
+    {
+        size_t oldSize = knots.size();
+        knots.resize(diffCount + 1);
+        for(size_t i = oldSize; i < knots.size(); i++)
+        {
+            knots[i] = floating_t(i);
+        }
+        return 1;
+    }
+
+    assert(!tDiffs.empty());
+
+    //inserting a point splits one distance in two, and removing a point merges two distances into one
+    //either way, the diffs after the edit just shift over, so make room and then recompute the ones that touch the edited point
+    if(type == Insert)
+    {
+        tDiffs.insert(tDiffs.begin() + std::min(index, tDiffs.size()), floating_t(0));
+    }
+    else if(type == Remove)
+    {
+        tDiffs.erase(tDiffs.begin() + std::min(index, tDiffs.size() - 1));
+    }
+
+    //the distance from the previous point to the edited one. removing the last point of a non-looping spline doesn't leave one
+    if(index > 0)
+    {
+        if(index - 1 < diffCount)
+            recomputeTDiff(points, index - 1);
+    }
+    else if(looping)
+    {
+        recomputeTDiff(points, diffCount - 1);
+    }
+
+    if(type != Remove && index < diffCount)
+    {
+        recomputeTDiff(points, index);
+    }
+
+    //rebuild the knots from the diffs exactly the same way SplineCommon::computeTValuesWithInnerPadding would
+    knots.resize(diffCount + 1);
+    knots[0] = 0;
+    for(size_t i = 0; i < diffCount; i++)
+    {
+        knots[i + 1] = knots[i] + tDiffs[i];
+    }
+
+    floating_t oldMultiplier = multiplier;
+    multiplier = diffCount / knots[diffCount];
+    for(auto &knot : knots)
+    {
+        knot *= multiplier;
+    }
+
+    return multiplier / oldMultiplier;
+}
+
+template<class InterpolationType, typename floating_t>
+void SplineKnotEditor<InterpolationType, floating_t>::recomputeTDiff(const std::vector<InterpolationType> &points, size_t diffIndex)
+{
+    tDiffs[diffIndex] = SplineCommon::computeTDiff(points[diffIndex], points[(diffIndex + 1) % points.size()], alpha);
+}
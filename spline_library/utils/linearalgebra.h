@@ -1,6 +1,32 @@
 #pragma once
 
 #include <vector>
+#include <array>
+#include <algorithm>
+#include <cassert>
+
+#include "instrumentation.h"
+
+//a tridiagonal matrix that has already been through the forward sweep of the thomas algorithm,
+//so that systems using it can be solved without repeating any of the work that depends only on the matrix
+//it owns its storage, so refactoring a different matrix of the same size or smaller into an existing factorization doesn't allocate
+template<typename floating_t>
+struct TridiagonalFactorization
+{
+    size_t size = 0;
+
+    //the reciprocal of each element of the main diagonal after the forward sweep, the multiplier used to eliminate each lower diagonal element,
+    //and a copy of the upper diagonal
+    std::vector<floating_t> inverseDiagonal;
+    std::vector<floating_t> multipliers;
+    std::vector<floating_t> upperDiagonal;
+
+    //for cyclic systems only: the sherman-morrison correction vector, and the constants needed to apply it
+    bool cyclic = false;
+    std::vector<floating_t> correction;
+    floating_t cornerMultiplier = 0;
+    floating_t inverseCorrectionDenominator = 0;
+};
 
 class LinearAlgebra
 {
@@ -9,13 +35,16 @@ private:
 
 public:
 
+    //the vector-based solvers take mainDiagonal and inputVector by value and use them as scratch space,
+    //so pass them with std::move to solve without allocating anything but the cyclic solver's correction vector
+
     //solve the given tridiagonal matrix system, with the assumption that the lower diagonal and upper diagonal (ie secondaryDiagonal) are identical.
     //in other words, assume that the matrix is symmetric
     template<class OutputType, typename floating_t>
     static std::vector<OutputType> solveSymmetricTridiagonal(
 
             std::vector<floating_t> mainDiagonal,
-            const std::vector<floating_t> secondaryDiagonal,
+            const std::vector<floating_t> &secondaryDiagonal,
             std::vector<OutputType> inputVector);
 
     //solve the given tridiagonal matrix system
@@ -23,8 +52,8 @@ public:
     static std::vector<OutputType> solveTridiagonal(
 
             std::vector<floating_t> mainDiagonal,
-            const std::vector<floating_t> upperDiagonal,
-            const std::vector<floating_t> lowerDiagonal,
+            const std::vector<floating_t> &upperDiagonal,
+            const std::vector<floating_t> &lowerDiagonal,
             std::vector<OutputType> inputVector);
 
     //solve the given cyclic tridiagonal matrix system, with the assumption that the lower diagonal and upper diagonal (ie secondaryDiagonal) are identical
@@ -33,23 +62,147 @@ public:
     static std::vector<OutputType> solveCyclicSymmetricTridiagonal(
 
             std::vector<floating_t> mainDiagonal,
-            std::vector<floating_t> secondaryDiagonal,
+            const std::vector<floating_t> &secondaryDiagonal,
             std::vector<OutputType> inputVector);
+
+    //the same three solvers, working in place on arrays of size elements so that nothing is allocated. each does exactly the same arithmetic as the vector version
+    //mainDiagonal is used as scratch space, values holds the right hand side and is replaced with the solution, and correction is scratch space for the cyclic solver
+    template<class OutputType, typename floating_t>
+    static void solveSymmetricTridiagonalInPlace(
+            floating_t *mainDiagonal,
+            const floating_t *secondaryDiagonal,
+            OutputType *values,
+            size_t size);
+
+    template<class OutputType, typename floating_t>
+    static void solveTridiagonalInPlace(
+            floating_t *mainDiagonal,
+            const floating_t *upperDiagonal,
+            const floating_t *lowerDiagonal,
+            OutputType *values,
+            size_t size);
+
+    template<class OutputType, typename floating_t>
+    static void solveCyclicSymmetricTridiagonalInPlace(
+            floating_t *mainDiagonal,
+            const floating_t *secondaryDiagonal,
+            OutputType *values,
+            floating_t *correction,
+            size_t size);
+
+    //factor the given tridiagonal matrix into "factorization", reusing its memory. upperDiagonal and lowerDiagonal have size - 1 elements
+    template<typename floating_t>
+    static void factorTridiagonal(
+            const floating_t *mainDiagonal,
+            const floating_t *upperDiagonal,
+            const floating_t *lowerDiagonal,
+            size_t size,
+            TridiagonalFactorization<floating_t> &factorization);
+
+    //factor the given symmetric tridiagonal matrix. secondaryDiagonal has size - 1 elements
+    template<typename floating_t>
+    static void factorSymmetricTridiagonal(
+            const floating_t *mainDiagonal,
+            const floating_t *secondaryDiagonal,
+            size_t size,
+            TridiagonalFactorization<floating_t> &factorization);
+
+    //factor the given cyclic symmetric tridiagonal matrix. like solveCyclicSymmetricTridiagonal, secondaryDiagonal has size elements,
+    //and the last one is the corner value
+    template<typename floating_t>
+    static void factorCyclicSymmetricTridiagonal(
+            const floating_t *mainDiagonal,
+            const floating_t *secondaryDiagonal,
+            size_t size,
+            TridiagonalFactorization<floating_t> &factorization);
+
+    //solve rhsCount systems that all use the factored matrix, in place. values holds each right hand side one after another,
+    //each factorization.size elements long, and each is replaced with its solution. nothing is allocated
+    template<class OutputType, typename floating_t>
+    static void solveFactored(
+            const TridiagonalFactorization<floating_t> &factorization,
+            OutputType *values,
+            size_t rhsCount = 1);
+
+    //solve systemCount independent symmetric tridiagonal systems of the same size at once, in place. every array is interleaved:
+    //element i of system s is at index i * systemCount + s. mainDiagonal and secondaryDiagonal have size * systemCount elements,
+    //and the last secondary element of each system is ignored. mainDiagonal is used as scratch space, and values is replaced with the solutions
+    //each system does exactly the same arithmetic as solveSymmetricTridiagonal, but the inner loop runs across systems instead of down a single one,
+    //so the sweeps no longer wait on the previous row's result, and the scalar parts vectorize
+    template<class OutputType, typename floating_t>
+    static void solveSymmetricTridiagonalInterleaved(
+            floating_t *mainDiagonal,
+            const floating_t *secondaryDiagonal,
+            OutputType *values,
+            size_t size,
+            size_t systemCount);
+
+    //the same for cyclic systems, doing the same arithmetic as solveCyclicSymmetricTridiagonal. the last secondary element of each system is its corner value
+    //correction is scratch space for size * systemCount elements
+    template<class OutputType, typename floating_t>
+    static void solveCyclicSymmetricTridiagonalInterleaved(
+            floating_t *mainDiagonal,
+            const floating_t *secondaryDiagonal,
+            OutputType *values,
+            floating_t *correction,
+            size_t size,
+            size_t systemCount);
+
+    //solve the given symmetric positive definite banded matrix system, where every nonzero element is within bandwidth of the main diagonal
+    //bands holds the main diagonal and the bandwidth diagonals above it, row by row: element (i, i + k) is at bands[i * (bandwidth + 1) + k],
+    //and the elements past the end of the matrix are ignored. a bandwidth of 1 is a symmetric tridiagonal matrix
+    //this is an LDL^T factorization, which never takes a square root, so it works on any OutputType with the same operators as the tridiagonal solvers
+    template<class OutputType, typename floating_t>
+    static std::vector<OutputType> solveSymmetricBanded(
+            std::vector<floating_t> bands,
+            size_t bandwidth,
+            std::vector<OutputType> inputVector);
+
+    //the same, in place. bands is replaced with the factorization, and values holds the right hand side and is replaced with the solution
+    template<class OutputType, typename floating_t>
+    static void solveSymmetricBandedInPlace(
+            floating_t *bands,
+            size_t bandwidth,
+            OutputType *values,
+            size_t size);
+
+private:
+    //the interleaved solvers process this many systems at a time in their forward sweeps
+    static const size_t interleavedChunkSize = 64;
+
+    //the forward and backward sweeps of the thomas algorithm for a single right hand side, without any cyclic correction
+    template<class OutputType, typename floating_t>
+    static void solveFactoredNonCyclic(const TridiagonalFactorization<floating_t> &factorization, OutputType *values);
 };
 
 template<class OutputType, typename floating_t>
 std::vector<OutputType> LinearAlgebra::solveTridiagonal(
 
         std::vector<floating_t> mainDiagonal,
-        const std::vector<floating_t> upperDiagonal,
-        const std::vector<floating_t> lowerDiagonal,
+        const std::vector<floating_t> &upperDiagonal,
+        const std::vector<floating_t> &lowerDiagonal,
         std::vector<OutputType> inputVector)
 {
+    solveTridiagonalInPlace(mainDiagonal.data(), upperDiagonal.data(), lowerDiagonal.data(), inputVector.data(), inputVector.size());
+    return inputVector;
+}
+
+template<class OutputType, typename floating_t>
+void LinearAlgebra::solveTridiagonalInPlace(
+
+        floating_t *mainDiagonal,
+        const floating_t *upperDiagonal,
+        const floating_t *lowerDiagonal,
+        OutputType *inputVector,
+        size_t size)
+{
+    SPLINE_LIBRARY_TIMED_SCOPE(TridiagonalSolves, 1);
+
     //use the thomas algorithm to solve the tridiagonal matrix
     // http://en.wikipedia.org/wiki/Tridiagonal_matrix_algorithm
 
     //forward sweep
-    for(size_t i = 1; i < inputVector.size(); i++)
+    for(size_t i = 1; i < size; i++)
     {
         floating_t m = lowerDiagonal[i - 1] / mainDiagonal[i - 1];
         mainDiagonal[i] -= m * upperDiagonal[i - 1];
@@ -57,29 +210,41 @@ std::vector<OutputType> LinearAlgebra::solveTridiagonal(
     }
 
     //back substitution
-    size_t finalIndex = inputVector.size();
+    size_t finalIndex = size;
     inputVector[finalIndex - 1] /= mainDiagonal[finalIndex - 1];
 
     for(size_t i = finalIndex - 1; i > 0; i--)
     {
         inputVector[i - 1] = (inputVector[i - 1] - upperDiagonal[i - 1] * inputVector[i]) / mainDiagonal[i - 1];
     }
-
-    return inputVector;
 }
 
 template<class OutputType, typename floating_t>
 std::vector<OutputType> LinearAlgebra::solveSymmetricTridiagonal(
 
         std::vector<floating_t> mainDiagonal,
-        const std::vector<floating_t> secondaryDiagonal,
+        const std::vector<floating_t> &secondaryDiagonal,
         std::vector<OutputType> inputVector)
 {
+    solveSymmetricTridiagonalInPlace(mainDiagonal.data(), secondaryDiagonal.data(), inputVector.data(), inputVector.size());
+    return inputVector;
+}
+
+template<class OutputType, typename floating_t>
+void LinearAlgebra::solveSymmetricTridiagonalInPlace(
+
+        floating_t *mainDiagonal,
+        const floating_t *secondaryDiagonal,
+        OutputType *inputVector,
+        size_t size)
+{
+    SPLINE_LIBRARY_TIMED_SCOPE(TridiagonalSolves, 1);
+
     //use the thomas algorithm to solve the tridiagonal matrix
     // http://en.wikipedia.org/wiki/Tridiagonal_matrix_algorithm
 
     //forward sweep
-    for(size_t i = 1; i < inputVector.size(); i++)
+    for(size_t i = 1; i < size; i++)
     {
         floating_t m = secondaryDiagonal[i - 1] / mainDiagonal[i - 1];
         mainDiagonal[i] -= m * secondaryDiagonal[i - 1];
@@ -87,77 +252,418 @@ std::vector<OutputType> LinearAlgebra::solveSymmetricTridiagonal(
     }
 
     //back substitution
-    size_t finalIndex = inputVector.size();
+    size_t finalIndex = size;
     inputVector[finalIndex - 1] /= mainDiagonal[finalIndex - 1];
 
     for(size_t i = finalIndex - 1; i > 0; i--)
     {
         inputVector[i - 1] = (inputVector[i - 1] - secondaryDiagonal[i - 1] * inputVector[i]) / mainDiagonal[i - 1];
     }
-
-    return inputVector;
 }
 
 template<class OutputType, typename floating_t>
 std::vector<OutputType> LinearAlgebra::solveCyclicSymmetricTridiagonal(
 
         std::vector<floating_t> mainDiagonal,
-        std::vector<floating_t> secondaryDiagonal,
+        const std::vector<floating_t> &secondaryDiagonal,
         std::vector<OutputType> inputVector)
 {
+    assert(secondaryDiagonal.size() >= inputVector.size());
+
+    std::vector<floating_t> correctionOutput(inputVector.size());
+    solveCyclicSymmetricTridiagonalInPlace(mainDiagonal.data(), secondaryDiagonal.data(), inputVector.data(), correctionOutput.data(), inputVector.size());
+    return inputVector;
+}
+
+template<class OutputType, typename floating_t>
+void LinearAlgebra::solveCyclicSymmetricTridiagonalInPlace(
+
+        floating_t *mainDiagonal,
+        const floating_t *secondaryDiagonal,
+        OutputType *inputVector,
+        floating_t *correctionOutput,
+        size_t size)
+{
+    SPLINE_LIBRARY_TIMED_SCOPE(TridiagonalSolves, 1);
+
     //apply the sherman-morrison algorithm to the cyclic tridiagonal matrix so that we can use the standard tridiagonal algorithm
     //we're getting this algorithm from http://www.cs.princeton.edu/courses/archive/fall11/cos323/notes/cos323_f11_lecture06_linsys2.pdf
     //basically, we're going to solve two different non-cyclic versions of this system and then combine the results
 
-    size_t size = inputVector.size();
-
-
     //the value at the upper right and lower left of the input matrix. it's at the end of the secondary diagonal array because almost all
     //cyclic tridiagonal papers treat it as an extension of the secondary diagonals
-    floating_t cornerValue = secondaryDiagonal.at(size - 1);
+    floating_t cornerValue = secondaryDiagonal[size - 1];
 
     //gamma value - doesn't affect actual output (the algorithm makes sure it cancels out), but a good choice for this value can reduce floating point errors
-    floating_t gamma = -mainDiagonal.at(0);
+    floating_t gamma = -mainDiagonal[0];
     floating_t cornerMultiplier = cornerValue/gamma;
 
     //corrective vector U: should be all 0, except for gamma in the first element, and cornerValue at the end
-    std::vector<floating_t> correctionInputU(size);
-    correctionInputU[0] = gamma;
-    correctionInputU[size - 1] = cornerValue;
+    std::fill(correctionOutput, correctionOutput + size, floating_t(0));
+    correctionOutput[0] = gamma;
+    correctionOutput[size - 1] = cornerValue;
 
     //modify the main diagonal of the matrix to account for the correction vector
     mainDiagonal[0] -= gamma;
     mainDiagonal[size - 1] -= cornerValue * cornerMultiplier;
 
-    //solve the modified system for the input vector
-    std::vector<OutputType> initialOutput = solveSymmetricTridiagonal(
-                mainDiagonal,
-                secondaryDiagonal,
-                std::move(inputVector)
-                );
+    //solve the modified system for the input vector and the correction vector at the same time. this is exactly what solveSymmetricTridiagonal
+    //would do to each of them, but sharing the sweeps means the main diagonal only has to be modified once, instead of copied for the second solve
+    for(size_t i = 1; i < size; i++)
+    {
+        floating_t m = secondaryDiagonal[i - 1] / mainDiagonal[i - 1];
+        mainDiagonal[i] -= m * secondaryDiagonal[i - 1];
+        inputVector[i] -= m * inputVector[i - 1];
+        correctionOutput[i] -= m * correctionOutput[i - 1];
+    }
 
-    //solve the modified system for the correction vector
-    std::vector<floating_t> correctionOutput = solveSymmetricTridiagonal(
-                std::move(mainDiagonal),
-                std::move(secondaryDiagonal),
-                std::move(correctionInputU)
-                );
+    inputVector[size - 1] /= mainDiagonal[size - 1];
+    correctionOutput[size - 1] /= mainDiagonal[size - 1];
+    for(size_t i = size - 1; i > 0; i--)
+    {
+        inputVector[i - 1] = (inputVector[i - 1] - secondaryDiagonal[i - 1] * inputVector[i]) / mainDiagonal[i - 1];
+        correctionOutput[i - 1] = (correctionOutput[i - 1] - secondaryDiagonal[i - 1] * correctionOutput[i]) / mainDiagonal[i - 1];
+    }
 
     //compute the corrective OutputType to apply to each initial output
     //this involves a couple dot products, but all of the elements on the correctionV vector are 0 except the first and last
     //so just compute those directly instead of looping through and multplying a bunch of 0s
-    OutputType factor = (initialOutput.at(0) + initialOutput.at(size - 1) * cornerMultiplier) / (1 + correctionOutput.at(0) + correctionOutput.at(size - 1) * cornerMultiplier);
-
-    /*std::vector<floating_t> correctionV(size);
-    correctionV[0] = 1;
-    correctionV[size - 1] = cornerMultiplier;
-    OutputType factor = vectorDotProduct(initialOutput, correctionV) / (1 + vectorDotProduct(correctionV, correctionOutput));*/
+    OutputType factor = (inputVector[0] + inputVector[size - 1] * cornerMultiplier) / (1 + correctionOutput[0] + correctionOutput[size - 1] * cornerMultiplier);
 
     //use the correction factor to modify the result
     for(size_t i = 0; i < size; i++)
     {
-        initialOutput[i] -= factor * correctionOutput.at(i);
+        inputVector[i] -= factor * correctionOutput[i];
+    }
+}
+
+
+template<typename floating_t>
+void LinearAlgebra::factorTridiagonal(
+        const floating_t *mainDiagonal,
+        const floating_t *upperDiagonal,
+        const floating_t *lowerDiagonal,
+        size_t size,
+        TridiagonalFactorization<floating_t> &factorization)
+{
+    assert(size > 0);
+
+    factorization.size = size;
+    factorization.cyclic = false;
+    factorization.inverseDiagonal.resize(size);
+    factorization.multipliers.resize(size);
+    factorization.upperDiagonal.assign(upperDiagonal, upperDiagonal + size - 1);
+
+    //this is the matrix half of the forward sweep in solveTridiagonal. the input vector half is left for solveFactored
+    floating_t diagonal = mainDiagonal[0];
+    factorization.inverseDiagonal[0] = 1 / diagonal;
+    factorization.multipliers[0] = 0;
+    for(size_t i = 1; i < size; i++)
+    {
+        floating_t m = lowerDiagonal[i - 1] * factorization.inverseDiagonal[i - 1];
+        diagonal = mainDiagonal[i] - m * upperDiagonal[i - 1];
+
+        factorization.multipliers[i] = m;
+        factorization.inverseDiagonal[i] = 1 / diagonal;
     }
+}
+
+template<typename floating_t>
+void LinearAlgebra::factorSymmetricTridiagonal(
+        const floating_t *mainDiagonal,
+        const floating_t *secondaryDiagonal,
+        size_t size,
+        TridiagonalFactorization<floating_t> &factorization)
+{
+    factorTridiagonal(mainDiagonal, secondaryDiagonal, secondaryDiagonal, size, factorization);
+}
 
-    return initialOutput;
+template<typename floating_t>
+void LinearAlgebra::factorCyclicSymmetricTridiagonal(
+        const floating_t *mainDiagonal,
+        const floating_t *secondaryDiagonal,
+        size_t size,
+        TridiagonalFactorization<floating_t> &factorization)
+{
+    assert(size >= 3);
+
+    //same sherman-morisson setup as solveCyclicSymmetricTridiagonal: factor a modified non-cyclic matrix,
+    //and solve it for the correction vector once here instead of once per right hand side
+    floating_t cornerValue = secondaryDiagonal[size - 1];
+    floating_t gamma = -mainDiagonal[0];
+    floating_t cornerMultiplier = cornerValue / gamma;
+
+    //the modified diagonal is the only temporary, so keep it in the correction vector's storage until the correction vector itself is needed
+    std::vector<floating_t> &modifiedDiagonal = factorization.correction;
+    modifiedDiagonal.assign(mainDiagonal, mainDiagonal + size);
+    modifiedDiagonal[0] -= gamma;
+    modifiedDiagonal[size - 1] -= cornerValue * cornerMultiplier;
+
+    factorTridiagonal(modifiedDiagonal.data(), secondaryDiagonal, secondaryDiagonal, size, factorization);
+
+    factorization.correction.assign(size, floating_t(0));
+    factorization.correction[0] = gamma;
+    factorization.correction[size - 1] = cornerValue;
+    solveFactoredNonCyclic(factorization, factorization.correction.data());
+
+    factorization.cyclic = true;
+    factorization.cornerMultiplier = cornerMultiplier;
+    factorization.inverseCorrectionDenominator = 1 / (1 + factorization.correction[0] + factorization.correction[size - 1] * cornerMultiplier);
+}
+
+template<class OutputType, typename floating_t>
+void LinearAlgebra::solveFactored(
+        const TridiagonalFactorization<floating_t> &factorization,
+        OutputType *values,
+        size_t rhsCount)
+{
+    SPLINE_LIBRARY_TIMED_SCOPE(TridiagonalSolves, rhsCount);
+
+    size_t size = factorization.size;
+    for(size_t rhs = 0; rhs < rhsCount; rhs++)
+    {
+        OutputType *rhsValues = values + rhs * size;
+        solveFactoredNonCyclic(factorization, rhsValues);
+
+        if(factorization.cyclic)
+        {
+            //the correction vector was solved ahead of time, so all that's left is to subtract the right multiple of it
+            OutputType factor = (rhsValues[0] + rhsValues[size - 1] * factorization.cornerMultiplier) * factorization.inverseCorrectionDenominator;
+            for(size_t i = 0; i < size; i++)
+            {
+                rhsValues[i] -= factor * factorization.correction[i];
+            }
+        }
+    }
+}
+
+template<class OutputType, typename floating_t>
+void LinearAlgebra::solveFactoredNonCyclic(const TridiagonalFactorization<floating_t> &factorization, OutputType *values)
+{
+    size_t size = factorization.size;
+
+    //forward sweep
+    for(size_t i = 1; i < size; i++)
+    {
+        values[i] -= factorization.multipliers[i] * values[i - 1];
+    }
+
+    //back substitution
+    values[size - 1] *= factorization.inverseDiagonal[size - 1];
+    for(size_t i = size - 1; i > 0; i--)
+    {
+        values[i - 1] = (values[i - 1] - factorization.upperDiagonal[i - 1] * values[i]) * factorization.inverseDiagonal[i - 1];
+    }
+}
+
+template<class OutputType, typename floating_t>
+void LinearAlgebra::solveSymmetricTridiagonalInterleaved(
+        floating_t *mainDiagonal,
+        const floating_t *secondaryDiagonal,
+        OutputType *values,
+        size_t size,
+        size_t systemCount)
+{
+    SPLINE_LIBRARY_TIMED_SCOPE(TridiagonalSolves, systemCount);
+
+    assert(size > 0);
+
+    //forward sweep. the scalar half of each row is kept in its own loop so that it vectorizes, and its multipliers are kept
+    //for the values half a fixed-size chunk of systems at a time, so that nothing needs to be allocated
+    std::array<floating_t, interleavedChunkSize> multipliers;
+    for(size_t i = 1; i < size; i++)
+    {
+        for(size_t chunkBegin = 0; chunkBegin < systemCount; chunkBegin += interleavedChunkSize)
+        {
+            size_t chunkSize = std::min(size_t(interleavedChunkSize), systemCount - chunkBegin);
+            size_t previousRow = (i - 1) * systemCount + chunkBegin;
+            size_t row = i * systemCount + chunkBegin;
+
+            for(size_t s = 0; s < chunkSize; s++)
+            {
+                floating_t m = secondaryDiagonal[previousRow + s] / mainDiagonal[previousRow + s];
+                mainDiagonal[row + s] -= m * secondaryDiagonal[previousRow + s];
+                multipliers[s] = m;
+            }
+            for(size_t s = 0; s < chunkSize; s++)
+            {
+                values[row + s] -= multipliers[s] * values[previousRow + s];
+            }
+        }
+    }
+
+    //back substitution
+    size_t lastRow = (size - 1) * systemCount;
+    for(size_t s = 0; s < systemCount; s++)
+    {
+        values[lastRow + s] /= mainDiagonal[lastRow + s];
+    }
+
+    for(size_t i = size - 1; i > 0; i--)
+    {
+        size_t previousRow = (i - 1) * systemCount;
+        size_t row = i * systemCount;
+        for(size_t s = 0; s < systemCount; s++)
+        {
+            values[previousRow + s] = (values[previousRow + s] - secondaryDiagonal[previousRow + s] * values[row + s]) / mainDiagonal[previousRow + s];
+        }
+    }
+}
+
+template<class OutputType, typename floating_t>
+void LinearAlgebra::solveCyclicSymmetricTridiagonalInterleaved(
+        floating_t *mainDiagonal,
+        const floating_t *secondaryDiagonal,
+        OutputType *values,
+        floating_t *correction,
+        size_t size,
+        size_t systemCount)
+{
+    SPLINE_LIBRARY_TIMED_SCOPE(TridiagonalSolves, systemCount);
+
+    assert(size >= 3);
+
+    //the same sherman-morrison setup as solveCyclicSymmetricTridiagonal, for every system at once
+    size_t lastRow = (size - 1) * systemCount;
+    std::fill(correction, correction + size * systemCount, floating_t(0));
+    for(size_t s = 0; s < systemCount; s++)
+    {
+        floating_t cornerValue = secondaryDiagonal[lastRow + s];
+        floating_t gamma = -mainDiagonal[s];
+        floating_t cornerMultiplier = cornerValue / gamma;
+
+        correction[s] = gamma;
+        correction[lastRow + s] = cornerValue;
+
+        mainDiagonal[s] -= gamma;
+        mainDiagonal[lastRow + s] -= cornerValue * cornerMultiplier;
+    }
+
+    //solve the modified system for the values and the correction vector together, sharing the matrix half of each sweep
+    std::array<floating_t, interleavedChunkSize> multipliers;
+    for(size_t i = 1; i < size; i++)
+    {
+        for(size_t chunkBegin = 0; chunkBegin < systemCount; chunkBegin += interleavedChunkSize)
+        {
+            size_t chunkSize = std::min(size_t(interleavedChunkSize), systemCount - chunkBegin);
+            size_t previousRow = (i - 1) * systemCount + chunkBegin;
+            size_t row = i * systemCount + chunkBegin;
+
+            for(size_t s = 0; s < chunkSize; s++)
+            {
+                floating_t m = secondaryDiagonal[previousRow + s] / mainDiagonal[previousRow + s];
+                mainDiagonal[row + s] -= m * secondaryDiagonal[previousRow + s];
+                correction[row + s] -= m * correction[previousRow + s];
+                multipliers[s] = m;
+            }
+            for(size_t s = 0; s < chunkSize; s++)
+            {
+                values[row + s] -= multipliers[s] * values[previousRow + s];
+            }
+        }
+    }
+
+    for(size_t s = 0; s < systemCount; s++)
+    {
+        values[lastRow + s] /= mainDiagonal[lastRow + s];
+        correction[lastRow + s] /= mainDiagonal[lastRow + s];
+    }
+    for(size_t i = size - 1; i > 0; i--)
+    {
+        size_t previousRow = (i - 1) * systemCount;
+        size_t row = i * systemCount;
+        for(size_t s = 0; s < systemCount; s++)
+        {
+            correction[previousRow + s] = (correction[previousRow + s] - secondaryDiagonal[previousRow + s] * correction[row + s]) / mainDiagonal[previousRow + s];
+        }
+        for(size_t s = 0; s < systemCount; s++)
+        {
+            values[previousRow + s] = (values[previousRow + s] - secondaryDiagonal[previousRow + s] * values[row + s]) / mainDiagonal[previousRow + s];
+        }
+    }
+
+    for(size_t s = 0; s < systemCount; s++)
+    {
+        //the sweeps never touch the first row's diagonal, which is exactly twice the original after the setup above, so the gamma can be recovered exactly
+        floating_t gamma = -mainDiagonal[s] / 2;
+        floating_t cornerMultiplier = secondaryDiagonal[lastRow + s] / gamma;
+
+        OutputType factor = (values[s] + values[lastRow + s] * cornerMultiplier) / (1 + correction[s] + correction[lastRow + s] * cornerMultiplier);
+        for(size_t i = 0; i < size; i++)
+        {
+            values[i * systemCount + s] -= factor * correction[i * systemCount + s];
+        }
+    }
+}
+
+template<class OutputType, typename floating_t>
+std::vector<OutputType> LinearAlgebra::solveSymmetricBanded(
+
+        std::vector<floating_t> bands,
+        size_t bandwidth,
+        std::vector<OutputType> inputVector)
+{
+    assert(bands.size() >= inputVector.size() * (bandwidth + 1));
+    solveSymmetricBandedInPlace(bands.data(), bandwidth, inputVector.data(), inputVector.size());
+    return inputVector;
+}
+
+template<class OutputType, typename floating_t>
+void LinearAlgebra::solveSymmetricBandedInPlace(
+
+        floating_t *bands,
+        size_t bandwidth,
+        OutputType *values,
+        size_t size)
+{
+    const size_t stride = bandwidth + 1;
+
+    //factor the matrix into L * D * L^T, where L is unit lower triangular with the same bandwidth. row j's diagonal is replaced with D(j),
+    //and each element (j, i) above the diagonal is replaced with L(i, j), which is the last thing that will ever read it
+    for(size_t j = 0; j < size; j++)
+    {
+        size_t firstK = j > bandwidth ? j - bandwidth : 0;
+
+        floating_t diagonal = bands[j * stride];
+        for(size_t k = firstK; k < j; k++)
+        {
+            floating_t l = bands[k * stride + (j - k)];
+            diagonal -= l * l * bands[k * stride];
+        }
+        bands[j * stride] = diagonal;
+        assert(diagonal > 0);
+
+        size_t lastI = std::min(size - 1, j + bandwidth);
+        for(size_t i = j + 1; i <= lastI; i++)
+        {
+            //L(i, k) is only nonzero within bandwidth of i, which is a narrower range than for j
+            floating_t element = bands[j * stride + (i - j)];
+            for(size_t k = i > bandwidth ? i - bandwidth : 0; k < j; k++)
+            {
+                element -= bands[k * stride + (i - k)] * bands[k * stride + (j - k)] * bands[k * stride];
+            }
+            bands[j * stride + (i - j)] = element / diagonal;
+        }
+    }
+
+    //forward substitution with L
+    for(size_t i = 1; i < size; i++)
+    {
+        size_t firstK = i > bandwidth ? i - bandwidth : 0;
+        for(size_t k = firstK; k < i; k++)
+        {
+            values[i] -= bands[k * stride + (i - k)] * values[k];
+        }
+    }
+
+    //divide by D, then back substitution with L^T
+    for(size_t i = size; i-- > 0;)
+    {
+        values[i] /= bands[i * stride];
+        size_t lastK = std::min(size - 1, i + bandwidth);
+        for(size_t k = i + 1; k <= lastK; k++)
+        {
+            values[i] -= bands[i * stride + (k - i)] * values[k];
+        }
+    }
 }
@@ -0,0 +1,54 @@
+#pragma once
+
+#include <vector>
+#include <algorithm>
+#include <atomic>
+#include <thread>
+
+namespace SplineCommon
+{
+    //call function(i) for every i in [0, count), split across threadCount threads. if threadCount is 0, use one thread per hardware thread
+    //each thread repeatedly claims the next chunk of chunkSize indexes until there are none left, so threads that finish early pick up the slack
+    //if there's only one chunk of work, everything runs on the calling thread, so small inputs don't pay for starting threads
+    template<class Function>
+    void parallelFor(size_t count, size_t chunkSize, size_t threadCount, const Function &function)
+    {
+        if(count == 0)
+            return;
+
+        if(threadCount == 0)
+            threadCount = std::max(1u, std::thread::hardware_concurrency());
+
+        //don't bother spinning up threads that would have nothing to do
+        size_t chunkCount = (count + chunkSize - 1) / chunkSize;
+        threadCount = std::min(threadCount, chunkCount);
+
+        //chunks are contiguous, so neighboring indexes (like neighboring pixels, or neighboring segments) stay on the same thread
+        std::atomic<size_t> nextChunk(0);
+        auto worker = [&]() {
+            for(size_t chunk = nextChunk++; chunk < chunkCount; chunk = nextChunk++)
+            {
+                size_t begin = chunk * chunkSize;
+                size_t end = std::min(count, begin + chunkSize);
+                for(size_t i = begin; i < end; i++)
+                {
+                    function(i);
+                }
+            }
+        };
+
+        //the calling thread does its share of the work too
+        std::vector<std::thread> threads;
+        threads.reserve(threadCount - 1);
+        for(size_t i = 1; i < threadCount; i++)
+        {
+            threads.emplace_back(worker);
+        }
+        worker();
+
+        for(auto &thread : threads)
+        {
+            thread.join();
+        }
+    }
+}
@@ -0,0 +1,197 @@
+#pragma once
+
+#include <array>
+#include <algorithm>
+#include <limits>
+#include <cassert>
+
+#include "../spline.h"
+
+//every segment of every spline type in this library is a polynomial of degree 5 or less, so it can be converted exactly into a quintic bezier curve
+//bezier curves are useful because they never leave the convex hull of their control points, and the same is true of their derivatives
+//so the control points give guaranteed bounds on the curve, where sampling the spline can only give estimates
+//the only exceptions are a GenericBSpline with a degree higher than 5, and a CompiledSpline of degree 7, which aren't supported
+namespace QuinticBezier
+{
+    template<class InterpolationType>
+    using ControlPoints = std::array<InterpolationType, 6>;
+
+    //the control points of the bezier curve that matches the given spline segment exactly, parameterized from 0 at the beginning of the segment to 1 at the end
+    template<class InterpolationType, typename floating_t>
+    ControlPoints<InterpolationType> fromSegment(const Spline<InterpolationType, floating_t> &spline, size_t segmentIndex);
+
+    //split a bezier curve in half with de casteljau's algorithm. both halves are parameterized from 0 to 1 again
+    template<class InterpolationType>
+    void split(const ControlPoints<InterpolationType> &controlPoints, ControlPoints<InterpolationType> &left, ControlPoints<InterpolationType> &right);
+
+    //evaluate a bezier curve and its first two derivatives with respect to u
+    template<class InterpolationType, typename floating_t>
+    void evaluate(const ControlPoints<InterpolationType> &controlPoints, floating_t u, InterpolationType &position, InterpolationType &tangent, InterpolationType &curvature);
+
+    //the square of the largest distance from any of the inner control points to the line segment between the first and last control point
+    //the whole curve is inside the control points' convex hull, so its distance from the line segment is no larger than this
+    //floating_t can't be deduced from the control points, so it comes first: call this as flatnessSquared<floating_t>(controlPoints)
+    template<typename floating_t, class InterpolationType>
+    floating_t flatnessSquared(const ControlPoints<InterpolationType> &controlPoints);
+
+    //convert a bezier curve to power basis coefficients in terms of u, lowest power first. call this as powerBasis<floating_t>(controlPoints)
+    template<typename floating_t, class InterpolationType>
+    std::array<InterpolationType, 6> powerBasis(const ControlPoints<InterpolationType> &controlPoints);
+
+    //convert a bezier curve to power basis coefficients, lowest power first, in terms of a centered local t that goes from -0.5 at u = 0 to 0.5 at u = 1
+    //centering keeps the high degree coefficients small, which matters in single precision. call this as centeredPowerBasis<floating_t>(controlPoints)
+    template<typename floating_t, class InterpolationType>
+    std::array<InterpolationType, 6> centeredPowerBasis(const ControlPoints<InterpolationType> &controlPoints);
+}
+
+template<class InterpolationType, typename floating_t>
+QuinticBezier::ControlPoints<InterpolationType> QuinticBezier::fromSegment(const Spline<InterpolationType, floating_t> &spline, size_t segmentIndex)
+{
+    floating_t beginT = spline.segmentT(segmentIndex);
+    floating_t endT = spline.segmentT(segmentIndex + 1);
+
+    //a quintic polynomial is completely determined by its position, first derivative and second derivative at both ends
+    //so these control points give exactly the same curve as the segment, if the segment's degree is 5 or less
+    auto begin = spline.getCurvatureInSegment(segmentIndex, beginT);
+    auto end = spline.getCurvatureInSegment(segmentIndex, endT);
+    floating_t h = endT - beginT;
+
+    ControlPoints<InterpolationType> controlPoints = {{
+        begin.position,
+        begin.position + begin.tangent * (h / 5),
+        begin.position + begin.tangent * (h * 2 / 5) + begin.curvature * (h * h / 20),
+        end.position - end.tangent * (h * 2 / 5) + end.curvature * (h * h / 20),
+        end.position - end.tangent * (h / 5),
+        end.position
+    }};
+
+#ifndef NDEBUG
+    //make sure the conversion really was exact, by comparing the middle of the bezier curve to the middle of the segment
+    InterpolationType middle, middleTangent, middleCurvature;
+    evaluate(controlPoints, floating_t(0.5), middle, middleTangent, middleCurvature);
+    floating_t error = (middle - spline.getPositionInSegment(segmentIndex, beginT + h / 2)).length();
+
+    floating_t size = 0;
+    for(const auto &controlPoint : controlPoints)
+    {
+        size = std::max(size, floating_t((controlPoint - controlPoints[0]).length()));
+    }
+
+    //far from t = 0, t itself is only so precise, and the segment moves by its speed times that much between representable t values
+    const floating_t epsilon = std::numeric_limits<floating_t>::epsilon();
+    floating_t speed = std::max(begin.tangent.length(), end.tangent.length());
+    floating_t tPrecision = std::max(std::abs(beginT), std::abs(endT)) * epsilon;
+    floating_t positionPrecision = std::max(begin.position.length(), end.position.length()) * epsilon;
+    assert(error <= size * floating_t(1e-3) + 16 * (speed * tPrecision + positionPrecision) + epsilon);
+#endif
+
+    return controlPoints;
+}
+
+template<class InterpolationType>
+void QuinticBezier::split(const ControlPoints<InterpolationType> &controlPoints, ControlPoints<InterpolationType> &left, ControlPoints<InterpolationType> &right)
+{
+    ControlPoints<InterpolationType> working = controlPoints;
+    for(size_t level = 0; level < 6; level++)
+    {
+        left[level] = working[0];
+        right[5 - level] = working[5 - level];
+        for(size_t i = 0; i + level < 5; i++)
+        {
+            working[i] = (working[i] + working[i + 1]) / 2;
+        }
+    }
+}
+
+template<class InterpolationType, typename floating_t>
+void QuinticBezier::evaluate(const ControlPoints<InterpolationType> &controlPoints, floating_t u, InterpolationType &position, InterpolationType &tangent, InterpolationType &curvature)
+{
+    //de casteljau's algorithm: the last three points tell us the second derivative, the last two the first derivative
+    ControlPoints<InterpolationType> working = controlPoints;
+    for(size_t level = 0; level < 3; level++)
+    {
+        for(size_t i = 0; i + level < 5; i++)
+        {
+            working[i] = working[i] + (working[i + 1] - working[i]) * u;
+        }
+    }
+    curvature = (working[2] - working[1] * 2 + working[0]) * 20;
+    working[0] = working[0] + (working[1] - working[0]) * u;
+    working[1] = working[1] + (working[2] - working[1]) * u;
+    tangent = (working[1] - working[0]) * 5;
+    position = working[0] + (working[1] - working[0]) * u;
+}
+
+template<typename floating_t, class InterpolationType>
+floating_t QuinticBezier::flatnessSquared(const ControlPoints<InterpolationType> &controlPoints)
+{
+    InterpolationType chord = controlPoints[5] - controlPoints[0];
+    floating_t chordLengthSquared = chord.lengthSquared();
+
+    floating_t result = 0;
+    for(size_t i = 1; i < 5; i++)
+    {
+        InterpolationType offset = controlPoints[i] - controlPoints[0];
+        if(chordLengthSquared > 0)
+        {
+            floating_t projection = std::min(std::max(floating_t(InterpolationType::dotProduct(offset, chord) / chordLengthSquared), floating_t(0)), floating_t(1));
+            offset = offset - chord * projection;
+        }
+        result = std::max(result, floating_t(offset.lengthSquared()));
+    }
+    return result;
+}
+
+namespace __QuinticBezierPrivate
+{
+    const size_t binomial[6][6] = {
+        {1, 0, 0, 0, 0, 0},
+        {1, 1, 0, 0, 0, 0},
+        {1, 2, 1, 0, 0, 0},
+        {1, 3, 3, 1, 0, 0},
+        {1, 4, 6, 4, 1, 0},
+        {1, 5, 10, 10, 5, 1}
+    };
+}
+
+template<typename floating_t, class InterpolationType>
+std::array<InterpolationType, 6> QuinticBezier::powerBasis(const ControlPoints<InterpolationType> &controlPoints)
+{
+    using __QuinticBezierPrivate::binomial;
+
+    //the kth coefficient is C(5,k) times the kth forward difference of the control points
+    std::array<InterpolationType, 6> uCoefficients;
+    for(size_t k = 0; k < 6; k++)
+    {
+        InterpolationType difference = controlPoints[k];
+        for(size_t j = 0; j < k; j++)
+        {
+            InterpolationType term = controlPoints[j] * floating_t(binomial[k][j]);
+            difference = ((k - j) % 2 == 0) ? difference + term : difference - term;
+        }
+        uCoefficients[k] = difference * floating_t(binomial[5][k]);
+    }
+    return uCoefficients;
+}
+
+template<typename floating_t, class InterpolationType>
+std::array<InterpolationType, 6> QuinticBezier::centeredPowerBasis(const ControlPoints<InterpolationType> &controlPoints)
+{
+    using __QuinticBezierPrivate::binomial;
+    std::array<InterpolationType, 6> uCoefficients = powerBasis<floating_t>(controlPoints);
+
+    //shift to the centered local t = u - 0.5, by expanding each (localT + 0.5)^k
+    std::array<InterpolationType, 6> result;
+    for(size_t j = 0; j < 6; j++)
+    {
+        InterpolationType coefficient = uCoefficients[j];
+        floating_t half = floating_t(0.5);
+        for(size_t k = j + 1; k < 6; k++)
+        {
+            coefficient = coefficient + uCoefficients[k] * (floating_t(binomial[k][j]) * half);
+            half *= floating_t(0.5);
+        }
+        result[j] = coefficient;
+    }
+    return result;
+}
@@ -0,0 +1,225 @@
+#pragma once
+
+#include <cmath>
+#include <cassert>
+
+#include "../spline.h"
+#include "splinecursor.h"
+
+//sweeps an orientation frame along a 3D spline, for extruding tubes and roads, or orienting a camera that follows the spline
+//the frame is rotation minimizing: from one sample to the next, it only turns as much as it has to in order to follow the tangent, so it never twists around the tangent
+//unlike a frenet frame, it's still well defined where the curvature is zero, so it doesn't flip on straight pieces or at inflection points
+//each step carries the previous frame along with the double reflection method (Wang, Juttler, Zheng and Liu, 2008), which only needs the position and tangent at each sample,
+//and the cursor underneath keeps track of the current segment, so each sample costs one tangent evaluation and no segment search
+//
+//InterpolationType must have 3 components, accessed with operator[]. the spline must outlive the generator, and must not be edited while the generator is in use
+template<class InterpolationType, typename floating_t=float>
+class RotationMinimizingFrames
+{
+public:
+    //the tangent, normal and binormal are unit length and perpendicular to each other, and binormal is tangent x normal
+    struct Frame
+    {
+        floating_t t;
+        InterpolationType position;
+        InterpolationType tangent;
+        InterpolationType normal;
+        InterpolationType binormal;
+    };
+
+    //begin at t, with the normal as close as possible to initialNormal. if initialNormal is zero, or parallel to the tangent, any perpendicular direction is used
+    RotationMinimizingFrames(const Spline<InterpolationType, floating_t> &spline, floating_t t = 0, const InterpolationType &initialNormal = InterpolationType());
+
+    inline const Frame &getFrame(void) const { return frame; }
+    inline const SplineCursor<InterpolationType, floating_t> &getCursor(void) const { return cursor; }
+
+    //move by dt, or by the given arc length, carrying the frame along. the same wrapping and clamping rules as SplineCursor apply
+    //the frame depends on the path it took, so the steps should be small enough to follow the spline's turns. IE, stepping across a whole segment at once
+    //still gives a valid frame, but not a very rotation minimizing one
+    void advance(floating_t dt);
+    floating_t advanceLength(floating_t distance);
+
+    //write the frames at the given t values, which must be in increasing order, into output, starting from initialNormal at the first t value
+    static void sampleT(const Spline<InterpolationType, floating_t> &spline, const floating_t *tValues, size_t count, Frame *output,
+                        const InterpolationType &initialNormal = InterpolationType());
+
+    //write count frames into output, evenly spaced in t or in arc length, from the beginning of the spline to the end. count must be at least 2
+    //for a looping spline, the last frame is back at the beginning, with t wrapped to 0. its normal is generally rotated from the first frame's normal,
+    //by however much the loop as a whole twists, so a closed tube has to spread that rotation over its length to meet itself
+    static void sampleUniformT(const Spline<InterpolationType, floating_t> &spline, size_t count, Frame *output,
+                               const InterpolationType &initialNormal = InterpolationType());
+    static void sampleUniformLength(const Spline<InterpolationType, floating_t> &spline, size_t count, Frame *output,
+                                    const InterpolationType &initialNormal = InterpolationType());
+
+private:
+    //evaluate the spline wherever the cursor ended up, and rotate the frame from where it was
+    void moveFrame(void);
+
+    static InterpolationType crossProduct(const InterpolationType &left, const InterpolationType &right);
+
+    //reflect v through the plane perpendicular to the given direction, where directionSquared is its squared length
+    static inline InterpolationType reflect(const InterpolationType &v, const InterpolationType &direction, floating_t directionSquared)
+    {
+        return v - direction * (2 * InterpolationType::dotProduct(direction, v) / directionSquared);
+    }
+
+    SplineCursor<InterpolationType, floating_t> cursor;
+    Frame frame;
+};
+
+template<class InterpolationType, typename floating_t>
+RotationMinimizingFrames<InterpolationType, floating_t>::RotationMinimizingFrames(const Spline<InterpolationType, floating_t> &spline, floating_t t, const InterpolationType &initialNormal)
+    :cursor(spline, t)
+{
+    auto result = cursor.getTangent();
+    frame.t = cursor.getT();
+    frame.position = result.position;
+
+    //a tangent of zero has no direction at all. pick one, so that the frame is still a frame, and the next real tangent will rotate it into place
+    floating_t speed = result.tangent.length();
+    if(speed > 0)
+    {
+        frame.tangent = result.tangent / speed;
+    }
+    else
+    {
+        frame.tangent = InterpolationType();
+        frame.tangent[0] = 1;
+    }
+
+    //remove the part of the initial normal that's along the tangent. if there's nothing left, use the axis that's furthest from the tangent instead
+    InterpolationType normal = initialNormal - frame.tangent * InterpolationType::dotProduct(frame.tangent, initialNormal);
+    if(normal.length() <= initialNormal.length() * floating_t(1e-4))
+    {
+        size_t axis = 0;
+        for(size_t i = 1; i < 3; i++)
+        {
+            if(std::abs(frame.tangent[i]) < std::abs(frame.tangent[axis]))
+                axis = i;
+        }
+        InterpolationType axisVector = InterpolationType();
+        axisVector[axis] = 1;
+        normal = axisVector - frame.tangent * frame.tangent[axis];
+    }
+    frame.normal = normal.normalized();
+    frame.binormal = crossProduct(frame.tangent, frame.normal);
+}
+
+template<class InterpolationType, typename floating_t>
+void RotationMinimizingFrames<InterpolationType, floating_t>::advance(floating_t dt)
+{
+    cursor.advance(dt);
+    moveFrame();
+}
+
+template<class InterpolationType, typename floating_t>
+floating_t RotationMinimizingFrames<InterpolationType, floating_t>::advanceLength(floating_t distance)
+{
+    floating_t moved = cursor.advanceLength(distance);
+    moveFrame();
+    return moved;
+}
+
+template<class InterpolationType, typename floating_t>
+void RotationMinimizingFrames<InterpolationType, floating_t>::moveFrame(void)
+{
+    auto result = cursor.getTangent();
+
+    //where the spline stops, IE at a cusp, keep pointing the same way until it starts moving again
+    floating_t speed = result.tangent.length();
+    InterpolationType nextTangent = speed > 0 ? result.tangent / speed : frame.tangent;
+
+    //the first reflection swaps the two positions, which takes the frame most of the way there
+    InterpolationType normal = frame.normal;
+    InterpolationType tangent = frame.tangent;
+    InterpolationType offset = result.position - frame.position;
+    floating_t offsetSquared = offset.lengthSquared();
+    if(offsetSquared > 0)
+    {
+        normal = reflect(normal, offset, offsetSquared);
+        tangent = reflect(tangent, offset, offsetSquared);
+    }
+
+    //the second reflection lines the reflected tangent up with the new tangent, leaving the normal perpendicular to it
+    InterpolationType tangentOffset = nextTangent - tangent;
+    floating_t tangentOffsetSquared = tangentOffset.lengthSquared();
+    if(tangentOffsetSquared > 0)
+    {
+        normal = reflect(normal, tangentOffset, tangentOffsetSquared);
+    }
+
+    //reflections preserve lengths and angles, so this only removes rounding error, which would otherwise build up over thousands of steps
+    normal = normal - nextTangent * InterpolationType::dotProduct(nextTangent, normal);
+
+    frame.t = cursor.getT();
+    frame.position = result.position;
+    frame.tangent = nextTangent;
+    frame.normal = normal.normalized();
+    frame.binormal = crossProduct(frame.tangent, frame.normal);
+}
+
+template<class InterpolationType, typename floating_t>
+InterpolationType RotationMinimizingFrames<InterpolationType, floating_t>::crossProduct(const InterpolationType &left, const InterpolationType &right)
+{
+    InterpolationType result = InterpolationType();
+    result[0] = left[1] * right[2] - left[2] * right[1];
+    result[1] = left[2] * right[0] - left[0] * right[2];
+    result[2] = left[0] * right[1] - left[1] * right[0];
+    return result;
+}
+
+template<class InterpolationType, typename floating_t>
+void RotationMinimizingFrames<InterpolationType, floating_t>::sampleT(const Spline<InterpolationType, floating_t> &spline, const floating_t *tValues, size_t count, Frame *output,
+                                                                      const InterpolationType &initialNormal)
+{
+    if(count == 0)
+        return;
+
+    RotationMinimizingFrames frames(spline, tValues[0], initialNormal);
+    output[0] = frames.getFrame();
+    for(size_t i = 1; i < count; i++)
+    {
+        assert(tValues[i] >= tValues[i - 1]);
+        frames.advance(tValues[i] - frames.getFrame().t);
+        output[i] = frames.getFrame();
+    }
+}
+
+template<class InterpolationType, typename floating_t>
+void RotationMinimizingFrames<InterpolationType, floating_t>::sampleUniformT(const Spline<InterpolationType, floating_t> &spline, size_t count, Frame *output,
+                                                                             const InterpolationType &initialNormal)
+{
+    assert(count >= 2);
+
+    //aim for each t value directly, instead of adding up steps, so that rounding can't drift
+    floating_t maxT = spline.getMaxT();
+    RotationMinimizingFrames frames(spline, 0, initialNormal);
+    output[0] = frames.getFrame();
+    for(size_t i = 1; i < count; i++)
+    {
+        floating_t targetT = i + 1 == count ? maxT : maxT * i / (count - 1);
+        frames.advance(targetT - frames.getFrame().t);
+        output[i] = frames.getFrame();
+    }
+}
+
+template<class InterpolationType, typename floating_t>
+void RotationMinimizingFrames<InterpolationType, floating_t>::sampleUniformLength(const Spline<InterpolationType, floating_t> &spline, size_t count, Frame *output,
+                                                                                  const InterpolationType &initialNormal)
+{
+    assert(count >= 2);
+
+    //the cursor only integrates the part of each segment that each step covers, so the whole sweep integrates every segment about twice
+    floating_t lengthPerStep = spline.totalLength() / (count - 1);
+    RotationMinimizingFrames frames(spline, 0, initialNormal);
+    output[0] = frames.getFrame();
+    for(size_t i = 1; i + 1 < count; i++)
+    {
+        frames.advanceLength(lengthPerStep);
+        output[i] = frames.getFrame();
+    }
+
+    //the lengths add up to slightly more or less than the total, so the last frame is placed at the end directly
+    frames.advance(spline.getMaxT() - frames.getFrame().t);
+    output[count - 1] = frames.getFrame();
+}
@@ -2,10 +2,35 @@
 
 #include <unordered_map>
 #include <vector>
+#include <memory>
 #include <cmath>
+#include <algorithm>
+#include <cassert>
+#include <type_traits>
+#include <utility>
+
+#include "instrumentation.h"
 
 namespace SplineCommon
 {
+    //the floating point type and interpolation type of a spline class, found from its methods rather than from its template parameters
+    //so that templates like the ArcLength functions work with any spline class, no matter how many template parameters it has
+    //types without a getMaxT, like an ArcLengthTable, have no traits, so overloads that take a spline quietly drop out for them instead of failing to compile
+    template<class...> struct MakeVoid { typedef void type; };
+
+    template<class SplineT, class = void>
+    struct SplineTraits {};
+
+    template<class SplineT>
+    struct SplineTraits<SplineT, typename MakeVoid<decltype(std::declval<const SplineT&>().getMaxT())>::type>
+    {
+        typedef typename std::decay<decltype(std::declval<const SplineT&>().getMaxT())>::type floating_t;
+        typedef typename std::decay<decltype(std::declval<const SplineT&>().getPosition(floating_t()))>::type InterpolationType;
+    };
+
+    template<class SplineT> using SplineFloat = typename SplineTraits<SplineT>::floating_t;
+    template<class SplineT> using SplineInterpolation = typename SplineTraits<SplineT>::InterpolationType;
+
     //compute the T values for the given points, with the given alpha.
     //the distance in T between adjacent points is the magitude of the distance, raised to the power alpha
     template<class InterpolationType, typename floating_t>
@@ -23,6 +48,15 @@ namespace SplineCommon
             size_t innerPadding
             );
 
+    //the same, computed into output, reusing its memory
+    template<class InterpolationType, typename floating_t>
+    void computeTValuesWithInnerPadding(
+            const std::vector<InterpolationType> &points,
+            floating_t alpha,
+            size_t innerPadding,
+            std::vector<floating_t> &output
+            );
+
     //compute the T values for the given points, with the given alpha, for use in a looping spline
     //if padding is zero, this method will return points.size() + 1 points
     //the "extra" point is because the first point in the list is represented at the beginning AND end
@@ -31,27 +65,202 @@ namespace SplineCommon
     template<class InterpolationType, typename floating_t>
     std::vector<floating_t> computeLoopingTValues(const std::vector<InterpolationType> &points, floating_t alpha, size_t padding);
 
+    //the same, computed into output, reusing its memory
+    template<class InterpolationType, typename floating_t>
+    void computeLoopingTValues(const std::vector<InterpolationType> &points, floating_t alpha, size_t padding, std::vector<floating_t> &output);
+
+    //turn the result of computeTValuesWithInnerPadding or computeLoopingTValues into the count knots starting at index padding, in place
+    //so that splines don't have to allocate a second vector just to drop the padding
+    template<typename floating_t>
+    void removeKnotPadding(std::vector<floating_t> &paddedKnots, size_t padding, size_t count);
+
+    //compute the catmull-rom tangent at pCurrent, given its neighbors and the t values of all three
+    //this is written in terms of each neighbor's displacement from pCurrent, so that points far from the origin don't cancel each other out
+    template<class InterpolationType, typename floating_t>
+    InterpolationType computeCatmullRomTangent(
+            const InterpolationType &pPrev, const InterpolationType &pCurrent, const InterpolationType &pNext,
+            floating_t tPrev, floating_t tCurrent, floating_t tNext);
+
+    //the number of bytes allocated by the given vector, for the spline cores' heapFootprint methods
+    template<class T, class Allocator>
+    inline size_t vectorFootprint(const std::vector<T, Allocator> &data) { return data.capacity() * sizeof(T); }
+
+    //replace output with count of the points stored in the given spline core, starting at index begin
+    //this is how splines whose core keeps a copy of the original points rebuild them after discardOriginalPoints
+    template<class SplineCoreT, class InterpolationType>
+    void copyStoredPoints(const SplineCoreT &core, size_t begin, size_t count, std::vector<InterpolationType> &output);
 
 
     //given a list of knots and a t value, return the index of the knot the t value falls within
     template<typename floating_t>
     size_t getIndexForT(const std::vector<floating_t> &knotData, floating_t t);
+
+    //the same, for knots stored outside of a vector
+    template<typename floating_t>
+    size_t getIndexForT(const floating_t *knotData, size_t size, floating_t t);
+
+    //given a spline core, a t value, and a guess for which segment t falls in (usually the segment of the previously evaluated t value)
+    //return the same result as core.segmentForT(t). if t is in the guessed segment or one of its neighbors, this skips the full search
+    template<class SplineCoreT, typename floating_t>
+    size_t segmentForTWithHint(const SplineCoreT &core, floating_t t, size_t hint);
+
+    //the squared length of a polynomial segment's tangent is itself a polynomial, with twice the degree
+    //given the tangent in power basis, IE tangent(u) = sum(tangentCoefficients[i] * u^i), compute the power basis coefficients of its squared length
+    //output must have room for tangentSize * 2 - 1 values
+    template<class InterpolationType, typename floating_t>
+    void computeSquaredSpeed(const InterpolationType *tangentCoefficients, size_t tangentSize, floating_t *output);
+
+    //given coefficients computed by computeSquaredSpeed, compute the length of the tangent at u
+    //this is a scalar horner pass and a sqrt, so it's much cheaper than evaluating the tangent itself, especially in higher dimensions
+    template<typename floating_t>
+    floating_t evaluateSpeed(const floating_t *squaredSpeed, size_t size, floating_t u);
+
+    //the same as computeSquaredSpeed, but for a tangent in bernstein form, IE given the control points of a bezier curve's derivative
+    //high degree power basis coefficients cancel each other out badly in single precision, and bernstein coefficients don't
+    //each output coefficient is premultiplied by its binomial coefficient. output must have room for controlPointCount * 2 - 1 values
+    template<class InterpolationType, typename floating_t>
+    void computeBernsteinSquaredSpeed(const InterpolationType *controlPoints, size_t controlPointCount, floating_t *output);
+
+    //given coefficients computed by computeBernsteinSquaredSpeed, compute the length of the tangent at u, where u is from 0 to 1
+    template<typename floating_t>
+    floating_t evaluateBernsteinSpeed(const floating_t *squaredSpeed, size_t size, floating_t u);
+
+    //the t value at the beginning of each segment of a spline, plus the end of the last segment
+    //by default the knots are stored, and t values are looked up with getIndexForT
+    //if uniform is true, knot i is always exactly i, as it is for any spline with alpha == 0. then nothing is stored,
+    //looking up a t value is just a floor, and every segment's t distance is the constant 1, which the compiler can fold away
+    template<typename floating_t, bool uniform>
+    class Knots;
+
+    template<typename floating_t>
+    class Knots<floating_t, false>
+    {
+    public:
+        inline Knots(void) = default;
+        inline Knots(std::vector<floating_t> values)
+            :values(std::move(values))
+        {}
+
+        inline size_t size(void) const { return values.size(); }
+        inline floating_t operator[](size_t index) const { return values[index]; }
+        inline floating_t tDiff(size_t segmentIndex) const { return values[segmentIndex + 1] - values[segmentIndex]; }
+
+        //same as getIndexForT
+        inline size_t indexForT(floating_t t) const { return getIndexForT(values, t); }
+
+        //direct access to the knot values, for the splines that support editing their points in place
+        inline std::vector<floating_t> &edit(void) { return values; }
+
+        //for rebuilding a spline in place: the vector to compute the knot values into, which is then passed to finishBuild
+        //stored knots are computed straight into their own storage
+        inline std::vector<floating_t> &buildStorage(std::vector<floating_t> &) { return values; }
+        inline void finishBuild(const std::vector<floating_t> &) {}
+
+        inline size_t heapFootprint(void) const { return vectorFootprint(values); }
+
+    private:
+        std::vector<floating_t> values;
+    };
+
+    template<typename floating_t>
+    class Knots<floating_t, true>
+    {
+    public:
+        inline Knots(void) = default;
+
+        //the values are only used for their count. they're expected to already be 0, 1, 2, etc
+        inline Knots(const std::vector<floating_t> &values)
+            :count(values.size())
+        {}
+
+        inline size_t size(void) const { return count; }
+        inline floating_t operator[](size_t index) const { return floating_t(index); }
+        inline floating_t tDiff(size_t) const { return 1; }
+
+        //same as getIndexForT, but since knot i is i, there's nothing to search
+        inline size_t indexForT(floating_t t) const
+        {
+            if(t <= 0)
+                return 0;
+            if(t >= floating_t(count - 1))
+                return count - 1;
+            return size_t(t);
+        }
+
+        inline void resize(size_t newCount) { count = newCount; }
+
+        //uniform knots aren't stored, so they're computed into the caller's scratch vector, and only their count is kept
+        inline std::vector<floating_t> &buildStorage(std::vector<floating_t> &scratch) { return scratch; }
+        inline void finishBuild(const std::vector<floating_t> &builtValues) { count = builtValues.size(); }
+
+        inline size_t heapFootprint(void) const { return 0; }
+
+    private:
+        size_t count = 0;
+    };
+
+    //temporary storage for computing a spline's data: knots that aren't kept, the diagonals of a linear system, and its right hand side
+    //the constructors use a fresh one each time. the rebuild methods use one that the spline keeps, so that in steady state they don't allocate
+    template<class InterpolationType, typename floating_t>
+    struct BuildScratch
+    {
+        std::vector<floating_t> knots;
+        std::vector<floating_t> diagonal;
+        std::vector<floating_t> upperDiagonal;
+        std::vector<floating_t> lowerDiagonal;
+        std::vector<floating_t> correction;
+        std::vector<InterpolationType> values;
+
+        inline size_t heapFootprint(void) const
+        {
+            return vectorFootprint(knots) + vectorFootprint(diagonal) + vectorFootprint(upperDiagonal)
+                    + vectorFootprint(lowerDiagonal) + vectorFootprint(correction) + vectorFootprint(values);
+        }
+    };
+
+    //the BuildScratch a spline keeps between rebuilds. it's only allocated the first time the spline is rebuilt,
+    //and it isn't part of the spline's value, so copying a spline leaves the copy without one
+    template<class InterpolationType, typename floating_t>
+    class RetainedBuildScratch
+    {
+    public:
+        RetainedBuildScratch(void) = default;
+        RetainedBuildScratch(const RetainedBuildScratch &) {}
+        RetainedBuildScratch(RetainedBuildScratch &&) = default;
+        RetainedBuildScratch &operator=(const RetainedBuildScratch &) { return *this; }
+        RetainedBuildScratch &operator=(RetainedBuildScratch &&) = default;
+
+        inline BuildScratch<InterpolationType, floating_t> &get(void)
+        {
+            if(!scratch)
+                scratch.reset(new BuildScratch<InterpolationType, floating_t>);
+            return *scratch;
+        }
+
+        inline size_t heapFootprint(void) const
+        {
+            return scratch ? sizeof(*scratch) + scratch->heapFootprint() : 0;
+        }
+
+    private:
+        std::unique_ptr<BuildScratch<InterpolationType, floating_t>> scratch;
+    };
 }
 
 namespace ArcLength
 {
     //compute the arc length from a to b on the given spline
-    template<template <class, typename> class SplineT, class InterpolationType, typename floating_t>
-    floating_t arcLength(const SplineT<InterpolationType, floating_t>& spline, floating_t a, floating_t b);
+    template<class SplineT>
+    SplineCommon::SplineFloat<SplineT> arcLength(const SplineT& spline, SplineCommon::SplineFloat<SplineT> a, SplineCommon::SplineFloat<SplineT> b);
 
     //compute the arc length from a to b on the given spline, using wrapping/cylic logic
     //for cyclic splines only!
-    template<template <class, typename> class CyclicSplineT, class InterpolationType, typename floating_t>
-    floating_t cyclicArcLength(const CyclicSplineT<InterpolationType, floating_t>& spline, floating_t a, floating_t b);
+    template<class CyclicSplineT>
+    SplineCommon::SplineFloat<CyclicSplineT> cyclicArcLength(const CyclicSplineT& spline, SplineCommon::SplineFloat<CyclicSplineT> a, SplineCommon::SplineFloat<CyclicSplineT> b);
 
     //compute the arc length from the beginning to the end on the given spline
-    template<template <class, typename> class Spline, class InterpolationType, typename floating_t>
-    floating_t totalLength(const Spline<InterpolationType, floating_t>& spline);
+    template<class SplineT>
+    SplineCommon::SplineFloat<SplineT> totalLength(const SplineT& spline);
 }
 
 
@@ -88,12 +297,25 @@ std::vector<floating_t> SplineCommon::computeTValuesWithInnerPadding(
         floating_t alpha,
         size_t innerPadding
         )
+{
+    std::vector<floating_t> tValues;
+    computeTValuesWithInnerPadding(points, alpha, innerPadding, tValues);
+    return tValues;
+}
+
+template<class InterpolationType, typename floating_t>
+void SplineCommon::computeTValuesWithInnerPadding(
+        const std::vector<InterpolationType> &points,
+        floating_t alpha,
+        size_t innerPadding,
+        std::vector<floating_t> &tValues
+        )
 {
     size_t size = points.size();
     size_t endPaddingIndex = size - 1 - innerPadding;
     size_t desiredMaxT = size - 2 * innerPadding - 1;
 
-    std::vector<floating_t> tValues(size);
+    tValues.resize(size);
 
     //we know points[padding] will have a t value of 0
     tValues[innerPadding] = 0;
@@ -121,8 +343,6 @@ std::vector<floating_t> SplineCommon::computeTValuesWithInnerPadding(
     {
         entry *= multiplier;
     }
-
-    return tValues;
 }
 
 template<class InterpolationType, typename floating_t>
@@ -130,10 +350,22 @@ std::vector<floating_t> SplineCommon::computeLoopingTValues(
         const std::vector<InterpolationType> &points,
         floating_t alpha,
         size_t padding)
+{
+    std::vector<floating_t> tValues;
+    computeLoopingTValues(points, alpha, padding, tValues);
+    return tValues;
+}
+
+template<class InterpolationType, typename floating_t>
+void SplineCommon::computeLoopingTValues(
+        const std::vector<InterpolationType> &points,
+        floating_t alpha,
+        size_t padding,
+        std::vector<floating_t> &tValues)
 {
     size_t size = points.size();
     floating_t maxT = floating_t(size);
-    std::vector<floating_t> tValues(size + padding * 2 + 1);
+    tValues.resize(size + padding * 2 + 1);
 
     //compute the t values each point
     tValues[padding] = 0;
@@ -161,62 +393,237 @@ std::vector<floating_t> SplineCommon::computeLoopingTValues(
         tValues[i] = tValues[i + size] - maxT;
         tValues[i + size + padding + 1] = tValues[i + padding + 1] + maxT;
     }
+}
 
-    return tValues;
+
+template<typename floating_t>
+void SplineCommon::removeKnotPadding(std::vector<floating_t> &paddedKnots, size_t padding, size_t count)
+{
+    assert(padding + count <= paddedKnots.size());
+
+    paddedKnots.erase(paddedKnots.begin(), paddedKnots.begin() + padding);
+    paddedKnots.resize(count);
+}
+
+template<class InterpolationType, typename floating_t>
+InterpolationType SplineCommon::computeCatmullRomTangent(
+        const InterpolationType &pPrev, const InterpolationType &pCurrent, const InterpolationType &pNext,
+        floating_t tPrev, floating_t tCurrent, floating_t tNext)
+{
+    //this is the standard catmull-rom tangent, plus a little something extra derived from the pyramid construction,
+    //rearranged so that the weights of pPrev, pCurrent and pNext (which sum to zero) are applied to displacements instead
+    //when the t values are evenly spaced (ie when alpha is 0), the extra part collapses to 0, yielding the standard (pNext - pPrev) / 2
+    floating_t prevDiff = tCurrent - tPrev;
+    floating_t nextDiff = tNext - tCurrent;
+    floating_t totalDiff = tNext - tPrev;
+
+    return (pNext - pCurrent) * (prevDiff / (totalDiff * nextDiff)) - (pPrev - pCurrent) * (nextDiff / (totalDiff * prevDiff));
+}
+
+template<class SplineCoreT, class InterpolationType>
+void SplineCommon::copyStoredPoints(const SplineCoreT &core, size_t begin, size_t count, std::vector<InterpolationType> &output)
+{
+    assert(begin + count <= core.storedPointCount());
+
+    output.resize(count);
+    for(size_t i = 0; i < count; i++)
+    {
+        output[i] = core.storedPoint(begin + i);
+    }
 }
 
 
 template<typename floating_t>
 size_t SplineCommon::getIndexForT(const std::vector<floating_t> &knotData, floating_t t)
+{
+    return getIndexForT(knotData.data(), knotData.size(), t);
+}
+
+template<typename floating_t>
+size_t SplineCommon::getIndexForT(const floating_t *knotData, size_t size, floating_t t)
 {
     //we want to find the segment whos t0 and t1 values bound x
+    SPLINE_LIBRARY_COUNT(IndexLookups, 1);
 
     //if no segments bound x, return -1
-    if(t <= knotData.front())
+    if(t <= knotData[0])
         return 0;
-    if(t >= knotData.back())
-        return knotData.size() - 1;
+    if(t >= knotData[size - 1])
+        return size - 1;
 
     //our initial guess will be to subtract the minimum t value, then take the floor
-    size_t currentIndex = std::floor(t - knotData.front());
-    size_t size = knotData.size();
-
-    //move left or right in the array until we've found the correct index
-    size_t searchSize = 1;
-    while(t < knotData[currentIndex])
+    //knots that are further apart than 1 can put that past the end, so keep it in range
+    size_t currentIndex = std::min(size_t(std::floor(t - knotData[0])), size - 2);
+
+    //gallop away from the guess with doubling steps until t is bracketed, then bisect the bracket
+    //when the guess is right, that's a single probe. the checks above guarantee that knotData[0] <= t < knotData[size - 1], so both gallops stop
+    size_t low, high;
+    size_t step = 1;
+    if(t < knotData[currentIndex])
+    {
+        high = currentIndex;
+        while(true)
+        {
+            SPLINE_LIBRARY_COUNT(IndexProbes, 1);
+            low = high > step ? high - step : 0;
+            if(t >= knotData[low])
+                break;
+            high = low;
+            step *= 2;
+        }
+    }
+    else
     {
-        while(currentIndex >= 0 && t < knotData[currentIndex])
+        low = currentIndex;
+        while(true)
         {
-            searchSize++;
-            currentIndex -= searchSize;
+            SPLINE_LIBRARY_COUNT(IndexProbes, 1);
+            high = std::min(low + step, size - 1);
+            if(t < knotData[high])
+                break;
+            low = high;
+            step *= 2;
         }
-        if(currentIndex < 0 || t > knotData[currentIndex + 1])
+    }
+
+    while(high - low > 1)
+    {
+        SPLINE_LIBRARY_COUNT(IndexProbes, 1);
+        size_t middle = low + (high - low) / 2;
+        if(t < knotData[middle])
+            high = middle;
+        else
+            low = middle;
+    }
+    return low;
+}
+
+template<class SplineCoreT, typename floating_t>
+size_t SplineCommon::segmentForTWithHint(const SplineCoreT &core, floating_t t, size_t hint)
+{
+    size_t lastSegment = core.segmentCount() - 1;
+
+    //the first segment extends infinitely to the left and the last segment extends infinitely to the right, to match the clamping in segmentForT
+    auto containsT = [&](size_t segmentIndex) {
+        return (segmentIndex == 0 || core.segmentT(segmentIndex) <= t)
+            && (segmentIndex == lastSegment || t < core.segmentT(segmentIndex + 1));
+    };
+
+    if(hint <= lastSegment)
+    {
+        if(containsT(hint))
+            return hint;
+        if(hint < lastSegment && containsT(hint + 1))
+            return hint + 1;
+        if(hint > 0 && containsT(hint - 1))
+            return hint - 1;
+    }
+
+    return core.segmentForT(t);
+}
+
+template<class InterpolationType, typename floating_t>
+void SplineCommon::computeSquaredSpeed(const InterpolationType *tangentCoefficients, size_t tangentSize, floating_t *output)
+{
+    std::fill(output, output + tangentSize * 2 - 1, floating_t(0));
+
+    //multiply the tangent polynomial by itself, using the dot product in place of multiplication
+    //each cross term appears twice, so only compute the ones where j > i and double them
+    for(size_t i = 0; i < tangentSize; i++)
+    {
+        output[i * 2] += InterpolationType::dotProduct(tangentCoefficients[i], tangentCoefficients[i]);
+        for(size_t j = i + 1; j < tangentSize; j++)
         {
-            currentIndex += searchSize;
-            searchSize /= 4;
+            output[i + j] += 2 * InterpolationType::dotProduct(tangentCoefficients[i], tangentCoefficients[j]);
         }
+    }
+}
 
+template<typename floating_t>
+floating_t SplineCommon::evaluateSpeed(const floating_t *squaredSpeed, size_t size, floating_t u)
+{
+    floating_t result = squaredSpeed[size - 1];
+    for(size_t i = size - 1; i > 0; i--)
+    {
+        result = result * u + squaredSpeed[i - 1];
     }
-    while(t >= knotData[currentIndex + 1])
+
+    //where the tangent is close to zero, rounding error can push the squared length slightly negative
+    return std::sqrt(std::max(result, floating_t(0)));
+}
+
+template<class InterpolationType, typename floating_t>
+void SplineCommon::computeBernsteinSquaredSpeed(const InterpolationType *controlPoints, size_t controlPointCount, floating_t *output)
+{
+    std::fill(output, output + controlPointCount * 2 - 1, floating_t(0));
+
+    //the product of two bernstein basis functions of degree n is a bernstein basis function of degree 2n, times a ratio of binomial coefficients
+    //the denominator of that ratio is taken care of by premultiplying, so only the numerator is needed here
+    //the binomial coefficients follow binomial(k) = binomial(k - 1) * (n - k) / k. they're recomputed with that recurrence as the loops go,
+    //which gives exactly the same values as a table of them would, without allocating one
+    floating_t binomialI = 1;
+    for(size_t i = 0; i < controlPointCount; i++)
     {
-        while(currentIndex < size && t >= knotData[currentIndex])
+        if(i > 0)
+            binomialI = binomialI * (controlPointCount - i) / i;
+
+        output[i * 2] += binomialI * binomialI * InterpolationType::dotProduct(controlPoints[i], controlPoints[i]);
+
+        floating_t binomialJ = binomialI;
+        for(size_t j = i + 1; j < controlPointCount; j++)
         {
-            searchSize++;
-            currentIndex += searchSize;
+            binomialJ = binomialJ * (controlPointCount - j) / j;
+            output[i + j] += 2 * binomialI * binomialJ * InterpolationType::dotProduct(controlPoints[i], controlPoints[j]);
         }
-        if(currentIndex >= size || t < knotData[currentIndex])
+    }
+}
+
+template<typename floating_t>
+floating_t SplineCommon::evaluateBernsteinSpeed(const floating_t *squaredSpeed, size_t size, floating_t u)
+{
+    //this is the sum of squaredSpeed[k] * u^k * (1 - u)^(n - k). factoring out whichever of u and 1 - u is bigger leaves a polynomial
+    //of their ratio, which is never more than 1, so horner's method stays accurate
+    const size_t n = size - 1;
+    floating_t result, bigger;
+    if(u < floating_t(0.5))
+    {
+        bigger = 1 - u;
+        floating_t ratio = u / bigger;
+        result = squaredSpeed[n];
+        for(size_t k = n; k > 0; k--)
         {
-            currentIndex -= searchSize;
-            searchSize /= 4;
+            result = result * ratio + squaredSpeed[k - 1];
         }
     }
-    return currentIndex;
+    else
+    {
+        bigger = u;
+        floating_t ratio = (1 - u) / bigger;
+        result = squaredSpeed[0];
+        for(size_t k = 0; k < n; k++)
+        {
+            result = result * ratio + squaredSpeed[k + 1];
+        }
+    }
+
+    //raise the bigger factor to the nth power by squaring
+    floating_t power = 1;
+    for(size_t exponent = n; exponent > 0; exponent /= 2)
+    {
+        if(exponent % 2 == 1)
+            power *= bigger;
+        bigger *= bigger;
+    }
+
+    return std::sqrt(std::max(result * power, floating_t(0)));
 }
 
 //compute the arc length from a to b on the given spline
-template<template <class, typename> class Spline, class InterpolationType, typename floating_t>
-floating_t ArcLength::arcLength(const Spline<InterpolationType, floating_t>& spline, floating_t a, floating_t b)
+template<class SplineT>
+SplineCommon::SplineFloat<SplineT> ArcLength::arcLength(const SplineT& spline, SplineCommon::SplineFloat<SplineT> a, SplineCommon::SplineFloat<SplineT> b)
 {
+    typedef SplineCommon::SplineFloat<SplineT> floating_t;
+
     if(a > b) {
         std::swap(a,b);
     }
@@ -253,9 +660,11 @@ floating_t ArcLength::arcLength(const Spline<InterpolationType, floating_t>& spl
 
 //compute the arc length from a to b on the given spline, using wrapping/cyclic logic
 //for cyclic splines only!
-template<template <class, typename> class CyclicSplineT, class InterpolationType, typename floating_t>
-floating_t ArcLength::cyclicArcLength(const CyclicSplineT<InterpolationType, floating_t>& spline, floating_t a, floating_t b)
+template<class CyclicSplineT>
+SplineCommon::SplineFloat<CyclicSplineT> ArcLength::cyclicArcLength(const CyclicSplineT& spline, SplineCommon::SplineFloat<CyclicSplineT> a, SplineCommon::SplineFloat<CyclicSplineT> b)
 {
+    typedef SplineCommon::SplineFloat<CyclicSplineT> floating_t;
+
     floating_t wrappedA = spline.wrapT(a);
     floating_t wrappedB = spline.wrapT(b);
 
@@ -298,9 +707,11 @@ floating_t ArcLength::cyclicArcLength(const CyclicSplineT<InterpolationType, flo
 }
 
 //compute the arc length from the beginning to the end on the given spline
-template<template <class, typename> class Spline, class InterpolationType, typename floating_t>
-floating_t ArcLength::totalLength(const Spline<InterpolationType, floating_t>& spline)
+template<class SplineT>
+SplineCommon::SplineFloat<SplineT> ArcLength::totalLength(const SplineT& spline)
 {
+    typedef SplineCommon::SplineFloat<SplineT> floating_t;
+
     floating_t result{0};
     for(size_t i = 0; i < spline.segmentCount(); i++) {
         result += spline.segmentArcLength(i, spline.segmentT(i), spline.segmentT(i+1));
@@ -0,0 +1,720 @@
+#pragma once
+
+#include <vector>
+#include <array>
+#include <string>
+#include <memory>
+#include <fstream>
+#include <algorithm>
+#include <limits>
+#include <type_traits>
+#include <cmath>
+#include <cstring>
+#include <cstdint>
+#include <cassert>
+
+#if !defined(_WIN32)
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+#include "../spline.h"
+#include "spline_common.h"
+#include "quinticbezier.h"
+
+//a compact binary format for splines that have already been built, so that loading them doesn't repeat the work of building them
+//every segment is stored exactly as a quintic polynomial (see quinticbezier.h for the splines that aren't supported), so any spline type can be stored,
+//along with its knots and, optionally, the arc length of each segment
+//
+//the format is little-endian, and every array in it is aligned, so a file can be memory mapped with SplineArchiveFile and evaluated in place:
+//SplineArchiveView checks the file once, and the splines it hands out read their segments directly from the mapped memory
+//
+//layout, with every offset measured from the beginning of the file:
+//  header: char[8] magic, uint32 version, uint32 byte order mark, uint32 scalar size, uint32 dimension, uint64 spline count
+//  one record per spline: uint64 knot offset, uint64 segment offset, uint64 length offset (0 if absent), uint64 segment count, uint32 flags, uint32 padding, float64 max t
+//  for each spline: segmentCount + 1 knots, then segmentCount segments, then optionally segmentCount arc lengths, each aligned to 8 bytes
+//  each segment is its center t and one over its t length, followed by 6 power basis coefficients in terms of a local t from -0.5 to 0.5, lowest power first
+namespace SplineArchive
+{
+    const char magic[8] = {'S', 'P', 'L', 'A', 'R', 'C', 'H', '\0'};
+    const uint32_t version = 1;
+
+    //written in little-endian order, so it reads back as this value on little-endian machines
+    const uint32_t byteOrderMark = 0x01020304;
+
+    const uint32_t loopingFlag = 1;
+    const uint32_t arcLengthFlag = 2;
+
+    const size_t headerSize = 32;
+    const size_t recordSize = 48;
+    const size_t alignment = 8;
+
+    //the number of scalars in one stored segment
+    inline constexpr size_t segmentStride(size_t dimension) { return 2 + 6 * dimension; }
+}
+
+//the spline core for splines stored in a SplineArchive. it doesn't own any memory: everything it reads belongs to the archive
+template<class InterpolationType, typename floating_t, size_t dimension>
+class MappedSplineCommon
+{
+public:
+    inline MappedSplineCommon(void) = default;
+    inline MappedSplineCommon(const floating_t *knots, const floating_t *segmentData, const floating_t *segmentLengths, size_t count)
+        :knots(knots), segmentData(segmentData), segmentLengths(segmentLengths), count(count)
+    {}
+
+    inline size_t segmentCount(void) const
+    {
+        return count;
+    }
+
+    inline size_t segmentForT(floating_t t) const
+    {
+        size_t segmentIndex = SplineCommon::getIndexForT(knots, count + 1, t);
+        if(segmentIndex > segmentCount() - 1)
+            return segmentCount() - 1;
+        else
+            return segmentIndex;
+    }
+
+    inline floating_t segmentT(size_t segmentIndex) const
+    {
+        return knots[segmentIndex];
+    }
+
+    inline InterpolationType getPosition(floating_t globalT) const
+    {
+        return positionInSegment(segmentForT(globalT), globalT);
+    }
+
+    inline typename Spline<InterpolationType,floating_t>::InterpolatedPT getTangent(floating_t globalT) const
+    {
+        return tangentInSegment(segmentForT(globalT), globalT);
+    }
+
+    inline typename Spline<InterpolationType,floating_t>::InterpolatedPTC getCurvature(floating_t globalT) const
+    {
+        return curvatureInSegment(segmentForT(globalT), globalT);
+    }
+
+    inline typename Spline<InterpolationType,floating_t>::InterpolatedPTCW getWiggle(floating_t globalT) const
+    {
+        return wiggleInSegment(segmentForT(globalT), globalT);
+    }
+
+    inline void getPositions(const floating_t *tValues, size_t outputCount, InterpolationType *output) const
+    {
+        size_t segmentIndex = 0;
+        for(size_t i = 0; i < outputCount; i++)
+        {
+            segmentIndex = SplineCommon::segmentForTWithHint(*this, tValues[i], segmentIndex);
+            output[i] = positionInSegment(segmentIndex, tValues[i]);
+        }
+    }
+
+    inline void getTangents(const floating_t *tValues, size_t outputCount, typename Spline<InterpolationType,floating_t>::InterpolatedPT *output) const
+    {
+        size_t segmentIndex = 0;
+        for(size_t i = 0; i < outputCount; i++)
+        {
+            segmentIndex = SplineCommon::segmentForTWithHint(*this, tValues[i], segmentIndex);
+            output[i] = tangentInSegment(segmentIndex, tValues[i]);
+        }
+    }
+
+    inline void getCurvatures(const floating_t *tValues, size_t outputCount, typename Spline<InterpolationType,floating_t>::InterpolatedPTC *output) const
+    {
+        size_t segmentIndex = 0;
+        for(size_t i = 0; i < outputCount; i++)
+        {
+            segmentIndex = SplineCommon::segmentForTWithHint(*this, tValues[i], segmentIndex);
+            output[i] = curvatureInSegment(segmentIndex, tValues[i]);
+        }
+    }
+
+    inline void getWiggles(const floating_t *tValues, size_t outputCount, typename Spline<InterpolationType,floating_t>::InterpolatedPTCW *output) const
+    {
+        size_t segmentIndex = 0;
+        for(size_t i = 0; i < outputCount; i++)
+        {
+            segmentIndex = SplineCommon::segmentForTWithHint(*this, tValues[i], segmentIndex);
+            output[i] = wiggleInSegment(segmentIndex, tValues[i]);
+        }
+    }
+
+    inline floating_t segmentLength(size_t segmentIndex, floating_t a, floating_t b, const SplineLibraryCalculus::QuadratureSettings<floating_t> &quadrature) const
+    {
+        //whole segments are the common case (totalLength, ArcLengthTable, etc), and the archive may already know their lengths
+        if(segmentLengths && a == knots[segmentIndex] && b == knots[segmentIndex + 1])
+            return segmentLengths[segmentIndex];
+
+        const floating_t *segment = segmentPointer(segmentIndex);
+        floating_t inverseLength = segment[1];
+
+        //it's perfectly legal for segments to have a T distance of 0, in which case the arc length is 0
+        if(inverseLength > 0)
+        {
+            auto segmentFunction = [segment](floating_t t) -> floating_t {
+                return evaluate<1>(segment, localT(segment, t)).length();
+            };
+
+            return SplineLibraryCalculus::integrate<floating_t>(segmentFunction, a, b, quadrature);
+        }
+        else
+        {
+            return 0;
+        }
+    }
+
+    //everything is owned by the archive
+    inline size_t heapFootprint(void) const
+    {
+        return 0;
+    }
+
+    //these skip the segment search, for callers that already know which segment globalT is in
+    inline InterpolationType positionInSegment(size_t segmentIndex, floating_t globalT) const
+    {
+        const floating_t *segment = segmentPointer(segmentIndex);
+        return evaluate<0>(segment, localT(segment, globalT));
+    }
+
+    inline typename Spline<InterpolationType,floating_t>::InterpolatedPT tangentInSegment(size_t segmentIndex, floating_t globalT) const
+    {
+        const floating_t *segment = segmentPointer(segmentIndex);
+        floating_t t = localT(segment, globalT);
+
+        return typename Spline<InterpolationType,floating_t>::InterpolatedPT(
+                    evaluate<0>(segment, t),
+                    evaluate<1>(segment, t)
+                    );
+    }
+
+    inline typename Spline<InterpolationType,floating_t>::InterpolatedPTC curvatureInSegment(size_t segmentIndex, floating_t globalT) const
+    {
+        const floating_t *segment = segmentPointer(segmentIndex);
+        floating_t t = localT(segment, globalT);
+
+        return typename Spline<InterpolationType,floating_t>::InterpolatedPTC(
+                    evaluate<0>(segment, t),
+                    evaluate<1>(segment, t),
+                    evaluate<2>(segment, t)
+                    );
+    }
+
+    inline typename Spline<InterpolationType,floating_t>::InterpolatedPTCW wiggleInSegment(size_t segmentIndex, floating_t globalT) const
+    {
+        const floating_t *segment = segmentPointer(segmentIndex);
+        floating_t t = localT(segment, globalT);
+
+        return typename Spline<InterpolationType,floating_t>::InterpolatedPTCW(
+                    evaluate<0>(segment, t),
+                    evaluate<1>(segment, t),
+                    evaluate<2>(segment, t),
+                    evaluate<3>(segment, t)
+                    );
+    }
+
+private: //methods
+    inline const floating_t *segmentPointer(size_t segmentIndex) const
+    {
+        return segmentData + segmentIndex * SplineArchive::segmentStride(dimension);
+    }
+
+    static inline floating_t localT(const floating_t *segment, floating_t globalT)
+    {
+        return (globalT - segment[0]) * segment[1];
+    }
+
+    static inline InterpolationType loadCoefficient(const floating_t *segment, size_t power)
+    {
+        InterpolationType result;
+        const floating_t *coefficient = segment + 2 + power * dimension;
+        for(size_t d = 0; d < dimension; d++)
+        {
+            result[d] = coefficient[d];
+        }
+        return result;
+    }
+
+    //the given derivative of the segment with respect to global t. the stored coefficients are for position, so derivatives
+    //scale each coefficient by its power's falling factorial, and by the inverse length once per derivative to convert from local t
+    template<size_t derivative>
+    static inline InterpolationType evaluate(const floating_t *segment, floating_t t)
+    {
+        auto scale = [](size_t power) {
+            floating_t result = 1;
+            for(size_t i = 0; i < derivative; i++)
+            {
+                result *= floating_t(power - i);
+            }
+            return result;
+        };
+
+        InterpolationType result = loadCoefficient(segment, 5) * scale(5);
+        for(size_t power = 5; power > derivative; power--)
+        {
+            result = result * t + loadCoefficient(segment, power - 1) * scale(power - 1);
+        }
+
+        floating_t inverseLength = segment[1];
+        for(size_t i = 0; i < derivative; i++)
+        {
+            result = result * inverseLength;
+        }
+        return result;
+    }
+
+private: //data
+    const floating_t *knots = nullptr;
+    const floating_t *segmentData = nullptr;
+
+    //null if the archive doesn't have arc lengths for this spline
+    const floating_t *segmentLengths = nullptr;
+
+    size_t count = 0;
+};
+
+namespace __SplineArchivePrivate
+{
+    //SplineImpl expects a spline core with exactly two template parameters, so bind the dimension ahead of time
+    template<size_t dimension>
+    struct Dimension
+    {
+        template<class InterpolationType, typename floating_t>
+        using Common = MappedSplineCommon<InterpolationType, floating_t, dimension>;
+    };
+
+    //append value to output in little-endian order, regardless of the machine's byte order
+    template<class IntegerType>
+    void appendInteger(std::vector<char> &output, IntegerType value)
+    {
+        for(size_t i = 0; i < sizeof(IntegerType); i++)
+        {
+            output.push_back(char((value >> (i * 8)) & 0xff));
+        }
+    }
+
+    template<typename floating_t>
+    void appendFloat(std::vector<char> &output, floating_t value)
+    {
+        static_assert(sizeof(floating_t) == 4 || sizeof(floating_t) == 8, "SplineArchive only supports 32 and 64 bit floating point");
+        typedef typename std::conditional<sizeof(floating_t) == 4, uint32_t, uint64_t>::type IntegerType;
+
+        IntegerType bits;
+        std::memcpy(&bits, &value, sizeof(value));
+        appendInteger(output, bits);
+    }
+
+    inline void padToAlignment(std::vector<char> &output)
+    {
+        while(output.size() % SplineArchive::alignment != 0)
+            output.push_back(0);
+    }
+
+    //read a value that's already known to be in bounds. the view only accepts archives on little-endian machines, so no swapping is needed
+    template<class ValueType>
+    ValueType readValue(const char *data, size_t offset)
+    {
+        ValueType result;
+        std::memcpy(&result, data + offset, sizeof(result));
+        return result;
+    }
+
+    //true if [offset, offset + count * elementSize) fits in a buffer of the given size, without overflowing along the way
+    inline bool rangeFits(uint64_t offset, uint64_t count, uint64_t elementSize, uint64_t size)
+    {
+        if(offset > size || offset % SplineArchive::alignment != 0)
+            return false;
+        return count <= (size - offset) / elementSize;
+    }
+}
+
+template<class InterpolationType, typename floating_t, size_t dimension>
+class SplineArchiveView;
+
+//a spline read directly out of a SplineArchiveView. the view, and whatever memory it was given, must outlive the spline
+template<class InterpolationType, typename floating_t=float, size_t dimension=2>
+class MappedSpline final : public SplineImpl<__SplineArchivePrivate::Dimension<dimension>::template Common, InterpolationType, floating_t>
+{
+//constructors
+public:
+    MappedSpline(const SplineArchiveView<InterpolationType, floating_t, dimension> &archive, size_t splineIndex)
+        :SplineImpl<__SplineArchivePrivate::Dimension<dimension>::template Common, InterpolationType, floating_t>(std::vector<InterpolationType>(), archive.maxT(splineIndex))
+    {
+        assert(!archive.isLooping(splineIndex));
+
+        common = archive.common(splineIndex);
+
+        //the archive doesn't store the original points, and there's no way to rebuild them
+        this->discardOriginalPoints();
+    }
+};
+
+template<class InterpolationType, typename floating_t=float, size_t dimension=2>
+class LoopingMappedSpline final : public SplineLoopingImpl<__SplineArchivePrivate::Dimension<dimension>::template Common, InterpolationType, floating_t>
+{
+//constructors
+public:
+    LoopingMappedSpline(const SplineArchiveView<InterpolationType, floating_t, dimension> &archive, size_t splineIndex)
+        :SplineLoopingImpl<__SplineArchivePrivate::Dimension<dimension>::template Common, InterpolationType, floating_t>(std::vector<InterpolationType>(), archive.maxT(splineIndex))
+    {
+        assert(archive.isLooping(splineIndex));
+
+        common = archive.common(splineIndex);
+
+        this->discardOriginalPoints();
+    }
+};
+
+//collects splines and serializes them into the archive format. each spline is converted as soon as it's added, so it doesn't have to outlive the writer
+template<class InterpolationType, typename floating_t=float, size_t dimension=2>
+class SplineArchiveWriter
+{
+public:
+    //if includeArcLengths is true, the arc length of every segment is computed now and stored, so splines loaded from the archive
+    //can skip integrating whole segments. this makes totalLength, ArcLengthTable, and most of ArcLength much cheaper after loading
+    //the lengths are computed with the spline's quadrature settings at the time it's added. loaded splines return them as they are, whatever their own settings
+    void addSpline(const Spline<InterpolationType, floating_t> &spline, bool includeArcLengths = true);
+
+    inline size_t splineCount(void) const { return entries.size(); }
+
+    //the complete archive. write it to disk as-is
+    std::vector<char> serialize(void) const;
+
+    //returns false if the file couldn't be written
+    bool writeFile(const std::string &path) const;
+
+private:
+    struct Entry
+    {
+        bool looping;
+        floating_t maxT;
+        std::vector<floating_t> knots;
+        std::vector<floating_t> segmentData;
+        std::vector<floating_t> segmentLengths;
+    };
+    std::vector<Entry> entries;
+};
+
+//checks an archive and hands out splines that evaluate directly from its memory. nothing is copied, so data must stay valid as long as the view and its splines
+//data must be aligned to at least 8 bytes, which memory mapped files and the results of operator new always are
+template<class InterpolationType, typename floating_t=float, size_t dimension=2>
+class SplineArchiveView
+{
+public:
+    SplineArchiveView(const void *data, size_t size);
+
+    //false if the data isn't a complete archive of this version, with this floating point type and dimension, or if this machine isn't little-endian
+    //none of the other methods may be called on an invalid view
+    inline bool isValid(void) const { return valid; }
+
+    inline size_t splineCount(void) const { return records.size(); }
+    inline bool isLooping(size_t splineIndex) const { return (records[splineIndex].flags & SplineArchive::loopingFlag) != 0; }
+    inline bool hasArcLengths(size_t splineIndex) const { return (records[splineIndex].flags & SplineArchive::arcLengthFlag) != 0; }
+    inline floating_t maxT(size_t splineIndex) const { return records[splineIndex].maxT; }
+
+    //a MappedSpline or LoopingMappedSpline, depending on whether the stored spline loops
+    std::shared_ptr<Spline<InterpolationType, floating_t>> makeSpline(size_t splineIndex) const;
+
+    //the spline core for the given spline, for MappedSpline and LoopingMappedSpline
+    MappedSplineCommon<InterpolationType, floating_t, dimension> common(size_t splineIndex) const;
+
+private:
+    struct Record
+    {
+        const floating_t *knots;
+        const floating_t *segmentData;
+        const floating_t *segmentLengths;
+        size_t segmentCount;
+        uint32_t flags;
+        floating_t maxT;
+    };
+    std::vector<Record> records;
+    bool valid = false;
+};
+
+//a read-only memory mapping of an entire file, for handing to SplineArchiveView. pages are only read from disk as the splines touch them
+//on platforms without mmap, the file is read into memory instead
+class SplineArchiveFile
+{
+public:
+    inline SplineArchiveFile(const std::string &path);
+    inline ~SplineArchiveFile(void);
+
+    SplineArchiveFile(const SplineArchiveFile &) = delete;
+    SplineArchiveFile &operator=(const SplineArchiveFile &) = delete;
+
+    //false if the file couldn't be opened or mapped
+    inline bool isOpen(void) const { return mappedData != nullptr || !fallbackData.empty(); }
+
+    inline const void *data(void) const { return mappedData ? mappedData : static_cast<const void*>(fallbackData.data()); }
+    inline size_t size(void) const { return mappedSize; }
+
+private:
+    void *mappedData = nullptr;
+    size_t mappedSize = 0;
+
+    //the whole file, where mmap isn't available. vectors of uint64 are aligned well enough for the view
+    std::vector<uint64_t> fallbackData;
+};
+
+template<class InterpolationType, typename floating_t, size_t dimension>
+void SplineArchiveWriter<InterpolationType, floating_t, dimension>::addSpline(const Spline<InterpolationType, floating_t> &spline, bool includeArcLengths)
+{
+    assert(spline.segmentCount() > 0);
+
+    Entry entry;
+    entry.looping = spline.isLooping();
+    entry.maxT = spline.getMaxT();
+    entry.knots.resize(spline.segmentCount() + 1);
+    entry.segmentData.reserve(spline.segmentCount() * SplineArchive::segmentStride(dimension));
+
+    for(size_t i = 0; i < spline.segmentCount(); i++)
+    {
+        floating_t beginT = spline.segmentT(i);
+        floating_t endT = spline.segmentT(i + 1);
+        entry.knots[i] = beginT;
+
+        std::array<InterpolationType, 6> coefficients;
+        if(endT > beginT)
+        {
+            entry.segmentData.push_back(beginT + (endT - beginT) / 2);
+            entry.segmentData.push_back(1 / (endT - beginT));
+            coefficients = QuinticBezier::centeredPowerBasis<floating_t>(QuinticBezier::fromSegment(spline, i));
+        }
+        else
+        {
+            //a segment with no T distance is a single point, and every derivative is zero
+            entry.segmentData.push_back(beginT);
+            entry.segmentData.push_back(0);
+            coefficients.fill(InterpolationType());
+            coefficients[0] = spline.getPositionInSegment(i, beginT);
+        }
+
+        for(const auto &coefficient : coefficients)
+        {
+            for(size_t d = 0; d < dimension; d++)
+            {
+                entry.segmentData.push_back(coefficient[d]);
+            }
+        }
+
+        if(includeArcLengths)
+            entry.segmentLengths.push_back(spline.segmentArcLength(i, beginT, endT));
+    }
+    entry.knots.back() = spline.segmentT(spline.segmentCount());
+
+    entries.push_back(std::move(entry));
+}
+
+template<class InterpolationType, typename floating_t, size_t dimension>
+std::vector<char> SplineArchiveWriter<InterpolationType, floating_t, dimension>::serialize(void) const
+{
+    using namespace __SplineArchivePrivate;
+
+    //work out where every array goes before writing anything, so the records can be written first
+    struct Offsets
+    {
+        uint64_t knots, segments, lengths;
+    };
+    std::vector<Offsets> offsets(entries.size());
+
+    uint64_t position = SplineArchive::headerSize + SplineArchive::recordSize * entries.size();
+    auto reserveArray = [&](size_t count) {
+        uint64_t result = position;
+        position += count * sizeof(floating_t);
+        position = (position + SplineArchive::alignment - 1) / SplineArchive::alignment * SplineArchive::alignment;
+        return result;
+    };
+    for(size_t i = 0; i < entries.size(); i++)
+    {
+        offsets[i].knots = reserveArray(entries[i].knots.size());
+        offsets[i].segments = reserveArray(entries[i].segmentData.size());
+        offsets[i].lengths = entries[i].segmentLengths.empty() ? 0 : reserveArray(entries[i].segmentLengths.size());
+    }
+
+    std::vector<char> output;
+    output.reserve(position);
+
+    output.insert(output.end(), SplineArchive::magic, SplineArchive::magic + sizeof(SplineArchive::magic));
+    appendInteger<uint32_t>(output, SplineArchive::version);
+    appendInteger<uint32_t>(output, SplineArchive::byteOrderMark);
+    appendInteger<uint32_t>(output, sizeof(floating_t));
+    appendInteger<uint32_t>(output, dimension);
+    appendInteger<uint64_t>(output, entries.size());
+    assert(output.size() == SplineArchive::headerSize);
+
+    for(size_t i = 0; i < entries.size(); i++)
+    {
+        uint32_t flags = 0;
+        if(entries[i].looping)
+            flags |= SplineArchive::loopingFlag;
+        if(!entries[i].segmentLengths.empty())
+            flags |= SplineArchive::arcLengthFlag;
+
+        appendInteger<uint64_t>(output, offsets[i].knots);
+        appendInteger<uint64_t>(output, offsets[i].segments);
+        appendInteger<uint64_t>(output, offsets[i].lengths);
+        appendInteger<uint64_t>(output, entries[i].knots.size() - 1);
+        appendInteger<uint32_t>(output, flags);
+        appendInteger<uint32_t>(output, 0);
+        appendFloat<double>(output, double(entries[i].maxT));
+    }
+
+    for(const auto &entry : entries)
+    {
+        for(const auto &array : {&entry.knots, &entry.segmentData, &entry.segmentLengths})
+        {
+            for(floating_t value : *array)
+            {
+                appendFloat<floating_t>(output, value);
+            }
+            padToAlignment(output);
+        }
+    }
+    assert(output.size() == position);
+
+    return output;
+}
+
+template<class InterpolationType, typename floating_t, size_t dimension>
+bool SplineArchiveWriter<InterpolationType, floating_t, dimension>::writeFile(const std::string &path) const
+{
+    std::vector<char> data = serialize();
+
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    file.write(data.data(), std::streamsize(data.size()));
+    return bool(file);
+}
+
+template<class InterpolationType, typename floating_t, size_t dimension>
+SplineArchiveView<InterpolationType, floating_t, dimension>::SplineArchiveView(const void *data, size_t size)
+{
+    using namespace __SplineArchivePrivate;
+    const char *bytes = static_cast<const char*>(data);
+
+    //the arrays are used in place, so they have to be aligned, and in this machine's byte order
+    if(bytes == nullptr || reinterpret_cast<uintptr_t>(bytes) % SplineArchive::alignment != 0 || size < SplineArchive::headerSize)
+        return;
+    if(std::memcmp(bytes, SplineArchive::magic, sizeof(SplineArchive::magic)) != 0)
+        return;
+    if(readValue<uint32_t>(bytes, 8) != SplineArchive::version || readValue<uint32_t>(bytes, 12) != SplineArchive::byteOrderMark)
+        return;
+    if(readValue<uint32_t>(bytes, 16) != sizeof(floating_t) || readValue<uint32_t>(bytes, 20) != dimension)
+        return;
+
+    uint64_t splineCount = readValue<uint64_t>(bytes, 24);
+    if(!rangeFits(SplineArchive::headerSize, splineCount, SplineArchive::recordSize, size))
+        return;
+
+    records.reserve(splineCount);
+    for(uint64_t i = 0; i < splineCount; i++)
+    {
+        size_t recordOffset = SplineArchive::headerSize + i * SplineArchive::recordSize;
+        uint64_t knotOffset = readValue<uint64_t>(bytes, recordOffset);
+        uint64_t segmentOffset = readValue<uint64_t>(bytes, recordOffset + 8);
+        uint64_t lengthOffset = readValue<uint64_t>(bytes, recordOffset + 16);
+        uint64_t segmentCount = readValue<uint64_t>(bytes, recordOffset + 24);
+        uint32_t flags = readValue<uint32_t>(bytes, recordOffset + 32);
+        double maxT = readValue<double>(bytes, recordOffset + 40);
+
+        bool hasLengths = (flags & SplineArchive::arcLengthFlag) != 0;
+        uint64_t stride = SplineArchive::segmentStride(dimension) * sizeof(floating_t);
+        if(segmentCount == 0 || segmentCount == std::numeric_limits<uint64_t>::max()
+                || !rangeFits(knotOffset, segmentCount + 1, sizeof(floating_t), size)
+                || !rangeFits(segmentOffset, segmentCount, stride, size)
+                || (hasLengths && !rangeFits(lengthOffset, segmentCount, sizeof(floating_t), size)))
+        {
+            records.clear();
+            return;
+        }
+
+        //looping splines divide by max t to wrap, and segmentForT's binary search needs the knots in order. segments with a t length of 0 are legal
+        const floating_t *knots = reinterpret_cast<const floating_t*>(bytes + knotOffset);
+        bool knotsOrdered = std::isfinite(knots[0]) && knots[segmentCount] > knots[0];
+        for(uint64_t k = 0; knotsOrdered && k < segmentCount; k++)
+            knotsOrdered = std::isfinite(knots[k + 1]) && knots[k + 1] >= knots[k];
+
+        if(!std::isfinite(maxT) || !(maxT > 0) || !knotsOrdered)
+        {
+            records.clear();
+            return;
+        }
+
+        Record record;
+        record.knots = knots;
+        record.segmentData = reinterpret_cast<const floating_t*>(bytes + segmentOffset);
+        record.segmentLengths = hasLengths ? reinterpret_cast<const floating_t*>(bytes + lengthOffset) : nullptr;
+        record.segmentCount = size_t(segmentCount);
+        record.flags = flags;
+        record.maxT = floating_t(maxT);
+        records.push_back(record);
+    }
+
+    valid = true;
+}
+
+template<class InterpolationType, typename floating_t, size_t dimension>
+MappedSplineCommon<InterpolationType, floating_t, dimension> SplineArchiveView<InterpolationType, floating_t, dimension>::common(size_t splineIndex) const
+{
+    assert(valid && splineIndex < records.size());
+
+    const Record &record = records[splineIndex];
+    return MappedSplineCommon<InterpolationType, floating_t, dimension>(record.knots, record.segmentData, record.segmentLengths, record.segmentCount);
+}
+
+template<class InterpolationType, typename floating_t, size_t dimension>
+std::shared_ptr<Spline<InterpolationType, floating_t>> SplineArchiveView<InterpolationType, floating_t, dimension>::makeSpline(size_t splineIndex) const
+{
+    if(isLooping(splineIndex))
+        return std::make_shared<LoopingMappedSpline<InterpolationType, floating_t, dimension>>(*this, splineIndex);
+    else
+        return std::make_shared<MappedSpline<InterpolationType, floating_t, dimension>>(*this, splineIndex);
+}
+
+SplineArchiveFile::SplineArchiveFile(const std::string &path)
+{
+#if defined(_WIN32)
+    std::ifstream file(path, std::ios::binary | std::ios::ate);
+    if(!file)
+        return;
+
+    mappedSize = size_t(file.tellg());
+    fallbackData.resize((mappedSize + sizeof(uint64_t) - 1) / sizeof(uint64_t));
+    file.seekg(0);
+    if(!file.read(reinterpret_cast<char*>(fallbackData.data()), std::streamsize(mappedSize)))
+    {
+        fallbackData.clear();
+        mappedSize = 0;
+    }
+#else
+    int descriptor = ::open(path.c_str(), O_RDONLY);
+    if(descriptor < 0)
+        return;
+
+    struct stat status;
+    if(::fstat(descriptor, &status) == 0 && status.st_size > 0)
+    {
+        void *result = ::mmap(nullptr, size_t(status.st_size), PROT_READ, MAP_PRIVATE, descriptor, 0);
+        if(result != MAP_FAILED)
+        {
+            mappedData = result;
+            mappedSize = size_t(status.st_size);
+        }
+    }
+
+    //the mapping stays valid after the descriptor is closed
+    ::close(descriptor);
+#endif
+}
+
+SplineArchiveFile::~SplineArchiveFile(void)
+{
+#if !defined(_WIN32)
+    if(mappedData)
+        ::munmap(mappedData, mappedSize);
+#endif
+}
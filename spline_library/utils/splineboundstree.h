@@ -0,0 +1,589 @@
+#pragma once
+
+#include <vector>
+#include <array>
+#include <algorithm>
+#include <utility>
+#include <limits>
+#include <cmath>
+#include <cassert>
+
+#include "../spline.h"
+#include "spline_common.h"
+#include "quinticbezier.h"
+
+//a bounding volume hierarchy over the segments of a spline, for closest point queries and for finding the parts of a spline inside a box or near a ray
+//each segment is converted exactly into a quintic bezier curve, which never leaves the box around its control points
+//so unlike the SplineInverter, which only looks at samples, the bounds here are guaranteed. see quinticbezier.h for the splines that aren't supported
+template<class InterpolationType, typename floating_t=float, size_t dimension=2>
+class SplineBoundsTree
+{
+public:
+    //findClosestT's result is guaranteed to be within tolerance of the true closest distance. if tolerance is 0, a millionth of the size of the spline is used
+    SplineBoundsTree(const Spline<InterpolationType, floating_t> &spline, floating_t tolerance = 0);
+
+    floating_t findClosestT(const InterpolationType &queryPoint) const;
+
+    //find the t ranges that contain every part of the spline inside the box from boxMin to boxMax
+    //the ranges are conservative - they can contain parts of the spline just outside the box. they're sorted, and adjacent ranges are merged
+    std::vector<std::pair<floating_t, floating_t>> findTRangesInBox(const InterpolationType &boxMin, const InterpolationType &boxMax) const;
+
+    //find the t ranges that contain every part of the spline within radius of the ray from origin in the given direction, which doesn't need to be normalized
+    //the ranges are conservative, sorted, and merged just like findTRangesInBox
+    std::vector<std::pair<floating_t, floating_t>> findTRangesNearRay(const InterpolationType &origin, const InterpolationType &direction, floating_t radius = 0) const;
+
+    //each segment is split into one or more pieces, depending on how much it curves
+    inline size_t pieceCount(void) const { return pieces.size(); }
+
+    //the number of bytes used by this tree, including everything it allocated
+    size_t memoryFootprint(void) const;
+
+private: //types
+    typedef QuinticBezier::ControlPoints<InterpolationType> ControlPoints;
+
+    struct Box
+    {
+        std::array<floating_t, dimension> min;
+        std::array<floating_t, dimension> max;
+    };
+
+    //a quintic bezier curve that matches the spline exactly from beginT to endT
+    struct Piece
+    {
+        floating_t beginT;
+        floating_t endT;
+        ControlPoints controlPoints;
+    };
+
+    //nodes are stored depth first, so the first child of a node is always the node right after it
+    //a leaf has secondChild == 0, and piece is the index of its piece
+    struct Node
+    {
+        Box bounds;
+        size_t secondChild;
+        size_t piece;
+    };
+
+private: //methods
+    void addPieces(const ControlPoints &controlPoints, floating_t beginT, floating_t endT, int depth);
+    size_t buildNode(size_t beginPiece, size_t endPiece);
+
+    //the state of a findClosestT query, with squared distances
+    //anything whose distance is at least pruneDistance can't beat the best so far by more than half the tolerance, so it isn't worth searching
+    struct ClosestSearch
+    {
+        InterpolationType queryPoint;
+        floating_t bestDistance;
+        floating_t pruneDistance;
+        floating_t bestU;
+    };
+
+    //branch and bound on a single piece: subdivide it until newton's method is guaranteed to find its closest point, skipping anything the search can prune
+    void closestInPiece(const ControlPoints &controlPoints, const Box &bounds, floating_t beginU, floating_t endU, ClosestSearch &search, int depth) const;
+    void tryClosestCandidate(ClosestSearch &search, const InterpolationType &point, floating_t u) const;
+
+    //sort the t ranges of the pieces found by a query, and merge the ones that touch
+    static void mergeRanges(std::vector<std::pair<floating_t, floating_t>> &ranges);
+
+    static Box computeBounds(const ControlPoints &controlPoints);
+    static Box mergeBounds(const Box &a, const Box &b);
+    static floating_t boxDistanceSquared(const Box &box, const InterpolationType &point);
+    static floating_t boxDiagonal(const Box &box);
+
+    //the middle of the box around the control points is a cheap stand in for the middle of the piece
+    static floating_t pieceCenter(const Piece &piece, size_t d);
+
+    //true if the squared distance from the query point to the curve has a positive second derivative everywhere, so it has exactly one minimum
+    //that's the case when the curve's speed along its chord is large compared to how much it curves and how far away the query point is
+    static bool hasConvexDistance(const ControlPoints &controlPoints, const InterpolationType &queryPoint);
+
+private: //data
+    std::vector<Piece> pieces;
+    std::vector<Node> nodes;
+    floating_t tolerance;
+
+    //keep splitting a piece in half until its inner control points are this close to the line between its endpoints, relative to its size
+    //so that each piece only turns a little, and its box fits it tightly
+    static constexpr floating_t maxPieceFlatness = floating_t(0.125);
+    static const int maxBuildDepth = 6;
+
+    //a piece won't be subdivided more than this many times while searching it, even if it still isn't within the tolerance
+    static const int maxQueryDepth = 32;
+
+    //newton's method converges quadratically once it's certain to have a single minimum, so this is only a safety net
+    static const int maxNewtonIterations = 16;
+
+    //deep enough for any tree with fewer than 2^64 pieces, since the tree is balanced
+    static const size_t maxTreeDepth = 64;
+};
+
+template<class InterpolationType, typename floating_t, size_t dimension>
+SplineBoundsTree<InterpolationType, floating_t, dimension>::SplineBoundsTree(const Spline<InterpolationType, floating_t> &spline, floating_t tolerance)
+    :tolerance(tolerance)
+{
+    for(size_t i = 0; i < spline.segmentCount(); i++)
+    {
+        floating_t beginT = spline.segmentT(i);
+        floating_t endT = spline.segmentT(i + 1);
+        if(endT <= beginT)
+            continue;
+
+        addPieces(QuinticBezier::fromSegment(spline, i), beginT, endT, 0);
+    }
+
+    if(!pieces.empty())
+    {
+        nodes.reserve(pieces.size() * 2 - 1);
+        buildNode(0, pieces.size());
+
+        if(this->tolerance <= 0)
+            this->tolerance = boxDiagonal(nodes[0].bounds) * floating_t(1e-6);
+    }
+}
+
+template<class InterpolationType, typename floating_t, size_t dimension>
+void SplineBoundsTree<InterpolationType, floating_t, dimension>::addPieces(const ControlPoints &controlPoints, floating_t beginT, floating_t endT, int depth)
+{
+    floating_t maxFlatness = boxDiagonal(computeBounds(controlPoints)) * maxPieceFlatness;
+    if(depth < maxBuildDepth && QuinticBezier::flatnessSquared<floating_t>(controlPoints) > maxFlatness * maxFlatness)
+    {
+        ControlPoints left, right;
+        QuinticBezier::split(controlPoints, left, right);
+
+        floating_t middleT = (beginT + endT) / 2;
+        addPieces(left, beginT, middleT, depth + 1);
+        addPieces(right, middleT, endT, depth + 1);
+    }
+    else
+    {
+        pieces.push_back(Piece{beginT, endT, controlPoints});
+    }
+}
+
+template<class InterpolationType, typename floating_t, size_t dimension>
+size_t SplineBoundsTree<InterpolationType, floating_t, dimension>::buildNode(size_t beginPiece, size_t endPiece)
+{
+    size_t index = nodes.size();
+    nodes.push_back(Node());
+
+    if(endPiece - beginPiece == 1)
+    {
+        nodes[index].bounds = computeBounds(pieces[beginPiece].controlPoints);
+        nodes[index].secondChild = 0;
+        nodes[index].piece = beginPiece;
+    }
+    else
+    {
+        //split at the median along the longest side of the box around the pieces' centers
+        Box centers;
+        for(size_t d = 0; d < dimension; d++)
+        {
+            centers.min[d] = std::numeric_limits<floating_t>::infinity();
+            centers.max[d] = -std::numeric_limits<floating_t>::infinity();
+            for(size_t i = beginPiece; i < endPiece; i++)
+            {
+                floating_t center = pieceCenter(pieces[i], d);
+                centers.min[d] = std::min(centers.min[d], center);
+                centers.max[d] = std::max(centers.max[d], center);
+            }
+        }
+        size_t axis = 0;
+        for(size_t d = 1; d < dimension; d++)
+        {
+            if(centers.max[d] - centers.min[d] > centers.max[axis] - centers.min[axis])
+                axis = d;
+        }
+
+        size_t middlePiece = (beginPiece + endPiece) / 2;
+        std::nth_element(pieces.begin() + beginPiece, pieces.begin() + middlePiece, pieces.begin() + endPiece,
+                         [axis](const Piece &a, const Piece &b) { return pieceCenter(a, axis) < pieceCenter(b, axis); });
+
+        size_t firstChild = buildNode(beginPiece, middlePiece);
+        size_t secondChild = buildNode(middlePiece, endPiece);
+
+        nodes[index].bounds = mergeBounds(nodes[firstChild].bounds, nodes[secondChild].bounds);
+        nodes[index].secondChild = secondChild;
+        nodes[index].piece = 0;
+    }
+    return index;
+}
+
+template<class InterpolationType, typename floating_t, size_t dimension>
+floating_t SplineBoundsTree<InterpolationType, floating_t, dimension>::findClosestT(const InterpolationType &queryPoint) const
+{
+    assert(!nodes.empty());
+
+    ClosestSearch search;
+    search.queryPoint = queryPoint;
+    search.bestDistance = std::numeric_limits<floating_t>::infinity();
+    search.pruneDistance = std::numeric_limits<floating_t>::infinity();
+    floating_t bestT = pieces[0].beginT;
+
+    //each entry is a node to visit, and a lower bound on the distance to anything inside it
+    std::array<std::pair<size_t, floating_t>, maxTreeDepth + 1> stack;
+    size_t stackSize = 0;
+    stack[stackSize++] = std::make_pair(size_t(0), boxDistanceSquared(nodes[0].bounds, queryPoint));
+
+    while(stackSize > 0)
+    {
+        auto current = stack[--stackSize];
+        if(current.second >= search.pruneDistance)
+            continue;
+
+        const Node &node = nodes[current.first];
+        if(node.secondChild == 0)
+        {
+            const Piece &piece = pieces[node.piece];
+            search.bestU = -1;
+            closestInPiece(piece.controlPoints, node.bounds, 0, 1, search, 0);
+            if(search.bestU >= 0)
+                bestT = piece.beginT + search.bestU * (piece.endT - piece.beginT);
+        }
+        else
+        {
+            size_t firstChild = current.first + 1;
+            floating_t firstDistance = boxDistanceSquared(nodes[firstChild].bounds, queryPoint);
+            floating_t secondDistance = boxDistanceSquared(nodes[node.secondChild].bounds, queryPoint);
+
+            //push the closer child last, so that it's visited first. the sooner we find a close point, the more we get to skip
+            if(firstDistance < secondDistance)
+            {
+                stack[stackSize++] = std::make_pair(node.secondChild, secondDistance);
+                stack[stackSize++] = std::make_pair(firstChild, firstDistance);
+            }
+            else
+            {
+                stack[stackSize++] = std::make_pair(firstChild, firstDistance);
+                stack[stackSize++] = std::make_pair(node.secondChild, secondDistance);
+            }
+        }
+    }
+
+    return bestT;
+}
+
+template<class InterpolationType, typename floating_t, size_t dimension>
+void SplineBoundsTree<InterpolationType, floating_t, dimension>::closestInPiece(const ControlPoints &controlPoints, const Box &bounds, floating_t beginU, floating_t endU, ClosestSearch &search, int depth) const
+{
+    //the first and last control points are on the curve, so they're free upper bounds on the closest distance. the lower the bound, the more we get to skip
+    tryClosestCandidate(search, controlPoints[0], beginU);
+    tryClosestCandidate(search, controlPoints[5], endU);
+
+    //boxes fit diagonal curves loosely, so before doing anything else, check the curve's distance from its chord for a tighter bound
+    InterpolationType chord = controlPoints[5] - controlPoints[0];
+    floating_t chordLengthSquared = chord.lengthSquared();
+    floating_t chordU = 0;
+    if(chordLengthSquared > 0)
+        chordU = std::min(std::max(InterpolationType::dotProduct(search.queryPoint - controlPoints[0], chord) / chordLengthSquared, floating_t(0)), floating_t(1));
+
+    floating_t chordDistance = (controlPoints[0] + chord * chordU - search.queryPoint).length() - std::sqrt(QuinticBezier::flatnessSquared<floating_t>(controlPoints));
+    if(chordDistance > 0 && chordDistance * chordDistance >= search.pruneDistance)
+        return;
+
+    if(!hasConvexDistance(controlPoints, search.queryPoint))
+    {
+        //if the whole box is within half the tolerance of an endpoint we already tried, there's nothing left to find
+        if(depth >= maxQueryDepth || boxDiagonal(bounds) <= tolerance / 2)
+            return;
+
+        ControlPoints left, right;
+        QuinticBezier::split(controlPoints, left, right);
+        floating_t middleU = (beginU + endU) / 2;
+
+        //search the closer half first
+        Box leftBounds = computeBounds(left);
+        Box rightBounds = computeBounds(right);
+        floating_t leftDistance = boxDistanceSquared(leftBounds, search.queryPoint);
+        floating_t rightDistance = boxDistanceSquared(rightBounds, search.queryPoint);
+        if(leftDistance < rightDistance)
+        {
+            if(leftDistance < search.pruneDistance)
+                closestInPiece(left, leftBounds, beginU, middleU, search, depth + 1);
+            if(rightDistance < search.pruneDistance)
+                closestInPiece(right, rightBounds, middleU, endU, search, depth + 1);
+        }
+        else
+        {
+            if(rightDistance < search.pruneDistance)
+                closestInPiece(right, rightBounds, middleU, endU, search, depth + 1);
+            if(leftDistance < search.pruneDistance)
+                closestInPiece(left, leftBounds, beginU, middleU, search, depth + 1);
+        }
+        return;
+    }
+
+    //the distance only has one minimum, so if it's increasing at the start or decreasing at the end, the closest point is an endpoint we already tried
+    //the first derivative at each end is just the difference of the two control points there, scaled by 5. the scale doesn't matter for the sign
+    if(InterpolationType::dotProduct(controlPoints[0] - search.queryPoint, controlPoints[1] - controlPoints[0]) >= 0)
+        return;
+    if(InterpolationType::dotProduct(controlPoints[5] - search.queryPoint, controlPoints[5] - controlPoints[4]) <= 0)
+        return;
+
+    //start at the closest point on the chord, and keep each newton step inside the range we know contains the minimum
+    floating_t u = chordU;
+    floating_t lowU = 0, highU = 1;
+
+    InterpolationType position, tangent, curvature;
+    for(int i = 0; i < maxNewtonIterations; i++)
+    {
+        QuinticBezier::evaluate(controlPoints, u, position, tangent, curvature);
+        InterpolationType displacement = position - search.queryPoint;
+        floating_t slope = InterpolationType::dotProduct(displacement, tangent);
+        floating_t concavity = InterpolationType::dotProduct(tangent, tangent) + InterpolationType::dotProduct(displacement, curvature);
+
+        if(slope > 0)
+            highU = u;
+        else
+            lowU = u;
+
+        floating_t nextU = u - slope / concavity;
+        if(!(nextU > lowU && nextU < highU))
+            nextU = (lowU + highU) / 2;
+
+        if(std::abs(nextU - u) <= std::numeric_limits<floating_t>::epsilon() * 4)
+            break;
+        u = nextU;
+    }
+    QuinticBezier::evaluate(controlPoints, u, position, tangent, curvature);
+    tryClosestCandidate(search, position, beginU + u * (endU - beginU));
+}
+
+template<class InterpolationType, typename floating_t, size_t dimension>
+void SplineBoundsTree<InterpolationType, floating_t, dimension>::tryClosestCandidate(ClosestSearch &search, const InterpolationType &point, floating_t u) const
+{
+    floating_t distance = (point - search.queryPoint).lengthSquared();
+    if(distance < search.bestDistance)
+    {
+        search.bestDistance = distance;
+        search.bestU = u;
+
+        floating_t pruneRadius = std::sqrt(distance) - tolerance / 2;
+        search.pruneDistance = pruneRadius > 0 ? pruneRadius * pruneRadius : 0;
+    }
+}
+
+template<class InterpolationType, typename floating_t, size_t dimension>
+std::vector<std::pair<floating_t, floating_t>> SplineBoundsTree<InterpolationType, floating_t, dimension>::findTRangesInBox(
+        const InterpolationType &boxMin, const InterpolationType &boxMax) const
+{
+    std::vector<std::pair<floating_t, floating_t>> ranges;
+    if(nodes.empty())
+        return ranges;
+
+    auto overlaps = [&](const Box &bounds) {
+        for(size_t d = 0; d < dimension; d++)
+        {
+            if(bounds.max[d] < boxMin[d] || bounds.min[d] > boxMax[d])
+                return false;
+        }
+        return true;
+    };
+
+    std::array<size_t, maxTreeDepth + 1> stack;
+    size_t stackSize = 0;
+    stack[stackSize++] = 0;
+    while(stackSize > 0)
+    {
+        size_t index = stack[--stackSize];
+        const Node &node = nodes[index];
+        if(!overlaps(node.bounds))
+            continue;
+
+        if(node.secondChild == 0)
+        {
+            ranges.emplace_back(pieces[node.piece].beginT, pieces[node.piece].endT);
+        }
+        else
+        {
+            stack[stackSize++] = node.secondChild;
+            stack[stackSize++] = index + 1;
+        }
+    }
+    mergeRanges(ranges);
+    return ranges;
+}
+
+template<class InterpolationType, typename floating_t, size_t dimension>
+std::vector<std::pair<floating_t, floating_t>> SplineBoundsTree<InterpolationType, floating_t, dimension>::findTRangesNearRay(
+        const InterpolationType &origin, const InterpolationType &direction, floating_t radius) const
+{
+    std::vector<std::pair<floating_t, floating_t>> ranges;
+    if(nodes.empty())
+        return ranges;
+
+    //slab test against the box grown by radius in every direction. that grown box contains everything within radius of the original box, so nothing gets missed
+    auto hits = [&](const Box &bounds) {
+        floating_t enter = 0;
+        floating_t exit = std::numeric_limits<floating_t>::infinity();
+        for(size_t d = 0; d < dimension; d++)
+        {
+            floating_t slabMin = bounds.min[d] - radius;
+            floating_t slabMax = bounds.max[d] + radius;
+            if(direction[d] == 0)
+            {
+                if(origin[d] < slabMin || origin[d] > slabMax)
+                    return false;
+            }
+            else
+            {
+                floating_t a = (slabMin - origin[d]) / direction[d];
+                floating_t b = (slabMax - origin[d]) / direction[d];
+                enter = std::max(enter, std::min(a, b));
+                exit = std::min(exit, std::max(a, b));
+                if(enter > exit)
+                    return false;
+            }
+        }
+        return true;
+    };
+
+    std::array<size_t, maxTreeDepth + 1> stack;
+    size_t stackSize = 0;
+    stack[stackSize++] = 0;
+    while(stackSize > 0)
+    {
+        size_t index = stack[--stackSize];
+        const Node &node = nodes[index];
+        if(!hits(node.bounds))
+            continue;
+
+        if(node.secondChild == 0)
+        {
+            ranges.emplace_back(pieces[node.piece].beginT, pieces[node.piece].endT);
+        }
+        else
+        {
+            stack[stackSize++] = node.secondChild;
+            stack[stackSize++] = index + 1;
+        }
+    }
+    mergeRanges(ranges);
+    return ranges;
+}
+
+template<class InterpolationType, typename floating_t, size_t dimension>
+size_t SplineBoundsTree<InterpolationType, floating_t, dimension>::memoryFootprint(void) const
+{
+    return sizeof(*this) + SplineCommon::vectorFootprint(pieces) + SplineCommon::vectorFootprint(nodes);
+}
+
+template<class InterpolationType, typename floating_t, size_t dimension>
+void SplineBoundsTree<InterpolationType, floating_t, dimension>::mergeRanges(std::vector<std::pair<floating_t, floating_t>> &ranges)
+{
+    if(ranges.empty())
+        return;
+
+    std::sort(ranges.begin(), ranges.end());
+
+    size_t mergedSize = 1;
+    for(size_t i = 1; i < ranges.size(); i++)
+    {
+        if(ranges[i].first <= ranges[mergedSize - 1].second)
+            ranges[mergedSize - 1].second = std::max(ranges[mergedSize - 1].second, ranges[i].second);
+        else
+            ranges[mergedSize++] = ranges[i];
+    }
+    ranges.resize(mergedSize);
+}
+
+template<class InterpolationType, typename floating_t, size_t dimension>
+typename SplineBoundsTree<InterpolationType, floating_t, dimension>::Box SplineBoundsTree<InterpolationType, floating_t, dimension>::computeBounds(const ControlPoints &controlPoints)
+{
+    Box result;
+    for(size_t d = 0; d < dimension; d++)
+    {
+        result.min[d] = controlPoints[0][d];
+        result.max[d] = controlPoints[0][d];
+        for(size_t i = 1; i < controlPoints.size(); i++)
+        {
+            result.min[d] = std::min(result.min[d], floating_t(controlPoints[i][d]));
+            result.max[d] = std::max(result.max[d], floating_t(controlPoints[i][d]));
+        }
+    }
+    return result;
+}
+
+template<class InterpolationType, typename floating_t, size_t dimension>
+typename SplineBoundsTree<InterpolationType, floating_t, dimension>::Box SplineBoundsTree<InterpolationType, floating_t, dimension>::mergeBounds(const Box &a, const Box &b)
+{
+    Box result;
+    for(size_t d = 0; d < dimension; d++)
+    {
+        result.min[d] = std::min(a.min[d], b.min[d]);
+        result.max[d] = std::max(a.max[d], b.max[d]);
+    }
+    return result;
+}
+
+template<class InterpolationType, typename floating_t, size_t dimension>
+floating_t SplineBoundsTree<InterpolationType, floating_t, dimension>::boxDistanceSquared(const Box &box, const InterpolationType &point)
+{
+    floating_t result = 0;
+    for(size_t d = 0; d < dimension; d++)
+    {
+        floating_t outside = std::max(std::max(box.min[d] - point[d], point[d] - box.max[d]), floating_t(0));
+        result += outside * outside;
+    }
+    return result;
+}
+
+template<class InterpolationType, typename floating_t, size_t dimension>
+floating_t SplineBoundsTree<InterpolationType, floating_t, dimension>::boxDiagonal(const Box &box)
+{
+    floating_t result = 0;
+    for(size_t d = 0; d < dimension; d++)
+    {
+        floating_t size = box.max[d] - box.min[d];
+        result += size * size;
+    }
+    return std::sqrt(result);
+}
+
+template<class InterpolationType, typename floating_t, size_t dimension>
+floating_t SplineBoundsTree<InterpolationType, floating_t, dimension>::pieceCenter(const Piece &piece, size_t d)
+{
+    floating_t min = piece.controlPoints[0][d];
+    floating_t max = piece.controlPoints[0][d];
+    for(size_t i = 1; i < piece.controlPoints.size(); i++)
+    {
+        min = std::min(min, floating_t(piece.controlPoints[i][d]));
+        max = std::max(max, floating_t(piece.controlPoints[i][d]));
+    }
+    return (min + max) / 2;
+}
+
+template<class InterpolationType, typename floating_t, size_t dimension>
+bool SplineBoundsTree<InterpolationType, floating_t, dimension>::hasConvexDistance(const ControlPoints &controlPoints, const InterpolationType &queryPoint)
+{
+    //the second derivative of the squared distance is T.T + D.C, for tangent T, curvature C, and displacement D from the query point
+    //the derivatives of a bezier curve are bezier curves too, so each one is a blend of its own control points - the differences of the curve's control points
+    InterpolationType chord = controlPoints[5] - controlPoints[0];
+    floating_t chordLength = chord.length();
+    if(chordLength <= 0)
+        return false;
+
+    //the length of T is at least its component along the chord
+    floating_t minSpeed = std::numeric_limits<floating_t>::infinity();
+    for(size_t i = 0; i < 5; i++)
+    {
+        minSpeed = std::min(minSpeed, floating_t(InterpolationType::dotProduct(controlPoints[i + 1] - controlPoints[i], chord)));
+    }
+    if(minSpeed <= 0)
+        return false;
+    minSpeed *= 5 / chordLength;
+
+    //D.C is at least -|D||C|
+    floating_t maxCurvatureSquared = 0;
+    for(size_t i = 0; i < 4; i++)
+    {
+        InterpolationType difference = controlPoints[i + 2] - controlPoints[i + 1] * 2 + controlPoints[i];
+        maxCurvatureSquared = std::max(maxCurvatureSquared, floating_t(difference.lengthSquared()));
+    }
+    floating_t maxDistanceSquared = 0;
+    for(size_t i = 0; i < 6; i++)
+    {
+        maxDistanceSquared = std::max(maxDistanceSquared, floating_t((controlPoints[i] - queryPoint).lengthSquared()));
+    }
+
+    return minSpeed * minSpeed > std::sqrt(maxDistanceSquared * maxCurvatureSquared) * 20;
+}
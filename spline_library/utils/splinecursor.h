@@ -0,0 +1,270 @@
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+
+#include "../spline.h"
+#include "arclength.h"
+
+//a position on a spline that remembers which segment it's in, for callers that step along the spline a little bit at a time
+//IE an object moving along the spline at some speed. getPosition(t) searches for t's segment on every call, while a cursor
+//only checks whether it has crossed out of the current segment, so stepping forward or backward costs the same no matter how big the spline is
+//the spline must outlive the cursor, and must not be edited while the cursor is in use
+template<class InterpolationType, typename floating_t=float>
+class SplineCursor
+{
+public:
+    SplineCursor(const Spline<InterpolationType, floating_t> &spline, floating_t t = 0);
+
+    //move to t, with a full segment search. for looping splines, t is wrapped to [0, maxT). for non-looping splines, it's clamped to [0, maxT]
+    void seek(floating_t t);
+
+    //move by dt, which may be negative. looping splines wrap around, and non-looping splines stop at the ends
+    //small steps only check the neighboring segments. a step that crosses more than a few segments falls back to seek()
+    void advance(floating_t dt);
+
+    //move by the given arc length, which may be negative. same wrapping and clamping behavior as advance()
+    //the arc length of the current segment is computed once and reused until the cursor leaves it, and each step only integrates the part of the segment it covers
+    //returns the arc length actually moved, which can only be smaller than distance if the cursor stopped at the end of a non-looping spline
+    floating_t advanceLength(floating_t distance);
+
+    inline floating_t getT(void) const { return t; }
+    inline size_t getSegmentIndex(void) const { return segmentIndex; }
+
+    inline InterpolationType getPosition(void) const { return spline.getPositionInSegment(segmentIndex, t); }
+    inline typename Spline<InterpolationType,floating_t>::InterpolatedPT getTangent(void) const { return spline.getTangentInSegment(segmentIndex, t); }
+    inline typename Spline<InterpolationType,floating_t>::InterpolatedPTC getCurvature(void) const { return spline.getCurvatureInSegment(segmentIndex, t); }
+    inline typename Spline<InterpolationType,floating_t>::InterpolatedPTCW getWiggle(void) const { return spline.getWiggleInSegment(segmentIndex, t); }
+
+    inline const Spline<InterpolationType, floating_t> &getSpline(void) const { return spline; }
+
+private: //methods
+    void enterSegment(size_t index);
+
+    //make sure segmentLength and lengthIntoSegment are up to date
+    void computeLengths(void);
+
+    floating_t advanceLengthForward(floating_t distance);
+    floating_t advanceLengthBackward(floating_t distance);
+
+private: //data
+    const Spline<InterpolationType, floating_t> &spline;
+    bool looping;
+
+    floating_t t;
+    size_t segmentIndex;
+    floating_t segmentBeginT;
+    floating_t segmentEndT;
+
+    //the arc length of the current segment, and the arc length from the beginning of the current segment to t. negative until computed
+    floating_t segmentLength;
+    floating_t lengthIntoSegment;
+
+    //a step in t that crosses more segments than this is handed off to seek(), which is O(log n) instead of O(segments crossed)
+    static const size_t maxSegmentWalk = 4;
+};
+
+template<class InterpolationType, typename floating_t>
+SplineCursor<InterpolationType, floating_t>::SplineCursor(const Spline<InterpolationType, floating_t> &spline, floating_t t)
+    :spline(spline), looping(spline.isLooping())
+{
+    seek(t);
+}
+
+template<class InterpolationType, typename floating_t>
+void SplineCursor<InterpolationType, floating_t>::seek(floating_t newT)
+{
+    if(looping)
+    {
+        newT = static_cast<const LoopingSpline<InterpolationType, floating_t>&>(spline).wrapT(newT);
+    }
+    else
+    {
+        newT = std::max(floating_t(0), std::min(newT, spline.getMaxT()));
+    }
+
+    enterSegment(spline.segmentForT(newT));
+    t = newT;
+}
+
+template<class InterpolationType, typename floating_t>
+void SplineCursor<InterpolationType, floating_t>::advance(floating_t dt)
+{
+    floating_t newT = t + dt;
+    size_t oldSegment = segmentIndex;
+    size_t steps = 0;
+
+    //walk one segment at a time until we find the one containing newT. segments with no T distance are skipped on the way
+    while(newT >= segmentEndT)
+    {
+        if(segmentIndex + 1 < spline.segmentCount())
+        {
+            enterSegment(segmentIndex + 1);
+        }
+        else if(looping)
+        {
+            newT -= spline.getMaxT();
+            enterSegment(0);
+        }
+        else
+        {
+            newT = std::min(newT, spline.getMaxT());
+            break;
+        }
+
+        if(++steps > maxSegmentWalk)
+        {
+            seek(newT);
+            return;
+        }
+    }
+    while(newT < segmentBeginT)
+    {
+        if(segmentIndex > 0)
+        {
+            enterSegment(segmentIndex - 1);
+        }
+        else if(looping)
+        {
+            newT += spline.getMaxT();
+            enterSegment(spline.segmentCount() - 1);
+        }
+        else
+        {
+            newT = 0;
+            break;
+        }
+
+        if(++steps > maxSegmentWalk)
+        {
+            seek(newT);
+            return;
+        }
+    }
+
+    t = newT;
+
+    //the segment's length is still good if we didn't leave it, but the length up to t has changed
+    if(segmentIndex == oldSegment)
+    {
+        lengthIntoSegment = -1;
+    }
+}
+
+template<class InterpolationType, typename floating_t>
+floating_t SplineCursor<InterpolationType, floating_t>::advanceLength(floating_t distance)
+{
+    if(distance >= 0)
+        return advanceLengthForward(distance);
+    else
+        return -advanceLengthBackward(-distance);
+}
+
+template<class InterpolationType, typename floating_t>
+floating_t SplineCursor<InterpolationType, floating_t>::advanceLengthForward(floating_t distance)
+{
+    floating_t remaining = distance;
+
+    //if a looping spline gets all the way around without using up any distance, it has no length, and we'd loop forever
+    floating_t remainingAtLastWrap = -1;
+
+    while(true)
+    {
+        computeLengths();
+
+        floating_t lengthLeftInSegment = segmentLength - lengthIntoSegment;
+        if(remaining < lengthLeftInSegment)
+        {
+            t = __ArcLengthSolvePrivate::solveSegment(spline, segmentIndex, remaining, lengthLeftInSegment, t);
+            lengthIntoSegment += remaining;
+            return distance;
+        }
+        remaining -= lengthLeftInSegment;
+
+        //move to the beginning of the next segment. its length is known to be 0 there, so only the segment length needs computing
+        if(segmentIndex + 1 < spline.segmentCount())
+        {
+            enterSegment(segmentIndex + 1);
+        }
+        else if(looping && remaining != remainingAtLastWrap)
+        {
+            remainingAtLastWrap = remaining;
+            enterSegment(0);
+        }
+        else
+        {
+            t = segmentEndT;
+            lengthIntoSegment = segmentLength;
+            return distance - remaining;
+        }
+        t = segmentBeginT;
+        lengthIntoSegment = 0;
+    }
+}
+
+template<class InterpolationType, typename floating_t>
+floating_t SplineCursor<InterpolationType, floating_t>::advanceLengthBackward(floating_t distance)
+{
+    floating_t remaining = distance;
+    floating_t remainingAtLastWrap = -1;
+
+    while(true)
+    {
+        computeLengths();
+
+        if(remaining < lengthIntoSegment)
+        {
+            //solving forward from the beginning of the segment means we don't need a second version of the solver that searches backwards
+            floating_t targetLength = lengthIntoSegment - remaining;
+            t = __ArcLengthSolvePrivate::solveSegment(spline, segmentIndex, targetLength, lengthIntoSegment, segmentBeginT);
+            lengthIntoSegment = targetLength;
+            return distance;
+        }
+        remaining -= lengthIntoSegment;
+
+        //move to the end of the previous segment
+        if(segmentIndex > 0)
+        {
+            enterSegment(segmentIndex - 1);
+        }
+        else if(looping && remaining != remainingAtLastWrap)
+        {
+            remainingAtLastWrap = remaining;
+            enterSegment(spline.segmentCount() - 1);
+        }
+        else
+        {
+            t = segmentBeginT;
+            lengthIntoSegment = 0;
+            return distance - remaining;
+        }
+        t = segmentEndT;
+        computeLengths();
+        lengthIntoSegment = segmentLength;
+    }
+}
+
+template<class InterpolationType, typename floating_t>
+void SplineCursor<InterpolationType, floating_t>::enterSegment(size_t index)
+{
+    assert(index < spline.segmentCount());
+
+    segmentIndex = index;
+    segmentBeginT = spline.segmentT(index);
+    segmentEndT = spline.segmentT(index + 1);
+    segmentLength = -1;
+    lengthIntoSegment = -1;
+}
+
+template<class InterpolationType, typename floating_t>
+void SplineCursor<InterpolationType, floating_t>::computeLengths(void)
+{
+    if(segmentLength < 0)
+    {
+        segmentLength = segmentEndT > segmentBeginT ? spline.segmentArcLength(segmentIndex, segmentBeginT, segmentEndT) : 0;
+    }
+    if(lengthIntoSegment < 0)
+    {
+        lengthIntoSegment = std::min(segmentLength, t > segmentBeginT ? spline.segmentArcLength(segmentIndex, segmentBeginT, t) : floating_t(0));
+    }
+}
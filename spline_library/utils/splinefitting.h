@@ -0,0 +1,329 @@
+#pragma once
+
+#include <vector>
+#include <algorithm>
+#include <cassert>
+#include <limits>
+
+#include "../spline.h"
+#include "../splines/uniform_cubic_bspline.h"
+#include "../splines/generic_b_spline.h"
+#include "linearalgebra.h"
+
+//fit a B-spline to a dense list of samples, like a GPS track or a lidar scan, with far fewer control points than there are samples
+//the control points are a least squares fit, so noise in the samples is averaged out instead of being followed, and fitting stops adding control points
+//once every sample is within the given tolerance of the spline
+//
+//each sample is fitted to the spline at its distance along the samples, so t on the fitted spline is roughly distance along the curve
+//the error of a sample is its distance from the spline at that t value. the distance to the closest point on the spline is never larger
+namespace SplineFitting
+{
+    template<class InterpolationType, typename floating_t>
+    struct Fit
+    {
+        //the control points and knots of a B-spline of the requested degree, in the form GenericBSpline takes them
+        std::vector<InterpolationType> controlPoints;
+        std::vector<floating_t> knots;
+
+        //for each sample, the t value it was fitted to
+        std::vector<floating_t> sampleT;
+
+        //the largest distance from any sample to the spline at its t value
+        floating_t maxError;
+    };
+
+    //fit a B-spline of the given degree to the samples, which must be in order along the curve
+    //the knots are placed adaptively: the fit begins with a single segment, then splits every segment that has a sample outside the tolerance, and fits again,
+    //so the segments end up short where the curve bends sharply, and long where it's straight
+    //every sample ends up within tolerance unless the segments become too short to split, IE if the samples have duplicates that disagree, so check maxError
+    template<class InterpolationType, typename floating_t>
+    Fit<InterpolationType, floating_t> fit(const std::vector<InterpolationType> &samples, floating_t tolerance, size_t degree = 3);
+
+    //the same, for a B-spline with evenly spaced knots, which UniformCubicBSpline requires. this searches for the smallest number of segments that's within tolerance
+    //evenly spaced segments can't be shorter in one place than another, so this usually needs more control points than fit
+    template<class InterpolationType, typename floating_t>
+    Fit<InterpolationType, floating_t> fitUniform(const std::vector<InterpolationType> &samples, floating_t tolerance, size_t degree = 3);
+
+    //fit the samples, and build the spline
+    template<size_t fixedDegree = 0, class InterpolationType, typename floating_t>
+    GenericBSpline<InterpolationType, floating_t, fixedDegree> fitGenericBSpline(const std::vector<InterpolationType> &samples, floating_t tolerance, size_t degree = fixedDegree)
+    {
+        Fit<InterpolationType, floating_t> result = fit(samples, tolerance, degree);
+        return GenericBSpline<InterpolationType, floating_t, fixedDegree>(result.controlPoints, result.knots, degree);
+    }
+
+    template<class InterpolationType, typename floating_t>
+    UniformCubicBSpline<InterpolationType, floating_t> fitUniformCubicBSpline(const std::vector<InterpolationType> &samples, floating_t tolerance)
+    {
+        return UniformCubicBSpline<InterpolationType, floating_t>(fitUniform(samples, tolerance, 3).controlPoints);
+    }
+
+    //the least squares control points of a B-spline with the given degree and knots, in the form GenericBSpline takes them, where each sample is matched with the given t value
+    //the t values must be in increasing order, and inside the spline
+    template<class InterpolationType, typename floating_t>
+    std::vector<InterpolationType> fitControlPoints(const std::vector<InterpolationType> &samples, const std::vector<floating_t> &sampleT,
+                                                    const std::vector<floating_t> &knots, size_t degree);
+}
+
+namespace __SplineFittingPrivate
+{
+    //the degree + 1 basis functions that are nonzero in the given segment, at t, by the cox-de boor recursion. output[j] is the weight of the segment's jth control point
+    //knots are in the form GenericBSpline stores them, so segment i uses control points i through i + degree, and goes from knots[i + degree - 1] to knots[i + degree]
+    //workspace needs room for 2 * (degree + 1) values
+    template<typename floating_t>
+    void computeBasis(const std::vector<floating_t> &knots, size_t segmentIndex, size_t degree, floating_t t, floating_t *output, floating_t *workspace)
+    {
+        floating_t *left = workspace;
+        floating_t *right = workspace + degree + 1;
+
+        output[0] = 1;
+        for(size_t j = 1; j <= degree; j++)
+        {
+            left[j] = t - knots[segmentIndex + degree - j];
+            right[j] = knots[segmentIndex + degree + j - 1] - t;
+
+            //each basis function of degree j - 1 contributes to two of degree j
+            floating_t saved = 0;
+            for(size_t r = 0; r < j; r++)
+            {
+                floating_t scaled = output[r] / (right[r + 1] + left[j - r]);
+                output[r] = saved + right[r + 1] * scaled;
+                saved = left[j - r] * scaled;
+            }
+            output[j] = saved;
+        }
+    }
+
+    //walk forward from the given segment to the one containing t, for sorted t values. clamped to the last segment, the same way the splines clamp it
+    template<typename floating_t>
+    size_t advanceSegment(const std::vector<floating_t> &knots, size_t degree, size_t segmentCount, size_t segmentIndex, floating_t t)
+    {
+        while(segmentIndex + 1 < segmentCount && knots[segmentIndex + degree] <= t)
+            segmentIndex++;
+        return segmentIndex;
+    }
+
+    //knots for the given segment boundaries, which begin at 0. B-splines need degree - 1 more knots past each end, which are spaced like the segment at that end
+    template<typename floating_t>
+    void computeKnots(const std::vector<floating_t> &boundaries, size_t degree, std::vector<floating_t> &knots)
+    {
+        size_t padding = degree - 1;
+        floating_t firstSpacing = boundaries[1] - boundaries[0];
+        floating_t lastSpacing = boundaries.back() - boundaries[boundaries.size() - 2];
+
+        knots.resize(boundaries.size() + padding * 2);
+        for(size_t i = 0; i < padding; i++)
+        {
+            knots[i] = boundaries.front() - firstSpacing * floating_t(padding - i);
+            knots[padding + boundaries.size() + i] = boundaries.back() + lastSpacing * floating_t(i + 1);
+        }
+        std::copy(boundaries.begin(), boundaries.end(), knots.begin() + padding);
+    }
+
+    //the distance along the samples to each sample. if the samples are all in the same place, the sample index instead
+    template<class InterpolationType, typename floating_t>
+    std::vector<floating_t> computeSampleT(const std::vector<InterpolationType> &samples)
+    {
+        std::vector<floating_t> sampleT(samples.size());
+        sampleT[0] = 0;
+        for(size_t i = 1; i < samples.size(); i++)
+        {
+            sampleT[i] = sampleT[i - 1] + floating_t((samples[i] - samples[i - 1]).length());
+        }
+
+        if(sampleT.back() <= 0)
+        {
+            for(size_t i = 0; i < samples.size(); i++)
+                sampleT[i] = floating_t(i);
+        }
+        return sampleT;
+    }
+
+    //fit control points to the given knots, then find the largest error in each segment, and overall
+    template<class InterpolationType, typename floating_t>
+    void fitAndMeasure(const std::vector<InterpolationType> &samples, size_t degree, SplineFitting::Fit<InterpolationType, floating_t> &result, std::vector<floating_t> &segmentErrors)
+    {
+        result.controlPoints = SplineFitting::fitControlPoints(samples, result.sampleT, result.knots, degree);
+
+        size_t segmentCount = result.controlPoints.size() - degree;
+        segmentErrors.assign(segmentCount, floating_t(0));
+
+        std::vector<floating_t> basis(degree + 1);
+        std::vector<floating_t> workspace(2 * (degree + 1));
+        size_t segmentIndex = 0;
+        for(size_t i = 0; i < samples.size(); i++)
+        {
+            segmentIndex = advanceSegment(result.knots, degree, segmentCount, segmentIndex, result.sampleT[i]);
+            computeBasis(result.knots, segmentIndex, degree, result.sampleT[i], basis.data(), workspace.data());
+
+            InterpolationType position = result.controlPoints[segmentIndex] * basis[0];
+            for(size_t j = 1; j <= degree; j++)
+            {
+                position = position + result.controlPoints[segmentIndex + j] * basis[j];
+            }
+
+            floating_t error = (position - samples[i]).length();
+            segmentErrors[segmentIndex] = std::max(segmentErrors[segmentIndex], error);
+        }
+
+        result.maxError = *std::max_element(segmentErrors.begin(), segmentErrors.end());
+    }
+}
+
+template<class InterpolationType, typename floating_t>
+std::vector<InterpolationType> SplineFitting::fitControlPoints(const std::vector<InterpolationType> &samples, const std::vector<floating_t> &sampleT,
+                                                               const std::vector<floating_t> &knots, size_t degree)
+{
+    assert(samples.size() == sampleT.size());
+    assert(knots.size() >= degree * 2);
+
+    //the control points that affect a sample are all within degree of each other, so the normal equations are banded. the smoothing term below reaches 2 away
+    const size_t controlPointCount = knots.size() - degree + 1;
+    const size_t segmentCount = controlPointCount - degree;
+    const size_t bandwidth = std::max(degree, size_t(2));
+    const size_t stride = bandwidth + 1;
+
+    std::vector<floating_t> bands(controlPointCount * stride, floating_t(0));
+    std::vector<InterpolationType> values(controlPointCount, InterpolationType());
+    std::vector<floating_t> basis(degree + 1);
+    std::vector<floating_t> workspace(2 * (degree + 1));
+
+    //the normal equations, B^T * B * controlPoints = B^T * samples, where row i of B is the basis functions at sample i's t value
+    size_t segmentIndex = 0;
+    for(size_t i = 0; i < samples.size(); i++)
+    {
+        segmentIndex = __SplineFittingPrivate::advanceSegment(knots, degree, segmentCount, segmentIndex, sampleT[i]);
+        __SplineFittingPrivate::computeBasis(knots, segmentIndex, degree, sampleT[i], basis.data(), workspace.data());
+
+        for(size_t a = 0; a <= degree; a++)
+        {
+            size_t row = segmentIndex + a;
+            values[row] = values[row] + samples[i] * basis[a];
+            for(size_t b = a; b <= degree; b++)
+            {
+                bands[row * stride + (b - a)] += basis[a] * basis[b];
+            }
+        }
+    }
+
+    //control points that no sample reaches, IE where the samples have a gap, would make the system singular. so add a very light penalty
+    //on the second difference of the control points, which fills gaps with a straight line, and is far too light to bend the spline anywhere else
+    const floating_t smoothing = floating_t(1e-4) * floating_t(samples.size()) / floating_t(controlPointCount);
+    const floating_t secondDifference[3] = {1, -2, 1};
+    for(size_t i = 0; i + 2 < controlPointCount; i++)
+    {
+        for(size_t a = 0; a < 3; a++)
+        {
+            for(size_t b = a; b < 3; b++)
+            {
+                bands[(i + a) * stride + (b - a)] += smoothing * secondDifference[a] * secondDifference[b];
+            }
+        }
+    }
+
+    LinearAlgebra::solveSymmetricBandedInPlace(bands.data(), bandwidth, values.data(), controlPointCount);
+    return values;
+}
+
+template<class InterpolationType, typename floating_t>
+SplineFitting::Fit<InterpolationType, floating_t> SplineFitting::fit(const std::vector<InterpolationType> &samples, floating_t tolerance, size_t degree)
+{
+    assert(degree > 0);
+    assert(samples.size() > degree);
+    assert(tolerance > 0);
+
+    Fit<InterpolationType, floating_t> result;
+    result.sampleT = __SplineFittingPrivate::computeSampleT<InterpolationType, floating_t>(samples);
+
+    //segments much shorter than this can't be told apart from their neighbors in floating_t
+    const floating_t maxT = result.sampleT.back();
+    const floating_t minSegmentLength = maxT * std::numeric_limits<floating_t>::epsilon() * 64;
+
+    std::vector<floating_t> boundaries = {0, maxT};
+    std::vector<floating_t> nextBoundaries;
+    std::vector<floating_t> segmentErrors;
+    while(true)
+    {
+        __SplineFittingPrivate::computeKnots(boundaries, degree, result.knots);
+        __SplineFittingPrivate::fitAndMeasure(samples, degree, result, segmentErrors);
+        if(result.maxError <= tolerance)
+            break;
+
+        //split every segment that missed in half. a segment only affects the samples within degree segments of it, so this refines each miss without touching the rest
+        nextBoundaries.clear();
+        nextBoundaries.push_back(boundaries[0]);
+        for(size_t i = 0; i + 1 < boundaries.size(); i++)
+        {
+            floating_t length = boundaries[i + 1] - boundaries[i];
+            if(segmentErrors[i] > tolerance && length > minSegmentLength)
+                nextBoundaries.push_back(boundaries[i] + length / 2);
+            nextBoundaries.push_back(boundaries[i + 1]);
+        }
+
+        //stop if nothing could be split, or if there would be more control points than samples, which couldn't be fitted any better
+        if(nextBoundaries.size() == boundaries.size() || nextBoundaries.size() - 1 + degree > samples.size())
+            break;
+        boundaries.swap(nextBoundaries);
+    }
+
+    return result;
+}
+
+template<class InterpolationType, typename floating_t>
+SplineFitting::Fit<InterpolationType, floating_t> SplineFitting::fitUniform(const std::vector<InterpolationType> &samples, floating_t tolerance, size_t degree)
+{
+    assert(degree > 0);
+    assert(samples.size() > degree);
+    assert(tolerance > 0);
+
+    //evenly spaced knots are 1 apart, so scale the distances along the samples to match
+    std::vector<floating_t> distances = __SplineFittingPrivate::computeSampleT<InterpolationType, floating_t>(samples);
+    std::vector<floating_t> segmentErrors;
+    auto fitWithSegments = [&](size_t segmentCount) {
+        Fit<InterpolationType, floating_t> candidate;
+        candidate.sampleT.resize(samples.size());
+        for(size_t i = 0; i < samples.size(); i++)
+        {
+            candidate.sampleT[i] = std::min(distances[i] / distances.back() * floating_t(segmentCount), floating_t(segmentCount));
+        }
+
+        std::vector<floating_t> boundaries(segmentCount + 1);
+        for(size_t i = 0; i <= segmentCount; i++)
+            boundaries[i] = floating_t(i);
+        __SplineFittingPrivate::computeKnots(boundaries, degree, candidate.knots);
+
+        __SplineFittingPrivate::fitAndMeasure(samples, degree, candidate, segmentErrors);
+        return candidate;
+    };
+
+    //double the number of segments until the fit is good enough, then binary search between the last miss and the first hit
+    const size_t maxSegments = samples.size() - degree;
+    size_t failedSegments = 0;
+    size_t segmentCount = 1;
+    Fit<InterpolationType, floating_t> best = fitWithSegments(segmentCount);
+    while(best.maxError > tolerance && segmentCount < maxSegments)
+    {
+        failedSegments = segmentCount;
+        segmentCount = std::min(maxSegments, segmentCount * 2);
+        best = fitWithSegments(segmentCount);
+    }
+
+    size_t low = failedSegments + 1;
+    size_t high = segmentCount;
+    while(best.maxError <= tolerance && low < high)
+    {
+        size_t middle = low + (high - low) / 2;
+        Fit<InterpolationType, floating_t> candidate = fitWithSegments(middle);
+        if(candidate.maxError <= tolerance)
+        {
+            best = std::move(candidate);
+            high = middle;
+        }
+        else
+        {
+            low = middle + 1;
+        }
+    }
+
+    return best;
+}
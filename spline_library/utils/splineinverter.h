@@ -2,11 +2,17 @@
 
 #include <vector>
 #include <array>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <cassert>
 
 #include <boost/math/tools/minima.hpp>
 
 #include "../spline.h"
 #include "splinesample_adaptor.h"
+#include "parallelfor.h"
+#include "instrumentation.h"
 
 template<class InterpolationType, typename floating_t=float, size_t sampleDimension=2>
 class SplineInverter
@@ -16,8 +22,39 @@ public:
 
     floating_t findClosestT(const InterpolationType &queryPoint) const;
 
+    //batch version of the above: find the closest t for each of the "count" query points, and write it to the corresponding element of output
+    //the queries are split across threadCount threads. if threadCount is 0, use one thread per hardware thread
+    void findClosestT(const InterpolationType *queryPoints, size_t count, floating_t *output, size_t threadCount = 0) const;
+
+    //coherent version of findClosestT, for a query point that has only moved a little since the last query: hintT is the previous result.
+    //starts from hintT and refines with newton's method, only falling back to the global search if the local minimum isn't close to the hint
+    floating_t findClosestT(const InterpolationType &queryPoint, floating_t hintT) const;
+
+    //the spline was edited in place, IE with setPoint, and only segments beginSegment through endSegment - 1 changed. resample just those segments,
+    //and patch the new samples into the search tree, which is only rebuilt once enough edits have piled up. the rest of the spline, including every segment's t values, must be unchanged
+    //if maxT changed, IE because a point was inserted, every sample moved, so this does a full rebuild instead
+    void refit(size_t beginSegment, size_t endSegment);
+
+    //the spline changed everywhere, IE it was rebuilt in place. resample all of it, reusing the samples' memory
+    void rebuild(void);
+
 private: //methods
-    SplineSamples<sampleDimension, floating_t> makeSplineSamples(int samplesPerT) const;
+    SplineSamples<sampleDimension, floating_t> makeSplineSamples(void) const;
+
+    //the number of samples for the spline as it is now, and the t value of each one
+    size_t sampleCount(void) const;
+    floating_t sampleT(size_t index) const;
+
+    //write samples [begin, end) of the spline as it is now to output, through the batch evaluation path
+    void writeSamples(typename SplineSamples<sampleDimension, floating_t>::Point *output, size_t begin, size_t end) const;
+
+    //refine hintT with newton's method, without going more than coherentSearchSamples samples away from it
+    //returns true and writes the closest t to result if it found one, returns false if the caller should do a global search instead
+    bool refineFromHint(const InterpolationType &queryPoint, floating_t hintT, floating_t &result) const;
+
+    //newton's method on the squared distance from the query point, without going more than searchRadius away from startT
+    //returns true and writes the t of the minimum and its squared distance to the output parameters if it converged, returns false otherwise
+    bool newtonRefine(const InterpolationType &queryPoint, floating_t startT, floating_t searchRadius, floating_t &resultT, floating_t &resultDistance) const;
 
     static std::array<floating_t, sampleDimension> convertPoint(const InterpolationType &p);
 
@@ -25,49 +62,124 @@ private: //data
     const Spline<InterpolationType, floating_t> &spline;
 
     //distance in t between samples
+    int samplesPerT;
     floating_t sampleStep;
 
+    //the spline's maxT when it was last sampled, so refit can tell whether the samples can still be updated in place
+    floating_t sampledMaxT;
+
     SplineSampleTree<sampleDimension, floating_t> sampleTree;
+
+    //number of queries a thread claims at a time in the batch version of findClosestT
+    //small enough that threads finishing early can pick up the slack, big enough that the shared counter isn't contended
+    static const size_t batchChunkSize = 256;
+
+    //how far, in samples, the coherent findClosestT will move away from its hint before giving up and doing a global search
+    static const int coherentSearchSamples = 2;
+
+    //newton's method converges quadratically, so if it hasn't converged after this many steps, it never will
+    static const int maxNewtonIterations = 8;
 };
 
 template<class InterpolationType, typename floating_t, size_t sampleDimension>
 SplineInverter<InterpolationType, floating_t, sampleDimension>::SplineInverter(
         const Spline<InterpolationType, floating_t> &spline,
         int samplesPerT)
-    :spline(spline), sampleStep(1.0 / samplesPerT), sampleTree(makeSplineSamples(samplesPerT))
+    :spline(spline), samplesPerT(samplesPerT), sampleStep(1.0 / samplesPerT), sampledMaxT(spline.getMaxT()), sampleTree(makeSplineSamples())
 {
 
 }
 
 template<class InterpolationType, typename floating_t, size_t sampleDimension>
-SplineSamples<sampleDimension, floating_t> SplineInverter<InterpolationType, floating_t, sampleDimension>::makeSplineSamples(int samplesPerT) const
+void SplineInverter<InterpolationType, floating_t, sampleDimension>::refit(size_t beginSegment, size_t endSegment)
 {
-    SplineSamples<sampleDimension, floating_t> samples;
-    floating_t maxT = spline.getMaxT();
-
-    //find the number of segments we're going to use
-    int numSegments = std::round(maxT * samplesPerT);
-
-    for(int i = 0; i < numSegments; i++)
+    assert(beginSegment <= endSegment && endSegment <= spline.segmentCount());
+    if(spline.getMaxT() != sampledMaxT)
     {
-        floating_t currentT = i * sampleStep;
-        auto sampledPoint = convertPoint(spline.getPosition(currentT));
-        samples.pts.emplace_back(sampledPoint, currentT);
+        rebuild();
+        return;
     }
+    if(beginSegment == endSegment)
+        return;
+
+    //the samples are evenly spaced in t, so the ones inside the changed segments are a contiguous range. include the samples on either side,
+    //since a sample that lands exactly on a segment boundary might have been rounded to either side of it
+    size_t count = sampleCount();
+    floating_t beginT = spline.segmentT(beginSegment);
+    floating_t endT = spline.segmentT(endSegment);
+    size_t begin = size_t(std::max(std::floor(beginT * samplesPerT) - 1, floating_t(0)));
+    size_t end = std::min(size_t(std::max(std::ceil(endT * samplesPerT) + 2, floating_t(0))), count);
+
+    std::vector<typename SplineSamples<sampleDimension, floating_t>::Point> samples(end - begin);
+    writeSamples(samples.data(), begin, end);
+    sampleTree.replaceSamples(begin, samples.data(), samples.size());
+}
+
+template<class InterpolationType, typename floating_t, size_t sampleDimension>
+void SplineInverter<InterpolationType, floating_t, sampleDimension>::rebuild(void)
+{
+    sampledMaxT = spline.getMaxT();
+
+    SplineSamples<sampleDimension, floating_t> &samples = sampleTree.editSamples();
+    size_t count = sampleCount();
+    samples.pts.resize(count);
+    writeSamples(samples.pts.data(), 0, count);
+    sampleTree.rebuildIndex();
+}
 
+template<class InterpolationType, typename floating_t, size_t sampleDimension>
+size_t SplineInverter<InterpolationType, floating_t, sampleDimension>::sampleCount(void) const
+{
     //if the spline isn't a loop, add a sample for maxT
-    if(!spline.isLooping())
-    {
-        auto sampledPoint = convertPoint(spline.getPosition(maxT));
-        samples.pts.emplace_back(sampledPoint, maxT);
-    }
+    size_t count = size_t(std::round(spline.getMaxT() * samplesPerT));
+    return spline.isLooping() ? count : count + 1;
+}
 
+template<class InterpolationType, typename floating_t, size_t sampleDimension>
+floating_t SplineInverter<InterpolationType, floating_t, sampleDimension>::sampleT(size_t index) const
+{
+    //the last sample of a non-looping spline is exactly maxT, even if maxT isn't a multiple of the sample step
+    if(!spline.isLooping() && index + 1 == sampleCount())
+        return spline.getMaxT();
+    return index * sampleStep;
+}
+
+template<class InterpolationType, typename floating_t, size_t sampleDimension>
+SplineSamples<sampleDimension, floating_t> SplineInverter<InterpolationType, floating_t, sampleDimension>::makeSplineSamples(void) const
+{
+    SplineSamples<sampleDimension, floating_t> samples;
+    size_t count = sampleCount();
+    samples.pts.resize(count);
+    writeSamples(samples.pts.data(), 0, count);
     return samples;
 }
 
+template<class InterpolationType, typename floating_t, size_t sampleDimension>
+void SplineInverter<InterpolationType, floating_t, sampleDimension>::writeSamples(typename SplineSamples<sampleDimension, floating_t>::Point *output, size_t begin, size_t end) const
+{
+    //evaluate in blocks, so the batch path skips the segment search for every sample but the first in each block, without a temporary as big as the whole spline
+    const size_t blockSize = 256;
+    std::array<floating_t, blockSize> tValues;
+    std::array<InterpolationType, blockSize> positions;
+    for(size_t blockBegin = begin; blockBegin < end; blockBegin += blockSize)
+    {
+        size_t blockCount = std::min(blockSize, end - blockBegin);
+        for(size_t i = 0; i < blockCount; i++)
+            tValues[i] = sampleT(blockBegin + i);
+
+        spline.getPositions(tValues.data(), blockCount, positions.data());
+        for(size_t i = 0; i < blockCount; i++)
+        {
+            output[blockBegin - begin + i] = typename SplineSamples<sampleDimension, floating_t>::Point(convertPoint(positions[i]), tValues[i]);
+        }
+    }
+}
+
 template<class InterpolationType, typename floating_t, size_t sampleDimension>
 floating_t SplineInverter<InterpolationType, floating_t, sampleDimension>::findClosestT(const InterpolationType &queryPoint) const
 {
+    SPLINE_LIBRARY_TIMED_SCOPE(InverterQueries, 1);
+
     auto convertedQueryPoint = convertPoint(queryPoint);
     floating_t closestSampleT = sampleTree.findClosestSample(convertedQueryPoint);
 
@@ -107,6 +219,8 @@ floating_t SplineInverter<InterpolationType, floating_t, sampleDimension>::findC
     }
 
     auto distanceFunction = [this, queryPoint](floating_t t) {
+        //brent's method evaluates this once per iteration
+        SPLINE_LIBRARY_COUNT(BrentIterations, 1);
         return (spline.getPosition(t) - queryPoint).lengthSquared();
     };
 
@@ -116,6 +230,151 @@ floating_t SplineInverter<InterpolationType, floating_t, sampleDimension>::findC
     return result.first;
 }
 
+template<class InterpolationType, typename floating_t, size_t sampleDimension>
+void SplineInverter<InterpolationType, floating_t, sampleDimension>::findClosestT(const InterpolationType *queryPoints, size_t count, floating_t *output, size_t threadCount) const
+{
+    SplineCommon::parallelFor(count, batchChunkSize, threadCount, [&](size_t i) {
+        output[i] = findClosestT(queryPoints[i]);
+    });
+}
+
+template<class InterpolationType, typename floating_t, size_t sampleDimension>
+floating_t SplineInverter<InterpolationType, floating_t, sampleDimension>::findClosestT(const InterpolationType &queryPoint, floating_t hintT) const
+{
+    floating_t result;
+    {
+        SPLINE_LIBRARY_TIMED_SCOPE(InverterQueries, 1);
+        if(refineFromHint(queryPoint, hintT, result))
+            return result;
+    }
+    return findClosestT(queryPoint);
+}
+
+template<class InterpolationType, typename floating_t, size_t sampleDimension>
+bool SplineInverter<InterpolationType, floating_t, sampleDimension>::refineFromHint(const InterpolationType &queryPoint, floating_t hintT, floating_t &result) const
+{
+    floating_t maxT = spline.getMaxT();
+    bool looping = spline.isLooping();
+
+    //the hint might come from anywhere, so bring it into the range of t values findClosestT returns
+    if(looping)
+    {
+        hintT = std::fmod(hintT, maxT);
+        if(hintT < 0)
+            hintT += maxT;
+    }
+    else
+    {
+        hintT = std::min(std::max(hintT, floating_t(0)), maxT);
+    }
+
+    //a looping spline's t is free to leave [0, maxT] here, because getPosition etc wrap it. it just gets wrapped again at the end
+    floating_t searchRadius = coherentSearchSamples * sampleStep;
+    floating_t refinedT, refinedDistance;
+    if(!newtonRefine(queryPoint, hintT, searchRadius, refinedT, refinedDistance))
+        return false;
+
+    //the spline might fold back on itself so that some other part of it is closer than the minimum we found near the hint
+    //we can't rule that out everywhere without a global search, but we can check evenly spaced samples across the search window,
+    //the same way the constructor samples the whole spline. if any of them is closer, the minimum we found isn't the one we want
+    for(int i = -coherentSearchSamples; i <= coherentSearchSamples; i++)
+    {
+        floating_t sampleT = hintT + i * sampleStep;
+        if(i == 0 || (!looping && (sampleT < 0 || sampleT > maxT)))
+            continue;
+
+        if((spline.getPosition(sampleT) - queryPoint).lengthSquared() < refinedDistance)
+            return false;
+    }
+
+    if(looping)
+    {
+        refinedT = std::fmod(refinedT, maxT);
+        if(refinedT < 0)
+            refinedT += maxT;
+    }
+    result = refinedT;
+    return true;
+}
+
+template<class InterpolationType, typename floating_t, size_t sampleDimension>
+bool SplineInverter<InterpolationType, floating_t, sampleDimension>::newtonRefine(const InterpolationType &queryPoint, floating_t startT, floating_t searchRadius, floating_t &resultT, floating_t &resultDistance) const
+{
+    floating_t maxT = spline.getMaxT();
+    bool looping = spline.isLooping();
+
+    floating_t lower = startT - searchRadius;
+    floating_t upper = startT + searchRadius;
+    if(!looping)
+    {
+        lower = std::max(lower, floating_t(0));
+        upper = std::min(upper, maxT);
+    }
+
+    //newton's method converges quadratically, so once a step is a small fraction of a sample, the error after taking it is
+    //already smaller than the tolerance brent's method is given in the global search. but never go finer than t can represent
+    floating_t tolerance = std::max(sampleStep / 64, std::abs(startT) * std::numeric_limits<floating_t>::epsilon() * 4);
+
+    floating_t t = startT;
+    for(int i = 0; i < maxNewtonIterations; i++)
+    {
+        //the first derivative of half the squared distance is the displacement dotted with the tangent,
+        //and the second derivative is the squared speed plus the displacement dotted with the curvature
+        auto sampleResult = spline.getCurvature(t);
+        InterpolationType displacement = sampleResult.position - queryPoint;
+        floating_t slope = InterpolationType::dotProduct(displacement, sampleResult.tangent);
+        floating_t concavity = InterpolationType::dotProduct(sampleResult.tangent, sampleResult.tangent)
+                + InterpolationType::dotProduct(displacement, sampleResult.curvature);
+
+        floating_t step;
+        if(concavity > 0)
+        {
+            //never take a step longer than the distance between samples - if the minimum is further than that, we'll get there over several steps
+            step = std::min(std::max(-slope / concavity, -sampleStep), sampleStep);
+        }
+        else if(slope != 0)
+        {
+            //the distance isn't convex here, so newton's method would take us towards a maximum. just go downhill instead
+            step = slope > 0 ? -sampleStep / 2 : sampleStep / 2;
+        }
+        else
+        {
+            //we're sitting exactly on a maximum of distance, so there's no way to tell which direction to go
+            return false;
+        }
+
+        floating_t nextT = t + step;
+
+        //if the minimum is past the end of a non-looping spline, the end itself is the closest point
+        if(!looping && (nextT < 0 || nextT > maxT) && (t == 0 || t == maxT))
+        {
+            resultT = t;
+            resultDistance = displacement.lengthSquared();
+            return true;
+        }
+
+        nextT = std::min(std::max(nextT, lower), upper);
+
+        //once the step is this small, it takes us the rest of the way. the distance isn't evaluated again at the new t,
+        //but the distance at the last t is only a hair bigger, which is good enough for comparisons
+        if(std::abs(step) <= tolerance && concavity > 0)
+        {
+            resultT = nextT;
+            resultDistance = displacement.lengthSquared();
+            return true;
+        }
+
+        //if we've been clamped to the edge of the search window, the minimum is further away
+        if(nextT == t)
+            return false;
+
+        t = nextT;
+    }
+
+    //didn't converge
+    return false;
+}
+
 template<class InterpolationType, typename floating_t, size_t sampleDimension>
 std::array<floating_t, sampleDimension> SplineInverter<InterpolationType, floating_t, sampleDimension>::convertPoint(const InterpolationType &p)
 {
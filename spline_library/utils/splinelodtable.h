@@ -0,0 +1,312 @@
+#pragma once
+
+#include <vector>
+#include <array>
+#include <algorithm>
+#include <cstdint>
+#include <cmath>
+#include <cassert>
+
+#include "../spline.h"
+#include "spline_common.h"
+
+//an approximation of a spline for level of detail: a dense table of samples, evenly spaced in t, so that each query is one multiply to find its place in the table,
+//and a blend of the two samples on either side. for far away objects and particle effects, where the spline only needs to look right, not be exact
+//the samples are interleaved, so the two samples a query reads are next to each other in memory, usually in the same cache line
+//
+//with Cubic interpolation, each sample also stores the tangent there, and queries blend with a cubic hermite curve, which has a much smaller error for the same table size
+//with quantization, each component is stored as a 16 bit fixed point value relative to the range of that component across the table, which halves the memory again with floats
+//the position and tangent errors are measured once the table is built, against the spline itself, so the table only uses the spline while it's being built, and can outlive it
+//they're measured at a fixed set of t values, so they're estimates of the largest error, not bounds
+template<class InterpolationType, typename floating_t=float, size_t dimension=2>
+class SplineLodTable
+{
+public:
+    enum Interpolation { Linear, Cubic };
+    typedef typename Spline<InterpolationType, floating_t>::InterpolatedPT InterpolatedPT;
+
+    //build a table with sampleCount samples, from the beginning of the spline to the end. sampleCount must be at least 2
+    SplineLodTable(const Spline<InterpolationType, floating_t> &spline, size_t sampleCount, Interpolation interpolation = Cubic, bool quantized = false);
+
+    //build the smallest table, doubling the number of intervals each time, whose measured position error is at most maxError, or the last one tried before going past maxSampleCount
+    //quantization alone costs about 1/131070th of the size of the spline, so a smaller maxError can only be met without it
+    static SplineLodTable withMaxError(const Spline<InterpolationType, floating_t> &spline, floating_t maxError, Interpolation interpolation = Cubic,
+                                       bool quantized = false, size_t maxSampleCount = size_t(1) << 20);
+
+    //the same as the spline's getPosition and getTangent, approximately. t values outside the spline are wrapped for a looping spline, and clamped otherwise
+    InterpolationType getPosition(floating_t t) const;
+    InterpolatedPT getTangent(floating_t t) const;
+
+    //the largest distance between getPosition and the spline's getPosition, measured at every sample and at checksPerInterval - 1 points evenly spaced between each pair of samples
+    //both interpolations are furthest from the spline near the middle of each interval, which is always checked, so this is close to the true largest error, but it can be a little under
+    inline floating_t measuredPositionError(void) const { return positionError; }
+
+    //the same for getTangent's tangent and the spline's tangent, at the same t values
+    //the cubic tangent error peaks between the checks, so the true largest tangent error can be up to about 1.5 times this with Cubic interpolation
+    inline floating_t measuredTangentError(void) const { return tangentError; }
+
+    //measuredPositionError as a fraction of the length of the diagonal of the box around the samples
+    inline floating_t relativePositionError(void) const { return size > 0 ? positionError / size : 0; }
+
+    inline size_t sampleCount(void) const { return samples; }
+    inline Interpolation getInterpolation(void) const { return interpolation; }
+    inline bool isQuantized(void) const { return quantized; }
+
+    //the number of bytes used by the table, including everything it allocated
+    size_t memoryFootprint(void) const;
+
+    static const size_t checksPerInterval = 4;
+
+private:
+    //the position of sample index, and with Cubic interpolation, its tangent scaled by the distance in t between samples
+    InterpolationType loadPosition(size_t index) const { return load(index, 0); }
+    InterpolationType loadTangent(size_t index) const { return load(index, dimension); }
+    InterpolationType load(size_t index, size_t offset) const;
+
+    //the interval containing t, and how far through it t is, from 0 to 1
+    size_t findInterval(floating_t t, floating_t &fraction) const;
+
+    void measureError(const Spline<InterpolationType, floating_t> &spline);
+
+    Interpolation interpolation;
+    bool quantized;
+    bool looping;
+
+    size_t samples;
+    size_t stride;
+    floating_t beginT;
+    floating_t endT;
+    floating_t step;
+    floating_t inverseStep;
+
+    //one record of stride components per sample: the position, followed by the scaled tangent with Cubic interpolation. only one of the two is used
+    std::vector<floating_t> values;
+    std::vector<uint16_t> quantizedValues;
+
+    //a quantized component is componentOrigin + q * componentScale
+    std::array<floating_t, dimension * 2> componentOrigin;
+    std::array<floating_t, dimension * 2> componentScale;
+
+    floating_t positionError;
+    floating_t tangentError;
+    floating_t size;
+};
+
+template<class InterpolationType, typename floating_t, size_t dimension>
+SplineLodTable<InterpolationType, floating_t, dimension>::SplineLodTable(const Spline<InterpolationType, floating_t> &spline, size_t sampleCount, Interpolation interpolation, bool quantized)
+    :interpolation(interpolation), quantized(quantized), looping(spline.isLooping()), samples(sampleCount), stride(interpolation == Cubic ? dimension * 2 : dimension),
+      beginT(spline.segmentT(0)), endT(spline.getMaxT()), step((endT - beginT) / (sampleCount - 1)), inverseStep((sampleCount - 1) / (endT - beginT))
+{
+    assert(sampleCount >= 2);
+    assert(endT > beginT);
+
+    //aim for each t value directly, instead of adding up steps, so that rounding can't drift, and the last sample is exactly at the end
+    std::vector<floating_t> tValues(samples);
+    for(size_t i = 0; i < samples; i++)
+    {
+        tValues[i] = i + 1 == samples ? endT : beginT + (endT - beginT) * i / (samples - 1);
+    }
+
+    std::vector<floating_t> table(samples * stride);
+    if(interpolation == Cubic)
+    {
+        std::vector<InterpolatedPT> tangents(samples);
+        spline.getTangents(tValues.data(), samples, tangents.data());
+        for(size_t i = 0; i < samples; i++)
+        {
+            for(size_t d = 0; d < dimension; d++)
+            {
+                table[i * stride + d] = tangents[i].position[d];
+                table[i * stride + dimension + d] = tangents[i].tangent[d] * step;
+            }
+        }
+    }
+    else
+    {
+        std::vector<InterpolationType> positions(samples);
+        spline.getPositions(tValues.data(), samples, positions.data());
+        for(size_t i = 0; i < samples; i++)
+        {
+            for(size_t d = 0; d < dimension; d++)
+            {
+                table[i * stride + d] = positions[i][d];
+            }
+        }
+    }
+
+    //the range of each component, which the quantized values are relative to, and whose position part measures the size of the spline
+    std::array<floating_t, dimension * 2> componentMin, componentMax;
+    for(size_t c = 0; c < stride; c++)
+    {
+        componentMin[c] = componentMax[c] = table[c];
+        for(size_t i = 1; i < samples; i++)
+        {
+            componentMin[c] = std::min(componentMin[c], table[i * stride + c]);
+            componentMax[c] = std::max(componentMax[c], table[i * stride + c]);
+        }
+    }
+    size = 0;
+    for(size_t d = 0; d < dimension; d++)
+    {
+        size += (componentMax[d] - componentMin[d]) * (componentMax[d] - componentMin[d]);
+    }
+    size = std::sqrt(size);
+
+    if(quantized)
+    {
+        for(size_t c = 0; c < stride; c++)
+        {
+            componentOrigin[c] = componentMin[c];
+            componentScale[c] = (componentMax[c] - componentMin[c]) / 65535;
+        }
+
+        quantizedValues.resize(table.size());
+        for(size_t i = 0; i < table.size(); i++)
+        {
+            size_t c = i % stride;
+            floating_t q = componentScale[c] > 0 ? (table[i] - componentOrigin[c]) / componentScale[c] : 0;
+            quantizedValues[i] = uint16_t(std::min(std::max(std::round(q), floating_t(0)), floating_t(65535)));
+        }
+    }
+    else
+    {
+        values = std::move(table);
+    }
+
+    measureError(spline);
+}
+
+template<class InterpolationType, typename floating_t, size_t dimension>
+SplineLodTable<InterpolationType, floating_t, dimension> SplineLodTable<InterpolationType, floating_t, dimension>::withMaxError(
+        const Spline<InterpolationType, floating_t> &spline, floating_t maxError, Interpolation interpolation, bool quantized, size_t maxSampleCount)
+{
+    assert(maxSampleCount >= 2);
+
+    //start with a couple of samples per segment, since anything less can't follow the segments at all
+    size_t sampleCount = std::min(std::max(spline.segmentCount() * 2 + 1, size_t(3)), maxSampleCount);
+    SplineLodTable result(spline, sampleCount, interpolation, quantized);
+    while(result.measuredPositionError() > maxError && (sampleCount - 1) * 2 + 1 <= maxSampleCount)
+    {
+        //doubling the intervals keeps every old sample, and divides the error by about 4 for linear interpolation, or 16 for cubic
+        sampleCount = (sampleCount - 1) * 2 + 1;
+        result = SplineLodTable(spline, sampleCount, interpolation, quantized);
+    }
+    return result;
+}
+
+template<class InterpolationType, typename floating_t, size_t dimension>
+size_t SplineLodTable<InterpolationType, floating_t, dimension>::findInterval(floating_t t, floating_t &fraction) const
+{
+    if(looping)
+    {
+        t = std::fmod(t - beginT, endT - beginT);
+        if(t < 0)
+            t += endT - beginT;
+    }
+    else
+    {
+        t = std::min(std::max(t - beginT, floating_t(0)), endT - beginT);
+    }
+
+    floating_t x = t * inverseStep;
+    size_t index = std::min(size_t(x), samples - 2);
+    fraction = x - index;
+    return index;
+}
+
+template<class InterpolationType, typename floating_t, size_t dimension>
+InterpolationType SplineLodTable<InterpolationType, floating_t, dimension>::load(size_t index, size_t offset) const
+{
+    InterpolationType result = InterpolationType();
+    size_t begin = index * stride + offset;
+    if(quantized)
+    {
+        for(size_t d = 0; d < dimension; d++)
+            result[d] = componentOrigin[offset + d] + quantizedValues[begin + d] * componentScale[offset + d];
+    }
+    else
+    {
+        for(size_t d = 0; d < dimension; d++)
+            result[d] = values[begin + d];
+    }
+    return result;
+}
+
+template<class InterpolationType, typename floating_t, size_t dimension>
+InterpolationType SplineLodTable<InterpolationType, floating_t, dimension>::getPosition(floating_t t) const
+{
+    floating_t f;
+    size_t index = findInterval(t, f);
+
+    InterpolationType p0 = loadPosition(index);
+    InterpolationType p1 = loadPosition(index + 1);
+    if(interpolation == Linear)
+        return p0 + (p1 - p0) * f;
+
+    //cubic hermite basis functions. the tangents were scaled by the step when the table was built, so they're already in terms of f
+    floating_t oneMinusF = 1 - f;
+    floating_t h00 = (1 + 2 * f) * oneMinusF * oneMinusF;
+    floating_t h10 = f * oneMinusF * oneMinusF;
+    floating_t h01 = f * f * (3 - 2 * f);
+    floating_t h11 = f * f * (f - 1);
+    return p0 * h00 + loadTangent(index) * h10 + p1 * h01 + loadTangent(index + 1) * h11;
+}
+
+template<class InterpolationType, typename floating_t, size_t dimension>
+typename SplineLodTable<InterpolationType, floating_t, dimension>::InterpolatedPT SplineLodTable<InterpolationType, floating_t, dimension>::getTangent(floating_t t) const
+{
+    floating_t f;
+    size_t index = findInterval(t, f);
+
+    InterpolationType p0 = loadPosition(index);
+    InterpolationType p1 = loadPosition(index + 1);
+    if(interpolation == Linear)
+        return InterpolatedPT(p0 + (p1 - p0) * f, (p1 - p0) * inverseStep);
+
+    InterpolationType m0 = loadTangent(index);
+    InterpolationType m1 = loadTangent(index + 1);
+
+    floating_t oneMinusF = 1 - f;
+    floating_t h00 = (1 + 2 * f) * oneMinusF * oneMinusF;
+    floating_t h10 = f * oneMinusF * oneMinusF;
+    floating_t h01 = f * f * (3 - 2 * f);
+    floating_t h11 = f * f * (f - 1);
+
+    //the derivatives of the basis functions with respect to f, converted to t at the end
+    floating_t d00 = 6 * f * (f - 1);
+    floating_t d10 = (3 * f - 1) * (f - 1);
+    floating_t d11 = f * (3 * f - 2);
+    return InterpolatedPT(
+                p0 * h00 + m0 * h10 + p1 * h01 + m1 * h11,
+                ((p0 - p1) * d00 + m0 * d10 + m1 * d11) * inverseStep
+                );
+}
+
+template<class InterpolationType, typename floating_t, size_t dimension>
+void SplineLodTable<InterpolationType, floating_t, dimension>::measureError(const Spline<InterpolationType, floating_t> &spline)
+{
+    size_t checkCount = (samples - 1) * checksPerInterval + 1;
+    std::vector<floating_t> tValues(checkCount);
+    for(size_t i = 0; i < checkCount; i++)
+    {
+        tValues[i] = i + 1 == checkCount ? endT : beginT + (endT - beginT) * i / (checkCount - 1);
+    }
+
+    std::vector<InterpolatedPT> expected(checkCount);
+    spline.getTangents(tValues.data(), checkCount, expected.data());
+
+    positionError = 0;
+    tangentError = 0;
+    for(size_t i = 0; i < checkCount; i++)
+    {
+        InterpolatedPT actual = getTangent(tValues[i]);
+        positionError = std::max(positionError, floating_t((actual.position - expected[i].position).length()));
+        tangentError = std::max(tangentError, floating_t((actual.tangent - expected[i].tangent).length()));
+    }
+}
+
+template<class InterpolationType, typename floating_t, size_t dimension>
+size_t SplineLodTable<InterpolationType, floating_t, dimension>::memoryFootprint(void) const
+{
+    return sizeof(*this) + SplineCommon::vectorFootprint(values) + SplineCommon::vectorFootprint(quantizedValues);
+}
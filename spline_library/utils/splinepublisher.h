@@ -0,0 +1,280 @@
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <new>
+#include <vector>
+#include <algorithm>
+#include <cstdint>
+#include <cassert>
+
+//shares a spline between one writer thread, which edits it, and any number of reader threads, which evaluate it, without either side ever taking a lock
+//the writer never edits a spline that a reader might see. instead it publishes a whole new version, and readers that took a snapshot before that
+//keep evaluating the version they took, so readers never wait on an edit, and never see one half finished
+//
+//reading is wait-free: a reader announces the current epoch in its own slot, then loads the current version. the writer bumps the epoch every time it publishes,
+//so a retired version can be reused once every reader that's still holding a snapshot announced a later epoch than the one it was retired in
+//reused versions are recycled as storage for the next version, so once the vectors inside them have grown big enough, editing doesn't allocate
+//
+//SplineType is a concrete spline type, like NaturalSpline<QVector2D>, so that the writer can call its rebuild and edit methods
+//only one thread may write at a time. readers must be registered from the publisher, and must not outlive it
+template<class SplineType>
+class SplinePublisher
+{
+private:
+    //each reader gets its own cache line, so that announcing an epoch doesn't slow down the readers around it
+    static constexpr size_t cacheLineSize = 64;
+    struct alignas(cacheLineSize) ReaderSlot
+    {
+        //0 while the reader isn't holding a snapshot
+        std::atomic<uint64_t> epoch;
+        std::atomic<bool> claimed;
+        char padding[cacheLineSize - sizeof(std::atomic<uint64_t>) - sizeof(std::atomic<bool>)];
+    };
+
+public:
+    //a read-only view of one version of the spline. the version stays alive, and unchanged, until the snapshot is destroyed
+    class Snapshot
+    {
+    public:
+        Snapshot(Snapshot &&other) :spline(other.spline), slot(other.slot) { other.slot = nullptr; }
+        Snapshot(const Snapshot &) = delete;
+        Snapshot &operator=(const Snapshot &) = delete;
+        ~Snapshot(void)
+        {
+            if(slot)
+                slot->epoch.store(0, std::memory_order_release);
+        }
+
+        //false if it came from an invalid reader, in which case there's no version to look at
+        inline bool isValid(void) const { return spline != nullptr; }
+
+        inline const SplineType &operator*(void) const { return *spline; }
+        inline const SplineType *operator->(void) const { return spline; }
+        inline const SplineType *get(void) const { return spline; }
+
+    private:
+        friend class SplinePublisher;
+        Snapshot(const SplineType *spline, ReaderSlot *slot) :spline(spline), slot(slot) {}
+
+        const SplineType *spline;
+        ReaderSlot *slot;
+    };
+
+    //one reader thread's registration. a reader can hold one snapshot at a time, so a thread that needs two versions at once needs two readers
+    class Reader
+    {
+    public:
+        Reader(Reader &&other) :publisher(other.publisher), slot(other.slot) { other.slot = nullptr; }
+        Reader(const Reader &) = delete;
+        Reader &operator=(const Reader &) = delete;
+        ~Reader(void)
+        {
+            if(slot)
+            {
+                assert(slot->epoch.load(std::memory_order_relaxed) == 0);
+                slot->claimed.store(false, std::memory_order_release);
+            }
+        }
+
+        //false if every reader slot was taken when this reader was registered. reading from an invalid reader gives an invalid snapshot
+        inline bool isValid(void) const { return slot != nullptr; }
+
+        //the latest published version. this never blocks, and never retries
+        Snapshot read(void) const
+        {
+            if(!slot)
+                return Snapshot(nullptr, nullptr);
+            assert(slot->epoch.load(std::memory_order_relaxed) == 0);
+
+            //the announcement has to be visible before the version is loaded, or the writer could reuse the version in between, hence seq_cst
+            slot->epoch.store(publisher->epoch.load(std::memory_order_seq_cst), std::memory_order_seq_cst);
+            return Snapshot(publisher->current.load(std::memory_order_seq_cst), slot);
+        }
+
+    private:
+        friend class SplinePublisher;
+        Reader(const SplinePublisher *publisher, ReaderSlot *slot) :publisher(publisher), slot(slot) {}
+
+        const SplinePublisher *publisher;
+        ReaderSlot *slot;
+    };
+
+    //the reader slots are allocated up front, so maxReaders is the most readers that can be registered at once
+    SplinePublisher(SplineType initial, size_t maxReaders = 64);
+    ~SplinePublisher(void);
+
+    SplinePublisher(const SplinePublisher &) = delete;
+    SplinePublisher &operator=(const SplinePublisher &) = delete;
+
+    //claim a reader slot. this is lock-free, but it's meant to be called once per thread, not once per read
+    //if all maxReaders slots are taken, the reader is invalid, so check isValid() on the result, and register again once another reader has been destroyed
+    Reader registerReader(void) const;
+
+//writing
+public:
+    //the latest published version, for the writer to look at. readers should take a snapshot instead
+    inline const SplineType &latest(void) const { return *currentVersion; }
+
+    //publish a copy of the latest version, after calling modify on it, IE to move a single point with setPoint
+    //the copy goes into a recycled version when there's one available, so it reuses that version's memory
+    template<class Modify>
+    void modify(Modify modify);
+
+    //publish a new version built by calling build on it, which should replace everything in it, IE with rebuild
+    //when there's a recycled version available, build gets it as is, so nothing is copied. otherwise it gets a copy of the latest version
+    template<class Build>
+    void replace(Build build);
+
+    //publish a version the caller built
+    void publish(std::unique_ptr<SplineType> version);
+
+    //a retired version that no reader can still see, for the caller to reuse, or null if there isn't one yet
+    std::unique_ptr<SplineType> reclaim(void);
+
+    //the number of retired versions that some reader might still be holding. a reader that holds onto a snapshot forever keeps every later version alive too
+    size_t retiredCount(void) const { return retired.size(); }
+
+private:
+    struct RetiredVersion
+    {
+        std::unique_ptr<SplineType> spline;
+
+        //readers that announced this epoch or later loaded a newer version
+        uint64_t epoch;
+    };
+
+    //free every retired version that no reader is holding, except one, which is kept as the spare. so memory follows what's in use
+    void collect(void);
+
+    //new ReaderSlot[] only has to honour alignments above alignof(std::max_align_t) from C++17 on, so the slots are placed in an over-allocated buffer instead
+    std::unique_ptr<unsigned char[]> slotStorage;
+    ReaderSlot *readerSlots;
+    size_t slotCount;
+
+    std::atomic<uint64_t> epoch;
+    std::atomic<const SplineType*> current;
+
+    //only the writer touches these
+    std::unique_ptr<SplineType> currentVersion;
+    std::vector<RetiredVersion> retired;
+    std::unique_ptr<SplineType> spare;
+};
+
+template<class SplineType>
+SplinePublisher<SplineType>::SplinePublisher(SplineType initial, size_t maxReaders)
+    :slotStorage(new unsigned char[maxReaders * sizeof(ReaderSlot) + alignof(ReaderSlot) - 1]), slotCount(maxReaders), epoch(1), currentVersion(new SplineType(std::move(initial)))
+{
+    void *alignedStorage = slotStorage.get();
+    size_t storageSize = maxReaders * sizeof(ReaderSlot) + alignof(ReaderSlot) - 1;
+    readerSlots = static_cast<ReaderSlot*>(std::align(alignof(ReaderSlot), maxReaders * sizeof(ReaderSlot), alignedStorage, storageSize));
+    assert(readerSlots != nullptr);
+
+    for(size_t i = 0; i < slotCount; i++)
+    {
+        new(&readerSlots[i]) ReaderSlot;
+        readerSlots[i].epoch.store(0, std::memory_order_relaxed);
+        readerSlots[i].claimed.store(false, std::memory_order_relaxed);
+    }
+    current.store(currentVersion.get(), std::memory_order_seq_cst);
+}
+
+template<class SplineType>
+SplinePublisher<SplineType>::~SplinePublisher(void)
+{
+    for(size_t i = 0; i < slotCount; i++)
+    {
+        assert(!readerSlots[i].claimed.load(std::memory_order_acquire));
+        readerSlots[i].~ReaderSlot();
+    }
+}
+
+template<class SplineType>
+typename SplinePublisher<SplineType>::Reader SplinePublisher<SplineType>::registerReader(void) const
+{
+    for(size_t i = 0; i < slotCount; i++)
+    {
+        bool expected = false;
+        if(!readerSlots[i].claimed.load(std::memory_order_relaxed) && readerSlots[i].claimed.compare_exchange_strong(expected, true, std::memory_order_acquire))
+        {
+            return Reader(this, &readerSlots[i]);
+        }
+    }
+
+    //every slot is taken. the caller has to check isValid, or construct the publisher with a higher maxReaders
+    return Reader(this, nullptr);
+}
+
+template<class SplineType>
+template<class Modify>
+void SplinePublisher<SplineType>::modify(Modify modify)
+{
+    //copy assignment keeps the recycled version's vectors, so if they're already big enough, this doesn't allocate
+    std::unique_ptr<SplineType> version = reclaim();
+    if(version)
+        *version = *currentVersion;
+    else
+        version.reset(new SplineType(*currentVersion));
+
+    modify(*version);
+    publish(std::move(version));
+}
+
+template<class SplineType>
+template<class Build>
+void SplinePublisher<SplineType>::replace(Build build)
+{
+    std::unique_ptr<SplineType> version = reclaim();
+    if(!version)
+        version.reset(new SplineType(*currentVersion));
+
+    build(*version);
+    publish(std::move(version));
+}
+
+template<class SplineType>
+void SplinePublisher<SplineType>::publish(std::unique_ptr<SplineType> version)
+{
+    assert(version);
+
+    //a reader that loads the old version has already announced the old epoch, so tagging the old version with the new epoch keeps it alive for that reader
+    current.store(version.get(), std::memory_order_seq_cst);
+    uint64_t retiredEpoch = epoch.fetch_add(1, std::memory_order_seq_cst) + 1;
+
+    retired.push_back(RetiredVersion{std::move(currentVersion), retiredEpoch});
+    currentVersion = std::move(version);
+    collect();
+}
+
+template<class SplineType>
+std::unique_ptr<SplineType> SplinePublisher<SplineType>::reclaim(void)
+{
+    collect();
+    return std::move(spare);
+}
+
+template<class SplineType>
+void SplinePublisher<SplineType>::collect(void)
+{
+    if(retired.empty())
+        return;
+
+    //the oldest epoch any reader is holding. readers that aren't holding a snapshot don't hold anything back
+    uint64_t oldestHeld = UINT64_MAX;
+    for(size_t i = 0; i < slotCount; i++)
+    {
+        uint64_t held = readerSlots[i].epoch.load(std::memory_order_seq_cst);
+        if(held != 0)
+            oldestHeld = std::min(oldestHeld, held);
+    }
+
+    //versions are retired in epoch order, so the free ones are all at the front
+    size_t freeCount = 0;
+    while(freeCount < retired.size() && retired[freeCount].epoch <= oldestHeld)
+        freeCount++;
+
+    //keep the most recently retired free version as the spare, since it's the most likely to be the same size as the next one
+    if(freeCount > 0 && !spare)
+        spare = std::move(retired[freeCount - 1].spline);
+    retired.erase(retired.begin(), retired.begin() + freeCount);
+}
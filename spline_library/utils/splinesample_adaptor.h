@@ -31,8 +31,13 @@
  *************************************************************************/
 
 #include "nanoflann.hpp"
+#include "instrumentation.h"
 #include <vector>
 #include <array>
+#include <algorithm>
+#include <utility>
+#include <limits>
+#include <cassert>
 
 template<int dimension, typename floating_t>
 struct SplineSamples
@@ -44,6 +49,10 @@ struct SplineSamples
         std::array<coord_t, dimension> coords;
         coord_t t;
 
+        //true if the sample has been replaced since the index was built. the search skips it, and finds its replacement in the tree's patch instead
+        bool replaced = false;
+
+        Point(void) = default;
         Point(const std::array<coord_t, dimension> &coords, coord_t ct)
             :coords(coords), t(ct)
         {}
@@ -58,7 +67,8 @@ struct SplineSampleAdaptor
 {
     typedef typename Derived::coord_t coord_t;
 
-    const Derived obj;
+    //the samples belong to whoever built the adaptor, and must outlive it. they aren't copied, so they can be updated in place before rebuilding the index
+    const Derived &obj;
 
     /// The constructor that sets the data set source
     SplineSampleAdaptor(const Derived &obj_) : obj(obj_) {}
@@ -72,6 +82,10 @@ struct SplineSampleAdaptor
     // Returns the distance between the vector "p1[0:size-1]" and the data point with index "idx_p2" stored in the class:
     inline coord_t kdtree_distance(const coord_t *p1, const size_t idx_p2,size_t size) const
     {
+        //a replaced sample's old position is still what the index was built from, so leave it where it is, but never let the search pick it
+        if(derived().pts[idx_p2].replaced)
+            return std::numeric_limits<coord_t>::max();
+
         coord_t sum = 0;
         for(size_t i = 0; i < size; i++) {
             coord_t diff = p1[i]-derived().pts[idx_p2].coords[i];
@@ -106,26 +120,99 @@ class SplineSampleTree
         TreeType;
 
 public:
-    SplineSampleTree(const SplineSamples<dimension, floating_t> &samples)
-        :adaptor(samples), tree(dimension, adaptor)
+    typedef typename SplineSamples<dimension, floating_t>::Point Point;
+
+    //the tree owns the one copy of the samples, which the adaptor and the index both refer to
+    SplineSampleTree(SplineSamples<dimension, floating_t> samples)
+        :samples(std::move(samples)), adaptor(this->samples), tree(dimension, adaptor)
+    {
+        tree.buildIndex();
+    }
+
+    //the index and the adaptor refer to the samples by address, so the tree can't be copied or moved
+    SplineSampleTree(const SplineSampleTree &) = delete;
+    SplineSampleTree &operator=(const SplineSampleTree &) = delete;
+
+    //overwrite every sample in place, resizing if necessary, then call rebuildIndex, which indexes them again without copying them
+    inline SplineSamples<dimension, floating_t> &editSamples(void) { return samples; }
+    inline void rebuildIndex(void)
     {
+        patch.clear();
         tree.buildIndex();
     }
 
+    //replace samples [begin, begin + count) without rebuilding the index
+    //the old samples stay in the index, which skips them, and the new ones go in a small patch that every search also checks. the index is only rebuilt,
+    //with the patch merged back in, once the patch is big enough to slow searches down, so a few small edits in a row only pay for their own samples
+    void replaceSamples(size_t begin, const Point *newSamples, size_t count)
+    {
+        assert(begin + count <= samples.pts.size());
+
+        //samples that were already replaced have an older replacement in the patch
+        patch.erase(std::remove_if(patch.begin(), patch.end(), [=](const PatchEntry &entry) {
+            return entry.index >= begin && entry.index < begin + count;
+        }), patch.end());
+
+        for(size_t i = 0; i < count; i++)
+        {
+            samples.pts[begin + i].replaced = true;
+            patch.push_back(PatchEntry{newSamples[i], begin + i});
+        }
+
+        if(patch.size() > maxPatchSize())
+        {
+            for(const PatchEntry &entry : patch)
+                samples.pts[entry.index] = entry.sample;
+            rebuildIndex();
+        }
+    }
+
+    inline const SplineSamples<dimension, floating_t> &getSamples(void) const { return samples; }
+    inline size_t patchSize(void) const { return patch.size(); }
+
     floating_t findClosestSample(const std::array<floating_t, dimension> &queryPoint) const
     {
+        SPLINE_LIBRARY_TIMED_SCOPE(KdTreeLookups, 1);
+
         // do a knn search
         const size_t num_results = 1;
-        size_t ret_index;
-        floating_t out_dist_sqr;
+        size_t ret_index = 0;
+        floating_t out_dist_sqr = std::numeric_limits<floating_t>::max();
         nanoflann::KNNResultSet<floating_t> resultSet(num_results);
         resultSet.init(&ret_index, &out_dist_sqr );
         tree.findNeighbors(resultSet, queryPoint.data(), nanoflann::SearchParams());
 
-        return adaptor.derived().pts.at(ret_index).t;
+        //if every sample in the index was replaced, the search finds nothing, and everything is in the patch
+        floating_t closestT = resultSet.size() > 0 ? samples.pts[ret_index].t : 0;
+        for(const PatchEntry &entry : patch)
+        {
+            floating_t distance = 0;
+            for(size_t i = 0; i < dimension; i++)
+            {
+                floating_t diff = queryPoint[i] - entry.sample.coords[i];
+                distance += diff * diff;
+            }
+            if(distance < out_dist_sqr)
+            {
+                out_dist_sqr = distance;
+                closestT = entry.sample.t;
+            }
+        }
+        return closestT;
     }
 
 private:
+    SplineSamples<dimension, floating_t> samples;
     AdaptorType adaptor;
     TreeType tree;
+
+    struct PatchEntry
+    {
+        Point sample;
+        size_t index;
+    };
+    std::vector<PatchEntry> patch;
+
+    //a search checks the whole patch, so once it's this big, rebuilding the index is worth it
+    inline size_t maxPatchSize(void) const { return std::max(size_t(256), samples.pts.size() / 64); }
 };
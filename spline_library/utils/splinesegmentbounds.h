@@ -0,0 +1,398 @@
+#pragma once
+
+#include <vector>
+#include <array>
+#include <algorithm>
+#include <cmath>
+#include <cassert>
+
+#include "../spline.h"
+#include "spline_common.h"
+#include "quinticbezier.h"
+
+namespace __SplineSegmentBoundsPrivate
+{
+    //evaluate the polynomial with the given coefficients, lowest power first, with horner's method
+    template<typename floating_t>
+    floating_t evaluatePolynomial(const floating_t *coefficients, size_t degree, floating_t x)
+    {
+        floating_t result = coefficients[degree];
+        for(size_t k = degree; k > 0; k--)
+        {
+            result = result * x + coefficients[k - 1];
+        }
+        return result;
+    }
+
+    //find the root of the polynomial between low and high, where the polynomial only goes up or only goes down, and changes sign
+    //newton's method is kept inside the bracket, and falls back to bisection whenever it would leave it
+    template<typename floating_t>
+    floating_t solveMonotonic(const floating_t *coefficients, const floating_t *derivative, size_t degree, floating_t low, floating_t high, bool increasing)
+    {
+        floating_t x = (low + high) / 2;
+        for(int i = 0; i < 64; i++)
+        {
+            floating_t value = evaluatePolynomial(coefficients, degree, x);
+            if(value == 0)
+                return x;
+
+            if((value > 0) == increasing)
+                high = x;
+            else
+                low = x;
+
+            floating_t slope = evaluatePolynomial(derivative, degree - 1, x);
+            floating_t next = slope != 0 ? x - value / slope : low;
+            if(!(next > low && next < high))
+                next = (low + high) / 2;
+
+            //once the bracket can't shrink any more, we're as close as floating_t can get
+            if(next == x || next <= low || next >= high)
+                break;
+            x = next;
+        }
+        return x;
+    }
+
+    //write the real roots of the polynomial between low and high into output, in increasing order, and return how many there are
+    //output needs room for degree roots. the roots of the derivative split the range into pieces where the polynomial only goes up or only goes down,
+    //and each of those pieces contains one root at most, so finding the derivative's roots first, recursively, makes every root easy to bracket
+    //degree can't be more than 5, which is the highest degree of any supported segment
+    template<typename floating_t>
+    size_t findRoots(const floating_t *coefficients, size_t degree, floating_t low, floating_t high, floating_t *output)
+    {
+        assert(degree <= 5);
+        if(degree == 0)
+            return 0;
+
+        if(degree == 1)
+        {
+            if(coefficients[1] == 0)
+                return 0;
+
+            floating_t root = -coefficients[0] / coefficients[1];
+            if(root < low || root > high)
+                return 0;
+
+            output[0] = root;
+            return 1;
+        }
+
+        std::array<floating_t, 5> derivative;
+        for(size_t k = 0; k < degree; k++)
+        {
+            derivative[k] = coefficients[k + 1] * floating_t(k + 1);
+        }
+
+        //the ends of the monotonic pieces: low, then every root of the derivative, then high
+        std::array<floating_t, 6> ends;
+        ends[0] = low;
+        size_t endCount = findRoots(derivative.data(), degree - 1, low, high, ends.data() + 1) + 1;
+        ends[endCount++] = high;
+
+        size_t rootCount = 0;
+        floating_t beginValue = evaluatePolynomial(coefficients, degree, low);
+        for(size_t i = 0; i + 1 < endCount; i++)
+        {
+            floating_t endValue = evaluatePolynomial(coefficients, degree, ends[i + 1]);
+
+            //a root exactly on the shared end of two pieces gets found once, as the beginning of the second piece
+            if(beginValue == 0)
+            {
+                if(rootCount == 0 || output[rootCount - 1] != ends[i])
+                    output[rootCount++] = ends[i];
+            }
+            else if(endValue != 0 && (beginValue > 0) != (endValue > 0))
+            {
+                output[rootCount++] = solveMonotonic(coefficients, derivative.data(), degree, ends[i], ends[i + 1], endValue > beginValue);
+            }
+            beginValue = endValue;
+        }
+        if(beginValue == 0 && (rootCount == 0 || output[rootCount - 1] != high))
+            output[rootCount++] = high;
+
+        //ends can repeat when the derivative has a root exactly at low or high, so a root can be found twice
+        return size_t(std::distance(output, std::unique(output, output + rootCount)));
+    }
+}
+
+//tight axis-aligned bounding boxes around each segment of a spline, for culling segments against view frustums and spatial partitions without evaluating them
+//every supported segment is a polynomial of degree 5 or less, so along each axis, its extremes are either at its ends, or where the derivative of that axis is zero
+//the derivative's roots are found directly, so each box touches the segment on every side, instead of being a conservative box around sample points or control points
+//see quinticbezier.h for the splines that aren't supported
+//
+//the boxes are arranged into a hierarchy in t order: each box above the segments covers two boxes below it, so any range of segments can be bounded,
+//or culled, with a handful of boxes. this stores a reference to the spline, so it should not outlive the spline, and has to be rebuilt if the spline changes
+template<class InterpolationType, typename floating_t=float, size_t dimension=2>
+class SplineSegmentBounds
+{
+public:
+    struct Bounds
+    {
+        InterpolationType min;
+        InterpolationType max;
+    };
+
+    SplineSegmentBounds(const Spline<InterpolationType, floating_t> &spline);
+
+    //the box around the whole spline
+    inline const Bounds &getBounds(void) const { return levels.back()[0]; }
+
+    //the box around the spline from a to b, which are clamped to the range of the spline. whole segments are looked up in the hierarchy,
+    //and the pieces of the segments that a and b are in are computed on the spot, so the box is just as tight as the per-segment boxes
+    Bounds getBounds(floating_t a, floating_t b) const;
+
+    inline const Bounds &segmentBounds(size_t segmentIndex) const { return levels[0][segmentIndex]; }
+
+    //the box around segments beginSegment to endSegment - 1
+    Bounds segmentRangeBounds(size_t beginSegment, size_t endSegment) const;
+
+    //call visit(segmentIndex) for every segment whose box passes the test, in increasing order. test(bounds) is called on boxes in the hierarchy,
+    //so it must only be false for a box when it would be false for every box inside it, like a test for overlapping a frustum or a cell of a grid
+    template<class Test, class Visit>
+    void findSegments(Test test, Visit visit) const;
+
+    //the indexes of every segment whose box overlaps the box from boxMin to boxMax, in increasing order
+    std::vector<size_t> findSegmentsInBox(const InterpolationType &boxMin, const InterpolationType &boxMax) const;
+
+    //write the t values inside the given segment where the given axis of the position reaches a local minimum or maximum into output, in increasing order,
+    //and return how many there are. the ends of the segment aren't included unless the derivative is zero there. output needs room for maxExtremaPerAxis values
+    size_t segmentExtrema(size_t segmentIndex, size_t axis, floating_t *output) const;
+
+    //the derivative of a segment is at most degree 4, so it has at most 4 roots
+    static const size_t maxExtremaPerAxis = 4;
+
+    //the number of bytes used by the hierarchy, including everything it allocated
+    size_t memoryFootprint(void) const;
+
+    inline const Spline<InterpolationType, floating_t> &getSpline(void) const { return spline; }
+
+private:
+    //the box around the given segment from beginT to endT, which must be inside the segment
+    Bounds computeBounds(size_t segmentIndex, floating_t beginT, floating_t endT) const;
+
+    //the extrema of every axis of the segment from beginT to endT, in no particular order. returns how many were written
+    size_t findExtrema(size_t segmentIndex, floating_t beginT, floating_t endT, size_t firstAxis, size_t lastAxis, floating_t *output) const;
+
+    template<class Test, class Visit>
+    void findSegments(size_t level, size_t index, Test &test, Visit &visit) const;
+
+    static Bounds pointBounds(const InterpolationType &point);
+    static void expandBounds(Bounds &bounds, const InterpolationType &point);
+    static Bounds mergeBounds(const Bounds &a, const Bounds &b);
+
+    const Spline<InterpolationType, floating_t> &spline;
+
+    //levels[0] has one box per segment, and each level above it has one box for every two boxes below it, ending with a level with a single box
+    std::vector<std::vector<Bounds>> levels;
+};
+
+template<class InterpolationType, typename floating_t, size_t dimension>
+SplineSegmentBounds<InterpolationType, floating_t, dimension>::SplineSegmentBounds(const Spline<InterpolationType, floating_t> &spline)
+    :spline(spline)
+{
+    assert(spline.segmentCount() > 0);
+
+    levels.emplace_back(spline.segmentCount());
+    for(size_t i = 0; i < spline.segmentCount(); i++)
+    {
+        levels[0][i] = computeBounds(i, spline.segmentT(i), spline.segmentT(i + 1));
+    }
+
+    while(levels.back().size() > 1)
+    {
+        const std::vector<Bounds> &below = levels.back();
+        std::vector<Bounds> above((below.size() + 1) / 2);
+        for(size_t i = 0; i < above.size(); i++)
+        {
+            above[i] = 2 * i + 1 < below.size() ? mergeBounds(below[2 * i], below[2 * i + 1]) : below[2 * i];
+        }
+        levels.push_back(std::move(above));
+    }
+}
+
+template<class InterpolationType, typename floating_t, size_t dimension>
+typename SplineSegmentBounds<InterpolationType, floating_t, dimension>::Bounds SplineSegmentBounds<InterpolationType, floating_t, dimension>::getBounds(floating_t a, floating_t b) const
+{
+    if(a > b) {
+        std::swap(a,b);
+    }
+    a = std::max(a, spline.segmentT(0));
+    b = std::min(b, spline.getMaxT());
+    if(a >= b)
+        return pointBounds(spline.getPosition(a));
+
+    size_t aIndex = spline.segmentForT(a);
+    size_t bIndex = spline.segmentForT(b);
+    if(aIndex == bIndex)
+        return computeBounds(aIndex, a, b);
+
+    Bounds result = mergeBounds(computeBounds(aIndex, a, spline.segmentT(aIndex + 1)), computeBounds(bIndex, spline.segmentT(bIndex), b));
+    if(aIndex + 1 < bIndex)
+        result = mergeBounds(result, segmentRangeBounds(aIndex + 1, bIndex));
+    return result;
+}
+
+template<class InterpolationType, typename floating_t, size_t dimension>
+typename SplineSegmentBounds<InterpolationType, floating_t, dimension>::Bounds SplineSegmentBounds<InterpolationType, floating_t, dimension>::segmentRangeBounds(size_t beginSegment, size_t endSegment) const
+{
+    assert(beginSegment < endSegment && endSegment <= levels[0].size());
+
+    //climb the hierarchy from both ends of the range: a box that's only half inside the range is split into the half that is, one level down
+    //so each level contributes at most one box at each end
+    Bounds result = levels[0][beginSegment];
+    beginSegment++;
+    for(size_t level = 0; beginSegment < endSegment; level++)
+    {
+        if(beginSegment % 2 == 1)
+            result = mergeBounds(result, levels[level][beginSegment++]);
+        if(endSegment % 2 == 1)
+            result = mergeBounds(result, levels[level][--endSegment]);
+
+        beginSegment /= 2;
+        endSegment /= 2;
+    }
+    return result;
+}
+
+template<class InterpolationType, typename floating_t, size_t dimension>
+template<class Test, class Visit>
+void SplineSegmentBounds<InterpolationType, floating_t, dimension>::findSegments(Test test, Visit visit) const
+{
+    findSegments(levels.size() - 1, 0, test, visit);
+}
+
+template<class InterpolationType, typename floating_t, size_t dimension>
+template<class Test, class Visit>
+void SplineSegmentBounds<InterpolationType, floating_t, dimension>::findSegments(size_t level, size_t index, Test &test, Visit &visit) const
+{
+    if(!test(levels[level][index]))
+        return;
+
+    if(level == 0)
+    {
+        visit(index);
+        return;
+    }
+
+    findSegments(level - 1, index * 2, test, visit);
+    if(index * 2 + 1 < levels[level - 1].size())
+        findSegments(level - 1, index * 2 + 1, test, visit);
+}
+
+template<class InterpolationType, typename floating_t, size_t dimension>
+std::vector<size_t> SplineSegmentBounds<InterpolationType, floating_t, dimension>::findSegmentsInBox(const InterpolationType &boxMin, const InterpolationType &boxMax) const
+{
+    std::vector<size_t> result;
+    findSegments([&](const Bounds &bounds) {
+        for(size_t d = 0; d < dimension; d++)
+        {
+            if(bounds.max[d] < boxMin[d] || bounds.min[d] > boxMax[d])
+                return false;
+        }
+        return true;
+    },
+    [&](size_t segmentIndex) {
+        result.push_back(segmentIndex);
+    });
+    return result;
+}
+
+template<class InterpolationType, typename floating_t, size_t dimension>
+size_t SplineSegmentBounds<InterpolationType, floating_t, dimension>::segmentExtrema(size_t segmentIndex, size_t axis, floating_t *output) const
+{
+    assert(axis < dimension);
+    size_t count = findExtrema(segmentIndex, spline.segmentT(segmentIndex), spline.segmentT(segmentIndex + 1), axis, axis + 1, output);
+    std::sort(output, output + count);
+    return count;
+}
+
+template<class InterpolationType, typename floating_t, size_t dimension>
+size_t SplineSegmentBounds<InterpolationType, floating_t, dimension>::findExtrema(size_t segmentIndex, floating_t beginT, floating_t endT,
+                                                                                  size_t firstAxis, size_t lastAxis, floating_t *output) const
+{
+    floating_t segmentBegin = spline.segmentT(segmentIndex);
+    floating_t segmentEnd = spline.segmentT(segmentIndex + 1);
+    if(segmentEnd <= segmentBegin)
+        return 0;
+
+    //work in the segment's centered local t, which goes from -0.5 to 0.5, since it keeps the high degree coefficients small in single precision
+    floating_t h = segmentEnd - segmentBegin;
+    floating_t low = (beginT - segmentBegin) / h - floating_t(0.5);
+    floating_t high = (endT - segmentBegin) / h - floating_t(0.5);
+    auto coefficients = QuinticBezier::centeredPowerBasis<floating_t>(QuinticBezier::fromSegment(spline, segmentIndex));
+
+    size_t count = 0;
+    for(size_t d = firstAxis; d < lastAxis; d++)
+    {
+        std::array<floating_t, 5> derivative;
+        for(size_t k = 0; k < 5; k++)
+        {
+            derivative[k] = floating_t(coefficients[k + 1][d]) * floating_t(k + 1);
+        }
+
+        size_t rootCount = __SplineSegmentBoundsPrivate::findRoots(derivative.data(), 4, low, high, output + count);
+        for(size_t i = 0; i < rootCount; i++)
+        {
+            //the conversion back can round slightly outside the range, which would make the caller evaluate the wrong segment
+            output[count + i] = std::min(std::max(segmentBegin + (output[count + i] + floating_t(0.5)) * h, beginT), endT);
+        }
+        count += rootCount;
+    }
+    return count;
+}
+
+template<class InterpolationType, typename floating_t, size_t dimension>
+typename SplineSegmentBounds<InterpolationType, floating_t, dimension>::Bounds SplineSegmentBounds<InterpolationType, floating_t, dimension>::computeBounds(size_t segmentIndex, floating_t beginT, floating_t endT) const
+{
+    Bounds result = pointBounds(spline.getPositionInSegment(segmentIndex, beginT));
+    expandBounds(result, spline.getPositionInSegment(segmentIndex, endT));
+
+    //the extremes are evaluated with the spline itself, rather than with the polynomial the roots came from, so the box is exactly as precise as the spline is
+    std::array<floating_t, maxExtremaPerAxis * dimension> extrema;
+    size_t extremaCount = findExtrema(segmentIndex, beginT, endT, 0, dimension, extrema.data());
+    for(size_t i = 0; i < extremaCount; i++)
+    {
+        expandBounds(result, spline.getPositionInSegment(segmentIndex, extrema[i]));
+    }
+    return result;
+}
+
+template<class InterpolationType, typename floating_t, size_t dimension>
+size_t SplineSegmentBounds<InterpolationType, floating_t, dimension>::memoryFootprint(void) const
+{
+    size_t result = sizeof(*this) + SplineCommon::vectorFootprint(levels);
+    for(const auto &level : levels)
+    {
+        result += SplineCommon::vectorFootprint(level);
+    }
+    return result;
+}
+
+template<class InterpolationType, typename floating_t, size_t dimension>
+typename SplineSegmentBounds<InterpolationType, floating_t, dimension>::Bounds SplineSegmentBounds<InterpolationType, floating_t, dimension>::pointBounds(const InterpolationType &point)
+{
+    return Bounds{point, point};
+}
+
+template<class InterpolationType, typename floating_t, size_t dimension>
+void SplineSegmentBounds<InterpolationType, floating_t, dimension>::expandBounds(Bounds &bounds, const InterpolationType &point)
+{
+    for(size_t d = 0; d < dimension; d++)
+    {
+        bounds.min[d] = std::min(bounds.min[d], point[d]);
+        bounds.max[d] = std::max(bounds.max[d], point[d]);
+    }
+}
+
+template<class InterpolationType, typename floating_t, size_t dimension>
+typename SplineSegmentBounds<InterpolationType, floating_t, dimension>::Bounds SplineSegmentBounds<InterpolationType, floating_t, dimension>::mergeBounds(const Bounds &a, const Bounds &b)
+{
+    Bounds result = a;
+    for(size_t d = 0; d < dimension; d++)
+    {
+        result.min[d] = std::min(result.min[d], b.min[d]);
+        result.max[d] = std::max(result.max[d], b.max[d]);
+    }
+    return result;
+}
@@ -0,0 +1,275 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <memory>
+#include <algorithm>
+#include <cstdint>
+#include <cassert>
+
+#include "../spline.h"
+#include "arclength.h"
+
+//one lazily computed value per spline segment, safe to read and fill from any number of threads at once
+//entries are grouped into pages, and a page is only allocated the first time one of its segments is asked for, so memory follows whatever has actually been queried
+//nothing ever waits on a lock: each slot is published with an atomic state, and a thread that finds a slot in the middle of being filled just computes the value itself
+//Compute must be deterministic, since two threads can compute the same entry at once, and only one of them gets to store it
+template<class Entry>
+class LazySegmentArray
+{
+public:
+    LazySegmentArray(size_t segmentCount)
+        :segmentCount(segmentCount), pageCount((segmentCount + pageSize - 1) / pageSize), pages(new std::atomic<Page*>[pageCount]), allocatedPages(0)
+    {
+        for(size_t i = 0; i < pageCount; i++)
+            pages[i].store(nullptr, std::memory_order_relaxed);
+    }
+    ~LazySegmentArray(void)
+    {
+        for(size_t i = 0; i < pageCount; i++)
+            delete pages[i].load(std::memory_order_relaxed);
+    }
+
+    LazySegmentArray(const LazySegmentArray &) = delete;
+    LazySegmentArray &operator=(const LazySegmentArray &) = delete;
+
+    //the entry for the given segment, calling compute(segmentIndex) to create it if no thread has stored it yet
+    template<class Compute>
+    Entry get(size_t segmentIndex, Compute compute) const
+    {
+        assert(segmentIndex < segmentCount);
+        Slot &slot = getPage(segmentIndex / pageSize).entries[segmentIndex % pageSize];
+
+        if(slot.state.load(std::memory_order_acquire) == Ready)
+            return slot.value;
+
+        Entry value = compute(segmentIndex);
+
+        //only the thread that claims the slot writes it. anyone who loses the race already has an identical value to return
+        uint8_t expected = Empty;
+        if(slot.state.compare_exchange_strong(expected, Writing, std::memory_order_acquire, std::memory_order_relaxed))
+        {
+            slot.value = value;
+            slot.state.store(Ready, std::memory_order_release);
+        }
+        return value;
+    }
+
+    //true if the given segment's entry has been stored
+    bool isCached(size_t segmentIndex) const
+    {
+        assert(segmentIndex < segmentCount);
+        const Page *page = pages[segmentIndex / pageSize].load(std::memory_order_acquire);
+        return page != nullptr && page->entries[segmentIndex % pageSize].state.load(std::memory_order_acquire) == Ready;
+    }
+
+    inline size_t size(void) const { return segmentCount; }
+
+    //bytes allocated so far. the page table is allocated up front, at one pointer per page, and everything else on demand
+    inline size_t memoryFootprint(void) const
+    {
+        return sizeof(*this) + pageCount * sizeof(std::atomic<Page*>) + allocatedPages.load(std::memory_order_relaxed) * sizeof(Page);
+    }
+
+    //segments per page. big enough for the page table to be negligible, small enough that a scattered query only allocates a little
+    static const size_t pageSize = 64;
+
+private:
+    enum SlotState : uint8_t { Empty, Writing, Ready };
+
+    struct Slot
+    {
+        std::atomic<uint8_t> state;
+        Entry value;
+    };
+    struct Page
+    {
+        Page(void)
+        {
+            for(Slot &slot : entries)
+                slot.state.store(Empty, std::memory_order_relaxed);
+        }
+        std::array<Slot, pageSize> entries;
+    };
+
+    Page &getPage(size_t pageIndex) const
+    {
+        Page *page = pages[pageIndex].load(std::memory_order_acquire);
+        if(page != nullptr)
+            return *page;
+
+        //two threads can allocate the same page at once. whoever publishes second throws theirs away and uses the winner's
+        Page *newPage = new Page;
+        if(pages[pageIndex].compare_exchange_strong(page, newPage, std::memory_order_acq_rel, std::memory_order_acquire))
+        {
+            allocatedPages.fetch_add(1, std::memory_order_relaxed);
+            return *newPage;
+        }
+        delete newPage;
+        return *page;
+    }
+
+    size_t segmentCount;
+    size_t pageCount;
+    std::unique_ptr<std::atomic<Page*>[]> pages;
+    mutable std::atomic<size_t> allocatedPages;
+};
+
+//derived per-segment data for a spline, computed the first time each segment is asked for and reused after that
+//it's the lazy counterpart to the ArcLengthTable: where the table integrates every segment up front, this only pays for the segments that get used,
+//which suits huge splines that are only ever queried in a few places. every method is const and safe to call from many threads at once
+//like the ArcLengthTable, this stores a reference to the spline, so it should not outlive the spline, and the spline shouldn't be edited while it's in use
+template<class InterpolationType, typename floating_t=float>
+class SplineSegmentCache
+{
+public:
+    SplineSegmentCache(const Spline<InterpolationType, floating_t> &spline)
+        :spline(spline), lengths(spline.segmentCount()), lengthTables(spline.segmentCount())
+    {}
+
+    //arc length of the entire segment with the given index, exactly equal to spline.segmentArcLength over the whole segment
+    inline floating_t segmentLength(size_t segmentIndex) const
+    {
+        return lengths.get(segmentIndex, [this](size_t i) { return spline.segmentArcLength(i, spline.segmentT(i), spline.segmentT(i + 1)); });
+    }
+
+    //compute the arc length from a to b. same semantics as ArcLength::arcLength, using cached lengths for every whole segment in between
+    floating_t arcLength(floating_t a, floating_t b) const;
+
+    //compute b such that arcLength(a,b) == desiredLength. same semantics as ArcLength::solveLength
+    //whole segments are skipped with their cached lengths, and the last segment's reparameterization table gives the solver a close starting bracket
+    floating_t solveLength(floating_t a, floating_t desiredLength) const;
+
+    //the t value inside the given segment whose arc length from the beginning of the segment is the given length
+    //lengths outside the segment are clamped to its beginning and end
+    floating_t solveSegmentLength(size_t segmentIndex, floating_t length) const;
+
+    //true if the given segment's data has been computed, by any of the methods above
+    inline bool isCached(size_t segmentIndex) const { return lengths.isCached(segmentIndex) || lengthTables.isCached(segmentIndex); }
+
+    //bytes allocated so far, which grows as more segments are queried
+    inline size_t memoryFootprint(void) const
+    {
+        return sizeof(*this) - sizeof(lengths) - sizeof(lengthTables) + lengths.memoryFootprint() + lengthTables.memoryFootprint();
+    }
+
+    inline const Spline<InterpolationType, floating_t> &getSpline(void) const { return spline; }
+
+    //number of evenly spaced pieces in t that each segment's reparameterization table splits it into
+    static const size_t tableSize = 8;
+
+private:
+    //lengthTable[k] is the arc length from the beginning of the segment to k / tableSize of the way through it, in t
+    typedef std::array<floating_t, tableSize + 1> LengthTable;
+
+    inline LengthTable segmentLengthTable(size_t segmentIndex) const
+    {
+        return lengthTables.get(segmentIndex, [this](size_t i) {
+            floating_t beginT = spline.segmentT(i), endT = spline.segmentT(i + 1);
+
+            LengthTable table;
+            table[0] = 0;
+            for(size_t k = 0; k < tableSize; k++)
+            {
+                floating_t pieceBegin = beginT + (endT - beginT) * k / tableSize;
+                floating_t pieceEnd = k + 1 == tableSize ? endT : beginT + (endT - beginT) * (k + 1) / tableSize;
+                table[k + 1] = table[k] + spline.segmentArcLength(i, pieceBegin, pieceEnd);
+            }
+            return table;
+        });
+    }
+
+    //the arc length from the beginning of the given segment to t, which must be inside that segment
+    floating_t lengthIntoSegment(size_t segmentIndex, floating_t t) const;
+
+    const Spline<InterpolationType, floating_t> &spline;
+
+    LazySegmentArray<floating_t> lengths;
+    LazySegmentArray<LengthTable> lengthTables;
+};
+
+template<class InterpolationType, typename floating_t>
+floating_t SplineSegmentCache<InterpolationType, floating_t>::arcLength(floating_t a, floating_t b) const
+{
+    if(a > b) {
+        std::swap(a,b);
+    }
+
+    size_t aIndex = spline.segmentForT(a);
+    size_t bIndex = spline.segmentForT(b);
+
+    //if a and b occur inside the same segment, compute the length within that segment
+    if(aIndex == bIndex) {
+        return spline.segmentArcLength(aIndex, a, b);
+    }
+
+    //a and b occur in different segments. integrate the partial first and last segments, and look up every segment in between
+    floating_t result = spline.segmentArcLength(aIndex, a, spline.segmentT(aIndex + 1));
+    for(size_t i = aIndex + 1; i < bIndex; i++)
+    {
+        result += segmentLength(i);
+    }
+    return result + spline.segmentArcLength(bIndex, spline.segmentT(bIndex), b);
+}
+
+template<class InterpolationType, typename floating_t>
+floating_t SplineSegmentCache<InterpolationType, floating_t>::lengthIntoSegment(size_t segmentIndex, floating_t t) const
+{
+    floating_t beginT = spline.segmentT(segmentIndex), endT = spline.segmentT(segmentIndex + 1);
+    if(t <= beginT)
+        return 0;
+
+    //only the part of the table's piece before t has to be integrated
+    LengthTable table = segmentLengthTable(segmentIndex);
+    size_t piece = std::min(size_t((t - beginT) / (endT - beginT) * tableSize), tableSize - 1);
+    floating_t pieceBegin = beginT + (endT - beginT) * piece / tableSize;
+    return table[piece] + spline.segmentArcLength(segmentIndex, pieceBegin, t);
+}
+
+template<class InterpolationType, typename floating_t>
+floating_t SplineSegmentCache<InterpolationType, floating_t>::solveSegmentLength(size_t segmentIndex, floating_t length) const
+{
+    floating_t beginT = spline.segmentT(segmentIndex), endT = spline.segmentT(segmentIndex + 1);
+    if(length <= 0)
+        return beginT;
+
+    LengthTable table = segmentLengthTable(segmentIndex);
+    if(length >= table[tableSize])
+        return endT;
+
+    //the first table entry past the desired length ends the piece it's in
+    size_t piece = std::distance(table.cbegin() + 1, std::upper_bound(table.cbegin() + 1, table.cend() - 1, length));
+    floating_t pieceBegin = beginT + (endT - beginT) * piece / tableSize;
+    floating_t pieceEnd = piece + 1 == tableSize ? endT : beginT + (endT - beginT) * (piece + 1) / tableSize;
+
+    return __ArcLengthSolvePrivate::solveSegmentRange(spline, segmentIndex, length - table[piece], table[piece + 1] - table[piece], pieceBegin, pieceEnd);
+}
+
+template<class InterpolationType, typename floating_t>
+floating_t SplineSegmentCache<InterpolationType, floating_t>::solveLength(floating_t a, floating_t desiredLength) const
+{
+    size_t index = spline.segmentForT(a);
+
+    //measure from the beginning of a's segment, so that every segment after it can be skipped with its cached length
+    desiredLength += lengthIntoSegment(index, a);
+    while(index < spline.segmentCount())
+    {
+        floating_t length = segmentLength(index);
+        if(length < desiredLength)
+        {
+            desiredLength -= length;
+            index++;
+        }
+        else
+        {
+            break;
+        }
+    }
+
+    //if the index is equal to the segment count, we've hit the end of the spline, so return maxT
+    if(index == spline.segmentCount())
+    {
+        return spline.getMaxT();
+    }
+    return solveSegmentLength(index, desiredLength);
+}
@@ -0,0 +1,196 @@
+#pragma once
+
+#include <new>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include "../spline.h"
+
+namespace __SplineVariantPrivate
+{
+    //the position of T in Types, or sizeof...(Types) if it isn't there
+    template<class T, class... Types>
+    struct IndexOf { static constexpr size_t value = 0; };
+
+    template<class T, class... Tail>
+    struct IndexOf<T, T, Tail...> { static constexpr size_t value = 0; };
+
+    template<class T, class Head, class... Tail>
+    struct IndexOf<T, Head, Tail...> { static constexpr size_t value = 1 + IndexOf<T, Tail...>::value; };
+
+    template<bool... values> struct BoolList {};
+
+    //true if every value is true. std::conjunction is C++17
+    template<bool... values>
+    struct AllTrue : std::is_same<BoolList<values..., true>, BoolList<true, values...>> {};
+
+    template<class... Types>
+    constexpr size_t maxSize(void)
+    {
+        size_t sizes[] = {sizeof(Types)...};
+        size_t result = 0;
+        for(size_t size : sizes)
+            result = size > result ? size : result;
+        return result;
+    }
+
+    //call visitor with storage as the given spline type. the variant keeps a table of these, one per type, and calls the one for the held type
+    template<class SplineT, class Result, class Visitor>
+    Result visitAs(const void *storage, Visitor &visitor) { return visitor(*static_cast<const SplineT*>(storage)); }
+
+    template<class SplineT, class Result, class Visitor>
+    Result visitAsMutable(void *storage, Visitor &visitor) { return visitor(*static_cast<SplineT*>(storage)); }
+}
+
+//holds any one of a fixed set of concrete spline types by value, IE a closed set of alternatives to Spline's virtual functions
+//every call dispatches on the held type once, then calls the concrete spline directly. the spline classes are final, so those calls can inline,
+//and the batch and arc length methods only dispatch once for the whole batch instead of once per t value or segment
+//a std::vector of these keeps every spline in one contiguous array, with no separate allocation per spline
+//the spline is stored in a tagged union of the alternatives, so this only needs C++14
+template<class InterpolationType, typename floating_t, class... SplineTypes>
+class SplineVariant
+{
+    static_assert(sizeof...(SplineTypes) > 0, "SplineVariant needs at least one spline type");
+    static_assert(__SplineVariantPrivate::AllTrue<std::is_base_of<Spline<InterpolationType, floating_t>, SplineTypes>::value...>::value,
+                  "every spline type in a SplineVariant must be a Spline with the same InterpolationType and floating_t");
+
+    //assignment destroys the held spline before moving the new one into the storage, so a move that throws would leave nothing there to destroy
+    static_assert(__SplineVariantPrivate::AllTrue<std::is_nothrow_move_constructible<SplineTypes>::value...>::value,
+                  "every spline type in a SplineVariant must have a noexcept move constructor");
+
+    typedef typename std::tuple_element<0, std::tuple<SplineTypes...>>::type FirstSplineType;
+
+public:
+    typedef typename Spline<InterpolationType,floating_t>::InterpolatedPT InterpolatedPT;
+    typedef typename Spline<InterpolationType,floating_t>::InterpolatedPTC InterpolatedPTC;
+    typedef typename Spline<InterpolationType,floating_t>::InterpolatedPTCW InterpolatedPTCW;
+
+    template<class SplineT, class = std::enable_if_t<(__SplineVariantPrivate::IndexOf<std::decay_t<SplineT>, SplineTypes...>::value < sizeof...(SplineTypes))>>
+    SplineVariant(SplineT &&spline)
+        :typeIndex(__SplineVariantPrivate::IndexOf<std::decay_t<SplineT>, SplineTypes...>::value)
+    {
+        new(&storage) std::decay_t<SplineT>(std::forward<SplineT>(spline));
+    }
+
+    SplineVariant(const SplineVariant &other)
+        :typeIndex(other.typeIndex)
+    {
+        other.visit([this](const auto &spline) { new(&storage) std::decay_t<decltype(spline)>(spline); });
+    }
+    SplineVariant(SplineVariant &&other) noexcept
+        :typeIndex(other.typeIndex)
+    {
+        other.visit([this](auto &spline) { new(&storage) std::decay_t<decltype(spline)>(std::move(spline)); });
+    }
+
+    //copy before destroying the held spline, so that if the copy throws, this still holds a valid spline
+    SplineVariant &operator=(const SplineVariant &other)
+    {
+        if(this != &other)
+        {
+            SplineVariant copy(other);
+            *this = std::move(copy);
+        }
+        return *this;
+    }
+    SplineVariant &operator=(SplineVariant &&other) noexcept
+    {
+        if(this != &other)
+        {
+            destroy();
+            typeIndex = other.typeIndex;
+            other.visit([this](auto &spline) { new(&storage) std::decay_t<decltype(spline)>(std::move(spline)); });
+        }
+        return *this;
+    }
+
+    ~SplineVariant(void) { destroy(); }
+
+    //call visitor(spline) with the concrete spline this holds, and return whatever the visitor returns
+    //the visitor should return the same type for every spline type. each result is converted to the type it returns for the first one
+    template<class Visitor>
+    decltype(auto) visit(Visitor &&visitor) const
+    {
+        typedef decltype(visitor(std::declval<const FirstSplineType&>())) Result;
+        typedef Result (*Thunk)(const void*, Visitor&);
+        static constexpr Thunk thunks[] = {&__SplineVariantPrivate::visitAs<SplineTypes, Result, Visitor>...};
+
+        return thunks[typeIndex](&storage, visitor);
+    }
+    template<class Visitor>
+    decltype(auto) visit(Visitor &&visitor)
+    {
+        typedef decltype(visitor(std::declval<FirstSplineType&>())) Result;
+        typedef Result (*Thunk)(void*, Visitor&);
+        static constexpr Thunk thunks[] = {&__SplineVariantPrivate::visitAsMutable<SplineTypes, Result, Visitor>...};
+
+        return thunks[typeIndex](&storage, visitor);
+    }
+
+    //the position of the held spline's type in SplineTypes, and a pointer to it if it's the given type, otherwise null
+    inline size_t index(void) const { return typeIndex; }
+    template<class SplineT>
+    inline const SplineT *getIf(void) const
+    {
+        static_assert(__SplineVariantPrivate::IndexOf<SplineT, SplineTypes...>::value < sizeof...(SplineTypes), "getIf needs one of the variant's spline types");
+        return typeIndex == __SplineVariantPrivate::IndexOf<SplineT, SplineTypes...>::value ? reinterpret_cast<const SplineT*>(&storage) : nullptr;
+    }
+
+    //the held spline through the usual virtual interface, for the utilities that take a Spline reference
+    inline const Spline<InterpolationType, floating_t> &asSpline(void) const
+    {
+        return visit([](const auto &spline) -> const Spline<InterpolationType, floating_t>& { return spline; });
+    }
+
+    //the same as the Spline methods with the same names
+    inline InterpolationType getPosition(floating_t t) const { return visit([t](const auto &spline) { return spline.getPosition(t); }); }
+    inline InterpolatedPT getTangent(floating_t t) const { return visit([t](const auto &spline) { return spline.getTangent(t); }); }
+    inline InterpolatedPTC getCurvature(floating_t t) const { return visit([t](const auto &spline) { return spline.getCurvature(t); }); }
+    inline InterpolatedPTCW getWiggle(floating_t t) const { return visit([t](const auto &spline) { return spline.getWiggle(t); }); }
+
+    inline void getPositions(const floating_t *tValues, size_t count, InterpolationType *output) const
+    {
+        visit([=](const auto &spline) { spline.getPositions(tValues, count, output); });
+    }
+    inline void getTangents(const floating_t *tValues, size_t count, InterpolatedPT *output) const
+    {
+        visit([=](const auto &spline) { spline.getTangents(tValues, count, output); });
+    }
+    inline void getCurvatures(const floating_t *tValues, size_t count, InterpolatedPTC *output) const
+    {
+        visit([=](const auto &spline) { spline.getCurvatures(tValues, count, output); });
+    }
+    inline void getWiggles(const floating_t *tValues, size_t count, InterpolatedPTCW *output) const
+    {
+        visit([=](const auto &spline) { spline.getWiggles(tValues, count, output); });
+    }
+
+    inline floating_t arcLength(floating_t a, floating_t b) const { return visit([=](const auto &spline) { return spline.arcLength(a, b); }); }
+    inline floating_t totalLength(void) const { return visit([](const auto &spline) { return spline.totalLength(); }); }
+
+    inline floating_t getMaxT(void) const { return visit([](const auto &spline) { return spline.getMaxT(); }); }
+    inline bool isLooping(void) const { return visit([](const auto &spline) { return spline.isLooping(); }); }
+
+    inline size_t segmentCount(void) const { return visit([](const auto &spline) { return spline.segmentCount(); }); }
+    inline size_t segmentForT(floating_t t) const { return visit([t](const auto &spline) { return spline.segmentForT(t); }); }
+    inline floating_t segmentT(size_t segmentIndex) const { return visit([segmentIndex](const auto &spline) { return spline.segmentT(segmentIndex); }); }
+
+    //includes the unused space the variant reserves for its largest alternative
+    inline size_t memoryFootprint(void) const
+    {
+        return visit([](const auto &spline) { return spline.memoryFootprint() - sizeof(spline); }) + sizeof(*this);
+    }
+
+private:
+    inline void destroy(void)
+    {
+        visit([](auto &spline) {
+            typedef std::decay_t<decltype(spline)> SplineT;
+            spline.~SplineT();
+        });
+    }
+
+    alignas(SplineTypes...) unsigned char storage[__SplineVariantPrivate::maxSize<SplineTypes...>()];
+    size_t typeIndex;
+};
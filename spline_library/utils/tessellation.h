@@ -0,0 +1,137 @@
+#pragma once
+
+#include <array>
+#include <cmath>
+#include <cassert>
+
+#include "../spline.h"
+#include "quinticbezier.h"
+
+namespace Tessellation
+{
+    //flatten the spline into a polyline, and write its points into positions, which has room for capacity points
+    //if tValues or tangents aren't null, the t value and the tangent of each point are written to them too. they need room for capacity entries as well
+    //every point is computed with the spline's *InSegment methods, so positions and tangents are exactly what getPosition and getTangent return at each t value
+    //
+    //maxChordError is the furthest the spline may get from the polyline, and maxAngle is the largest angle, in radians, between the spline's tangent and
+    //the polyline line segment that approximates it. either tolerance can be 0 to ignore it, but not both
+    //
+    //returns the number of points in the whole polyline. if that's more than capacity, only the first capacity points were written,
+    //so a caller that doesn't know how big the polyline will be can call this once with a capacity of 0 to find out
+    template<class InterpolationType, typename floating_t>
+    size_t tessellate(const Spline<InterpolationType, floating_t> &spline, floating_t maxChordError, floating_t maxAngle,
+                      InterpolationType *positions, size_t capacity, floating_t *tValues = nullptr, InterpolationType *tangents = nullptr);
+
+    //the number of points tessellate will produce for the given tolerances
+    template<class InterpolationType, typename floating_t>
+    size_t countPoints(const Spline<InterpolationType, floating_t> &spline, floating_t maxChordError, floating_t maxAngle)
+    {
+        return tessellate<InterpolationType, floating_t>(spline, maxChordError, maxAngle, nullptr, 0);
+    }
+}
+
+namespace __TessellationPrivate
+{
+    //no part of a segment will be split more than this many times, even if it still isn't within the tolerances, so a segment makes at most 2^maxDepth line segments
+    //the tolerances can only fail to be met at a cusp, where the tangent turns around instantly, or if the tolerance is too small for floating point precision
+    const int maxDepth = 16;
+
+    //true if the whole curve is within both tolerances of the line segment between its endpoints
+    //the curve is inside the convex hull of its control points, and its tangent is inside the convex hull of the differences between adjacent control points
+    //so if every control point is close enough to the line segment, and every difference points close enough to its direction, the whole curve is too
+    template<class InterpolationType, typename floating_t>
+    bool withinTolerance(const QuinticBezier::ControlPoints<InterpolationType> &controlPoints, floating_t maxChordError, floating_t minCosAngle)
+    {
+        if(maxChordError > 0 && QuinticBezier::flatnessSquared<floating_t>(controlPoints) > maxChordError * maxChordError)
+            return false;
+
+        if(minCosAngle < 1)
+        {
+            InterpolationType chord = controlPoints[5] - controlPoints[0];
+            floating_t chordLength = chord.length();
+            for(size_t i = 0; i < 5; i++)
+            {
+                InterpolationType difference = controlPoints[i + 1] - controlPoints[i];
+                if(InterpolationType::dotProduct(difference, chord) < minCosAngle * difference.length() * chordLength)
+                    return false;
+            }
+        }
+        return true;
+    }
+}
+
+template<class InterpolationType, typename floating_t>
+size_t Tessellation::tessellate(const Spline<InterpolationType, floating_t> &spline, floating_t maxChordError, floating_t maxAngle,
+                                InterpolationType *positions, size_t capacity, floating_t *tValues, InterpolationType *tangents)
+{
+    assert(maxChordError > 0 || maxAngle > 0);
+    floating_t minCosAngle = maxAngle > 0 ? floating_t(std::cos(maxAngle)) : floating_t(1);
+
+    size_t count = 0;
+    auto addPoint = [&](size_t segmentIndex, floating_t t) {
+        if(count < capacity)
+        {
+            if(tangents)
+            {
+                auto result = spline.getTangentInSegment(segmentIndex, t);
+                positions[count] = result.position;
+                tangents[count] = result.tangent;
+            }
+            else
+            {
+                positions[count] = spline.getPositionInSegment(segmentIndex, t);
+            }
+
+            if(tValues)
+                tValues[count] = t;
+        }
+        count++;
+    };
+
+    //each entry is a piece of the current segment that hasn't been checked yet, and the range of the segment it covers
+    struct Piece
+    {
+        QuinticBezier::ControlPoints<InterpolationType> controlPoints;
+        floating_t beginU;
+        floating_t endU;
+        int depth;
+    };
+
+    //the left half of a split is always visited before the right half, so each depth has at most one right half waiting on the stack
+    std::array<Piece, __TessellationPrivate::maxDepth + 1> stack;
+
+    for(size_t i = 0; i < spline.segmentCount(); i++)
+    {
+        floating_t beginT = spline.segmentT(i);
+        floating_t endT = spline.segmentT(i + 1);
+        if(endT <= beginT)
+            continue;
+
+        //each segment begins where the previous one ended, so only the very first segment adds its beginning
+        if(count == 0)
+            addPoint(i, beginT);
+
+        size_t stackSize = 0;
+        stack[stackSize++] = Piece{QuinticBezier::fromSegment(spline, i), floating_t(0), floating_t(1), 0};
+        while(stackSize > 0)
+        {
+            Piece piece = stack[--stackSize];
+            if(piece.depth < __TessellationPrivate::maxDepth && !__TessellationPrivate::withinTolerance(piece.controlPoints, maxChordError, minCosAngle))
+            {
+                floating_t middleU = (piece.beginU + piece.endU) / 2;
+                Piece left{{}, piece.beginU, middleU, piece.depth + 1};
+                Piece right{{}, middleU, piece.endU, piece.depth + 1};
+                QuinticBezier::split(piece.controlPoints, left.controlPoints, right.controlPoints);
+
+                stack[stackSize++] = right;
+                stack[stackSize++] = left;
+            }
+            else
+            {
+                //use the segment's own end t for the last point, so that rounding can't leave a tiny gap before the next segment
+                addPoint(i, piece.endU == 1 ? endT : beginT + piece.endU * (endT - beginT));
+            }
+        }
+    }
+    return count;
+}
@@ -2,13 +2,17 @@
 
 #include <array>
 #include <cmath>
+#include <algorithm>
+#include <type_traits>
+
+#include "vector_simd.h"
 
 template<size_t dimension, typename floating_t=float>
 class Vector
 {
 public:
     Vector(void) :data() {}
-    Vector(std::array<floating_t, dimension> data) :data(data) {}
+    Vector(std::array<floating_t, dimension> data) :data() { std::copy(data.begin(), data.end(), this->data.begin()); }
 
     inline floating_t& operator[](size_t index) { return data[index]; }
     inline floating_t operator[](size_t index) const { return data[index]; }
@@ -37,7 +41,10 @@ public:
     inline static floating_t dotProduct(const Vector<dimension, floating_t>& left, const Vector<dimension, floating_t>& right);
 
 private:
-    std::array<floating_t, dimension> data;
+    typedef __VectorPrivate::VectorOps<dimension, floating_t> Ops;
+
+    //the storage may be padded past "dimension" to fit a SIMD register - see vector_simd.h
+    alignas(Ops::alignment) std::array<floating_t, Ops::storageSize> data;
 };
 
 typedef Vector<2> Vector2;
@@ -46,36 +53,28 @@ typedef Vector<3> Vector3;
 template<size_t dimension, typename floating_t>
 inline Vector<dimension, floating_t> &Vector<dimension, floating_t>::operator+=(const Vector<dimension, floating_t> &other)
 {
-    for(size_t i = 0; i < dimension; i++) {
-        data[i] += other.data[i];
-    }
+    Ops::add(data.data(), data.data(), other.data.data());
     return *this;
 }
 
 template<size_t dimension, typename floating_t>
 inline Vector<dimension, floating_t> &Vector<dimension, floating_t>::operator-=(const Vector<dimension, floating_t> &v)
 {
-    for(size_t i = 0; i < dimension; i++) {
-        data[i] -= v.data[i];
-    }
+    Ops::subtract(data.data(), data.data(), v.data.data());
     return *this;
 }
 
 template<size_t dimension, typename floating_t>
 inline Vector<dimension, floating_t> &Vector<dimension, floating_t>::operator*=(floating_t s)
 {
-    for(size_t i = 0; i < dimension; i++) {
-        data[i] *= s;
-    }
+    Ops::multiply(data.data(), data.data(), s);
     return *this;
 }
 
 template<size_t dimension, typename floating_t>
 inline Vector<dimension, floating_t> &Vector<dimension, floating_t>::operator/=(floating_t s)
 {
-    for(size_t i = 0; i < dimension; i++) {
-        data[i] /= s;
-    }
+    Ops::divide(data.data(), data.data(), s);
     return *this;
 }
 
@@ -83,9 +82,7 @@ template<size_t dimension, typename floating_t>
 inline Vector<dimension, floating_t> operator+(const Vector<dimension, floating_t> &left, const Vector<dimension, floating_t> &right)
 {
     Vector<dimension, floating_t> result;
-    for(size_t i = 0; i < dimension; i++) {
-        result.data[i] = left.data[i] + right.data[i];
-    }
+    Vector<dimension, floating_t>::Ops::add(result.data.data(), left.data.data(), right.data.data());
     return result;
 }
 
@@ -93,9 +90,7 @@ template<size_t dimension, typename floating_t>
 inline Vector<dimension, floating_t> operator-(const Vector<dimension, floating_t> &left, const Vector<dimension, floating_t> &right)
 {
     Vector<dimension, floating_t> result;
-    for(size_t i = 0; i < dimension; i++) {
-        result.data[i] = left.data[i] - right.data[i];
-    }
+    Vector<dimension, floating_t>::Ops::subtract(result.data.data(), left.data.data(), right.data.data());
     return result;
 }
 
@@ -103,9 +98,7 @@ template<size_t dimension, typename floating_t>
 inline Vector<dimension, floating_t> operator*(floating_t s, const Vector<dimension, floating_t> &v)
 {
     Vector<dimension, floating_t> result;
-    for(size_t i = 0; i < dimension; i++) {
-        result.data[i] = s * v.data[i];
-    }
+    Vector<dimension, floating_t>::Ops::multiply(result.data.data(), v.data.data(), s);
     return result;
 }
 
@@ -113,9 +106,7 @@ template<size_t dimension, typename floating_t>
 inline Vector<dimension, floating_t> operator*(const Vector<dimension, floating_t> &v, floating_t s)
 {
     Vector<dimension, floating_t> result;
-    for(size_t i = 0; i < dimension; i++) {
-        result.data[i] = v.data[i] * s;
-    }
+    Vector<dimension, floating_t>::Ops::multiply(result.data.data(), v.data.data(), s);
     return result;
 }
 
@@ -123,9 +114,7 @@ template<size_t dimension, typename floating_t>
 inline Vector<dimension, floating_t> operator-(const Vector<dimension, floating_t> &v)
 {
     Vector<dimension, floating_t> result;
-    for(size_t i = 0; i < dimension; i++) {
-        result.data[i] = -v.data[i];
-    }
+    Vector<dimension, floating_t>::Ops::negate(result.data.data(), v.data.data());
     return result;
 }
 
@@ -133,9 +122,7 @@ template<size_t dimension, typename floating_t>
 inline Vector<dimension, floating_t> operator/(const Vector<dimension, floating_t> &v, floating_t s)
 {
     Vector<dimension, floating_t> result;
-    for(size_t i = 0; i < dimension; i++) {
-        result.data[i] = v.data[i] / s;
-    }
+    Vector<dimension, floating_t>::Ops::divide(result.data.data(), v.data.data(), s);
     return result;
 }
 
@@ -175,11 +162,7 @@ inline Vector<dimension, floating_t> Vector<dimension, floating_t>::normalized()
 template<size_t dimension, typename floating_t>
 inline floating_t Vector<dimension, floating_t>::dotProduct(const Vector<dimension, floating_t>& v1, const Vector<dimension, floating_t>& v2)
 {
-    floating_t sum(0);
-    for(size_t i = 0; i < dimension; i++) {
-        sum += v1.data[i] * v2.data[i];
-    }
-    return sum;
+    return Ops::dotProduct(v1.data.data(), v2.data.data());
 }
 
 template<size_t dimension, typename floating_t>
@@ -193,3 +176,26 @@ inline floating_t Vector<dimension, floating_t>::lengthSquared() const
 {
     return Vector<dimension, floating_t>::dotProduct(*this, *this);
 }
+
+//a spline can store its points in single precision while it computes t values, knots and arc lengths in double precision
+//so multiplying or dividing by a scalar of any other arithmetic type first converts it to the vector's own precision
+template<size_t dimension, typename floating_t, typename scalar_t,
+         typename = typename std::enable_if<std::is_arithmetic<scalar_t>::value && !std::is_same<scalar_t, floating_t>::value>::type>
+inline Vector<dimension, floating_t> operator*(scalar_t s, const Vector<dimension, floating_t> &v)
+{
+    return floating_t(s) * v;
+}
+
+template<size_t dimension, typename floating_t, typename scalar_t,
+         typename = typename std::enable_if<std::is_arithmetic<scalar_t>::value && !std::is_same<scalar_t, floating_t>::value>::type>
+inline Vector<dimension, floating_t> operator*(const Vector<dimension, floating_t> &v, scalar_t s)
+{
+    return v * floating_t(s);
+}
+
+template<size_t dimension, typename floating_t, typename scalar_t,
+         typename = typename std::enable_if<std::is_arithmetic<scalar_t>::value && !std::is_same<scalar_t, floating_t>::value>::type>
+inline Vector<dimension, floating_t> operator/(const Vector<dimension, floating_t> &v, scalar_t s)
+{
+    return v / floating_t(s);
+}
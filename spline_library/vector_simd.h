@@ -0,0 +1,256 @@
+#pragma once
+
+#include <cstddef>
+
+//pick a SIMD backend for the common vector shapes. define SPLINE_LIBRARY_NO_SIMD to force the scalar implementation everywhere
+#if !defined(SPLINE_LIBRARY_NO_SIMD)
+    #if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+        #define SPLINE_LIBRARY_SIMD_SSE
+        #include <emmintrin.h>
+        #if defined(__AVX__)
+            #define SPLINE_LIBRARY_SIMD_AVX
+            #include <immintrin.h>
+        #endif
+    #endif
+#endif
+
+namespace __VectorPrivate
+{
+    //element-wise operations on the raw storage of a Vector
+    //the SIMD specializations below replace these for specific shapes, and Vector itself never needs to know which one it got
+    template<size_t dimension, typename floating_t>
+    struct VectorOps
+    {
+        //number of elements Vector actually stores. a SIMD specialization may pad this out to fill a register
+        //padding elements are never read back by anything that cares about their value
+        static constexpr size_t storageSize = dimension;
+        static constexpr size_t alignment = alignof(floating_t);
+        static constexpr const char *name = "scalar";
+
+        static inline void add(floating_t *result, const floating_t *left, const floating_t *right)
+        {
+            for(size_t i = 0; i < dimension; i++) {
+                result[i] = left[i] + right[i];
+            }
+        }
+        static inline void subtract(floating_t *result, const floating_t *left, const floating_t *right)
+        {
+            for(size_t i = 0; i < dimension; i++) {
+                result[i] = left[i] - right[i];
+            }
+        }
+        static inline void multiply(floating_t *result, const floating_t *v, floating_t s)
+        {
+            for(size_t i = 0; i < dimension; i++) {
+                result[i] = v[i] * s;
+            }
+        }
+        static inline void divide(floating_t *result, const floating_t *v, floating_t s)
+        {
+            for(size_t i = 0; i < dimension; i++) {
+                result[i] = v[i] / s;
+            }
+        }
+        static inline void negate(floating_t *result, const floating_t *v)
+        {
+            for(size_t i = 0; i < dimension; i++) {
+                result[i] = -v[i];
+            }
+        }
+        static inline floating_t dotProduct(const floating_t *left, const floating_t *right)
+        {
+            floating_t sum(0);
+            for(size_t i = 0; i < dimension; i++) {
+                sum += left[i] * right[i];
+            }
+            return sum;
+        }
+    };
+
+    //every SIMD dot product below sums its lanes in order, from first to last, exactly like the scalar loop above
+    //that way switching backends never changes a result, it only changes how fast we get it
+    //loads and stores are all unaligned: Vectors live in std::vector, which won't honor extended alignment before c++17
+
+#if defined(SPLINE_LIBRARY_SIMD_SSE)
+    struct SseFloat4Ops
+    {
+        static constexpr size_t storageSize = 4;
+        static constexpr size_t alignment = 16;
+        static constexpr const char *name = "sse";
+
+        static inline void add(float *result, const float *left, const float *right)
+        {
+            _mm_storeu_ps(result, _mm_add_ps(_mm_loadu_ps(left), _mm_loadu_ps(right)));
+        }
+        static inline void subtract(float *result, const float *left, const float *right)
+        {
+            _mm_storeu_ps(result, _mm_sub_ps(_mm_loadu_ps(left), _mm_loadu_ps(right)));
+        }
+        static inline void multiply(float *result, const float *v, float s)
+        {
+            _mm_storeu_ps(result, _mm_mul_ps(_mm_loadu_ps(v), _mm_set1_ps(s)));
+        }
+        static inline void divide(float *result, const float *v, float s)
+        {
+            _mm_storeu_ps(result, _mm_div_ps(_mm_loadu_ps(v), _mm_set1_ps(s)));
+        }
+        static inline void negate(float *result, const float *v)
+        {
+            _mm_storeu_ps(result, _mm_xor_ps(_mm_loadu_ps(v), _mm_set1_ps(-0.0f)));
+        }
+        static inline float dotProduct(const float *left, const float *right)
+        {
+            __m128 products = _mm_mul_ps(_mm_loadu_ps(left), _mm_loadu_ps(right));
+            __m128 sum = _mm_add_ss(products, _mm_shuffle_ps(products, products, _MM_SHUFFLE(1,1,1,1)));
+            sum = _mm_add_ss(sum, _mm_movehl_ps(products, products));
+            sum = _mm_add_ss(sum, _mm_shuffle_ps(products, products, _MM_SHUFFLE(3,3,3,3)));
+            return _mm_cvtss_f32(sum);
+        }
+    };
+
+    template<>
+    struct VectorOps<4, float> : public SseFloat4Ops {};
+
+    //3D vectors are padded out to a full register. the padding element can hold garbage (IE 0/0 after a divide), so the dot product leaves it out
+    template<>
+    struct VectorOps<3, float> : public SseFloat4Ops
+    {
+        static inline float dotProduct(const float *left, const float *right)
+        {
+            __m128 products = _mm_mul_ps(_mm_loadu_ps(left), _mm_loadu_ps(right));
+            __m128 sum = _mm_add_ss(products, _mm_shuffle_ps(products, products, _MM_SHUFFLE(1,1,1,1)));
+            sum = _mm_add_ss(sum, _mm_movehl_ps(products, products));
+            return _mm_cvtss_f32(sum);
+        }
+    };
+
+    //2D vectors stay 8 bytes, so that they don't take up twice the memory. they're loaded into the low half of a register
+    template<>
+    struct VectorOps<2, float>
+    {
+        static constexpr size_t storageSize = 2;
+        static constexpr size_t alignment = 8;
+        static constexpr const char *name = "sse";
+
+        static inline __m128 load(const float *v) { return _mm_loadl_pi(_mm_setzero_ps(), reinterpret_cast<const __m64*>(v)); }
+        static inline void store(float *result, __m128 v) { _mm_storel_pi(reinterpret_cast<__m64*>(result), v); }
+
+        static inline void add(float *result, const float *left, const float *right)
+        {
+            store(result, _mm_add_ps(load(left), load(right)));
+        }
+        static inline void subtract(float *result, const float *left, const float *right)
+        {
+            store(result, _mm_sub_ps(load(left), load(right)));
+        }
+        static inline void multiply(float *result, const float *v, float s)
+        {
+            store(result, _mm_mul_ps(load(v), _mm_set1_ps(s)));
+        }
+        static inline void divide(float *result, const float *v, float s)
+        {
+            store(result, _mm_div_ps(load(v), _mm_set1_ps(s)));
+        }
+        static inline void negate(float *result, const float *v)
+        {
+            store(result, _mm_xor_ps(load(v), _mm_set1_ps(-0.0f)));
+        }
+        static inline float dotProduct(const float *left, const float *right)
+        {
+            __m128 products = _mm_mul_ps(load(left), load(right));
+            __m128 sum = _mm_add_ss(products, _mm_shuffle_ps(products, products, _MM_SHUFFLE(1,1,1,1)));
+            return _mm_cvtss_f32(sum);
+        }
+    };
+
+#if defined(SPLINE_LIBRARY_SIMD_AVX)
+    template<>
+    struct VectorOps<4, double>
+    {
+        static constexpr size_t storageSize = 4;
+        static constexpr size_t alignment = 16;
+        static constexpr const char *name = "avx";
+
+        static inline void add(double *result, const double *left, const double *right)
+        {
+            _mm256_storeu_pd(result, _mm256_add_pd(_mm256_loadu_pd(left), _mm256_loadu_pd(right)));
+        }
+        static inline void subtract(double *result, const double *left, const double *right)
+        {
+            _mm256_storeu_pd(result, _mm256_sub_pd(_mm256_loadu_pd(left), _mm256_loadu_pd(right)));
+        }
+        static inline void multiply(double *result, const double *v, double s)
+        {
+            _mm256_storeu_pd(result, _mm256_mul_pd(_mm256_loadu_pd(v), _mm256_set1_pd(s)));
+        }
+        static inline void divide(double *result, const double *v, double s)
+        {
+            _mm256_storeu_pd(result, _mm256_div_pd(_mm256_loadu_pd(v), _mm256_set1_pd(s)));
+        }
+        static inline void negate(double *result, const double *v)
+        {
+            _mm256_storeu_pd(result, _mm256_xor_pd(_mm256_loadu_pd(v), _mm256_set1_pd(-0.0)));
+        }
+        static inline double dotProduct(const double *left, const double *right)
+        {
+            __m256d products = _mm256_mul_pd(_mm256_loadu_pd(left), _mm256_loadu_pd(right));
+            __m128d low = _mm256_castpd256_pd128(products);
+            __m128d high = _mm256_extractf128_pd(products, 1);
+
+            __m128d sum = _mm_add_sd(low, _mm_unpackhi_pd(low, low));
+            sum = _mm_add_sd(sum, high);
+            sum = _mm_add_sd(sum, _mm_unpackhi_pd(high, high));
+            return _mm_cvtsd_f64(sum);
+        }
+    };
+#else
+    //without AVX, a 4D double vector is two SSE2 registers
+    template<>
+    struct VectorOps<4, double>
+    {
+        static constexpr size_t storageSize = 4;
+        static constexpr size_t alignment = 16;
+        static constexpr const char *name = "sse";
+
+        static inline void add(double *result, const double *left, const double *right)
+        {
+            _mm_storeu_pd(result,     _mm_add_pd(_mm_loadu_pd(left),     _mm_loadu_pd(right)));
+            _mm_storeu_pd(result + 2, _mm_add_pd(_mm_loadu_pd(left + 2), _mm_loadu_pd(right + 2)));
+        }
+        static inline void subtract(double *result, const double *left, const double *right)
+        {
+            _mm_storeu_pd(result,     _mm_sub_pd(_mm_loadu_pd(left),     _mm_loadu_pd(right)));
+            _mm_storeu_pd(result + 2, _mm_sub_pd(_mm_loadu_pd(left + 2), _mm_loadu_pd(right + 2)));
+        }
+        static inline void multiply(double *result, const double *v, double s)
+        {
+            __m128d scalar = _mm_set1_pd(s);
+            _mm_storeu_pd(result,     _mm_mul_pd(_mm_loadu_pd(v),     scalar));
+            _mm_storeu_pd(result + 2, _mm_mul_pd(_mm_loadu_pd(v + 2), scalar));
+        }
+        static inline void divide(double *result, const double *v, double s)
+        {
+            __m128d scalar = _mm_set1_pd(s);
+            _mm_storeu_pd(result,     _mm_div_pd(_mm_loadu_pd(v),     scalar));
+            _mm_storeu_pd(result + 2, _mm_div_pd(_mm_loadu_pd(v + 2), scalar));
+        }
+        static inline void negate(double *result, const double *v)
+        {
+            __m128d signBit = _mm_set1_pd(-0.0);
+            _mm_storeu_pd(result,     _mm_xor_pd(_mm_loadu_pd(v),     signBit));
+            _mm_storeu_pd(result + 2, _mm_xor_pd(_mm_loadu_pd(v + 2), signBit));
+        }
+        static inline double dotProduct(const double *left, const double *right)
+        {
+            __m128d low = _mm_mul_pd(_mm_loadu_pd(left), _mm_loadu_pd(right));
+            __m128d high = _mm_mul_pd(_mm_loadu_pd(left + 2), _mm_loadu_pd(right + 2));
+
+            __m128d sum = _mm_add_sd(low, _mm_unpackhi_pd(low, low));
+            sum = _mm_add_sd(sum, high);
+            sum = _mm_add_sd(sum, _mm_unpackhi_pd(high, high));
+            return _mm_cvtsd_f64(sum);
+        }
+    };
+#endif
+#endif //SPLINE_LIBRARY_SIMD_SSE
+}
@@ -50,34 +50,40 @@ public:
     static SplinePtr createUniformCR(std::vector<T> data) {
         return std::make_shared<UniformCRSpline<T, floating_t>>(addPadding(data,1));
     }
+    template<bool uniformKnots = false>
     static SplinePtr createCatmullRom(std::vector<T> data, floating_t alpha) {
         auto padded = addPadding(data,1);
-        return std::make_shared<CubicHermiteSpline<T, floating_t>>(padded, alpha);
+        return std::make_shared<CubicHermiteSpline<T, floating_t, uniformKnots>>(padded, alpha);
     }
+    template<bool uniformKnots = false>
     static SplinePtr createCubicHermite(std::vector<T> data, floating_t alpha) {
         auto tangents = makeTangents(data);
-        return std::make_shared<CubicHermiteSpline<T, floating_t>>(data, tangents, alpha);
+        return std::make_shared<CubicHermiteSpline<T, floating_t, uniformKnots>>(data, tangents, alpha);
     }
+    template<bool uniformKnots = false>
     static SplinePtr createQuinticCatmullRom(std::vector<T> data, floating_t alpha) {
         auto padded = addPadding(data,2);
-        return std::make_shared<QuinticHermiteSpline<T, floating_t>>(padded, alpha);
+        return std::make_shared<QuinticHermiteSpline<T, floating_t, uniformKnots>>(padded, alpha);
     }
+    template<bool uniformKnots = false>
     static SplinePtr createQuinticHermite(std::vector<T> data, floating_t alpha) {
         auto tangents = makeTangents(data);
         auto curves = makeTangents(tangents);
-        return std::make_shared<QuinticHermiteSpline<T, floating_t>>(data, tangents, curves, alpha);
+        return std::make_shared<QuinticHermiteSpline<T, floating_t, uniformKnots>>(data, tangents, curves, alpha);
     }
+    template<bool uniformKnots = false>
     static SplinePtr createNatural(std::vector<T> data, bool includeEndpoints, floating_t alpha) {
         if(!includeEndpoints) {
             data = addPadding(data, 1);
         }
-        return std::make_shared<NaturalSpline<T, floating_t>>(data, includeEndpoints, alpha);
+        return std::make_shared<NaturalSpline<T, floating_t, uniformKnots>>(data, includeEndpoints, alpha);
     }
+    template<bool uniformKnots = false>
     static SplinePtr createNotAKnot(std::vector<T> data, bool includeEndpoints, floating_t alpha) {
         if(!includeEndpoints) {
             data = addPadding(data, 1);
         }
-        return std::make_shared<NaturalSpline<T, floating_t>>(data, includeEndpoints, alpha, NaturalSpline<Vector<2,floating_t>, floating_t>::NotAKnot);
+        return std::make_shared<NaturalSpline<T, floating_t, uniformKnots>>(data, includeEndpoints, alpha, NaturalSpline<T, floating_t, uniformKnots>::NotAKnot);
     }
     static SplinePtr createUniformBSpline(std::vector<T> data) {
         return std::make_shared<UniformCubicBSpline<T, floating_t>>(addPadding(data,1));
@@ -86,6 +92,11 @@ public:
         auto padded = addPadding(data, (degree - 1)/2);
         return std::make_shared<GenericBSpline<T, floating_t>>(padded, degree);
     }
+    template<size_t degree>
+    static SplinePtr createFixedDegreeGenericBSpline(std::vector<T> data) {
+        auto padded = addPadding(data, (degree - 1)/2);
+        return std::make_shared<GenericBSpline<T, floating_t, degree>>(padded);
+    }
 
 
 
@@ -93,23 +104,28 @@ public:
     static LoopingSplinePtr createLoopingUniformCR(std::vector<T> data) {
         return std::make_shared<LoopingUniformCRSpline<T, floating_t>>(data);
     }
+    template<bool uniformKnots = false>
     static LoopingSplinePtr createLoopingCatmullRom(std::vector<T> data, floating_t alpha) {
-        return std::make_shared<LoopingCubicHermiteSpline<T, floating_t>>(data, alpha);
+        return std::make_shared<LoopingCubicHermiteSpline<T, floating_t, uniformKnots>>(data, alpha);
     }
+    template<bool uniformKnots = false>
     static LoopingSplinePtr createLoopingCubicHermite(std::vector<T> data, floating_t alpha) {
         auto tangents = makeTangents(data);
-        return std::make_shared<LoopingCubicHermiteSpline<T, floating_t>>(data, tangents, alpha);
+        return std::make_shared<LoopingCubicHermiteSpline<T, floating_t, uniformKnots>>(data, tangents, alpha);
     }
+    template<bool uniformKnots = false>
     static LoopingSplinePtr createLoopingQuinticCatmullRom(std::vector<T> data, floating_t alpha) {
-        return std::make_shared<LoopingQuinticHermiteSpline<T, floating_t>>(data, alpha);
+        return std::make_shared<LoopingQuinticHermiteSpline<T, floating_t, uniformKnots>>(data, alpha);
     }
+    template<bool uniformKnots = false>
     static LoopingSplinePtr createLoopingQuinticHermite(std::vector<T> data, floating_t alpha) {
         auto tangents = makeTangents(data);
         auto curves = makeTangents(tangents);
-        return std::make_shared<LoopingQuinticHermiteSpline<T, floating_t>>(data, tangents, curves, alpha);
+        return std::make_shared<LoopingQuinticHermiteSpline<T, floating_t, uniformKnots>>(data, tangents, curves, alpha);
     }
+    template<bool uniformKnots = false>
     static LoopingSplinePtr createLoopingNatural(std::vector<T> data, floating_t alpha) {
-        return std::make_shared<LoopingNaturalSpline<T, floating_t>>(data, alpha);
+        return std::make_shared<LoopingNaturalSpline<T, floating_t, uniformKnots>>(data, alpha);
     }
     static LoopingSplinePtr createLoopingUniformBSpline(std::vector<T> data) {
         return std::make_shared<LoopingUniformCubicBSpline<T, floating_t>>(data);
@@ -166,9 +182,6 @@ public:
         return result;
     }
 
-
-private:
-
     //Given a list of points, compute an equal-sized list of tangents to use in a cubic or quintic hermite spline
     //use the finite difference algorithm
     static std::vector<T> makeTangents(std::vector<T> points) {
@@ -188,6 +201,9 @@ private:
         return tangents;
     }
 
+
+private:
+
     //we need to pad out the ends of the data differently depending on spline type
     //this way all of the splines will have the same arc length, so it'll be easier to test
     static std::vector<T> addPadding(std::vector<T> list, size_t paddingSize)
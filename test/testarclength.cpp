@@ -2,6 +2,10 @@
 
 #include "common.h"
 #include "spline_library/utils/arclength.h"
+#include "spline_library/utils/arclengthtable.h"
+#include "spline_library/utils/arclengthparameterization.h"
+#include "spline_library/utils/splinecursor.h"
+#include "spline_library/utils/splinesegmentcache.h"
 
 #include "spline_library/utils/calculus.h"
 #include "spline_library/splines/uniform_cubic_bspline.h"
@@ -11,6 +15,8 @@
 #include "spline_library/splines/uniform_cr_spline.h"
 #include "spline_library/splines/quintic_hermite_spline.h"
 
+#include <thread>
+
 #include <QtTest/QtTest>
 
 TestArcLength::TestArcLength(QObject *parent) : QObject(parent)
@@ -347,3 +353,581 @@ void TestArcLength::testPartitionN(void)
         QCOMPARE(pieceLength, totalLength/n);
     }
 }
+
+
+
+
+
+void TestArcLength::testPartitionParallel_data(void)
+{
+    //enough segments and pieces that every parallel step actually gets split across threads
+    auto data = TestDataFloat::generateRandomData(2000);
+
+    QTest::addColumn<std::shared_ptr<Spline<Vector2>>>("spline");
+    QTest::addColumn<size_t>("threadCount");
+
+    QTest::newRow("uniformCR 4 threads") << TestDataFloat::createUniformCR(data) << size_t(4);
+    QTest::newRow("natural 3 threads") << TestDataFloat::createNatural(data, true, 0.5f) << size_t(3);
+    QTest::newRow("uniformCR hardware threads") << TestDataFloat::createUniformCR(data) << size_t(0);
+}
+
+void TestArcLength::testPartitionParallel(void)
+{
+    QFETCH(std::shared_ptr<Spline<Vector2>>, spline);
+    QFETCH(size_t, threadCount);
+
+    ArcLengthTable<Vector2> serialTable(*spline);
+    ArcLengthTable<Vector2> parallelTable(*spline, threadCount);
+    for(size_t i = 0; i < spline->segmentCount(); i++)
+    {
+        QVERIFY(serialTable.segmentLength(i) == parallelTable.segmentLength(i));
+        QVERIFY(serialTable.lengthBeforeSegment(i + 1) == parallelTable.lengthBeforeSegment(i + 1));
+    }
+
+    float desiredLength = serialTable.totalLength() / 1000.5f;
+    std::vector<float> serialPieces = ArcLength::partition(*spline, desiredLength);
+    std::vector<float> parallelPieces = ArcLength::partition(*spline, desiredLength, threadCount);
+    QCOMPARE(parallelPieces.size(), size_t(1001));
+    QVERIFY(serialPieces == parallelPieces);
+
+    std::vector<float> serialPiecesN = ArcLength::partitionN(serialTable, 777);
+    std::vector<float> parallelPiecesN = ArcLength::partitionN(parallelTable, 777, threadCount);
+    QCOMPARE(parallelPiecesN.size(), size_t(778));
+    QVERIFY(serialPiecesN == parallelPiecesN);
+
+    //and the pieces should still have the right lengths. this spline is long enough that the rounding error in a float arc length table
+    //is bigger than QCOMPARE's relative tolerance for a single piece, so compare relative to the whole spline instead
+    float totalLength = parallelTable.totalLength();
+    for(size_t i = 0; i < parallelPiecesN.size() - 1; i++)
+    {
+        float pieceLength = parallelTable.arcLength(parallelPiecesN[i], parallelPiecesN[i+1]);
+        QVERIFY(std::abs(pieceLength - totalLength / 777) < totalLength * 1e-6f);
+    }
+}
+
+void TestArcLength::testArcLengthQuadrature_data(void)
+{
+    QTest::addColumn<std::shared_ptr<Spline<Vector2>>>("spline");
+
+    auto data = TestDataFloat::generateRandomData(10);
+
+    QTest::newRow("uniformCR") << TestDataFloat::createUniformCR(data);
+    QTest::newRow("cubicHermiteAlpha") << TestDataFloat::createCubicHermite(data, 0.5f);
+    QTest::newRow("quinticHermiteAlpha") << TestDataFloat::createQuinticHermite(data, 0.5f);
+    QTest::newRow("naturalAlpha") << TestDataFloat::createNatural(data, true, 0.5f);
+    QTest::newRow("genericBQuintic") << TestDataFloat::createGenericBSpline(data, 5);
+}
+
+void TestArcLength::testArcLengthQuadrature(void)
+{
+    QFETCH(std::shared_ptr<Spline<Vector2>>, spline);
+
+    std::vector<float> expectedLengths(spline->segmentCount());
+    for(size_t i = 0; i < spline->segmentCount(); i++)
+    {
+        expectedLengths[i] = spline->segmentArcLength(i, spline->segmentT(i), spline->segmentT(i + 1));
+    }
+    float expectedTotal = spline->totalLength();
+
+    spline->setArcLengthQuadrature(SplineLibraryCalculus::QuadratureSettings<float>(SplineLibraryCalculus::AdaptiveGaussKronrod, 1e-6f));
+    for(size_t i = 0; i < spline->segmentCount(); i++)
+    {
+        QCOMPARE(spline->segmentArcLength(i, spline->segmentT(i), spline->segmentT(i + 1)), expectedLengths[i]);
+    }
+    QCOMPARE(spline->totalLength(), expectedTotal);
+
+    spline->setArcLengthQuadrature(SplineLibraryCalculus::QuadratureSettings<float>(SplineLibraryCalculus::LowOrderGaussLegendre));
+    for(size_t i = 0; i < spline->segmentCount(); i++)
+    {
+        float lowOrderLength = spline->segmentArcLength(i, spline->segmentT(i), spline->segmentT(i + 1));
+        QVERIFY(std::abs(lowOrderLength - expectedLengths[i]) <= expectedLengths[i] * 1e-3f);
+    }
+    QVERIFY(std::abs(spline->totalLength() - expectedTotal) <= expectedTotal * 1e-3f);
+}
+
+void TestArcLength::testArcLengthTable_data(void)
+{
+    auto data = TestDataFloat::generateRandomData(10);
+
+    QTest::addColumn<std::shared_ptr<Spline<Vector2>>>("spline");
+    QTest::addColumn<float>("a");
+    QTest::addColumn<float>("b");
+
+    auto rowFunction = [=](const char* name, std::shared_ptr<Spline<Vector2>> spline) {
+
+        //add a row for the whole spline
+        std::string allName = QString("%1 (All)").arg(name).toStdString();
+        QTest::newRow(allName.data()) << spline << 0.0f << spline->getMaxT();
+
+        //add a row for just part of the spline. we want to make sure a and b fall partway through a segment
+        float partialA = lerp(spline->segmentT(1), spline->segmentT(2), 0.75f);
+        float partialB = lerp(spline->segmentT(spline->segmentCount() - 3), spline->segmentT(spline->segmentCount() - 2), 0.25f);
+        std::string partialName = QString("%1 (Partial)").arg(name).toStdString();
+        QTest::newRow(partialName.data()) << spline << partialA << partialB;
+
+        //add a row where a and b are in adjacent segments, so there are no "middle" segments to look up
+        float adjacentA = lerp(spline->segmentT(3), spline->segmentT(4), 0.5f);
+        float adjacentB = lerp(spline->segmentT(4), spline->segmentT(5), 0.5f);
+        std::string adjacentName = QString("%1 (Adjacent)").arg(name).toStdString();
+        QTest::newRow(adjacentName.data()) << spline << adjacentA << adjacentB;
+
+        //add a row where a and b are in the same segment, since this is a special case
+        size_t testIndex = 3;
+        float sameSegmentA = lerp(spline->segmentT(testIndex), spline->segmentT(testIndex + 1), 0.2f);
+        float sameSegmentB = lerp(spline->segmentT(testIndex), spline->segmentT(testIndex + 1), 0.6f);
+        std::string sameSegmentName = QString("%1 (Same)").arg(name).toStdString();
+        QTest::newRow(sameSegmentName.data()) << spline << sameSegmentA << sameSegmentB;
+    };
+
+    rowFunction("uniformCR", TestDataFloat::createUniformCR(data));
+    rowFunction("cubicHermiteAlpha", TestDataFloat::createCubicHermite(data, 0.5f));
+    rowFunction("genericBQuintic", TestDataFloat::createGenericBSpline(data, 5));
+}
+
+void TestArcLength::testArcLengthTable(void)
+{
+    QFETCH(std::shared_ptr<Spline<Vector2>>, spline);
+    QFETCH(float, a);
+    QFETCH(float, b);
+
+    ArcLengthTable<Vector2> table(*spline);
+
+    QCOMPARE(table.totalLength(), spline->totalLength());
+    QCOMPARE(table.lengthBeforeSegment(0), 0.0f);
+    QCOMPARE(table.lengthBeforeSegment(spline->segmentCount()), table.totalLength());
+
+    for(size_t i = 0; i < spline->segmentCount(); i++)
+    {
+        QCOMPARE(table.segmentLength(i), spline->segmentArcLength(i, spline->segmentT(i), spline->segmentT(i + 1)));
+    }
+
+    //the table should agree with the direct computation in both directions
+    QCOMPARE(table.arcLength(a, b), spline->arcLength(a, b));
+    QCOMPARE(table.arcLength(b, a), spline->arcLength(a, b));
+
+    //partitioning with the table should give each piece the correct length
+    float desiredLength = table.totalLength() / 7.5f;
+    std::vector<float> pieces = ArcLength::partition(table, desiredLength);
+    QCOMPARE(pieces.size(), size_t(8));
+    for(size_t i = 0; i < pieces.size() - 1; i++)
+    {
+        QCOMPARE(table.arcLength(pieces[i], pieces[i+1]), desiredLength);
+    }
+
+    std::vector<float> piecesN = ArcLength::partitionN(table, 5);
+    QCOMPARE(piecesN.size(), size_t(6));
+    for(size_t i = 0; i < piecesN.size() - 1; i++)
+    {
+        QCOMPARE(table.arcLength(piecesN[i], piecesN[i+1]), table.totalLength() / 5);
+    }
+}
+
+void TestArcLength::testArcLengthTableOutOfRange_data(void)
+{
+    auto data = TestDataFloat::generateRandomData(8);
+
+    QTest::addColumn<std::shared_ptr<Spline<Vector2>>>("spline");
+
+    QTest::newRow("uniformCR") << std::shared_ptr<Spline<Vector2>>(TestDataFloat::createUniformCR(data));
+    QTest::newRow("natural") << std::shared_ptr<Spline<Vector2>>(TestDataFloat::createNatural(data, true, 0.5f));
+    QTest::newRow("loopingUniformCR") << std::shared_ptr<Spline<Vector2>>(TestDataFloat::createLoopingUniformCR(data));
+    QTest::newRow("loopingNatural") << std::shared_ptr<Spline<Vector2>>(TestDataFloat::createLoopingNatural(data, 0.5f));
+}
+
+void TestArcLength::testArcLengthTableOutOfRange(void)
+{
+    QFETCH(std::shared_ptr<Spline<Vector2>>, spline);
+
+    float maxT = spline->getMaxT();
+    ArcLengthTable<Vector2> table(*spline);
+
+    //past the end, spanning the end, before the beginning, and spanning the beginning
+    const std::vector<std::pair<float, float>> ranges = {
+        {maxT + 1, maxT + 2.5f},
+        {1, maxT + 0.5f},
+        {-1.5f, -0.5f},
+        {-0.5f, 2.5f},
+        {-3 * maxT - 0.25f, 2 * maxT + 0.75f},
+    };
+    for(const auto &range : ranges)
+    {
+        compareFloatsLenient(table.arcLength(range.first, range.second), spline->arcLength(range.first, range.second), 1e-4f);
+        compareFloatsLenient(table.arcLength(range.second, range.first), spline->arcLength(range.first, range.second), 1e-4f);
+    }
+}
+
+void TestArcLength::testArcLengthTableCyclic_data(void)
+{
+    auto data = TestDataFloat::generateRandomData(10);
+
+    QTest::addColumn<std::shared_ptr<LoopingSpline<Vector2>>>("spline");
+    QTest::addColumn<float>("a");
+    QTest::addColumn<float>("b");
+
+    auto rowFunction = [=](const char* name, std::shared_ptr<LoopingSpline<Vector2>> spline) {
+
+        //add a row for just part of the spline. we want to make sure a and b fall partway through a segment
+        float partialA = lerp(spline->segmentT(2), spline->segmentT(3), 0.75f);
+        float partialB = lerp(spline->segmentT(spline->segmentCount() - 3), spline->segmentT(spline->segmentCount() - 2), 0.25f);
+        std::string partialName = QString("%1 (DifferentSegment)").arg(name).toStdString();
+        QTest::newRow(partialName.data()) << spline << partialA << partialB;
+
+        //add a row where a and b are in the same segment
+        size_t testIndex = 3;
+        float sameSegmentA = lerp(spline->segmentT(testIndex), spline->segmentT(testIndex + 1), 0.2f);
+        float sameSegmentB = lerp(spline->segmentT(testIndex), spline->segmentT(testIndex + 1), 0.6f);
+        std::string sameSegmentName = QString("%1 (SameSegment)").arg(name).toStdString();
+        QTest::newRow(sameSegmentName.data()) << spline << sameSegmentA << sameSegmentB;
+    };
+
+    rowFunction("uniformCR", TestDataFloat::createLoopingUniformCR(data));
+    rowFunction("cubicHermiteAlpha", TestDataFloat::createLoopingCatmullRom(data, 0.5f));
+}
+
+void TestArcLength::testArcLengthTableCyclic(void)
+{
+    QFETCH(std::shared_ptr<LoopingSpline<Vector2>>, spline);
+    QFETCH(float, a);
+    QFETCH(float, b);
+
+    float maxT = spline->getMaxT();
+    ArcLengthTable<Vector2> table(*spline);
+
+    QCOMPARE(table.totalLength(), spline->totalLength());
+
+    //verify every combination of wrapping, in both directions
+    QCOMPARE(table.cyclicArcLength(a, b), spline->cyclicArcLength(a, b));
+    QCOMPARE(table.cyclicArcLength(b, a), spline->cyclicArcLength(b, a));
+    QCOMPARE(table.cyclicArcLength(a + maxT, b), spline->cyclicArcLength(a, b));
+    QCOMPARE(table.cyclicArcLength(a, b - maxT), spline->cyclicArcLength(a, b));
+    QCOMPARE(table.cyclicArcLength(b, a + 2*maxT), spline->cyclicArcLength(b, a));
+}
+
+
+
+
+
+void TestArcLength::testArcLengthParameterization_data(void)
+{
+    auto data = TestDataFloat::generateRandomData(10);
+
+    QTest::addColumn<std::shared_ptr<Spline<Vector2>>>("spline");
+    QTest::addColumn<float>("tolerance");
+
+    auto rowFunction = [=](const char* name, std::shared_ptr<Spline<Vector2>> spline) {
+        std::string coarseName = QString("%1 (Coarse)").arg(name).toStdString();
+        QTest::newRow(coarseName.data()) << spline << 0.01f;
+
+        std::string fineName = QString("%1 (Fine)").arg(name).toStdString();
+        QTest::newRow(fineName.data()) << spline << 0.0005f;
+    };
+
+    rowFunction("uniformCR", TestDataFloat::createUniformCR(data));
+    rowFunction("uniformB", TestDataFloat::createUniformBSpline(data));
+    rowFunction("cubicHermiteAlpha", TestDataFloat::createCubicHermite(data, 0.5f));
+    rowFunction("natural", TestDataFloat::createNatural(data, true, 0.5f));
+    rowFunction("genericBQuintic", TestDataFloat::createGenericBSpline(data, 5));
+}
+
+void TestArcLength::testArcLengthParameterization(void)
+{
+    QFETCH(std::shared_ptr<Spline<Vector2>>, spline);
+    QFETCH(float, tolerance);
+
+    ArcLengthParameterization<Vector2> parameterization(*spline, tolerance);
+
+    QCOMPARE(parameterization.totalLength(), spline->totalLength());
+    QCOMPARE(parameterization.solveT(0), 0.0f);
+    QCOMPARE(parameterization.solveT(-1), 0.0f);
+    QCOMPARE(parameterization.solveT(parameterization.totalLength()), spline->getMaxT());
+    QCOMPARE(parameterization.solveT(parameterization.totalLength() + 1), spline->getMaxT());
+    QVERIFY(parameterization.measuredMaxError() <= tolerance);
+
+    //walk along the spline and make sure every approximated t value is within the tolerance, and that the result is monotone
+    //allow a little extra room for the floating point error in the arc length computation itself
+    float allowedError = tolerance + parameterization.totalLength() * 1e-5f;
+    float previousT = 0;
+
+    size_t numSteps = 997;
+    for(size_t i = 1; i < numSteps; i++)
+    {
+        float distance = parameterization.totalLength() * i / numSteps;
+        float t = parameterization.solveT(distance);
+
+        QVERIFY(t >= previousT);
+        QVERIFY(std::abs(spline->arcLength(0, t) - distance) <= allowedError);
+        previousT = t;
+
+        //the exact version should match the solver
+        QCOMPARE(parameterization.solveTExact(distance), ArcLength::solveLength(*spline, 0.0f, distance));
+    }
+}
+
+void TestArcLength::testArcLengthParameterizationCyclic_data(void)
+{
+    auto data = TestDataFloat::generateRandomData(10);
+
+    QTest::addColumn<std::shared_ptr<LoopingSpline<Vector2>>>("spline");
+
+    QTest::newRow("uniformCR") << TestDataFloat::createLoopingUniformCR(data);
+    QTest::newRow("uniformB") << TestDataFloat::createLoopingUniformBSpline(data);
+    QTest::newRow("cubicHermiteAlpha") << TestDataFloat::createLoopingCatmullRom(data, 0.5f);
+    QTest::newRow("natural") << TestDataFloat::createLoopingNatural(data, 0.5f);
+}
+
+void TestArcLength::testArcLengthParameterizationCyclic(void)
+{
+    QFETCH(std::shared_ptr<LoopingSpline<Vector2>>, spline);
+
+    ArcLengthParameterization<Vector2> parameterization(*spline, 0.001f);
+    float total = parameterization.totalLength();
+    float maxT = spline->getMaxT();
+
+    for(float fraction : {0.1f, 0.45f, 0.8f})
+    {
+        float distance = total * fraction;
+        float t = parameterization.solveT(distance);
+
+        QCOMPARE(parameterization.solveTCyclic(distance), t);
+        QCOMPARE(parameterization.solveTCyclic(distance + total * 2), t + maxT * 2);
+        QCOMPARE(parameterization.solveTCyclic(distance - total), t - maxT);
+    }
+
+    //a spline with no length has nothing to wrap, so it's clamped instead of dividing by zero
+    LoopingUniformCRSpline<Vector2> zeroLength(std::vector<Vector2>(4, Vector2({1, 2})));
+    ArcLengthParameterization<Vector2> zeroParameterization(zeroLength, 0.001f);
+    QCOMPARE(zeroParameterization.totalLength(), 0.0f);
+    QCOMPARE(zeroParameterization.solveTCyclic(5.0f), 0.0f);
+    QCOMPARE(zeroParameterization.solveTCyclic(-5.0f), 0.0f);
+}
+
+void TestArcLength::testSplineCursor_data(void)
+{
+    auto data = TestDataFloat::generateRandomData(10);
+
+    QTest::addColumn<std::shared_ptr<Spline<Vector2>>>("spline");
+
+    QTest::newRow("uniformCR") << TestDataFloat::createUniformCR(data);
+    QTest::newRow("catmullRomAlpha") << TestDataFloat::createCatmullRom(data, 0.5f);
+    QTest::newRow("quinticHermiteAlpha") << TestDataFloat::createQuinticHermite(data, 0.5f);
+    QTest::newRow("naturalAlpha") << TestDataFloat::createNatural(data, true, 0.5f);
+    QTest::newRow("genericBQuintic") << TestDataFloat::createGenericBSpline(data, 5);
+}
+
+void TestArcLength::testSplineCursor(void)
+{
+    QFETCH(std::shared_ptr<Spline<Vector2>>, spline);
+
+    float maxT = spline->getMaxT();
+    SplineCursor<Vector2> cursor(*spline);
+
+    //step forward in t, past the end, then back past the beginning. the cursor should stop at each end
+    float expectedT = 0;
+    float dt = maxT / 37;
+    for(size_t i = 0; i < 40; i++)
+    {
+        cursor.advance(dt);
+        expectedT = std::min(expectedT + dt, maxT);
+
+        QCOMPARE(cursor.getT(), expectedT);
+        QCOMPARE(cursor.getSegmentIndex(), spline->segmentForT(expectedT));
+        QCOMPARE(cursor.getPosition(), spline->getPosition(expectedT));
+        QCOMPARE(cursor.getWiggle().tangent, spline->getWiggle(expectedT).tangent);
+    }
+    for(size_t i = 0; i < 40; i++)
+    {
+        cursor.advance(-dt);
+        expectedT = std::max(expectedT - dt, 0.0f);
+
+        QCOMPARE(cursor.getT(), expectedT);
+        QCOMPARE(cursor.getPosition(), spline->getPosition(expectedT));
+    }
+
+    //big steps fall back to a full search, and should give the same result
+    cursor.advance(maxT * 0.75f);
+    QCOMPARE(cursor.getSegmentIndex(), spline->segmentForT(maxT * 0.75f));
+    QCOMPARE(cursor.getPosition(), spline->getPosition(maxT * 0.75f));
+
+    //step forward by arc length. the solver only converges to about half of float precision, so the error slowly builds up from step to step
+    float total = spline->totalLength();
+    float step = total / 23;
+    cursor.seek(0);
+    for(size_t i = 1; i < 23; i++)
+    {
+        QCOMPARE(cursor.advanceLength(step), step);
+        compareFloatsLenient(spline->arcLength(0, cursor.getT()), step * i, total * 1e-4f);
+    }
+
+    //the last step runs off the end, so it should be cut short
+    float lastStep = cursor.advanceLength(step * 2);
+    QCOMPARE(cursor.getT(), maxT);
+    compareFloatsLenient(lastStep, step, total * 1e-3f);
+
+    //then step backwards, and run off the beginning
+    for(size_t i = 22; i > 0; i--)
+    {
+        QCOMPARE(cursor.advanceLength(-step), -step);
+        compareFloatsLenient(spline->arcLength(0, cursor.getT()), step * i, total * 1e-4f);
+    }
+    compareFloatsLenient(cursor.advanceLength(-step * 2), -step, total * 1e-3f);
+    QCOMPARE(cursor.getT(), 0.0f);
+}
+
+void TestArcLength::testSplineCursorCyclic_data(void)
+{
+    auto data = TestDataFloat::generateRandomData(10);
+
+    QTest::addColumn<std::shared_ptr<LoopingSpline<Vector2>>>("spline");
+
+    QTest::newRow("uniformCR") << TestDataFloat::createLoopingUniformCR(data);
+    QTest::newRow("uniformB") << TestDataFloat::createLoopingUniformBSpline(data);
+    QTest::newRow("cubicHermiteAlpha") << TestDataFloat::createLoopingCatmullRom(data, 0.5f);
+    QTest::newRow("natural") << TestDataFloat::createLoopingNatural(data, 0.5f);
+}
+
+void TestArcLength::testSplineCursorCyclic(void)
+{
+    QFETCH(std::shared_ptr<LoopingSpline<Vector2>>, spline);
+
+    float maxT = spline->getMaxT();
+    SplineCursor<Vector2> cursor(*spline, maxT * 0.9f);
+
+    //step around the loop a bit more than once in each direction. t should always stay wrapped
+    float unwrappedT = maxT * 0.9f;
+    float dt = maxT / 17;
+    for(float direction : {1.0f, -1.0f})
+    {
+        for(size_t i = 0; i < 20; i++)
+        {
+            cursor.advance(dt * direction);
+            unwrappedT += dt * direction;
+
+            //the cursor wraps each step as it goes, so its t won't be rounded identically to wrapping the sum
+            QVERIFY(cursor.getT() >= 0 && cursor.getT() <= maxT);
+            QCOMPARE(spline->wrapT(cursor.getT()), spline->wrapT(unwrappedT));
+            QCOMPARE(cursor.getSegmentIndex(), spline->segmentForT(cursor.getT()));
+            QCOMPARE(cursor.getPosition(), spline->getPosition(cursor.getT()));
+        }
+    }
+
+    //step by arc length across the seam, in both directions
+    float total = spline->totalLength();
+    float start = maxT * 0.9f;
+    cursor.seek(start);
+
+    float distance = total * 0.3f;
+    QCOMPARE(cursor.advanceLength(distance), distance);
+    compareFloatsLenient(spline->cyclicArcLength(start, cursor.getT()), distance, total * 1e-4f);
+
+    QCOMPARE(cursor.advanceLength(-distance), -distance);
+    QVERIFY(spline->arcLength(std::min(cursor.getT(), start), std::max(cursor.getT(), start)) <= total * 1e-4f);
+
+    //more than a full loop backwards
+    QCOMPARE(cursor.advanceLength(-(total + distance)), -(total + distance));
+    compareFloatsLenient(spline->cyclicArcLength(cursor.getT(), start), distance, total * 1e-4f);
+}
+
+void TestArcLength::testSegmentCache_data(void)
+{
+    auto data = TestDataFloat::generateRandomData(10);
+
+    QTest::addColumn<std::shared_ptr<Spline<Vector2>>>("spline");
+    QTest::addColumn<float>("a");
+    QTest::addColumn<float>("b");
+
+    auto rowFunction = [=](const char* name, std::shared_ptr<Spline<Vector2>> spline) {
+        float partialA = lerp(spline->segmentT(1), spline->segmentT(2), 0.75f);
+        float partialB = lerp(spline->segmentT(spline->segmentCount() - 3), spline->segmentT(spline->segmentCount() - 2), 0.25f);
+        std::string partialName = QString("%1 (Partial)").arg(name).toStdString();
+        QTest::newRow(partialName.data()) << spline << partialA << partialB;
+
+        size_t testIndex = 3;
+        float sameSegmentA = lerp(spline->segmentT(testIndex), spline->segmentT(testIndex + 1), 0.2f);
+        float sameSegmentB = lerp(spline->segmentT(testIndex), spline->segmentT(testIndex + 1), 0.6f);
+        std::string sameSegmentName = QString("%1 (Same)").arg(name).toStdString();
+        QTest::newRow(sameSegmentName.data()) << spline << sameSegmentA << sameSegmentB;
+    };
+
+    rowFunction("uniformCR", TestDataFloat::createUniformCR(data));
+    rowFunction("cubicHermiteAlpha", TestDataFloat::createCubicHermite(data, 0.5f));
+    rowFunction("genericBQuintic", TestDataFloat::createGenericBSpline(data, 5));
+}
+
+void TestArcLength::testSegmentCache(void)
+{
+    QFETCH(std::shared_ptr<Spline<Vector2>>, spline);
+    QFETCH(float, a);
+    QFETCH(float, b);
+
+    SplineSegmentCache<Vector2> cache(*spline);
+    size_t emptyFootprint = cache.memoryFootprint();
+    for(size_t i = 0; i < spline->segmentCount(); i++)
+    {
+        QVERIFY(!cache.isCached(i));
+    }
+
+    float arcLength = spline->arcLength(a, b);
+    QCOMPARE(cache.arcLength(a, b), arcLength);
+    QCOMPARE(cache.arcLength(b, a), arcLength);
+    QCOMPARE(cache.solveLength(a, arcLength), b);
+    QVERIFY(cache.memoryFootprint() > emptyFootprint);
+
+    //the cached lengths are the spline's own, and asking again gives exactly the same value
+    for(size_t i = 0; i < spline->segmentCount(); i++)
+    {
+        float expected = spline->segmentArcLength(i, spline->segmentT(i), spline->segmentT(i + 1));
+        QCOMPARE(cache.segmentLength(i), expected);
+        QVERIFY(cache.isCached(i));
+        QCOMPARE(cache.segmentLength(i), expected);
+
+        float t = lerp(spline->segmentT(i), spline->segmentT(i + 1), 0.4f);
+        QCOMPARE(cache.solveSegmentLength(i, spline->segmentArcLength(i, spline->segmentT(i), t)), t);
+    }
+    QCOMPARE(cache.solveLength(a, spline->totalLength()), spline->getMaxT());
+}
+
+void TestArcLength::testSegmentCacheThreaded(void)
+{
+    auto data = TestDataFloat::generateRandomData(2000);
+    auto spline = TestDataFloat::createUniformCR(data);
+
+    //one thread on its own decides what every value should be
+    SplineSegmentCache<Vector2> expected(*spline);
+    std::vector<float> expectedT;
+    for(size_t i = 0; i < 256; i++)
+    {
+        expectedT.push_back(expected.solveSegmentLength(i, expected.segmentLength(i) * 0.3f));
+    }
+
+    //then a handful of threads race to fill the same pages of another cache
+    SplineSegmentCache<Vector2> cache(*spline);
+    std::vector<std::thread> threads;
+    std::vector<int> mismatches(4, 0);
+    for(size_t thread = 0; thread < mismatches.size(); thread++)
+    {
+        threads.emplace_back([&, thread]() {
+            for(size_t n = 0; n < expectedT.size(); n++)
+            {
+                size_t i = (n * 7 + thread * 31) % expectedT.size();
+                if(cache.segmentLength(i) != expected.segmentLength(i) || cache.solveSegmentLength(i, cache.segmentLength(i) * 0.3f) != expectedT[i])
+                    mismatches[thread]++;
+            }
+        });
+    }
+    for(auto &thread : threads)
+    {
+        thread.join();
+    }
+    for(int count : mismatches)
+    {
+        QCOMPARE(count, 0);
+    }
+
+    //only the pages covering the first 256 segments were allocated, not the whole spline's worth
+    QVERIFY(!cache.isCached(256));
+    for(size_t i = 0; i < spline->segmentCount(); i++)
+    {
+        expected.solveSegmentLength(i, expected.segmentLength(i) * 0.3f);
+    }
+    QVERIFY(cache.memoryFootprint() * 4 < expected.memoryFootprint());
+}
@@ -36,4 +36,47 @@ private slots:
     //verify that the "partitionN" method works as expected
     void testPartitionN_data(void);
     void testPartitionN(void);
+
+    //verify that the multithreaded partition methods give exactly the same results as the single threaded ones
+    void testPartitionParallel_data(void);
+    void testPartitionParallel(void);
+
+    //verify that the adaptive and low-order quadrature modes agree with the default quadrature, within their tolerances
+    void testArcLengthQuadrature_data(void);
+    void testArcLengthQuadrature(void);
+
+    //verify that the arc length table gives the same results as computing arc lengths directly
+    void testArcLengthTable_data(void);
+    void testArcLengthTable(void);
+
+    //verify that the arc length table agrees with the spline for t values below 0 and above maxT, on both looping and non-looping splines
+    void testArcLengthTableOutOfRange_data(void);
+    void testArcLengthTableOutOfRange(void);
+
+    //verify that the arc length table gives the same cyclic arc lengths as computing them directly
+    void testArcLengthTableCyclic_data(void);
+    void testArcLengthTableCyclic(void);
+
+    //verify that the arc length parameterization stays within its tolerance, that its measured error agrees, and that its exact mode matches solveLength
+    void testArcLengthParameterization_data(void);
+    void testArcLengthParameterization(void);
+
+    //verify that the cyclic arc length parameterization wraps correctly on looping splines, and doesn't divide by zero on a spline with no length
+    void testArcLengthParameterizationCyclic_data(void);
+    void testArcLengthParameterizationCyclic(void);
+
+    //verify that a spline cursor stepping along a spline matches evaluating the spline directly
+    void testSplineCursor_data(void);
+    void testSplineCursor(void);
+
+    //verify that a spline cursor wraps around looping splines in both directions
+    void testSplineCursorCyclic_data(void);
+    void testSplineCursorCyclic(void);
+
+    //verify that the segment cache gives the same results as computing arc lengths directly, and only allocates what's queried
+    void testSegmentCache_data(void);
+    void testSegmentCache(void);
+
+    //verify that many threads filling the same segment cache at once all get the same values as a single thread
+    void testSegmentCacheThreaded(void);
 };
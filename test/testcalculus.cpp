@@ -2,8 +2,13 @@
 
 #include "spline_library/utils/calculus.h"
 
+#include <functional>
+#include <cmath>
+
 #include <QtTest/QtTest>
 
+Q_DECLARE_METATYPE(std::function<double(double)>)
+
 TestCalculus::TestCalculus(QObject *parent) : QObject(parent)
 {
 
@@ -31,3 +36,73 @@ void TestCalculus::testGaussLegendre(void)
 
     QCOMPARE(result, expected);
 }
+
+void TestCalculus::testLowOrderGaussLegendre_data(void)
+{
+    testGaussLegendre_data();
+}
+
+void TestCalculus::testLowOrderGaussLegendre(void)
+{
+    QFETCH(float, from);
+    QFETCH(float, to);
+    QFETCH(float, expected);
+
+    auto result = SplineLibraryCalculus::lowOrderGaussLegendreIntegral<float>([](auto x){return x*x*(x-1);}, from, to);
+
+    QCOMPARE(result, expected);
+}
+
+void TestCalculus::testGaussKronrod_data(void)
+{
+    testGaussLegendre_data();
+}
+
+void TestCalculus::testGaussKronrod(void)
+{
+    QFETCH(float, from);
+    QFETCH(float, to);
+    QFETCH(float, expected);
+
+    float errorEstimate;
+    auto result = SplineLibraryCalculus::gaussKronrodIntegral<float>([](auto x){return x*x*(x-1);}, from, to, errorEstimate);
+
+    QCOMPARE(result, expected);
+
+    //both the gauss and kronrod rules are exact for a cubic, so they should agree
+    QVERIFY(errorEstimate <= std::abs(expected) * 1e-5f);
+}
+
+void TestCalculus::testAdaptiveGaussKronrod_data(void)
+{
+    QTest::addColumn<std::function<double(double)>>("function");
+    QTest::addColumn<double>("from");
+    QTest::addColumn<double>("to");
+    QTest::addColumn<double>("expected");
+    QTest::addColumn<double>("tolerance");
+
+    std::function<double(double)> squareRoot = [](double x) { return std::sqrt(x); };
+    std::function<double(double)> spike = [](double x) { return 1 / (1e-4 + x * x); };
+    std::function<double(double)> corner = [](double x) { return std::abs(x - 0.3); };
+
+    QTest::newRow("sqrt") << squareRoot << 0.0 << 4.0 << 16.0 / 3.0 << 1e-8;
+    QTest::newRow("spike") << spike << -1.0 << 1.0 << 200 * std::atan(100.0) << 1e-8;
+    QTest::newRow("corner") << corner << 0.0 << 1.0 << 0.29 << 1e-8;
+    QTest::newRow("loose") << spike << -1.0 << 1.0 << 200 * std::atan(100.0) << 1e-3;
+}
+
+void TestCalculus::testAdaptiveGaussKronrod(void)
+{
+    QFETCH(std::function<double(double)>, function);
+    QFETCH(double, from);
+    QFETCH(double, to);
+    QFETCH(double, expected);
+    QFETCH(double, tolerance);
+
+    double result = SplineLibraryCalculus::adaptiveGaussKronrodIntegral<double>(function, from, to, tolerance);
+    QVERIFY(std::abs(result - expected) <= std::abs(expected) * tolerance);
+
+    //the integrate() dispatcher should give the same result
+    SplineLibraryCalculus::QuadratureSettings<double> settings(SplineLibraryCalculus::AdaptiveGaussKronrod, tolerance);
+    QCOMPARE(SplineLibraryCalculus::integrate<double>(function, from, to, settings), result);
+}
@@ -13,4 +13,14 @@ signals:
 private slots:
     void testGaussLegendre_data(void);
     void testGaussLegendre(void);
+
+    void testLowOrderGaussLegendre_data(void);
+    void testLowOrderGaussLegendre(void);
+
+    void testGaussKronrod_data(void);
+    void testGaussKronrod(void);
+
+    //verify that the adaptive quadrature reaches its tolerance on integrands that a single fixed pass can't resolve
+    void testAdaptiveGaussKronrod_data(void);
+    void testAdaptiveGaussKronrod(void);
 };
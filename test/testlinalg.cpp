@@ -3,6 +3,8 @@
 #include "spline_library/utils/linearalgebra.h"
 
 #include <vector>
+#include <algorithm>
+#include <cmath>
 
 #include <QtTest/QtTest>
 #include <QDebug>
@@ -115,3 +117,222 @@ void TestLinAlg::testCyclicTridiagonal(void)
         QCOMPARE(result[i], expected_output[i]);
     }
 }
+
+
+void TestLinAlg::testSymmetricBanded_data(void)
+{
+    testSymmetricTridiagonal_data();
+}
+void TestLinAlg::testSymmetricBanded(void)
+{
+    QFETCH(std::vector<float>, main_diagonal);
+    QFETCH(std::vector<float>, secondary_diagonal);
+    QFETCH(std::vector<float>, input);
+
+    //a bandwidth of 1 is a symmetric tridiagonal matrix, so verify that it gives the same result as the tridiagonal solver
+    std::vector<float> bands(main_diagonal.size() * 2, 0.0f);
+    for(size_t i = 0; i < main_diagonal.size(); i++) {
+        bands[i * 2] = main_diagonal[i];
+        if(i < secondary_diagonal.size())
+            bands[i * 2 + 1] = secondary_diagonal[i];
+    }
+
+    auto result = LinearAlgebra::solveSymmetricBanded(bands, 1, input);
+    auto expected = LinearAlgebra::solveSymmetricTridiagonal(main_diagonal, secondary_diagonal, input);
+
+    for(size_t i = 0; i < result.size(); i++) {
+        QVERIFY(std::abs(result[i] - expected[i]) <= 1e-5f * std::abs(expected[i]));
+    }
+
+    //then pad the same matrix out to a bandwidth of 3, with an extra diagonal 2 away, and verify the solution by multiplying it back
+    //the matrix stays diagonally dominant, so it's still positive definite
+    const size_t bandwidth = 3;
+    const size_t size = main_diagonal.size();
+    std::vector<float> wideBands(size * (bandwidth + 1), 0.0f);
+    for(size_t i = 0; i < size; i++) {
+        wideBands[i * (bandwidth + 1)] = main_diagonal[i] + 2.0f;
+        if(i < secondary_diagonal.size())
+            wideBands[i * (bandwidth + 1) + 1] = secondary_diagonal[i];
+        if(i + 2 < size)
+            wideBands[i * (bandwidth + 1) + 2] = 0.5f;
+    }
+
+    auto wideResult = LinearAlgebra::solveSymmetricBanded(wideBands, bandwidth, input);
+    for(size_t i = 0; i < size; i++) {
+        float product = 0;
+        for(size_t j = 0; j < size; j++) {
+            size_t row = std::min(i, j);
+            size_t offset = std::max(i, j) - row;
+            if(offset <= bandwidth)
+                product += wideBands[row * (bandwidth + 1) + offset] * wideResult[j];
+        }
+        QVERIFY(std::abs(product - input[i]) < 1e-4f * std::abs(input[i]) + 1e-5f);
+    }
+}
+
+//the factored tests share the one-shot tests' data
+void TestLinAlg::testFactoredTridiagonal_data(void)
+{
+    testTridiagonal_data();
+}
+void TestLinAlg::testFactoredTridiagonal(void)
+{
+    QFETCH(std::vector<float>, lower_diagonal);
+    QFETCH(std::vector<float>, main_diagonal);
+    QFETCH(std::vector<float>, upper_diagonal);
+    QFETCH(std::vector<float>, input);
+    QFETCH(std::vector<float>, expected_output);
+
+    TridiagonalFactorization<float> factorization;
+    LinearAlgebra::factorTridiagonal(main_diagonal.data(), upper_diagonal.data(), lower_diagonal.data(), main_diagonal.size(), factorization);
+
+    //solve for the input and for double the input at the same time
+    size_t size = input.size();
+    std::vector<float> values(size * 2);
+    for(size_t i = 0; i < size; i++) {
+        values[i] = input[i];
+        values[i + size] = input[i] * 2;
+    }
+    LinearAlgebra::solveFactored(factorization, values.data(), 2);
+
+    for(size_t i = 0; i < size; i++) {
+        QCOMPARE(values[i], expected_output[i]);
+        QCOMPARE(values[i + size], expected_output[i] * 2);
+    }
+}
+
+void TestLinAlg::testFactoredSymmetricTridiagonal_data(void)
+{
+    testSymmetricTridiagonal_data();
+}
+void TestLinAlg::testFactoredSymmetricTridiagonal(void)
+{
+    QFETCH(std::vector<float>, main_diagonal);
+    QFETCH(std::vector<float>, secondary_diagonal);
+    QFETCH(std::vector<float>, input);
+
+    auto expected = LinearAlgebra::solveSymmetricTridiagonal(main_diagonal, secondary_diagonal, input);
+
+    //reuse a factorization that was already used for a bigger matrix, to make sure nothing from the old matrix leaks through
+    TridiagonalFactorization<float> factorization;
+    std::vector<float> bigDiagonal(10, 7.0f);
+    std::vector<float> bigSecondary(9, 1.0f);
+    LinearAlgebra::factorSymmetricTridiagonal(bigDiagonal.data(), bigSecondary.data(), bigDiagonal.size(), factorization);
+    LinearAlgebra::factorSymmetricTridiagonal(main_diagonal.data(), secondary_diagonal.data(), main_diagonal.size(), factorization);
+
+    std::vector<float> values = input;
+    LinearAlgebra::solveFactored(factorization, values.data());
+
+    for(size_t i = 0; i < values.size(); i++) {
+        QCOMPARE(values[i], expected[i]);
+    }
+}
+
+void TestLinAlg::testFactoredCyclicTridiagonal_data(void)
+{
+    testCyclicTridiagonal_data();
+}
+void TestLinAlg::testFactoredCyclicTridiagonal(void)
+{
+    QFETCH(std::vector<float>, main_diagonal);
+    QFETCH(std::vector<float>, secondary_diagonal);
+    QFETCH(std::vector<float>, input);
+    QFETCH(std::vector<float>, expected_output);
+
+    TridiagonalFactorization<float> factorization;
+    LinearAlgebra::factorCyclicSymmetricTridiagonal(main_diagonal.data(), secondary_diagonal.data(), main_diagonal.size(), factorization);
+
+    size_t size = input.size();
+    std::vector<float> values(size * 2);
+    for(size_t i = 0; i < size; i++) {
+        values[i] = input[i];
+        values[i + size] = input[i] * 2;
+    }
+    LinearAlgebra::solveFactored(factorization, values.data(), 2);
+
+    for(size_t i = 0; i < size; i++) {
+        QCOMPARE(values[i], expected_output[i]);
+        QCOMPARE(values[i + size], expected_output[i] * 2);
+    }
+}
+
+
+namespace
+{
+    //enough systems to need more than one of the interleaved solvers' chunks
+    const size_t interleavedSystemCount = 70;
+
+    //system s of the batch has the test row's matrix scaled by a power of 2, and the test row's input scaled by a different power of 2,
+    //so every system has a different matrix, but its exact solution is known from the one-shot solver
+    float matrixScale(size_t s) { return float(1 << (s % 3)); }
+    float inputScale(size_t s) { return float(1 << (s % 4)); }
+
+    void interleave(const std::vector<float> &mainDiagonal, const std::vector<float> &secondaryDiagonal, const std::vector<float> &input,
+                    std::vector<float> &interleavedDiagonal, std::vector<float> &interleavedSecondary, std::vector<float> &interleavedValues)
+    {
+        size_t size = input.size();
+        interleavedDiagonal.resize(size * interleavedSystemCount);
+        interleavedSecondary.resize(size * interleavedSystemCount);
+        interleavedValues.resize(size * interleavedSystemCount);
+        for(size_t i = 0; i < size; i++) {
+            for(size_t s = 0; s < interleavedSystemCount; s++) {
+                interleavedDiagonal[i * interleavedSystemCount + s] = mainDiagonal[i] * matrixScale(s);
+                interleavedSecondary[i * interleavedSystemCount + s] = i < secondaryDiagonal.size() ? secondaryDiagonal[i] * matrixScale(s) : 0;
+                interleavedValues[i * interleavedSystemCount + s] = input[i] * inputScale(s);
+            }
+        }
+    }
+}
+
+void TestLinAlg::testInterleavedSymmetricTridiagonal_data(void)
+{
+    testSymmetricTridiagonal_data();
+}
+void TestLinAlg::testInterleavedSymmetricTridiagonal(void)
+{
+    QFETCH(std::vector<float>, main_diagonal);
+    QFETCH(std::vector<float>, secondary_diagonal);
+    QFETCH(std::vector<float>, input);
+
+    std::vector<float> diagonal, secondary, values;
+    interleave(main_diagonal, secondary_diagonal, input, diagonal, secondary, values);
+    LinearAlgebra::solveSymmetricTridiagonalInterleaved(diagonal.data(), secondary.data(), values.data(), input.size(), interleavedSystemCount);
+
+    for(size_t s = 0; s < interleavedSystemCount; s++) {
+        std::vector<float> systemDiagonal(main_diagonal.size()), systemSecondary(secondary_diagonal.size()), systemInput(input.size());
+        for(size_t i = 0; i < main_diagonal.size(); i++)
+            systemDiagonal[i] = main_diagonal[i] * matrixScale(s);
+        for(size_t i = 0; i < secondary_diagonal.size(); i++)
+            systemSecondary[i] = secondary_diagonal[i] * matrixScale(s);
+        for(size_t i = 0; i < input.size(); i++)
+            systemInput[i] = input[i] * inputScale(s);
+
+        auto expected = LinearAlgebra::solveSymmetricTridiagonal(systemDiagonal, systemSecondary, systemInput);
+        for(size_t i = 0; i < input.size(); i++) {
+            QCOMPARE(values[i * interleavedSystemCount + s], expected[i]);
+        }
+    }
+}
+
+void TestLinAlg::testInterleavedCyclicTridiagonal_data(void)
+{
+    testCyclicTridiagonal_data();
+}
+void TestLinAlg::testInterleavedCyclicTridiagonal(void)
+{
+    QFETCH(std::vector<float>, main_diagonal);
+    QFETCH(std::vector<float>, secondary_diagonal);
+    QFETCH(std::vector<float>, input);
+    QFETCH(std::vector<float>, expected_output);
+
+    std::vector<float> diagonal, secondary, values;
+    interleave(main_diagonal, secondary_diagonal, input, diagonal, secondary, values);
+    std::vector<float> correction(values.size());
+    LinearAlgebra::solveCyclicSymmetricTridiagonalInterleaved(diagonal.data(), secondary.data(), values.data(), correction.data(), input.size(), interleavedSystemCount);
+
+    for(size_t s = 0; s < interleavedSystemCount; s++) {
+        for(size_t i = 0; i < input.size(); i++) {
+            QCOMPARE(values[i * interleavedSystemCount + s], expected_output[i] * inputScale(s) / matrixScale(s));
+        }
+    }
+}
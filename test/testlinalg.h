@@ -19,4 +19,24 @@ private slots:
 
     void testCyclicTridiagonal_data(void);
     void testCyclicTridiagonal(void);
+
+    void testSymmetricBanded_data(void);
+    void testSymmetricBanded(void);
+
+    //verify that factoring each kind of matrix and then solving several right hand sides in place gives the same results as the one-shot solvers
+    void testFactoredTridiagonal_data(void);
+    void testFactoredTridiagonal(void);
+
+    void testFactoredSymmetricTridiagonal_data(void);
+    void testFactoredSymmetricTridiagonal(void);
+
+    void testFactoredCyclicTridiagonal_data(void);
+    void testFactoredCyclicTridiagonal(void);
+
+    //verify that solving many systems at once, interleaved, gives the same results as solving each one alone
+    void testInterleavedSymmetricTridiagonal_data(void);
+    void testInterleavedSymmetricTridiagonal(void);
+
+    void testInterleavedCyclicTridiagonal_data(void);
+    void testInterleavedCyclicTridiagonal(void);
 };
@@ -10,16 +10,38 @@
 #include "spline_library/splines/cubic_hermite_spline.h"
 #include "spline_library/splines/uniform_cr_spline.h"
 #include "spline_library/splines/quintic_hermite_spline.h"
+#include "spline_library/splines/compiled_spline.h"
+#include "spline_library/splines/fixed_uniform_spline.h"
+#include "spline_library/splines/sliding_window_spline.h"
 
 #include "spline_library/utils/splineinverter.h"
+#include "spline_library/utils/splineboundstree.h"
+#include "spline_library/utils/splinesegmentbounds.h"
+#include "spline_library/utils/splinelodtable.h"
+#include "spline_library/utils/tessellation.h"
+#include "spline_library/utils/fixedstepsampler.h"
+#include "spline_library/utils/rotationminimizingframes.h"
+#include "spline_library/utils/splinefitting.h"
+#include "spline_library/utils/splinepublisher.h"
+#include "spline_library/utils/gpusplinebuffer.h"
+#include "spline_library/utils/splinearchive.h"
+#include "spline_library/utils/arclength.h"
+#include "spline_library/utils/instrumentation.h"
+#include "spline_library/utils/splinevariant.h"
 
 #include "common.h"
 
 #include <vector>
 #include <memory>
 #include <cmath>
+#include <cstring>
+#include <limits>
+#include <algorithm>
+#include <random>
+#include <thread>
 
 #include <QtTest/QtTest>
+#include <QTemporaryDir>
 
 TestSpline::TestSpline(QObject *parent) : QObject(parent)
 {
@@ -200,6 +222,7 @@ void TestSpline::testDerivatives_data(void)
 
     QTest::newRow("uniformCubicB") <<       TestDataFloat::createUniformBSpline(data);
     QTest::newRow("genericB3") <<           TestDataFloat::createGenericBSpline(data,3);
+    QTest::newRow("genericB3Fixed") <<      TestDataFloat::createFixedDegreeGenericBSpline<3>(data);
     QTest::newRow("natural") <<             TestDataFloat::createNatural(data, true, 0.0f);
     QTest::newRow("naturalAlpha") <<        TestDataFloat::createNatural(data, true, 0.5f);
     QTest::newRow("quinticHermite") <<      TestDataFloat::createQuinticHermite(data, 0.0f);
@@ -261,6 +284,451 @@ void TestSpline::testDerivatives(void)
 
 
 
+void TestSpline::testGenericBFixedDegree_data(void)
+{
+    QTest::addColumn<std::shared_ptr<Spline<Vector2>>>("runtimeDegree");
+    QTest::addColumn<std::shared_ptr<Spline<Vector2>>>("fixedDegree");
+
+    auto data = TestDataFloat::generateRandomData(10);
+
+    QTest::newRow("linear") <<  TestDataFloat::createGenericBSpline(data,1) <<  TestDataFloat::createFixedDegreeGenericBSpline<1>(data);
+    QTest::newRow("cubic") <<   TestDataFloat::createGenericBSpline(data,3) <<  TestDataFloat::createFixedDegreeGenericBSpline<3>(data);
+    QTest::newRow("quintic") << TestDataFloat::createGenericBSpline(data,5) <<  TestDataFloat::createFixedDegreeGenericBSpline<5>(data);
+    QTest::newRow("septic") <<  TestDataFloat::createGenericBSpline(data,7) <<  TestDataFloat::createFixedDegreeGenericBSpline<7>(data);
+
+    //runtime degrees this high don't fit in the stack workspace, so this also compares the heap workspace against the stack workspace
+    QTest::newRow("degree17") << TestDataFloat::createGenericBSpline(data,17) << TestDataFloat::createFixedDegreeGenericBSpline<17>(data);
+}
+
+void TestSpline::testGenericBFixedDegree(void)
+{
+    QFETCH(std::shared_ptr<Spline<Vector2>>, runtimeDegree);
+    QFETCH(std::shared_ptr<Spline<Vector2>>, fixedDegree);
+
+    QCOMPARE(fixedDegree->getMaxT(), runtimeDegree->getMaxT());
+    QCOMPARE(fixedDegree->segmentCount(), runtimeDegree->segmentCount());
+
+    //both versions run exactly the same math, so the results should be identical
+    for(float t = 0; t < runtimeDegree->getMaxT(); t += 0.15f)
+    {
+        auto expected = runtimeDegree->getWiggle(t);
+        auto actual = fixedDegree->getWiggle(t);
+
+        QCOMPARE(actual.position, expected.position);
+        QCOMPARE(actual.tangent, expected.tangent);
+        QCOMPARE(actual.curvature, expected.curvature);
+        QCOMPARE(actual.wiggle, expected.wiggle);
+    }
+
+    QCOMPARE(fixedDegree->totalLength(), runtimeDegree->totalLength());
+}
+
+
+void TestSpline::testUniformKnots_data(void)
+{
+    QTest::addColumn<std::shared_ptr<Spline<Vector2>>>("storedKnots");
+    QTest::addColumn<std::shared_ptr<Spline<Vector2>>>("uniformKnots");
+
+    auto data = TestDataFloat::generateRandomData(10);
+
+    QTest::newRow("catmullRom") <<          TestDataFloat::createCatmullRom(data, 0.0f) <<              TestDataFloat::createCatmullRom<true>(data, 0.0f);
+    QTest::newRow("cubicHermite") <<        TestDataFloat::createCubicHermite(data, 0.0f) <<            TestDataFloat::createCubicHermite<true>(data, 0.0f);
+    QTest::newRow("quinticCatmullRom") <<   TestDataFloat::createQuinticCatmullRom(data, 0.0f) <<       TestDataFloat::createQuinticCatmullRom<true>(data, 0.0f);
+    QTest::newRow("quinticHermite") <<      TestDataFloat::createQuinticHermite(data, 0.0f) <<          TestDataFloat::createQuinticHermite<true>(data, 0.0f);
+    QTest::newRow("natural") <<             TestDataFloat::createNatural(data, true, 0.0f) <<           TestDataFloat::createNatural<true>(data, true, 0.0f);
+    QTest::newRow("notAKnot") <<            TestDataFloat::createNotAKnot(data, false, 0.0f) <<         TestDataFloat::createNotAKnot<true>(data, false, 0.0f);
+
+    QTest::newRow("loopingCatmullRom") <<   std::shared_ptr<Spline<Vector2>>(TestDataFloat::createLoopingCatmullRom(data, 0.0f))
+                                       <<   std::shared_ptr<Spline<Vector2>>(TestDataFloat::createLoopingCatmullRom<true>(data, 0.0f));
+    QTest::newRow("loopingQuintic") <<      std::shared_ptr<Spline<Vector2>>(TestDataFloat::createLoopingQuinticHermite(data, 0.0f))
+                                    <<      std::shared_ptr<Spline<Vector2>>(TestDataFloat::createLoopingQuinticHermite<true>(data, 0.0f));
+    QTest::newRow("loopingNatural") <<      std::shared_ptr<Spline<Vector2>>(TestDataFloat::createLoopingNatural(data, 0.0f))
+                                    <<      std::shared_ptr<Spline<Vector2>>(TestDataFloat::createLoopingNatural<true>(data, 0.0f));
+}
+
+void TestSpline::testUniformKnots(void)
+{
+    QFETCH(std::shared_ptr<Spline<Vector2>>, storedKnots);
+    QFETCH(std::shared_ptr<Spline<Vector2>>, uniformKnots);
+
+    QCOMPARE(uniformKnots->getMaxT(), storedKnots->getMaxT());
+    QCOMPARE(uniformKnots->segmentCount(), storedKnots->segmentCount());
+    for(size_t i = 0; i <= storedKnots->segmentCount(); i++)
+    {
+        QCOMPARE(uniformKnots->segmentT(i), storedKnots->segmentT(i));
+    }
+
+    //with alpha == 0, the stored knots are exact integers and every T distance is exactly 1, so the results should be identical
+    for(float t = -0.5f; t < storedKnots->getMaxT() + 0.5f; t += 0.15f)
+    {
+        QCOMPARE(uniformKnots->segmentForT(t), storedKnots->segmentForT(t));
+
+        auto expected = storedKnots->getWiggle(t);
+        auto actual = uniformKnots->getWiggle(t);
+
+        QCOMPARE(actual.position, expected.position);
+        QCOMPARE(actual.tangent, expected.tangent);
+        QCOMPARE(actual.curvature, expected.curvature);
+        QCOMPARE(actual.wiggle, expected.wiggle);
+    }
+
+    QCOMPARE(uniformKnots->totalLength(), storedKnots->totalLength());
+}
+
+
+namespace
+{
+    //everything about a fixed spline should be usable in a constant expression when InterpolationType's arithmetic is constexpr
+    constexpr std::array<double, 5> fixedPoints = {{ 0.0, 1.0, 4.0, 9.0, 16.0 }};
+    constexpr FixedUniformCRSpline<double, 5, double> constexprCR(fixedPoints);
+    constexpr LoopingFixedUniformCubicBSpline<double, 5, double> constexprLoopingB(fixedPoints);
+
+    static_assert(constexprCR.getMaxT() == 2.0, "fixed spline maxT should be usable at compile time");
+    static_assert(constexprCR.getPosition(0.0) == 1.0 && constexprCR.getPosition(1.0) == 4.0, "a catmull-rom spline should pass through its points at compile time");
+    static_assert(constexprCR.getTangent(0.5).tangent > 0.0, "fixed spline tangents should be usable at compile time");
+    static_assert(constexprLoopingB.getPosition(-1.0) == constexprLoopingB.getPosition(4.0), "looping fixed splines should wrap t at compile time");
+
+    template<class FixedSplineT>
+    void compareFixedSpline(const FixedSplineT &fixedSpline, const Spline<Vector2> &expected)
+    {
+        QCOMPARE(fixedSpline.getMaxT(), expected.getMaxT());
+        QCOMPARE(fixedSpline.segmentCount(), expected.segmentCount());
+        QCOMPARE(fixedSpline.isLooping(), expected.isLooping());
+        QCOMPARE(std::vector<Vector2>(fixedSpline.getOriginalPoints().begin(), fixedSpline.getOriginalPoints().end()), expected.getOriginalPoints());
+
+        //both use exactly the same math on exactly the same points, so the results should be identical
+        //stay in range, because the std::vector-based looping splines wrap t with std::fmod, which can round differently
+        for(float t = 0; t < expected.getMaxT(); t += 0.15f)
+        {
+            QCOMPARE(fixedSpline.segmentForT(t), expected.segmentForT(t));
+
+            auto expectedResult = expected.getWiggle(t);
+            auto actual = fixedSpline.getWiggle(t);
+
+            QCOMPARE(actual.position, expectedResult.position);
+            QCOMPARE(actual.tangent, expectedResult.tangent);
+            QCOMPARE(actual.curvature, expectedResult.curvature);
+            QCOMPARE(actual.wiggle, expectedResult.wiggle);
+        }
+
+        //out of range t values should be clamped for regular splines, and wrapped for looping splines
+        float maxT = expected.getMaxT();
+        for(float t = 0.1f; t < maxT; t += 0.8f)
+        {
+            if(fixedSpline.isLooping())
+            {
+                QVERIFY((fixedSpline.getPosition(t + maxT) - fixedSpline.getPosition(t)).length() < 1e-3f);
+                QVERIFY((fixedSpline.getPosition(t - maxT) - fixedSpline.getPosition(t)).length() < 1e-3f);
+            }
+            else
+            {
+                QCOMPARE(fixedSpline.segmentForT(-t), size_t(0));
+                QCOMPARE(fixedSpline.segmentForT(maxT + t), fixedSpline.segmentCount() - 1);
+            }
+        }
+    }
+}
+
+void TestSpline::testFixedUniformSplines(void)
+{
+    auto data = TestDataFloat::generateRandomData(10);
+
+    std::array<Vector2, 10> fixedData;
+    std::copy(data.begin(), data.end(), fixedData.begin());
+
+    compareFixedSpline(FixedUniformCRSpline<Vector2, 10>(fixedData), UniformCRSpline<Vector2>(data));
+    compareFixedSpline(FixedUniformCubicBSpline<Vector2, 10>(fixedData), UniformCubicBSpline<Vector2>(data));
+    compareFixedSpline(LoopingFixedUniformCRSpline<Vector2, 10>(fixedData), LoopingUniformCRSpline<Vector2>(data));
+    compareFixedSpline(LoopingFixedUniformCubicBSpline<Vector2, 10>(fixedData), LoopingUniformCubicBSpline<Vector2>(data));
+}
+
+
+void TestSpline::testSlidingWindowSplines(void)
+{
+    auto data = TestDataFloat::generateRandomData(20);
+    auto tangents = TestDataFloat::generateRandomData(20, 11);
+
+    //with a sample interval of 1, the window's t is the reference spline's t plus the window's offset, which is exact in float, so the results should be identical
+    SlidingWindowUniformCRSpline<Vector2> crWindow(8);
+    size_t emptyFootprint = crWindow.memoryFootprint();
+    for(size_t pushed = 1; pushed <= data.size(); pushed++)
+    {
+        crWindow.push(data[pushed - 1]);
+
+        size_t windowSize = std::min(pushed, size_t(8));
+        QCOMPARE(crWindow.pointCount(), windowSize);
+        if(windowSize < 4)
+        {
+            QCOMPARE(crWindow.segmentCount(), size_t(0));
+            continue;
+        }
+
+        std::vector<Vector2> windowPoints(data.begin() + (pushed - windowSize), data.begin() + pushed);
+        for(size_t i = 0; i < windowSize; i++)
+        {
+            QCOMPARE(crWindow.windowPoint(i), windowPoints[i]);
+        }
+
+        UniformCRSpline<Vector2> expected(windowPoints);
+        float offset = float(pushed - windowSize + 1);
+        QCOMPARE(crWindow.segmentCount(), expected.segmentCount());
+        QCOMPARE(crWindow.getMinT(), offset);
+        QCOMPARE(crWindow.getMaxT(), offset + expected.getMaxT());
+
+        for(float t = 0; t <= expected.getMaxT(); t += 0.125f)
+        {
+            QCOMPARE(crWindow.segmentForT(t + offset), expected.segmentForT(t));
+
+            auto expectedResult = expected.getWiggle(t);
+            auto actual = crWindow.getWiggle(t + offset);
+            QCOMPARE(actual.position, expectedResult.position);
+            QCOMPARE(actual.tangent, expectedResult.tangent);
+            QCOMPARE(actual.curvature, expectedResult.curvature);
+            QCOMPARE(actual.wiggle, expectedResult.wiggle);
+        }
+        compareFloatsLenient(crWindow.totalLength(), expected.totalLength(), 1e-5f);
+    }
+
+    //the ring buffer is allocated up front, so pushing never allocates
+    QCOMPARE(crWindow.memoryFootprint(), emptyFootprint);
+
+    //with a different interval and start time, t is scaled and shifted, so the tangents are in terms of the window's t
+    const float interval = 0.25f;
+    const float startTime = 10;
+    SlidingWindowCubicHermiteSpline<Vector2> hermiteWindow(6, interval, startTime);
+    for(size_t pushed = 1; pushed <= data.size(); pushed++)
+    {
+        hermiteWindow.push(data[pushed - 1], tangents[pushed - 1]);
+
+        size_t windowSize = std::min(pushed, size_t(6));
+        if(windowSize < 2)
+        {
+            QCOMPARE(hermiteWindow.segmentCount(), size_t(0));
+            continue;
+        }
+
+        //the reference spline's t is in samples, so its tangents are the window's tangents times the interval
+        std::vector<Vector2> windowPoints(data.begin() + (pushed - windowSize), data.begin() + pushed);
+        std::vector<Vector2> windowTangents;
+        for(size_t i = pushed - windowSize; i < pushed; i++)
+        {
+            windowTangents.push_back(tangents[i] * interval);
+        }
+
+        CubicHermiteSpline<Vector2> expected(windowPoints, windowTangents);
+        float minT = startTime + (pushed - windowSize) * interval;
+        QCOMPARE(hermiteWindow.segmentCount(), expected.segmentCount());
+        QCOMPARE(hermiteWindow.getMinT(), minT);
+        QCOMPARE(hermiteWindow.getMaxT(), minT + expected.getMaxT() * interval);
+
+        for(float t = 0; t <= expected.getMaxT(); t += 0.125f)
+        {
+            float windowT = minT + t * interval;
+            QCOMPARE(hermiteWindow.segmentForT(windowT), expected.segmentForT(t));
+
+            auto expectedResult = expected.getWiggle(t);
+            auto actual = hermiteWindow.getWiggle(windowT);
+            QVERIFY((actual.position - expectedResult.position).length() < 1e-4f);
+            QVERIFY((actual.tangent * interval - expectedResult.tangent).length() < 1e-3f);
+            QVERIFY((actual.curvature * (interval * interval) - expectedResult.curvature).length() < 1e-2f);
+            QVERIFY((actual.wiggle * (interval * interval * interval) - expectedResult.wiggle).length() < 1e-1f);
+        }
+
+        //arc length doesn't depend on how t is scaled
+        compareFloatsLenient(hermiteWindow.totalLength(), expected.totalLength(), 1e-5f);
+        compareFloatsLenient(hermiteWindow.arcLength(minT + interval / 2, hermiteWindow.getMaxT()), expected.arcLength(0.5f, expected.getMaxT()), 1e-5f);
+    }
+}
+
+
+namespace
+{
+    typedef Vector<2, double> Vector2d;
+
+    template<class MixedSplineT, class DoubleSplineT>
+    void compareMixedPrecision(const MixedSplineT &mixed, const DoubleSplineT &reference, double tolerance)
+    {
+        QCOMPARE(mixed.getMaxT(), reference.getMaxT());
+        QCOMPARE(mixed.segmentCount(), reference.segmentCount());
+
+        //t values this large can't even be represented to within a thousandth in single precision
+        std::minstd_rand gen(5);
+        std::uniform_real_distribution<double> distribution(0, reference.getMaxT());
+        std::vector<double> tValues;
+        for(size_t i = 0; i < 200; i++)
+        {
+            tValues.push_back(distribution(gen));
+        }
+        tValues.push_back(reference.getMaxT() - 0.123);
+        if(reference.isLooping())
+        {
+            tValues.push_back(reference.getMaxT() * 3 + 0.123);
+            tValues.push_back(-reference.getMaxT() + 0.123);
+        }
+
+        for(double t : tValues)
+        {
+            auto expected = reference.getTangent(t);
+            auto actual = mixed.getTangent(t);
+            for(size_t d = 0; d < 2; d++)
+            {
+                QVERIFY(std::abs(actual.position[d] - expected.position[d]) < tolerance);
+                QVERIFY(std::abs(actual.tangent[d] - expected.tangent[d]) < tolerance);
+            }
+        }
+
+        double expectedLength = reference.totalLength();
+        QVERIFY(std::abs(mixed.totalLength() - expectedLength) < expectedLength * 1e-6);
+    }
+}
+
+//call the ArcLength functions on the spline's own type, so that the template arguments are deduced from the concrete class rather than from Spline
+template<class SplineT, class ReferenceT>
+void compareConcreteArcLength(const SplineT &spline, const ReferenceT &reference)
+{
+    float maxT = reference.getMaxT();
+    float a = maxT * 0.2f;
+    float b = maxT * 0.7f;
+
+    compareFloatsLenient(ArcLength::arcLength(spline, a, b), ArcLength::arcLength(reference, a, b), 1e-5f);
+    compareFloatsLenient(ArcLength::totalLength(spline), ArcLength::totalLength(reference), 1e-5f);
+
+    float length = ArcLength::arcLength(reference, a, b);
+    compareFloatsLenient(ArcLength::solveLength(spline, a, length), ArcLength::solveLength(reference, a, length), 1e-4f);
+}
+
+//partition builds an arc length table, which needs a Spline, so only the Spline subclasses support it
+template<class SplineT, class ReferenceT>
+void compareConcretePartition(const SplineT &spline, const ReferenceT &reference)
+{
+    compareConcreteArcLength(spline, reference);
+
+    auto pieces = ArcLength::partitionN(spline, 5);
+    auto expectedPieces = ArcLength::partitionN(reference, 5);
+    QCOMPARE(pieces.size(), expectedPieces.size());
+    for(size_t i = 0; i < pieces.size(); i++) {
+        compareFloatsLenient(pieces[i], expectedPieces[i], 1e-4f);
+    }
+}
+
+template<class SplineT, class ReferenceT>
+void compareConcreteArcLengthCyclic(const SplineT &spline, const ReferenceT &reference)
+{
+    compareConcretePartition(spline, reference);
+
+    float maxT = reference.getMaxT();
+    float a = maxT * 0.7f;
+    float b = maxT * 1.2f;
+
+    compareFloatsLenient(ArcLength::cyclicArcLength(spline, a, b), ArcLength::cyclicArcLength(reference, a, b), 1e-5f);
+
+    float length = ArcLength::totalLength(reference) * 0.6f;
+    compareFloatsLenient(ArcLength::solveLengthCyclic(spline, a, length), ArcLength::solveLengthCyclic(reference, a, length), 1e-4f);
+}
+
+void TestSpline::testArcLengthConcreteTypes(void)
+{
+    auto data = TestDataFloat::generateRandomData(12);
+    auto tangents = TestDataFloat::generateRandomData(12, 11);
+    auto curvatures = TestDataFloat::generateRandomData(12, 23);
+
+    //every template parameter list the splines use: two parameters, plus a bool for the knot type or a size_t for the degree
+    UniformCRSpline<Vector2> uniformCR(data);
+    compareConcretePartition(uniformCR, static_cast<const Spline<Vector2>&>(uniformCR));
+    UniformCubicBSpline<Vector2> uniformB(data);
+    compareConcretePartition(uniformB, static_cast<const Spline<Vector2>&>(uniformB));
+    NaturalSpline<Vector2> natural(data);
+    compareConcretePartition(natural, static_cast<const Spline<Vector2>&>(natural));
+    NaturalSpline<Vector2, float, true> naturalUniform(data);
+    compareConcretePartition(naturalUniform, static_cast<const Spline<Vector2>&>(naturalUniform));
+    CubicHermiteSpline<Vector2> cubicHermite(data, tangents);
+    compareConcretePartition(cubicHermite, static_cast<const Spline<Vector2>&>(cubicHermite));
+    CubicHermiteSpline<Vector2, float, true> cubicHermiteUniform(data, tangents);
+    compareConcretePartition(cubicHermiteUniform, static_cast<const Spline<Vector2>&>(cubicHermiteUniform));
+    QuinticHermiteSpline<Vector2> quinticHermite(data, tangents, curvatures);
+    compareConcretePartition(quinticHermite, static_cast<const Spline<Vector2>&>(quinticHermite));
+    QuinticHermiteSpline<Vector2, float, true> quinticHermiteUniform(data, tangents, curvatures);
+    compareConcretePartition(quinticHermiteUniform, static_cast<const Spline<Vector2>&>(quinticHermiteUniform));
+    GenericBSpline<Vector2> genericB(data, 5);
+    compareConcretePartition(genericB, static_cast<const Spline<Vector2>&>(genericB));
+    GenericBSpline<Vector2, float, 3> genericBFixed(data);
+    compareConcretePartition(genericBFixed, static_cast<const Spline<Vector2>&>(genericBFixed));
+    CompiledSpline<Vector2> compiled(natural);
+    compareConcretePartition(compiled, static_cast<const Spline<Vector2>&>(compiled));
+
+    LoopingUniformCRSpline<Vector2> loopingUniformCR(data);
+    compareConcreteArcLengthCyclic(loopingUniformCR, static_cast<const LoopingSpline<Vector2>&>(loopingUniformCR));
+    LoopingUniformCubicBSpline<Vector2> loopingUniformB(data);
+    compareConcreteArcLengthCyclic(loopingUniformB, static_cast<const LoopingSpline<Vector2>&>(loopingUniformB));
+    LoopingNaturalSpline<Vector2> loopingNatural(data);
+    compareConcreteArcLengthCyclic(loopingNatural, static_cast<const LoopingSpline<Vector2>&>(loopingNatural));
+    LoopingNaturalSpline<Vector2, float, true> loopingNaturalUniform(data);
+    compareConcreteArcLengthCyclic(loopingNaturalUniform, static_cast<const LoopingSpline<Vector2>&>(loopingNaturalUniform));
+    LoopingCubicHermiteSpline<Vector2> loopingCubicHermite(data, tangents);
+    compareConcreteArcLengthCyclic(loopingCubicHermite, static_cast<const LoopingSpline<Vector2>&>(loopingCubicHermite));
+    LoopingCubicHermiteSpline<Vector2, float, true> loopingCubicHermiteUniform(data, tangents);
+    compareConcreteArcLengthCyclic(loopingCubicHermiteUniform, static_cast<const LoopingSpline<Vector2>&>(loopingCubicHermiteUniform));
+    LoopingQuinticHermiteSpline<Vector2> loopingQuinticHermite(data, tangents, curvatures);
+    compareConcreteArcLengthCyclic(loopingQuinticHermite, static_cast<const LoopingSpline<Vector2>&>(loopingQuinticHermite));
+    LoopingQuinticHermiteSpline<Vector2, float, true> loopingQuinticHermiteUniform(data, tangents, curvatures);
+    compareConcreteArcLengthCyclic(loopingQuinticHermiteUniform, static_cast<const LoopingSpline<Vector2>&>(loopingQuinticHermiteUniform));
+    LoopingGenericBSpline<Vector2> loopingGenericB(data, 5);
+    compareConcreteArcLengthCyclic(loopingGenericB, static_cast<const LoopingSpline<Vector2>&>(loopingGenericB));
+    LoopingGenericBSpline<Vector2, float, 5> loopingGenericBFixed(data);
+    compareConcreteArcLengthCyclic(loopingGenericBFixed, static_cast<const LoopingSpline<Vector2>&>(loopingGenericBFixed));
+    LoopingCompiledSpline<Vector2> loopingCompiled(loopingNatural);
+    compareConcreteArcLengthCyclic(loopingCompiled, static_cast<const LoopingSpline<Vector2>&>(loopingCompiled));
+
+    //the sliding window splines don't inherit from Spline, so compare against the std::vector-based spline with the same points
+    //the catmull-rom window's first segment begins at the second point, so a start time of -1 lines its t values up with the reference spline's
+    SlidingWindowUniformCRSpline<Vector2> crWindow(data.size(), 1, -1);
+    for(const auto &point : data) {
+        crWindow.push(point);
+    }
+    compareConcreteArcLength(crWindow, uniformCR);
+
+    SlidingWindowCubicHermiteSpline<Vector2> hermiteWindow(data.size());
+    for(size_t i = 0; i < data.size(); i++) {
+        hermiteWindow.push(data[i], tangents[i]);
+    }
+    compareConcreteArcLength(hermiteWindow, cubicHermite);
+}
+
+void TestSpline::testMixedPrecision(void)
+{
+    //a closed track 100km around, with a point roughly every meter
+    const size_t size = 100000;
+    const double radius = 16000;
+    constexpr double pi = 3.14159265358979323846;
+
+    std::vector<Vector2> points(size);
+    for(size_t i = 0; i < size; i++)
+    {
+        double angle = 2 * pi * i / size;
+        double wobble = 3 * std::sin(angle * 997);
+        points[i] = Vector2({float((radius + wobble) * std::cos(angle)), float((radius + wobble) * std::sin(angle))});
+    }
+
+    //start from exactly the same points, so that the only difference is the precision of everything else
+    //this is a separate pass so the optimizer can't hand us the unrounded double values it just converted to float
+    std::vector<Vector2d> doublePoints;
+    doublePoints.reserve(size);
+    for(const Vector2 &point : points)
+    {
+        doublePoints.push_back(Vector2d({point[0], point[1]}));
+    }
+
+    //single precision points can only be relied on to about a hundredth of a meter at this distance from the origin
+    const double tolerance = 0.01;
+
+    compareMixedPrecision(LoopingUniformCRSpline<Vector2, double>(points), LoopingUniformCRSpline<Vector2d, double>(doublePoints), tolerance);
+    compareMixedPrecision(UniformCubicBSpline<Vector2, double>(points), UniformCubicBSpline<Vector2d, double>(doublePoints), tolerance);
+    compareMixedPrecision(LoopingCubicHermiteSpline<Vector2, double>(points, 0.5), LoopingCubicHermiteSpline<Vector2d, double>(doublePoints, 0.5), tolerance);
+    compareMixedPrecision(NaturalSpline<Vector2, double>(points, true, 0.5), NaturalSpline<Vector2d, double>(doublePoints, true, 0.5), tolerance);
+}
+
+
+
 void TestSpline::testSegmentArcLength_data(void)
 {
     QTest::addColumn<std::shared_ptr<Spline<Vector2>>>("spline");
@@ -371,3 +839,2148 @@ void TestSpline::testSegmentArcLengthCyclic(void)
         compareFloatsLenient(integrated2ndDerivative + 1, expected2ndDerivativeResult + 1, 0.0001f);
     }
 }
+
+
+
+//helper for the batch evaluation tests: evaluate every T in the list with both the batch and single-value methods and verify that they match
+//the batch methods do exactly the same math as the single-value methods, so results should be identical, not just close
+template<class SplineT>
+void compareBatchEvaluation(const SplineT &spline, const std::vector<float> &tValues)
+{
+    std::vector<Vector2> positions(tValues.size());
+    std::vector<Spline<Vector2>::InterpolatedPT> tangents(tValues.size());
+    std::vector<Spline<Vector2>::InterpolatedPTC> curvatures(tValues.size());
+    std::vector<Spline<Vector2>::InterpolatedPTCW> wiggles(tValues.size());
+
+    spline.getPositions(tValues.data(), tValues.size(), positions.data());
+    spline.getTangents(tValues.data(), tValues.size(), tangents.data());
+    spline.getCurvatures(tValues.data(), tValues.size(), curvatures.data());
+    spline.getWiggles(tValues.data(), tValues.size(), wiggles.data());
+
+    for(size_t i = 0; i < tValues.size(); i++)
+    {
+        auto expected = spline.getWiggle(tValues[i]);
+
+        QCOMPARE(positions[i], expected.position);
+
+        QCOMPARE(tangents[i].position, expected.position);
+        QCOMPARE(tangents[i].tangent, expected.tangent);
+
+        QCOMPARE(curvatures[i].position, expected.position);
+        QCOMPARE(curvatures[i].tangent, expected.tangent);
+        QCOMPARE(curvatures[i].curvature, expected.curvature);
+
+        QCOMPARE(wiggles[i].position, expected.position);
+        QCOMPARE(wiggles[i].tangent, expected.tangent);
+        QCOMPARE(wiggles[i].curvature, expected.curvature);
+        QCOMPARE(wiggles[i].wiggle, expected.wiggle);
+    }
+}
+
+void TestSpline::testBatchEvaluation_data(void)
+{
+    QTest::addColumn<std::shared_ptr<Spline<Vector2>>>("spline");
+
+    auto data = TestDataFloat::generateRandomData(10);
+
+    QTest::newRow("uniformCR") <<           TestDataFloat::createUniformCR(data);
+    QTest::newRow("catmullRomAlpha") <<     TestDataFloat::createCatmullRom(data, 0.5f);
+    QTest::newRow("cubicHermite") <<        TestDataFloat::createCubicHermite(data, 0.0f);
+    QTest::newRow("quinticHermiteAlpha") << TestDataFloat::createQuinticHermite(data, 0.5f);
+    QTest::newRow("naturalAlpha") <<        TestDataFloat::createNatural(data, true, 0.5f);
+    QTest::newRow("naturalNotAKnot") <<     TestDataFloat::createNotAKnot(data, true, 0.0f);
+    QTest::newRow("uniformB") <<            TestDataFloat::createUniformBSpline(data);
+    QTest::newRow("genericBQuintic") <<     TestDataFloat::createGenericBSpline(data, 5);
+}
+
+void TestSpline::testBatchEvaluation(void)
+{
+    QFETCH(std::shared_ptr<Spline<Vector2>>, spline);
+
+    //sorted T values, including every segment boundary and the endpoints
+    std::vector<float> sortedT;
+    for(size_t i = 0; i < spline->segmentCount(); i++)
+    {
+        for(float fraction: {0.0f, 0.1f, 0.5f, 0.9f})
+        {
+            sortedT.push_back(lerp(spline->segmentT(i), spline->segmentT(i + 1), fraction));
+        }
+    }
+    sortedT.push_back(spline->getMaxT());
+    compareBatchEvaluation(*spline, sortedT);
+
+    //reversed and shuffled T values, so that the segment hint is usually wrong
+    std::vector<float> reversedT(sortedT.rbegin(), sortedT.rend());
+    compareBatchEvaluation(*spline, reversedT);
+
+    std::vector<float> shuffledT = sortedT;
+    std::shuffle(shuffledT.begin(), shuffledT.end(), std::minstd_rand(10));
+    compareBatchEvaluation(*spline, shuffledT);
+}
+
+void TestSpline::testBatchEvaluationCyclic_data(void)
+{
+    QTest::addColumn<std::shared_ptr<LoopingSpline<Vector2>>>("spline");
+
+    auto data = TestDataFloat::generateRandomData(10);
+
+    QTest::newRow("uniformCR") <<           TestDataFloat::createLoopingUniformCR(data);
+    QTest::newRow("catmullRomAlpha") <<     TestDataFloat::createLoopingCatmullRom(data, 0.5f);
+    QTest::newRow("quinticHermiteAlpha") << TestDataFloat::createLoopingQuinticHermite(data, 0.5f);
+    QTest::newRow("naturalAlpha") <<        TestDataFloat::createLoopingNatural(data, 0.5f);
+    QTest::newRow("uniformB") <<            TestDataFloat::createLoopingUniformBSpline(data);
+    QTest::newRow("genericBQuintic") <<     TestDataFloat::createLoopingGenericBSpline(data, 5);
+}
+
+void TestSpline::testBatchEvaluationCyclic(void)
+{
+    QFETCH(std::shared_ptr<LoopingSpline<Vector2>>, spline);
+
+    //go around the spline several times, in both directions, so that T values need to be wrapped
+    //this also produces more T values than fit in one wrapped chunk
+    float maxT = spline->getMaxT();
+    std::vector<float> tValues;
+    for(float t = -2 * maxT; t < 2 * maxT; t += 0.3f)
+    {
+        tValues.push_back(t);
+    }
+    compareBatchEvaluation(*spline, tValues);
+
+    std::shuffle(tValues.begin(), tValues.end(), std::minstd_rand(10));
+    compareBatchEvaluation(*spline, tValues);
+}
+
+
+
+//helper for the compiled spline tests: compare two vectors, allowing an error proportional to the expected vector's length
+//this way values near zero can be compared without the error blowing up, unlike compareFloatsLenient
+void compareVectorsLenient(const Vector2 &actual, const Vector2 &expected, float tolerance)
+{
+    float error = (actual - expected).length() / (1 + expected.length());
+    if(error > tolerance) {
+        std::string errorMessage = QString("Compared vectors were different. Actual: (%1, %2), Expected: (%3, %4)")
+                .arg(QString::number(actual[0]), QString::number(actual[1]), QString::number(expected[0]), QString::number(expected[1])).toStdString();
+        QFAIL(errorMessage.data());
+    }
+}
+
+//helper for comparing two splines that should be identical except for floating point error, like a compiled spline and its source
+template<class SplineT>
+void compareSplinesLenient(const SplineT &actualSpline, const SplineT &expectedSpline, float beginT, float endT, float toleranceScale)
+{
+    for(float t = beginT; t < endT; t += 0.07f)
+    {
+        auto expected = expectedSpline.getWiggle(t);
+        auto actual = actualSpline.getWiggle(t);
+
+        compareVectorsLenient(actual.position, expected.position, 0.00001f * toleranceScale);
+        compareVectorsLenient(actual.tangent, expected.tangent, 0.0001f * toleranceScale);
+        compareVectorsLenient(actual.curvature, expected.curvature, 0.001f * toleranceScale);
+        compareVectorsLenient(actual.wiggle, expected.wiggle, 0.01f * toleranceScale);
+    }
+}
+
+void TestSpline::testCompiledSpline_data(void)
+{
+    QTest::addColumn<std::shared_ptr<Spline<Vector2>>>("source");
+    QTest::addColumn<std::shared_ptr<Spline<Vector2>>>("compiled");
+
+    //the higher degree fits are solved from float samples with a worse conditioned matrix, so they get more slack
+    //extrapolating them past the ends also amplifies that error quickly, so they're only compared inside the spline
+    QTest::addColumn<float>("toleranceScale");
+    QTest::addColumn<float>("extrapolation");
+
+    auto data = TestDataFloat::generateRandomData(10);
+
+    auto rowFunction = [](const char *name, std::shared_ptr<Spline<Vector2>> source, std::shared_ptr<Spline<Vector2>> compiled, float toleranceScale) {
+        float extrapolation = toleranceScale > 1 ? 0.0f : 0.5f;
+        QTest::newRow(name) << source << compiled << toleranceScale << extrapolation;
+    };
+
+    auto uniformCR = TestDataFloat::createUniformCR(data);
+    auto uniformB = TestDataFloat::createUniformBSpline(data);
+    auto cubicHermite = TestDataFloat::createCubicHermite(data, 0.5f);
+    auto natural = TestDataFloat::createNatural(data, true, 0.5f);
+    auto quinticHermite = TestDataFloat::createQuinticHermite(data, 0.5f);
+    auto genericB5 = TestDataFloat::createGenericBSpline(data, 5);
+    auto genericB7 = TestDataFloat::createGenericBSpline(data, 7);
+
+    rowFunction("uniformCR",        uniformCR,      std::make_shared<CompiledSpline<Vector2>>(*uniformCR), 1.0f);
+    rowFunction("uniformCubicB",    uniformB,       std::make_shared<CompiledSpline<Vector2>>(*uniformB), 1.0f);
+    rowFunction("cubicHermite",     cubicHermite,   std::make_shared<CompiledSpline<Vector2>>(*cubicHermite), 1.0f);
+    rowFunction("natural",          natural,        std::make_shared<CompiledSpline<Vector2>>(*natural), 1.0f);
+    rowFunction("quinticHermite",   quinticHermite, std::make_shared<CompiledSpline<Vector2, float, 5>>(*quinticHermite), 50.0f);
+    rowFunction("genericB5",        genericB5,      std::make_shared<CompiledSpline<Vector2, float, 5>>(*genericB5), 50.0f);
+    rowFunction("genericB7",        genericB7,      std::make_shared<CompiledSpline<Vector2, float, 7>>(*genericB7), 50.0f);
+
+    //a higher degree than necessary should still give the same result
+    rowFunction("uniformCR (degree 7)", uniformCR,  std::make_shared<CompiledSpline<Vector2, float, 7>>(*uniformCR), 50.0f);
+}
+
+void TestSpline::testCompiledSpline(void)
+{
+    QFETCH(std::shared_ptr<Spline<Vector2>>, source);
+    QFETCH(std::shared_ptr<Spline<Vector2>>, compiled);
+    QFETCH(float, toleranceScale);
+    QFETCH(float, extrapolation);
+
+    QCOMPARE(compiled->getMaxT(), source->getMaxT());
+    QCOMPARE(compiled->segmentCount(), source->segmentCount());
+    QCOMPARE(compiled->isLooping(), false);
+    for(size_t i = 0; i <= source->segmentCount(); i++)
+    {
+        QCOMPARE(compiled->segmentT(i), source->segmentT(i));
+    }
+
+    //go a little past the ends, to make sure the end segments extrapolate the same way
+    compareSplinesLenient(*compiled, *source, -extrapolation, source->getMaxT() + extrapolation, toleranceScale);
+
+    QCOMPARE(compiled->totalLength(), source->totalLength());
+
+    compareBatchEvaluation(*compiled, std::vector<float>{0.0f, 0.5f, 1.5f, 2.25f, 2.25f, 7.0f, 3.0f});
+
+    //the compiled spline should be completely independent of its source, so compiling a temporary should work
+    CompiledSpline<Vector2, float, 7> independent(*TestDataFloat::createGenericBSpline(TestDataFloat::generateRandomData(10), 3));
+    QVERIFY(independent.totalLength() > 0);
+}
+
+void TestSpline::testCompiledSplineCyclic_data(void)
+{
+    QTest::addColumn<std::shared_ptr<LoopingSpline<Vector2>>>("source");
+    QTest::addColumn<std::shared_ptr<LoopingSpline<Vector2>>>("compiled");
+    QTest::addColumn<float>("toleranceScale");
+
+    auto data = TestDataFloat::generateRandomData(10);
+
+    auto uniformCR = TestDataFloat::createLoopingUniformCR(data);
+    auto natural = TestDataFloat::createLoopingNatural(data, 0.5f);
+    auto quinticHermite = TestDataFloat::createLoopingQuinticHermite(data, 0.5f);
+    auto genericB5 = TestDataFloat::createLoopingGenericBSpline(data, 5);
+
+    QTest::newRow("uniformCR") <<       uniformCR <<        std::shared_ptr<LoopingSpline<Vector2>>(std::make_shared<LoopingCompiledSpline<Vector2>>(*uniformCR)) << 1.0f;
+    QTest::newRow("natural") <<         natural <<          std::shared_ptr<LoopingSpline<Vector2>>(std::make_shared<LoopingCompiledSpline<Vector2>>(*natural)) << 1.0f;
+    QTest::newRow("quinticHermite") <<  quinticHermite <<   std::shared_ptr<LoopingSpline<Vector2>>(std::make_shared<LoopingCompiledSpline<Vector2, float, 5>>(*quinticHermite)) << 50.0f;
+    QTest::newRow("genericB5") <<       genericB5 <<        std::shared_ptr<LoopingSpline<Vector2>>(std::make_shared<LoopingCompiledSpline<Vector2, float, 5>>(*genericB5)) << 50.0f;
+}
+
+void TestSpline::testCompiledSplineCyclic(void)
+{
+    QFETCH(std::shared_ptr<LoopingSpline<Vector2>>, source);
+    QFETCH(std::shared_ptr<LoopingSpline<Vector2>>, compiled);
+    QFETCH(float, toleranceScale);
+
+    float maxT = source->getMaxT();
+
+    QCOMPARE(compiled->getMaxT(), maxT);
+    QCOMPARE(compiled->segmentCount(), source->segmentCount());
+    QCOMPARE(compiled->isLooping(), true);
+
+    compareSplinesLenient(*compiled, *source, -maxT, maxT * 2, toleranceScale);
+
+    QCOMPARE(compiled->totalLength(), source->totalLength());
+    QCOMPARE(compiled->cyclicArcLength(maxT * 0.75f, maxT * 1.25f), source->cyclicArcLength(maxT * 0.75f, maxT * 1.25f));
+}
+
+void TestSpline::testInverterBatch_data(void)
+{
+    QTest::addColumn<std::shared_ptr<Spline<Vector2>>>("spline");
+    QTest::addColumn<size_t>("threadCount");
+
+    auto data = TestDataFloat::generateRandomData(10);
+    auto uniformCR = TestDataFloat::createUniformCR(data);
+    std::shared_ptr<Spline<Vector2>> loopingNatural = TestDataFloat::createLoopingNatural(data, 0.5f);
+
+    QTest::newRow("uniformCR (1 thread)") <<        uniformCR <<        size_t(1);
+    QTest::newRow("uniformCR (4 threads)") <<       uniformCR <<        size_t(4);
+    QTest::newRow("uniformCR (default)") <<         uniformCR <<        size_t(0);
+    QTest::newRow("loopingNatural (4 threads)") <<  loopingNatural <<   size_t(4);
+}
+
+void TestSpline::testInverterBatch(void)
+{
+    QFETCH(std::shared_ptr<Spline<Vector2>>, spline);
+    QFETCH(size_t, threadCount);
+
+    SplineInverter<Vector2> inverter(*spline);
+
+    //a shuffled grid of query points, so that each thread gets a mix of near and far queries
+    std::vector<Vector2> queries;
+    for(int y = 0; y < 40; y++)
+    {
+        for(int x = 0; x < 40; x++)
+        {
+            queries.push_back(Vector2({x * 0.25f - 2, y * 0.25f - 2}));
+        }
+    }
+    std::shuffle(queries.begin(), queries.end(), std::mt19937(5));
+
+    std::vector<float> results(queries.size());
+    inverter.findClosestT(queries.data(), queries.size(), results.data(), threadCount);
+
+    for(size_t i = 0; i < queries.size(); i++)
+    {
+        QCOMPARE(results[i], inverter.findClosestT(queries[i]));
+    }
+
+    //an empty batch should be fine too
+    inverter.findClosestT(queries.data(), 0, results.data(), threadCount);
+}
+
+void TestSpline::testInverterCoherent_data(void)
+{
+    QTest::addColumn<std::shared_ptr<Spline<Vector2>>>("spline");
+    QTest::addColumn<bool>("selfIntersecting");
+
+    auto data = TestDataFloat::generateRandomData(10);
+    QTest::newRow("uniformCR") <<       TestDataFloat::createUniformCR(data) << false;
+    QTest::newRow("cubicHermite") <<    TestDataFloat::createCubicHermite(data, 0.5f) << false;
+    QTest::newRow("uniformBSpline") <<  TestDataFloat::createUniformBSpline(data) << false;
+    QTest::newRow("loopingNatural") <<  std::shared_ptr<Spline<Vector2>>(TestDataFloat::createLoopingNatural(data, 0.5f)) << true;
+    QTest::newRow("circle") <<          std::shared_ptr<Spline<Vector2>>(TestDataFloat::createCircularGenericBSpline(12, 3, 5)) << false;
+}
+
+void TestSpline::testInverterCoherent(void)
+{
+    QFETCH(std::shared_ptr<Spline<Vector2>>, spline);
+    QFETCH(bool, selfIntersecting);
+
+    SplineInverter<Vector2> inverter(*spline);
+
+    //follow a point that wobbles along next to the spline. the spline might pass closer to the point somewhere else,
+    //but the point is tracking this part of the spline, so the result should stay with it
+    std::minstd_rand gen(5);
+    std::uniform_real_distribution<float> wobble(-0.05f, 0.05f);
+    float hintT = 0;
+    for(float t = 0; t < spline->getMaxT(); t += 0.03f)
+    {
+        Vector2 position = spline->getPosition(t);
+        Vector2 queryPoint = position + Vector2({wobble(gen), wobble(gen)});
+
+        float actualT = inverter.findClosestT(queryPoint, hintT);
+        QVERIFY(actualT >= 0 && actualT <= spline->getMaxT());
+        QVERIFY((spline->getPosition(actualT) - queryPoint).length() <= (position - queryPoint).length() + 1e-4f);
+        QVERIFY(std::abs(actualT - t) < 0.1f || std::abs(actualT - t) > spline->getMaxT() - 0.1f);
+
+        hintT = actualT;
+    }
+
+    if(!spline->isLooping())
+    {
+        //a point past either end should snap to that end
+        auto start = spline->getTangent(0);
+        QCOMPARE(inverter.findClosestT(start.position - start.tangent * 0.5f, 0.1f), 0.0f);
+
+        auto end = spline->getTangent(spline->getMaxT());
+        QCOMPARE(inverter.findClosestT(end.position + end.tangent * 0.5f, spline->getMaxT() - 0.1f), spline->getMaxT());
+    }
+
+    //a hint too far away from the closest point should be rejected, giving exactly the same result as the global search
+    //this only works if the spline doesn't cross itself, otherwise the hint might be near some other part of the spline that's just as good
+    if(spline->isLooping() && !selfIntersecting)
+    {
+        //hints outside [0, maxT] should be wrapped around, not clamped
+        for(float t = 0; t < spline->getMaxT(); t += 0.25f)
+        {
+            Vector2 queryPoint = spline->getPosition(t) * 1.01f;
+            float expectedT = inverter.findClosestT(queryPoint);
+            QCOMPARE(inverter.findClosestT(queryPoint, t + 1), expectedT);
+            QCOMPARE(inverter.findClosestT(queryPoint, t - 1), expectedT);
+            QCOMPARE(inverter.findClosestT(queryPoint, t + spline->getMaxT() * 2 + 1), expectedT);
+        }
+    }
+}
+
+namespace
+{
+    //check every kind of SplineBoundsTree query against brute force over a dense set of samples
+    template<class InterpolationType, size_t dimension>
+    void verifyBoundsTree(const Spline<InterpolationType> &spline, unsigned seed)
+    {
+        SplineBoundsTree<InterpolationType, float, dimension> tree(spline);
+        QVERIFY(tree.pieceCount() >= spline.segmentCount());
+
+        std::vector<float> sampleTs;
+        std::vector<InterpolationType> samples;
+        for(size_t i = 0; i <= 20000; i++)
+        {
+            sampleTs.push_back(spline.getMaxT() * i / 20000);
+            samples.push_back(spline.getPosition(sampleTs.back()));
+        }
+
+        //query points spread over the whole area around the spline
+        InterpolationType boundsMin = samples[0], boundsMax = samples[0];
+        for(const auto &sample : samples)
+        {
+            for(size_t d = 0; d < dimension; d++)
+            {
+                boundsMin[d] = std::min(boundsMin[d], sample[d]);
+                boundsMax[d] = std::max(boundsMax[d], sample[d]);
+            }
+        }
+        std::minstd_rand gen(seed);
+        auto randomPoint = [&]() {
+            InterpolationType result;
+            for(size_t d = 0; d < dimension; d++)
+                result[d] = std::uniform_real_distribution<float>(boundsMin[d] - 2, boundsMax[d] + 2)(gen);
+            return result;
+        };
+
+        for(size_t i = 0; i < 50; i++)
+        {
+            InterpolationType queryPoint = randomPoint();
+
+            float bruteForceDistance = std::numeric_limits<float>::infinity();
+            for(const auto &sample : samples)
+                bruteForceDistance = std::min(bruteForceDistance, (sample - queryPoint).length());
+
+            float t = tree.findClosestT(queryPoint);
+            QVERIFY(t >= 0 && t <= spline.getMaxT());
+            QVERIFY((spline.getPosition(t) - queryPoint).length() <= bruteForceDistance + 1e-4f);
+        }
+
+        auto contains = [](const std::vector<std::pair<float, float>> &ranges, float t) {
+            for(const auto &range : ranges)
+            {
+                if(range.first <= t && t <= range.second)
+                    return true;
+            }
+            return false;
+        };
+
+        for(size_t i = 0; i < 20; i++)
+        {
+            InterpolationType a = randomPoint(), b = randomPoint();
+            InterpolationType boxMin, boxMax;
+            for(size_t d = 0; d < dimension; d++)
+            {
+                boxMin[d] = std::min(a[d], b[d]);
+                boxMax[d] = std::max(a[d], b[d]);
+            }
+
+            auto ranges = tree.findTRangesInBox(boxMin, boxMax);
+            for(size_t s = 1; s < ranges.size(); s++)
+                QVERIFY(ranges[s - 1].second < ranges[s].first);
+
+            for(size_t s = 0; s < samples.size(); s++)
+            {
+                bool inside = true;
+                for(size_t d = 0; d < dimension; d++)
+                    inside = inside && boxMin[d] <= samples[s][d] && samples[s][d] <= boxMax[d];
+                if(inside)
+                    QVERIFY(contains(ranges, sampleTs[s]));
+            }
+        }
+
+        for(size_t i = 0; i < 20; i++)
+        {
+            InterpolationType origin = randomPoint();
+            InterpolationType direction = randomPoint() - origin;
+            float radius = 0.5f;
+
+            auto ranges = tree.findTRangesNearRay(origin, direction, radius);
+            for(size_t s = 0; s < samples.size(); s++)
+            {
+                float along = std::max(InterpolationType::dotProduct(samples[s] - origin, direction) / direction.lengthSquared(), 0.0f);
+                if((origin + direction * along - samples[s]).length() <= radius)
+                    QVERIFY(contains(ranges, sampleTs[s]));
+            }
+        }
+    }
+}
+
+void TestSpline::testInverterRefit(void)
+{
+    auto data = TestDataFloat::generateRandomData(30);
+    auto tangents = TestDataFloat::makeTangents(data);
+    CubicHermiteSpline<Vector2> spline(data, tangents);
+    SplineInverter<Vector2> inverter(spline);
+
+    std::minstd_rand gen(9);
+    std::uniform_real_distribution<float> distribution(0, 7);
+    std::vector<Vector2> queryPoints(500);
+    for(Vector2 &queryPoint : queryPoints)
+        queryPoint = Vector2({distribution(gen), distribution(gen)});
+
+    //a new inverter samples the spline the same way a refit does, so the results should be identical
+    auto compareWithNewInverter = [&]() {
+        SplineInverter<Vector2> expected(spline);
+        for(const Vector2 &queryPoint : queryPoints)
+            QCOMPARE(inverter.findClosestT(queryPoint), expected.findClosestT(queryPoint));
+    };
+
+    //moving a hermite point only changes the two segments that touch it. with uniform knots, no t values change
+    //moving every point replaces enough samples to make the tree merge its patch and rebuild at least once, and the ones after that are moved twice
+    std::vector<size_t> editIndexes = {0, 7, 15, 29, 7};
+    for(size_t index = 0; index < data.size(); index++)
+        editIndexes.push_back(index);
+    for(size_t index : editIndexes)
+    {
+        spline.setPoint(index, spline.getOriginalPoints()[index] + Vector2({0.5f, -0.25f}), tangents[index]);
+        inverter.refit(index > 0 ? index - 1 : 0, std::min(index + 1, spline.segmentCount()));
+        compareWithNewInverter();
+    }
+
+    //inserting a point makes the spline longer, so every sample after it moves, and a refit falls back to resampling everything
+    spline.insertPoint(10, Vector2({1, 1}), Vector2({0, 1}));
+    inverter.refit(9, 11);
+    compareWithNewInverter();
+
+    spline.rebuild(TestDataFloat::generateRandomData(12, 4));
+    inverter.rebuild();
+    compareWithNewInverter();
+
+    //refitting every segment of a short spline leaves nothing in the tree but replaced samples
+    CubicHermiteSpline<Vector2> shortSpline(TestDataFloat::generateRandomData(3, 6), TestDataFloat::makeTangents(TestDataFloat::generateRandomData(3, 6)));
+    SplineInverter<Vector2> shortInverter(shortSpline);
+    shortSpline.setPoint(1, Vector2({1, 1}), Vector2({1, 0}));
+    shortInverter.refit(0, shortSpline.segmentCount());
+    SplineInverter<Vector2> expectedShort(shortSpline);
+    for(const Vector2 &queryPoint : queryPoints)
+        QCOMPARE(shortInverter.findClosestT(queryPoint), expectedShort.findClosestT(queryPoint));
+}
+
+void TestSpline::testBoundsTree_data(void)
+{
+    QTest::addColumn<std::shared_ptr<Spline<Vector2>>>("spline");
+
+    auto data = TestDataFloat::generateRandomData(10);
+    QTest::newRow("uniformCR") <<           TestDataFloat::createUniformCR(data);
+    QTest::newRow("catmullRom") <<          TestDataFloat::createCatmullRom(data, 0.5f);
+    QTest::newRow("quinticHermite") <<      TestDataFloat::createQuinticHermite(data, 0.5f);
+    QTest::newRow("natural") <<             TestDataFloat::createNatural(data, true, 0.5f);
+    QTest::newRow("uniformBSpline") <<      TestDataFloat::createUniformBSpline(data);
+    QTest::newRow("genericBSpline5") <<     TestDataFloat::createGenericBSpline(data, 5);
+    QTest::newRow("loopingNatural") <<      std::shared_ptr<Spline<Vector2>>(TestDataFloat::createLoopingNatural(data, 0.5f));
+    QTest::newRow("circle") <<              std::shared_ptr<Spline<Vector2>>(TestDataFloat::createCircularQuinticHermite(12, 5));
+}
+
+void TestSpline::testBoundsTree(void)
+{
+    QFETCH(std::shared_ptr<Spline<Vector2>>, spline);
+    verifyBoundsTree<Vector2, 2>(*spline, 5);
+}
+
+void TestSpline::testBoundsTree3D(void)
+{
+    std::minstd_rand gen(7);
+    std::uniform_real_distribution<float> distribution(-5, 5);
+    std::vector<Vector3> points(12);
+    for(auto &point : points)
+        point = Vector3({distribution(gen), distribution(gen), distribution(gen)});
+
+    verifyBoundsTree<Vector3, 3>(UniformCRSpline<Vector3>(points), 6);
+    verifyBoundsTree<Vector3, 3>(LoopingCubicHermiteSpline<Vector3>(points, 0.5f), 7);
+}
+
+void TestSpline::testSegmentBounds_data(void)
+{
+    testBoundsTree_data();
+}
+
+void TestSpline::testSegmentBounds(void)
+{
+    QFETCH(std::shared_ptr<Spline<Vector2>>, spline);
+    SplineSegmentBounds<Vector2> bounds(*spline);
+
+    //dense samples of every segment. the box has to contain all of them, and since it comes from the exact extremes, the furthest samples have to reach its sides
+    const size_t samplesPerSegment = 2000;
+    std::vector<std::vector<Vector2>> segmentSamples(spline->segmentCount());
+    for(size_t i = 0; i < spline->segmentCount(); i++)
+    {
+        float beginT = spline->segmentT(i), endT = spline->segmentT(i + 1);
+        const auto &box = bounds.segmentBounds(i);
+        float size = std::max((box.max - box.min).length(), 1e-3f);
+
+        Vector2 sampleMin = spline->getPositionInSegment(i, beginT), sampleMax = sampleMin;
+        for(size_t k = 0; k <= samplesPerSegment; k++)
+        {
+            Vector2 sample = spline->getPositionInSegment(i, beginT + (endT - beginT) * k / samplesPerSegment);
+            segmentSamples[i].push_back(sample);
+            for(size_t d = 0; d < 2; d++)
+            {
+                QVERIFY(sample[d] >= box.min[d] - size * 1e-5f && sample[d] <= box.max[d] + size * 1e-5f);
+                sampleMin[d] = std::min(sampleMin[d], sample[d]);
+                sampleMax[d] = std::max(sampleMax[d], sample[d]);
+            }
+        }
+        for(size_t d = 0; d < 2; d++)
+        {
+            QVERIFY(sampleMin[d] - box.min[d] <= size * 1e-4f);
+            QVERIFY(box.max[d] - sampleMax[d] <= size * 1e-4f);
+        }
+
+        //the derivative along each axis is zero at each extremum
+        for(size_t d = 0; d < 2; d++)
+        {
+            std::array<float, SplineSegmentBounds<Vector2>::maxExtremaPerAxis> extrema;
+            size_t extremaCount = bounds.segmentExtrema(i, d, extrema.data());
+            std::vector<float> extremaTs(extrema.begin(), extrema.begin() + extremaCount);
+            QVERIFY(std::is_sorted(extremaTs.begin(), extremaTs.end()));
+
+            float maxSpeed = 0;
+            for(size_t k = 0; k <= 16; k++)
+                maxSpeed = std::max(maxSpeed, std::abs(spline->getTangentInSegment(i, beginT + (endT - beginT) * k / 16).tangent[d]));
+            for(float t : extremaTs)
+            {
+                QVERIFY(t >= beginT && t <= endT);
+                QVERIFY(std::abs(spline->getTangentInSegment(i, t).tangent[d]) <= maxSpeed * 1e-3f + 1e-4f);
+            }
+        }
+    }
+
+    //the whole spline's box, and the box of any range of segments, is exactly the merge of the segments' boxes
+    std::minstd_rand gen(8);
+    std::uniform_int_distribution<size_t> segmentDistribution(0, spline->segmentCount() - 1);
+    for(size_t q = 0; q < 100; q++)
+    {
+        size_t begin = segmentDistribution(gen), end = segmentDistribution(gen);
+        if(begin > end)
+            std::swap(begin, end);
+        end++;
+        if(q == 0)
+        {
+            begin = 0;
+            end = spline->segmentCount();
+        }
+
+        auto expected = bounds.segmentBounds(begin);
+        for(size_t i = begin + 1; i < end; i++)
+        {
+            for(size_t d = 0; d < 2; d++)
+            {
+                expected.min[d] = std::min(expected.min[d], bounds.segmentBounds(i).min[d]);
+                expected.max[d] = std::max(expected.max[d], bounds.segmentBounds(i).max[d]);
+            }
+        }
+        auto actual = bounds.segmentRangeBounds(begin, end);
+        QCOMPARE(actual.min, expected.min);
+        QCOMPARE(actual.max, expected.max);
+        if(q == 0)
+        {
+            QCOMPARE(bounds.getBounds().min, expected.min);
+            QCOMPARE(bounds.getBounds().max, expected.max);
+        }
+    }
+
+    //a t range's box contains every sample in the range, and is no bigger than the segments it touches
+    std::uniform_real_distribution<float> tDistribution(0, spline->getMaxT());
+    for(size_t q = 0; q < 50; q++)
+    {
+        float a = tDistribution(gen), b = tDistribution(gen);
+        auto box = bounds.getBounds(a, b);
+        if(a > b)
+            std::swap(a, b);
+
+        auto outer = bounds.segmentRangeBounds(spline->segmentForT(a), spline->segmentForT(b) + 1);
+        float size = std::max((outer.max - outer.min).length(), 1e-3f);
+        for(size_t d = 0; d < 2; d++)
+        {
+            QVERIFY(box.min[d] >= outer.min[d] && box.max[d] <= outer.max[d]);
+        }
+        for(size_t k = 0; k <= 1000; k++)
+        {
+            Vector2 sample = spline->getPosition(a + (b - a) * k / 1000);
+            for(size_t d = 0; d < 2; d++)
+                QVERIFY(sample[d] >= box.min[d] - size * 1e-5f && sample[d] <= box.max[d] + size * 1e-5f);
+        }
+    }
+
+    //culling against a box finds exactly the segments whose boxes overlap it, and so every segment with a sample inside it
+    auto whole = bounds.getBounds();
+    std::uniform_real_distribution<float> unitDistribution(0, 1);
+    for(size_t q = 0; q < 50; q++)
+    {
+        Vector2 corner, extent;
+        for(size_t d = 0; d < 2; d++)
+        {
+            corner[d] = whole.min[d] + (whole.max[d] - whole.min[d]) * unitDistribution(gen);
+            extent[d] = (whole.max[d] - whole.min[d]) * unitDistribution(gen) * 0.25f;
+        }
+        Vector2 boxMax = corner + extent;
+
+        std::vector<size_t> expected;
+        for(size_t i = 0; i < spline->segmentCount(); i++)
+        {
+            const auto &segmentBox = bounds.segmentBounds(i);
+            bool overlaps = true;
+            for(size_t d = 0; d < 2; d++)
+                overlaps = overlaps && segmentBox.max[d] >= corner[d] && segmentBox.min[d] <= boxMax[d];
+            if(overlaps)
+                expected.push_back(i);
+        }
+        QCOMPARE(bounds.findSegmentsInBox(corner, boxMax), expected);
+
+        for(size_t i = 0; i < spline->segmentCount(); i++)
+        {
+            for(const Vector2 &sample : segmentSamples[i])
+            {
+                bool inside = sample[0] >= corner[0] && sample[0] <= boxMax[0] && sample[1] >= corner[1] && sample[1] <= boxMax[1];
+                if(inside)
+                    QVERIFY(std::binary_search(expected.begin(), expected.end(), i));
+            }
+        }
+    }
+}
+
+void TestSpline::testLodTable_data(void)
+{
+    testBoundsTree_data();
+}
+
+void TestSpline::testLodTable(void)
+{
+    QFETCH(std::shared_ptr<Spline<Vector2>>, spline);
+    typedef SplineLodTable<Vector2> LodTable;
+
+    //denser than the checks the table measures its error with, and offset from them
+    std::vector<float> tValues;
+    std::vector<Spline<Vector2>::InterpolatedPT> expected;
+    for(size_t i = 0; i <= 9973; i++)
+    {
+        tValues.push_back(spline->getMaxT() * i / 9973);
+        expected.push_back(spline->getTangent(tValues.back()));
+    }
+
+    size_t sampleCount = spline->segmentCount() * 16 + 1;
+    float errors[2][2];
+    for(int cubic = 0; cubic < 2; cubic++)
+    {
+        for(int quantized = 0; quantized < 2; quantized++)
+        {
+            LodTable table(*spline, sampleCount, cubic ? LodTable::Cubic : LodTable::Linear, quantized);
+            QCOMPARE(table.sampleCount(), sampleCount);
+            QVERIFY(table.measuredPositionError() > 0);
+            QVERIFY(table.relativePositionError() > 0 && table.relativePositionError() < 1);
+
+            //the reported errors are from a sparser set of checks, so they can be under the true largest errors, but not by much
+            float denseError = 0, tangentError = 0, maxSpeed = 0;
+            for(size_t i = 0; i < tValues.size(); i++)
+            {
+                auto result = table.getTangent(tValues[i]);
+                denseError = std::max(denseError, (result.position - expected[i].position).length());
+                tangentError = std::max(tangentError, (result.tangent - expected[i].tangent).length());
+                maxSpeed = std::max(maxSpeed, expected[i].tangent.length());
+                QVERIFY((table.getPosition(tValues[i]) - result.position).length() <= table.measuredPositionError() * 1e-3f + 1e-5f);
+            }
+            QVERIFY(denseError <= table.measuredPositionError() * 1.25f + 1e-5f);
+            QVERIFY(tangentError <= maxSpeed * (cubic ? 0.05f : 0.5f));
+            QVERIFY(table.measuredTangentError() > 0);
+            QVERIFY(tangentError <= table.measuredTangentError() * 2 + 1e-5f);
+            errors[cubic][quantized] = table.measuredPositionError();
+
+            //quantization halves the memory with floats
+            if(quantized)
+            {
+                LodTable unquantized(*spline, sampleCount, cubic ? LodTable::Cubic : LodTable::Linear, false);
+                QVERIFY(table.memoryFootprint() < unquantized.memoryFootprint());
+            }
+
+            //wrapping for looping splines, clamping otherwise
+            float t = tValues[1234];
+            if(spline->isLooping())
+                QVERIFY((table.getPosition(t + spline->getMaxT()) - table.getPosition(t)).length() <= table.measuredPositionError());
+            else
+                QCOMPARE(table.getPosition(-1), table.getPosition(0));
+        }
+    }
+    QVERIFY(errors[1][0] < errors[0][0]);
+
+    //quantization only adds a tiny fraction of the size of the spline to the error
+    for(int cubic = 0; cubic < 2; cubic++)
+    {
+        LodTable table(*spline, sampleCount, cubic ? LodTable::Cubic : LodTable::Linear, true);
+        QVERIFY(errors[cubic][1] <= errors[cubic][0] + table.measuredPositionError() / table.relativePositionError() * 1e-4f);
+    }
+
+    //withMaxError meets its budget, without being much bigger than it needs to be
+    for(int cubic = 0; cubic < 2; cubic++)
+    {
+        LodTable reference(*spline, sampleCount, LodTable::Cubic);
+        float budget = reference.measuredPositionError() / reference.relativePositionError() * 1e-3f;
+        LodTable table = LodTable::withMaxError(*spline, budget, cubic ? LodTable::Cubic : LodTable::Linear);
+        QVERIFY(table.measuredPositionError() <= budget);
+
+        LodTable half(*spline, (table.sampleCount() - 1) / 2 + 1, cubic ? LodTable::Cubic : LodTable::Linear);
+        QVERIFY(table.sampleCount() <= spline->segmentCount() * 2 + 1 || half.measuredPositionError() > budget);
+    }
+}
+
+void TestSpline::testTessellation_data(void)
+{
+    QTest::addColumn<std::shared_ptr<Spline<Vector2>>>("spline");
+    QTest::addColumn<float>("maxChordError");
+    QTest::addColumn<float>("maxAngle");
+
+    auto data = TestDataFloat::generateRandomData(10);
+    auto rowFunction = [](const char *name, std::shared_ptr<Spline<Vector2>> spline) {
+        QTest::newRow(QString("%1 (chord)").arg(name).toStdString().data()) << spline << 0.01f << 0.0f;
+        QTest::newRow(QString("%1 (angle)").arg(name).toStdString().data()) << spline << 0.0f << 0.05f;
+        QTest::newRow(QString("%1 (both)").arg(name).toStdString().data()) << spline << 0.05f << 0.1f;
+    };
+
+    rowFunction("uniformCR",        TestDataFloat::createUniformCR(data));
+    rowFunction("natural",          TestDataFloat::createNatural(data, true, 0.5f));
+    rowFunction("quinticHermite",   TestDataFloat::createQuinticHermite(data, 0.5f));
+    rowFunction("genericBSpline5",  TestDataFloat::createGenericBSpline(data, 5));
+    rowFunction("loopingNatural",   std::shared_ptr<Spline<Vector2>>(TestDataFloat::createLoopingNatural(data, 0.5f)));
+}
+
+void TestSpline::testTessellation(void)
+{
+    QFETCH(std::shared_ptr<Spline<Vector2>>, spline);
+    QFETCH(float, maxChordError);
+    QFETCH(float, maxAngle);
+
+    size_t count = Tessellation::countPoints(*spline, maxChordError, maxAngle);
+    QVERIFY(count > spline->segmentCount());
+
+    std::vector<Vector2> positions(count), tangents(count);
+    std::vector<float> tValues(count);
+    QCOMPARE(Tessellation::tessellate(*spline, maxChordError, maxAngle, positions.data(), count, tValues.data(), tangents.data()), count);
+
+    QCOMPARE(tValues.front(), 0.0f);
+    QCOMPARE(tValues.back(), spline->getMaxT());
+    for(size_t i = 0; i < count; i++)
+    {
+        auto expected = spline->getTangent(tValues[i]);
+        QVERIFY((positions[i] - expected.position).length() < 1e-4f);
+        QVERIFY((tangents[i] - expected.tangent).length() < 1e-3f);
+    }
+
+    for(size_t i = 0; i + 1 < count; i++)
+    {
+        QVERIFY(tValues[i] < tValues[i + 1]);
+
+        //sample the spline between each pair of points, and make sure it stays within the tolerances of the line segment between them
+        Vector2 line = positions[i + 1] - positions[i];
+        for(int sample = 1; sample < 16; sample++)
+        {
+            float t = tValues[i] + (tValues[i + 1] - tValues[i]) * sample / 16;
+            auto actual = spline->getTangent(t);
+
+            if(maxChordError > 0)
+            {
+                float projection = std::min(std::max(Vector2::dotProduct(actual.position - positions[i], line) / line.lengthSquared(), 0.0f), 1.0f);
+                QVERIFY((positions[i] + line * projection - actual.position).length() <= maxChordError + 1e-4f);
+            }
+            //near a cusp the tangent turns too fast for any amount of subdivision to follow, so the tessellator stops at a tiny line segment instead
+            if(maxAngle > 0 && line.length() > 1e-3f)
+            {
+                float cosAngle = Vector2::dotProduct(actual.tangent.normalized(), line.normalized());
+                QVERIFY(std::acos(std::min(cosAngle, 1.0f)) <= maxAngle + 1e-3f);
+            }
+        }
+    }
+
+    //a buffer that's too small should get the beginning of the same polyline, and still report the full size
+    std::vector<Vector2> partialPositions(count / 2);
+    std::vector<float> partialTValues(count / 2);
+    QCOMPARE(Tessellation::tessellate(*spline, maxChordError, maxAngle, partialPositions.data(), partialPositions.size(), partialTValues.data()), count);
+    for(size_t i = 0; i < partialPositions.size(); i++)
+    {
+        QCOMPARE(partialTValues[i], tValues[i]);
+        QVERIFY(partialPositions[i] == positions[i]);
+    }
+}
+
+void TestSpline::testFixedStepSampler_data(void)
+{
+    QTest::addColumn<std::shared_ptr<Spline<Vector2>>>("spline");
+    QTest::addColumn<int>("degree");
+
+    auto data = TestDataFloat::generateRandomData(10);
+    QTest::newRow("uniformCR")          << TestDataFloat::createUniformCR(data) << 3;
+    QTest::newRow("uniformBSpline")     << TestDataFloat::createUniformBSpline(data) << 3;
+    QTest::newRow("cubicHermite")       << TestDataFloat::createCubicHermite(data, 0.5f) << 3;
+    QTest::newRow("natural")            << TestDataFloat::createNatural(data, true, 0.5f) << 3;
+    QTest::newRow("quinticHermite")     << TestDataFloat::createQuinticHermite(data, 0.5f) << 5;
+    QTest::newRow("genericBSpline5")    << TestDataFloat::createGenericBSpline(data, 5) << 5;
+    QTest::newRow("cubicAsQuintic")     << TestDataFloat::createUniformCR(data) << 5;
+    QTest::newRow("loopingNatural")     << std::shared_ptr<Spline<Vector2>>(TestDataFloat::createLoopingNatural(data, 0.5f)) << 3;
+}
+
+void TestSpline::testFixedStepSampler(void)
+{
+    QFETCH(std::shared_ptr<Spline<Vector2>>, spline);
+    QFETCH(int, degree);
+
+    //the polynomial form of each segment is only as precise as the spline's coordinates
+    float scale = 0;
+    for(size_t i = 0; i <= spline->segmentCount(); i++)
+        scale = std::max(scale, spline->getPosition(spline->segmentT(i)).length());
+    float tolerance = std::max(scale, 1.0f) * 1e-5f;
+
+    //enough samples per segment to restart the differences several times
+    for(size_t samplesPerSegment : {1, 7, 300})
+    {
+        size_t count = FixedStepSampler::sampleCount(*spline, samplesPerSegment);
+        QCOMPARE(count, spline->segmentCount() * samplesPerSegment + 1);
+
+        std::vector<Vector2> positions(count), tangents(count);
+        std::vector<float> tValues(count);
+        size_t written = degree == 3
+                ? FixedStepSampler::sample<3>(*spline, samplesPerSegment, positions.data(), tValues.data(), tangents.data())
+                : FixedStepSampler::sample<5>(*spline, samplesPerSegment, positions.data(), tValues.data(), tangents.data());
+        QCOMPARE(written, count);
+
+        QCOMPARE(tValues.front(), 0.0f);
+        QCOMPARE(tValues.back(), spline->getMaxT());
+        for(size_t i = 0; i < count; i++)
+        {
+            auto expected = spline->getTangent(tValues[i]);
+            QVERIFY((positions[i] - expected.position).length() <= tolerance);
+            QVERIFY((tangents[i] - expected.tangent).length() <= std::max(expected.tangent.length(), 1.0f) * 1e-3f);
+        }
+
+        //the positions alone should be the same as the positions written alongside the tangents
+        std::vector<Vector2> positionsOnly(count);
+        if(degree == 3)
+            FixedStepSampler::sample<3>(*spline, samplesPerSegment, positionsOnly.data());
+        else
+            FixedStepSampler::sample<5>(*spline, samplesPerSegment, positionsOnly.data());
+        QVERIFY(positionsOnly == positions);
+
+        //each segment should begin and end exactly where the spline does
+        for(size_t segment = 0; segment < spline->segmentCount(); segment++)
+        {
+            QVERIFY(positions[segment * samplesPerSegment] == spline->getPositionInSegment(segment, spline->segmentT(segment)));
+        }
+        QVERIFY(positions.back() == spline->getPositionInSegment(spline->segmentCount() - 1, spline->getMaxT()));
+    }
+}
+
+namespace
+{
+    typedef RotationMinimizingFrames<Vector3>::Frame Frame3;
+
+    //check that every frame is orthonormal and right handed, that it's on the spline, that its tangent is the spline's, and that it barely twists on the way to the next frame
+    void verifyFrames(const Spline<Vector3> &spline, const std::vector<Frame3> &frames)
+    {
+        float twist = 0;
+        for(size_t i = 0; i < frames.size(); i++)
+        {
+            const Frame3 &frame = frames[i];
+            QVERIFY(std::abs(frame.tangent.length() - 1) < 1e-5f);
+            QVERIFY(std::abs(frame.normal.length() - 1) < 1e-5f);
+            QVERIFY(std::abs(Vector3::dotProduct(frame.tangent, frame.normal)) < 1e-5f);
+            QVERIFY(std::abs(Vector3::dotProduct(frame.tangent, frame.binormal)) < 1e-5f);
+            QVERIFY(std::abs(Vector3::dotProduct(frame.normal, frame.binormal)) < 1e-5f);
+            Vector3 cross({frame.tangent[1] * frame.normal[2] - frame.tangent[2] * frame.normal[1],
+                           frame.tangent[2] * frame.normal[0] - frame.tangent[0] * frame.normal[2],
+                           frame.tangent[0] * frame.normal[1] - frame.tangent[1] * frame.normal[0]});
+            QVERIFY((frame.binormal - cross).length() < 1e-5f);
+
+            auto expected = spline.getTangent(frame.t);
+            QVERIFY((frame.position - expected.position).length() < 1e-4f);
+            QVERIFY((frame.tangent - expected.tangent.normalized()).length() < 1e-4f);
+
+            //the rotation from one frame to the next may bend the tangent, but shouldn't turn around it
+            if(i > 0)
+                twist += std::abs(Vector3::dotProduct(frames[i - 1].binormal, frame.normal) - Vector3::dotProduct(frames[i - 1].normal, frame.binormal)) / 2;
+        }
+        QVERIFY(twist < 1e-2f);
+    }
+}
+
+void TestSpline::testRotationMinimizingFrames(void)
+{
+    std::minstd_rand gen(3);
+    std::uniform_real_distribution<float> distribution(-5, 5);
+    std::vector<Vector3> points(12), planarPoints(12);
+    for(size_t i = 0; i < points.size(); i++)
+    {
+        points[i] = Vector3({distribution(gen), distribution(gen), distribution(gen)});
+        planarPoints[i] = Vector3({points[i][0], points[i][1], 0});
+    }
+
+    UniformCRSpline<Vector3> uniformCR(points);
+    QuinticHermiteSpline<Vector3> quintic(points, 0.5f);
+    LoopingNaturalSpline<Vector3> loopingNatural(points, 0.5f);
+    for(const Spline<Vector3> *spline : std::initializer_list<const Spline<Vector3>*>{&uniformCR, &quintic, &loopingNatural})
+    {
+        std::vector<Frame3> frames(1000);
+        RotationMinimizingFrames<Vector3>::sampleUniformT(*spline, frames.size(), frames.data(), Vector3({0, 0, 1}));
+        verifyFrames(*spline, frames);
+        QCOMPARE(frames.front().t, 0.0f);
+        QVERIFY(frames[frames.size() - 2].t < frames.back().t || spline->isLooping());
+
+        //sweeping through the same t values one at a time should give exactly the same frames
+        std::vector<float> tValues(frames.size());
+        for(size_t i = 0; i < frames.size(); i++)
+            tValues[i] = frames[i].t;
+        tValues.back() = spline->getMaxT();
+        std::vector<Frame3> sweptFrames(frames.size());
+        RotationMinimizingFrames<Vector3>::sampleT(*spline, tValues.data(), tValues.size(), sweptFrames.data(), Vector3({0, 0, 1}));
+        for(size_t i = 0; i < frames.size(); i++)
+        {
+            QCOMPARE(sweptFrames[i].t, frames[i].t);
+            QVERIFY(sweptFrames[i].normal == frames[i].normal);
+        }
+
+        //frames evenly spaced by arc length should be the same distance apart, and should agree with the frames evenly spaced in t
+        std::vector<Frame3> lengthFrames(2000);
+        RotationMinimizingFrames<Vector3>::sampleUniformLength(*spline, lengthFrames.size(), lengthFrames.data(), Vector3({0, 0, 1}));
+        verifyFrames(*spline, lengthFrames);
+        float totalLength = spline->totalLength();
+        float lengthPerStep = totalLength / (lengthFrames.size() - 1);
+        for(size_t i = 0; i + 1 < lengthFrames.size(); i++)
+            QVERIFY(std::abs(spline->arcLength(0, lengthFrames[i].t) - lengthPerStep * i) <= totalLength * 1e-4f);
+
+        RotationMinimizingFrames<Vector3> generator(*spline, 0, Vector3({0, 0, 1}));
+        for(size_t i = 1; i < lengthFrames.size() - 1; i++)
+        {
+            generator.advance(lengthFrames[i].t - generator.getFrame().t);
+            QVERIFY((generator.getFrame().normal - lengthFrames[i].normal).length() < 1e-2f);
+        }
+    }
+
+    //a spline that stays in a plane never needs to turn its normal out of the plane's normal, even across inflection points, where a frenet frame would flip
+    UniformCRSpline<Vector3> planar(planarPoints);
+    std::vector<Frame3> planarFrames(500);
+    RotationMinimizingFrames<Vector3>::sampleUniformT(planar, planarFrames.size(), planarFrames.data(), Vector3({0, 0, 1}));
+    verifyFrames(planar, planarFrames);
+    for(const Frame3 &frame : planarFrames)
+        QVERIFY((frame.normal - Vector3({0, 0, 1})).length() < 1e-5f);
+
+    //a straight line has no curvature at all, so it has no frenet frame. without an initial normal, any perpendicular normal is fine, as long as it never turns
+    std::vector<Vector3> linePoints(6);
+    for(size_t i = 0; i < linePoints.size(); i++)
+        linePoints[i] = Vector3({float(i), float(i) * 2, float(i) * 3});
+    UniformCRSpline<Vector3> line(linePoints);
+    std::vector<Frame3> lineFrames(50);
+    RotationMinimizingFrames<Vector3>::sampleUniformT(line, lineFrames.size(), lineFrames.data());
+    verifyFrames(line, lineFrames);
+    for(const Frame3 &frame : lineFrames)
+        QVERIFY((frame.normal - lineFrames.front().normal).length() < 1e-5f);
+}
+
+void TestSpline::testSplineFitting(void)
+{
+    //dense samples of a smooth curve
+    UniformCRSpline<Vector2> source(TestDataFloat::generateRandomData(12));
+    std::vector<Vector2> samples(4000);
+    for(size_t i = 0; i < samples.size(); i++)
+        samples[i] = source.getPosition(source.getMaxT() * i / (samples.size() - 1));
+
+    const float tolerance = 0.01f;
+    for(size_t degree : {2, 3, 5})
+    {
+        auto fit = SplineFitting::fit(samples, tolerance, degree);
+        QVERIFY(fit.maxError <= tolerance);
+        QVERIFY(fit.controlPoints.size() * 20 < samples.size());
+        QCOMPARE(fit.knots.size(), fit.controlPoints.size() + degree - 1);
+        QCOMPARE(fit.sampleT.front(), 0.0f);
+
+        //the t values are distances along the samples, so the fitted spline is about as long as the samples' maximum t
+        GenericBSpline<Vector2> spline(fit.controlPoints, fit.knots, degree);
+        QCOMPARE(spline.getMaxT(), fit.sampleT.back());
+        compareFloatsLenient(spline.totalLength(), fit.sampleT.back(), 1e-2f);
+
+        float maxError = 0;
+        for(size_t i = 0; i < samples.size(); i++)
+            maxError = std::max(maxError, (spline.getPosition(fit.sampleT[i]) - samples[i]).length());
+        compareFloatsLenient(maxError, fit.maxError, 1e-3f);
+    }
+
+    auto fixedDegree = SplineFitting::fitGenericBSpline<3>(samples, tolerance);
+    auto fit = SplineFitting::fit(samples, tolerance, 3);
+    for(size_t i = 0; i < samples.size(); i += 10)
+        QVERIFY((fixedDegree.getPosition(fit.sampleT[i]) - samples[i]).length() <= tolerance * 1.001f);
+
+    //a long straight stretch, then a tight half turn, then back, sampled unevenly. the segments should be much shorter in the turn than far away from it
+    std::minstd_rand gen(7);
+    std::uniform_real_distribution<float> spacing(0.01f, 0.05f);
+    std::vector<Vector2> turnSamples;
+    const float straightLength = 50;
+    const float radius = 1;
+    constexpr double pi = 3.14159265358979323846;
+    for(float s = 0; s < straightLength * 2 + float(pi) * radius; s += spacing(gen))
+    {
+        if(s < straightLength)
+            turnSamples.push_back(Vector2({s, 0}));
+        else if(s < straightLength + float(pi) * radius)
+        {
+            float angle = (s - straightLength) / radius;
+            turnSamples.push_back(Vector2({straightLength + std::sin(angle) * radius, radius - std::cos(angle) * radius}));
+        }
+        else
+            turnSamples.push_back(Vector2({straightLength - (s - straightLength - float(pi) * radius), radius * 2}));
+    }
+
+    auto turnFit = SplineFitting::fit(turnSamples, tolerance, 3);
+    QVERIFY(turnFit.maxError <= tolerance);
+    float longestTurnSegment = 0;
+    float shortestStraightSegment = straightLength;
+    for(size_t i = 2; i + 3 < turnFit.knots.size(); i++)
+    {
+        float begin = turnFit.knots[i];
+        float end = turnFit.knots[i + 1];
+        if(begin >= straightLength && end <= straightLength + float(pi) * radius)
+            longestTurnSegment = std::max(longestTurnSegment, end - begin);
+        else if(end <= straightLength / 2)
+            shortestStraightSegment = std::min(shortestStraightSegment, end - begin);
+    }
+    QVERIFY(longestTurnSegment > 0);
+    QVERIFY(longestTurnSegment * 4 < shortestStraightSegment);
+
+    //evenly spaced knots can't do that, so the uniform fit needs more control points for the same tolerance
+    auto uniformFit = SplineFitting::fitUniform(turnSamples, tolerance, 3);
+    QVERIFY(uniformFit.maxError <= tolerance);
+    QVERIFY(uniformFit.controlPoints.size() > turnFit.controlPoints.size());
+
+    UniformCubicBSpline<Vector2> uniform = SplineFitting::fitUniformCubicBSpline(turnSamples, tolerance);
+    QCOMPARE(uniform.getMaxT(), uniformFit.sampleT.back());
+    for(size_t i = 0; i < turnSamples.size(); i++)
+        QVERIFY((uniform.getPosition(uniformFit.sampleT[i]) - turnSamples[i]).length() <= tolerance * 1.001f);
+}
+
+void TestSpline::testGpuSplineBuffer_data(void)
+{
+    QTest::addColumn<std::shared_ptr<Spline<Vector2>>>("spline");
+
+    auto data = TestDataFloat::generateRandomData(10);
+    QTest::newRow("uniformCR") <<           TestDataFloat::createUniformCR(data);
+    QTest::newRow("catmullRom") <<          TestDataFloat::createCatmullRom(data, 0.5f);
+    QTest::newRow("quinticHermite") <<      TestDataFloat::createQuinticHermite(data, 0.5f);
+    QTest::newRow("natural") <<             TestDataFloat::createNatural(data, true, 0.5f);
+    QTest::newRow("uniformBSpline") <<      TestDataFloat::createUniformBSpline(data);
+    QTest::newRow("genericBSpline5") <<     TestDataFloat::createGenericBSpline(data, 5);
+    QTest::newRow("loopingNatural") <<      std::shared_ptr<Spline<Vector2>>(TestDataFloat::createLoopingNatural(data, 0.5f));
+    QTest::newRow("circle") <<              std::shared_ptr<Spline<Vector2>>(TestDataFloat::createCircularQuinticHermite(12, 5));
+}
+
+void TestSpline::testGpuSplineBuffer(void)
+{
+    QFETCH(std::shared_ptr<Spline<Vector2>>, spline);
+
+    //put another spline in front of this one, so that the curve offsets get tested too
+    auto other = TestDataFloat::createUniformCR(TestDataFloat::generateRandomData(7));
+    GpuSplineBuffer<Vector2> buffer;
+    QCOMPARE(buffer.addSpline(*other), size_t(0));
+    QCOMPARE(buffer.addSpline(*spline), size_t(1));
+    QCOMPARE(buffer.curveCount(), size_t(2));
+    QCOMPARE(buffer.segmentData().size(), other->segmentCount() + spline->segmentCount());
+    QCOMPARE(size_t(buffer.curveData()[1].firstSegment), other->segmentCount());
+
+    float scale = 0;
+    for(size_t i = 0; i <= spline->segmentCount(); i++)
+        scale = std::max(scale, spline->getPosition(spline->segmentT(i)).length());
+    float tolerance = std::max(scale, 1.0f) * 1e-4f;
+
+    float maxT = spline->getMaxT();
+    float totalLength = spline->totalLength();
+    QVERIFY(std::abs(buffer.curveData()[1].totalLength - totalLength) <= totalLength * 1e-4f);
+
+    //the looping spline also gets t values outside its range, which should wrap around
+    float beginT = spline->isLooping() ? -maxT : 0;
+    float endT = spline->isLooping() ? maxT * 2 : maxT;
+    for(int i = 0; i <= 200; i++)
+    {
+        float t = beginT + (endT - beginT) * i / 200;
+        auto expected = spline->getTangent(t);
+
+        QVERIFY((buffer.position(1, t) - expected.position).length() <= tolerance);
+
+        Vector2 position, tangent;
+        buffer.tangent(1, t, position, tangent);
+        QVERIFY((position - expected.position).length() <= tolerance);
+        QVERIFY((tangent - expected.tangent).length() <= std::max(expected.tangent.length(), 1.0f) * 1e-3f);
+    }
+
+    //the first spline should still be intact
+    for(int i = 0; i <= 20; i++)
+    {
+        float t = other->getMaxT() * i / 20;
+        QVERIFY((buffer.position(0, t) - other->getPosition(t)).length() <= 1e-3f);
+    }
+
+    //the arc length lookup should land on the same point as the CPU arc length solver
+    for(int i = 0; i <= 50; i++)
+    {
+        float length = totalLength * i / 50;
+        float expectedT = ArcLength::solveLength(*spline, 0.0f, length);
+        Vector2 expected = spline->getPosition(expectedT);
+        QVERIFY((spline->getPosition(buffer.tForLength(1, length)) - expected).length() <= std::max(totalLength, 1.0f) * 1e-4f);
+    }
+}
+
+namespace
+{
+    //compare every kind of evaluation of a spline loaded from an archive against the spline that was written
+    void verifyArchivedSpline(const Spline<Vector2> &expected, const Spline<Vector2> &actual)
+    {
+        QCOMPARE(actual.isLooping(), expected.isLooping());
+        QCOMPARE(actual.getMaxT(), expected.getMaxT());
+        QCOMPARE(actual.segmentCount(), expected.segmentCount());
+        QVERIFY(!actual.hasOriginalPoints());
+
+        for(size_t i = 0; i <= expected.segmentCount(); i++)
+            QCOMPARE(actual.segmentT(i), expected.segmentT(i));
+
+        float scale = 1;
+        for(size_t i = 0; i <= expected.segmentCount(); i++)
+            scale = std::max(scale, expected.getPosition(expected.segmentT(i)).length());
+
+        //looping splines also get t values outside their range, which should wrap around
+        float maxT = expected.getMaxT();
+        float beginT = expected.isLooping() ? -maxT : 0;
+        float endT = expected.isLooping() ? maxT * 2 : maxT;
+        std::vector<float> tValues;
+        for(int i = 0; i <= 200; i++)
+            tValues.push_back(beginT + (endT - beginT) * i / 200);
+
+        for(float t : tValues)
+        {
+            auto expectedResult = expected.getWiggle(t);
+            auto actualResult = actual.getWiggle(t);
+
+            QVERIFY((actualResult.position - expectedResult.position).length() <= scale * 1e-4f);
+            QVERIFY((actualResult.tangent - expectedResult.tangent).length() <= std::max(expectedResult.tangent.length(), 1.0f) * 1e-3f);
+            QVERIFY((actualResult.curvature - expectedResult.curvature).length() <= std::max(expectedResult.curvature.length(), 1.0f) * 1e-2f);
+            QVERIFY((actual.getPosition(t) - actualResult.position).length() <= scale * 1e-5f);
+        }
+
+        std::vector<Vector2> batch(tValues.size());
+        actual.getPositions(tValues.data(), tValues.size(), batch.data());
+        for(size_t i = 0; i < tValues.size(); i++)
+            QVERIFY(batch[i] == actual.getPosition(tValues[i]));
+
+        float expectedLength = expected.totalLength();
+        QVERIFY(std::abs(actual.totalLength() - expectedLength) <= expectedLength * 1e-4f);
+        QVERIFY(std::abs(actual.arcLength(maxT * 0.3f, maxT * 0.8f) - expected.arcLength(maxT * 0.3f, maxT * 0.8f)) <= expectedLength * 1e-4f);
+    }
+
+    std::vector<std::shared_ptr<Spline<Vector2>>> makeArchiveSplines(void)
+    {
+        auto data = TestDataFloat::generateRandomData(10);
+        return std::vector<std::shared_ptr<Spline<Vector2>>>{
+            TestDataFloat::createUniformCR(data),
+            TestDataFloat::createCatmullRom(data, 0.5f),
+            TestDataFloat::createQuinticHermite(data, 0.5f),
+            TestDataFloat::createNatural(data, true, 0.5f),
+            TestDataFloat::createGenericBSpline(data, 5),
+            std::shared_ptr<Spline<Vector2>>(TestDataFloat::createLoopingNatural(data, 0.5f)),
+            std::shared_ptr<Spline<Vector2>>(TestDataFloat::createCircularQuinticHermite(12, 5)),
+        };
+    }
+}
+
+void TestSpline::testSplineArchive_data(void)
+{
+    QTest::addColumn<bool>("includeArcLengths");
+
+    QTest::newRow("with arc lengths") << true;
+    QTest::newRow("without arc lengths") << false;
+}
+
+void TestSpline::testSplineArchive(void)
+{
+    QFETCH(bool, includeArcLengths);
+
+    auto splines = makeArchiveSplines();
+    SplineArchiveWriter<Vector2> writer;
+    for(const auto &spline : splines)
+        writer.addSpline(*spline, includeArcLengths);
+    QCOMPARE(writer.splineCount(), splines.size());
+
+    std::vector<char> data = writer.serialize();
+    SplineArchiveView<Vector2> view(data.data(), data.size());
+    QVERIFY(view.isValid());
+    QCOMPARE(view.splineCount(), splines.size());
+
+    for(size_t i = 0; i < splines.size(); i++)
+    {
+        QCOMPARE(view.hasArcLengths(i), includeArcLengths);
+        verifyArchivedSpline(*splines[i], *view.makeSpline(i));
+    }
+
+    //the concrete types work too, without going through makeSpline
+    MappedSpline<Vector2> uniformCR(view, 0);
+    verifyArchivedSpline(*splines[0], uniformCR);
+    LoopingMappedSpline<Vector2> loopingNatural(view, 5);
+    verifyArchivedSpline(*splines[5], loopingNatural);
+    auto expectedLooping = std::dynamic_pointer_cast<LoopingSpline<Vector2>>(splines[5]);
+    QVERIFY(std::abs(loopingNatural.cyclicArcLength(4.5f, 1.5f) - expectedLooping->cyclicArcLength(4.5f, 1.5f)) <= expectedLooping->totalLength() * 1e-4f);
+}
+
+void TestSpline::testSplineArchiveFile(void)
+{
+    auto splines = makeArchiveSplines();
+    SplineArchiveWriter<Vector2> writer;
+    for(const auto &spline : splines)
+        writer.addSpline(*spline);
+
+    QTemporaryDir directory;
+    QVERIFY(directory.isValid());
+    std::string path = directory.filePath("splines.bin").toStdString();
+    QVERIFY(writer.writeFile(path));
+
+    SplineArchiveFile file(path);
+    QVERIFY(file.isOpen());
+    QCOMPARE(file.size(), writer.serialize().size());
+
+    SplineArchiveView<Vector2> view(file.data(), file.size());
+    QVERIFY(view.isValid());
+    QCOMPARE(view.splineCount(), splines.size());
+    for(size_t i = 0; i < splines.size(); i++)
+        verifyArchivedSpline(*splines[i], *view.makeSpline(i));
+
+    SplineArchiveFile missing(directory.filePath("missing.bin").toStdString());
+    QVERIFY(!missing.isOpen());
+}
+
+void TestSpline::testSplineArchiveInvalid(void)
+{
+    SplineArchiveWriter<Vector2> writer;
+    writer.addSpline(*TestDataFloat::createUniformCR(TestDataFloat::generateRandomData(10)));
+    const std::vector<char> data = writer.serialize();
+    QVERIFY((SplineArchiveView<Vector2>(data.data(), data.size()).isValid()));
+
+    //an archive that was cut short anywhere should be rejected. the last array may be followed by up to alignment - 1 bytes of padding
+    for(size_t size : {size_t(0), size_t(7), SplineArchive::headerSize, SplineArchive::headerSize + SplineArchive::recordSize, data.size() - SplineArchive::alignment})
+        QVERIFY(!(SplineArchiveView<Vector2>(data.data(), size).isValid()));
+
+    //the wrong dimension or floating point type
+    QVERIFY(!(SplineArchiveView<Vector3, float, 3>(data.data(), data.size()).isValid()));
+    QVERIFY(!(SplineArchiveView<Vector<2, double>, double>(data.data(), data.size()).isValid()));
+
+    //a damaged header, or a damaged offset
+    for(size_t offset : {size_t(0), size_t(8), size_t(12), SplineArchive::headerSize + 8})
+    {
+        std::vector<char> damaged = data;
+        damaged[offset + 3] = char(0x7f);
+        QVERIFY(!(SplineArchiveView<Vector2>(damaged.data(), damaged.size()).isValid()));
+    }
+
+    //a max t that looping splines can't wrap by
+    for(double maxT : {0.0, -1.0, std::numeric_limits<double>::quiet_NaN(), std::numeric_limits<double>::infinity()})
+    {
+        std::vector<char> damaged = data;
+        std::memcpy(damaged.data() + SplineArchive::headerSize + 40, &maxT, sizeof(maxT));
+        QVERIFY(!(SplineArchiveView<Vector2>(damaged.data(), damaged.size()).isValid()));
+    }
+
+    //knots that go backwards, or that are all the same
+    uint64_t knotOffset, segmentCount;
+    std::memcpy(&knotOffset, data.data() + SplineArchive::headerSize, sizeof(knotOffset));
+    std::memcpy(&segmentCount, data.data() + SplineArchive::headerSize + 24, sizeof(segmentCount));
+    for(float knot : {-1.0f, 100.0f, std::numeric_limits<float>::quiet_NaN()})
+    {
+        std::vector<char> damaged = data;
+        std::memcpy(damaged.data() + knotOffset + 3 * sizeof(float), &knot, sizeof(knot));
+        QVERIFY(!(SplineArchiveView<Vector2>(damaged.data(), damaged.size()).isValid()));
+    }
+    {
+        std::vector<char> damaged = data;
+        std::memset(damaged.data() + knotOffset, 0, (segmentCount + 1) * sizeof(float));
+        QVERIFY(!(SplineArchiveView<Vector2>(damaged.data(), damaged.size()).isValid()));
+    }
+
+    //a misaligned buffer can't be used in place
+    std::vector<char> shifted(data.size() + 1);
+    std::copy(data.begin(), data.end(), shifted.begin() + 1);
+    QVERIFY(!(SplineArchiveView<Vector2>(shifted.data() + 1, data.size()).isValid()));
+}
+
+namespace
+{
+    struct SplineEdit
+    {
+        enum Type { Set, Insert, Remove } type;
+        size_t index;
+    };
+
+    //an edit of every kind at the beginning, middle and end of a spline with the given number of points
+    std::vector<SplineEdit> makeSplineEdits(size_t size)
+    {
+        return std::vector<SplineEdit>{
+            {SplineEdit::Set, size / 2},
+            {SplineEdit::Set, 0},
+            {SplineEdit::Set, size - 1},
+            {SplineEdit::Insert, size / 3},
+            {SplineEdit::Insert, 0},
+            {SplineEdit::Insert, size + 2},
+            {SplineEdit::Remove, size / 2},
+            {SplineEdit::Remove, 0},
+            {SplineEdit::Remove, size},
+        };
+    }
+
+    //apply a series of edits to both a spline and a copy of its points, and after each edit, verify that the spline matches a spline built from scratch
+    //editFunction(spline, edit, point, tangent) applies the edit to the spline, and buildFunction(points, tangents) builds a new one
+    template<class SplineT, class EditFunction, class BuildFunction>
+    void verifySplineEdits(SplineT &spline, std::vector<Vector2> points, EditFunction editFunction, BuildFunction buildFunction)
+    {
+        std::vector<Vector2> tangents = TestDataFloat::makeTangents(points);
+
+        std::minstd_rand gen(4);
+        std::uniform_real_distribution<float> distribution(-2, 2);
+
+        for(const SplineEdit &edit : makeSplineEdits(points.size()))
+        {
+            //put each new point near the point it's replacing or next to, so that the curve stays reasonable
+            Vector2 nearbyPoint = points[std::min(edit.index, points.size() - 1)];
+            Vector2 point = nearbyPoint + Vector2({distribution(gen), distribution(gen)});
+            Vector2 tangent({distribution(gen), distribution(gen)});
+
+            if(edit.type == SplineEdit::Set)
+            {
+                points[edit.index] = point;
+                tangents[edit.index] = tangent;
+            }
+            else if(edit.type == SplineEdit::Insert)
+            {
+                points.insert(points.begin() + edit.index, point);
+                tangents.insert(tangents.begin() + edit.index, tangent);
+            }
+            else
+            {
+                points.erase(points.begin() + edit.index);
+                tangents.erase(tangents.begin() + edit.index);
+            }
+
+            editFunction(spline, edit, point, tangent);
+            auto expected = buildFunction(points, tangents);
+
+            QVERIFY(spline.getOriginalPoints() == points);
+            QCOMPARE(spline.getMaxT(), expected.getMaxT());
+            QCOMPARE(spline.segmentCount(), expected.segmentCount());
+            for(size_t i = 0; i <= spline.segmentCount(); i++)
+            {
+                QCOMPARE(spline.segmentT(i), expected.segmentT(i));
+            }
+
+            compareSplinesLenient(spline, expected, 0, expected.getMaxT(), 1.0f);
+
+            //the data cached for arc length has to follow the edits too
+            for(size_t i = 0; i < spline.segmentCount(); i++)
+            {
+                float expectedLength = expected.segmentArcLength(i, expected.segmentT(i), expected.segmentT(i + 1));
+                float actualLength = spline.segmentArcLength(i, spline.segmentT(i), spline.segmentT(i + 1));
+                QVERIFY(std::abs(actualLength - expectedLength) <= 1e-4f * std::max(expectedLength, 1.0f));
+            }
+        }
+    }
+}
+
+void TestSpline::testSplineEditing_data(void)
+{
+    QTest::addColumn<float>("alpha");
+
+    QTest::newRow("uniform") << 0.0f;
+    QTest::newRow("centripetal") << 0.5f;
+}
+
+void TestSpline::testSplineEditing(void)
+{
+    QFETCH(float, alpha);
+
+    //use enough points that the natural spline edits don't just re-solve the whole spline
+    auto data = TestDataFloat::generateRandomData(80);
+
+    auto editNatural = [](auto &spline, const SplineEdit &edit, const Vector2 &point, const Vector2 &) {
+        if(edit.type == SplineEdit::Set)
+            spline.setPoint(edit.index, point);
+        else if(edit.type == SplineEdit::Insert)
+            spline.insertPoint(edit.index, point);
+        else
+            spline.removePoint(edit.index);
+    };
+    auto editHermite = [](auto &spline, const SplineEdit &edit, const Vector2 &point, const Vector2 &tangent) {
+        if(edit.type == SplineEdit::Set)
+            spline.setPoint(edit.index, point, tangent);
+        else if(edit.type == SplineEdit::Insert)
+            spline.insertPoint(edit.index, point, tangent);
+        else
+            spline.removePoint(edit.index);
+    };
+
+    NaturalSpline<Vector2> natural(data, true, alpha);
+    QVERIFY(natural.isEditable());
+    verifySplineEdits(natural, data, editNatural, [alpha](const std::vector<Vector2> &points, const std::vector<Vector2> &) {
+        return NaturalSpline<Vector2>(points, true, alpha);
+    });
+
+    LoopingNaturalSpline<Vector2> loopingNatural(data, alpha);
+    verifySplineEdits(loopingNatural, data, editNatural, [alpha](const std::vector<Vector2> &points, const std::vector<Vector2> &) {
+        return LoopingNaturalSpline<Vector2>(points, alpha);
+    });
+
+    CubicHermiteSpline<Vector2> hermite(data, TestDataFloat::makeTangents(data), alpha);
+    QVERIFY(hermite.isEditable());
+    verifySplineEdits(hermite, data, editHermite, [alpha](const std::vector<Vector2> &points, const std::vector<Vector2> &tangents) {
+        return CubicHermiteSpline<Vector2>(points, tangents, alpha);
+    });
+
+    LoopingCubicHermiteSpline<Vector2> loopingHermite(data, TestDataFloat::makeTangents(data), alpha);
+    verifySplineEdits(loopingHermite, data, editHermite, [alpha](const std::vector<Vector2> &points, const std::vector<Vector2> &tangents) {
+        return LoopingCubicHermiteSpline<Vector2>(points, tangents, alpha);
+    });
+
+    //compile-time uniform knots only support alpha == 0, and editing them should only ever change how many knots there are
+    if(alpha == 0)
+    {
+        NaturalSpline<Vector2, float, true> uniformNatural(data);
+        verifySplineEdits(uniformNatural, data, editNatural, [](const std::vector<Vector2> &points, const std::vector<Vector2> &) {
+            return NaturalSpline<Vector2, float, true>(points);
+        });
+
+        LoopingNaturalSpline<Vector2, float, true> uniformLoopingNatural(data);
+        verifySplineEdits(uniformLoopingNatural, data, editNatural, [](const std::vector<Vector2> &points, const std::vector<Vector2> &) {
+            return LoopingNaturalSpline<Vector2, float, true>(points);
+        });
+
+        CubicHermiteSpline<Vector2, float, true> uniformHermite(data, TestDataFloat::makeTangents(data));
+        verifySplineEdits(uniformHermite, data, editHermite, [](const std::vector<Vector2> &points, const std::vector<Vector2> &tangents) {
+            return CubicHermiteSpline<Vector2, float, true>(points, tangents);
+        });
+
+        LoopingCubicHermiteSpline<Vector2, float, true> uniformLoopingHermite(data, TestDataFloat::makeTangents(data));
+        verifySplineEdits(uniformLoopingHermite, data, editHermite, [](const std::vector<Vector2> &points, const std::vector<Vector2> &tangents) {
+            return LoopingCubicHermiteSpline<Vector2, float, true>(points, tangents);
+        });
+    }
+
+    //the natural splines keep the scratch for re-solving their curvatures, so after the first edit has grown it, edits in the middle of the spline reuse it
+    NaturalSpline<Vector2> reusedNatural(data, true, alpha);
+    LoopingNaturalSpline<Vector2> reusedLoopingNatural(data, alpha);
+    reusedNatural.setPoint(40, Vector2({1, 2}));
+    reusedLoopingNatural.setPoint(40, Vector2({1, 2}));
+    size_t naturalFootprint = reusedNatural.memoryFootprint();
+    size_t loopingNaturalFootprint = reusedLoopingNatural.memoryFootprint();
+    for(size_t index : {30, 45, 50})
+    {
+        reusedNatural.setPoint(index, Vector2({3, 4}));
+        reusedLoopingNatural.setPoint(index, Vector2({3, 4}));
+    }
+    QCOMPARE(reusedNatural.memoryFootprint(), naturalFootprint);
+    QCOMPARE(reusedLoopingNatural.memoryFootprint(), loopingNaturalFootprint);
+
+    //editing a spline whose original points were discarded should restore them first
+    NaturalSpline<Vector2> leanNatural(data, true, alpha);
+    leanNatural.discardOriginalPoints();
+    verifySplineEdits(leanNatural, data, editNatural, [alpha](const std::vector<Vector2> &points, const std::vector<Vector2> &) {
+        return NaturalSpline<Vector2>(points, true, alpha);
+    });
+
+    LoopingCubicHermiteSpline<Vector2> leanLoopingHermite(data, TestDataFloat::makeTangents(data), alpha);
+    leanLoopingHermite.discardOriginalPoints();
+    verifySplineEdits(leanLoopingHermite, data, editHermite, [alpha](const std::vector<Vector2> &points, const std::vector<Vector2> &tangents) {
+        return LoopingCubicHermiteSpline<Vector2>(points, tangents, alpha);
+    });
+
+    //splines whose tangents or curvatures depend on padding points can't be edited
+    QVERIFY(!NaturalSpline<Vector2>(data, false, alpha).isEditable());
+    QVERIFY(!CubicHermiteSpline<Vector2>(data, alpha).isEditable());
+}
+
+void TestSpline::testDiscardOriginalPoints_data(void)
+{
+    QTest::addColumn<std::shared_ptr<Spline<Vector2>>>("spline");
+    QTest::addColumn<bool>("canRestore");
+
+    typedef std::shared_ptr<Spline<Vector2>> SplinePtr;
+    auto data = TestDataFloat::generateRandomData(10);
+
+    QTest::newRow("uniformCR") <<               TestDataFloat::createUniformCR(data) << true;
+    QTest::newRow("catmullRomAlpha") <<         TestDataFloat::createCatmullRom(data, 0.5f) << false;
+    QTest::newRow("cubicHermiteAlpha") <<       TestDataFloat::createCubicHermite(data, 0.5f) << true;
+    QTest::newRow("quinticCatmullRom") <<       TestDataFloat::createQuinticCatmullRom(data, 0.0f) << false;
+    QTest::newRow("quinticHermiteAlpha") <<     TestDataFloat::createQuinticHermite(data, 0.5f) << true;
+    QTest::newRow("naturalAlpha") <<            TestDataFloat::createNatural(data, true, 0.5f) << true;
+    QTest::newRow("naturalNotAKnot") <<         TestDataFloat::createNotAKnot(data, true, 0.0f) << true;
+    QTest::newRow("naturalWithoutEndpoints") << TestDataFloat::createNatural(data, false, 0.0f) << false;
+    QTest::newRow("uniformB") <<                TestDataFloat::createUniformBSpline(data) << true;
+    QTest::newRow("genericBQuintic") <<         TestDataFloat::createGenericBSpline(data, 5) << true;
+
+    QTest::newRow("loopingUniformCR") <<            SplinePtr(TestDataFloat::createLoopingUniformCR(data)) << true;
+    QTest::newRow("loopingCatmullRomAlpha") <<      SplinePtr(TestDataFloat::createLoopingCatmullRom(data, 0.5f)) << true;
+    QTest::newRow("loopingCubicHermiteAlpha") <<    SplinePtr(TestDataFloat::createLoopingCubicHermite(data, 0.5f)) << true;
+    QTest::newRow("loopingQuinticCatmullRom") <<    SplinePtr(TestDataFloat::createLoopingQuinticCatmullRom(data, 0.0f)) << true;
+    QTest::newRow("loopingNaturalAlpha") <<         SplinePtr(TestDataFloat::createLoopingNatural(data, 0.5f)) << true;
+    QTest::newRow("loopingUniformB") <<             SplinePtr(TestDataFloat::createLoopingUniformBSpline(data)) << true;
+    QTest::newRow("loopingGenericBQuintic") <<      SplinePtr(TestDataFloat::createLoopingGenericBSpline(data, 5)) << true;
+
+    //a compiled spline only keeps polynomials, so there's nothing to rebuild the points from
+    auto source = TestDataFloat::createCatmullRom(data, 0.5f);
+    QTest::newRow("compiled") << SplinePtr(std::make_shared<CompiledSpline<Vector2>>(*source)) << false;
+}
+
+void TestSpline::testDiscardOriginalPoints(void)
+{
+    QFETCH(std::shared_ptr<Spline<Vector2>>, spline);
+    QFETCH(bool, canRestore);
+
+    std::vector<float> tValues;
+    for(size_t i = 0; i <= 40; i++)
+    {
+        tValues.push_back(spline->getMaxT() * i / 40);
+    }
+    std::vector<Spline<Vector2>::InterpolatedPTCW> expected(tValues.size());
+    spline->getWiggles(tValues.data(), tValues.size(), expected.data());
+
+    std::vector<Vector2> originalPoints = spline->getOriginalPoints();
+    size_t fullFootprint = spline->memoryFootprint();
+    QVERIFY(spline->hasOriginalPoints());
+    QVERIFY(fullFootprint >= sizeof(Spline<Vector2>) + originalPoints.size() * sizeof(Vector2));
+
+    spline->discardOriginalPoints();
+    QVERIFY(!spline->hasOriginalPoints());
+    QVERIFY(spline->getOriginalPoints().empty());
+    QVERIFY(spline->memoryFootprint() <= fullFootprint - originalPoints.size() * sizeof(Vector2));
+
+    //evaluation never reads the original points, so it should be exactly the same
+    std::vector<Spline<Vector2>::InterpolatedPTCW> actual(tValues.size());
+    spline->getWiggles(tValues.data(), tValues.size(), actual.data());
+    for(size_t i = 0; i < tValues.size(); i++)
+    {
+        QCOMPARE(actual[i].position, expected[i].position);
+        QCOMPARE(actual[i].tangent, expected[i].tangent);
+        QCOMPARE(actual[i].curvature, expected[i].curvature);
+        QCOMPARE(actual[i].wiggle, expected[i].wiggle);
+    }
+
+    QCOMPARE(spline->restoreOriginalPoints(), canRestore);
+    QCOMPARE(spline->hasOriginalPoints(), canRestore);
+    if(canRestore)
+    {
+        QVERIFY(spline->getOriginalPoints() == originalPoints);
+    }
+    else
+    {
+        QVERIFY(spline->getOriginalPoints().empty());
+    }
+}
+
+namespace
+{
+    template<class SplineT>
+    void compareBatchSpline(const SplineT &actual, const SplineT &expected)
+    {
+        QVERIFY(actual.getOriginalPoints() == expected.getOriginalPoints());
+        QCOMPARE(actual.getMaxT(), expected.getMaxT());
+        QCOMPARE(actual.segmentCount(), expected.segmentCount());
+        for(size_t i = 0; i <= actual.segmentCount(); i++)
+        {
+            QCOMPARE(actual.segmentT(i), expected.segmentT(i));
+        }
+
+        //the batch does exactly the same arithmetic as the constructors, so the results should match exactly
+        for(size_t i = 0; i <= 100; i++)
+        {
+            float t = expected.getMaxT() * i / 100;
+            auto actualCurvature = actual.getCurvature(t);
+            auto expectedCurvature = expected.getCurvature(t);
+            QVERIFY(actualCurvature.position == expectedCurvature.position);
+            QVERIFY(actualCurvature.tangent == expectedCurvature.tangent);
+            QVERIFY(actualCurvature.curvature == expectedCurvature.curvature);
+        }
+        QCOMPARE(actual.totalLength(), expected.totalLength());
+    }
+}
+
+void TestSpline::testNaturalSplineBatch_data(void)
+{
+    QTest::addColumn<float>("alpha");
+    QTest::addColumn<size_t>("threadCount");
+
+    QTest::newRow("uniform") << 0.0f << size_t(1);
+    QTest::newRow("centripetal") << 0.5f << size_t(1);
+    QTest::newRow("centripetalThreaded") << 0.5f << size_t(0);
+}
+
+void TestSpline::testNaturalSplineBatch(void)
+{
+    QFETCH(float, alpha);
+    QFETCH(size_t, threadCount);
+
+    //mix up the sizes, and use enough splines of one size that they need more than one group
+    std::vector<std::vector<Vector2>> pointSets;
+    for(size_t i = 0; i < 150; i++)
+    {
+        size_t sizes[] = { 3, 12, 4, 40, 12 };
+        pointSets.push_back(TestDataFloat::generateRandomData(sizes[i % 5], unsigned(i + 1)));
+    }
+
+    auto naturalBatch = NaturalSpline<Vector2>::createBatch(pointSets, alpha, threadCount);
+    auto loopingBatch = LoopingNaturalSpline<Vector2>::createBatch(pointSets, alpha, threadCount);
+    QCOMPARE(naturalBatch.size(), pointSets.size());
+    QCOMPARE(loopingBatch.size(), pointSets.size());
+
+    for(size_t i = 0; i < pointSets.size(); i++)
+    {
+        compareBatchSpline(naturalBatch[i], NaturalSpline<Vector2>(pointSets[i], true, alpha));
+        compareBatchSpline(loopingBatch[i], LoopingNaturalSpline<Vector2>(pointSets[i], alpha));
+    }
+
+    //the batched splines are editable, just like splines that were constructed one at a time
+    QVERIFY(naturalBatch.back().isEditable());
+    naturalBatch.back().setPoint(1, Vector2({1, 2}));
+    pointSets.back()[1] = Vector2({1, 2});
+    compareSplinesLenient(naturalBatch.back(), NaturalSpline<Vector2>(pointSets.back(), true, alpha), 0, naturalBatch.back().getMaxT(), 1.0f);
+
+    if(alpha == 0)
+    {
+        auto uniformBatch = NaturalSpline<Vector2, float, true>::createBatch(pointSets, 0, threadCount);
+        for(size_t i = 0; i < pointSets.size(); i++)
+        {
+            compareBatchSpline(uniformBatch[i], NaturalSpline<Vector2, float, true>(pointSets[i]));
+        }
+    }
+}
+
+void TestSpline::testInstrumentation(void)
+{
+    auto data = TestDataFloat::generateRandomData(40);
+
+    //do a bit of everything the counters cover
+    auto doWork = [&data]() {
+        NaturalSpline<Vector2> spline(data, true, 0.5f);
+        LoopingNaturalSpline<Vector2> loopingSpline(data, 0.5f);
+        SplineInverter<Vector2, float> inverter(spline);
+
+        float sum = spline.getPosition(3.5f)[0] + loopingSpline.getPosition(3.5f)[0];
+        sum += ArcLength::solveLength(spline, 0.0f, spline.totalLength() / 3);
+        sum += inverter.findClosestT(data[5] + Vector2({0.1f, 0.1f}));
+        return sum;
+    };
+
+    auto threadBegin = SplineInstrumentation::threadSnapshot();
+    auto globalBegin = SplineInstrumentation::globalSnapshot();
+    doWork();
+    auto threadCounters = SplineInstrumentation::threadSnapshot() - threadBegin;
+
+    //the same work again, on a thread that exits before the global snapshot is taken
+    std::thread worker(doWork);
+    worker.join();
+    auto globalCounters = SplineInstrumentation::globalSnapshot() - globalBegin;
+
+    for(size_t i = 0; i < SplineInstrumentation::CounterCount; i++)
+    {
+        auto counter = SplineInstrumentation::Counter(i);
+        if(SplineInstrumentation::enabled)
+        {
+            QVERIFY2(threadCounters.counts[counter] > 0, SplineInstrumentation::counterName(counter));
+
+            //nothing else runs during the test, so the worker counted exactly what this thread did
+            QCOMPARE(globalCounters.counts[counter], threadCounters.counts[counter] * 2);
+        }
+        else
+        {
+            QCOMPARE(threadCounters.counts[counter], uint64_t(0));
+            QCOMPARE(globalCounters.counts[counter], uint64_t(0));
+        }
+    }
+
+    if(!SplineInstrumentation::timingEnabled)
+    {
+        for(size_t i = 0; i < SplineInstrumentation::CounterCount; i++)
+            QCOMPARE(globalCounters.nanoseconds[i], uint64_t(0));
+    }
+}
+
+namespace
+{
+    template<class SplineT>
+    void compareStaticSpline(const SplineT &spline)
+    {
+        auto view = spline.staticSpline();
+        QCOMPARE(view.getMaxT(), spline.getMaxT());
+        QCOMPARE(view.isLooping(), spline.isLooping());
+        QCOMPARE(view.segmentCount(), spline.segmentCount());
+
+        //go a bit past the ends, so that looping splines have to wrap
+        for(float t = -1.5f; t < spline.getMaxT() + 1.5f; t += 0.37f)
+        {
+            QVERIFY(view.getPosition(t) == spline.getPosition(t));
+            QVERIFY(view.getTangent(t).tangent == spline.getTangent(t).tangent);
+            QVERIFY(view.getCurvature(t).curvature == spline.getCurvature(t).curvature);
+            QVERIFY(view.getWiggle(t).wiggle == spline.getWiggle(t).wiggle);
+            QCOMPARE(view.segmentForT(t), spline.segmentForT(t));
+        }
+        for(size_t i = 0; i < spline.segmentCount(); i++)
+        {
+            QCOMPARE(view.segmentT(i), spline.segmentT(i));
+            QCOMPARE(view.segmentArcLength(i, spline.segmentT(i), spline.segmentT(i + 1)), spline.segmentArcLength(i, spline.segmentT(i), spline.segmentT(i + 1)));
+        }
+
+        QCOMPARE(view.totalLength(), spline.totalLength());
+        QCOMPARE(view.arcLength(0.3f, spline.getMaxT() - 0.6f), spline.arcLength(0.3f, spline.getMaxT() - 0.6f));
+
+        //the arc length solver works on the view too, through the same template
+        const Spline<Vector2, float> &base = spline;
+        float length = spline.totalLength() / 3;
+        QCOMPARE(ArcLength::solveLength(view, 0.2f, length), ArcLength::solveLength(base, 0.2f, length));
+    }
+
+    template<class SplineT>
+    void compareStaticSplineCyclic(const SplineT &spline)
+    {
+        compareStaticSpline(spline);
+
+        auto view = spline.staticSpline();
+        QCOMPARE(view.cyclicArcLength(spline.getMaxT() - 0.5f, 0.5f), spline.cyclicArcLength(spline.getMaxT() - 0.5f, 0.5f));
+        QCOMPARE(view.arcLength(-0.5f, spline.getMaxT() + 0.5f), spline.arcLength(-0.5f, spline.getMaxT() + 0.5f));
+    }
+}
+
+void TestSpline::testStaticSpline(void)
+{
+    auto data = TestDataFloat::generateRandomData(12);
+
+    compareStaticSpline(UniformCRSpline<Vector2>(data));
+    compareStaticSpline(CubicHermiteSpline<Vector2>(data, 0.5f));
+    compareStaticSpline(QuinticHermiteSpline<Vector2>(data, 0.5f));
+    compareStaticSpline(UniformCubicBSpline<Vector2>(data));
+    compareStaticSpline(GenericBSpline<Vector2>(data, 5));
+
+    //the view has to use the spline's own quadrature settings
+    NaturalSpline<Vector2> natural(data, true, 0.5f);
+    natural.setArcLengthQuadrature(SplineLibraryCalculus::QuadratureSettings<float>(SplineLibraryCalculus::AdaptiveGaussKronrod, 1e-3f));
+    compareStaticSpline(natural);
+
+    compareStaticSplineCyclic(LoopingUniformCRSpline<Vector2>(data));
+    compareStaticSplineCyclic(LoopingCubicHermiteSpline<Vector2>(data, 0.5f));
+    compareStaticSplineCyclic(LoopingNaturalSpline<Vector2>(data, 0.5f));
+    compareStaticSplineCyclic(LoopingGenericBSpline<Vector2>(data, 4));
+}
+
+void TestSpline::testSplineVariant(void)
+{
+    typedef SplineVariant<Vector2, float, NaturalSpline<Vector2>, LoopingNaturalSpline<Vector2>, UniformCRSpline<Vector2>> Variant;
+
+    std::vector<Variant> splines;
+    std::vector<std::shared_ptr<Spline<Vector2, float>>> expected;
+    for(unsigned i = 0; i < 9; i++)
+    {
+        auto data = TestDataFloat::generateRandomData(10 + i, i + 1);
+        if(i % 3 == 0)
+        {
+            splines.push_back(NaturalSpline<Vector2>(data, true, 0.5f));
+            expected.push_back(std::make_shared<NaturalSpline<Vector2>>(data, true, 0.5f));
+        }
+        else if(i % 3 == 1)
+        {
+            splines.push_back(LoopingNaturalSpline<Vector2>(data, 0.5f));
+            expected.push_back(std::make_shared<LoopingNaturalSpline<Vector2>>(data, 0.5f));
+        }
+        else
+        {
+            splines.push_back(UniformCRSpline<Vector2>(data));
+            expected.push_back(std::make_shared<UniformCRSpline<Vector2>>(data));
+        }
+    }
+
+    for(size_t i = 0; i < splines.size(); i++)
+    {
+        const Variant &spline = splines[i];
+        const Spline<Vector2, float> &reference = *expected[i];
+
+        QCOMPARE(spline.index(), i % 3);
+        QCOMPARE(spline.getIf<UniformCRSpline<Vector2>>() != nullptr, i % 3 == 2);
+        QCOMPARE(spline.getMaxT(), reference.getMaxT());
+        QCOMPARE(spline.isLooping(), reference.isLooping());
+        QCOMPARE(spline.segmentCount(), reference.segmentCount());
+        QCOMPARE(spline.totalLength(), reference.totalLength());
+        QCOMPARE(spline.arcLength(0.5f, 2.5f), reference.arcLength(0.5f, 2.5f));
+        QVERIFY(spline.memoryFootprint() >= sizeof(Variant));
+
+        std::vector<float> tValues;
+        for(float t = 0; t < reference.getMaxT(); t += 0.3f)
+        {
+            tValues.push_back(t);
+            QVERIFY(spline.getPosition(t) == reference.getPosition(t));
+            QVERIFY(spline.getTangent(t).tangent == reference.getTangent(t).tangent);
+            QVERIFY(spline.getCurvature(t).curvature == reference.getCurvature(t).curvature);
+            QVERIFY(spline.getWiggle(t).wiggle == reference.getWiggle(t).wiggle);
+            QCOMPARE(spline.segmentForT(t), reference.segmentForT(t));
+        }
+
+        std::vector<Vector2> positions(tValues.size());
+        spline.getPositions(tValues.data(), tValues.size(), positions.data());
+        for(size_t t = 0; t < tValues.size(); t++)
+        {
+            QVERIFY(positions[t] == reference.getPosition(tValues[t]));
+        }
+
+        //and the held spline still works with everything that takes a Spline reference
+        QCOMPARE(ArcLength::solveLength(spline.asSpline(), 0.0f, 1.0f), ArcLength::solveLength(reference, 0.0f, 1.0f));
+    }
+
+    //copying and assigning between different alternatives destroys the old spline and copies the new one's type along with it
+    Variant copy = splines[0];
+    QCOMPARE(copy.index(), size_t(0));
+    copy = splines[1];
+    QCOMPARE(copy.index(), size_t(1));
+    QCOMPARE(copy.totalLength(), expected[1]->totalLength());
+    copy = std::move(splines[2]);
+    QCOMPARE(copy.index(), size_t(2));
+    QVERIFY(copy.getPosition(1.5f) == expected[2]->getPosition(1.5f));
+}
+
+namespace
+{
+    typedef std::vector<Vector2> Points;
+
+    //rebuild a spline from point sets of several sizes in turn, and check that each result is exactly what the constructor gives for the same points
+    template<class SplineT, class Construct, class Rebuild>
+    void compareRebuiltSplines(Construct construct, Rebuild rebuild)
+    {
+        //the same number of points, then fewer, then more, so that rebuilds both reuse and outgrow the spline's memory
+        const std::array<size_t, 6> sizes = {{12, 12, 8, 20, 20, 16}};
+
+        SplineT spline = construct(TestDataFloat::generateRandomData(sizes[0], 1));
+        for(size_t round = 1; round < sizes.size(); round++)
+        {
+            Points points = TestDataFloat::generateRandomData(sizes[round], unsigned(round + 1));
+            size_t footprint = spline.memoryFootprint();
+            const Vector2 *storage = spline.getOriginalPoints().data();
+
+            rebuild(spline, points);
+            compareBatchSpline(spline, construct(points));
+
+            //the first rebuild allocates the scratch space. after that, a rebuild with no more points than the last one shouldn't allocate anything
+            if(round > 1 && sizes[round] <= sizes[round - 1])
+            {
+                QCOMPARE(spline.memoryFootprint(), footprint);
+                QVERIFY(spline.getOriginalPoints().data() == storage);
+            }
+        }
+    }
+
+    Points rebuildTangents(const Points &points) { return TestDataFloat::generateRandomData(points.size(), 99); }
+    Points rebuildCurvatures(const Points &points) { return TestDataFloat::generateRandomData(points.size(), 98); }
+}
+
+void TestSpline::testSplineRebuild(void)
+{
+    compareRebuiltSplines<UniformCRSpline<Vector2>>(
+        [](const Points &p) { return UniformCRSpline<Vector2>(p); },
+        [](UniformCRSpline<Vector2> &s, const Points &p) { s.rebuild(p); });
+    compareRebuiltSplines<LoopingUniformCRSpline<Vector2>>(
+        [](const Points &p) { return LoopingUniformCRSpline<Vector2>(p); },
+        [](LoopingUniformCRSpline<Vector2> &s, const Points &p) { s.rebuild(p); });
+    compareRebuiltSplines<UniformCubicBSpline<Vector2>>(
+        [](const Points &p) { return UniformCubicBSpline<Vector2>(p); },
+        [](UniformCubicBSpline<Vector2> &s, const Points &p) { s.rebuild(p); });
+    compareRebuiltSplines<LoopingUniformCubicBSpline<Vector2>>(
+        [](const Points &p) { return LoopingUniformCubicBSpline<Vector2>(p); },
+        [](LoopingUniformCubicBSpline<Vector2> &s, const Points &p) { s.rebuild(p); });
+
+    compareRebuiltSplines<CubicHermiteSpline<Vector2>>(
+        [](const Points &p) { return CubicHermiteSpline<Vector2>(p, 0.5f); },
+        [](CubicHermiteSpline<Vector2> &s, const Points &p) { s.rebuild(p, 0.5f); });
+    compareRebuiltSplines<CubicHermiteSpline<Vector2>>(
+        [](const Points &p) { return CubicHermiteSpline<Vector2>(p, rebuildTangents(p), 0.5f); },
+        [](CubicHermiteSpline<Vector2> &s, const Points &p) { s.rebuild(p, rebuildTangents(p), 0.5f); });
+    compareRebuiltSplines<CubicHermiteSpline<Vector2, float, true>>(
+        [](const Points &p) { return CubicHermiteSpline<Vector2, float, true>(p); },
+        [](CubicHermiteSpline<Vector2, float, true> &s, const Points &p) { s.rebuild(p); });
+    compareRebuiltSplines<LoopingCubicHermiteSpline<Vector2>>(
+        [](const Points &p) { return LoopingCubicHermiteSpline<Vector2>(p, 0.5f); },
+        [](LoopingCubicHermiteSpline<Vector2> &s, const Points &p) { s.rebuild(p, 0.5f); });
+    compareRebuiltSplines<LoopingCubicHermiteSpline<Vector2>>(
+        [](const Points &p) { return LoopingCubicHermiteSpline<Vector2>(p, rebuildTangents(p), 0.5f); },
+        [](LoopingCubicHermiteSpline<Vector2> &s, const Points &p) { s.rebuild(p, rebuildTangents(p), 0.5f); });
+
+    compareRebuiltSplines<QuinticHermiteSpline<Vector2>>(
+        [](const Points &p) { return QuinticHermiteSpline<Vector2>(p, 0.5f); },
+        [](QuinticHermiteSpline<Vector2> &s, const Points &p) { s.rebuild(p, 0.5f); });
+    compareRebuiltSplines<QuinticHermiteSpline<Vector2, float, true>>(
+        [](const Points &p) { return QuinticHermiteSpline<Vector2, float, true>(p, rebuildTangents(p), rebuildCurvatures(p)); },
+        [](QuinticHermiteSpline<Vector2, float, true> &s, const Points &p) { s.rebuild(p, rebuildTangents(p), rebuildCurvatures(p)); });
+    compareRebuiltSplines<LoopingQuinticHermiteSpline<Vector2>>(
+        [](const Points &p) { return LoopingQuinticHermiteSpline<Vector2>(p, 0.5f); },
+        [](LoopingQuinticHermiteSpline<Vector2> &s, const Points &p) { s.rebuild(p, 0.5f); });
+    compareRebuiltSplines<LoopingQuinticHermiteSpline<Vector2>>(
+        [](const Points &p) { return LoopingQuinticHermiteSpline<Vector2>(p, rebuildTangents(p), rebuildCurvatures(p), 0.5f); },
+        [](LoopingQuinticHermiteSpline<Vector2> &s, const Points &p) { s.rebuild(p, rebuildTangents(p), rebuildCurvatures(p), 0.5f); });
+
+    compareRebuiltSplines<NaturalSpline<Vector2>>(
+        [](const Points &p) { return NaturalSpline<Vector2>(p, true, 0.5f); },
+        [](NaturalSpline<Vector2> &s, const Points &p) { s.rebuild(p, true, 0.5f); });
+    compareRebuiltSplines<NaturalSpline<Vector2>>(
+        [](const Points &p) { return NaturalSpline<Vector2>(p, false, 0.5f, NaturalSpline<Vector2>::NotAKnot); },
+        [](NaturalSpline<Vector2> &s, const Points &p) { s.rebuild(p, false, 0.5f, NaturalSpline<Vector2>::NotAKnot); });
+    compareRebuiltSplines<NaturalSpline<Vector2, float, true>>(
+        [](const Points &p) { return NaturalSpline<Vector2, float, true>(p); },
+        [](NaturalSpline<Vector2, float, true> &s, const Points &p) { s.rebuild(p); });
+    compareRebuiltSplines<LoopingNaturalSpline<Vector2>>(
+        [](const Points &p) { return LoopingNaturalSpline<Vector2>(p, 0.5f); },
+        [](LoopingNaturalSpline<Vector2> &s, const Points &p) { s.rebuild(p, 0.5f); });
+
+    compareRebuiltSplines<GenericBSpline<Vector2>>(
+        [](const Points &p) { return GenericBSpline<Vector2>(p, 5); },
+        [](GenericBSpline<Vector2> &s, const Points &p) { s.rebuild(p, 5); });
+    compareRebuiltSplines<GenericBSpline<Vector2, float, 3>>(
+        [](const Points &p) { return GenericBSpline<Vector2, float, 3>(p); },
+        [](GenericBSpline<Vector2, float, 3> &s, const Points &p) { s.rebuild(p); });
+    compareRebuiltSplines<LoopingGenericBSpline<Vector2>>(
+        [](const Points &p) { return LoopingGenericBSpline<Vector2>(p, 4); },
+        [](LoopingGenericBSpline<Vector2> &s, const Points &p) { s.rebuild(p, 4); });
+
+    compareRebuiltSplines<CompiledSpline<Vector2>>(
+        [](const Points &p) { return CompiledSpline<Vector2>(CubicHermiteSpline<Vector2>(p, 0.5f)); },
+        [](CompiledSpline<Vector2> &s, const Points &p) { s.rebuild(CubicHermiteSpline<Vector2>(p, 0.5f)); });
+    compareRebuiltSplines<LoopingCompiledSpline<Vector2>>(
+        [](const Points &p) { return LoopingCompiledSpline<Vector2>(LoopingNaturalSpline<Vector2>(p, 0.5f)); },
+        [](LoopingCompiledSpline<Vector2> &s, const Points &p) { s.rebuild(LoopingNaturalSpline<Vector2>(p, 0.5f)); });
+
+    //a rebuild forgets the old points entirely, including what the last edit computed from them, so an edit after a rebuild gives the same result as on a new spline
+    Points points = TestDataFloat::generateRandomData(10, 3);
+    Points newPoints = TestDataFloat::generateRandomData(12, 4);
+
+    NaturalSpline<Vector2> natural(points, true, 0.5f);
+    natural.setPoint(4, Vector2({1, 2}));
+    natural.rebuild(newPoints, false, 0.5f);
+    QVERIFY(!natural.isEditable());
+    natural.rebuild(newPoints, true, 0.5f);
+    QVERIFY(natural.isEditable());
+
+    NaturalSpline<Vector2> expectedNatural(newPoints, true, 0.5f);
+    natural.setPoint(6, Vector2({3, 4}));
+    expectedNatural.setPoint(6, Vector2({3, 4}));
+    compareBatchSpline(natural, expectedNatural);
+
+    CubicHermiteSpline<Vector2> hermite(points, rebuildTangents(points), 0.5f);
+    hermite.insertPoint(4, Vector2({1, 2}), Vector2({1, 0}));
+    hermite.rebuild(newPoints, 0.5f);
+    QVERIFY(!hermite.isEditable());
+    hermite.rebuild(newPoints, rebuildTangents(newPoints), 0.5f);
+    QVERIFY(hermite.isEditable());
+
+    CubicHermiteSpline<Vector2> expectedHermite(newPoints, rebuildTangents(newPoints), 0.5f);
+    hermite.removePoint(6);
+    expectedHermite.removePoint(6);
+    compareBatchSpline(hermite, expectedHermite);
+
+    //a discarded spline gets its points back from a rebuild
+    LoopingNaturalSpline<Vector2> looping(points, 0.5f);
+    looping.discardOriginalPoints();
+    looping.rebuild(newPoints, 0.5f);
+    QVERIFY(looping.hasOriginalPoints());
+    compareBatchSpline(looping, LoopingNaturalSpline<Vector2>(newPoints, 0.5f));
+}
+
+void TestSpline::testSplinePublisher(void)
+{
+    Points points = TestDataFloat::generateRandomData(10, 3);
+    Points newPoints = TestDataFloat::generateRandomData(12, 4);
+
+    SplinePublisher<NaturalSpline<Vector2>> publisher(NaturalSpline<Vector2>(points, true, 0.5f), 4);
+    NaturalSpline<Vector2> expected(points, true, 0.5f);
+    {
+        auto reader = publisher.registerReader();
+        auto otherReader = publisher.registerReader();
+
+        //a snapshot keeps its version alive and unchanged through an edit, while a new snapshot sees the edit
+        const NaturalSpline<Vector2> *firstVersion;
+        {
+            auto snapshot = reader.read();
+            firstVersion = snapshot.get();
+            compareBatchSpline(*snapshot, expected);
+
+            publisher.modify([](NaturalSpline<Vector2> &spline) { spline.setPoint(3, Vector2({1, 2})); });
+            expected.setPoint(3, Vector2({1, 2}));
+            QCOMPARE(publisher.retiredCount(), size_t(1));
+            compareBatchSpline(*snapshot, NaturalSpline<Vector2>(points, true, 0.5f));
+
+            auto otherSnapshot = otherReader.read();
+            QVERIFY(otherSnapshot.get() != firstVersion);
+            compareBatchSpline(*otherSnapshot, expected);
+        }
+
+        //with no snapshots left, the next publish can free every retired version, and keeps the newest one for the next edit to reuse
+        const NaturalSpline<Vector2> *secondVersion = reader.read().get();
+        publisher.modify([](NaturalSpline<Vector2> &spline) { spline.setPoint(5, Vector2({3, 4})); });
+        expected.setPoint(5, Vector2({3, 4}));
+        QCOMPARE(publisher.retiredCount(), size_t(0));
+        compareBatchSpline(*reader.read(), expected);
+
+        publisher.modify([](NaturalSpline<Vector2> &spline) { spline.insertPoint(2, Vector2({5, 6})); });
+        expected.insertPoint(2, Vector2({5, 6}));
+        {
+            auto snapshot = reader.read();
+            QCOMPARE(snapshot.get(), secondVersion);
+            compareBatchSpline(*snapshot, expected);
+        }
+
+        //a recycled version is rebuilt as is, without copying the latest version first
+        publisher.replace([&](NaturalSpline<Vector2> &spline) { spline.rebuild(newPoints, true, 0.5f); });
+        compareBatchSpline(*reader.read(), NaturalSpline<Vector2>(newPoints, true, 0.5f));
+        compareBatchSpline(publisher.latest(), NaturalSpline<Vector2>(newPoints, true, 0.5f));
+
+        //running out of reader slots gives an invalid reader instead of failing, and destroying a reader frees its slot
+        QVERIFY(reader.isValid());
+        {
+            auto thirdReader = publisher.registerReader();
+            auto fourthReader = publisher.registerReader();
+            QVERIFY(thirdReader.isValid());
+            QVERIFY(fourthReader.isValid());
+
+            auto extraReader = publisher.registerReader();
+            QVERIFY(!extraReader.isValid());
+            auto snapshot = extraReader.read();
+            QVERIFY(!snapshot.isValid());
+            QVERIFY(snapshot.get() == nullptr);
+        }
+        auto replacementReader = publisher.registerReader();
+        QVERIFY(replacementReader.isValid());
+        QVERIFY(replacementReader.read().isValid());
+    }
+
+    //one writer publishes shifted copies of the same points while readers on other threads evaluate whatever is current
+    //every point of a version is shifted by the same amount, so a reader that saw part of one version and part of another would notice
+    Points base = TestDataFloat::generateRandomData(20, 5);
+    SplinePublisher<UniformCRSpline<Vector2>> shiftedPublisher(UniformCRSpline<Vector2>(base), 8);
+    const size_t versionCount = 2000;
+    std::atomic<bool> finished(false);
+    std::atomic<size_t> failures(0);
+    std::atomic<size_t> reads(0);
+
+    std::vector<std::thread> readers;
+    for(size_t r = 0; r < 4; r++)
+    {
+        readers.emplace_back([&]() {
+            auto reader = shiftedPublisher.registerReader();
+            float lastShift = 0;
+            while(!finished.load())
+            {
+                auto snapshot = reader.read();
+                const Points &snapshotPoints = snapshot->getOriginalPoints();
+                float shift = snapshotPoints[0][0] - base[0][0];
+                bool consistent = shift >= lastShift && snapshotPoints.size() == base.size();
+                for(size_t i = 0; consistent && i < base.size(); i++)
+                    consistent = snapshotPoints[i] == base[i] + Vector2({shift, 0});
+
+                //a uniform catmull-rom spline passes through each of its inner points at the beginning of a segment
+                for(size_t i = 0; consistent && i < snapshot->segmentCount(); i++)
+                    consistent = (snapshot->getPosition(snapshot->segmentT(i)) - snapshotPoints[i + 1]).length() < 1e-3f;
+
+                if(!consistent)
+                    failures++;
+                lastShift = shift;
+                reads++;
+            }
+        });
+    }
+
+    Points shifted = base;
+    for(size_t v = 1; v <= versionCount; v++)
+    {
+        for(size_t i = 0; i < base.size(); i++)
+            shifted[i] = base[i] + Vector2({float(v), 0});
+        shiftedPublisher.replace([&](UniformCRSpline<Vector2> &spline) { spline.rebuild(shifted); });
+    }
+    finished.store(true);
+    for(auto &thread : readers)
+        thread.join();
+
+    QCOMPARE(failures.load(), size_t(0));
+    QVERIFY(reads.load() > 0);
+    QCOMPARE(shiftedPublisher.latest().getOriginalPoints(), shifted);
+
+    //once every reader is gone, nothing is held back
+    shiftedPublisher.modify([](UniformCRSpline<Vector2> &) {});
+    QCOMPARE(shiftedPublisher.retiredCount(), size_t(0));
+}
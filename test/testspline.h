@@ -26,6 +26,26 @@ private slots:
     void testDerivatives_data(void);
     void testDerivatives(void);
 
+    //verify that generic B-splines with a compile-time degree give the same results as generic B-splines with a runtime degree
+    void testGenericBFixedDegree_data(void);
+    void testGenericBFixedDegree(void);
+
+    //verify that splines with compile-time uniform knots give the same results as the same splines with stored knots and alpha == 0
+    void testUniformKnots_data(void);
+    void testUniformKnots(void);
+
+    //verify that the fixed-capacity uniform splines give the same results as the std::vector-based splines they're built from
+    void testFixedUniformSplines(void);
+
+    //verify that the sliding window splines match the std::vector-based splines built from the points in their window, after every push
+    void testSlidingWindowSplines(void);
+
+    //verify that the ArcLength functions accept every concrete spline type directly, not just Spline references, and give the same results as they do through the base class
+    void testArcLengthConcreteTypes(void);
+
+    //verify that splines with single precision points and double precision t values match splines that are double precision everywhere, on a very long spline
+    void testMixedPrecision(void);
+
     //Verify that the 'segment arc length' method computes the correct result
     void testSegmentArcLength_data(void);
     void testSegmentArcLength(void);
@@ -33,4 +53,94 @@ private slots:
     //Verify that the 'segment arc length' method computes the correct result for cyclic splines
     void testSegmentArcLengthCyclic_data(void);
     void testSegmentArcLengthCyclic(void);
+
+    //Verify that the batch evaluation methods give the same results as evaluating each T individually
+    void testBatchEvaluation_data(void);
+    void testBatchEvaluation(void);
+
+    //Verify that the batch evaluation methods give the same results as evaluating each T individually, including out-of-range T values
+    void testBatchEvaluationCyclic_data(void);
+    void testBatchEvaluationCyclic(void);
+
+    //verify that compiled splines match the spline they were compiled from
+    void testCompiledSpline_data(void);
+    void testCompiledSpline(void);
+
+    //verify that looping compiled splines match the looping spline they were compiled from, including out-of-range T values
+    void testCompiledSplineCyclic_data(void);
+    void testCompiledSplineCyclic(void);
+
+    //verify that the multithreaded batch version of SplineInverter::findClosestT matches the single query version
+    void testInverterBatch_data(void);
+    void testInverterBatch(void);
+
+    //verify that the coherent version of SplineInverter::findClosestT finds the same closest point as the global search, for a point moving along the spline and for bad hints
+    void testInverterCoherent_data(void);
+    void testInverterCoherent(void);
+
+    //verify that refitting an inverter after an edit, or rebuilding it after the spline was rebuilt, gives exactly the results of a new inverter
+    void testInverterRefit(void);
+
+    //verify that SplineBoundsTree's closest point is never further than the closest of a dense set of samples, and that its box and ray queries never miss a sample
+    void testBoundsTree_data(void);
+    void testBoundsTree(void);
+    void testBoundsTree3D(void);
+
+    //verify that each segment's box contains a dense set of samples and touches them on every side, and that range bounds and culling agree with the segment boxes
+    void testSegmentBounds_data(void);
+    void testSegmentBounds(void);
+
+    //verify that the LOD table's measured position and tangent errors are close to the errors at a dense set of samples in every mode, that cubic beats linear, and that withMaxError meets its budget
+    void testLodTable_data(void);
+    void testLodTable(void);
+
+    //verify that the tessellated polyline stays within its tolerances, and that a buffer that's too small gets exactly the beginning of the full polyline
+    void testTessellation_data(void);
+    void testTessellation(void);
+
+    //verify that forward differencing samples match evaluating the spline directly, including across the points where the differences are restarted
+    void testFixedStepSampler_data(void);
+    void testFixedStepSampler(void);
+
+    //verify that swept frames stay orthonormal, follow the spline, and don't twist: a planar spline keeps its normal, and the twist around the tangent adds up to almost nothing
+    void testRotationMinimizingFrames(void);
+
+    //verify that fitting dense samples stays within tolerance with far fewer control points, and puts its knots where the samples turn
+    void testSplineFitting(void);
+
+    //verify that the reference versions of the GLSL evaluators match the splines packed into a GpuSplineBuffer, with several splines sharing one buffer
+    void testGpuSplineBuffer_data(void);
+    void testGpuSplineBuffer(void);
+
+    //verify that splines loaded from a SplineArchive, in memory and through a memory mapped file, match the splines that were written, and that damaged archives are rejected
+    void testSplineArchive_data(void);
+    void testSplineArchive(void);
+    void testSplineArchiveFile(void);
+    void testSplineArchiveInvalid(void);
+
+    //verify that editing the points of a spline in place gives the same result as building a new spline from the edited points, and reuses the memory from earlier edits
+    void testSplineEditing_data(void);
+    void testSplineEditing(void);
+
+    //verify that discarding a spline's original points frees their memory without changing how it evaluates, and that they can be restored when the spline type supports it
+    void testDiscardOriginalPoints_data(void);
+    void testDiscardOriginalPoints(void);
+
+    //verify that building natural splines as a batch gives the same splines as building each one alone
+    void testNaturalSplineBatch_data(void);
+    void testNaturalSplineBatch(void);
+
+    //verify that the instrumentation counters see each hot path, from every thread, and that they count nothing when instrumentation is disabled
+    void testInstrumentation(void);
+
+    //verify that the devirtualized static interface and the variant handle give exactly what the virtual functions give
+    void testStaticSpline(void);
+    void testSplineVariant(void);
+
+    //verify that rebuilding a spline in place gives exactly the spline the constructor would, without allocating once it has enough memory
+    void testSplineRebuild(void);
+
+    //verify that readers keep seeing the version they took a snapshot of while the writer publishes newer ones, that versions are recycled once no reader holds them,
+    //that readers on other threads only ever see whole versions, in order, and that registering more readers than there are slots gives an invalid reader
+    void testSplinePublisher(void);
 };
@@ -12,7 +12,8 @@
 #include "spline_library/utils/splineinverter.h"
 
 #include <vector>
-
+#include <array>
+#include <limits>
 #include <memory>
 
 #include <QtTest/QtTest>
@@ -156,6 +157,73 @@ void TestVector::testLengthOperations(void)
     }
 }
 
+template<size_t dimension, typename floating_t>
+void verifyVectorShape(void)
+{
+    std::array<floating_t, dimension> leftData, rightData;
+    for(size_t i = 0; i < dimension; i++) {
+        leftData[i] = floating_t(1.5) + i;
+        rightData[i] = floating_t(-0.25) * (i + 3);
+    }
+    floating_t s = floating_t(0.3);
+
+    Vector<dimension, floating_t> left(leftData), right(rightData);
+
+    Vector<dimension, floating_t> sum = left + right;
+    Vector<dimension, floating_t> difference = left - right;
+    Vector<dimension, floating_t> product = left * s;
+    Vector<dimension, floating_t> reverseProduct = s * left;
+    Vector<dimension, floating_t> quotient = left / s;
+    Vector<dimension, floating_t> negated = -left;
+
+    Vector<dimension, floating_t> sumCopy = left;
+    sumCopy += right;
+    Vector<dimension, floating_t> quotientCopy = left;
+    quotientCopy /= s;
+
+    floating_t expectedDot = 0;
+    for(size_t i = 0; i < dimension; i++) {
+        //element-wise operations are exact, so they should match bit for bit
+        QVERIFY(sum[i] == leftData[i] + rightData[i]);
+        QVERIFY(difference[i] == leftData[i] - rightData[i]);
+        QVERIFY(product[i] == leftData[i] * s);
+        QVERIFY(reverseProduct[i] == s * leftData[i]);
+        QVERIFY(quotient[i] == leftData[i] / s);
+        QVERIFY(negated[i] == -leftData[i]);
+        QVERIFY(sumCopy[i] == sum[i]);
+        QVERIFY(quotientCopy[i] == quotient[i]);
+
+        expectedDot += leftData[i] * rightData[i];
+    }
+
+    QCOMPARE((Vector<dimension, floating_t>::dotProduct(left, right)), expectedDot);
+    QCOMPARE(left.lengthSquared(), (Vector<dimension, floating_t>::dotProduct(left, left)));
+    QCOMPARE(left.length(), std::sqrt(left.lengthSquared()));
+    QCOMPARE(left.normalized().length(), floating_t(1));
+
+    //if the shape is padded for SIMD, a scalar operation can leave garbage in the padding. make sure it never leaks into a result
+    //inf * 0 is NaN, so any padding element of "infinite" is NaN here
+    std::array<floating_t, dimension> onesData;
+    onesData.fill(1);
+    Vector<dimension, floating_t> ones(onesData);
+    Vector<dimension, floating_t> infinite = left * std::numeric_limits<floating_t>::infinity();
+    QVERIFY((Vector<dimension, floating_t>::dotProduct(infinite, ones)) == std::numeric_limits<floating_t>::infinity());
+    QVERIFY(infinite == infinite);
+}
+
+void TestVector::testSimdShapes(void)
+{
+    verifyVectorShape<2, float>();
+    verifyVectorShape<3, float>();
+    verifyVectorShape<4, float>();
+    verifyVectorShape<4, double>();
+
+    //and a few shapes that always use the scalar implementation
+    verifyVectorShape<1, float>();
+    verifyVectorShape<3, double>();
+    verifyVectorShape<5, float>();
+}
+
 void TestVector::testSplineFunctionality_data(void)
 {
     std::vector<Vector2> cubicPoints {
@@ -22,6 +22,9 @@ private slots:
     void testLengthOperations_data(void);
     void testLengthOperations(void);
 
+    //verify every operation on the vector shapes that have SIMD implementations against a plain scalar computation
+    void testSimdShapes(void);
+
     //verify that we can create a spline using Vector as the interpolation type and get the expected results
     void testSplineFunctionality_data(void);
     void testSplineFunctionality(void);